@@ -0,0 +1,37 @@
+#include "le_atClient_interface.h"
+
+#undef LE_KILL_CLIENT
+#define LE_KILL_CLIENT LE_WARN
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_atClient_GetClientSessionRef
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_atClient_GetServiceRef
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add service close handler
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionEventHandlerRef_t AddServiceCloseHandler
+(
+    le_msg_ServiceRef_t serviceRef,
+    le_msg_SessionEventHandler_t handlerFunc,
+    void *contextPtr
+);
@@ -1,11 +1,274 @@
 /**
  * This module implements the unit tests for AT Client API.
  *
+ * The unsolicited responses of a recorded modem trace are written to a pseudo-terminal monitored
+ * by the AT client, and the responses received by each subscribed handler are checked. The trace
+ * is then replayed a number of times to measure the line processing throughput.
+ *
  * Copyright (C) Sierra Wireless Inc.
  *
  */
 #include "legato.h"
+#include "interfaces.h"
+
+#include <termios.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time to wait for the expected unsolicited responses, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMEOUT_SEC 10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of subscriptions that never match, to emulate a port with many subscribers
+ */
+//--------------------------------------------------------------------------------------------------
+#define DUMMY_COUNT 32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of replays of the trace for the throughput measurement
+ */
+//--------------------------------------------------------------------------------------------------
+#define REPLAY_COUNT 2000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited responses recorded on the modem port
+ */
+//--------------------------------------------------------------------------------------------------
+static const char ModemTrace[] =
+    "\r\n+CREG: 1,\"0F3C\",\"01A2B3C4\",7\r\n"
+    "\r\n+CSQ: 21,99\r\n"
+    "\r\nRING\r\n"
+    "\r\n+CMT: \"+33612345678\",,\"17/05/02,10:31:00+08\"\r\nHello world\r\n"
+    "\r\n+CGEV: NW DETACH\r\n"
+    "\r\n^SYSSTART\r\n";
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subscription of the test
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* patternPtr;                         ///< Pattern to match
+    uint32_t    lineCount;                          ///< Unsolicited lines number
+    uint32_t    traceCount;                         ///< Responses expected in one trace
+    uint32_t    count;                              ///< Responses received
+    char        lastRsp[LE_ATDEFS_UNSOLICITED_MAX_BYTES]; ///< Last response received
+    le_atClient_UnsolicitedResponseHandlerRef_t ref;    ///< Handler reference
+}
+Subscription_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subscriptions matching the trace; "+C" overlaps with all the other "+C" patterns
+ */
+//--------------------------------------------------------------------------------------------------
+static Subscription_t Subscriptions[] =
+{
+    { "+CREG:", 1, 1 },
+    { "+C",     1, 4 },
+    { "+CMT:",  2, 1 },
+    { "RING",   1, 1 },
+};
+
+#define SUBSCRIPTION_COUNT (sizeof(Subscriptions)/sizeof(Subscriptions[0]))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Responses received by all handlers, and number expected before ExpectedSem is posted
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ReceivedCount;
+static uint32_t ExpectedCount;
+static le_sem_Ref_t ExpectedSem;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited handler, called by the device thread of the AT client.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnsolicitedHandler
+(
+    const char* unsolicitedRsp,
+    void* contextPtr
+)
+{
+    Subscription_t* subscriptionPtr = contextPtr;
+
+    LE_ASSERT(subscriptionPtr != NULL);
+
+    subscriptionPtr->count++;
+    le_utf8_Copy(subscriptionPtr->lastRsp, unsolicitedRsp, sizeof(subscriptionPtr->lastRsp), NULL);
+
+    if (++ReceivedCount == ExpectedCount)
+    {
+        le_sem_Post(ExpectedSem);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the subscriptions that must never match.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DummyHandler
+(
+    const char* unsolicitedRsp,
+    void* contextPtr
+)
+{
+    LE_FATAL("Unexpected unsolicited response: %s", unsolicitedRsp);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the counters and write the trace the given number of times to the modem side of the
+ * pseudo-terminal, then wait for all the expected responses.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReplayTrace
+(
+    int masterFd,
+    uint32_t replayCount,
+    uint32_t expectedCount
+)
+{
+    le_clk_Time_t timeout = { TIMEOUT_SEC, 0 };
+    uint32_t i;
+
+    for (i = 0; i < SUBSCRIPTION_COUNT; i++)
+    {
+        Subscriptions[i].count = 0;
+    }
+
+    ReceivedCount = 0;
+    ExpectedCount = expectedCount;
+
+    for (i = 0; i < replayCount; i++)
+    {
+        const char* bufPtr = ModemTrace;
+        size_t remaining = sizeof(ModemTrace) - 1;
+
+        while (remaining > 0)
+        {
+            ssize_t size = write(masterFd, bufPtr, remaining);
+
+            LE_ASSERT(size > 0);
+            bufPtr += size;
+            remaining -= size;
+        }
+    }
+
+    LE_ASSERT_OK(le_sem_WaitWithTimeOut(ExpectedSem, timeout));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the unsolicited responses received for one trace.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestUnsolicited
+(
+    int masterFd
+)
+{
+    uint32_t expectedCount = 0;
+    uint32_t i;
+
+    LE_INFO("======== Test unsolicited responses ========");
+
+    for (i = 0; i < SUBSCRIPTION_COUNT; i++)
+    {
+        expectedCount += Subscriptions[i].traceCount;
+    }
+
+    ReplayTrace(masterFd, 1, expectedCount);
+
+    for (i = 0; i < SUBSCRIPTION_COUNT; i++)
+    {
+        LE_ASSERT(Subscriptions[i].count == Subscriptions[i].traceCount);
+    }
+
+    LE_ASSERT(strcmp(Subscriptions[0].lastRsp, "+CREG: 1,\"0F3C\",\"01A2B3C4\",7") == 0);
+    LE_ASSERT(strcmp(Subscriptions[1].lastRsp, "+CGEV: NW DETACH") == 0);
+    LE_ASSERT(strcmp(Subscriptions[2].lastRsp,
+                     "+CMT: \"+33612345678\",,\"17/05/02,10:31:00+08\"\r\nHello world") == 0);
+    LE_ASSERT(strcmp(Subscriptions[3].lastRsp, "RING") == 0);
+
+    LE_INFO("======== Test removed subscription ========");
+
+    le_atClient_RemoveUnsolicitedResponseHandler(Subscriptions[1].ref);
+
+    // The subscription is released by the device thread; give it time to do so.
+    usleep(100000);
+
+    ReplayTrace(masterFd, 1, expectedCount - Subscriptions[1].traceCount);
+
+    LE_ASSERT(Subscriptions[0].count == 1);
+    LE_ASSERT(Subscriptions[1].count == 0);
+    LE_ASSERT(Subscriptions[2].count == 1);
+    LE_ASSERT(Subscriptions[3].count == 1);
+
+    Subscriptions[1].traceCount = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the line processing throughput.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestThroughput
+(
+    int masterFd
+)
+{
+    uint32_t expectedCount = 0;
+    uint32_t lineCount = 0;
+    uint32_t i;
+
+    LE_INFO("======== Test throughput ========");
+
+    for (i = 0; i < SUBSCRIPTION_COUNT; i++)
+    {
+        expectedCount += Subscriptions[i].traceCount;
+    }
+
+    for (i = 0; i < sizeof(ModemTrace) - 1; i++)
+    {
+        if (ModemTrace[i] == '\n')
+        {
+            lineCount++;
+        }
+    }
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    ReplayTrace(masterFd, REPLAY_COUNT, expectedCount * REPLAY_COUNT);
+
+    le_clk_Time_t duration = le_clk_Sub(le_clk_GetRelativeTime(), start);
+    double seconds = duration.sec + duration.usec / 1000000.0;
+
+    for (i = 0; i < SUBSCRIPTION_COUNT; i++)
+    {
+        LE_ASSERT(Subscriptions[i].count == Subscriptions[i].traceCount * REPLAY_COUNT);
+    }
+
+    LE_INFO("%u trace lines with %u subscriptions in %.3f s: %.0f lines/s",
+            lineCount * REPLAY_COUNT,
+            (uint32_t)(SUBSCRIPTION_COUNT - 1 + DUMMY_COUNT),
+            seconds,
+            (seconds > 0) ? (lineCount * REPLAY_COUNT) / seconds : 0.0);
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -20,6 +283,53 @@ COMPONENT_INIT
 
     LE_INFO("======== START UnitTest of AT CLIENT API ========");
 
+    // The modem side of the pseudo-terminal is written by the test, the other side is monitored
+    // by the AT client.
+    int masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    LE_ASSERT(masterFd != -1);
+    LE_ASSERT(grantpt(masterFd) == 0);
+    LE_ASSERT(unlockpt(masterFd) == 0);
+
+    int slaveFd = open(ptsname(masterFd), O_RDWR | O_NOCTTY);
+    LE_ASSERT(slaveFd != -1);
+
+    struct termios term;
+    LE_ASSERT(tcgetattr(slaveFd, &term) == 0);
+    cfmakeraw(&term);
+    LE_ASSERT(tcsetattr(slaveFd, TCSANOW, &term) == 0);
+
+    ExpectedSem = le_sem_Create("ExpectedSem", 0);
+
+    le_atClient_DeviceRef_t devRef = le_atClient_Start(slaveFd);
+    LE_ASSERT(devRef != NULL);
+
+    uint32_t i;
+    char pattern[LE_ATDEFS_UNSOLICITED_MAX_BYTES];
+
+    for (i = 0; i < DUMMY_COUNT; i++)
+    {
+        snprintf(pattern, sizeof(pattern), "+XDUMMY%u:", i);
+        LE_ASSERT(le_atClient_AddUnsolicitedResponseHandler(pattern,
+                                                            devRef,
+                                                            DummyHandler,
+                                                            NULL,
+                                                            1) != NULL);
+    }
+
+    for (i = 0; i < SUBSCRIPTION_COUNT; i++)
+    {
+        Subscriptions[i].ref = le_atClient_AddUnsolicitedResponseHandler(
+                                                            Subscriptions[i].patternPtr,
+                                                            devRef,
+                                                            UnsolicitedHandler,
+                                                            &Subscriptions[i],
+                                                            Subscriptions[i].lineCount);
+        LE_ASSERT(Subscriptions[i].ref != NULL);
+    }
+
+    TestUnsolicited(masterFd);
+    TestThroughput(masterFd);
+
     LE_INFO("======== UnitTest of AT CLIENT API FINISHED ========");
     exit(0);
 }
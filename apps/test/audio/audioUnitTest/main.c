@@ -13,9 +13,13 @@
 #include "pa_pcm_simu.h"
 #include "pa_audio_simu.h"
 #include <string.h>
+#include <math.h>
 
 #define BUFFER_LEN  5000
 
+// Amplitude of each of the two tones of a played DTMF (40% of the full scale)
+#define DTMF_TONE_AMPLITUDE  (32767 * 40 / 100)
+
 static le_sem_Ref_t    ThreadSemaphore;
 static le_thread_Ref_t TestThreadRef;
 static int Pipefd[2];
@@ -29,6 +33,9 @@ static char Dtmf;
 static char DtmfList[]="0123456789ABCD*#";
 static uint32_t DtmfDuration = 10;
 static uint32_t DtmfPause = 20;
+static const char DtmfKeypad[]="123A456B789C*0#D";
+static const uint32_t DtmfLowFreq[] = {697, 770, 852, 941};
+static const uint32_t DtmfHighFreq[] = {1209, 1336, 1477, 1633};
 static le_audio_StreamRef_t FakeStreamRef;
 static le_audio_StreamRef_t StreamRef[LE_AUDIO_NUM_INTERFACES];
 
@@ -42,8 +49,12 @@ enum
     TEST_REC_SAMPLES,
     TEST_REC_FILES,
     TEST_DTMF_DECODING,
+    TEST_REC_DTMF_DECODING,
     TEST_PLAY_DTMF,
     TEST_PLAY_DTMF_IN_PROGRESS,
+    TEST_PLAY_MIXED_DTMF,
+    TEST_PLAY_MIXED_DTMF_IN_PROGRESS,
+    TEST_PLAY_MIXED_DTMF_ENDED,
     TEST_LAST
 } TestCase;
 
@@ -145,7 +156,7 @@ static void DestroyTestThread
     void *contextPtr
 )
 {
-    if (TestCase == TEST_DTMF_DECODING)
+    if ((TestCase == TEST_DTMF_DECODING) || (TestCase == TEST_REC_DTMF_DECODING))
     {
         le_audio_RemoveDtmfDetectorHandler(DtmfDetectorHandlerRef);
     }
@@ -207,6 +218,18 @@ static void MyMediaHandler
             LE_ASSERT(event == LE_AUDIO_MEDIA_ENDED);
             TestCase = TEST_LAST;
         break;
+        case TEST_PLAY_MIXED_DTMF_IN_PROGRESS:
+            // The samples may run dry while the DTMFs are mixed over them
+            if (event == LE_AUDIO_MEDIA_NO_MORE_SAMPLES)
+            {
+                return;
+            }
+            LE_ASSERT(event == LE_AUDIO_MEDIA_ENDED);
+            TestCase = TEST_PLAY_MIXED_DTMF_ENDED;
+        break;
+        case TEST_PLAY_MIXED_DTMF_ENDED:
+            LE_ASSERT(event == LE_AUDIO_MEDIA_NO_MORE_SAMPLES);
+            return;
         default:
             LE_FATAL("Unexpected event %d", TestCase);
         break;
@@ -251,7 +274,7 @@ static void* TestThread
 {
     le_audio_StreamRef_t myStreamRef = (le_audio_StreamRef_t) contextPtr;
 
-    if (TestCase == TEST_DTMF_DECODING)
+    if ((TestCase == TEST_DTMF_DECODING) || (TestCase == TEST_REC_DTMF_DECODING))
     {
         // Add a dtmf decoding handler for this test
         DtmfDetectorHandlerRef = le_audio_AddDtmfDetectorHandler(myStreamRef,
@@ -269,7 +292,8 @@ static void* TestThread
     // Try to subscribe another handler on a different stream. This handler shouldn't be called
     if ((TestCase == TEST_PLAY_SAMPLES) ||
         (TestCase == TEST_PLAY_FILES) ||
-        (TestCase == TEST_PLAY_DTMF))
+        (TestCase == TEST_PLAY_DTMF) ||
+        (TestCase == TEST_PLAY_MIXED_DTMF))
     {
         // for play tests, subscribe to recorder stream
         FakeStreamRef = le_audio_OpenRecorder();
@@ -303,10 +327,20 @@ static void* TestThread
         case TEST_REC_FILES:
             LE_ASSERT(le_audio_RecordFile(myStreamRef, FileFd) == LE_OK);
         break;
+        case TEST_REC_DTMF_DECODING:
+            LE_ASSERT(le_audio_GetSamples(myStreamRef, Pipefd[1]) == LE_OK);
+        break;
         case TEST_PLAY_DTMF:
             TestCase = TEST_PLAY_DTMF_IN_PROGRESS;
             LE_ASSERT(le_audio_PlayDtmf(myStreamRef, DtmfList, DtmfDuration, DtmfPause) == LE_OK);
         break;
+        case TEST_PLAY_MIXED_DTMF:
+            TestCase = TEST_PLAY_MIXED_DTMF_IN_PROGRESS;
+            LE_ASSERT(le_audio_PlaySamples(myStreamRef, Pipefd[0]) == LE_OK);
+            LE_ASSERT(le_audio_PlayDtmf(myStreamRef, "5", DtmfDuration, DtmfPause) == LE_OK);
+            // Only one DTMF sequence can be mixed at a time
+            LE_ASSERT(le_audio_PlayDtmf(myStreamRef, "5", DtmfDuration, DtmfPause) == LE_BUSY);
+        break;
         default:
         break;
     }
@@ -991,11 +1025,257 @@ void Testle_audio_DecodingDtmf
     LE_ASSERT(le_sem_GetValue(ThreadSemaphore) == 0);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Capture a tone followed by a silence on a recorder stream, and check the detected DTMF.
+ * The first half of the pa_pcm_simu buffer is filled with the sum of two sine waves, and the
+ * second half with a silence. The pa_pcm_simu loops on this buffer, the captured samples are read
+ * until the whole buffer went twice through the DTMF detector.
+ *
+ * Exit if failed
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CaptureTone
+(
+    uint32_t lowFreq,   ///< [IN] Frequency of the first sine wave in Hertz, 0 for none.
+    uint32_t highFreq,  ///< [IN] Frequency of the second sine wave in Hertz, 0 for none.
+    char     dtmf       ///< [IN] Expected DTMF, '\0' if no DTMF must be detected.
+)
+{
+    le_audio_StreamRef_t captureStreamRef = NULL;
+    int16_t* samplesPtr;
+    uint32_t samplesCount = BUFFER_LEN / sizeof(int16_t);
+    uint8_t readBuffer[512];
+    uint32_t readLen = 0;
+    ssize_t len;
+    uint32_t i;
+
+    LE_ASSERT(pipe(Pipefd) == 0);
+
+    // init the pcm buffer in pa_pcm_simu side.
+    pa_pcmSimu_InitData(BUFFER_LEN);
+
+    // The recorder default configuration is 8kHz mono 16-bit
+    samplesPtr = (int16_t*) pa_pcmSimu_GetDataPtr();
+    memset(samplesPtr, 0, BUFFER_LEN);
+    for (i = 0; i < samplesCount/2; i++)
+    {
+        double sample = 0;
+
+        if (lowFreq)
+        {
+            sample += 8000 * sin(2 * M_PI * lowFreq * i / 8000);
+        }
+        if (highFreq)
+        {
+            sample += 8000 * sin(2 * M_PI * highFreq * i / 8000);
+        }
+        samplesPtr[i] = (int16_t) sample;
+    }
+
+    // open the recorder stream
+    captureStreamRef = le_audio_OpenRecorder();
+    LE_ASSERT(captureStreamRef != NULL);
+
+    // Set the test case. DtmfDecodingHandler fails on any detected DTMF other than this one.
+    TestCase = TEST_REC_DTMF_DECODING;
+    Dtmf = dtmf;
+
+    // Create the test thread which will execute le_audio_AddDtmfDetectorHandler and
+    // le_audio_GetSamples
+    CreateTestThread(captureStreamRef);
+
+    // The samples are looked for DTMFs before being written on the pipe
+    while (readLen < 2 * BUFFER_LEN)
+    {
+        len = read(Pipefd[0], readBuffer, sizeof(readBuffer));
+        LE_ASSERT(len > 0);
+        readLen += len;
+    }
+
+    if (dtmf != '\0')
+    {
+        // Wait for the dtmf detection
+        le_sem_Wait(ThreadSemaphore);
+    }
+    else
+    {
+        // Leave time to a detection to be reported
+        le_clk_Time_t timeout = {0, 100000};
+        LE_ASSERT(le_sem_WaitWithTimeOut(ThreadSemaphore, timeout) == LE_TIMEOUT);
+    }
+
+    // Drain the pipe, so that the capture can't be blocked on a full pipe when it is stopped
+    LE_ASSERT(fcntl(Pipefd[0], F_SETFL, O_NONBLOCK) == 0);
+    while (read(Pipefd[0], readBuffer, sizeof(readBuffer)) > 0)
+    {
+    }
+
+    // Stop the capture
+    LE_ASSERT(le_audio_Stop(captureStreamRef) == LE_OK);
+
+    // Close the output pipe
+    close(Pipefd[0]);
+
+    // Release buffer in pa_pcm_simu
+    pa_pcmSimu_ReleaseData();
+
+    // Stop the test thread
+    le_thread_Cancel(TestThreadRef);
+    le_thread_Join(TestThreadRef,NULL);
+
+    // close the recorder stream
+    le_audio_Close(captureStreamRef);
+
+    // The captured buffer is looped by the pa_pcm_simu, so the DTMF may have been detected again
+    // before the capture was stopped
+    while (le_sem_TryWait(ThreadSemaphore) == LE_OK)
+    {
+    }
+
+    // Check that no more call of the semaphore
+    LE_ASSERT(le_sem_GetValue(ThreadSemaphore) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the dtmf decoding functionality on a recorder stream.
+ * DTMFs followed by a silence are captured by the pa_pcm_simu, the test checks that they are
+ * detected in the captured samples. The test then checks that a single tone and a silence are not
+ * detected as a DTMF.
+ *
+ * API tested:
+ * - le_audio_AddDtmfDetectorHandler
+ * - le_audio_GetSamples
+ *
+ * Exit if failed
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void Testle_audio_CaptureDtmf
+(
+    void
+)
+{
+    // DTMF '5'
+    CaptureTone(770, 1336, '5');
+
+    // DTMF '#'
+    CaptureTone(941, 1477, '#');
+
+    // The row tone of the DTMF '5' alone
+    CaptureTone(770, 0, '\0');
+
+    // Silence
+    CaptureTone(0, 0, '\0');
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the amplitude of the frequency component of a tone.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ToneAmplitude
+(
+    const int16_t* samplesPtr,  ///< [IN] Samples of the tone
+    uint32_t       samplesCount,///< [IN] Number of samples
+    uint32_t       freq,        ///< [IN] Frequency in Hertz
+    uint32_t       sampleRate   ///< [IN] Sample frequency in Hertz
+)
+{
+    double re = 0;
+    double im = 0;
+    uint32_t i;
+
+    for (i = 0; i < samplesCount; i++)
+    {
+        re += samplesPtr[i] * cos(2 * M_PI * freq * i / sampleRate);
+        im -= samplesPtr[i] * sin(2 * M_PI * freq * i / sampleRate);
+    }
+
+    return 2 * sqrt(re * re + im * im) / samplesCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the samples of the played DTMFs: each DTMF is made of a tone at its two frequencies, with
+ * the expected amplitude and without saturation, followed by a silence.
+ *
+ * Exit if failed
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckDtmfSamples
+(
+    const int16_t* samplesPtr,  ///< [IN] Played samples
+    uint32_t       sampleRate   ///< [IN] Sample frequency in Hertz
+)
+{
+    uint32_t toneCount = sampleRate * DtmfDuration / 1000;
+    uint32_t pauseCount = sampleRate * DtmfPause / 1000;
+    uint32_t d;
+    uint32_t i;
+
+    for (d = 0; d < strlen(DtmfList); d++)
+    {
+        const int16_t* tonePtr = samplesPtr + d * (toneCount + pauseCount);
+        uint32_t key = strchr(DtmfKeypad, DtmfList[d]) - DtmfKeypad;
+        int32_t peak = 0;
+
+        // The oscillators start from a zero sample
+        LE_ASSERT(tonePtr[0] == 0);
+
+        for (i = 0; i < toneCount; i++)
+        {
+            peak = (abs(tonePtr[i]) > peak) ? abs(tonePtr[i]) : peak;
+        }
+        LE_ASSERT(peak > DTMF_TONE_AMPLITUDE);
+        LE_ASSERT(peak <= 2 * DTMF_TONE_AMPLITUDE);
+
+        // Over a DTMF duration, the leakage of the other tone stays below half the amplitude
+        for (i = 0; i < NUM_ARRAY_MEMBERS(DtmfLowFreq); i++)
+        {
+            double amplitude = ToneAmplitude(tonePtr, toneCount, DtmfLowFreq[i], sampleRate);
+
+            if (i == key / 4)
+            {
+                LE_ASSERT(amplitude > 0.9 * DTMF_TONE_AMPLITUDE);
+                LE_ASSERT(amplitude < 1.1 * DTMF_TONE_AMPLITUDE);
+            }
+            else
+            {
+                LE_ASSERT(amplitude < 0.5 * DTMF_TONE_AMPLITUDE);
+            }
+        }
+        for (i = 0; i < NUM_ARRAY_MEMBERS(DtmfHighFreq); i++)
+        {
+            double amplitude = ToneAmplitude(tonePtr, toneCount, DtmfHighFreq[i], sampleRate);
+
+            if (i == key % 4)
+            {
+                LE_ASSERT(amplitude > 0.9 * DTMF_TONE_AMPLITUDE);
+                LE_ASSERT(amplitude < 1.1 * DTMF_TONE_AMPLITUDE);
+            }
+            else
+            {
+                LE_ASSERT(amplitude < 0.5 * DTMF_TONE_AMPLITUDE);
+            }
+        }
+
+        for (i = toneCount; i < toneCount + pauseCount; i++)
+        {
+            LE_ASSERT(tonePtr[i] == 0);
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test the dtmf playing functionality.
  * Sub-test 1 : dtmf is played over the network
- * Sub-test 2 : dtmf are played over the network and in local mode.
+ * Sub-test 2 : dtmf are played over the network and in local mode. The frequencies and the
+ *              amplitude of the locally played samples are checked.
  *
  * API tested:
  * - le_audio_PlaySignallingDtmf
@@ -1044,11 +1324,89 @@ void Testle_audio_PlayDtmf
     // Get the buffer address of the received data in the pa_pcm_simu
     uint8_t* dataPtr = pa_pcmSimu_GetDataPtr();
 
-    // Check that something has been wrote
-    LE_ASSERT((uint32_t) *dataPtr == 0x00000000);
+    // Check the frequencies and the amplitude of the played DTMFs
+    CheckDtmfSamples((const int16_t*) dataPtr, sampleRate);
+
+    pa_pcmSimu_ReleaseData();
+
+    // Stop the test thread
+    le_thread_Cancel(TestThreadRef);
+    le_thread_Join(TestThreadRef,NULL);
+
+    // close the player stream
+    le_audio_Close(playbackStreamRef);
+
+    // Check that no more call of the semaphore
+    LE_ASSERT(le_sem_GetValue(ThreadSemaphore) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the dtmf playing functionality over played samples.
+ * The DTMFs are mixed over the samples. The test checks that the end of the DTMFs is reported
+ * while the samples go on playing, and that another DTMF sequence can then be mixed.
+ *
+ * API tested:
+ * - le_audio_PlaySamples
+ * - le_audio_PlayDtmf
+ * - le_audio_AddMediaHandler
+ * - le_audio_Stop
+ *
+ * Exit if failed
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void Testle_audio_PlayMixedDtmf
+(
+    void
+)
+{
+    int i;
+    le_audio_StreamRef_t playbackStreamRef = NULL;
+
+    LE_ASSERT(pipe(Pipefd) == 0);
 
+    // init the pcm buffer in pa_pcm_simu side.
+    pa_pcmSimu_InitData(BUFFER_LEN);
+
+    // open the player stream
+    playbackStreamRef = le_audio_OpenPlayer();
+    LE_ASSERT(playbackStreamRef != NULL);
+
+    // Set the test case
+    TestCase = TEST_PLAY_MIXED_DTMF;
+
+    for (i=0; i < BUFFER_LEN; i++)
+    {
+        LE_ASSERT(write(Pipefd[1],&Buffer[i],1) == 1);
+    }
+
+    // Create the test thread which will execute le_audio_PlaySamples and le_audio_PlayDtmf
+    CreateTestThread(playbackStreamRef);
+
+    // Wait the event LE_AUDIO_MEDIA_ENDED of the DTMFs
+    le_sem_Wait(ThreadSemaphore);
+
+    // The ended DTMFs are released, so that other DTMFs can be mixed over the samples
+    TestCase = TEST_PLAY_MIXED_DTMF_IN_PROGRESS;
+    LE_ASSERT(le_audio_PlayDtmf(playbackStreamRef, "5", DtmfDuration, DtmfPause) == LE_OK);
+    le_sem_Wait(ThreadSemaphore);
+
+    // Get the buffer address of the received data in the pa_pcm_simu
+    uint8_t* sentPcmPtr = pa_pcmSimu_GetDataPtr();
+
+    // The DTMFs are added to the samples
+    LE_ASSERT(memcmp(Buffer, sentPcmPtr, BUFFER_LEN) != 0);
+
+    // Release buffer in pa_pcm_simu
     pa_pcmSimu_ReleaseData();
 
+    // Stop
+    LE_ASSERT(le_audio_Stop(playbackStreamRef) == LE_OK);
+
+    // Close the input pipe
+    close(Pipefd[1]);
+
     // Stop the test thread
     le_thread_Cancel(TestThreadRef);
     le_thread_Join(TestThreadRef,NULL);
@@ -1197,9 +1555,15 @@ COMPONENT_INIT
     LE_INFO("======== Test decoding dtmf ========");
     Testle_audio_DecodingDtmf();
 
+    LE_INFO("======== Test capture dtmf ========");
+    Testle_audio_CaptureDtmf();
+
     LE_INFO("======== Test play dtmf ========");
     Testle_audio_PlayDtmf();
 
+    LE_INFO("======== Test play dtmf over samples ========");
+    Testle_audio_PlayMixedDtmf();
+
     LE_INFO("======== Test Echo canceller and Noise suppressor ========");
     Testle_audio_EchoCancellerNoiseSuppressor();
 
@@ -0,0 +1,412 @@
+/**
+ * This module implements the unit tests of the audio software mixer.
+ *
+ * The mixed samples are played by a file-backed stand-in of the PCM platform adaptor, which pulls
+ * the frames period by period like pa_pcm does, and writes them into a file instead of a sound
+ * card.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "le_audio_local.h"
+#include "le_mixer_local.h"
+#include "pa_pcm.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the periods played by the PCM stand-in, in bytes. This is a multiple of the frame sizes
+ * of all the tests.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PERIOD_SIZE     960
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time the PCM stand-in waits for the samples of a period, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PERIOD_USEC     20000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of frames of the test inputs.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FRAMES_NB       1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File receiving the samples played by the PCM stand-in.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PcmFileFd;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Played samples read back from the PCM file.
+ */
+//--------------------------------------------------------------------------------------------------
+static int16_t PlayedSamples[4 * FRAMES_NB * 2];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the frames of a period from the mixer. This is the callback given to the PCM platform
+ * adaptor by le_media.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetMixedFrames
+(
+    uint8_t* bufferPtr,
+    uint32_t* bufsizePtr,
+    void* contextPtr
+)
+{
+    return le_mixer_Read((le_mixer_Ref_t)contextPtr, bufferPtr, bufsizePtr, PERIOD_USEC);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File-backed PCM playback: the frames are pulled period by period and written into the PCM file
+ * until less than a period is received, then the PCM file is read back into PlayedSamples.
+ *
+ * @return The number of bytes played.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t PlayToFile
+(
+    GetSetFramesFunc_t getFramesFunc,
+    void*              contextPtr
+)
+{
+    uint8_t  period[PERIOD_SIZE];
+    uint32_t total = 0;
+    uint32_t len;
+
+    LE_ASSERT(ftruncate(PcmFileFd, 0) == 0);
+    LE_ASSERT(lseek(PcmFileFd, 0, SEEK_SET) == 0);
+
+    do
+    {
+        len = PERIOD_SIZE;
+        LE_ASSERT(getFramesFunc(period, &len, contextPtr) == LE_OK);
+        LE_ASSERT(write(PcmFileFd, period, len) == len);
+        total += len;
+    }
+    while (len == PERIOD_SIZE);
+
+    LE_ASSERT(total <= sizeof(PlayedSamples));
+    LE_ASSERT(lseek(PcmFileFd, 0, SEEK_SET) == 0);
+    LE_ASSERT(read(PcmFileFd, PlayedSamples, total) == total);
+
+    return total;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a pipe filled with the given samples.
+ *
+ * @return The read end of the pipe.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CreateInput
+(
+    const void* samplesPtr,
+    uint32_t    len,
+    bool        closeInput,     ///< Close the write end to signal the end of the samples
+    int*        writeFdPtr      ///< Write end of the pipe, if not closed
+)
+{
+    int pipefd[2];
+
+    LE_ASSERT(pipe(pipefd) == 0);
+    LE_ASSERT(write(pipefd[1], samplesPtr, len) == len);
+
+    if (closeInput)
+    {
+        close(pipefd[1]);
+    }
+    else
+    {
+        *writeFdPtr = pipefd[1];
+    }
+
+    return pipefd[0];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build a PCM configuration.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_audio_SamplePcmConfig_t PcmConfig
+(
+    uint32_t sampleRate,
+    uint16_t channelsCount,
+    uint16_t bitsPerSample
+)
+{
+    le_audio_SamplePcmConfig_t config;
+
+    config.sampleRate = sampleRate;
+    config.channelsCount = channelsCount;
+    config.bitsPerSample = bitsPerSample;
+    config.byteRate = sampleRate * channelsCount * bitsPerSample / 8;
+
+    return config;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test that a single input in the output configuration is played unchanged, including an
+ * incomplete last frame, and whatever its sample size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestPassthrough
+(
+    void
+)
+{
+    le_audio_SamplePcmConfig_t config = PcmConfig(8000, 2, 24);
+    uint8_t samples[FRAMES_NB * 6 + 1];
+    uint32_t i;
+
+    for (i = 0; i < sizeof(samples); i++)
+    {
+        samples[i] = i % 251;
+    }
+
+    int fd = CreateInput(samples, sizeof(samples), true, NULL);
+    le_mixer_Ref_t mixerRef = le_mixer_Create(&config);
+    le_mixer_InputRef_t inputRef = le_mixer_AddInput(mixerRef, fd, &config, LE_MIXER_GAIN_UNITY);
+
+    LE_ASSERT(inputRef != NULL);
+
+    // 24-bit samples can't be mixed
+    le_audio_SamplePcmConfig_t monoConfig = PcmConfig(8000, 1, 16);
+    LE_ASSERT(le_mixer_AddInput(mixerRef, fd, &monoConfig, LE_MIXER_GAIN_UNITY) == NULL);
+
+    LE_ASSERT(PlayToFile(GetMixedFrames, mixerRef) == sizeof(samples));
+    LE_ASSERT(memcmp(PlayedSamples, samples, sizeof(samples)) == 0);
+    LE_ASSERT(le_mixer_IsInputEnded(inputRef));
+
+    le_mixer_Delete(mixerRef);
+
+    // The file descriptor is back to blocking mode
+    LE_ASSERT((fcntl(fd, F_GETFL) & O_NONBLOCK) == 0);
+    close(fd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the mixing of a stereo input with a mono input at half gain.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestMix
+(
+    void
+)
+{
+    le_audio_SamplePcmConfig_t stereoConfig = PcmConfig(16000, 2, 16);
+    le_audio_SamplePcmConfig_t monoConfig = PcmConfig(16000, 1, 16);
+    int16_t stereoSamples[FRAMES_NB * 2];
+    int16_t monoSamples[FRAMES_NB / 2];
+    uint32_t i;
+
+    for (i = 0; i < FRAMES_NB; i++)
+    {
+        stereoSamples[2 * i] = i;
+        stereoSamples[2 * i + 1] = -i;
+    }
+    for (i = 0; i < FRAMES_NB / 2; i++)
+    {
+        monoSamples[i] = 2000;
+    }
+
+    int stereoFd = CreateInput(stereoSamples, sizeof(stereoSamples), true, NULL);
+    int monoFd = CreateInput(monoSamples, sizeof(monoSamples), true, NULL);
+    le_mixer_Ref_t mixerRef = le_mixer_Create(&stereoConfig);
+
+    LE_ASSERT(le_mixer_AddInput(mixerRef, stereoFd, &stereoConfig, LE_MIXER_GAIN_UNITY) != NULL);
+    le_mixer_InputRef_t monoRef = le_mixer_AddInput(mixerRef, monoFd, &monoConfig,
+                                                    LE_MIXER_GAIN_UNITY);
+    LE_ASSERT(monoRef != NULL);
+    LE_ASSERT(le_mixer_SetGain(monoRef, LE_MIXER_GAIN_MAX + 1) == LE_OUT_OF_RANGE);
+    LE_ASSERT(le_mixer_SetGain(monoRef, LE_MIXER_GAIN_UNITY / 2) == LE_OK);
+
+    // The stereo input is longer: the mono input is silent once ended
+    LE_ASSERT(PlayToFile(GetMixedFrames, mixerRef) == sizeof(stereoSamples));
+
+    for (i = 0; i < FRAMES_NB; i++)
+    {
+        int16_t mono = (i < FRAMES_NB / 2) ? 1000 : 0;
+
+        LE_ASSERT(PlayedSamples[2 * i] == (int16_t)(i + mono));
+        LE_ASSERT(PlayedSamples[2 * i + 1] == (int16_t)(mono - i));
+    }
+
+    le_mixer_Delete(mixerRef);
+    close(stereoFd);
+    close(monoFd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test that the mixed samples saturate instead of wrapping around.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestSaturation
+(
+    void
+)
+{
+    le_audio_SamplePcmConfig_t config = PcmConfig(16000, 1, 16);
+    int16_t samples1[FRAMES_NB];
+    int16_t samples2[FRAMES_NB];
+    uint32_t i;
+
+    for (i = 0; i < FRAMES_NB; i++)
+    {
+        samples1[i] = (i & 1) ? 30000 : -30000;
+        samples2[i] = samples1[i];
+    }
+
+    int fd1 = CreateInput(samples1, sizeof(samples1), true, NULL);
+    int fd2 = CreateInput(samples2, sizeof(samples2), true, NULL);
+    le_mixer_Ref_t mixerRef = le_mixer_Create(&config);
+
+    LE_ASSERT(le_mixer_AddInput(mixerRef, fd1, &config, LE_MIXER_GAIN_UNITY) != NULL);
+    LE_ASSERT(le_mixer_AddInput(mixerRef, fd2, &config, LE_MIXER_GAIN_UNITY) != NULL);
+
+    LE_ASSERT(PlayToFile(GetMixedFrames, mixerRef) == sizeof(samples1));
+
+    for (i = 0; i < FRAMES_NB; i++)
+    {
+        LE_ASSERT(PlayedSamples[i] == ((i & 1) ? INT16_MAX : INT16_MIN));
+    }
+
+    le_mixer_Delete(mixerRef);
+    close(fd1);
+    close(fd2);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the conversion of an 8 kHz input to 16 kHz. The linear interpolation of a ramp is exact:
+ * the output starts from the silence before the input, and then interleaves the input samples
+ * with their midpoints.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestResampling
+(
+    void
+)
+{
+    le_audio_SamplePcmConfig_t inConfig = PcmConfig(8000, 1, 16);
+    le_audio_SamplePcmConfig_t outConfig = PcmConfig(16000, 1, 16);
+    int16_t samples[FRAMES_NB];
+    uint32_t i;
+
+    for (i = 0; i < FRAMES_NB; i++)
+    {
+        samples[i] = 8 * i;
+    }
+
+    int fd = CreateInput(samples, sizeof(samples), true, NULL);
+    le_mixer_Ref_t mixerRef = le_mixer_Create(&outConfig);
+
+    LE_ASSERT(le_mixer_AddInput(mixerRef, fd, &inConfig, LE_MIXER_GAIN_UNITY) != NULL);
+
+    uint32_t frames = PlayToFile(GetMixedFrames, mixerRef) / sizeof(int16_t);
+
+    LE_ASSERT(frames == 2 * FRAMES_NB);
+    LE_ASSERT(PlayedSamples[0] == 0);
+
+    for (i = 2; i < frames; i++)
+    {
+        LE_ASSERT(PlayedSamples[i] == (int16_t)(4 * (i - 2)));
+    }
+
+    le_mixer_Delete(mixerRef);
+    close(fd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test that the playback ends when no sample is received within a period, and that a flush drops
+ * the pending samples.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestUnderflowAndFlush
+(
+    void
+)
+{
+    le_audio_SamplePcmConfig_t config = PcmConfig(16000, 1, 16);
+    int16_t samples[FRAMES_NB];
+    int writeFd;
+
+    memset(samples, 0x55, sizeof(samples));
+
+    int fd = CreateInput(samples, sizeof(samples), false, &writeFd);
+    le_mixer_Ref_t mixerRef = le_mixer_Create(&config);
+    le_mixer_InputRef_t inputRef = le_mixer_AddInput(mixerRef, fd, &config, LE_MIXER_GAIN_UNITY);
+
+    LE_ASSERT(inputRef != NULL);
+
+    // The write end is still open: the playback ends after a period without samples
+    LE_ASSERT(PlayToFile(GetMixedFrames, mixerRef) == sizeof(samples));
+    LE_ASSERT(!le_mixer_IsInputEnded(inputRef));
+
+    LE_ASSERT(write(writeFd, samples, sizeof(samples)) == sizeof(samples));
+    le_mixer_Flush(mixerRef);
+    close(writeFd);
+
+    LE_ASSERT(PlayToFile(GetMixedFrames, mixerRef) == 0);
+    LE_ASSERT(le_mixer_IsInputEnded(inputRef));
+
+    le_mixer_RemoveInput(inputRef);
+    le_mixer_Delete(mixerRef);
+    close(fd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * main of the test
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    char pcmFileName[] = "/tmp/mixerUnitTestXXXXXX";
+
+    PcmFileFd = mkstemp(pcmFileName);
+    LE_ASSERT(PcmFileFd != -1);
+    unlink(pcmFileName);
+
+    le_mixer_Init();
+
+    LE_INFO("======== Start UnitTest of audio mixer ========");
+
+    LE_INFO("======== Test passthrough ========");
+    TestPassthrough();
+
+    LE_INFO("======== Test mix ========");
+    TestMix();
+
+    LE_INFO("======== Test saturation ========");
+    TestSaturation();
+
+    LE_INFO("======== Test resampling ========");
+    TestResampling();
+
+    LE_INFO("======== Test underflow and flush ========");
+    TestUnderflowAndFlush();
+
+    close(PcmFileFd);
+
+    LE_INFO("======== UnitTest of audio mixer ends with SUCCESS ========");
+    exit(0);
+}
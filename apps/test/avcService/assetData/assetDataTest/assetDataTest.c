@@ -6,6 +6,12 @@
 
 #include "assetData.h"
 #include "le_print.h"
+#include "paAvcStub.h"
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+#include "tinycbor/cbor.h"
+#include "zlib.h"
+#endif
 
 
 
@@ -230,6 +236,21 @@ void RunTest(void)
     LE_TEST( assetData_GetAssetRefById("testOne", 1000, &testOneAssetRef) == LE_OK );
 
 
+    banner("Look up instances and fields");
+    assetData_InstanceDataRef_t instanceRef;
+    int fieldId;
+
+    LE_TEST( assetData_GetInstanceRefById("lwm2m", 9, 4, &instanceRef) == LE_OK );
+    LE_TEST( instanceRef == lwm2mRefOne );
+    LE_TEST( assetData_GetInstanceRefById("lwm2m", 9, 5, &instanceRef) == LE_NOT_FOUND );
+
+    LE_TEST( assetData_GetFieldIdFromName(lwm2mRefZero, "Update State", &fieldId) == LE_OK );
+    LE_TEST( fieldId == 7 );
+    LE_TEST( assetData_GetFieldIdFromName(lwm2mRefOne, "Activate", &fieldId) == LE_OK );
+    LE_TEST( fieldId == 10 );
+    LE_TEST( assetData_GetFieldIdFromName(lwm2mRefZero, "Unknown", &fieldId) == LE_FAULT );
+
+
     banner("Read/Write integer fields");
     int value;
 
@@ -384,7 +405,142 @@ void RunTest(void)
 
     LE_TEST( bytesWrittenOne == bytesWrittenTwo );
     LE_TEST( memcmp(tlvBufferOne, tlvBufferTwo, bytesWrittenOne) == 0 );
+
+
+    banner("TLV cache Testing");
+    uint8_t tlvBufferLarge[512];
+    size_t bytesWrittenLarge;
+    char longStr[201];
+
+    // Reading the fields doesn't change the cached TLV list
+    LE_TEST( assetData_client_GetString(lwm2mRefZero, 0, strBuf, sizeof(strBuf)) == LE_OK );
+    LE_TEST( assetData_WriteFieldListToTLV(lwm2mRefZero, tlvBufferTwo, sizeof(tlvBufferTwo), &bytesWrittenTwo) == LE_OK );
+    LE_TEST( bytesWrittenOne == bytesWrittenTwo );
+    LE_TEST( memcmp(tlvBufferOne, tlvBufferTwo, bytesWrittenOne) == 0 );
+
+    // Writing a field from the client side invalidates it
+    LE_TEST( assetData_client_SetInt(lwm2mRefZero, 9, 0x654321) == LE_OK );
+    LE_TEST( assetData_WriteFieldListToTLV(lwm2mRefZero, tlvBufferTwo, sizeof(tlvBufferTwo), &bytesWrittenTwo) == LE_OK );
+    LE_TEST( bytesWrittenOne == bytesWrittenTwo );
+    LE_TEST( memcmp(tlvBufferOne, tlvBufferTwo, bytesWrittenOne) != 0 );
+
+    // So does writing it from the server side
+    LE_TEST( assetData_ReadFieldListFromTLV(tlvBufferOne, bytesWrittenOne, lwm2mRefZero, false) == LE_OK );
+    LE_TEST( assetData_client_GetInt(lwm2mRefZero, 9, &value) == LE_OK );
+    LE_TEST( value == 0x123456 );
+    LE_TEST( assetData_WriteFieldListToTLV(lwm2mRefZero, tlvBufferTwo, sizeof(tlvBufferTwo), &bytesWrittenTwo) == LE_OK );
+    LE_TEST( bytesWrittenOne == bytesWrittenTwo );
+    LE_TEST( memcmp(tlvBufferOne, tlvBufferTwo, bytesWrittenOne) == 0 );
+
+    // An instance too large for the cache is encoded to the output buffer on every read
+    memset(longStr, 'a', sizeof(longStr)-1);
+    longStr[sizeof(longStr)-1] = '\0';
+    LE_TEST( assetData_client_SetString(lwm2mRefOne, 0, longStr) == LE_OK );
+    LE_TEST( assetData_client_SetString(lwm2mRefOne, 1, longStr) == LE_OK );
+
+    LE_TEST( assetData_WriteFieldListToTLV(lwm2mRefOne, tlvBufferLarge, sizeof(tlvBufferLarge), &bytesWrittenLarge) == LE_OK );
+    LE_TEST( bytesWrittenLarge > 2*strlen(longStr) );
+    LE_TEST( assetData_WriteFieldListToTLV(lwm2mRefOne, tlvBufferTwo, sizeof(tlvBufferTwo), &bytesWrittenTwo) == LE_OVERFLOW );
+    LE_TEST( assetData_WriteFieldListToTLV(lwm2mRefOne, tlvBufferOne, sizeof(tlvBufferOne), &bytesWrittenOne) == LE_OVERFLOW );
+
+    // Shrinking it again makes it fit in the cache
+    LE_TEST( assetData_client_SetString(lwm2mRefOne, 1, "1.0") == LE_OK );
+    LE_TEST( assetData_WriteFieldListToTLV(lwm2mRefOne, tlvBufferLarge, sizeof(tlvBufferLarge), &bytesWrittenLarge) == LE_OK );
+    LE_TEST( assetData_WriteFieldListToTLV(lwm2mRefOne, tlvBufferTwo, sizeof(tlvBufferTwo), &bytesWrittenTwo) == LE_OK );
+    LE_TEST( bytesWrittenLarge == bytesWrittenTwo );
+    LE_TEST( memcmp(tlvBufferLarge, tlvBufferTwo, bytesWrittenTwo) == 0 );
+}
+
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+// Number of samples recorded in the time series; they take several chunks once compressed
+#define TIME_SERIES_NUM_SAMPLES 1000
+
+void RunTimeSeriesTest(void)
+{
+    static uint8_t expected[TIME_SERIES_NUM_SAMPLES * 32];
+    static uint8_t inflated[sizeof(expected)];
+    static int values[TIME_SERIES_NUM_SAMPLES];
+    static uint64_t timeStamps[TIME_SERIES_NUM_SAMPLES];
+    const paAvcStub_Notification_t* notificationPtr;
+    assetData_InstanceDataRef_t instanceRef;
+    CborEncoder streamRef, mapRef, arrayRef;
+    uint32_t seed = 12345;
+    uint8_t token[] = { 0x12, 0x34 };
+    size_t expectedSize;
+    z_stream zStream;
+    int i;
+
+    banner("Time series Testing");
+
+    LE_TEST( assetData_GetInstanceRefById("testOne", 1000, 1, &instanceRef) == LE_OK );
+    LE_TEST( assetData_SetObserve(instanceRef, true, token, sizeof(token)) == LE_OK );
+    assetData_SessionStatus(ASSET_DATA_SESSION_AVAILABLE);
+    paAvcStub_Reset();
+
+    // Samples that don't compress well, with deltas of various sizes.
+    LE_TEST( assetData_client_StartTimeSeries(instanceRef, 0, 1.0, 1.0) == LE_OK );
+    for (i = 0; i < TIME_SERIES_NUM_SAMPLES; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        values[i] = (int)((seed >> 8) % 2000000) - 1000000;
+        timeStamps[i] = 1500000000000ULL + (uint64_t)i * 1000 + (seed % 1000);
+        if ( assetData_client_RecordInt(instanceRef, 0, values[i], timeStamps[i]) != LE_OK )
+        {
+            break;
+        }
+    }
+    LE_TEST( i == TIME_SERIES_NUM_SAMPLES );
+    LE_TEST( paAvcStub_GetCount() == 0 );
+
+    LE_TEST( assetData_client_PushTimeSeries(instanceRef, 0, false) == LE_OK );
+    LE_TEST( paAvcStub_GetCount() == 1 );
+    notificationPtr = paAvcStub_GetLast();
+
+    // More than one 1 KiB chunk was used
+    LE_PRINT_VALUE("%zu", notificationPtr->payloadNumBytes);
+    LE_TEST( notificationPtr->payloadNumBytes > 1024 );
+
+    // The pushed stream, as it is expected once inflated
+    cbor_encoder_init(&streamRef, expected, sizeof(expected), 0);
+    cbor_encoder_create_map(&streamRef, &mapRef, 3);
+    cbor_encode_text_stringz(&mapRef, "h");
+    cbor_encoder_create_array(&mapRef, &arrayRef, 1);
+    cbor_encode_text_stringz(&arrayRef, "/1/0");
+    cbor_encoder_close_container(&mapRef, &arrayRef);
+    cbor_encode_text_stringz(&mapRef, "f");
+    cbor_encoder_create_array(&mapRef, &arrayRef, 2);
+    cbor_encode_double(&arrayRef, 1.0);
+    cbor_encode_double(&arrayRef, 1.0);
+    cbor_encoder_close_container(&mapRef, &arrayRef);
+    cbor_encode_text_stringz(&mapRef, "s");
+    cbor_encoder_create_array(&mapRef, &arrayRef, CborIndefiniteLength);
+    for (i = 0; i < TIME_SERIES_NUM_SAMPLES; i++)
+    {
+        cbor_encode_int(&arrayRef, (i == 0) ? timeStamps[i] : timeStamps[i] - timeStamps[i-1]);
+        cbor_encode_int(&arrayRef, (i == 0) ? values[i] : values[i] - values[i-1]);
+    }
+    cbor_encoder_close_container(&mapRef, &arrayRef);
+    LE_TEST( cbor_encoder_close_container(&streamRef, &mapRef) == CborNoError );
+    expectedSize = cbor_encoder_get_buffer_size(&streamRef, expected);
+
+    // Inflate the pushed payload and compare it with the recorded samples
+    memset(&zStream, 0, sizeof(zStream));
+    LE_TEST( inflateInit(&zStream) == Z_OK );
+    zStream.next_in = (uint8_t*)notificationPtr->payload;
+    zStream.avail_in = notificationPtr->payloadNumBytes;
+    zStream.next_out = inflated;
+    zStream.avail_out = sizeof(inflated);
+    LE_TEST( inflate(&zStream, Z_FINISH) == Z_STREAM_END );
+    LE_TEST( zStream.avail_in == 0 );
+    LE_TEST( zStream.total_out == expectedSize );
+    LE_TEST( memcmp(inflated, expected, expectedSize) == 0 );
+    inflateEnd(&zStream);
+
+    assetData_SessionStatus(ASSET_DATA_SESSION_UNAVAILABLE);
+    LE_TEST( assetData_SetObserve(instanceRef, false, NULL, 0) == LE_OK );
 }
+#endif
 
 
 COMPONENT_INIT
@@ -402,6 +558,9 @@ COMPONENT_INIT
     SemCreateTwo = le_sem_Create("SemCreateTwo", 0);
 
     RunTest();
+#ifdef LEGATO_FEATURE_TIMESERIES
+    RunTimeSeriesTest();
+#endif
 
     LE_TEST_EXIT;
 }
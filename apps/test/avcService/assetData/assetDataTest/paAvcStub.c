@@ -0,0 +1,158 @@
+/**
+ * Stub of the AirVantage platform adaptor for the asset data test: the last notification sent to
+ * the server is recorded so that the test can check it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "pa_avc.h"
+#include "paAvcStub.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Operation data returned by pa_avc_CreateOpData()
+ */
+//--------------------------------------------------------------------------------------------------
+struct pa_avc_LWM2MOperationData
+{
+    paAvcStub_Notification_t notification;
+};
+
+static struct pa_avc_LWM2MOperationData OpData;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of notifications received
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t NumNotifications;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill in the data structure required for lwm2m notify operation.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_avc_LWM2MOperationDataRef_t pa_avc_CreateOpData
+(
+    char* prefixPtr,
+    int objId,
+    int objInstId,
+    int resourceId,
+    pa_avc_OpType_t opType,
+    uint16_t contentType,
+    uint8_t* tokenPtr,
+    uint8_t tokenLength
+)
+{
+    LE_ASSERT(opType == PA_AVC_OPTYPE_NOTIFY);
+
+    memset(&OpData, 0, sizeof(OpData));
+    LE_ASSERT(le_utf8_Copy(OpData.notification.appName,
+                           prefixPtr,
+                           sizeof(OpData.notification.appName),
+                           NULL) == LE_OK);
+    OpData.notification.assetId = objId;
+    OpData.notification.contentType = contentType;
+
+    return &OpData;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the server when the asset value changes.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_avc_NotifyChange
+(
+    pa_avc_LWM2MOperationDataRef_t notifyOpRef,
+    uint8_t* respPayloadPtr,
+    size_t respPayloadNumBytes
+)
+{
+    LE_ASSERT(notifyOpRef == &OpData);
+    LE_ASSERT(respPayloadNumBytes <= sizeof(OpData.notification.payload));
+
+    memcpy(OpData.notification.payload, respPayloadPtr, respPayloadNumBytes);
+    OpData.notification.payloadNumBytes = respPayloadNumBytes;
+
+    NumNotifications++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the response of a read call back operation. Not used by the test.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_avc_ReadCallBackReport
+(
+    pa_avc_LWM2MOperationDataRef_t opRef,
+    uint8_t* respPayloadPtr,
+    size_t respPayloadNumBytes
+)
+{
+    LE_ERROR("Unsupported function called.");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a registration update to the server. Not used by the test.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_avc_RegistrationUpdate
+(
+    const char* updatePtr,
+    size_t updateNumBytes,
+    size_t updateCount
+)
+{
+    LE_ERROR("Unsupported function called");
+    return LE_FAULT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of notifications received.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t paAvcStub_GetCount
+(
+    void
+)
+{
+    return NumNotifications;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the last notification received.
+ */
+//--------------------------------------------------------------------------------------------------
+const paAvcStub_Notification_t* paAvcStub_GetLast
+(
+    void
+)
+{
+    LE_ASSERT(NumNotifications > 0);
+    return &OpData.notification;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Forget the notifications received.
+ */
+//--------------------------------------------------------------------------------------------------
+void paAvcStub_Reset
+(
+    void
+)
+{
+    NumNotifications = 0;
+}
@@ -0,0 +1,39 @@
+/**
+ * Stub of the AirVantage platform adaptor for the asset data test.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_AVC_STUB_INCLUDE_GUARD
+#define PA_AVC_STUB_INCLUDE_GUARD
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum payload size of a recorded notification; a pushed time series can use up to 32 chunks
+ * of 1 KiB.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_AVC_STUB_MAX_PAYLOAD_NUMBYTES (32 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notification sent to the server
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char appName[64];
+    int assetId;
+    uint16_t contentType;
+    uint8_t payload[PA_AVC_STUB_MAX_PAYLOAD_NUMBYTES];
+    size_t payloadNumBytes;
+}
+paAvcStub_Notification_t;
+
+size_t paAvcStub_GetCount(void);
+const paAvcStub_Notification_t* paAvcStub_GetLast(void);
+void paAvcStub_Reset(void);
+
+#endif // PA_AVC_STUB_INCLUDE_GUARD
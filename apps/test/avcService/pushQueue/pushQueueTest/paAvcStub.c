@@ -0,0 +1,130 @@
+/**
+ * Stub of the AirVantage platform adaptor for the push queue test: the notifications sent to the
+ * server are recorded so that the test can check them.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "pa_avc.h"
+#include "paAvcStub.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Operation data returned by pa_avc_CreateOpData()
+ */
+//--------------------------------------------------------------------------------------------------
+struct pa_avc_LWM2MOperationData
+{
+    paAvcStub_Notification_t notification;
+};
+
+static struct pa_avc_LWM2MOperationData OpData;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notifications received
+ */
+//--------------------------------------------------------------------------------------------------
+static paAvcStub_Notification_t Notifications[PA_AVC_STUB_MAX_NOTIFICATIONS];
+static size_t NumNotifications;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill in the data structure required for lwm2m notify operation.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_avc_LWM2MOperationDataRef_t pa_avc_CreateOpData
+(
+    char* prefixPtr,
+    int objId,
+    int objInstId,
+    int resourceId,
+    pa_avc_OpType_t opType,
+    uint16_t contentType,
+    uint8_t* tokenPtr,
+    uint8_t tokenLength
+)
+{
+    LE_ASSERT(opType == PA_AVC_OPTYPE_NOTIFY);
+    LE_ASSERT(tokenLength <= sizeof(OpData.notification.token));
+
+    memset(&OpData, 0, sizeof(OpData));
+    LE_ASSERT(le_utf8_Copy(OpData.notification.appName,
+                           prefixPtr,
+                           sizeof(OpData.notification.appName),
+                           NULL) == LE_OK);
+    OpData.notification.assetId = objId;
+    OpData.notification.contentType = contentType;
+    memcpy(OpData.notification.token, tokenPtr, tokenLength);
+    OpData.notification.tokenLength = tokenLength;
+
+    return &OpData;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the server when the asset value changes.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_avc_NotifyChange
+(
+    pa_avc_LWM2MOperationDataRef_t notifyOpRef,
+    uint8_t* respPayloadPtr,
+    size_t respPayloadNumBytes
+)
+{
+    LE_ASSERT(notifyOpRef == &OpData);
+    LE_ASSERT(NumNotifications < PA_AVC_STUB_MAX_NOTIFICATIONS);
+    LE_ASSERT(respPayloadNumBytes <= sizeof(OpData.notification.payload));
+
+    memcpy(OpData.notification.payload, respPayloadPtr, respPayloadNumBytes);
+    OpData.notification.payloadNumBytes = respPayloadNumBytes;
+
+    Notifications[NumNotifications++] = OpData.notification;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of notifications received.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t paAvcStub_GetCount
+(
+    void
+)
+{
+    return NumNotifications;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a notification received.
+ */
+//--------------------------------------------------------------------------------------------------
+const paAvcStub_Notification_t* paAvcStub_Get
+(
+    size_t index
+)
+{
+    LE_ASSERT(index < NumNotifications);
+    return &Notifications[index];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Forget the notifications received.
+ */
+//--------------------------------------------------------------------------------------------------
+void paAvcStub_Reset
+(
+    void
+)
+{
+    NumNotifications = 0;
+}
@@ -0,0 +1,40 @@
+/**
+ * Stub of the AirVantage platform adaptor for the push queue test.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_AVC_STUB_INCLUDE_GUARD
+#define PA_AVC_STUB_INCLUDE_GUARD
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of notifications recorded
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_AVC_STUB_MAX_NOTIFICATIONS 64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notification sent to the server
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char appName[64];
+    int assetId;
+    uint16_t contentType;
+    uint8_t token[8];
+    uint8_t tokenLength;
+    uint8_t payload[1024];
+    size_t payloadNumBytes;
+}
+paAvcStub_Notification_t;
+
+size_t paAvcStub_GetCount(void);
+const paAvcStub_Notification_t* paAvcStub_Get(size_t index);
+void paAvcStub_Reset(void);
+
+#endif // PA_AVC_STUB_INCLUDE_GUARD
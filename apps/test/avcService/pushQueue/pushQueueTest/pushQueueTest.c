@@ -0,0 +1,447 @@
+/**
+ * This program tests the push queue of avcDaemon against a stub of the platform adaptor.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "pushQueue.h"
+#include "paAvcStub.h"
+#include "pushQueueTest.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the queue, and size of the small queue used to test the eviction
+ */
+//--------------------------------------------------------------------------------------------------
+#define QUEUE_NUMBYTES          (256 * 1024)
+#define SMALL_QUEUE_NUMBYTES    1024
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Content types used by the test
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_TLV    0x0B
+#define TEST_CBOR   0x0C
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Token of the test notifications
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint8_t Token[] = { 0x12, 0x34, 0x56, 0x78 };
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the identifier of the current boot read by the queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetBootId
+(
+    const char* bootIdPtr   ///< [IN] Boot identifier
+)
+{
+    FILE* filePtr;
+
+    mkdir(TEST_DIR, S_IRWXU);
+
+    filePtr = fopen(BOOT_ID_PATH, "w");
+    LE_ASSERT(filePtr != NULL);
+    LE_ASSERT(fputs(bootIdPtr, filePtr) >= 0);
+    LE_ASSERT(fclose(filePtr) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenQueue
+(
+    bool reset,             ///< [IN] Whether to start from an empty queue
+    size_t maxNumBytes      ///< [IN] Size of the queue
+)
+{
+    if (reset)
+    {
+        unlink(TEST_QUEUE);
+    }
+    mkdir(TEST_DIR, S_IRWXU);
+
+    LE_ASSERT(pushQueue_Init(TEST_QUEUE, maxNumBytes) == LE_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a notification whose payload is a text.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddNotification
+(
+    const char* textPtr,                ///< [IN] Payload
+    pushQueue_Priority_t priority,      ///< [IN] Priority
+    uint32_t timeToLive                 ///< [IN] Time to live (s)
+)
+{
+    pushQueue_Notification_t notification =
+    {
+        .appNamePtr = "testApp",
+        .assetId = 1000,
+        .contentType = (priority == PUSHQUEUE_PRIORITY_HIGH) ? TEST_CBOR : TEST_TLV,
+        .tokenPtr = Token,
+        .tokenLength = sizeof(Token),
+        .payloadPtr = (const uint8_t*)textPtr,
+        .payloadNumBytes = strlen(textPtr),
+        .priority = priority,
+        .timeToLive = timeToLive
+    };
+
+    return pushQueue_Add(&notification);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a notification received by the stub.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckNotification
+(
+    size_t index,                       ///< [IN] Index of the notification in the stub
+    const char* textPtr                 ///< [IN] Expected payload
+)
+{
+    const paAvcStub_Notification_t* notificationPtr = paAvcStub_Get(index);
+
+    LE_ASSERT(strcmp(notificationPtr->appName, "testApp") == 0);
+    LE_ASSERT(notificationPtr->assetId == 1000);
+    LE_ASSERT(notificationPtr->tokenLength == sizeof(Token));
+    LE_ASSERT(memcmp(notificationPtr->token, Token, sizeof(Token)) == 0);
+    LE_ASSERT(notificationPtr->payloadNumBytes == strlen(textPtr));
+    LE_ASSERT(memcmp(notificationPtr->payload, textPtr, strlen(textPtr)) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of the queue file.
+ */
+//--------------------------------------------------------------------------------------------------
+static off_t GetQueueSize
+(
+    void
+)
+{
+    struct stat st;
+
+    LE_ASSERT(stat(TEST_QUEUE, &st) == 0);
+    return st.st_size;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: notifications queued before a restart are sent by priority, then in order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_pushQueue_Persistence
+(
+    void
+)
+{
+    OpenQueue(true, QUEUE_NUMBYTES);
+    paAvcStub_Reset();
+
+    LE_ASSERT(AddNotification("value 1", PUSHQUEUE_PRIORITY_LOW, 0) == LE_OK);
+    LE_ASSERT(AddNotification("series 1", PUSHQUEUE_PRIORITY_HIGH, 0) == LE_OK);
+    LE_ASSERT(AddNotification("value 2", PUSHQUEUE_PRIORITY_LOW, 0) == LE_OK);
+    LE_ASSERT(AddNotification("series 2", PUSHQUEUE_PRIORITY_HIGH, 0) == LE_OK);
+    LE_ASSERT(pushQueue_GetCount() == 4);
+
+    pushQueue_Close();
+    OpenQueue(false, QUEUE_NUMBYTES);
+    LE_ASSERT(pushQueue_GetCount() == 4);
+
+    LE_ASSERT(pushQueue_Send(10) == 0);
+    LE_ASSERT(paAvcStub_GetCount() == 4);
+    CheckNotification(0, "series 1");
+    CheckNotification(1, "series 2");
+    CheckNotification(2, "value 1");
+    CheckNotification(3, "value 2");
+    LE_ASSERT(paAvcStub_Get(0)->contentType == TEST_CBOR);
+    LE_ASSERT(paAvcStub_Get(2)->contentType == TEST_TLV);
+
+    // The file is emptied once everything is sent.
+    LE_ASSERT(GetQueueSize() == 0);
+
+    pushQueue_Close();
+    OpenQueue(false, QUEUE_NUMBYTES);
+    LE_ASSERT(pushQueue_GetCount() == 0);
+    pushQueue_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: the queue is sent in batches.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_pushQueue_Batch
+(
+    void
+)
+{
+    char text[16];
+    int i;
+
+    OpenQueue(true, QUEUE_NUMBYTES);
+    paAvcStub_Reset();
+
+    for (i = 0; i < 20; i++)
+    {
+        snprintf(text, sizeof(text), "value %d", i);
+        LE_ASSERT(AddNotification(text, PUSHQUEUE_PRIORITY_LOW, 0) == LE_OK);
+    }
+
+    LE_ASSERT(pushQueue_Send(8) == 12);
+    LE_ASSERT(paAvcStub_GetCount() == 8);
+
+    // Sent notifications stay sent after a restart.
+    pushQueue_Close();
+    OpenQueue(false, QUEUE_NUMBYTES);
+    LE_ASSERT(pushQueue_GetCount() == 12);
+
+    LE_ASSERT(pushQueue_Send(8) == 4);
+    LE_ASSERT(pushQueue_Send(8) == 0);
+    LE_ASSERT(paAvcStub_GetCount() == 20);
+
+    for (i = 0; i < 20; i++)
+    {
+        snprintf(text, sizeof(text), "value %d", i);
+        CheckNotification(i, text);
+    }
+
+    pushQueue_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: a full queue drops its oldest lowest priority notifications.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_pushQueue_Eviction
+(
+    void
+)
+{
+    char payload[5][200];
+    char largePayload[SMALL_QUEUE_NUMBYTES + 1];
+    int i;
+
+    OpenQueue(true, SMALL_QUEUE_NUMBYTES);
+    paAvcStub_Reset();
+
+    LE_ASSERT(AddNotification("oldest value", PUSHQUEUE_PRIORITY_LOW, 0) == LE_OK);
+    LE_ASSERT(AddNotification("newest value", PUSHQUEUE_PRIORITY_LOW, 0) == LE_OK);
+
+    // Only three of these fit in the queue: the low priority notifications are dropped first,
+    // then the oldest high priority ones.
+    for (i = 0; i < 5; i++)
+    {
+        memset(payload[i], 'a' + i, sizeof(payload[i]) - 1);
+        payload[i][sizeof(payload[i]) - 1] = '\0';
+        LE_ASSERT(AddNotification(payload[i], PUSHQUEUE_PRIORITY_HIGH, 0) == LE_OK);
+    }
+    LE_ASSERT(pushQueue_GetCount() == 3);
+
+    LE_ASSERT(AddNotification(payload[0], PUSHQUEUE_PRIORITY_LOW, 0) == LE_NO_MEMORY);
+
+    memset(largePayload, 'z', sizeof(largePayload) - 1);
+    largePayload[sizeof(largePayload) - 1] = '\0';
+    LE_ASSERT(AddNotification(largePayload, PUSHQUEUE_PRIORITY_HIGH, 0) == LE_OVERFLOW);
+
+    LE_ASSERT(pushQueue_Send(10) == 0);
+    LE_ASSERT(paAvcStub_GetCount() == 3);
+    CheckNotification(0, payload[2]);
+    CheckNotification(1, payload[3]);
+    CheckNotification(2, payload[4]);
+
+    pushQueue_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: expired notifications are not sent.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_pushQueue_Expiry
+(
+    void
+)
+{
+    OpenQueue(true, QUEUE_NUMBYTES);
+    paAvcStub_Reset();
+
+    LE_ASSERT(AddNotification("short lived", PUSHQUEUE_PRIORITY_HIGH, 1) == LE_OK);
+    LE_ASSERT(AddNotification("long lived", PUSHQUEUE_PRIORITY_LOW, 3600) == LE_OK);
+
+    sleep(2);
+
+    LE_ASSERT(pushQueue_Send(10) == 0);
+    LE_ASSERT(paAvcStub_GetCount() == 1);
+    CheckNotification(0, "long lived");
+
+    pushQueue_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: the time to live keeps running across a restart of the daemon, and starts again after a
+ * reboot.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_pushQueue_Reboot
+(
+    void
+)
+{
+    SetBootId("boot 1");
+    OpenQueue(true, QUEUE_NUMBYTES);
+    paAvcStub_Reset();
+
+    LE_ASSERT(AddNotification("restart", PUSHQUEUE_PRIORITY_LOW, 1) == LE_OK);
+    pushQueue_Close();
+
+    sleep(2);
+
+    OpenQueue(false, QUEUE_NUMBYTES);
+    LE_ASSERT(pushQueue_GetCount() == 0);
+
+    LE_ASSERT(AddNotification("reboot", PUSHQUEUE_PRIORITY_LOW, 1) == LE_OK);
+    pushQueue_Close();
+
+    sleep(2);
+
+    SetBootId("boot 2");
+    OpenQueue(false, QUEUE_NUMBYTES);
+    LE_ASSERT(pushQueue_GetCount() == 1);
+
+    LE_ASSERT(pushQueue_Send(10) == 0);
+    LE_ASSERT(paAvcStub_GetCount() == 1);
+    CheckNotification(0, "reboot");
+
+    pushQueue_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: a record torn by a power loss is discarded, the records before it are kept.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_pushQueue_TornRecord
+(
+    void
+)
+{
+    static const uint8_t garbage[] = { 0x51, 0x50, 0x56, 0x41, 0xde, 0xad, 0xbe, 0xef, 0x01 };
+    off_t size;
+    int fd;
+
+    OpenQueue(true, QUEUE_NUMBYTES);
+    paAvcStub_Reset();
+
+    LE_ASSERT(AddNotification("value 1", PUSHQUEUE_PRIORITY_LOW, 0) == LE_OK);
+    LE_ASSERT(AddNotification("value 2", PUSHQUEUE_PRIORITY_LOW, 0) == LE_OK);
+    pushQueue_Close();
+
+    size = GetQueueSize();
+    fd = open(TEST_QUEUE, O_WRONLY | O_APPEND);
+    LE_ASSERT(fd != -1);
+    LE_ASSERT(write(fd, garbage, sizeof(garbage)) == sizeof(garbage));
+    close(fd);
+
+    OpenQueue(false, QUEUE_NUMBYTES);
+    LE_ASSERT(pushQueue_GetCount() == 2);
+    LE_ASSERT(GetQueueSize() == size);
+
+    LE_ASSERT(pushQueue_Send(10) == 0);
+    CheckNotification(0, "value 1");
+    CheckNotification(1, "value 2");
+
+    pushQueue_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: the file is compacted when the queue never gets empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_pushQueue_Compaction
+(
+    void
+)
+{
+    char payload[1000];
+    int i;
+
+    memset(payload, 'z', sizeof(payload) - 1);
+    payload[sizeof(payload) - 1] = '\0';
+
+    OpenQueue(true, QUEUE_NUMBYTES);
+
+    LE_ASSERT(AddNotification("pending value", PUSHQUEUE_PRIORITY_LOW, 0) == LE_OK);
+
+    for (i = 0; i < 200; i++)
+    {
+        paAvcStub_Reset();
+        LE_ASSERT(AddNotification(payload, PUSHQUEUE_PRIORITY_HIGH, 0) == LE_OK);
+        LE_ASSERT(pushQueue_Send(1) == 1);
+        CheckNotification(0, payload);
+    }
+
+    LE_ASSERT(GetQueueSize() < (100 * 1024));
+
+    pushQueue_Close();
+    OpenQueue(false, QUEUE_NUMBYTES);
+    LE_ASSERT(pushQueue_GetCount() == 1);
+
+    paAvcStub_Reset();
+    LE_ASSERT(pushQueue_Send(10) == 0);
+    CheckNotification(0, "pending value");
+
+    pushQueue_Close();
+}
+
+
+COMPONENT_INIT
+{
+    LE_INFO("======== START UnitTest of push queue ========");
+
+    SetBootId("boot 1");
+
+    LE_INFO("======== Test_pushQueue_Persistence ========");
+    Test_pushQueue_Persistence();
+
+    LE_INFO("======== Test_pushQueue_Batch ========");
+    Test_pushQueue_Batch();
+
+    LE_INFO("======== Test_pushQueue_Eviction ========");
+    Test_pushQueue_Eviction();
+
+    LE_INFO("======== Test_pushQueue_Expiry ========");
+    Test_pushQueue_Expiry();
+
+    LE_INFO("======== Test_pushQueue_Reboot ========");
+    Test_pushQueue_Reboot();
+
+    LE_INFO("======== Test_pushQueue_TornRecord ========");
+    Test_pushQueue_TornRecord();
+
+    LE_INFO("======== Test_pushQueue_Compaction ========");
+    Test_pushQueue_Compaction();
+
+    unlink(TEST_QUEUE);
+    unlink(BOOT_ID_PATH);
+    rmdir(TEST_DIR);
+
+    LE_INFO("======== UnitTest of push queue FINISHED ========");
+    exit(0);
+}
@@ -0,0 +1,16 @@
+/**
+ * Paths used by the push queue when it is unit tested.  The queue file and the boot identifier are
+ * kept in a temporary directory, so that the test can simulate a reboot.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PUSH_QUEUE_TEST_INCLUDE_GUARD
+#define PUSH_QUEUE_TEST_INCLUDE_GUARD
+
+#define TEST_DIR        "/tmp/pushQueueTest"
+#define TEST_QUEUE      TEST_DIR "/pushQueue"
+
+#define BOOT_ID_PATH    TEST_DIR "/bootId"
+
+#endif // PUSH_QUEUE_TEST_INCLUDE_GUARD
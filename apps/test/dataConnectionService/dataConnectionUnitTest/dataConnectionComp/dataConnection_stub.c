@@ -7,6 +7,7 @@
 
 #include "legato.h"
 #include "interfaces.h"
+#include "dcsNet.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -206,15 +207,30 @@ void le_cfgTest_SetIntNodeValue
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Dummy function to replace system calls
+ * Dummy function to replace the default gateway setting
  */
 //--------------------------------------------------------------------------------------------------
-int MySystem
+le_result_t dcsNet_SetDefaultGateway
 (
-    const char *command
+    const char* interfacePtr,
+    const char* gatewayPtr,
+    bool isIpv6
 )
 {
-    return 0;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dummy function to replace the DHCP client
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t dcsNet_AskForIpAddress
+(
+    const char* interfacePtr
+)
+{
+    return LE_OK;
 }
 
 
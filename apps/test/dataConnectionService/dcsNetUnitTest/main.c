@@ -0,0 +1,467 @@
+/**
+ * This module implements the unit tests of the network configuration of the Data Connection
+ * service.
+ *
+ * Tested API:
+ * - dcsNet_SetDefaultGateway
+ *
+ * The test runs in its own network namespace, on a veth pair it creates there, so it does not
+ * change the routes of the host.  It is skipped when the namespace or the veth pair cannot be
+ * created, e.g. without CAP_NET_ADMIN.
+ *
+ * Unit test steps, for IPv4 then IPv6:
+ *  1. Set the default gateway when there is no default route
+ *  2. Replace the default route by a route through another gateway
+ *  3. Check that an unreachable gateway is refused and the current route is kept
+ *  4. Check that an unknown interface and an invalid address are refused
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "dcsNet.h"
+#include <sched.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/veth.h>
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interfaces of the veth pair created for the test, and an interface which does not exist
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_INTERFACE      "dcsTest0"
+#define PEER_INTERFACE      "dcsTest1"
+#define UNKNOWN_INTERFACE   "dcsTestNone"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffers used to build rtnetlink requests and to receive their answers
+ */
+//--------------------------------------------------------------------------------------------------
+#define REQUEST_BYTES       512
+#define ANSWER_BYTES        8192
+
+//--------------------------------------------------------------------------------------------------
+// Data structures
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Addresses used for the test in an address family
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool        isIpv6;             ///< IPv6 or not
+    const char* localAddrPtr;       ///< Address of the test interface
+    uint8_t     prefixLen;          ///< Prefix length of the test interface address
+    const char* gatewayPtr;         ///< First gateway, on the test interface network
+    const char* otherGatewayPtr;    ///< Second gateway, on the test interface network
+    const char* unreachablePtr;     ///< Gateway outside of the test interface network
+}
+TestAddresses_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * rtnetlink request
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    struct nlmsghdr hdr;                    ///< Request header
+    uint8_t         data[REQUEST_BYTES];    ///< Request payload and attributes
+}
+Request_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Addresses of each address family
+ */
+//--------------------------------------------------------------------------------------------------
+static const TestAddresses_t Ipv4Addresses =
+{
+    .isIpv6 = false,
+    .localAddrPtr = "10.0.0.1",
+    .prefixLen = 24,
+    .gatewayPtr = "10.0.0.254",
+    .otherGatewayPtr = "10.0.0.253",
+    .unreachablePtr = "10.9.9.9",
+};
+
+static const TestAddresses_t Ipv6Addresses =
+{
+    .isIpv6 = true,
+    .localAddrPtr = "fd00::1",
+    .prefixLen = 64,
+    .gatewayPtr = "fd00::fe",
+    .otherGatewayPtr = "fd00::fd",
+    .unreachablePtr = "fd09::9",
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a request
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitRequest
+(
+    Request_t* reqPtr,          ///< [IN] Request
+    uint16_t type,              ///< [IN] Request type
+    uint16_t flags,             ///< [IN] Request flags, in addition to NLM_F_REQUEST
+    const void* payloadPtr,     ///< [IN] Request payload
+    size_t payloadSize          ///< [IN] Request payload size
+)
+{
+    memset(reqPtr, 0, sizeof(*reqPtr));
+    reqPtr->hdr.nlmsg_len = NLMSG_LENGTH(payloadSize);
+    reqPtr->hdr.nlmsg_type = type;
+    reqPtr->hdr.nlmsg_flags = NLM_F_REQUEST | flags;
+    memcpy(NLMSG_DATA(&reqPtr->hdr), payloadPtr, payloadSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an attribute at the end of a request
+ *
+ * @return Pointer on the attribute, whose length is to be updated if attributes are nested in it
+ */
+//--------------------------------------------------------------------------------------------------
+static struct rtattr* AddAttribute
+(
+    Request_t* reqPtr,          ///< [IN] Request
+    uint16_t type,              ///< [IN] Attribute type
+    const void* dataPtr,        ///< [IN] Attribute data
+    size_t dataSize             ///< [IN] Attribute data size
+)
+{
+    size_t offset = NLMSG_ALIGN(reqPtr->hdr.nlmsg_len);
+    LE_ASSERT(offset + RTA_SPACE(dataSize) <= sizeof(*reqPtr));
+
+    struct rtattr* attrPtr = (struct rtattr*)((uint8_t*)reqPtr + offset);
+    attrPtr->rta_type = type;
+    attrPtr->rta_len = RTA_LENGTH(dataSize);
+    memcpy(RTA_DATA(attrPtr), dataPtr, dataSize);
+
+    reqPtr->hdr.nlmsg_len = offset + RTA_SPACE(dataSize);
+
+    return attrPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the length of an attribute to cover the attributes added after it
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndNestedAttribute
+(
+    Request_t* reqPtr,          ///< [IN] Request
+    struct rtattr* attrPtr      ///< [IN] Attribute containing the attributes added after it
+)
+{
+    attrPtr->rta_len = (uint8_t*)reqPtr + reqPtr->hdr.nlmsg_len - (uint8_t*)attrPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request and wait for its acknowledgement
+ *
+ * @return 0 if the request succeeded, its error otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static int SendRequest
+(
+    Request_t* reqPtr           ///< [IN] Request
+)
+{
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    LE_ASSERT(-1 != fd);
+
+    reqPtr->hdr.nlmsg_flags |= NLM_F_ACK;
+
+    LE_ASSERT(send(fd, reqPtr, reqPtr->hdr.nlmsg_len, 0) == (ssize_t)reqPtr->hdr.nlmsg_len);
+
+    uint8_t answer[ANSWER_BYTES] __attribute__((aligned(NLMSG_ALIGNTO)));
+    ssize_t len = recv(fd, answer, sizeof(answer), 0);
+    close(fd);
+
+    struct nlmsghdr* hdrPtr = (struct nlmsghdr*)answer;
+    LE_ASSERT(NLMSG_OK(hdrPtr, len) && (NLMSG_ERROR == hdrPtr->nlmsg_type));
+
+    return -((struct nlmsgerr*)NLMSG_DATA(hdrPtr))->error;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the veth pair of the test
+ *
+ * @return 0 if the pair was created, the error of the request otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static int CreateVethPair
+(
+    void
+)
+{
+    Request_t req;
+    struct ifinfomsg info = { .ifi_family = AF_UNSPEC };
+
+    InitRequest(&req, RTM_NEWLINK, NLM_F_CREATE | NLM_F_EXCL, &info, sizeof(info));
+    AddAttribute(&req, IFLA_IFNAME, TEST_INTERFACE, sizeof(TEST_INTERFACE));
+
+    struct rtattr* linkInfoPtr = AddAttribute(&req, IFLA_LINKINFO, NULL, 0);
+    AddAttribute(&req, IFLA_INFO_KIND, "veth", sizeof("veth"));
+
+    struct rtattr* infoDataPtr = AddAttribute(&req, IFLA_INFO_DATA, NULL, 0);
+    struct rtattr* peerPtr = AddAttribute(&req, VETH_INFO_PEER, &info, sizeof(info));
+    AddAttribute(&req, IFLA_IFNAME, PEER_INTERFACE, sizeof(PEER_INTERFACE));
+
+    EndNestedAttribute(&req, peerPtr);
+    EndNestedAttribute(&req, infoDataPtr);
+    EndNestedAttribute(&req, linkInfoPtr);
+
+    return SendRequest(&req);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bring an interface up
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetInterfaceUp
+(
+    const char* interfacePtr    ///< [IN] Interface name
+)
+{
+    Request_t req;
+    struct ifinfomsg info =
+    {
+        .ifi_family = AF_UNSPEC,
+        .ifi_index = if_nametoindex(interfacePtr),
+        .ifi_flags = IFF_UP,
+        .ifi_change = IFF_UP,
+    };
+
+    LE_ASSERT(0 != info.ifi_index);
+
+    InitRequest(&req, RTM_NEWLINK, 0, &info, sizeof(info));
+    LE_ASSERT(0 == SendRequest(&req));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the address of an address family to the test interface
+ *
+ * @return 0 if the address was added, the error of the request otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static int AddInterfaceAddress
+(
+    const TestAddresses_t* addrPtr  ///< [IN] Addresses of the address family
+)
+{
+    Request_t req;
+    int family = addrPtr->isIpv6 ? AF_INET6 : AF_INET;
+    struct in6_addr localAddr;
+    struct ifaddrmsg info =
+    {
+        .ifa_family = family,
+        .ifa_prefixlen = addrPtr->prefixLen,
+        .ifa_flags = IFA_F_NODAD,
+        .ifa_index = if_nametoindex(TEST_INTERFACE),
+    };
+
+    LE_ASSERT(1 == inet_pton(family, addrPtr->localAddrPtr, &localAddr));
+
+    size_t addrSize = addrPtr->isIpv6 ? sizeof(struct in6_addr) : sizeof(struct in_addr);
+
+    InitRequest(&req, RTM_NEWADDR, NLM_F_CREATE | NLM_F_EXCL, &info, sizeof(info));
+    AddAttribute(&req, IFA_LOCAL, &localAddr, addrSize);
+    AddAttribute(&req, IFA_ADDRESS, &localAddr, addrSize);
+
+    return SendRequest(&req);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the default routes of an address family from the main routing table
+ *
+ * @return Number of default routes
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetDefaultGateway
+(
+    bool isIpv6,                ///< [IN] IPv6 or not
+    char* gatewayPtr,           ///< [OUT] Gateway of the last default route, empty if none
+    size_t gatewaySize          ///< [IN] Gateway buffer size
+)
+{
+    Request_t req;
+    struct rtmsg rt = { .rtm_family = isIpv6 ? AF_INET6 : AF_INET };
+    int numRoutes = 0;
+    bool isDone = false;
+
+    gatewayPtr[0] = '\0';
+
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    LE_ASSERT(-1 != fd);
+
+    InitRequest(&req, RTM_GETROUTE, NLM_F_DUMP, &rt, sizeof(rt));
+    LE_ASSERT(send(fd, &req, req.hdr.nlmsg_len, 0) == (ssize_t)req.hdr.nlmsg_len);
+
+    while (!isDone)
+    {
+        uint8_t answer[ANSWER_BYTES] __attribute__((aligned(NLMSG_ALIGNTO)));
+        int len = recv(fd, answer, sizeof(answer), 0);
+        LE_ASSERT(len > 0);
+
+        struct nlmsghdr* hdrPtr;
+
+        for (hdrPtr = (struct nlmsghdr*)answer; NLMSG_OK(hdrPtr, len);
+             hdrPtr = NLMSG_NEXT(hdrPtr, len))
+        {
+            LE_ASSERT(NLMSG_ERROR != hdrPtr->nlmsg_type);
+
+            if (NLMSG_DONE == hdrPtr->nlmsg_type)
+            {
+                isDone = true;
+                break;
+            }
+
+            struct rtmsg* rtPtr = NLMSG_DATA(hdrPtr);
+
+            if ((RT_TABLE_MAIN != rtPtr->rtm_table) || (0 != rtPtr->rtm_dst_len)
+                || (RTN_UNICAST != rtPtr->rtm_type))
+            {
+                continue;
+            }
+
+            struct rtattr* attrPtr;
+            int attrLen = RTM_PAYLOAD(hdrPtr);
+
+            numRoutes++;
+
+            for (attrPtr = RTM_RTA(rtPtr); RTA_OK(attrPtr, attrLen);
+                 attrPtr = RTA_NEXT(attrPtr, attrLen))
+            {
+                if (RTA_GATEWAY == attrPtr->rta_type)
+                {
+                    LE_ASSERT(NULL != inet_ntop(rtPtr->rtm_family, RTA_DATA(attrPtr),
+                                                gatewayPtr, gatewaySize));
+                }
+            }
+        }
+    }
+
+    close(fd);
+
+    return numRoutes;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that there is a single default route of an address family, through a gateway
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckDefaultGateway
+(
+    bool isIpv6,                ///< [IN] IPv6 or not
+    const char* gatewayPtr      ///< [IN] Expected gateway
+)
+{
+    char gateway[INET6_ADDRSTRLEN];
+
+    LE_TEST(1 == GetDefaultGateway(isIpv6, gateway, sizeof(gateway)));
+    LE_TEST(0 == strcmp(gateway, gatewayPtr));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test dcsNet_SetDefaultGateway in an address family
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestSetDefaultGateway
+(
+    const TestAddresses_t* addrPtr  ///< [IN] Addresses of the address family
+)
+{
+    char gateway[INET6_ADDRSTRLEN];
+    bool isIpv6 = addrPtr->isIpv6;
+
+    LE_INFO("Testing the %s default gateway", isIpv6 ? "IPv6" : "IPv4");
+
+    // No previous default route
+    LE_TEST(0 == GetDefaultGateway(isIpv6, gateway, sizeof(gateway)));
+    LE_TEST(LE_OK == dcsNet_SetDefaultGateway(TEST_INTERFACE, addrPtr->gatewayPtr, isIpv6));
+    CheckDefaultGateway(isIpv6, addrPtr->gatewayPtr);
+
+    // Replacement of the current default route
+    LE_TEST(LE_OK == dcsNet_SetDefaultGateway(TEST_INTERFACE, addrPtr->otherGatewayPtr, isIpv6));
+    CheckDefaultGateway(isIpv6, addrPtr->otherGatewayPtr);
+
+    // The current default route is kept when the new one is refused
+    LE_TEST(LE_FAULT == dcsNet_SetDefaultGateway(TEST_INTERFACE, addrPtr->unreachablePtr,
+                                                 isIpv6));
+    CheckDefaultGateway(isIpv6, addrPtr->otherGatewayPtr);
+
+    LE_TEST(LE_FAULT == dcsNet_SetDefaultGateway(UNKNOWN_INTERFACE, addrPtr->gatewayPtr, isIpv6));
+    CheckDefaultGateway(isIpv6, addrPtr->otherGatewayPtr);
+
+    LE_TEST(LE_FAULT == dcsNet_SetDefaultGateway(TEST_INTERFACE, "invalid", isIpv6));
+    CheckDefaultGateway(isIpv6, addrPtr->otherGatewayPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main of the test
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    // The namespace is only entered by this thread, which runs the whole test.
+    if (0 != unshare(CLONE_NEWNET))
+    {
+        LE_INFO("Unable to create a network namespace (%m), test skipped");
+        LE_TEST_EXIT;
+    }
+
+    int error = CreateVethPair();
+    if (0 != error)
+    {
+        LE_INFO("Unable to create a veth pair (%s), test skipped", strerror(error));
+        LE_TEST_EXIT;
+    }
+
+    SetInterfaceUp(TEST_INTERFACE);
+    SetInterfaceUp(PEER_INTERFACE);
+
+    LE_ASSERT(0 == AddInterfaceAddress(&Ipv4Addresses));
+    TestSetDefaultGateway(&Ipv4Addresses);
+
+    error = AddInterfaceAddress(&Ipv6Addresses);
+    if (0 != error)
+    {
+        LE_INFO("Unable to add an IPv6 address (%s), IPv6 test skipped", strerror(error));
+    }
+    else
+    {
+        TestSetDefaultGateway(&Ipv6Addresses);
+
+        // The IPv4 default route is not affected by the IPv6 one
+        CheckDefaultGateway(false, Ipv4Addresses.otherGatewayPtr);
+    }
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,352 @@
+/**
+ * This module is for unit testing the sampling of the apps' resource usage by the Supervisor, and
+ * the summary of the samples printed by "app stats".
+ *
+ * The cgroups of the sampled app are stubbed so that the n-th sample has known values, and the
+ * module is built with a sampling period of a millisecond.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "cgroups.h"
+#include "appStats.h"
+#include "distribution.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the sampled app.
+ */
+//--------------------------------------------------------------------------------------------------
+#define APP_NAME            "statsApp"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample whose memory cannot be read, as if the app stopped between the reads of its cgroups.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DROPPED_SAMPLE      3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample before which the first samples are checked.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FIRST_CHECK_SAMPLE  6
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of samples taken, enough for the ring buffer to wrap around.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_SAMPLES         (LE_APPSTATS_MAX_SAMPLES + 10)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of times the CPU time of the app was read, i.e. the number of the current sample.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t SampleNum = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Output arrays of le_appStats_GetSamples().
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t Timestamps[LE_APPSTATS_MAX_SAMPLES];
+static uint64_t CpuTimes[LE_APPSTATS_MAX_SAMPLES];
+static uint64_t MemUsed[LE_APPSTATS_MAX_SAMPLES];
+static uint32_t NumThreads[LE_APPSTATS_MAX_SAMPLES];
+static uint32_t NumFds[LE_APPSTATS_MAX_SAMPLES];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the samples of the app.
+ *
+ * @return
+ *      Result of le_appStats_GetSamples().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetSamples
+(
+    size_t maxSamples,                  ///< [IN] Number of elements of the memory used array.
+    size_t* numSamplesPtr               ///< [OUT] Number of samples returned.
+)
+{
+    size_t numTimestamps = NUM_ARRAY_MEMBERS(Timestamps);
+    size_t numCpuTimes = NUM_ARRAY_MEMBERS(CpuTimes);
+    size_t numMemUsed = maxSamples;
+    size_t numNumThreads = NUM_ARRAY_MEMBERS(NumThreads);
+    size_t numNumFds = NUM_ARRAY_MEMBERS(NumFds);
+
+    le_result_t result = le_appStats_GetSamples(APP_NAME,
+                                                Timestamps, &numTimestamps,
+                                                CpuTimes, &numCpuTimes,
+                                                MemUsed, &numMemUsed,
+                                                NumThreads, &numNumThreads,
+                                                NumFds, &numNumFds);
+
+    if (result == LE_OK)
+    {
+        // All the arrays must be given the same number of samples.
+        LE_TEST( (numCpuTimes == numTimestamps) && (numMemUsed == numTimestamps) &&
+                 (numNumThreads == numTimestamps) && (numNumFds == numTimestamps) );
+    }
+
+    *numSamplesPtr = numTimestamps;
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that the returned samples are the given consecutive samples, from the oldest to the most
+ * recent.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckSamples
+(
+    size_t numSamples,                  ///< [IN] Number of returned samples.
+    uint32_t firstSampleNum             ///< [IN] Number of the oldest sample expected.
+)
+{
+    uint32_t sampleNum = firstSampleNum;
+    size_t i;
+
+    for (i = 0; i < numSamples; i++, sampleNum++)
+    {
+        if (sampleNum == DROPPED_SAMPLE)
+        {
+            sampleNum++;
+        }
+
+        LE_TEST(CpuTimes[i] == sampleNum * 1000);
+        LE_TEST(MemUsed[i] == sampleNum * 4096);
+        LE_TEST(NumThreads[i] == sampleNum);
+        LE_TEST(NumFds[i] == 0);
+        LE_TEST( (i == 0) || (Timestamps[i] >= Timestamps[i - 1]) );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the first samples, before the ring buffer is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestFirstSamples
+(
+    void
+)
+{
+    size_t numSamples;
+
+    LE_INFO("======== Test the first samples ========");
+
+    LE_TEST(GetSamples(LE_APPSTATS_MAX_SAMPLES, &numSamples) == LE_OK);
+
+    // The sample whose memory could not be read was dropped, and memory is still sampled.
+    LE_TEST(numSamples == FIRST_CHECK_SAMPLE - 2);
+    CheckSamples(numSamples, 1);
+    LE_TEST(le_appStats_IsMemUsedSampled());
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the samples once the ring buffer has wrapped around, then ends the test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWrappedSamples
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    size_t numSamples;
+
+    LE_INFO("======== Test the ring buffer wraparound ========");
+
+    // The most recent samples are kept.
+    LE_TEST(GetSamples(LE_APPSTATS_MAX_SAMPLES, &numSamples) == LE_OK);
+    LE_TEST(numSamples == LE_APPSTATS_MAX_SAMPLES);
+    CheckSamples(numSamples, NUM_SAMPLES - LE_APPSTATS_MAX_SAMPLES + 1);
+
+    LE_INFO("======== Test the output arrays clamping ========");
+
+    // Only as many samples as the smallest array can hold are returned, the most recent ones.
+    LE_TEST(GetSamples(10, &numSamples) == LE_OK);
+    LE_TEST(numSamples == 10);
+    CheckSamples(numSamples, NUM_SAMPLES - 10 + 1);
+
+    LE_TEST(GetSamples(0, &numSamples) == LE_OK);
+    LE_TEST(numSamples == 0);
+
+    LE_INFO("======== Test the stopped and restarted app ========");
+
+    // The samples are kept when the app stops, and discarded when it starts again.
+    LE_TEST(GetSamples(LE_APPSTATS_MAX_SAMPLES, &numSamples) == LE_OK);
+    appStats_StartApp(APP_NAME);
+    LE_TEST(GetSamples(LE_APPSTATS_MAX_SAMPLES, &numSamples) == LE_NOT_FOUND);
+    appStats_DeleteApp(APP_NAME);
+    LE_TEST(GetSamples(LE_APPSTATS_MAX_SAMPLES, &numSamples) == LE_NOT_FOUND);
+
+    LE_TEST_EXIT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the summary of series of values.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestDistribution
+(
+    void
+)
+{
+    distribution_Summary_t summary;
+    double values[LE_APPSTATS_MAX_SAMPLES];
+    size_t i;
+
+    LE_INFO("======== Test the distribution summary ========");
+
+    // A single value.
+    values[0] = 42;
+    distribution_Summarize(values, 1, &summary);
+    LE_TEST( (summary.last == 42) && (summary.p50 == 42) && (summary.p90 == 42) &&
+             (summary.max == 42) );
+
+    // 10 values in reverse order: p50 is the 5th smallest and p90 the 9th smallest.
+    for (i = 0; i < 10; i++)
+    {
+        values[i] = 10 - i;
+    }
+    distribution_Summarize(values, 10, &summary);
+    LE_TEST( (summary.last == 1) && (summary.p50 == 5) && (summary.p90 == 9) &&
+             (summary.max == 10) );
+
+    // 11 values: ranks are rounded up, p50 is the 6th smallest and p90 the 10th smallest.
+    for (i = 0; i < 11; i++)
+    {
+        values[i] = (i * 7) % 11;
+    }
+    distribution_Summarize(values, 11, &summary);
+    LE_TEST( (summary.last == 4) && (summary.p50 == 5) && (summary.p90 == 9) &&
+             (summary.max == 10) );
+
+    // A full series, with the values sorted in place.
+    for (i = 0; i < LE_APPSTATS_MAX_SAMPLES; i++)
+    {
+        values[i] = (i % 2) ? i : LE_APPSTATS_MAX_SAMPLES - i;
+    }
+    distribution_Summarize(values, LE_APPSTATS_MAX_SAMPLES, &summary);
+    LE_TEST( (summary.last == LE_APPSTATS_MAX_SAMPLES - 1) &&
+             (summary.p50 == LE_APPSTATS_MAX_SAMPLES / 2) &&
+             (summary.p90 == LE_APPSTATS_MAX_SAMPLES * 9 / 10) &&
+             (summary.max == LE_APPSTATS_MAX_SAMPLES) );
+
+    for (i = 1; i < LE_APPSTATS_MAX_SAMPLES; i++)
+    {
+        LE_TEST(values[i - 1] <= values[i]);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stub of the CPU time of a cgroup.  The n-th sample reads n us.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_cpu_GetUsage
+(
+    const char* cgroupNamePtr,
+    uint64_t* usagePtr
+)
+{
+    SampleNum++;
+
+    if (SampleNum == FIRST_CHECK_SAMPLE)
+    {
+        TestFirstSamples();
+    }
+    else if (SampleNum > NUM_SAMPLES)
+    {
+        // Stop sampling and fail this sample so that it is not stored.
+        appStats_StopApp(APP_NAME);
+        le_event_QueueFunction(TestWrappedSamples, NULL, NULL);
+        return LE_FAULT;
+    }
+
+    *usagePtr = SampleNum * 1000;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stub of the memory used by a cgroup.  The root cgroup accounts memory, and the n-th sample of the
+ * app reads n pages.
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t cgrp_GetMemUsed
+(
+    const char* cgroupNamePtr
+)
+{
+    if (strcmp(cgroupNamePtr, "") == 0)
+    {
+        return 0;
+    }
+
+    if (SampleNum == DROPPED_SAMPLE)
+    {
+        return LE_FAULT;
+    }
+
+    return SampleNum * 4096;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stub of the threads of a cgroup.  The n-th sample reads n threads.
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t cgrp_GetThreadList
+(
+    cgrp_SubSys_t subsystem,
+    const char* cgroupNamePtr,
+    pid_t* tidListPtr,
+    size_t maxTids
+)
+{
+    return SampleNum;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stub of the processes of a cgroup.  The app has no processes, so no file descriptors.
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t cgrp_GetProcessesList
+(
+    cgrp_SubSys_t subsystem,
+    const char* cgroupNamePtr,
+    pid_t* idListPtr,
+    size_t maxIds
+)
+{
+    return 0;
+}
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    TestDistribution();
+
+    appStats_Init();
+
+    size_t numSamples;
+    LE_TEST(GetSamples(LE_APPSTATS_MAX_SAMPLES, &numSamples) == LE_NOT_FOUND);
+
+    // The samples are checked by the cgroup stubs as they are taken.
+    appStats_StartApp(APP_NAME);
+}
@@ -0,0 +1,24 @@
+/**
+ * Paths and sizes used by the debugData module when it is unit tested.  The data is captured in a
+ * temporary directory, with small maximum sizes.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef DEBUG_DATA_TEST_INCLUDE_GUARD
+#define DEBUG_DATA_TEST_INCLUDE_GUARD
+
+#define TEST_DIR                "/tmp/debugDataTest"
+
+#define RAM_LOG_DIR             TEST_DIR "/ram"
+#define FLASH_LOG_DIR           TEST_DIR "/flash"
+#define APPS_CORE_DIR           TEST_DIR "/apps"
+#define LOGREAD_PATH            TEST_DIR "/logread"
+
+#define MAX_KEPT_FILES          3
+#define MAX_PENDING_CAPTURES    4
+
+#define MAX_LOG_BYTES           (64 * 1024)
+#define MAX_CORE_BYTES          (32 * 1024)
+
+#endif // DEBUG_DATA_TEST_INCLUDE_GUARD
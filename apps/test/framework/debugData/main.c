@@ -0,0 +1,350 @@
+/**
+ * This module is for unit testing the capture of the debug data of faulty processes by the
+ * Supervisor's debugData module.
+ *
+ * The data is captured in a temporary directory (see debugDataTest.h), from a stand-in for logread
+ * that dumps more than the maximum size of a system log, and from core files left in the app's
+ * directory.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "debugData.h"
+#include "wait.h"
+#include "limit.h"
+#include <dirent.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the app of the faulty processes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define APP_NAME            "faultyApp"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of faults.  The ones beyond MAX_PENDING_CAPTURES happen while the others are being
+ * captured, and are not captured.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_FAULTS          (MAX_PENDING_CAPTURES + 2)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of files of each kind saved from previous faults before the test.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_OLD_FILES       (MAX_KEPT_FILES + 2)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the core files, except the first process's one which is larger than MAX_CORE_BYTES.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CORE_BYTES          100
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Period at which the end of the captures is checked for, and maximum number of checks.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHECK_PERIOD_MS     50
+#define MAX_CHECKS          200
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer checking for the end of the captures.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t CheckTimer;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a file of a given size and modification time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateFile
+(
+    const char* dirPathPtr,         ///< [IN] Directory.
+    const char* namePtr,            ///< [IN] Name of the file.
+    off_t size,                     ///< [IN] Size of the file.
+    time_t mtime                    ///< [IN] Modification time.
+)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dirPathPtr, namePtr);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(ftruncate(fd, size) == 0);
+    close(fd);
+
+    struct timeval times[2] = { { .tv_sec = mtime }, { .tv_sec = mtime } };
+    LE_ASSERT(utimes(path, times) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts the files of a directory whose name starts with a prefix, and gets the size of the last
+ * one found.
+ *
+ * @return
+ *      The number of files.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t CountFiles
+(
+    const char* dirPathPtr,         ///< [IN] Directory.
+    const char* prefixPtr,          ///< [IN] Prefix of the file names.
+    off_t* sizePtr                  ///< [OUT] Size of the last file found, if not NULL.
+)
+{
+    DIR* dirPtr = opendir(dirPathPtr);
+
+    if (dirPtr == NULL)
+    {
+        return 0;
+    }
+
+    size_t numFiles = 0;
+    struct dirent* entryPtr;
+
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        struct stat fileStat;
+
+        if ( (strncmp(entryPtr->d_name, prefixPtr, strlen(prefixPtr)) == 0) &&
+             (fstatat(dirfd(dirPtr), entryPtr->d_name, &fileStat, 0) == 0) )
+        {
+            numFiles++;
+
+            if (sizePtr != NULL)
+            {
+                *sizePtr = fileStat.st_size;
+            }
+        }
+    }
+
+    closedir(dirPtr);
+
+    return numFiles;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the prefix of the files saved for a process.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSavedPrefix
+(
+    const char* kindPtr,            ///< [IN] "syslog" or "core".
+    int procNum,                    ///< [IN] Number of the process.
+    char* prefixPtr,                ///< [OUT] Prefix.
+    size_t prefixSize               ///< [IN] Size of the prefix buffer.
+)
+{
+    snprintf(prefixPtr, prefixSize, "%s-%s-proc%d-", kindPtr, APP_NAME, procNum);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the data saved when the system is about to reboot, then ends the test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestRebootCapture
+(
+    void
+)
+{
+    char prefix[PATH_MAX];
+    off_t size;
+
+    LE_INFO("======== Test the capture before a reboot ========");
+
+    // The capture is done before the function returns, in flash, along with a copy of the data
+    // saved in the tmp file system.
+    debugData_Capture(APP_NAME, "proc0", true);
+
+    GetSavedPrefix("syslog", 0, prefix, sizeof(prefix));
+    LE_TEST(CountFiles(FLASH_LOG_DIR, prefix, &size) == 1);
+    LE_TEST(size == MAX_LOG_BYTES);
+
+    LE_TEST(CountFiles(FLASH_LOG_DIR, "syslog-", NULL) == MAX_PENDING_CAPTURES + 1);
+    LE_TEST(CountFiles(FLASH_LOG_DIR, "core-", NULL) == MAX_PENDING_CAPTURES);
+
+    LE_ASSERT(le_dir_RemoveRecursive(TEST_DIR) == LE_OK);
+
+    LE_TEST_EXIT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the data saved by the asynchronous captures.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestCaptures
+(
+    void
+)
+{
+    char prefix[PATH_MAX];
+    off_t size;
+    int i;
+
+    LE_INFO("======== Test the captures ========");
+
+    // Only the data of the last faults is kept, as each capture first deletes the oldest files
+    // beyond MAX_KEPT_FILES.
+    LE_TEST(CountFiles(RAM_LOG_DIR, "syslog-", NULL) == MAX_PENDING_CAPTURES);
+    LE_TEST(CountFiles(RAM_LOG_DIR, "core-", NULL) == MAX_PENDING_CAPTURES);
+    LE_TEST(CountFiles(RAM_LOG_DIR, "syslog-old-", NULL) == 0);
+    LE_TEST(CountFiles(RAM_LOG_DIR, "core-old-", NULL) == 0);
+
+    for (i = 1; i <= NUM_FAULTS; i++)
+    {
+        bool isCaptured = (i <= MAX_PENDING_CAPTURES);
+
+        // The system log is truncated to its maximum size.
+        GetSavedPrefix("syslog", i, prefix, sizeof(prefix));
+        LE_TEST(CountFiles(RAM_LOG_DIR, prefix, &size) == (isCaptured ? 1 : 0));
+        LE_TEST(!isCaptured || (size == MAX_LOG_BYTES));
+
+        // The newest core file is moved and truncated to its maximum size.
+        GetSavedPrefix("core", i, prefix, sizeof(prefix));
+        LE_TEST(CountFiles(RAM_LOG_DIR, prefix, &size) == (isCaptured ? 1 : 0));
+        LE_TEST(!isCaptured || (size == ((i == 1) ? MAX_CORE_BYTES : CORE_BYTES)));
+
+        // The older core files of a captured process are deleted.
+        snprintf(prefix, sizeof(prefix), "core-proc%d-", i);
+        LE_TEST(CountFiles(APPS_CORE_DIR "/" APP_NAME, prefix, NULL) == (isCaptured ? 0 : 2));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether the last capture is done, i.e. the core file of the last captured process is
+ * saved.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckTimerHandler
+(
+    le_timer_Ref_t timerRef         ///< [IN] Check timer.
+)
+{
+    char prefix[PATH_MAX];
+    GetSavedPrefix("core", MAX_PENDING_CAPTURES, prefix, sizeof(prefix));
+
+    if (CountFiles(RAM_LOG_DIR, prefix, NULL) == 0)
+    {
+        LE_FATAL_IF(le_timer_GetExpiryCount(timerRef) >= MAX_CHECKS, "Captures not done.");
+        return;
+    }
+
+    le_timer_Stop(timerRef);
+
+    TestCaptures();
+    TestRebootCapture();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reaps the logread stand-ins, as the Supervisor does.  Unlike the Supervisor, the test may have
+ * no children left, so wait_Peek() can't be used.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SigChildHandler
+(
+    int sigNum
+)
+{
+    siginfo_t childInfo = { .si_pid = 0 };
+
+    while ( (waitid(P_ALL, 0, &childInfo, WEXITED | WNOHANG | WNOWAIT) == 0) &&
+            (childInfo.si_pid != 0) )
+    {
+        if (debugData_SigChildHandler(childInfo.si_pid) == LE_NOT_FOUND)
+        {
+            wait_ReapChild(childInfo.si_pid);
+        }
+
+        childInfo.si_pid = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the logread stand-in, the files saved from previous faults, and the core files of the
+ * faulty processes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateTestFiles
+(
+    void
+)
+{
+    time_t now = time(NULL);
+    char name[PATH_MAX];
+    int i;
+
+    LE_ASSERT(le_dir_RemoveRecursive(TEST_DIR) == LE_OK);
+    LE_ASSERT(le_dir_MakePath(RAM_LOG_DIR, S_IRWXU) == LE_OK);
+    LE_ASSERT(le_dir_MakePath(APPS_CORE_DIR "/" APP_NAME, S_IRWXU) == LE_OK);
+
+    // logread dumps twice the maximum size of a system log.
+    FILE* filePtr = fopen(LOGREAD_PATH, "w");
+    LE_ASSERT(filePtr != NULL);
+    fprintf(filePtr, "#!/bin/sh\nexec dd if=/dev/zero bs=1024 count=%d 2>/dev/null\n",
+            2 * MAX_LOG_BYTES / 1024);
+    fclose(filePtr);
+    LE_ASSERT(chmod(LOGREAD_PATH, S_IRWXU) == 0);
+
+    for (i = 0; i < NUM_OLD_FILES; i++)
+    {
+        snprintf(name, sizeof(name), "syslog-old-%d", i);
+        CreateFile(RAM_LOG_DIR, name, CORE_BYTES, now - 100 + i);
+        snprintf(name, sizeof(name), "core-old-%d", i);
+        CreateFile(RAM_LOG_DIR, name, CORE_BYTES, now - 100 + i);
+    }
+
+    // Each process left an older and a newer core file.
+    for (i = 1; i <= NUM_FAULTS; i++)
+    {
+        snprintf(name, sizeof(name), "core-proc%d-1", i);
+        CreateFile(APPS_CORE_DIR "/" APP_NAME, name, CORE_BYTES, now - 10);
+        snprintf(name, sizeof(name), "core-proc%d-2", i);
+        CreateFile(APPS_CORE_DIR "/" APP_NAME, name,
+                   (i == 1) ? MAX_CORE_BYTES + CORE_BYTES : CORE_BYTES, now);
+    }
+}
+
+COMPONENT_INIT
+{
+    char procName[LIMIT_MAX_PROCESS_NAME_BYTES];
+    int i;
+
+    LE_TEST_INIT;
+
+    CreateTestFiles();
+
+    le_sig_Block(SIGCHLD);
+    le_sig_SetEventHandler(SIGCHLD, SigChildHandler);
+
+    debugData_Init();
+
+    LE_INFO("======== Capture %d faults ========", NUM_FAULTS);
+
+    for (i = 1; i <= NUM_FAULTS; i++)
+    {
+        snprintf(procName, sizeof(procName), "proc%d", i);
+        debugData_Capture(APP_NAME, procName, false);
+    }
+
+    CheckTimer = le_timer_Create("DebugDataCheck");
+    LE_ASSERT(le_timer_SetMsInterval(CheckTimer, CHECK_PERIOD_MS) == LE_OK);
+    LE_ASSERT(le_timer_SetRepeat(CheckTimer, 0) == LE_OK);
+    LE_ASSERT(le_timer_SetHandler(CheckTimer, CheckTimerHandler) == LE_OK);
+    LE_ASSERT(le_timer_Start(CheckTimer) == LE_OK);
+}
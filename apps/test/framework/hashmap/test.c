@@ -452,6 +452,17 @@ void TestLongIntHashMap(le_hashmap_Ref_t map)
     le_hashmap_RemoveAll(map);
     LE_TEST(le_hashmap_isEmpty(map));
 
+    // Keys differing only in their upper 32 bits are different keys
+    uint64_t ikey2 = ikey1 + (1ULL << 32);
+    insertRetrieve(map, &ikey1, &ival1);
+    rval = insertRetrieve(map, &ikey2, &ival2);
+    LE_TEST((*((uint64_t*) rval) == ival2) && (le_hashmap_Size(map) == 2));
+    rval = le_hashmap_Get(map, &ikey1);
+    LE_TEST((rval != NULL) && (*((uint64_t*) rval) == ival1));
+
+    le_hashmap_RemoveAll(map);
+    LE_TEST(le_hashmap_isEmpty(map));
+
     // Time to store 1000 pairs
     uint64_t iKeys[1000];
     uint64_t iVals[1000];
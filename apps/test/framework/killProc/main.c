@@ -0,0 +1,189 @@
+/**
+ * This module is for unit testing the kill_ByName() function of the killProc module in the legato
+ * runtime library (liblegato.so).
+ *
+ * Processes are given names by running this test's executable through symbolic links, with an
+ * argument that makes them wait to be killed.  The kernel names a process after the file it runs,
+ * truncated to 15 characters, and the command line keeps the full path of the link.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "killProc.h"
+#include <sys/wait.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Argument that makes the test executable wait to be killed.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WAIT_ARG            "wait"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory of the links to the test executable.
+ */
+//--------------------------------------------------------------------------------------------------
+static char TestDir[] = "/tmp/killProcTestXXXXXX";
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Names of the test processes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SHORT_NAME          "killTestShort"                 // Fits in the kernel's name.
+#define EXACT_NAME          "killTestExactly"               // 15 characters.
+#define LONG_NAME           "killTestLongProcessName"       // Truncated to "killTestLongPro".
+#define OTHER_LONG_NAME     "killTestLongProcessOther"      // Same truncated name.
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a test process with the specified name, and waits for it to be running under that name.
+ *
+ * @return
+ *      The pid of the process.
+ */
+//--------------------------------------------------------------------------------------------------
+static pid_t StartProc
+(
+    const char* procNamePtr         ///< [IN] Name of the process.
+)
+{
+    char exePath[PATH_MAX];
+    ssize_t len = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+    LE_ASSERT(len > 0);
+    exePath[len] = '\0';
+
+    char linkPath[PATH_MAX];
+    snprintf(linkPath, sizeof(linkPath), "%s/%s", TestDir, procNamePtr);
+    LE_ASSERT( (symlink(exePath, linkPath) == 0) || (errno == EEXIST) );
+
+    pid_t pid = fork();
+    LE_ASSERT(pid >= 0);
+
+    if (pid == 0)
+    {
+        execl(linkPath, linkPath, WAIT_ARG, (char*)NULL);
+        _exit(EXIT_FAILURE);
+    }
+
+    // The process keeps the name of its parent until it runs the link.
+    char commPath[PATH_MAX];
+    snprintf(commPath, sizeof(commPath), "/proc/%d/comm", pid);
+
+    char comm[32] = "";
+    int retries;
+
+    for (retries = 0; retries < 1000; retries++)
+    {
+        int fd = open(commPath, O_RDONLY);
+        LE_ASSERT(fd >= 0);
+        ssize_t n = read(fd, comm, sizeof(comm) - 1);
+        close(fd);
+
+        comm[(n > 0) ? n : 0] = '\0';
+        comm[strcspn(comm, "\n")] = '\0';
+
+        if (strncmp(comm, procNamePtr, 15) == 0)
+        {
+            break;
+        }
+
+        usleep(1000);
+    }
+
+    LE_ASSERT(retries < 1000);
+
+    return pid;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a test process was killed, and kills it if it was not.
+ *
+ * @return
+ *      true if the process was killed by SIGTERM.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WasKilled
+(
+    pid_t pid                       ///< [IN] Process.
+)
+{
+    int status;
+
+    // SIGTERM is sent by kill_ByName() before it returns, so a process that is still running was
+    // not sent one.
+    usleep(100000);
+
+    if (waitpid(pid, &status, WNOHANG) == 0)
+    {
+        kill(pid, SIGKILL);
+        LE_ASSERT(waitpid(pid, &status, 0) == pid);
+        return false;
+    }
+
+    return (WIFSIGNALED(status) && (WTERMSIG(status) == SIGTERM));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kills the processes of a name and checks which of the test processes were killed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestKill
+(
+    const char* killedNamePtr,      ///< [IN] Name given to kill_ByName().
+    const char* procNamePtr,        ///< [IN] Name of the test process.
+    bool isKilled                   ///< [IN] Is the test process expected to be killed?
+)
+{
+    LE_INFO("Kill '%s' with '%s' running.", killedNamePtr, procNamePtr);
+
+    pid_t pid = StartProc(procNamePtr);
+
+    kill_ByName(killedNamePtr);
+
+    LE_TEST(WasKilled(pid) == isKilled);
+}
+
+COMPONENT_INIT
+{
+    if ( (le_arg_NumArgs() == 1) && (strcmp(le_arg_GetArg(0), WAIT_ARG) == 0) )
+    {
+        // Wait in the event loop to be killed.
+        return;
+    }
+
+    LE_TEST_INIT;
+
+    LE_ASSERT(mkdtemp(TestDir) != NULL);
+
+    // Names shorter than the kernel's limit must match exactly.
+    TestKill(SHORT_NAME, SHORT_NAME, true);
+    TestKill("killTestSho", SHORT_NAME, false);
+    TestKill("killTestShortName", SHORT_NAME, false);
+
+    // Names of exactly 15 characters are also checked against the executable's name.
+    TestKill(EXACT_NAME, EXACT_NAME, true);
+
+    // Longer names are matched on the executable's name since the kernel's name is truncated.
+    TestKill(LONG_NAME, LONG_NAME, true);
+    TestKill(OTHER_LONG_NAME, LONG_NAME, false);
+    TestKill("killTestLongPro", LONG_NAME, false);
+
+    // The calling process is never killed, which is checked by getting to the end of the test.
+    char ownName[32] = "";
+    int fd = open("/proc/self/comm", O_RDONLY);
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(read(fd, ownName, sizeof(ownName) - 1) > 0);
+    close(fd);
+    ownName[strcspn(ownName, "\n")] = '\0';
+
+    kill_ByName(ownName);
+
+    LE_ASSERT(le_dir_RemoveRecursive(TestDir) == LE_OK);
+
+    LE_TEST_EXIT;
+}
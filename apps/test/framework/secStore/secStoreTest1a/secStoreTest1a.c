@@ -76,6 +76,36 @@ COMPONENT_INIT
     LE_FATAL_IF(result != LE_NO_MEMORY,
                     "Should have failed due to a memory limit.  %s.", LE_RESULT_TXT(result));
 
+    // Overwriting an item with one of the same size should fit within the limit.
+    result = le_secStore_Write("loop0", (uint8_t*)loopString, sizeof(loopString));
+    LE_FATAL_IF(result != LE_OK,
+                "Could not overwrite item 'loop0'.  %s.", LE_RESULT_TXT(result));
+
+    // Deleting an item should free enough space for another one.
+    result = le_secStore_Delete("loop0");
+    LE_FATAL_IF(result != LE_OK,
+                "Could not delete item 'loop0'.  %s.", LE_RESULT_TXT(result));
+
+    result = le_secStore_Write("lastLoopItem", (uint8_t*)loopString, sizeof(loopString));
+    LE_FATAL_IF(result != LE_OK,
+                "Could not write within the memory limit after a delete.  %s.",
+                LE_RESULT_TXT(result));
+
+    // The space taken by the new item should be counted.
+    result = le_secStore_Write("loop0", (uint8_t*)loopString, sizeof(loopString));
+    LE_FATAL_IF(result != LE_NO_MEMORY,
+                    "Should have failed due to a memory limit.  %s.", LE_RESULT_TXT(result));
+
+    result = le_secStore_Delete("lastLoopItem");
+    LE_FATAL_IF(result != LE_OK,
+                "Could not delete item 'lastLoopItem'.  %s.", LE_RESULT_TXT(result));
+
+    result = le_secStore_Write("loop0", (uint8_t*)loopString, sizeof(loopString));
+    LE_FATAL_IF(result != LE_OK,
+                "Could not write to sec store.  %s.", LE_RESULT_TXT(result));
+
+    LE_INFO("Usage updated correctly on delete and overwrite.");
+
     // Delete item that does not exist.
     result = le_secStore_Delete("NonExistence");
     LE_FATAL_IF(result != LE_NOT_FOUND,
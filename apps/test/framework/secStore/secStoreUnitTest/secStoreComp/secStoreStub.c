@@ -182,6 +182,19 @@ void appCfg_DeleteIter
     LE_ASSERT(DEFAULT_APPCFG_ITER == iter)
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the change handler.  The apps configuration never changes in the unit test, so the handler
+ * is never called.
+ */
+//--------------------------------------------------------------------------------------------------
+void appCfg_SetChangeHandler
+(
+    appCfg_ChangeHandler_t handler          ///< [IN] Change handler.
+)
+{
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the index of the currently running system.
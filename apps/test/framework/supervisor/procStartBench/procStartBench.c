@@ -0,0 +1,101 @@
+//--------------------------------------------------------------------------------------------------
+/** @file procStartBench.c
+ *
+ * This program measures the latency of (re)starting a configured process through the Supervisor.
+ *
+ * The target process of the ProcStartTarget app exits as soon as it is initialized and is started
+ * again from its stop handler.  The first start also starts the app and has the Supervisor read the
+ * process's launch settings from the config tree, the following starts use the settings cached by
+ * the Supervisor.  The latency is measured from the start request to the stop notification so it
+ * includes the initialization of the target process.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+#include "legato.h"
+#include "interfaces.h"
+
+
+#define TARGET_APP_NAME         "ProcStartTarget"
+#define TARGET_PROC_NAME        "target"
+#define NUM_STARTS              100
+
+
+static le_appProc_RefRef_t TargetRef;
+static int NumStarts = 0;
+static le_clk_Time_t StartTime;
+static le_clk_Time_t FirstLatency;
+static le_clk_Time_t RestartsLatency = {0, 0};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the target process and records the time of the request.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartTarget
+(
+    void
+)
+{
+    StartTime = le_clk_GetRelativeTime();
+
+    LE_ASSERT(le_appProc_Start(TargetRef) == LE_OK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when the target process exits.  Restarts it until enough samples have been taken.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TargetStopped
+(
+    int32_t exitCode,
+    void* contextPtr
+)
+{
+    le_clk_Time_t latency = le_clk_Sub(le_clk_GetRelativeTime(), StartTime);
+
+    LE_ASSERT(exitCode == EXIT_SUCCESS);
+
+    NumStarts++;
+
+    if (NumStarts == 1)
+    {
+        FirstLatency = latency;
+    }
+    else
+    {
+        RestartsLatency = le_clk_Add(RestartsLatency, latency);
+    }
+
+    if (NumStarts < NUM_STARTS)
+    {
+        StartTarget();
+        return;
+    }
+
+    uint64_t avgUsec = ((uint64_t)RestartsLatency.sec * 1000000 + RestartsLatency.usec) /
+                       (NUM_STARTS - 1);
+
+    LE_INFO("First start: %ld.%06ld s", (long)FirstLatency.sec, (long)FirstLatency.usec);
+    LE_INFO("Average of %d restarts: %" PRIu64 " us", NUM_STARTS - 1, avgUsec);
+
+    le_appProc_Delete(TargetRef);
+
+    LE_INFO("======== Process Start Benchmark Ended ========");
+    exit(EXIT_SUCCESS);
+}
+
+
+COMPONENT_INIT
+{
+    LE_INFO("======== Start Process Start Benchmark ========");
+
+    TargetRef = le_appProc_Create(TARGET_APP_NAME, TARGET_PROC_NAME, "");
+    LE_ASSERT(TargetRef != NULL);
+
+    le_appProc_AddStopHandler(TargetRef, TargetStopped, NULL);
+
+    StartTarget();
+}
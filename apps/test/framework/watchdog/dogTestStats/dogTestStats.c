@@ -0,0 +1,79 @@
+#include "legato.h"
+#include "interfaces.h"
+
+/*
+ * This watchdog test reads back its kick counters after a known sequence of kicks and timeouts.
+ *
+ * The app is configured with a 2000 ms timeout, so kicks sooner than 100 ms after the last applied
+ * one are throttled. The kicks of a tight loop are all done well within 100 ms.
+ *
+ * The watchdogAction is "ignore", so that the app survives the expiry of its watchdog and can
+ * check that the expiry is counted as a missed deadline.
+ */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the kick counters of the watchdog.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckKickStats
+(
+    uint32_t expectedKicks,         ///< [IN] Expected number of kicks.
+    uint32_t expectedThrottled      ///< [IN] Expected number of throttled kicks.
+)
+{
+    uint32_t kickCount;
+    uint32_t throttledCount;
+    uint32_t missedCount;
+
+    LE_ASSERT(le_wdog_GetKickStats(&kickCount, &throttledCount, &missedCount) == LE_OK);
+    LE_INFO("%u kicks, %u throttled, %u missed deadlines", kickCount, throttledCount, missedCount);
+    LE_ASSERT(kickCount == expectedKicks);
+    LE_ASSERT(throttledCount == expectedThrottled);
+}
+
+COMPONENT_INIT
+{
+    uint32_t kickCount;
+    uint32_t throttledCount;
+    uint32_t missedCount;
+    uint32_t missedBefore;
+    int i;
+
+    LE_INFO("======== Start '%s' Test ========", le_arg_GetProgramName());
+
+    // No watchdog until the first kick.
+    LE_ASSERT(le_wdog_GetKickStats(&kickCount, &throttledCount, &missedBefore) == LE_NOT_FOUND);
+    LE_ASSERT((kickCount == 0) && (throttledCount == 0));
+
+    // The first kick is applied, the following ones are throttled.
+    for (i = 0; i < 10; i++)
+    {
+        le_wdog_Kick();
+    }
+    CheckKickStats(10, 9);
+
+    // A kick after the rate limit interval is applied.
+    usleep(150 * 1000);
+    le_wdog_Kick();
+    CheckKickStats(11, 9);
+
+    // A timeout and the kick reverting it are always applied.
+    le_wdog_Timeout(1000);
+    le_wdog_Kick();
+    CheckKickStats(13, 9);
+
+    // The expiry is counted as a missed deadline, and the counters of the watchdog start again.
+    le_wdog_Timeout(LE_WDOG_TIMEOUT_NOW);
+    usleep(500 * 1000);
+    LE_ASSERT(le_wdog_GetKickStats(&kickCount, &throttledCount, &missedCount) == LE_NOT_FOUND);
+    LE_ASSERT(missedCount > missedBefore);
+
+    le_wdog_Kick();
+    CheckKickStats(1, 0);
+
+    le_wdog_Timeout(LE_WDOG_TIMEOUT_NEVER);
+
+    LE_INFO("PASS");
+    exit(EXIT_SUCCESS);
+}
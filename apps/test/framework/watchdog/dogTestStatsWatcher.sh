@@ -0,0 +1,32 @@
+# dogTestStats
+# This script watches the output of the dogTestStats.
+# The test app reads back its watchdog kick counters after a known sequence of kicks and
+# timeouts, and logs PASS once they all matched. A failed check asserts and kills the app.
+
+TEST_NAME='dogTestStats'
+test_pid='XXXXXXXXXXX'
+
+#find where the supervisor starts the test and get the pid
+start_match="supervisor.*\| Starting process $TEST_NAME with pid ([0-9]*)"
+
+while read line
+do
+if [[ $line =~ $start_match ]]; then
+    test_pid=${BASH_REMATCH[1]}
+    echo "--$TEST_NAME started with pid ${test_pid}"
+fi
+if [[ $line =~ $test_pid ]]; then
+# These are potential lines of interest
+    echo "---$line"
+
+    if [[ $line =~ 'Assert Failed' ]]; then
+        echo "--FAIL"
+        exit 1
+    fi
+
+    if [[ $line =~ 'PASS' ]]; then
+        echo "--PASS"
+        exit 0
+    fi
+fi
+done
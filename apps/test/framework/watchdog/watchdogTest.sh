@@ -245,6 +245,10 @@ set_test_message dogTestRevertAfterTimeout "Test if watchdog reverts to regular
 launch dogTestRevertAfterTimeout dogTestRevertAfterTimeoutWatcher.sh 120
 sleep 2
 
+set_test_message dogTestStats "Test if the watchdog kick counters match a known sequence of kicks"
+launch dogTestStats dogTestStatsWatcher.sh 30
+sleep 2
+
 wait_for_results
 
 cleanup
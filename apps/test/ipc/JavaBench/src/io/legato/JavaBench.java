@@ -0,0 +1,212 @@
+/*
+ * Benchmark of the marshalling of IPC message payloads from Java.
+ *
+ * A message of 20 values (the shape of a typical generated API call) is packed and then unpacked
+ * again, either through MessageBuffer, which works directly in the payload memory, or through one
+ * native LegatoJni call per value as MessageBuffer used to.  Like JMH, each approach first runs a
+ * number of warm-up iterations so that the JIT has compiled the code being measured, and then
+ * reports the average time per message over the measurement iterations.
+ *
+ * The messages are created on a session that is never opened, so only the marshalling is measured,
+ * not the transfer to a server.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+package io.legato;
+
+import java.util.logging.Logger;
+
+public class JavaBench implements Component
+{
+    private static final int WARMUP_ITERATIONS = 5;
+    private static final int MEASURE_ITERATIONS = 10;
+    private static final int OPS_PER_ITERATION = 10000;
+
+    private static final int NUM_INTS = 8;
+    private static final int NUM_LONGS = 4;
+    private static final String STRING_VALUE = "Legato IPC benchmark";
+    private static final int MAX_STRING_BYTES = 64;
+
+    private Logger logger;
+    private ClientSession session;
+
+    // Consumes the unpacked values so that the JIT can't optimize the unpacking away.
+    private long sink;
+
+    private interface Marshaller
+    {
+        public void run(Message message);
+    }
+
+    private final Marshaller direct = new Marshaller()
+    {
+        @Override
+        public void run(Message message)
+        {
+            MessageBuffer buffer = message.getBuffer();
+
+            buffer.writeInt(1);
+            for (int i = 0; i < NUM_INTS; i++)
+            {
+                buffer.writeInt(i);
+            }
+            for (int i = 0; i < NUM_LONGS; i++)
+            {
+                buffer.writeLong(i);
+            }
+            buffer.writeDouble(1.5);
+            buffer.writeDouble(2.5);
+            buffer.writeBool(true);
+            buffer.writeBool(false);
+            buffer.writeByte((byte)1);
+            buffer.writeByte((byte)2);
+            buffer.writeString(STRING_VALUE, MAX_STRING_BYTES);
+
+            buffer.resetPosition();
+
+            long total = buffer.readInt();
+            for (int i = 0; i < NUM_INTS; i++)
+            {
+                total += buffer.readInt();
+            }
+            for (int i = 0; i < NUM_LONGS; i++)
+            {
+                total += buffer.readLong();
+            }
+            total += (long)buffer.readDouble();
+            total += (long)buffer.readDouble();
+            total += buffer.readBool() ? 1 : 0;
+            total += buffer.readBool() ? 1 : 0;
+            total += buffer.readByte();
+            total += buffer.readByte();
+            total += buffer.readString().length();
+
+            sink += total;
+        }
+    };
+
+    private final Marshaller perValueJni = new Marshaller()
+    {
+        @Override
+        public void run(Message message)
+        {
+            long ref = message.getRef();
+            int location = 0;
+
+            LegatoJni.SetMessageInt(ref, location, 1);
+            location += 4;
+            for (int i = 0; i < NUM_INTS; i++)
+            {
+                LegatoJni.SetMessageInt(ref, location, i);
+                location += 4;
+            }
+            for (int i = 0; i < NUM_LONGS; i++)
+            {
+                LegatoJni.SetMessageLong(ref, location, i);
+                location += 8;
+            }
+            LegatoJni.SetMessageDouble(ref, location, 1.5);
+            location += 8;
+            LegatoJni.SetMessageDouble(ref, location, 2.5);
+            location += 8;
+            LegatoJni.SetMessageBool(ref, location, true);
+            location += 1;
+            LegatoJni.SetMessageBool(ref, location, false);
+            location += 1;
+            LegatoJni.SetMessageByte(ref, location, (byte)1);
+            location += 1;
+            LegatoJni.SetMessageByte(ref, location, (byte)2);
+            location += 1;
+            LegatoJni.SetMessageString(ref, location, STRING_VALUE, MAX_STRING_BYTES);
+
+            location = 0;
+
+            long total = LegatoJni.GetMessageInt(ref, location);
+            location += 4;
+            for (int i = 0; i < NUM_INTS; i++)
+            {
+                total += LegatoJni.GetMessageInt(ref, location);
+                location += 4;
+            }
+            for (int i = 0; i < NUM_LONGS; i++)
+            {
+                total += LegatoJni.GetMessageLong(ref, location);
+                location += 8;
+            }
+            total += (long)LegatoJni.GetMessageDouble(ref, location);
+            location += 8;
+            total += (long)LegatoJni.GetMessageDouble(ref, location);
+            location += 8;
+            total += LegatoJni.GetMessageBool(ref, location) ? 1 : 0;
+            location += 1;
+            total += LegatoJni.GetMessageBool(ref, location) ? 1 : 0;
+            location += 1;
+            total += LegatoJni.GetMessageByte(ref, location);
+            location += 1;
+            total += LegatoJni.GetMessageByte(ref, location);
+            location += 1;
+            total += ((String)LegatoJni.GetMessageString(ref, location).value).length();
+
+            sink += total;
+        }
+    };
+
+    private long runIteration(Marshaller marshaller)
+    {
+        long start = System.nanoTime();
+
+        for (int i = 0; i < OPS_PER_ITERATION; i++)
+        {
+            Message message = session.createMessage();
+            marshaller.run(message);
+            message.close();
+        }
+
+        return System.nanoTime() - start;
+    }
+
+    private void runBenchmark(String name, Marshaller marshaller)
+    {
+        for (int i = 0; i < WARMUP_ITERATIONS; i++)
+        {
+            runIteration(marshaller);
+        }
+
+        long total = 0;
+
+        for (int i = 0; i < MEASURE_ITERATIONS; i++)
+        {
+            long elapsed = runIteration(marshaller);
+
+            logger.info(String.format("%s: iteration %d: %d ns/msg",
+                                      name, i, elapsed / OPS_PER_ITERATION));
+            total += elapsed;
+        }
+
+        logger.info(String.format("%s: average %d ns/msg",
+                                  name, total / (MEASURE_ITERATIONS * OPS_PER_ITERATION)));
+    }
+
+    @Override
+    public void componentInit()
+    {
+        logger.info("======== Start Java Message Marshalling Benchmark ========");
+
+        session = new ClientSession(new Protocol("ipcBenchJava", 512), "ipcBenchJava");
+
+        runBenchmark("perValueJni", perValueJni);
+        runBenchmark("direct", direct);
+
+        logger.info("(checksum " + sink + ")");
+        logger.info("======== Java Message Marshalling Benchmark Ended ========");
+
+        System.exit(0);
+    }
+
+    @Override
+    public void setLogger(Logger logger)
+    {
+        this.logger = logger;
+    }
+}
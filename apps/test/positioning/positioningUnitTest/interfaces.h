@@ -11,6 +11,9 @@
 
 le_msg_ServiceRef_t le_posCtrl_GetServiceRef(void);
 le_msg_SessionRef_t le_posCtrl_GetClientSessionRef(void);
+le_msg_ServiceRef_t le_pos_GetServiceRef(void);
+le_msg_SessionRef_t le_pos_GetClientSessionRef(void);
+void le_msgSimu_CloseSession(le_msg_SessionRef_t sessionRef);
 le_cfg_ChangeHandlerRef_t le_cfg_AddChangeHandler(const char *newPath,
                                 le_cfg_ChangeHandlerFunc_t handlerPtr,
                                 void *contextPtr);
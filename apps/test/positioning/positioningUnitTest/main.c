@@ -7,6 +7,7 @@
 
 #include "legato.h"
 #include "interfaces.h"
+#include "le_pos_local.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -536,6 +537,553 @@ static void Test_le_pos_GetFixState
     LE_ASSERT((state == LE_POS_STATE_FIX_ESTIMATED) && (result == LE_OK));
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fence events received by FenceHandler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_pos_FenceRef_t FenceEventRef;
+static le_pos_FenceEvent_t FenceEvent;
+static int FenceEventCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler for the fence events.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FenceHandler
+(
+    le_pos_FenceRef_t fenceRef,
+    le_pos_FenceEvent_t event,
+    void* contextPtr
+)
+{
+    FenceEventRef = fenceRef;
+    FenceEvent = event;
+    FenceEventCount++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test geofences
+ *
+ * Verify that the circle and polygon fences report the expected events
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_pos_Fence
+(
+    void
+)
+{
+    le_pos_FenceHandlerRef_t handlerRef;
+    le_pos_FenceRef_t circleRef, polygonRef;
+    // A 1 km x 1 km square, South-West of (0, 0) to check the negative coordinates.
+    int32_t latitudes[] = { -10000, -10000, -1000, -1000 };
+    int32_t longitudes[] = { -10000, -1000, -1000, -10000 };
+
+    handlerRef = le_pos_AddFenceHandler(FenceHandler, NULL);
+
+    // test for invalid fences
+    LE_ASSERT(le_pos_fence_CreateCircle(91000000, 0, 100, 0) == NULL);
+    LE_ASSERT(le_pos_fence_CreatePolygon(latitudes, 2, longitudes, 2, 0) == NULL);
+    LE_ASSERT(le_pos_fence_CreatePolygon(latitudes, 4, longitudes, 3, 0) == NULL);
+
+    // circle of 100 m around (48.8566, 2.3522), with a dwell time of 1 ms
+    circleRef = le_pos_fence_CreateCircle(48856600, 2352200, 100, 1);
+    LE_ASSERT(circleRef != NULL);
+
+    FenceEventCount = 0;
+    posFence_ProcessPosition(48860000, 2352200);
+    LE_ASSERT(FenceEventCount == 0);
+
+    posFence_ProcessPosition(48857000, 2352200);
+    LE_ASSERT((FenceEventCount == 1) && (FenceEventRef == circleRef) &&
+              (FenceEvent == LE_POS_FENCE_ENTER));
+
+    usleep(2000);
+    posFence_ProcessPosition(48856700, 2352300);
+    LE_ASSERT((FenceEventCount == 2) && (FenceEvent == LE_POS_FENCE_DWELL));
+
+    // no more dwell event
+    usleep(2000);
+    posFence_ProcessPosition(48856600, 2352200);
+    LE_ASSERT(FenceEventCount == 2);
+
+    // exit to a position far away, in another cell of the grid
+    posFence_ProcessPosition(40000000, 2352200);
+    LE_ASSERT((FenceEventCount == 3) && (FenceEventRef == circleRef) &&
+              (FenceEvent == LE_POS_FENCE_EXIT));
+
+    le_pos_fence_Delete(circleRef);
+
+    // polygon without dwell time
+    polygonRef = le_pos_fence_CreatePolygon(latitudes, 4, longitudes, 4, 0);
+    LE_ASSERT(polygonRef != NULL);
+
+    FenceEventCount = 0;
+    posFence_ProcessPosition(-500, -5000);
+    LE_ASSERT(FenceEventCount == 0);
+
+    posFence_ProcessPosition(-5000, -5000);
+    LE_ASSERT((FenceEventCount == 1) && (FenceEventRef == polygonRef) &&
+              (FenceEvent == LE_POS_FENCE_ENTER));
+
+    usleep(2000);
+    posFence_ProcessPosition(-9000, -2000);
+    LE_ASSERT(FenceEventCount == 1);
+
+    posFence_ProcessPosition(-9000, 2000);
+    LE_ASSERT((FenceEventCount == 2) && (FenceEvent == LE_POS_FENCE_EXIT));
+
+    // a deleted fence doesn't report anything
+    le_pos_fence_Delete(polygonRef);
+    posFence_ProcessPosition(-5000, -5000);
+    LE_ASSERT(FenceEventCount == 2);
+
+    // nor does a removed handler
+    polygonRef = le_pos_fence_CreatePolygon(latitudes, 4, longitudes, 4, 0);
+    le_pos_RemoveFenceHandler(handlerRef);
+    posFence_ProcessPosition(-4000, -4000);
+    LE_ASSERT(FenceEventCount == 2);
+    le_pos_fence_Delete(polygonRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Geofence benchmark
+ *
+ * Evaluate a 10 Hz fix stream for 60 seconds against 10000 fences spread over a 100 km x 100 km
+ * area, and check that each fix is only checked against the few fences around it.  The processing
+ * time is logged but not checked, as it depends on the load of the machine running the test.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_FENCE_COUNT       10000
+#define BENCH_FIX_COUNT         600
+
+// The circles are centered on the corners of the grid cells and don't overlap: a fix is checked
+// against the 4 fences of its cell, plus the one it may still be inside of from the previous cell.
+#define BENCH_MAX_CHECKS        5
+
+static void Test_le_pos_FenceBenchmark
+(
+    void
+)
+{
+    static le_pos_FenceRef_t fenceRefs[BENCH_FENCE_COUNT];
+    le_pos_FenceHandlerRef_t handlerRef;
+    le_clk_Time_t start, elapsed, maxElapsed = { 0, 0 }, totalElapsed = { 0, 0 };
+    uint32_t checkCount, maxCheckCount = 0;
+    int i;
+
+    handlerRef = le_pos_AddFenceHandler(FenceHandler, NULL);
+
+    // 100 x 100 circles of 300 m, one every 0.01 degree
+    for (i = 0; i < BENCH_FENCE_COUNT; i++)
+    {
+        fenceRefs[i] = le_pos_fence_CreateCircle(45000000 + (i / 100) * 10000,
+                                                 5000000 + (i % 100) * 10000,
+                                                 300,
+                                                 5000);
+        LE_ASSERT(fenceRefs[i] != NULL);
+    }
+
+    // a straight path across the area, about 14 m between fixes
+    FenceEventCount = 0;
+    for (i = 0; i < BENCH_FIX_COUNT; i++)
+    {
+        start = le_clk_GetRelativeTime();
+        checkCount = posFence_ProcessPosition(45000000 + i * 100, 5000000 + i * 100);
+        elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+        if (checkCount > maxCheckCount)
+        {
+            maxCheckCount = checkCount;
+        }
+
+        totalElapsed = le_clk_Add(totalElapsed, elapsed);
+        if (le_clk_GreaterThan(elapsed, maxElapsed))
+        {
+            maxElapsed = elapsed;
+        }
+    }
+
+    LE_INFO("%d fences, %d fixes: average %lu us, max %lu us, max %u fences checked per fix,"
+            " %d events",
+            BENCH_FENCE_COUNT, BENCH_FIX_COUNT,
+            (unsigned long)((totalElapsed.sec * 1000000 + totalElapsed.usec) / BENCH_FIX_COUNT),
+            (unsigned long)(maxElapsed.sec * 1000000 + maxElapsed.usec),
+            maxCheckCount, FenceEventCount);
+
+    LE_ASSERT(FenceEventCount > 0);
+    LE_ASSERT((maxCheckCount > 0) && (maxCheckCount <= BENCH_MAX_CHECKS));
+
+    for (i = 0; i < BENCH_FENCE_COUNT; i++)
+    {
+        le_pos_fence_Delete(fenceRefs[i]);
+    }
+    le_pos_RemoveFenceHandler(handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position sample references received by StressMovementHandler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+#define STRESS_SAMPLE_COUNT     1000
+
+static le_pos_SampleRef_t StressSampleRefs[STRESS_SAMPLE_COUNT];
+static int StressSampleCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Movement handler keeping the position sample references.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void StressMovementHandler
+(
+    le_pos_SampleRef_t positionSampleRef,
+    void* contextPtr
+)
+{
+    LE_ASSERT(StressSampleCount < STRESS_SAMPLE_COUNT);
+    StressSampleRefs[StressSampleCount++] = positionSampleRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position sample references stress test
+ *
+ * Hold 1000 position sample references, release half of them one by one and check that the
+ * others are released when the client session closes
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_pos_SampleRefStress
+(
+    void
+)
+{
+    le_pos_MovementHandlerRef_t handlerRef;
+    gnssSimuLocation_t gnssLocation;
+    le_clk_Time_t start, reportTime, releaseTime;
+    int32_t latitude, longitude, accuracy;
+    int var = 0;
+    int i;
+
+    gnssLocation.latitude = 48856600;
+    gnssLocation.longitude = 2352200;
+    gnssLocation.accuracy = 1000;
+    gnssLocation.result = LE_OK;
+    le_gnssSimu_SetLocation(gnssLocation);
+    le_gnssSimu_SetSampleRef((le_gnss_SampleRef_t) &var);
+
+    // no magnitude: every position is reported
+    handlerRef = le_pos_AddMovementHandler(0, 0, StressMovementHandler, NULL);
+
+    StressSampleCount = 0;
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < STRESS_SAMPLE_COUNT; i++)
+    {
+        le_gnssSimu_ReportPosition();
+    }
+    reportTime = le_clk_Sub(le_clk_GetRelativeTime(), start);
+    LE_ASSERT(StressSampleCount == STRESS_SAMPLE_COUNT);
+
+    LE_ASSERT(le_pos_sample_Get2DLocation(StressSampleRefs[0], &latitude, &longitude,
+                                          &accuracy) == LE_OK);
+    LE_ASSERT((latitude == gnssLocation.latitude) && (longitude == gnssLocation.longitude));
+
+    // release the oldest references first, the worst case for a list of all the samples
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < STRESS_SAMPLE_COUNT; i += 2)
+    {
+        le_pos_sample_Release(StressSampleRefs[i]);
+    }
+    releaseTime = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    LE_INFO("%d samples: %lu us to report, %lu us to release half of them",
+            STRESS_SAMPLE_COUNT,
+            (unsigned long)(reportTime.sec * 1000000 + reportTime.usec),
+            (unsigned long)(releaseTime.sec * 1000000 + releaseTime.usec));
+
+    LE_ASSERT(le_pos_sample_Get2DLocation(StressSampleRefs[0], &latitude, &longitude,
+                                          &accuracy) == LE_FAULT);
+    LE_ASSERT(le_pos_sample_Get2DLocation(StressSampleRefs[1], &latitude, &longitude,
+                                          &accuracy) == LE_OK);
+
+    // the remaining references are released when the client goes away
+    le_msgSimu_CloseSession(le_pos_GetClientSessionRef());
+
+    for (i = 1; i < STRESS_SAMPLE_COUNT; i += 2)
+    {
+        LE_ASSERT(le_pos_sample_Get2DLocation(StressSampleRefs[i], &latitude, &longitude,
+                                              &accuracy) == LE_FAULT);
+    }
+
+    le_pos_RemoveMovementHandler(handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Batches of position samples received by BatchHandler, one per handler context.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+#define BATCH_HANDLER_COUNT     2
+
+typedef struct
+{
+    int         batchCount;                         ///< Number of batches received.
+    size_t      numSamples;                         ///< Number of samples in the last batch.
+    int32_t     latitude[LE_POS_MAX_BATCH_SIZE];    ///< Latitudes of the last batch.
+    int32_t     hAccuracy[LE_POS_MAX_BATCH_SIZE];   ///< Accuracies of the last batch.
+    le_clk_Time_t time;                             ///< Time at which the last batch arrived.
+}
+ReceivedBatch_t;
+
+static ReceivedBatch_t ReceivedBatches[BATCH_HANDLER_COUNT];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample batch handler recording the batches in the ReceivedBatch_t given as context.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void BatchHandler
+(
+    const int32_t* latitudePtr,
+    size_t latitudeSize,
+    const int32_t* longitudePtr,
+    size_t longitudeSize,
+    const int32_t* hAccuracyPtr,
+    size_t hAccuracySize,
+    const int32_t* altitudePtr,
+    size_t altitudeSize,
+    const uint32_t* hSpeedPtr,
+    size_t hSpeedSize,
+    const uint32_t* directionPtr,
+    size_t directionSize,
+    const uint64_t* epochTimePtr,
+    size_t epochTimeSize,
+    void* contextPtr
+)
+{
+    ReceivedBatch_t* batchPtr = (ReceivedBatch_t*)contextPtr;
+
+    LE_ASSERT((latitudeSize > 0) && (latitudeSize <= LE_POS_MAX_BATCH_SIZE));
+    LE_ASSERT((longitudeSize == latitudeSize) && (hAccuracySize == latitudeSize)
+              && (altitudeSize == latitudeSize) && (hSpeedSize == latitudeSize)
+              && (directionSize == latitudeSize) && (epochTimeSize == latitudeSize));
+
+    batchPtr->batchCount++;
+    batchPtr->numSamples = latitudeSize;
+    memcpy(batchPtr->latitude, latitudePtr, latitudeSize * sizeof(int32_t));
+    memcpy(batchPtr->hAccuracy, hAccuracyPtr, hAccuracySize * sizeof(int32_t));
+    batchPtr->time = le_clk_GetRelativeTime();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a position at the given latitude to the positioning service.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportLatitude
+(
+    int32_t latitude
+)
+{
+    gnssSimuLocation_t gnssLocation;
+
+    gnssLocation.latitude = latitude;
+    gnssLocation.longitude = 2352200;
+    gnssLocation.accuracy = 1000;
+    gnssLocation.result = LE_OK;
+    le_gnssSimu_SetLocation(gnssLocation);
+    le_gnssSimu_ReportPosition();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample batch test
+ *
+ * Verify that the samples are decimated in distance and in time, that they are delivered by
+ * batches of maxBatchSize samples to all the handlers sharing the same parameters, and that
+ * nothing is delivered once the handlers are removed.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_pos_SampleBatch
+(
+    void
+)
+{
+    le_pos_SampleBatchHandlerRef_t handlerRefs[BATCH_HANDLER_COUNT];
+    int var = 0;
+    int i;
+
+    le_gnssSimu_SetSampleRef((le_gnss_SampleRef_t) &var);
+    memset(ReceivedBatches, 0, sizeof(ReceivedBatches));
+
+    // Distance decimation: a sample is kept once it is 100 m away from the last one, accuracy
+    // (10 m) included. Both handlers share the same filter and the same batches.
+    for (i = 0; i < BATCH_HANDLER_COUNT; i++)
+    {
+        handlerRefs[i] = le_pos_AddSampleBatchHandler(0, 100, 3, 0, BatchHandler,
+                                                      &ReceivedBatches[i]);
+        LE_ASSERT(handlerRefs[i] != NULL);
+    }
+
+    ReportLatitude(48856600);   // kept, first sample
+    ReportLatitude(48856700);   // 11 m away, dropped
+    ReportLatitude(48857500);   // 100 m away, but only 90 m for sure: dropped
+    ReportLatitude(48857600);   // 111 m away, kept
+    LE_ASSERT(ReceivedBatches[0].batchCount == 0);
+    ReportLatitude(48858600);   // 111 m away, kept: the batch is full
+    ReportLatitude(48858600);   // same place, dropped
+
+    for (i = 0; i < BATCH_HANDLER_COUNT; i++)
+    {
+        LE_ASSERT(ReceivedBatches[i].batchCount == 1);
+        LE_ASSERT(ReceivedBatches[i].numSamples == 3);
+        LE_ASSERT(ReceivedBatches[i].latitude[0] == 48856600);
+        LE_ASSERT(ReceivedBatches[i].latitude[1] == 48857600);
+        LE_ASSERT(ReceivedBatches[i].latitude[2] == 48858600);
+        LE_ASSERT(ReceivedBatches[i].hAccuracy[0] == 10);
+    }
+
+    // The pending samples are dropped with the last handler of the filter.
+    ReportLatitude(48859600);
+    le_pos_RemoveSampleBatchHandler(handlerRefs[1]);
+    le_pos_RemoveSampleBatchHandler(handlerRefs[0]);
+    for (i = 0; i < 2 * LE_POS_MAX_BATCH_SIZE; i++)
+    {
+        ReportLatitude(48860600 + i * 1000);
+    }
+    LE_ASSERT(ReceivedBatches[0].batchCount == 1);
+    LE_ASSERT(ReceivedBatches[1].batchCount == 1);
+
+    // Time decimation: a sample is kept once 50 ms have elapsed since the last one. A batch size
+    // above LE_POS_MAX_BATCH_SIZE is handled as LE_POS_MAX_BATCH_SIZE.
+    memset(ReceivedBatches, 0, sizeof(ReceivedBatches));
+    handlerRefs[0] = le_pos_AddSampleBatchHandler(50, 0, LE_POS_MAX_BATCH_SIZE + 1, 0,
+                                                  BatchHandler, &ReceivedBatches[0]);
+    LE_ASSERT(handlerRefs[0] != NULL);
+
+    for (i = 0; i < LE_POS_MAX_BATCH_SIZE; i++)
+    {
+        ReportLatitude(48856600 + i);   // kept
+        ReportLatitude(48856600);       // too early, dropped
+        usleep(60 * 1000);
+    }
+
+    LE_ASSERT(ReceivedBatches[0].batchCount == 1);
+    LE_ASSERT(ReceivedBatches[0].numSamples == LE_POS_MAX_BATCH_SIZE);
+    for (i = 0; i < LE_POS_MAX_BATCH_SIZE; i++)
+    {
+        LE_ASSERT(ReceivedBatches[0].latitude[i] == 48856600 + i);
+    }
+
+    le_pos_RemoveSampleBatchHandler(handlerRefs[0]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time at which the sample of the latency test was reported.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t LatencyReportTime;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the latency test: check the batch and end the tests.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void LatencyBatchHandler
+(
+    const int32_t* latitudePtr,
+    size_t latitudeSize,
+    const int32_t* longitudePtr,
+    size_t longitudeSize,
+    const int32_t* hAccuracyPtr,
+    size_t hAccuracySize,
+    const int32_t* altitudePtr,
+    size_t altitudeSize,
+    const uint32_t* hSpeedPtr,
+    size_t hSpeedSize,
+    const uint32_t* directionPtr,
+    size_t directionSize,
+    const uint64_t* epochTimePtr,
+    size_t epochTimeSize,
+    void* contextPtr
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), LatencyReportTime);
+
+    LE_ASSERT(latitudeSize == 1);
+    LE_ASSERT(latitudePtr[0] == 48856600);
+    LE_ASSERT((elapsed.sec * 1000 + elapsed.usec / 1000) >= 100);
+
+    LE_INFO("Sample batch delivered after %ld ms",
+            (long)(elapsed.sec * 1000 + elapsed.usec / 1000));
+
+    exit(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called if the batch of the latency test never arrives.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void LatencyGuardTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    LE_FATAL("The pending sample was not delivered after maxLatency");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample batch latency test
+ *
+ * Verify that a pending sample is delivered maxLatency milliseconds after it was kept, although
+ * the batch is not full. The batch is delivered from the event loop, so this test must be the
+ * last one: LatencyBatchHandler ends the tests.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_pos_SampleBatchLatency
+(
+    void
+)
+{
+    static int var = 0;
+    le_timer_Ref_t guardTimer;
+
+    le_gnssSimu_SetSampleRef((le_gnss_SampleRef_t) &var);
+
+    LE_ASSERT(le_pos_AddSampleBatchHandler(0, 0, LE_POS_MAX_BATCH_SIZE, 100,
+                                           LatencyBatchHandler, NULL) != NULL);
+
+    LatencyReportTime = le_clk_GetRelativeTime();
+    ReportLatitude(48856600);
+
+    guardTimer = le_timer_Create("LatencyGuard");
+    le_timer_SetHandler(guardTimer, LatencyGuardTimerHandler);
+    le_timer_SetMsInterval(guardTimer, 5000);
+    le_timer_Start(guardTimer);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * main of the test
@@ -559,6 +1107,11 @@ COMPONENT_INIT
     Test_le_pos_GetDate();
     Test_le_pos_GetTime();
     Test_le_pos_GetFixState();
+    Test_le_pos_Fence();
+    Test_le_pos_FenceBenchmark();
+    Test_le_pos_SampleRefStress();
+    Test_le_pos_SampleBatch();
 
-    exit(0);
+    // Last test, ends the tests from the event loop
+    Test_le_pos_SampleBatchLatency();
 }
@@ -36,6 +36,23 @@ static gnssSimuAltitude_t GnssAltitude;
 //--------------------------------------------------------------------------------------------------
 static gnssSimuDirection_t GnssDirection;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maintains the position handlers
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+#define GNSS_SIMU_MAX_HANDLERS  4
+
+typedef struct
+{
+    le_gnss_PositionHandlerFunc_t handlerPtr;
+    void*                         contextPtr;
+}
+gnssSimuHandler_t;
+
+static gnssSimuHandler_t PositionHandlers[GNSS_SIMU_MAX_HANDLERS];
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maintains simulated horizontal data
@@ -242,6 +259,18 @@ le_gnss_PositionHandlerRef_t le_gnss_AddPositionHandler
     void*                        contextPtr           ///< [IN] The context pointer
 )
 {
+    int i;
+
+    for (i = 0; i < GNSS_SIMU_MAX_HANDLERS; i++)
+    {
+        if (PositionHandlers[i].handlerPtr == NULL)
+        {
+            PositionHandlers[i].handlerPtr = handlerPtr;
+            PositionHandlers[i].contextPtr = contextPtr;
+            return (le_gnss_PositionHandlerRef_t)&PositionHandlers[i];
+        }
+    }
+
     return NULL;
 }
 
@@ -257,6 +286,31 @@ void le_gnss_RemovePositionHandler
     le_gnss_PositionHandlerRef_t    handlerRef ///< [IN] The handler reference.
 )
 {
+    gnssSimuHandler_t* handlerPtr = (gnssSimuHandler_t*)handlerRef;
+
+    handlerPtr->handlerPtr = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * le_gnssSimu_ReportPosition: report the sample reference to the position handlers
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gnssSimu_ReportPosition
+(
+    void
+)
+{
+    int i;
+
+    for (i = 0; i < GNSS_SIMU_MAX_HANDLERS; i++)
+    {
+        if (PositionHandlers[i].handlerPtr != NULL)
+        {
+            PositionHandlers[i].handlerPtr(Sample, PositionHandlers[i].contextPtr);
+        }
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -850,6 +904,199 @@ le_result_t le_gnss_GetMagneticDeviation
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get all the position sample's parameters at once, from the simulated data. The parameters
+ * that are not simulated are reported as invalid.
+ *
+ * @return
+ *  - LE_FAULT         One of the simulated getters is set to fail.
+ *  - LE_OUT_OF_RANGE  One of the retrieved parameter is invalid.
+ *  - LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_GetSample
+(
+    le_gnss_SampleRef_t positionSampleRef,
+        ///< [IN] Position sample's reference.
+
+    le_gnss_FixState_t* statePtr,
+        ///< [OUT] Position fix state.
+
+    int32_t* latitudePtr,
+        ///< [OUT] WGS84 Latitude in degrees, positive North [resolution 1e-6].
+
+    int32_t* longitudePtr,
+        ///< [OUT] WGS84 Longitude in degrees, positive East [resolution 1e-6].
+
+    int32_t* hAccuracyPtr,
+        ///< [OUT] Horizontal position's accuracy in meters [resolution 1e-2].
+
+    int32_t* altitudePtr,
+        ///< [OUT] Altitude in meters, above Mean Sea Level [resolution 1e-3].
+
+    int32_t* vAccuracyPtr,
+        ///< [OUT] Vertical position's accuracy in meters [resolution 1e-1].
+
+    int32_t* altitudeOnWgs84Ptr,
+        ///< [OUT] Altitude in meters, between WGS-84 earth ellipsoid
+        ///<       and mean sea level [resolution 1e-3].
+
+    uint32_t* hSpeedPtr,
+        ///< [OUT] Horizontal speed in meters/second [resolution 1e-2].
+
+    uint32_t* hSpeedAccuracyPtr,
+        ///< [OUT] Horizontal speed's accuracy in meters/second [resolution 1e-1].
+
+    int32_t* vSpeedPtr,
+        ///< [OUT] Vertical speed in meters/second [resolution 1e-2].
+
+    int32_t* vSpeedAccuracyPtr,
+        ///< [OUT] Vertical speed's accuracy in meters/second [resolution 1e-1].
+
+    uint32_t* directionPtr,
+        ///< [OUT] Direction in degrees [resolution 1e-1].
+
+    uint32_t* directionAccuracyPtr,
+        ///< [OUT] Direction's accuracy estimate in degrees [resolution 1e-1].
+
+    int32_t* magneticDeviationPtr,
+        ///< [OUT] MagneticDeviation in degrees [resolution 1e-1].
+
+    uint16_t* yearPtr,
+        ///< [OUT] UTC Year A.D. [e.g. 2014].
+
+    uint16_t* monthPtr,
+        ///< [OUT] UTC Month into the year [range 1...12].
+
+    uint16_t* dayPtr,
+        ///< [OUT] UTC Days into the month [range 1...31].
+
+    uint16_t* hoursPtr,
+        ///< [OUT] UTC Hours into the day [range 0..23].
+
+    uint16_t* minutesPtr,
+        ///< [OUT] UTC Minutes into the hour [range 0..59].
+
+    uint16_t* secondsPtr,
+        ///< [OUT] UTC Seconds into the minute [range 0..59].
+
+    uint16_t* millisecondsPtr,
+        ///< [OUT] UTC Milliseconds into the second [range 0..999].
+
+    uint64_t* epochTimePtr,
+        ///< [OUT] Epoch time in milliseconds since Jan. 1, 1970.
+
+    uint32_t* timeAccuracyPtr,
+        ///< [OUT] Estimated time accuracy in milliseconds.
+
+    uint32_t* gpsWeekPtr,
+        ///< [OUT] GPS week number from midnight, Jan. 6, 1980.
+
+    uint32_t* gpsTimeOfWeekPtr,
+        ///< [OUT] Amount of time in milliseconds into the GPS week.
+
+    uint16_t* hdopPtr,
+        ///< [OUT] Horizontal Dilution of Precision [resolution 1e-3].
+
+    uint16_t* vdopPtr,
+        ///< [OUT] Vertical Dilution of Precision [resolution 1e-3].
+
+    uint16_t* pdopPtr,
+        ///< [OUT] Position Dilution of Precision [resolution 1e-3].
+
+    uint8_t* satsInViewCountPtr,
+        ///< [OUT] Number of satellites expected to be in view.
+
+    uint8_t* satsTrackingCountPtr,
+        ///< [OUT] Number of satellites in view, when tracking.
+
+    uint8_t* satsUsedCountPtr
+        ///< [OUT] Number of satellites in view used for Navigation.
+)
+{
+    le_result_t result = LE_OK;
+    gnssSimuDate_t date = GnssDate;
+    gnssSimuTime_t time = GnssTime;
+
+    // Like the GNSS service, report an invalid date or time as all 0.
+    if (LE_OK != date.result)
+    {
+        date.year = 0;
+        date.month = 0;
+        date.day = 0;
+    }
+    if (LE_OK != time.result)
+    {
+        time.hrs = 0;
+        time.min = 0;
+        time.sec = 0;
+        time.msec = 0;
+    }
+
+#define SIMU_VALUE(ptr, value) \
+    if (ptr)                   \
+    {                          \
+        *(ptr) = (value);      \
+    }
+
+    SIMU_VALUE(statePtr, GnssSimuPositionSate.state);
+    SIMU_VALUE(latitudePtr, GnssLocation.latitude);
+    SIMU_VALUE(longitudePtr, GnssLocation.longitude);
+    SIMU_VALUE(hAccuracyPtr, GnssLocation.accuracy);
+    SIMU_VALUE(altitudePtr, GnssAltitude.altitude);
+    SIMU_VALUE(vAccuracyPtr, GnssAltitude.accuracy);
+    SIMU_VALUE(altitudeOnWgs84Ptr, INT32_MAX);
+    SIMU_VALUE(hSpeedPtr, GnssHSpeed.speed);
+    SIMU_VALUE(hSpeedAccuracyPtr, GnssHSpeed.accuracy);
+    SIMU_VALUE(vSpeedPtr, GnssVSpeed.speed);
+    SIMU_VALUE(vSpeedAccuracyPtr, GnssVSpeed.accuracy);
+    SIMU_VALUE(directionPtr, GnssDirection.direction);
+    SIMU_VALUE(directionAccuracyPtr, GnssDirection.accuracy);
+    SIMU_VALUE(magneticDeviationPtr, INT32_MAX);
+    SIMU_VALUE(yearPtr, date.year);
+    SIMU_VALUE(monthPtr, date.month);
+    SIMU_VALUE(dayPtr, date.day);
+    SIMU_VALUE(hoursPtr, time.hrs);
+    SIMU_VALUE(minutesPtr, time.min);
+    SIMU_VALUE(secondsPtr, time.sec);
+    SIMU_VALUE(millisecondsPtr, time.msec);
+    SIMU_VALUE(epochTimePtr, 0);
+    SIMU_VALUE(timeAccuracyPtr, UINT16_MAX);
+    SIMU_VALUE(gpsWeekPtr, 0);
+    SIMU_VALUE(gpsTimeOfWeekPtr, 0);
+    SIMU_VALUE(hdopPtr, UINT16_MAX);
+    SIMU_VALUE(vdopPtr, UINT16_MAX);
+    SIMU_VALUE(pdopPtr, UINT16_MAX);
+    SIMU_VALUE(satsInViewCountPtr, UINT8_MAX);
+    SIMU_VALUE(satsTrackingCountPtr, UINT8_MAX);
+    SIMU_VALUE(satsUsedCountPtr, UINT8_MAX);
+
+#undef SIMU_VALUE
+
+    le_result_t results[] =
+    {
+        GnssSimuPositionSate.result, GnssLocation.result, GnssAltitude.result, GnssHSpeed.result,
+        GnssVSpeed.result, GnssDirection.result, GnssDate.result, GnssTime.result
+    };
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(results); i++)
+    {
+        if (LE_FAULT == results[i])
+        {
+            return LE_FAULT;
+        }
+        if (LE_OK != results[i])
+        {
+            result = LE_OUT_OF_RANGE;
+        }
+    }
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function gets the last updated position sample object reference.
@@ -134,6 +134,7 @@ void le_gnssSimu_SetVSpeed(gnssSimuVSpeed_t gnssVSpeed);
 void le_gnssSimu_SetTime(gnssSimuTime_t gnssTime);
 void le_gnssSimu_SetSampleRef(le_gnss_SampleRef_t sample);
 void le_gnssSimu_SetPositionState(gnssSimuPositionState_t state);
+void le_gnssSimu_ReportPosition(void);
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -540,6 +541,106 @@ le_result_t le_gnss_GetMagneticDeviation
         ///< [OUT] MagneticDeviation in degrees [resolution 1e-1].
 );
 
+le_result_t le_gnss_GetSample
+(
+    le_gnss_SampleRef_t positionSampleRef,
+        ///< [IN] Position sample's reference.
+
+    le_gnss_FixState_t* statePtr,
+        ///< [OUT] Position fix state.
+
+    int32_t* latitudePtr,
+        ///< [OUT] WGS84 Latitude in degrees, positive North [resolution 1e-6].
+
+    int32_t* longitudePtr,
+        ///< [OUT] WGS84 Longitude in degrees, positive East [resolution 1e-6].
+
+    int32_t* hAccuracyPtr,
+        ///< [OUT] Horizontal position's accuracy in meters [resolution 1e-2].
+
+    int32_t* altitudePtr,
+        ///< [OUT] Altitude in meters, above Mean Sea Level [resolution 1e-3].
+
+    int32_t* vAccuracyPtr,
+        ///< [OUT] Vertical position's accuracy in meters [resolution 1e-1].
+
+    int32_t* altitudeOnWgs84Ptr,
+        ///< [OUT] Altitude in meters, between WGS-84 earth ellipsoid
+        ///<       and mean sea level [resolution 1e-3].
+
+    uint32_t* hSpeedPtr,
+        ///< [OUT] Horizontal speed in meters/second [resolution 1e-2].
+
+    uint32_t* hSpeedAccuracyPtr,
+        ///< [OUT] Horizontal speed's accuracy in meters/second [resolution 1e-1].
+
+    int32_t* vSpeedPtr,
+        ///< [OUT] Vertical speed in meters/second [resolution 1e-2].
+
+    int32_t* vSpeedAccuracyPtr,
+        ///< [OUT] Vertical speed's accuracy in meters/second [resolution 1e-1].
+
+    uint32_t* directionPtr,
+        ///< [OUT] Direction in degrees [resolution 1e-1].
+
+    uint32_t* directionAccuracyPtr,
+        ///< [OUT] Direction's accuracy estimate in degrees [resolution 1e-1].
+
+    int32_t* magneticDeviationPtr,
+        ///< [OUT] MagneticDeviation in degrees [resolution 1e-1].
+
+    uint16_t* yearPtr,
+        ///< [OUT] UTC Year A.D. [e.g. 2014].
+
+    uint16_t* monthPtr,
+        ///< [OUT] UTC Month into the year [range 1...12].
+
+    uint16_t* dayPtr,
+        ///< [OUT] UTC Days into the month [range 1...31].
+
+    uint16_t* hoursPtr,
+        ///< [OUT] UTC Hours into the day [range 0..23].
+
+    uint16_t* minutesPtr,
+        ///< [OUT] UTC Minutes into the hour [range 0..59].
+
+    uint16_t* secondsPtr,
+        ///< [OUT] UTC Seconds into the minute [range 0..59].
+
+    uint16_t* millisecondsPtr,
+        ///< [OUT] UTC Milliseconds into the second [range 0..999].
+
+    uint64_t* epochTimePtr,
+        ///< [OUT] Epoch time in milliseconds since Jan. 1, 1970.
+
+    uint32_t* timeAccuracyPtr,
+        ///< [OUT] Estimated time accuracy in milliseconds.
+
+    uint32_t* gpsWeekPtr,
+        ///< [OUT] GPS week number from midnight, Jan. 6, 1980.
+
+    uint32_t* gpsTimeOfWeekPtr,
+        ///< [OUT] Amount of time in milliseconds into the GPS week.
+
+    uint16_t* hdopPtr,
+        ///< [OUT] Horizontal Dilution of Precision [resolution 1e-3].
+
+    uint16_t* vdopPtr,
+        ///< [OUT] Vertical Dilution of Precision [resolution 1e-3].
+
+    uint16_t* pdopPtr,
+        ///< [OUT] Position Dilution of Precision [resolution 1e-3].
+
+    uint8_t* satsInViewCountPtr,
+        ///< [OUT] Number of satellites expected to be in view.
+
+    uint8_t* satsTrackingCountPtr,
+        ///< [OUT] Number of satellites in view, when tracking.
+
+    uint8_t* satsUsedCountPtr
+        ///< [OUT] Number of satellites in view used for Navigation.
+);
+
 le_gnss_SampleRef_t le_gnss_GetLastSampleRef
 (
     void
@@ -29,6 +29,88 @@ le_msg_SessionRef_t le_posCtrl_GetClientSessionRef
     return NULL;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service refrence stub
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_pos_GetServiceRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session refrence stub
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_pos_GetClientSessionRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Service close handlers, called by le_msgSimu_CloseSession()
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_SIMU_MAX_CLOSE_HANDLERS     8
+
+static le_msg_SessionEventHandler_t CloseHandlers[MSG_SIMU_MAX_CLOSE_HANDLERS];
+static void* CloseHandlerContexts[MSG_SIMU_MAX_CLOSE_HANDLERS];
+static int NumOfCloseHandlers;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add service close handler stub: there is no real service in the unit test, the handlers are
+ * called by le_msgSimu_CloseSession()
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionEventHandlerRef_t le_msg_AddServiceCloseHandler
+(
+    le_msg_ServiceRef_t             serviceRef,
+    le_msg_SessionEventHandler_t    handlerFunc,
+    void*                           contextPtr
+)
+{
+    LE_ASSERT(NumOfCloseHandlers < MSG_SIMU_MAX_CLOSE_HANDLERS);
+
+    CloseHandlers[NumOfCloseHandlers] = handlerFunc;
+    CloseHandlerContexts[NumOfCloseHandlers] = contextPtr;
+    NumOfCloseHandlers++;
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the closing of a client session
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msgSimu_CloseSession
+(
+    le_msg_SessionRef_t sessionRef
+)
+{
+    int i;
+
+    for (i = 0; i < NumOfCloseHandlers; i++)
+    {
+        CloseHandlers[i](sessionRef, CloseHandlerContexts[i]);
+    }
+}
+
 le_cfg_ChangeHandlerRef_t le_cfg_AddChangeHandler
 (
     const char *newPath,
@@ -0,0 +1,193 @@
+/**
+ * This module implements the unit tests for the le_pm API.
+ *
+ * The power manager writes to a fake sysfs tree given by the LE_PM_SYSFS_ROOT environment
+ * variable, and runs with a LE_PM_HOLD_OFF_MS release hold-off.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kernel wake lock held by the power manager
+ */
+//--------------------------------------------------------------------------------------------------
+#define WAKE_LOCK_NAME      "legato"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time to wait for the wake lock release: longer than the hold-off
+ */
+//--------------------------------------------------------------------------------------------------
+#define RELEASE_WAIT_MS     300
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Paths of the fake sysfs files
+ */
+//--------------------------------------------------------------------------------------------------
+static char WakeLockPath[PATH_MAX];
+static char WakeUnlockPath[PATH_MAX];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wakeup sources used by the tests
+ */
+//--------------------------------------------------------------------------------------------------
+static le_pm_WakeupSourceRef_t WakeupSourceA;
+static le_pm_WakeupSourceRef_t WakeupSourceB;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the number of times the wake lock was written to a sysfs file.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CountWrites
+(
+    const char* pathPtr
+)
+{
+    char buf[512];
+    char* posPtr = buf;
+    int count = 0;
+    int fd = open(pathPtr, O_RDONLY);
+    ssize_t len;
+
+    LE_ASSERT(fd != -1);
+    len = read(fd, buf, sizeof(buf) - 1);
+    LE_ASSERT(len >= 0);
+    close(fd);
+    buf[len] = '\0';
+
+    while ((posPtr = strstr(posPtr, WAKE_LOCK_NAME)) != NULL)
+    {
+        count++;
+        posPtr += strlen(WAKE_LOCK_NAME);
+    }
+
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the wake lock is released on behalf of a disconnected client, then end the test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckDisconnectRelease
+(
+    le_timer_Ref_t timerRef
+)
+{
+    LE_ASSERT(CountWrites(WakeLockPath) == 2);
+    LE_ASSERT(CountWrites(WakeUnlockPath) == 2);
+
+    LE_INFO("======== UnitTest of le_pm API ends with SUCCESS ========");
+    exit(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the wake lock is released once the hold-off has elapsed, then test the release of the
+ * wakeup sources of a disconnecting client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckRelease
+(
+    le_timer_Ref_t timerRef
+)
+{
+    LE_ASSERT(CountWrites(WakeLockPath) == 1);
+    LE_ASSERT(CountWrites(WakeUnlockPath) == 1);
+
+    LE_INFO("======== Test client disconnection ========");
+    le_pm_StayAwake(WakeupSourceB);
+    LE_ASSERT(CountWrites(WakeLockPath) == 2);
+
+    pmStub_DisconnectClient();
+    LE_ASSERT(CountWrites(WakeUnlockPath) == 1);
+
+    le_timer_SetHandler(timerRef, CheckDisconnectRelease);
+    le_timer_Start(timerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test that the wakeup sources share a single kernel wake lock, and that a wakeup source acquired
+ * again during the hold-off doesn't toggle it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestCoalescing
+(
+    void
+)
+{
+    uint32_t acquireCount;
+    uint64_t holdTime;
+
+    WakeupSourceA = le_pm_NewWakeupSource(LE_PM_REF_COUNT, "testA");
+    WakeupSourceB = le_pm_NewWakeupSource(0, "testB");
+    LE_ASSERT(WakeupSourceA != NULL);
+    LE_ASSERT(WakeupSourceB != NULL);
+
+    le_pm_StayAwake(WakeupSourceA);
+    LE_ASSERT(CountWrites(WakeLockPath) == 1);
+
+    le_pm_StayAwake(WakeupSourceA);
+    le_pm_StayAwake(WakeupSourceB);
+    LE_ASSERT(CountWrites(WakeLockPath) == 1);
+
+    le_pm_Relax(WakeupSourceB);
+    le_pm_Relax(WakeupSourceA);
+    le_pm_Relax(WakeupSourceA);
+    LE_ASSERT(CountWrites(WakeUnlockPath) == 0);
+
+    // Acquired again during the hold-off: the kernel wake lock is still held
+    le_pm_StayAwake(WakeupSourceA);
+    LE_ASSERT(CountWrites(WakeLockPath) == 1);
+    usleep(50000);
+    le_pm_Relax(WakeupSourceA);
+    LE_ASSERT(CountWrites(WakeUnlockPath) == 0);
+
+    LE_INFO("======== Test wakeup source statistics ========");
+    le_pm_GetWakeupSourceStats(WakeupSourceA, &acquireCount, &holdTime);
+    LE_ASSERT(acquireCount == 3);
+    LE_ASSERT(holdTime >= 50);
+
+    le_pm_GetWakeupSourceStats(WakeupSourceB, &acquireCount, &holdTime);
+    LE_ASSERT(acquireCount == 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main of the test.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    const char* sysfsRootPtr = getenv("LE_PM_SYSFS_ROOT");
+    le_timer_Ref_t timerRef;
+
+    LE_ASSERT(sysfsRootPtr != NULL);
+    snprintf(WakeLockPath, sizeof(WakeLockPath), "%s/sys/power/wake_lock", sysfsRootPtr);
+    snprintf(WakeUnlockPath, sizeof(WakeUnlockPath), "%s/sys/power/wake_unlock", sysfsRootPtr);
+
+    // Clear the writes of a previous run
+    LE_ASSERT(truncate(WakeLockPath, 0) == 0);
+    LE_ASSERT(truncate(WakeUnlockPath, 0) == 0);
+
+    LE_INFO("======== Start UnitTest of le_pm API ========");
+
+    pmStub_ConnectClient();
+
+    LE_INFO("======== Test wake lock coalescing ========");
+    TestCoalescing();
+
+    // Wait for the end of the hold-off
+    timerRef = le_timer_Create("PmTestTimer");
+    le_timer_SetMsInterval(timerRef, RELEASE_WAIT_MS);
+    le_timer_SetHandler(timerRef, CheckRelease);
+    le_timer_Start(timerRef);
+}
@@ -0,0 +1,41 @@
+#include "le_pm_interface.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_pm_GetClientSessionRef
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_pm_GetServiceRef
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the connection of the test client to the le_pm service
+ */
+//--------------------------------------------------------------------------------------------------
+void pmStub_ConnectClient
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the disconnection of the test client from the le_pm service
+ */
+//--------------------------------------------------------------------------------------------------
+void pmStub_DisconnectClient
+(
+    void
+);
@@ -0,0 +1,127 @@
+/**
+ * Stubs of the messaging functions used by the power manager service.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Session reference of the test client
+ */
+//--------------------------------------------------------------------------------------------------
+#define CLIENT_SESSION_REF  ((le_msg_SessionRef_t)0x1001)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Session open and close handlers registered by the service
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_SessionEventHandler_t OpenHandler;
+static le_msg_SessionEventHandler_t CloseHandler;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stub the client session reference for the current message
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_pm_GetClientSessionRef
+(
+    void
+)
+{
+    return CLIENT_SESSION_REF;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_pm_GetServiceRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add service open handler stub
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionEventHandlerRef_t MsgAddServiceOpenHandler
+(
+    le_msg_ServiceRef_t serviceRef,
+    le_msg_SessionEventHandler_t handlerFunc,
+    void *contextPtr
+)
+{
+    OpenHandler = handlerFunc;
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add service close handler stub
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionEventHandlerRef_t MsgAddServiceCloseHandler
+(
+    le_msg_ServiceRef_t serviceRef,
+    le_msg_SessionEventHandler_t handlerFunc,
+    void *contextPtr
+)
+{
+    CloseHandler = handlerFunc;
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get client process id stub: the test client is the test process itself
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t MsgGetClientProcessId
+(
+    le_msg_SessionRef_t sessionRef,
+    pid_t* processIdPtr
+)
+{
+    *processIdPtr = getpid();
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the connection of the test client to the le_pm service
+ */
+//--------------------------------------------------------------------------------------------------
+void pmStub_ConnectClient
+(
+    void
+)
+{
+    LE_ASSERT(OpenHandler != NULL);
+    OpenHandler(CLIENT_SESSION_REF, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the disconnection of the test client from the le_pm service
+ */
+//--------------------------------------------------------------------------------------------------
+void pmStub_DisconnectClient
+(
+    void
+)
+{
+    LE_ASSERT(CloseHandler != NULL);
+    CloseHandler(CLIENT_SESSION_REF, NULL);
+}
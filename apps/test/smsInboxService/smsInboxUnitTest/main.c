@@ -0,0 +1,501 @@
+/**
+ * This module implements the unit tests for the SMS Inbox message store.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "msgStore.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message store log used by the test.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_DIR        "/tmp/smsInboxUnitTest"
+#define TEST_LOG        TEST_DIR "/inbox.log"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of messages of the benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_NB_MSG    10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message box sizes: a small one to test the eviction, and one for the benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint32_t MboxSize[] = { 3, BENCH_NB_MSG };
+#define NB_MBOX         NUM_ARRAY_MEMBERS(MboxSize)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Text of the test messages.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_TEXT       "Hello, this is a message of the SMS Inbox unit test"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the message store.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenStore
+(
+    bool reset      ///< [IN] Whether to start from an empty log.
+)
+{
+    if (reset)
+    {
+        unlink(TEST_LOG);
+    }
+    mkdir(TEST_DIR, S_IRWXU);
+
+    LE_ASSERT(msgStore_Init(TEST_LOG, NB_MBOX, MboxSize) == LE_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a text message to the store.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t AddTextMsg
+(
+    uint32_t mboxMask       ///< [IN] Message boxes the message is added to.
+)
+{
+    msgStore_Msg_t msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.format = 0;
+    msg.msgLen = strlen(TEST_TEXT);
+    msg.strPtr[MSGSTORE_IMSI] = "208011234567890";
+    msg.strPtr[MSGSTORE_SENDER_TEL] = "+33612345678";
+    msg.strPtr[MSGSTORE_TIMESTAMP] = "17/01/12,10:25:31+04";
+    msg.dataPtr = (const uint8_t*)TEST_TEXT;
+    msg.dataLen = strlen(TEST_TEXT) + 1;
+
+    return msgStore_AddMsg(0, &msg, mboxMask, mboxMask);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of the log.
+ */
+//--------------------------------------------------------------------------------------------------
+static off_t GetLogSize
+(
+    void
+)
+{
+    struct stat st;
+
+    LE_ASSERT(stat(TEST_LOG, &st) == 0);
+    return st.st_size;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a start time, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedMs
+(
+    le_clk_Time_t start     ///< [IN] Start time.
+)
+{
+    le_clk_Time_t diff = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return (diff.sec * 1000) + (diff.usec / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: add a message, read its fields, change its state and delete it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_msgStore_Message
+(
+    void
+)
+{
+    char string[32];
+    uint8_t data[MSGSTORE_MAX_DATA_BYTES];
+    size_t len;
+    int32_t format;
+    uint32_t msgLen;
+    msgStore_Msg_t msg;
+
+    OpenStore(true);
+
+    uint32_t msgId = AddTextMsg(0x3);
+    LE_ASSERT(msgId != 0);
+    LE_ASSERT(msgStore_IsInMbox(msgId, 0));
+    LE_ASSERT(msgStore_IsInMbox(msgId, 1));
+
+    LE_ASSERT(msgStore_GetInfo(msgId, &format, &msgLen) == LE_OK);
+    LE_ASSERT((format == 0) && (msgLen == strlen(TEST_TEXT)));
+
+    LE_ASSERT(msgStore_GetString(msgId, MSGSTORE_SENDER_TEL, string, sizeof(string)) == LE_OK);
+    LE_ASSERT(strcmp(string, "+33612345678") == 0);
+    LE_ASSERT(msgStore_GetString(msgId, MSGSTORE_TIMESTAMP, string, sizeof(string)) == LE_OK);
+    LE_ASSERT(strcmp(string, "17/01/12,10:25:31+04") == 0);
+    LE_ASSERT(msgStore_GetString(msgId, MSGSTORE_IMSI, string, 15) == LE_OVERFLOW);
+
+    len = sizeof(data);
+    LE_ASSERT(msgStore_GetData(msgId, data, &len) == LE_OK);
+    LE_ASSERT((len == strlen(TEST_TEXT) + 1) && (strcmp((char*)data, TEST_TEXT) == 0));
+    len = strlen(TEST_TEXT);
+    LE_ASSERT(msgStore_GetData(msgId, data, &len) == LE_OVERFLOW);
+
+    // A message without sender and data.
+    memset(&msg, 0, sizeof(msg));
+    msg.format = 2;
+    uint32_t pduId = msgStore_AddMsg(0, &msg, 0x2, 0x2);
+    LE_ASSERT(pduId > msgId);
+    LE_ASSERT(msgStore_GetString(pduId, MSGSTORE_SENDER_TEL, string, sizeof(string)) == LE_FAULT);
+    len = sizeof(data);
+    LE_ASSERT(msgStore_GetData(pduId, data, &len) == LE_FAULT);
+    LE_ASSERT(!msgStore_IsInMbox(pduId, 0));
+
+    // Read status is per message box.
+    LE_ASSERT(msgStore_IsUnread(msgId, 0) && msgStore_IsUnread(msgId, 1));
+    off_t logSize = GetLogSize();
+    msgStore_SetUnread(msgId, 0, false);
+    LE_ASSERT(!msgStore_IsUnread(msgId, 0) && msgStore_IsUnread(msgId, 1));
+    LE_ASSERT(GetLogSize() > logSize);
+
+    // Nothing is written when the state doesn't change.
+    logSize = GetLogSize();
+    msgStore_SetUnread(msgId, 0, false);
+    LE_ASSERT(GetLogSize() == logSize);
+
+    // The message is deleted once it is in no message box.
+    msgStore_Delete(msgId, 0);
+    LE_ASSERT(!msgStore_IsInMbox(msgId, 0) && msgStore_IsInMbox(msgId, 1));
+    LE_ASSERT(msgStore_GetInfo(msgId, &format, &msgLen) == LE_OK);
+    msgStore_Delete(msgId, 1);
+    LE_ASSERT(msgStore_GetInfo(msgId, &format, &msgLen) == LE_NOT_FOUND);
+    len = sizeof(data);
+    LE_ASSERT(msgStore_GetData(msgId, data, &len) == LE_FAULT);
+
+    msgStore_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: the oldest message is removed from a full message box.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_msgStore_Eviction
+(
+    void
+)
+{
+    uint32_t msgId[4];
+    int i;
+
+    OpenStore(true);
+
+    for (i = 0; i < 4; i++)
+    {
+        msgId[i] = AddTextMsg(0x3);
+    }
+
+    LE_ASSERT(!msgStore_IsInMbox(msgId[0], 0) && msgStore_IsInMbox(msgId[0], 1));
+    for (i = 1; i < 4; i++)
+    {
+        LE_ASSERT(msgStore_IsInMbox(msgId[i], 0));
+    }
+
+    msgStore_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Limit the size of the files written by the process, 0 to remove the limit. Writes beyond the
+ * limit fail instead of raising SIGXFSZ.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LimitFileSize
+(
+    off_t size      ///< [IN] Maximum file size.
+)
+{
+    static struct rlimit savedLimit;
+    struct rlimit limit;
+
+    if (size)
+    {
+        LE_ASSERT(getrlimit(RLIMIT_FSIZE, &savedLimit) == 0);
+        signal(SIGXFSZ, SIG_IGN);
+        limit = savedLimit;
+        limit.rlim_cur = size;
+        LE_ASSERT(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+    }
+    else
+    {
+        LE_ASSERT(setrlimit(RLIMIT_FSIZE, &savedLimit) == 0);
+        signal(SIGXFSZ, SIG_DFL);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: a record that can't be written to the log leaves the index unchanged, and the oldest
+ * message of a full message box is only removed once the new message is stored.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_msgStore_WriteFailure
+(
+    void
+)
+{
+    uint32_t msgId[5];
+    off_t recordLen;
+    int i;
+
+    OpenStore(true);
+
+    for (i = 0; i < 3; i++)
+    {
+        msgId[i] = AddTextMsg(0x1);
+    }
+    recordLen = GetLogSize() / 3;
+
+    // Nothing can be written: the full message box is unchanged.
+    LimitFileSize(GetLogSize());
+    LE_ASSERT(AddTextMsg(0x1) == 0);
+    LE_ASSERT(msgStore_IsInMbox(msgId[0], 0));
+    LE_ASSERT(msgStore_SetUnread(msgId[1], 0, false) == LE_FAULT);
+    LE_ASSERT(msgStore_IsUnread(msgId[1], 0));
+    LE_ASSERT(msgStore_Delete(msgId[2], 0) == LE_FAULT);
+    LE_ASSERT(msgStore_IsInMbox(msgId[2], 0));
+    LimitFileSize(0);
+
+    // Only the new message can be written: the message box stays over its size.
+    LimitFileSize(GetLogSize() + recordLen);
+    msgId[3] = AddTextMsg(0x1);
+    LE_ASSERT(msgId[3] != 0);
+    for (i = 0; i < 4; i++)
+    {
+        LE_ASSERT(msgStore_IsInMbox(msgId[i], 0));
+    }
+    LimitFileSize(0);
+
+    // The next message brings the message box back to its size.
+    msgId[4] = AddTextMsg(0x1);
+    LE_ASSERT(!msgStore_IsInMbox(msgId[0], 0) && !msgStore_IsInMbox(msgId[1], 0));
+    for (i = 2; i < 5; i++)
+    {
+        LE_ASSERT(msgStore_IsInMbox(msgId[i], 0) && msgStore_IsUnread(msgId[i], 0));
+    }
+
+    // The log matches the index.
+    msgStore_Close();
+    OpenStore(false);
+    LE_ASSERT(!msgStore_IsInMbox(msgId[0], 0) && !msgStore_IsInMbox(msgId[1], 0));
+    for (i = 2; i < 5; i++)
+    {
+        LE_ASSERT(msgStore_IsInMbox(msgId[i], 0) && msgStore_IsUnread(msgId[i], 0));
+    }
+
+    msgStore_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: browse a message box while messages are deleted and added.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_msgStore_Browse
+(
+    void
+)
+{
+    msgStore_Cursor_t cursor;
+    uint32_t msgId[5];
+    int i;
+
+    OpenStore(true);
+
+    LE_ASSERT(msgStore_GetFirst(1, &cursor) == 0);
+    LE_ASSERT(msgStore_GetNext(1, &cursor) == 0);
+
+    for (i = 0; i < 5; i++)
+    {
+        msgId[i] = AddTextMsg(0x2);
+    }
+
+    LE_ASSERT(msgStore_GetFirst(1, &cursor) == msgId[0]);
+
+    // Deleting the current message doesn't break the browsing.
+    msgStore_Delete(msgId[0], 1);
+    LE_ASSERT(msgStore_GetNext(1, &cursor) == msgId[1]);
+
+    // Deleted messages are skipped, new ones are not returned.
+    msgStore_Delete(msgId[2], 1);
+    AddTextMsg(0x2);
+    LE_ASSERT(msgStore_GetNext(1, &cursor) == msgId[3]);
+    LE_ASSERT(msgStore_GetNext(1, &cursor) == msgId[4]);
+    LE_ASSERT(msgStore_GetNext(1, &cursor) == 0);
+
+    msgStore_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: the index is rebuilt from the log, and a torn record at its end is discarded.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_msgStore_Replay
+(
+    void
+)
+{
+    msgStore_Cursor_t cursor;
+    uint32_t msgId[3];
+    int i;
+
+    OpenStore(true);
+
+    for (i = 0; i < 3; i++)
+    {
+        msgId[i] = AddTextMsg(0x3);
+    }
+    msgStore_SetUnread(msgId[1], 1, false);
+    msgStore_Delete(msgId[2], 0);
+    msgStore_Delete(msgId[2], 1);
+    msgStore_Close();
+
+    // Simulate a power loss during the write of a record.
+    off_t logSize = GetLogSize();
+    int fd = open(TEST_LOG, O_WRONLY | O_APPEND);
+    LE_ASSERT(fd != -1);
+    LE_ASSERT(write(fd, "\x52\x53\x4d\x53\x00\x00\x00", 7) == 7);
+    close(fd);
+
+    OpenStore(false);
+    LE_ASSERT(GetLogSize() == logSize);
+
+    LE_ASSERT(msgStore_GetFirst(1, &cursor) == msgId[0]);
+    LE_ASSERT(msgStore_GetNext(1, &cursor) == msgId[1]);
+    LE_ASSERT(msgStore_GetNext(1, &cursor) == 0);
+    LE_ASSERT(msgStore_IsUnread(msgId[0], 1) && !msgStore_IsUnread(msgId[1], 1));
+    LE_ASSERT(msgStore_IsUnread(msgId[1], 0));
+
+    // Message identifiers are not reused.
+    LE_ASSERT(AddTextMsg(0x3) > msgId[2]);
+
+    msgStore_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: store, browse, read, reload and delete a large number of messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_msgStore_Benchmark
+(
+    void
+)
+{
+    msgStore_Cursor_t cursor;
+    le_clk_Time_t start;
+    uint32_t msgId;
+    uint32_t lastMsgId = 0;
+    char string[32];
+    int count;
+    int i;
+
+    OpenStore(true);
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < BENCH_NB_MSG; i++)
+    {
+        lastMsgId = AddTextMsg(0x2);
+        LE_ASSERT(lastMsgId != 0);
+    }
+    LE_INFO("Add %d messages: %"PRIu64" ms, log %d bytes",
+            BENCH_NB_MSG, GetElapsedMs(start), (int)GetLogSize());
+
+    start = le_clk_GetRelativeTime();
+    count = 0;
+    for (msgId = msgStore_GetFirst(1, &cursor); msgId; msgId = msgStore_GetNext(1, &cursor))
+    {
+        LE_ASSERT(msgStore_GetString(msgId, MSGSTORE_SENDER_TEL, string, sizeof(string)) == LE_OK);
+        count++;
+    }
+    LE_ASSERT(count == BENCH_NB_MSG);
+    LE_INFO("Browse %d messages: %"PRIu64" ms", count, GetElapsedMs(start));
+
+    start = le_clk_GetRelativeTime();
+    for (msgId = msgStore_GetFirst(1, &cursor); msgId; msgId = msgStore_GetNext(1, &cursor))
+    {
+        msgStore_SetUnread(msgId, 1, false);
+    }
+    LE_INFO("Mark %d messages read: %"PRIu64" ms", BENCH_NB_MSG, GetElapsedMs(start));
+
+    msgStore_Close();
+    start = le_clk_GetRelativeTime();
+    OpenStore(false);
+    LE_INFO("Replay %d messages: %"PRIu64" ms", BENCH_NB_MSG, GetElapsedMs(start));
+    LE_ASSERT(!msgStore_IsUnread(lastMsgId, 1) && msgStore_IsInMbox(lastMsgId, 1));
+
+    start = le_clk_GetRelativeTime();
+    for (msgId = msgStore_GetFirst(1, &cursor); msgId; msgId = msgStore_GetNext(1, &cursor))
+    {
+        msgStore_Delete(msgId, 1);
+    }
+    LE_ASSERT(msgStore_GetFirst(1, &cursor) == 0);
+    LE_INFO("Delete %d messages: %"PRIu64" ms, log %d bytes",
+            BENCH_NB_MSG, GetElapsedMs(start), (int)GetLogSize());
+
+    // Compaction has reclaimed the deleted messages.
+    LE_ASSERT(GetLogSize() < (BENCH_NB_MSG * 100));
+    msgStore_Close();
+
+    OpenStore(false);
+    LE_ASSERT(AddTextMsg(0x2) > lastMsgId);
+    msgStore_Close();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * main of the test
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    // To reactivate for all DEBUG logs
+    //le_log_SetFilterLevel(LE_LOG_DEBUG);
+
+    LE_INFO("======== START UnitTest of SMS INBOX STORE ========");
+
+    LE_INFO("======== Test_msgStore_Message ========");
+    Test_msgStore_Message();
+
+    LE_INFO("======== Test_msgStore_Eviction ========");
+    Test_msgStore_Eviction();
+
+    LE_INFO("======== Test_msgStore_WriteFailure ========");
+    Test_msgStore_WriteFailure();
+
+    LE_INFO("======== Test_msgStore_Browse ========");
+    Test_msgStore_Browse();
+
+    LE_INFO("======== Test_msgStore_Replay ========");
+    Test_msgStore_Replay();
+
+    LE_INFO("======== Test_msgStore_Benchmark ========");
+    Test_msgStore_Benchmark();
+
+    unlink(TEST_LOG);
+    rmdir(TEST_DIR);
+
+    LE_INFO("======== UnitTest of SMS INBOX STORE FINISHED ========");
+    exit(0);
+}
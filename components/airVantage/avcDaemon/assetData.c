@@ -20,6 +20,7 @@
 
 #include "limit.h"
 #include "assetData.h"
+#include "pushQueue.h"
 #include "le_print.h"
 
 // For htonl
@@ -60,10 +61,118 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of bytes for CBOR encoded time series data
+ * Maximum number of bytes of the resource TLVs of an object instance. This leaves enough space in
+ * 256 bytes for the maximum object instance header size of 6 bytes.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_CBOR_BUFFER_NUMBYTES 1024
+#define INSTANCE_TLV_MAX_NUMBYTES (256-6)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes of a chunk of compressed time series data
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_CHUNK_NUMBYTES 1024
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of chunks of compressed data in a time series
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_MAX_CHUNKS 32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of compressed data in a time series
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_MAX_NUMBYTES (TIME_SERIES_CHUNK_NUMBYTES * TIME_SERIES_MAX_CHUNKS)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deflate window size (log2) and memory level of a time series. They bound the zlib state kept
+ * per time series to about 16 KB, instead of more than 256 KB with the zlib defaults.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_WINDOW_BITS 10
+#define TIME_SERIES_MEM_LEVEL 4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes for the CBOR encoded time series header (header, factor & start of the
+ * sample array)
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_HEADER_NUMBYTES 128
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes for a CBOR encoded sample (time stamp & value)
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_SAMPLE_NUMBYTES (STRING_VALUE_NUMBYTES + CBOR_RESERVED_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CBOR "break" byte, closing the indefinite length sample array
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_BREAK_BYTE 0xFF
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File of the push queue, keeping the notifications while there is no session
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_QUEUE_DIR "/data/avc"
+#define PUSH_QUEUE_PATH PUSH_QUEUE_DIR "/pushQueue"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of notifications in the push queue
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_QUEUE_MAX_NUMBYTES (256 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of queued notifications sent at each expiry of the push queue timer
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_QUEUE_BATCH_SIZE 8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time (in seconds) a notification is kept in the push queue: a time series can't be recorded
+ * again, while a value change notification becomes stale sooner.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_TIME_TO_LIVE (7 * 24 * 3600)
+#define VALUE_CHANGE_TIME_TO_LIVE (24 * 3600)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of asset instances and fields, used to size the lookup maps
+ */
+//--------------------------------------------------------------------------------------------------
+#define INSTANCE_MAP_CAPACITY 127
+#define FIELD_MAP_CAPACITY 1023
+
+#if TIME_SERIES_MAX_NUMBYTES > PUSHQUEUE_MAX_PAYLOAD_NUMBYTES
+#error "A time series must fit in the push queue."
+#endif
 
 
 //--------------------------------------------------------------------------------------------------
@@ -138,6 +247,19 @@ typedef struct assetData_AssetData
 AssetData_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of an asset instance in InstanceMap
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const AssetData_t* assetDataPtr;    ///< Asset containing the instance
+    int instanceId;                     ///< Id of the instance within the asset
+}
+InstanceKey_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Data contained in a single asset instance
@@ -149,19 +271,65 @@ typedef struct le_avdata_AssetInstance
     AssetData_t* assetDataPtr;   ///< Back reference to asset data containing this instance
     le_dls_List_t fieldList;     ///< List of fields for this instance
     le_dls_Link_t link;          ///< For adding to the asset instance list
+    InstanceKey_t key;           ///< Key in InstanceMap
+    bool isTLVCacheValid;        ///< Does tlvCache hold the current field values?
+    bool isTLVTooLarge;          ///< If tlvCache is valid: are the TLVs too large to be cached?
+    size_t tlvCacheNumBytes;     ///< Number of bytes in tlvCache
+    uint8_t tlvCache[INSTANCE_TLV_MAX_NUMBYTES];
+                                 ///< Readable resource TLVs of this instance, as last encoded
 }
 InstanceData_t;
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Data contained in time series
+ * Key of a field in FieldMap
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    uint8_t* bufferPtr;             ///< Buffer for accumulating history data.
-    size_t bufferSize;              ///< Buffer size of history data.
+    const InstanceData_t* instancePtr;  ///< Instance containing the field
+    int fieldId;                        ///< Id of the field within the instance
+}
+FieldKey_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of a field in FieldMapByName
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const InstanceData_t* instancePtr;  ///< Instance containing the field
+    const char* namePtr;                ///< Name of the field
+}
+FieldNameKey_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Chunk of compressed time series data
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;                         ///< For adding to the chunk list
+    uint8_t data[TIME_SERIES_CHUNK_NUMBYTES];   ///< Compressed data
+}
+TimeSeriesChunk_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time series data. The samples are CBOR encoded and deflated as they are recorded, the compressed
+ * stream being accumulated in a list of chunks.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_List_t chunkList;        ///< Chunks of compressed history data.
+    size_t numChunks;               ///< Number of chunks in chunkList.
 
 #ifdef LEGATO_FEATURE_TIMESERIES
     double timeStampFactor;         ///< Factor of time stamp.
@@ -176,9 +344,9 @@ typedef struct
 
     uint32_t numElements;           ///< Number of elements in cbor encoded stream.
 
-    CborEncoder streamRef;          ///< CBOR encoded stream reference.
-    CborEncoder mapRef;             ///< CBOR encoded map reference.
-    CborEncoder sampleRef;          ///< CBOR encoded sample data reference.
+    z_stream zStream;               ///< Deflate state of the CBOR encoded stream.
+    uLong flushedIn;                ///< Bytes of CBOR encoded stream deflated at the last flush.
+    uLong flushedOut;               ///< Bytes of compressed data at the last flush.
 #endif
 }
 TimeSeriesData_t;
@@ -211,6 +379,8 @@ typedef struct
     TimeSeriesData_t* timeSeriesPtr;
 
     le_dls_Link_t link;          ///< For adding to the field list
+    FieldKey_t key;              ///< Key in FieldMap
+    FieldNameKey_t nameKey;      ///< Key in FieldMapByName
 }
 FieldData_t;
 
@@ -323,6 +493,30 @@ static le_hashmap_Ref_t AssetMap = NULL;
 static le_hashmap_Ref_t AssetMapByName = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps (asset, instanceId) to an asset instance.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t InstanceMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps (instance, fieldId) to a field.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t FieldMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps (instance, field name) to a field.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t FieldMapByName = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Used to delay reporting REG_UPDATE, so that we don't generate too much message traffic.
@@ -331,6 +525,14 @@ static le_hashmap_Ref_t AssetMapByName = NULL;
 static le_timer_Ref_t RegUpdateTimerRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Used to send the queued notifications in batches once a session is available.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t PushQueueTimerRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Time series data memory pool.  Initialized in assetData_Init().
@@ -341,10 +543,19 @@ static le_mem_PoolRef_t TimeSeriesDataPoolRef = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * CBOR buffer memory pool.  Initialized in assetData_Init().
+ * Time series chunk memory pool.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t TimeSeriesChunkPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool of the buffers used to send a time series made of several chunks.  Initialized in
+ * assetData_Init().
  */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t CborBufferPoolRef = NULL;
+static le_mem_PoolRef_t TimeSeriesPushBufferPoolRef = NULL;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -1105,6 +1316,216 @@ static le_result_t CreateAssetDataFromModelByName
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mix a pointer and an integer into a hash value
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashPointerAndInt
+(
+    const void* ptr,
+    int value
+)
+{
+    size_t hash = (size_t)(uintptr_t)ptr;
+
+    // The low bits of a pool object address carry little information, and the hashmap only uses
+    // the low bits of the hash to select a bucket, so fold the high bits down.
+    hash ^= hash >> 16;
+    hash ^= (size_t)(uint32_t)value * 2654435761u;
+
+    return hash ^ (hash >> 15);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for InstanceMap keys
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashInstanceKey
+(
+    const void* keyPtr
+)
+{
+    const InstanceKey_t* instanceKeyPtr = keyPtr;
+
+    return HashPointerAndInt(instanceKeyPtr->assetDataPtr, instanceKeyPtr->instanceId);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for InstanceMap keys
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsInstanceKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const InstanceKey_t* firstPtr = firstKeyPtr;
+    const InstanceKey_t* secondPtr = secondKeyPtr;
+
+    return ( (firstPtr->assetDataPtr == secondPtr->assetDataPtr) &&
+             (firstPtr->instanceId == secondPtr->instanceId) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for FieldMap keys
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashFieldKey
+(
+    const void* keyPtr
+)
+{
+    const FieldKey_t* fieldKeyPtr = keyPtr;
+
+    return HashPointerAndInt(fieldKeyPtr->instancePtr, fieldKeyPtr->fieldId);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for FieldMap keys
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsFieldKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const FieldKey_t* firstPtr = firstKeyPtr;
+    const FieldKey_t* secondPtr = secondKeyPtr;
+
+    return ( (firstPtr->instancePtr == secondPtr->instancePtr) &&
+             (firstPtr->fieldId == secondPtr->fieldId) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for FieldMapByName keys
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashFieldNameKey
+(
+    const void* keyPtr
+)
+{
+    const FieldNameKey_t* fieldNameKeyPtr = keyPtr;
+
+    return HashPointerAndInt(fieldNameKeyPtr->instancePtr,
+                             (int)le_hashmap_HashString(fieldNameKeyPtr->namePtr));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for FieldMapByName keys
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsFieldNameKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const FieldNameKey_t* firstPtr = firstKeyPtr;
+    const FieldNameKey_t* secondPtr = secondKeyPtr;
+
+    return ( (firstPtr->instancePtr == secondPtr->instancePtr) &&
+             (strcmp(firstPtr->namePtr, secondPtr->namePtr) == 0) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an instance and its fields to the lookup maps. The instance id and the back reference to the
+ * asset must already be set.
+ *
+ * If several fields have the same id or name, the first one in the field list is the one found,
+ * as it was when the field list was searched.
+ */
+//--------------------------------------------------------------------------------------------------
+static void IndexInstance
+(
+    InstanceData_t* instanceDataPtr     ///< [IN]
+)
+{
+    FieldData_t* fieldDataPtr;
+    le_dls_Link_t* linkPtr;
+
+    instanceDataPtr->key.assetDataPtr = instanceDataPtr->assetDataPtr;
+    instanceDataPtr->key.instanceId = instanceDataPtr->instanceId;
+    le_hashmap_Put(InstanceMap, &instanceDataPtr->key, instanceDataPtr);
+
+    linkPtr = le_dls_Peek(&instanceDataPtr->fieldList);
+
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        fieldDataPtr->key.instancePtr = instanceDataPtr;
+        fieldDataPtr->key.fieldId = fieldDataPtr->fieldId;
+        if ( !le_hashmap_ContainsKey(FieldMap, &fieldDataPtr->key) )
+        {
+            le_hashmap_Put(FieldMap, &fieldDataPtr->key, fieldDataPtr);
+        }
+
+        fieldDataPtr->nameKey.instancePtr = instanceDataPtr;
+        fieldDataPtr->nameKey.namePtr = fieldDataPtr->name;
+        if ( !le_hashmap_ContainsKey(FieldMapByName, &fieldDataPtr->nameKey) )
+        {
+            le_hashmap_Put(FieldMapByName, &fieldDataPtr->nameKey, fieldDataPtr);
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceDataPtr->fieldList, linkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove an instance and its fields from the lookup maps.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnindexInstance
+(
+    InstanceData_t* instanceDataPtr     ///< [IN]
+)
+{
+    FieldData_t* fieldDataPtr;
+    le_dls_Link_t* linkPtr;
+
+    linkPtr = le_dls_Peek(&instanceDataPtr->fieldList);
+
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        // Only remove the entries that refer to this field, in case of duplicate ids or names.
+        if ( le_hashmap_Get(FieldMap, &fieldDataPtr->key) == fieldDataPtr )
+        {
+            le_hashmap_Remove(FieldMap, &fieldDataPtr->key);
+        }
+        if ( le_hashmap_Get(FieldMapByName, &fieldDataPtr->nameKey) == fieldDataPtr )
+        {
+            le_hashmap_Remove(FieldMapByName, &fieldDataPtr->nameKey);
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceDataPtr->fieldList, linkPtr);
+    }
+
+    le_hashmap_Remove(InstanceMap, &instanceDataPtr->key);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the specified instance from the given asset data block
@@ -1121,28 +1542,16 @@ static le_result_t GetInstanceFromAssetData
     InstanceData_t** instanceDataPtrPtr   ///< [OUT]
 )
 {
-    InstanceData_t* assetInstancePtr;
-    le_dls_Link_t* linkPtr;
-
-    // Get the start of the instance list
-    linkPtr = le_dls_Peek(&assetDataPtr->instanceList);
+    InstanceKey_t key = { .assetDataPtr = assetDataPtr, .instanceId = instanceId };
+    InstanceData_t* assetInstancePtr = le_hashmap_Get(InstanceMap, &key);
 
-    // Loop through the asset instances
-    while ( linkPtr != NULL )
+    if ( assetInstancePtr == NULL )
     {
-        assetInstancePtr = CONTAINER_OF(linkPtr, InstanceData_t, link);
-        //LE_PRINT_VALUE("%i", assetInstancePtr->instanceId);
-
-        if ( assetInstancePtr->instanceId == instanceId )
-        {
-            *instanceDataPtrPtr = assetInstancePtr;
-            return LE_OK;
-        }
-
-        linkPtr = le_dls_PeekNext(&assetDataPtr->instanceList, linkPtr);
+        return LE_NOT_FOUND;
     }
 
-    return LE_NOT_FOUND;
+    *instanceDataPtrPtr = assetInstancePtr;
+    return LE_OK;
 }
 
 
@@ -1162,28 +1571,16 @@ static le_result_t GetFieldFromInstance
     FieldData_t** fieldDataPtrPtr   ///< [OUT]
 )
 {
-    FieldData_t* fieldDataPtr;
-    le_dls_Link_t* fieldLinkPtr;
+    FieldKey_t key = { .instancePtr = instanceDataPtr, .fieldId = fieldId };
+    FieldData_t* fieldDataPtr = le_hashmap_Get(FieldMap, &key);
 
-    // Get the start of the field list
-    fieldLinkPtr = le_dls_Peek(&instanceDataPtr->fieldList);
-
-    // Loop through the fields
-    while ( fieldLinkPtr != NULL )
+    if ( fieldDataPtr == NULL )
     {
-        fieldDataPtr = CONTAINER_OF(fieldLinkPtr, FieldData_t, link);
-        //LE_PRINT_VALUE("%i", fieldDataPtr->fieldId);
-
-        if ( fieldDataPtr->fieldId == fieldId )
-        {
-            *fieldDataPtrPtr = fieldDataPtr;
-            return LE_OK;
-        }
-
-        fieldLinkPtr = le_dls_PeekNext(&instanceDataPtr->fieldList, fieldLinkPtr);
+        return LE_NOT_FOUND;
     }
 
-    return LE_NOT_FOUND;
+    *fieldDataPtrPtr = fieldDataPtr;
+    return LE_OK;
 }
 
 
@@ -1216,74 +1613,317 @@ static le_result_t GetInstance
         return result;
     }
 
-    //LE_PRINT_VALUE("%i", assetDataPtr->assetId);
-    //LE_PRINT_VALUE("%s", assetDataPtr->assetName);
+    //LE_PRINT_VALUE("%i", assetDataPtr->assetId);
+    //LE_PRINT_VALUE("%s", assetDataPtr->assetName);
+
+    result = GetInstanceFromAssetData(assetDataPtr, instanceId, &instanceDataPtr);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    // Found the instance, so return it.
+    *instanceDataPtrPtr = instanceDataPtr;
+    return LE_OK;
+}
+
+
+#if 0
+// todo: Is this needed?
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the specified field from the AssetMap
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if field not found
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetField
+(
+    const char* appNamePtr,
+    int assetId,
+    int instanceId,
+    int fieldId,
+    FieldData_t** fieldDataPtrPtr   ///< [OUT]
+)
+{
+    le_result_t result;
+    AssetData_t* assetDataPtr;
+    InstanceData_t* instanceDataPtr;
+    FieldData_t* fieldDataPtr;
+
+    // Get an existing AssetData block from AssetMap
+    result = GetAssetData(appNamePtr, assetId, &assetDataPtr);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    //LE_PRINT_VALUE("%i", assetDataPtr->assetId);
+    //LE_PRINT_VALUE("%s", assetDataPtr->assetName);
+
+    result = GetInstanceFromAssetData(assetDataPtr, instanceId, &instanceDataPtr);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    result = GetFieldFromInstance(instanceDataPtr, fieldId, &fieldDataPtr);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    // Found the field, so return it.
+    *fieldDataPtrPtr = fieldDataPtr;
+    return LE_OK;
+}
+#endif
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a notification to the server. If there is no session, the notification is queued to be sent
+ * once a session is available. It is also queued when older notifications are still queued, so that
+ * it doesn't overtake them. The queue keeps the order of the notifications of a priority, but sends
+ * the time series before the value changes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NotifyChange
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance
+    FieldData_t* fieldDataPtr,                  ///< [IN] Field being notified
+    uint16_t contentType,                       ///< [IN] Encoding of the payload
+    uint8_t* payloadPtr,                        ///< [IN] Payload
+    size_t payloadNumBytes,                     ///< [IN] Payload size in bytes
+    pushQueue_Priority_t priority,              ///< [IN] Priority if queued
+    uint32_t timeToLive                         ///< [IN] Time to live (s) if queued
+)
+{
+    pa_avc_LWM2MOperationDataRef_t opRef;
+    pushQueue_Notification_t notification;
+    le_result_t result;
+
+    if ((CurrentAvSessionStatus == ASSET_DATA_SESSION_AVAILABLE) && (pushQueue_GetCount() == 0))
+    {
+        opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
+                                    instanceRef->assetDataPtr->assetId,
+                                    -1,
+                                    -1,
+                                    PA_AVC_OPTYPE_NOTIFY,
+                                    contentType,
+                                    fieldDataPtr->token,
+                                    fieldDataPtr->tokenLength);
+
+        pa_avc_NotifyChange(opRef, payloadPtr, payloadNumBytes);
+        return;
+    }
+
+    notification.appNamePtr = instanceRef->assetDataPtr->appName;
+    notification.assetId = instanceRef->assetDataPtr->assetId;
+    notification.contentType = contentType;
+    notification.tokenPtr = fieldDataPtr->token;
+    notification.tokenLength = fieldDataPtr->tokenLength;
+    notification.payloadPtr = payloadPtr;
+    notification.payloadNumBytes = payloadNumBytes;
+    notification.priority = priority;
+    notification.timeToLive = timeToLive;
+
+    result = pushQueue_Add(&notification);
+    if (result != LE_OK)
+    {
+        LE_WARN("Notification on field %d not queued (%s).",
+                fieldDataPtr->fieldId, LE_RESULT_TXT(result));
+        return;
+    }
+
+    if ((CurrentAvSessionStatus == ASSET_DATA_SESSION_AVAILABLE) &&
+        !le_timer_IsRunning(PushQueueTimerRef))
+    {
+        le_timer_Start(PushQueueTimerRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Free the resources of a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseTimeSeries
+(
+    TimeSeriesData_t* timeSeriesPtr             ///< [IN] Time series to release
+)
+{
+    le_dls_Link_t* linkPtr;
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+    deflateEnd(&timeSeriesPtr->zStream);
+#endif
+
+    while ((linkPtr = le_dls_Pop(&timeSeriesPtr->chunkList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, TimeSeriesChunk_t, link));
+    }
+
+    le_mem_Release(timeSeriesPtr);
+}
+
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a chunk at the end of a time series and use it as output buffer of the deflate stream.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the time series already has TIME_SERIES_MAX_CHUNKS chunks
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddTimeSeriesChunk
+(
+    TimeSeriesData_t* timeSeriesPtr             ///< [IN] Time series
+)
+{
+    TimeSeriesChunk_t* chunkPtr;
+
+    if (timeSeriesPtr->numChunks >= TIME_SERIES_MAX_CHUNKS)
+    {
+        LE_ERROR("Time series has too many chunks.");
+        return LE_NO_MEMORY;
+    }
+
+    chunkPtr = le_mem_ForceAlloc(TimeSeriesChunkPoolRef);
+    chunkPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&timeSeriesPtr->chunkList, &chunkPtr->link);
+    timeSeriesPtr->numChunks++;
+
+    timeSeriesPtr->zStream.next_out = (Bytef *)chunkPtr->data;
+    timeSeriesPtr->zStream.avail_out = (uInt)sizeof(chunkPtr->data);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deflate a part of the CBOR encoded stream of a time series, adding chunks as the compressed data
+ * grows.
+ *
+ * With Z_NO_FLUSH, deflate may keep some of the data in its internal buffers. Z_SYNC_FLUSH writes
+ * all of it to the chunks, and Z_FINISH ends the compressed stream.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the compressed data doesn't fit in TIME_SERIES_MAX_CHUNKS chunks
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DeflateTimeSeries
+(
+    TimeSeriesData_t* timeSeriesPtr,            ///< [IN] Time series
+    const uint8_t* dataPtr,                     ///< [IN] CBOR encoded data
+    size_t dataNumBytes,                        ///< [IN] Number of bytes of CBOR encoded data
+    int flush                                   ///< [IN] Z_NO_FLUSH, Z_SYNC_FLUSH or Z_FINISH
+)
+{
+    z_stream* zStreamPtr = &timeSeriesPtr->zStream;
+    le_result_t result;
+    int zResult;
+
+    zStreamPtr->next_in = (Bytef *)dataPtr;
+    zStreamPtr->avail_in = (uInt)dataNumBytes;
+
+    while (true)
+    {
+        if (zStreamPtr->avail_out == 0)
+        {
+            result = AddTimeSeriesChunk(timeSeriesPtr);
+            if (result != LE_OK)
+            {
+                return result;
+            }
+        }
+
+        zResult = deflate(zStreamPtr, flush);
+        if (zResult == Z_STREAM_ERROR)
+        {
+            LE_ERROR("Time series compression error.");
+            return LE_FAULT;
+        }
+
+        if (flush == Z_FINISH)
+        {
+            if (zResult == Z_STREAM_END)
+            {
+                break;
+            }
+        }
+        else if ((zStreamPtr->avail_in == 0) &&
+                 ((flush == Z_NO_FLUSH) || (zStreamPtr->avail_out != 0)))
+        {
+            // A flush is only complete when deflate didn't fill the output buffer.
+            break;
+        }
+    }
 
-    result = GetInstanceFromAssetData(assetDataPtr, instanceId, &instanceDataPtr);
-    if ( result != LE_OK )
+    if (flush != Z_NO_FLUSH)
     {
-        return result;
+        timeSeriesPtr->flushedIn = zStreamPtr->total_in;
+        timeSeriesPtr->flushedOut = zStreamPtr->total_out;
     }
 
-    // Found the instance, so return it.
-    *instanceDataPtrPtr = instanceDataPtr;
     return LE_OK;
 }
 
 
-#if 0
-// todo: Is this needed?
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the specified field from the AssetMap
+ * Check if some more CBOR encoded data can be added to a time series, so that the compressed
+ * stream ended after it still fits in TIME_SERIES_MAX_NUMBYTES (less one byte, so that the last
+ * chunk is never filled up by a flush).
+ *
+ * The data not flushed yet is counted with its worst case compressed size. When that estimate
+ * doesn't fit, the deflate stream is flushed to get the actual size and the check is done again.
  *
  * @return:
- *      - LE_OK on success
- *      - LE_NOT_FOUND if field not found
+ *      - true if the data can be added
+ *      - false otherwise
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetField
+static bool IsTimeSeriesRoomAvailable
 (
-    const char* appNamePtr,
-    int assetId,
-    int instanceId,
-    int fieldId,
-    FieldData_t** fieldDataPtrPtr   ///< [OUT]
+    TimeSeriesData_t* timeSeriesPtr,            ///< [IN] Time series
+    size_t dataNumBytes                         ///< [IN] Number of bytes of CBOR encoded data
 )
 {
-    le_result_t result;
-    AssetData_t* assetDataPtr;
-    InstanceData_t* instanceDataPtr;
-    FieldData_t* fieldDataPtr;
+    z_stream* zStreamPtr = &timeSeriesPtr->zStream;
+    uLong pendingNumBytes = zStreamPtr->total_in - timeSeriesPtr->flushedIn;
 
-    // Get an existing AssetData block from AssetMap
-    result = GetAssetData(appNamePtr, assetId, &assetDataPtr);
-    if ( result != LE_OK )
+    if ((timeSeriesPtr->flushedOut + deflateBound(zStreamPtr, pendingNumBytes + dataNumBytes))
+        < TIME_SERIES_MAX_NUMBYTES)
     {
-        return result;
+        return true;
     }
 
-    //LE_PRINT_VALUE("%i", assetDataPtr->assetId);
-    //LE_PRINT_VALUE("%s", assetDataPtr->assetName);
-
-    result = GetInstanceFromAssetData(assetDataPtr, instanceId, &instanceDataPtr);
-    if ( result != LE_OK )
+    if (pendingNumBytes == 0)
     {
-        return result;
+        return false;
     }
 
-    result = GetFieldFromInstance(instanceDataPtr, fieldId, &fieldDataPtr);
-    if ( result != LE_OK )
+    if (DeflateTimeSeries(timeSeriesPtr, NULL, 0, Z_SYNC_FLUSH) != LE_OK)
     {
-        return result;
+        return false;
     }
 
-    // Found the field, so return it.
-    *fieldDataPtrPtr = fieldDataPtr;
-    return LE_OK;
+    return ((timeSeriesPtr->flushedOut + deflateBound(zStreamPtr, dataNumBytes))
+            < TIME_SERIES_MAX_NUMBYTES);
 }
-#endif
 
+#endif
 
 
 //--------------------------------------------------------------------------------------------------
@@ -1309,11 +1949,16 @@ static le_result_t StartTimeSeries
 
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint8_t* timeSeriesBufferPtr;
+    TimeSeriesData_t* timeSeriesPtr;
+    uint8_t headerBuf[CBOR_HEADER_NUMBYTES];
+    size_t headerSize;
     char headerId[64];
     CborError err;
+    CborEncoder streamRef;
+    CborEncoder mapRef;
     CborEncoder headerArray;
     CborEncoder factorArray;
+    CborEncoder sampleRef;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -1335,34 +1980,19 @@ static le_result_t StartTimeSeries
                  instanceRef->instanceId,
                  fieldId);
 
-    fieldDataPtr->timeSeriesPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
-
-    memset(fieldDataPtr->timeSeriesPtr, 0, sizeof(TimeSeriesData_t));
-
-    timeSeriesBufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
-    fieldDataPtr->timeSeriesPtr->bufferPtr = timeSeriesBufferPtr;
-
-    fieldDataPtr->timeSeriesPtr->bufferSize = MAX_CBOR_BUFFER_NUMBYTES;
+    // Initialize CBOR stream. Only its beginning is encoded here, the samples are encoded one by
+    // one as they are recorded and the stream is closed when the time series is pushed.
+    cbor_encoder_init(&streamRef, headerBuf, sizeof(headerBuf), 0);
 
-    // Initialize CBOR stream.
-    cbor_encoder_init(&fieldDataPtr->timeSeriesPtr->streamRef,
-                      timeSeriesBufferPtr,
-                      MAX_CBOR_BUFFER_NUMBYTES,
-                      0);
-
-    err = cbor_encoder_create_map(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                  &fieldDataPtr->timeSeriesPtr->mapRef,
-                                  NUM_TIME_SERIES_MAPS);
+    err = cbor_encoder_create_map(&streamRef, &mapRef, NUM_TIME_SERIES_MAPS);
     RETURN_IF_CBOR_ERROR(err);
 
     // Create a map and add the header in to the map.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "h");
+    err = cbor_encode_text_stringz(&mapRef, "h");
     RETURN_IF_CBOR_ERROR(err);
 
     // Create an array for the header.
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &headerArray,
-                                    1);
+    err = cbor_encoder_create_array(&mapRef, &headerArray, 1);
     RETURN_IF_CBOR_ERROR(err);
 
     err = cbor_encode_text_string(&headerArray, headerId, strlen(headerId));
@@ -1370,18 +2000,15 @@ static le_result_t StartTimeSeries
 
     // Close the heade map i.e done with entering in to header array.
     // e.g. "h" : [/1000/0]  --> map for header.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &headerArray);
+    cbor_encoder_close_container(&mapRef, &headerArray);
 
     // Create a map for factor.
     // e.g. "f" : [1]  --> map for factor.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "f");
+    err = cbor_encode_text_stringz(&mapRef, "f");
     RETURN_IF_CBOR_ERROR(err);
 
     // Create an array of factors (time stamp factor, data factor)
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &factorArray,
-                                    2);
+    err = cbor_encoder_create_array(&mapRef, &factorArray, 2);
     RETURN_IF_CBOR_ERROR(err);
 
     // Add factor for time stamp.
@@ -1393,20 +2020,50 @@ static le_result_t StartTimeSeries
     RETURN_IF_CBOR_ERROR(err);
 
     // Close the map i.e done with entering in to factor array.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &factorArray);
+    cbor_encoder_close_container(&mapRef, &factorArray);
 
     // Create an array for samples. The sample array will have time stamp and data pair.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "s");
+    err = cbor_encode_text_stringz(&mapRef, "s");
     RETURN_IF_CBOR_ERROR(err);
 
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &fieldDataPtr->timeSeriesPtr->sampleRef,
-                                    CborIndefiniteLength);
+    err = cbor_encoder_create_array(&mapRef, &sampleRef, CborIndefiniteLength);
     RETURN_IF_CBOR_ERROR(err);
 
-    fieldDataPtr->timeSeriesPtr->factor = factor;
-    fieldDataPtr->timeSeriesPtr->timeStampFactor = timeStampFactor;
+    headerSize = cbor_encoder_get_buffer_size(&sampleRef, headerBuf);
+
+    timeSeriesPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
+
+    memset(timeSeriesPtr, 0, sizeof(TimeSeriesData_t));
+    timeSeriesPtr->chunkList = LE_DLS_LIST_INIT;
+
+    // Initialize the compressed stream. The samples are compressed as they are recorded, so that
+    // only the compressed data is kept.
+    timeSeriesPtr->zStream.zalloc = Z_NULL;
+    timeSeriesPtr->zStream.zfree = Z_NULL;
+    timeSeriesPtr->zStream.opaque = Z_NULL;
+
+    if (deflateInit2(&timeSeriesPtr->zStream,
+                     Z_BEST_COMPRESSION,
+                     Z_DEFLATED,
+                     TIME_SERIES_WINDOW_BITS,
+                     TIME_SERIES_MEM_LEVEL,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        LE_ERROR("Failed to initialize time series compression.");
+        le_mem_Release(timeSeriesPtr);
+        return LE_FAULT;
+    }
+
+    timeSeriesPtr->factor = factor;
+    timeSeriesPtr->timeStampFactor = timeStampFactor;
+
+    if (DeflateTimeSeries(timeSeriesPtr, headerBuf, headerSize, Z_NO_FLUSH) != LE_OK)
+    {
+        ReleaseTimeSeries(timeSeriesPtr);
+        return LE_FAULT;
+    }
+
+    fieldDataPtr->timeSeriesPtr = timeSeriesPtr;
 
     return result;
 
@@ -1450,8 +2107,7 @@ static le_result_t StopTimeSeries
         return LE_CLOSED;
     }
 
-    le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-    le_mem_Release(fieldDataPtr->timeSeriesPtr);
+    ReleaseTimeSeries(fieldDataPtr->timeSeriesPtr);
 
     fieldDataPtr->timeSeriesPtr = NULL;
 
@@ -1466,7 +2122,7 @@ static le_result_t StopTimeSeries
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Compress the accumulated CBOR encoded time series data and send it to server.
+ * Close the compressed CBOR encoded time series data and send it to server.
  *
  * @return:
  *      - LE_OK on success
@@ -1488,12 +2144,14 @@ static le_result_t PushTimeSeries
 
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint32_t cborStreamSize;
-    unsigned char compressedBuf[MAX_CBOR_BUFFER_NUMBYTES];
-    unsigned long int compressBufLength;
-    z_stream defstream;
-    pa_avc_LWM2MOperationDataRef_t opRef;
-    CborError err;
+    TimeSeriesData_t* timeSeriesPtr;
+    TimeSeriesChunk_t* chunkPtr;
+    le_dls_Link_t* linkPtr;
+    const uint8_t breakByte = CBOR_BREAK_BYTE;
+    uint8_t* payloadPtr;
+    size_t payloadSize;
+    size_t offset;
+    size_t numBytes;
 
     double dataFactor;
     double timeStampFactor;
@@ -1504,7 +2162,8 @@ static le_result_t PushTimeSeries
         return result;
     }
 
-    if (fieldDataPtr->timeSeriesPtr == NULL)
+    timeSeriesPtr = fieldDataPtr->timeSeriesPtr;
+    if (timeSeriesPtr == NULL)
     {
         // Time series not enabled on this field.
         LE_ERROR("Time series not enabled on this field.");
@@ -1519,58 +2178,65 @@ static le_result_t PushTimeSeries
     }
 
     // Remember the factors used.
-    dataFactor = fieldDataPtr->timeSeriesPtr->factor;
-    timeStampFactor = fieldDataPtr->timeSeriesPtr->timeStampFactor;
+    dataFactor = timeSeriesPtr->factor;
+    timeStampFactor = timeSeriesPtr->timeStampFactor;
 
-    // Close the map i.e done with entering in to sample array.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                               &fieldDataPtr->timeSeriesPtr->sampleRef);
-
-    RETURN_IF_CBOR_ERROR(err);
+    // Close the sample array (the map and the stream have a definite length) and end the
+    // compressed stream. Room for this was kept when the samples were added.
+    result = DeflateTimeSeries(timeSeriesPtr, &breakByte, sizeof(breakByte), Z_FINISH);
+    if (result != LE_OK)
+    {
+        return LE_FAULT;
+    }
 
-    // Close the stream.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                               &fieldDataPtr->timeSeriesPtr->mapRef);
-    RETURN_IF_CBOR_ERROR(err);
+    payloadSize = timeSeriesPtr->zStream.total_out;
 
-    // Dump CBOR encoded data.
-    cborStreamSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                                  fieldDataPtr->timeSeriesPtr->bufferPtr);
+    LE_DEBUG("%"PRIu32" samples compressed in %zu bytes.",
+             timeSeriesPtr->numElements, payloadSize);
 
-    //LE_DEBUG("cborStreamSize = %d", cborStreamSize);
-    //LE_DUMP(fieldDataPtr->timeSeriesPtr->bufferPtr, cborStreamSize);
+    // A single chunk is sent as is, several chunks are gathered in a push buffer.
+    linkPtr = le_dls_Peek(&timeSeriesPtr->chunkList);
+    LE_ASSERT(linkPtr != NULL);
+    chunkPtr = CONTAINER_OF(linkPtr, TimeSeriesChunk_t, link);
 
-    // Compress the cbor encoded data
-    // ToDo: In place compression
-    defstream.zalloc = Z_NULL;
-    defstream.zfree = Z_NULL;
-    defstream.opaque = Z_NULL;
+    if (timeSeriesPtr->numChunks == 1)
+    {
+        payloadPtr = chunkPtr->data;
+    }
+    else
+    {
+        payloadPtr = le_mem_ForceAlloc(TimeSeriesPushBufferPoolRef);
 
-    defstream.avail_in = cborStreamSize;
-    defstream.next_in = (Bytef *)fieldDataPtr->timeSeriesPtr->bufferPtr;
-    defstream.avail_out = (uInt)sizeof(compressedBuf);
-    defstream.next_out = (Bytef *)compressedBuf;
+        for (offset = 0; offset < payloadSize; offset += numBytes)
+        {
+            LE_ASSERT(linkPtr != NULL);
+            chunkPtr = CONTAINER_OF(linkPtr, TimeSeriesChunk_t, link);
 
-    deflateInit(&defstream, Z_BEST_COMPRESSION);
-    deflate(&defstream, Z_FINISH);
-    deflateEnd(&defstream);
+            numBytes = payloadSize - offset;
+            if (numBytes > sizeof(chunkPtr->data))
+            {
+                numBytes = sizeof(chunkPtr->data);
+            }
 
-    compressBufLength = defstream.total_out;
+            memcpy(payloadPtr + offset, chunkPtr->data, numBytes);
 
-    //LE_DEBUG("Compressed size is: %lu\n", compressBufLength);
-    //LE_DUMP(compressedBuf, compressBufLength);
+            linkPtr = le_dls_PeekNext(&timeSeriesPtr->chunkList, linkPtr);
+        }
+    }
 
     // Send the delta encoded + CBOR encoded + Zipped data to the server.
-    opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                instanceRef->assetDataPtr->assetId,
-                                -1,
-                                -1,
-                                PA_AVC_OPTYPE_NOTIFY,
-                                SIERRA_CBOR_ENCODING,
-                                fieldDataPtr->token,
-                                fieldDataPtr->tokenLength);
+    NotifyChange(instanceRef,
+                 fieldDataPtr,
+                 SIERRA_CBOR_ENCODING,
+                 payloadPtr,
+                 payloadSize,
+                 PUSHQUEUE_PRIORITY_HIGH,
+                 TIME_SERIES_TIME_TO_LIVE);
 
-    pa_avc_NotifyChange(opRef, compressedBuf, compressBufLength);
+    if (timeSeriesPtr->numChunks != 1)
+    {
+        le_mem_Release(payloadPtr);
+    }
 
     // Stop time series.
     result = StopTimeSeries(instanceRef, fieldId);
@@ -1662,27 +2328,16 @@ static le_result_t TimeSeriesAddEntry
 
 #ifdef LEGATO_FEATURE_TIMESERIES
 
+    TimeSeriesData_t* timeSeriesPtr = fieldDataPtr->timeSeriesPtr;
     CborError err;
+    CborEncoder sampleRef;
+    uint8_t sampleBuf[CBOR_SAMPLE_NUMBYTES];
+    size_t sampleSize;
     uint64_t timeStamp;
     int intDelta;
     double floatDelta;
-    size_t currentSize;
     struct timeval tv;
 
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
-
-
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
-    {
-        LE_WARN("Time series buffer overflow on field %d.", fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %zd.", currentSize);
-
-        return LE_OVERFLOW;
-    }
-
     // Get current system time if utc milli seconds is not provided.
     // The time stamp is expected in UTC milli seconds by the server.
     if (utcMilliSec == 0)
@@ -1692,98 +2347,121 @@ static le_result_t TimeSeriesAddEntry
     }
 
     // For the first entry write the absolute value, for all other entries calculate delta.
-    if (fieldDataPtr->timeSeriesPtr->numElements == 0)
+    if (timeSeriesPtr->numElements == 0)
     {
-        timeStamp = utcMilliSec * fieldDataPtr->timeSeriesPtr->timeStampFactor;
+        timeStamp = utcMilliSec * timeSeriesPtr->timeStampFactor;
     }
     else
     {
-        timeStamp = (utcMilliSec - fieldDataPtr->timeSeriesPtr->prevTimeStamp) *
-                    fieldDataPtr->timeSeriesPtr->timeStampFactor;
+        timeStamp = (utcMilliSec - timeSeriesPtr->prevTimeStamp) *
+                    timeSeriesPtr->timeStampFactor;
     }
 
+    // The sample is encoded on its own: the items of the indefinite length sample array are just
+    // appended to the CBOR encoded stream.
+    cbor_encoder_init(&sampleRef, sampleBuf, sizeof(sampleBuf), 0);
+
     // Add time stamp to sample array.
-    err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, timeStamp);
+    err = cbor_encode_int(&sampleRef, timeStamp);
     RETURN_IF_CBOR_ERROR(err);
 
-    fieldDataPtr->timeSeriesPtr->prevTimeStamp = utcMilliSec;
-
     // Add the data to sample array.
     switch ( fieldDataPtr->type )
     {
         case DATA_TYPE_INT:
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
+            if (timeSeriesPtr->numElements == 0)
             {
-                intDelta = fieldDataPtr->intValue * fieldDataPtr->timeSeriesPtr->factor;
+                intDelta = fieldDataPtr->intValue * timeSeriesPtr->factor;
             }
             else
             {
-                intDelta = (fieldDataPtr->intValue - fieldDataPtr->timeSeriesPtr->prevIntValue) *
-                            fieldDataPtr->timeSeriesPtr->factor;
+                intDelta = (fieldDataPtr->intValue - timeSeriesPtr->prevIntValue) *
+                            timeSeriesPtr->factor;
             }
 
             //LE_DEBUG("intDelta = %d", intDelta);
 
-            err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, intDelta);
-
-            fieldDataPtr->timeSeriesPtr->prevIntValue = fieldDataPtr->intValue;
+            err = cbor_encode_int(&sampleRef, intDelta);
             break;
 
         case DATA_TYPE_BOOL:
-            err = cbor_encode_boolean(&fieldDataPtr->timeSeriesPtr->sampleRef, fieldDataPtr->boolValue);
+            err = cbor_encode_boolean(&sampleRef, fieldDataPtr->boolValue);
             break;
 
         case DATA_TYPE_STRING:
-            err = cbor_encode_text_string(&fieldDataPtr->timeSeriesPtr->sampleRef,
+            err = cbor_encode_text_string(&sampleRef,
                                           fieldDataPtr->strValuePtr,
                                           strlen(fieldDataPtr->strValuePtr));
             break;
 
         case DATA_TYPE_FLOAT:
             // ToDO: float doesn't benefit from use of factor - investigate.
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
+            if (timeSeriesPtr->numElements == 0)
             {
-                floatDelta = fieldDataPtr->floatValue * fieldDataPtr->timeSeriesPtr->factor;
+                floatDelta = fieldDataPtr->floatValue * timeSeriesPtr->factor;
             }
             else
             {
-                floatDelta = (fieldDataPtr->floatValue - fieldDataPtr->timeSeriesPtr->prevFloatValue);
-                floatDelta = floatDelta * fieldDataPtr->timeSeriesPtr->factor;
+                floatDelta = (fieldDataPtr->floatValue - timeSeriesPtr->prevFloatValue);
+                floatDelta = floatDelta * timeSeriesPtr->factor;
             }
 
-            if ((uint64_t)fieldDataPtr->timeSeriesPtr->factor == 1)
+            if ((uint64_t)timeSeriesPtr->factor == 1)
             {
-                err = cbor_encode_double(&fieldDataPtr->timeSeriesPtr->sampleRef, floatDelta);
+                err = cbor_encode_double(&sampleRef, floatDelta);
             }
             else
             {
                 LE_DEBUG("Float data encoded as integer.");
-                err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, (int64_t)floatDelta);
+                err = cbor_encode_int(&sampleRef, (int64_t)floatDelta);
             }
-
-            fieldDataPtr->timeSeriesPtr->prevFloatValue = fieldDataPtr->floatValue;
             break;
 
         case DATA_TYPE_NONE:
             LE_ERROR("Failed to add an entry in CBOR stream.");
-            break;
+            return LE_FAULT;
     }
 
     RETURN_IF_CBOR_ERROR(err);
 
-    fieldDataPtr->timeSeriesPtr->numElements++;
+    sampleSize = cbor_encoder_get_buffer_size(&sampleRef, sampleBuf);
 
+    // Keep room for the byte closing the sample array.
+    if (!IsTimeSeriesRoomAvailable(timeSeriesPtr, sampleSize + 1))
+    {
+        LE_WARN("Time series buffer overflow on field %d.", fieldDataPtr->fieldId);
+        LE_DEBUG("numChunks = %zu.", timeSeriesPtr->numChunks);
 
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
+        return LE_OVERFLOW;
+    }
+
+    if (DeflateTimeSeries(timeSeriesPtr, sampleBuf, sampleSize, Z_NO_FLUSH) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    // The previous values are only updated once the sample is added, so that the next delta is
+    // relative to the last sample in the stream.
+    timeSeriesPtr->prevTimeStamp = utcMilliSec;
+
+    if (fieldDataPtr->type == DATA_TYPE_INT)
+    {
+        timeSeriesPtr->prevIntValue = fieldDataPtr->intValue;
+    }
+    else if (fieldDataPtr->type == DATA_TYPE_FLOAT)
+    {
+        timeSeriesPtr->prevFloatValue = fieldDataPtr->floatValue;
+    }
 
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
+    timeSeriesPtr->numElements++;
+
+    // Reserve CBOR_RESERVED_BYTES bytes for the next sample and closing the container.
+    // The stream has to be flushed it starts getting in to the reserved area.
+    if (!IsTimeSeriesRoomAvailable(timeSeriesPtr, CBOR_RESERVED_BYTES))
     {
         LE_WARN("Time series buffer full; flush and restart time series on field %d.",
                  fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %zd.", currentSize);
+        LE_DEBUG("numChunks = %zu.", timeSeriesPtr->numChunks);
 
         return LE_NO_MEMORY;
     }
@@ -2157,7 +2835,6 @@ static le_result_t SetInt
     uint8_t valueData[256+1];  // +1 for null byte, if storing a string
     size_t bytesWritten;
     int prevValue;
-    pa_avc_LWM2MOperationDataRef_t opRef;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
 
@@ -2175,6 +2852,7 @@ static le_result_t SetInt
     // Remember current value and set new value.
     prevValue = fieldDataPtr->intValue;
     fieldDataPtr->intValue = value;
+    instanceRef->isTLVCacheValid = false;
 
     // Call any registered handlers to be notified of write.
     CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_WRITE, isClient );
@@ -2227,16 +2905,13 @@ static le_result_t SetInt
                 return LE_FAULT;
             }
 
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
-
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
+            NotifyChange(instanceRef,
+                         fieldDataPtr,
+                         TLV_ENCODING,
+                         valueData,
+                         bytesWritten,
+                         PUSHQUEUE_PRIORITY_LOW,
+                         VALUE_CHANGE_TIME_TO_LIVE);
         }
     }
 
@@ -2272,7 +2947,6 @@ static le_result_t SetFloat
     uint8_t valueData[256+1];  // +1 for null byte, if storing a string
     size_t bytesWritten;
     float prevValue;
-    pa_avc_LWM2MOperationDataRef_t opRef;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -2289,6 +2963,7 @@ static le_result_t SetFloat
     // Remember current value and set new value.
     prevValue = fieldDataPtr->floatValue;
     fieldDataPtr->floatValue = value;
+    instanceRef->isTLVCacheValid = false;
 
     // Call any registered handlers to be notified of write.
     CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_WRITE, isClient );
@@ -2341,16 +3016,13 @@ static le_result_t SetFloat
                 return LE_FAULT;
             }
 
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
-
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
+            NotifyChange(instanceRef,
+                         fieldDataPtr,
+                         TLV_ENCODING,
+                         valueData,
+                         bytesWritten,
+                         PUSHQUEUE_PRIORITY_LOW,
+                         VALUE_CHANGE_TIME_TO_LIVE);
         }
     }
 
@@ -2427,7 +3099,6 @@ static le_result_t SetBool
     uint8_t valueData[256+1];  // +1 for null byte, if storing a string
     size_t bytesWritten;
     bool prevValue;
-    pa_avc_LWM2MOperationDataRef_t opRef;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -2444,6 +3115,7 @@ static le_result_t SetBool
     // Remember current value and set new value.
     prevValue = fieldDataPtr->boolValue;
     fieldDataPtr->boolValue = value;
+    instanceRef->isTLVCacheValid = false;
 
     // Call any registered handlers to be notified of write.
     CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_WRITE, isClient );
@@ -2496,16 +3168,13 @@ static le_result_t SetBool
                 return LE_FAULT;
             }
 
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
-
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
+            NotifyChange(instanceRef,
+                         fieldDataPtr,
+                         TLV_ENCODING,
+                         valueData,
+                         bytesWritten,
+                         PUSHQUEUE_PRIORITY_LOW,
+                         VALUE_CHANGE_TIME_TO_LIVE);
         }
     }
 
@@ -2585,7 +3254,6 @@ static le_result_t SetString
     uint8_t valueData[256+1];  // +1 for null byte, if storing a string
     size_t bytesWritten;
     char prevStr[STRING_VALUE_NUMBYTES];
-    pa_avc_LWM2MOperationDataRef_t opRef;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -2602,6 +3270,7 @@ static le_result_t SetString
     // Remember current value and set new value.
     result = le_utf8_Copy(prevStr, fieldDataPtr->strValuePtr, STRING_VALUE_NUMBYTES, NULL);
     result = le_utf8_Copy(fieldDataPtr->strValuePtr, strPtr, STRING_VALUE_NUMBYTES, NULL);
+    instanceRef->isTLVCacheValid = false;
 
     // Call any registered handlers to be notified of write.
     CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_WRITE, isClient );
@@ -2654,16 +3323,13 @@ static le_result_t SetString
                 return LE_FAULT;
             }
 
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
-
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
+            NotifyChange(instanceRef,
+                         fieldDataPtr,
+                         TLV_ENCODING,
+                         valueData,
+                         bytesWritten,
+                         PUSHQUEUE_PRIORITY_LOW,
+                         VALUE_CHANGE_TIME_TO_LIVE);
         }
     }
 
@@ -2871,6 +3537,18 @@ void assetData_SessionStatus
     {
         le_timer_Restart(RegUpdateTimerRef);
     }
+
+    // Send the notifications queued while there was no session.
+    if ((CurrentAvSessionStatus == ASSET_DATA_SESSION_AVAILABLE)
+        && (pushQueue_GetCount() > 0))
+    {
+        LE_INFO("Sending %zu queued notifications.", pushQueue_GetCount());
+        le_timer_Restart(PushQueueTimerRef);
+    }
+    else if (CurrentAvSessionStatus != ASSET_DATA_SESSION_AVAILABLE)
+    {
+        le_timer_Stop(PushQueueTimerRef);
+    }
 }
 
 
@@ -3063,8 +3741,13 @@ le_result_t assetData_CreateInstanceById
     // Add back reference from instance data to the asset containing the instance
     assetInstPtr->assetDataPtr = assetDataPtr;
 
+    // The TLV encoding of the instance is cached on first read.
+    assetInstPtr->isTLVCacheValid = false;
+    assetInstPtr->isTLVTooLarge = false;
+
 
     le_dls_Queue(&assetDataPtr->instanceList, &assetInstPtr->link);
+    IndexInstance(assetInstPtr);
 
     // todo: For now, for testing, print it out; add trace support later.
     if ( 0 )
@@ -3167,6 +3850,9 @@ void assetData_DeleteInstance
     FieldData_t* fieldDataPtr;
     le_dls_Link_t* linkPtr;
 
+    // Remove the instance and its fields from the lookup maps, before they are released.
+    UnindexInstance(instanceRef);
+
     // Pop the first field from field list
     linkPtr = le_dls_Pop(&instanceRef->fieldList);
 
@@ -3191,8 +3877,7 @@ void assetData_DeleteInstance
         if (fieldDataPtr->timeSeriesPtr != NULL)
         {
             LE_DEBUG("Releasing time series resources of %s", fieldDataPtr->name);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr);
+            ReleaseTimeSeries(fieldDataPtr->timeSeriesPtr);
         }
 
         // Release the field.
@@ -3553,40 +4238,20 @@ le_result_t assetData_GetFieldIdFromName
     /*
      * NOTE:
      *   The main use for this function is to get the fieldId that is then passed to the various
-     *   assetData_client_Get* functions.  This is not particularly efficient as it requires
-     *   iterating twice through the field list.  One alternative would be to add a new set of
-     *   assetData_client_Get* functions that take a field name instead of field id.
-     *
-     *   For now, assume that the performance is good enough, but if it becomes an issue then
-     *   this second set of functions may need to be added.  Of course, there might also be some
-     *   other alternative solution that has not yet been considered.
+     *   assetData_client_Get* functions.  Both the name and the id are looked up in hashmaps, so
+     *   the cost does not depend on the number of fields in the instance.
      */
 
-    FieldData_t* fieldDataPtr;
-    le_dls_Link_t* fieldLinkPtr;
-
-    // Get the start of the field list
-    fieldLinkPtr = le_dls_Peek(&instanceRef->fieldList);
-
-    //LE_PRINT_VALUE("%s", instanceRef->assetDataPtr->appName);
-    //LE_PRINT_VALUE("%s", instanceRef->assetDataPtr->assetName);
+    FieldNameKey_t key = { .instancePtr = instanceRef, .namePtr = fieldNamePtr };
+    FieldData_t* fieldDataPtr = le_hashmap_Get(FieldMapByName, &key);
 
-    // Loop through the fields
-    while ( fieldLinkPtr != NULL )
+    if ( fieldDataPtr == NULL )
     {
-        fieldDataPtr = CONTAINER_OF(fieldLinkPtr, FieldData_t, link);
-        //LE_PRINT_VALUE("%s", fieldDataPtr->name);
-
-        if ( strcmp(fieldDataPtr->name, fieldNamePtr) == 0 )
-        {
-            *fieldIdPtr = fieldDataPtr->fieldId;
-            return LE_OK;
-        }
-
-        fieldLinkPtr = le_dls_PeekNext(&instanceRef->fieldList, fieldLinkPtr);
+        return LE_FAULT;
     }
 
-    return LE_FAULT;
+    *fieldIdPtr = fieldDataPtr->fieldId;
+    return LE_OK;
 }
 
 
@@ -4313,6 +4978,8 @@ le_result_t assetData_server_SetValue
         return result;
     }
 
+    instanceRef->isTLVCacheValid = false;
+
     result = LE_OK;   // result could be changed in the switch statement
     switch ( fieldDataPtr->type )
     {
@@ -4511,6 +5178,24 @@ static void RegUpdateTimerHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function for PushQueueTimerRef expiry
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushQueueTimerHandler
+(
+    le_timer_Ref_t timerRef    ///< This timer has expired
+)
+{
+    if ((CurrentAvSessionStatus != ASSET_DATA_SESSION_AVAILABLE)
+        || (pushQueue_Send(PUSH_QUEUE_BATCH_SIZE) == 0))
+    {
+        le_timer_Stop(timerRef);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Init this sub-component
@@ -4530,7 +5215,10 @@ le_result_t assetData_Init
 
     // Memory pool for time series data.
     TimeSeriesDataPoolRef = le_mem_CreatePool("TimeSeries data pool", sizeof(TimeSeriesData_t));
-    CborBufferPoolRef = le_mem_CreatePool("CBOR buffer pool", MAX_CBOR_BUFFER_NUMBYTES);
+    TimeSeriesChunkPoolRef = le_mem_CreatePool("TimeSeries chunk pool",
+                                               sizeof(TimeSeriesChunk_t));
+    TimeSeriesPushBufferPoolRef = le_mem_CreatePool("TimeSeries push buffer pool",
+                                                    TIME_SERIES_MAX_NUMBYTES);
 
     StringValuePoolRef = le_mem_CreatePool("String value pool", STRING_VALUE_NUMBYTES);
     AddressStringPoolRef = le_mem_CreatePool("Address pool", 100);
@@ -4544,6 +5232,17 @@ le_result_t assetData_Init
                                        le_hashmap_HashString,
                                        le_hashmap_EqualsString);
 
+    // Create the maps used to look up instances and fields without walking their lists.
+    InstanceMap = le_hashmap_Create("Instance Map",
+                                    INSTANCE_MAP_CAPACITY,
+                                    HashInstanceKey,
+                                    EqualsInstanceKey);
+    FieldMap = le_hashmap_Create("Field Map", FIELD_MAP_CAPACITY, HashFieldKey, EqualsFieldKey);
+    FieldMapByName = le_hashmap_Create("FieldNameMap",
+                                       FIELD_MAP_CAPACITY,
+                                       HashFieldNameKey,
+                                       EqualsFieldNameKey);
+
 
     // Use a timer to delay reporting instance creation events to the modem for 15 seconds after
     // the last creation event. This allows us to aggregate multiple registration updates together.
@@ -4555,6 +5254,23 @@ le_result_t assetData_Init
     le_timer_SetInterval(RegUpdateTimerRef, timerInterval);
     le_timer_SetHandler(RegUpdateTimerRef, RegUpdateTimerHandler);
 
+    // Queued notifications are sent in batches, to leave room for the other messages of the
+    // session.
+    le_clk_Time_t pushQueueInterval = { .sec=0, .usec=500000 };
+
+    PushQueueTimerRef = le_timer_Create("PushQueue timer");
+    le_timer_SetInterval(PushQueueTimerRef, pushQueueInterval);
+    le_timer_SetRepeat(PushQueueTimerRef, 0);
+    le_timer_SetHandler(PushQueueTimerRef, PushQueueTimerHandler);
+
+    // Reload the notifications queued before a restart. Without the queue, the notifications are
+    // dropped while there is no session.
+    if ((le_dir_MakePath(PUSH_QUEUE_DIR, S_IRWXU) != LE_OK)
+        || (pushQueue_Init(PUSH_QUEUE_PATH, PUSH_QUEUE_MAX_NUMBYTES) != LE_OK))
+    {
+        LE_ERROR("Push queue not available.");
+    }
+
     // Pre-load the /lwm2m/9 object into the AssetMap; don't actually need to use the assetRef here.
     assetData_AssetDataRef_t lwm2mAssetRef;
 
@@ -4867,7 +5583,7 @@ static le_result_t WriteFieldTLV
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write a list of readable LWM2M Resource TLVs to the given buffer.
+ * Encode the list of readable LWM2M Resource TLVs to the given buffer.
  *
  * @return:
  *      - LE_OK on success
@@ -4875,7 +5591,7 @@ static le_result_t WriteFieldTLV
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t assetData_WriteFieldListToTLV
+static le_result_t EncodeFieldListTLV
 (
     assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
     uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
@@ -4926,6 +5642,125 @@ le_result_t assetData_WriteFieldListToTLV
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store a freshly encoded list of readable LWM2M Resource TLVs in the instance cache, or remember
+ * that it is too large for it, so that it is not encoded in the cache until a field is written.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateTLVCache
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    const uint8_t* tlvPtr,                      ///< [IN] Encoded TLV list
+    size_t tlvNumBytes                          ///< [IN] # bytes in encoded TLV list
+)
+{
+    instanceRef->isTLVTooLarge = ( tlvNumBytes > sizeof(instanceRef->tlvCache) );
+    if ( !instanceRef->isTLVTooLarge )
+    {
+        memcpy(instanceRef->tlvCache, tlvPtr, tlvNumBytes);
+        instanceRef->tlvCacheNumBytes = tlvNumBytes;
+    }
+
+    instanceRef->isTLVCacheValid = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the list of readable LWM2M Resource TLVs of the given instance from its cache, encoding it
+ * first if a field was written since the last encoding.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the TLV data does not fit in the cache
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetCachedFieldListTLV
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    const uint8_t** tlvPtrPtr,                  ///< [OUT] Cached TLV list
+    size_t* tlvNumBytesPtr                      ///< [OUT] # bytes in cached TLV list
+)
+{
+    if ( !instanceRef->isTLVCacheValid )
+    {
+        le_result_t result = EncodeFieldListTLV(instanceRef,
+                                                instanceRef->tlvCache,
+                                                sizeof(instanceRef->tlvCache),
+                                                &instanceRef->tlvCacheNumBytes);
+        if ( result == LE_OVERFLOW )
+        {
+            // Don't try again until a field is written.
+            instanceRef->isTLVTooLarge = true;
+            instanceRef->isTLVCacheValid = true;
+        }
+        if ( result != LE_OK )
+        {
+            return result;
+        }
+
+        instanceRef->isTLVTooLarge = false;
+        instanceRef->isTLVCacheValid = true;
+    }
+    else if ( instanceRef->isTLVTooLarge )
+    {
+        return LE_OVERFLOW;
+    }
+
+    *tlvPtrPtr = instanceRef->tlvCache;
+    *tlvNumBytesPtr = instanceRef->tlvCacheNumBytes;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a list of readable LWM2M Resource TLVs to the given buffer.
+ *
+ * The list is copied from the instance cache when it is up to date. Otherwise it is encoded from
+ * the field values straight to the given buffer, and then cached if it fits in the cache.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the TLV data could not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_WriteFieldListToTLV
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
+)
+{
+    le_result_t result;
+
+    if ( !instanceRef->isTLVCacheValid || instanceRef->isTLVTooLarge )
+    {
+        // Encode only once, whether or not the result fits in the cache.
+        result = EncodeFieldListTLV(instanceRef, bufPtr, bufNumBytes, numBytesWrittenPtr);
+        if ( ( result == LE_OK ) && !instanceRef->isTLVCacheValid )
+        {
+            UpdateTLVCache(instanceRef, bufPtr, *numBytesWrittenPtr);
+        }
+        return result;
+    }
+
+    if ( instanceRef->tlvCacheNumBytes > bufNumBytes )
+    {
+        LE_WARN("Overflow: oiid=%i", instanceRef->instanceId);
+        return LE_OVERFLOW;
+    }
+
+    memcpy(bufPtr, instanceRef->tlvCache, instanceRef->tlvCacheNumBytes);
+    *numBytesWrittenPtr = instanceRef->tlvCacheNumBytes;
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write a LWM2M Object Instance TLV to the given buffer.
@@ -4949,17 +5784,16 @@ static le_result_t WriteInstanceToTLV
     FieldData_t* fieldDataPtr;
     size_t totalNumBytesWritten;
     size_t numBytesWritten;
-    uint8_t tmpBuffer[256-6];  // leave enough space for maximum header size of 6 bytes
+    uint8_t tmpBuffer[INSTANCE_TLV_MAX_NUMBYTES];
+    const uint8_t* tlvPtr = tmpBuffer;
 
     // Need to write the field TLVs first, to know how many bytes will be in the instance TLV.
     // Either read all the allowable TLVs, or just the one specified.
     if ( fieldId == -1 )
     {
-        // Read all fields that are allowed and write to the TLV.
-        result = assetData_WriteFieldListToTLV(instanceRef,
-                                               tmpBuffer,
-                                               sizeof(tmpBuffer),
-                                               &totalNumBytesWritten);
+        // All fields that are allowed are read from the instance cache, which has the same size
+        // as tmpBuffer.
+        result = GetCachedFieldListTLV(instanceRef, &tlvPtr, &totalNumBytesWritten);
         if ( result != LE_OK )
         {
             return result;
@@ -4992,7 +5826,7 @@ static le_result_t WriteInstanceToTLV
         bufPtr += numBytesWritten;
         bufNumBytes -= numBytesWritten;
 
-        memcpy(bufPtr, tmpBuffer, totalNumBytesWritten);
+        memcpy(bufPtr, tlvPtr, totalNumBytesWritten);
         *numBytesWrittenPtr = numBytesWritten+totalNumBytesWritten;
 
         result = LE_OK;
@@ -5218,6 +6052,8 @@ static le_result_t ReadFieldValueFromTLV
     if ( result != LE_OK )
         return result;
 
+    instanceRef->isTLVCacheValid = false;
+
     // Update the field value from the TLV; note that result must be LE_OK here.
     switch ( fieldDataPtr->type )
     {
@@ -46,6 +46,8 @@
  * If we build part of the TLV, and then variable length values have changed, then the TLV
  * will be corrupted. This buffer is filled only when the request is for a block offset of 0.
  * For subsequent block reads we can just return data from this buffer without retrieving asset data.
+ * The TLV of each object instance is cached by assetData until one of its fields is written, so
+ * filling this buffer mostly copies the cached TLVs.
  *
  * The buffer size is chosen to support reading object 9 instances of at least 64 apps.
  * The following fields are read for lwm2m/9/appName, i.e. a single instance of object 9.
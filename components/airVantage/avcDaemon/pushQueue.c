@@ -0,0 +1,1159 @@
+/**
+ * @file pushQueue.c
+ *
+ * Implementation of the push queue.
+ *
+ * The notifications are kept in an append-only file made of CRC-protected records:
+ *  - a notification record holds a queued notification,
+ *  - a done record tells that a notification was sent, expired or dropped.
+ *
+ * The queue is rebuilt in memory by replaying the file at start-up, and the file is only read
+ * afterwards to send a notification. Replay stops at the first invalid record, which is how a
+ * record torn by a power loss is detected, and the file is truncated there.
+ *
+ * Done records are not synced to flash: losing one on a power loss only means that the
+ * notification is sent again. The file is truncated once the queue is empty, which is the usual
+ * case after a session, and it is compacted when obsolete records make up most of it.
+ *
+ * Expiry times are taken from the relative clock, which counts from boot and is not affected by the
+ * wall clock being set, e.g. when the time is first synced. A notification record tells the boot it
+ * was written in; the time to live of a notification queued before a reboot restarts at replay,
+ * since the time spent powered off is unknown.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "pushQueue.h"
+#include "pa_avc.h"
+
+
+//--------------------------------------------------------------------------------------------------
+// Definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number at the start of each record ("AVPQ")
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_MAGIC 0x41565051
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record types
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_NOTIFICATION 1
+#define RECORD_DONE 2
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of an app name in a record
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_APP_NAME_NUMBYTES UINT8_MAX
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a record
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RECORD_NUMBYTES (sizeof(RecordHeader_t) + sizeof(NotificationRecord_t) + \
+                             MAX_APP_NAME_NUMBYTES + PUSHQUEUE_MAX_PAYLOAD_NUMBYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The file is compacted when it holds more than this number of obsolete bytes, and more obsolete
+ * bytes than queued ones.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPACT_MIN_DEAD_NUMBYTES (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of queued notifications, used to size the hashmap
+ */
+//--------------------------------------------------------------------------------------------------
+#define ENTRY_MAP_SIZE 63
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File identifying the current boot
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef BOOT_ID_PATH
+#define BOOT_ID_PATH "/proc/sys/kernel/random/boot_id"
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record header
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                 ///< RECORD_MAGIC.
+    uint32_t crc;                   ///< CRC32 of the rest of the header and of the record data.
+    uint16_t type;                  ///< Record type.
+    uint16_t reserved;
+    uint32_t length;                ///< Number of bytes of record data following the header.
+    uint32_t id;                    ///< Notification identifier.
+}
+RecordHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fixed part of a notification record. It is followed by the app name, without terminating null
+ * character, then by the payload.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t expiry;                                ///< Relative time (s) when the notification
+                                                    ///  expires in boot bootId, or 0 if it never
+                                                    ///  does.
+    uint32_t bootId;                                ///< Boot the expiry time refers to.
+    uint32_t timeToLive;                            ///< Time to live (s), or 0.
+    int32_t assetId;                                ///< Asset id within the app.
+    uint16_t contentType;                           ///< Encoding of the payload.
+    uint8_t priority;                               ///< Priority.
+    uint8_t tokenLength;                            ///< Number of bytes in token.
+    uint8_t token[PUSHQUEUE_MAX_TOKEN_NUMBYTES];    ///< Observe token.
+    uint8_t appNameLength;                          ///< Number of bytes of the app name.
+    uint8_t reserved[7];
+}
+NotificationRecord_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queued notification
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t id;                    ///< Notification identifier.
+    pushQueue_Priority_t priority;  ///< Priority.
+    uint64_t expiry;                ///< Relative time (s) when the notification expires, or 0.
+    off_t offset;                   ///< Offset of the notification record in the file.
+    size_t recordNumBytes;          ///< Number of bytes of the notification record.
+    le_dls_Link_t link;             ///< For adding to the list of its priority.
+}
+Entry_t;
+
+
+//--------------------------------------------------------------------------------------------------
+// Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queued notification pool, and notifications by identifier
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t EntryPoolRef = NULL;
+static le_hashmap_Ref_t EntryMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queued notifications of each priority, oldest first
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t EntryList[PUSHQUEUE_NUM_PRIORITIES];
+static size_t NumEntries;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue file, and path of the file written by a compaction
+ */
+//--------------------------------------------------------------------------------------------------
+static int QueueFd = -1;
+static char QueuePath[PATH_MAX];
+static char TmpPath[PATH_MAX];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the queue file, number of its bytes holding queued notifications, and maximum value of
+ * the latter.
+ */
+//--------------------------------------------------------------------------------------------------
+static off_t QueueSize;
+static size_t LiveNumBytes;
+static size_t MaxLiveNumBytes;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Next notification identifier
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NextId = 1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identifier of the current boot, 0 if unknown
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t BootId;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record buffer. The daemon is single threaded, so a single buffer is shared by all the functions.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t RecordBuf[MAX_RECORD_NUMBYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current relative time in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetTime
+(
+    void
+)
+{
+    return (uint64_t)le_clk_GetRelativeTime().sec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the identifier of the current boot.
+ *
+ * @return
+ *      - CRC of the kernel's boot identifier, or 0 if it can't be read
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ReadBootId
+(
+    void
+)
+{
+    uint8_t buf[64];
+    ssize_t numBytes;
+    int fd;
+
+    fd = open(BOOT_ID_PATH, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        LE_WARN("Failed to open %s: %m", BOOT_ID_PATH);
+        return 0;
+    }
+
+    numBytes = read(fd, buf, sizeof(buf));
+    close(fd);
+
+    if (numBytes <= 0)
+    {
+        LE_WARN("Failed to read %s", BOOT_ID_PATH);
+        return 0;
+    }
+
+    return le_crc_Crc32(buf, numBytes, LE_CRC_START_CRC32);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the expiry time of a notification record in the current boot.
+ *
+ * @return
+ *      - Relative time (s) when the notification expires, or 0 if it never does
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetRecordExpiry
+(
+    const NotificationRecord_t* notificationPtr,    ///< [IN] Notification record
+    uint64_t now                                    ///< [IN] Current relative time (s)
+)
+{
+    if ((notificationPtr->expiry == 0) ||
+        ((BootId != 0) && (notificationPtr->bootId == BootId)))
+    {
+        return notificationPtr->expiry;
+    }
+
+    // Queued before a reboot: the time to live starts again.
+    return now + notificationPtr->timeToLive;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the CRC of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ComputeRecordCrc
+(
+    const uint8_t* recordPtr        ///< [IN] Record, header then record data
+)
+{
+    const RecordHeader_t* headerPtr = (const RecordHeader_t*)recordPtr;
+    size_t crcOffset = offsetof(RecordHeader_t, type);
+
+    return le_crc_Crc32((uint8_t*)recordPtr + crcOffset,
+                        sizeof(RecordHeader_t) + headerPtr->length - crcOffset,
+                        LE_CRC_START_CRC32);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a record read from the queue file is valid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRecordValid
+(
+    const uint8_t* recordPtr        ///< [IN] Record, header then record data
+)
+{
+    const RecordHeader_t* headerPtr = (const RecordHeader_t*)recordPtr;
+    const NotificationRecord_t* notificationPtr;
+
+    if (headerPtr->crc != ComputeRecordCrc(recordPtr))
+    {
+        return false;
+    }
+
+    switch (headerPtr->type)
+    {
+        case RECORD_NOTIFICATION:
+            notificationPtr = (const NotificationRecord_t*)(recordPtr + sizeof(RecordHeader_t));
+
+            return ((headerPtr->length >= sizeof(NotificationRecord_t) +
+                                          notificationPtr->appNameLength) &&
+                    (notificationPtr->priority < PUSHQUEUE_NUM_PRIORITIES) &&
+                    (notificationPtr->tokenLength <= PUSHQUEUE_MAX_TOKEN_NUMBYTES));
+
+        case RECORD_DONE:
+            return (headerPtr->length == 0);
+
+        default:
+            return false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a record from the queue file into RecordBuf.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if there is no valid record at this offset
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadRecord
+(
+    off_t offset                    ///< [IN] Offset of the record in the queue file
+)
+{
+    RecordHeader_t* headerPtr = (RecordHeader_t*)RecordBuf;
+    ssize_t numBytes;
+
+    numBytes = pread(QueueFd, RecordBuf, sizeof(RecordHeader_t), offset);
+    if ((numBytes != sizeof(RecordHeader_t)) ||
+        (headerPtr->magic != RECORD_MAGIC) ||
+        (headerPtr->length > (MAX_RECORD_NUMBYTES - sizeof(RecordHeader_t))))
+    {
+        return LE_FAULT;
+    }
+
+    numBytes = pread(QueueFd,
+                     RecordBuf + sizeof(RecordHeader_t),
+                     headerPtr->length,
+                     offset + sizeof(RecordHeader_t));
+    if ((numBytes != (ssize_t)headerPtr->length) || !IsRecordValid(RecordBuf))
+    {
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a buffer to a file.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAll
+(
+    int fd,                         ///< [IN] File descriptor
+    const uint8_t* bufPtr,          ///< [IN] Buffer
+    size_t numBytes                 ///< [IN] Number of bytes to write
+)
+{
+    ssize_t written;
+
+    while (numBytes > 0)
+    {
+        written = write(fd, bufPtr, numBytes);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return LE_FAULT;
+        }
+
+        bufPtr += written;
+        numBytes -= written;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a record to the queue file.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the record can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AppendRecord
+(
+    uint8_t* recordPtr,             ///< [IN] Record, its magic and CRC are filled in
+    bool isSync,                    ///< [IN] Sync the record to flash?
+    off_t* offsetPtr                ///< [OUT] Offset of the record in the queue file, or NULL
+)
+{
+    RecordHeader_t* headerPtr = (RecordHeader_t*)recordPtr;
+    size_t recordNumBytes = sizeof(RecordHeader_t) + headerPtr->length;
+
+    headerPtr->magic = RECORD_MAGIC;
+    headerPtr->crc = ComputeRecordCrc(recordPtr);
+
+    if (WriteAll(QueueFd, recordPtr, recordNumBytes) != LE_OK)
+    {
+        LE_ERROR("Failed to write to %s: %m", QueuePath);
+
+        // Don't leave a partial record behind, the records after it would be lost at replay.
+        if (ftruncate(QueueFd, QueueSize) == -1)
+        {
+            LE_ERROR("Failed to truncate %s: %m", QueuePath);
+        }
+        return LE_FAULT;
+    }
+
+    if (isSync && (fdatasync(QueueFd) == -1))
+    {
+        LE_WARN("Failed to sync %s: %m", QueuePath);
+    }
+
+    if (offsetPtr != NULL)
+    {
+        *offsetPtr = QueueSize;
+    }
+    QueueSize += recordNumBytes;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a notification record to the queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateEntry
+(
+    const RecordHeader_t* headerPtr,                ///< [IN] Notification record header
+    const NotificationRecord_t* notificationPtr,    ///< [IN] Notification record
+    uint64_t expiry,                                ///< [IN] Expiry time in the current boot
+    off_t offset                                    ///< [IN] Offset of the record
+)
+{
+    Entry_t* entryPtr = le_mem_ForceAlloc(EntryPoolRef);
+
+    entryPtr->id = headerPtr->id;
+    entryPtr->priority = notificationPtr->priority;
+    entryPtr->expiry = expiry;
+    entryPtr->offset = offset;
+    entryPtr->recordNumBytes = sizeof(RecordHeader_t) + headerPtr->length;
+    entryPtr->link = LE_DLS_LINK_INIT;
+
+    le_dls_Queue(&EntryList[entryPtr->priority], &entryPtr->link);
+    le_hashmap_Put(EntryMap, &entryPtr->id, entryPtr);
+
+    NumEntries++;
+    LiveNumBytes += entryPtr->recordNumBytes;
+
+    if (headerPtr->id >= NextId)
+    {
+        NextId = headerPtr->id + 1;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a notification from the queue, without writing a done record.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveEntry
+(
+    Entry_t* entryPtr               ///< [IN] Queued notification
+)
+{
+    le_dls_Remove(&EntryList[entryPtr->priority], &entryPtr->link);
+    le_hashmap_Remove(EntryMap, &entryPtr->id);
+
+    NumEntries--;
+    LiveNumBytes -= entryPtr->recordNumBytes;
+
+    le_mem_Release(entryPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a notification from the queue and write its done record.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropEntry
+(
+    Entry_t* entryPtr               ///< [IN] Queued notification
+)
+{
+    RecordHeader_t header;
+
+    memset(&header, 0, sizeof(header));
+    header.type = RECORD_DONE;
+    header.id = entryPtr->id;
+
+    // On failure, the notification is sent again after a restart.
+    AppendRecord((uint8_t*)&header, false, NULL);
+
+    RemoveEntry(entryPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the oldest notification of the lowest priority in the range [0, maxPriority].
+ *
+ * @return
+ *      - Queued notification, or NULL if there is none
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* GetLowestEntry
+(
+    pushQueue_Priority_t maxPriority    ///< [IN] Highest priority to consider
+)
+{
+    le_dls_Link_t* linkPtr;
+    int priority;
+
+    for (priority = 0; priority <= (int)maxPriority; priority++)
+    {
+        linkPtr = le_dls_Peek(&EntryList[priority]);
+        if (linkPtr != NULL)
+        {
+            return CONTAINER_OF(linkPtr, Entry_t, link);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the oldest notification of the highest priority.
+ *
+ * @return
+ *      - Queued notification, or NULL if the queue is empty
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* GetHighestEntry
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr;
+    int priority;
+
+    for (priority = PUSHQUEUE_NUM_PRIORITIES - 1; priority >= 0; priority--)
+    {
+        linkPtr = le_dls_Peek(&EntryList[priority]);
+        if (linkPtr != NULL)
+        {
+            return CONTAINER_OF(linkPtr, Entry_t, link);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the expired notifications.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropExpiredEntries
+(
+    void
+)
+{
+    uint64_t now = GetTime();
+    le_dls_Link_t* linkPtr;
+    Entry_t* entryPtr;
+    int priority;
+
+    for (priority = 0; priority < PUSHQUEUE_NUM_PRIORITIES; priority++)
+    {
+        linkPtr = le_dls_Peek(&EntryList[priority]);
+        while (linkPtr != NULL)
+        {
+            entryPtr = CONTAINER_OF(linkPtr, Entry_t, link);
+            linkPtr = le_dls_PeekNext(&EntryList[priority], linkPtr);
+
+            if ((entryPtr->expiry != 0) && (entryPtr->expiry <= now))
+            {
+                LE_INFO("Dropping expired notification %"PRIu32, entryPtr->id);
+                DropEntry(entryPtr);
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replay the queue file to rebuild the queue. The file is truncated at the first invalid record.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReplayQueue
+(
+    void
+)
+{
+    RecordHeader_t* headerPtr = (RecordHeader_t*)RecordBuf;
+    const NotificationRecord_t* notificationPtr;
+    uint64_t now = GetTime();
+    uint64_t expiry;
+    Entry_t* entryPtr;
+    struct stat st;
+    off_t offset = 0;
+
+    if (fstat(QueueFd, &st) == -1)
+    {
+        LE_ERROR("Failed to stat %s: %m", QueuePath);
+        st.st_size = 0;
+    }
+
+    while ((offset < st.st_size) && (ReadRecord(offset) == LE_OK))
+    {
+        if (headerPtr->type == RECORD_NOTIFICATION)
+        {
+            notificationPtr = (const NotificationRecord_t*)(RecordBuf + sizeof(RecordHeader_t));
+
+            expiry = GetRecordExpiry(notificationPtr, now);
+
+            // An expired notification is left in the file, it'll be removed by the compaction.
+            if ((expiry == 0) || (expiry > now))
+            {
+                CreateEntry(headerPtr, notificationPtr, expiry, offset);
+            }
+            else if (headerPtr->id >= NextId)
+            {
+                NextId = headerPtr->id + 1;
+            }
+        }
+        else
+        {
+            entryPtr = le_hashmap_Get(EntryMap, &headerPtr->id);
+            if (entryPtr != NULL)
+            {
+                RemoveEntry(entryPtr);
+            }
+        }
+
+        offset += sizeof(RecordHeader_t) + headerPtr->length;
+    }
+
+    if (offset != st.st_size)
+    {
+        LE_WARN("Discarding %d bytes of invalid records at the end of %s",
+                (int)(st.st_size - offset), QueuePath);
+
+        if (ftruncate(QueueFd, offset) == -1)
+        {
+            LE_ERROR("Failed to truncate %s: %m", QueuePath);
+        }
+    }
+
+    QueueSize = offset;
+
+    LE_INFO("%zu notifications queued in %s", NumEntries, QueuePath);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sync the directory of the queue file, so that a rename is durable.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SyncQueueDirectory
+(
+    void
+)
+{
+    char dirPath[PATH_MAX];
+    char* slashPtr;
+    int dirFd;
+
+    LE_ASSERT(le_utf8_Copy(dirPath, QueuePath, sizeof(dirPath), NULL) == LE_OK);
+
+    slashPtr = strrchr(dirPath, '/');
+    if (slashPtr == NULL)
+    {
+        LE_ASSERT(le_utf8_Copy(dirPath, ".", sizeof(dirPath), NULL) == LE_OK);
+    }
+    else if (slashPtr == dirPath)
+    {
+        dirPath[1] = '\0';
+    }
+    else
+    {
+        *slashPtr = '\0';
+    }
+
+    dirFd = open(dirPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd == -1)
+    {
+        LE_WARN("Failed to open %s: %m", dirPath);
+        return;
+    }
+
+    if (fsync(dirFd) == -1)
+    {
+        LE_WARN("Failed to sync %s: %m", dirPath);
+    }
+
+    close(dirFd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rewrite the queue file with only the queued notifications. Their expiry times are rewritten for
+ * the current boot.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompactQueue
+(
+    void
+)
+{
+    RecordHeader_t* headerPtr = (RecordHeader_t*)RecordBuf;
+    NotificationRecord_t* notificationPtr =
+        (NotificationRecord_t*)(RecordBuf + sizeof(RecordHeader_t));
+    le_dls_Link_t* linkPtr;
+    Entry_t* entryPtr;
+    le_result_t result;
+    off_t offset = 0;
+    int priority;
+    int fd;
+
+    fd = open(TmpPath, O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd == -1)
+    {
+        LE_ERROR("Failed to create %s: %m", TmpPath);
+        return;
+    }
+
+    // Each priority list is written in order, so that the replay rebuilds the same lists.
+    for (priority = 0; priority < PUSHQUEUE_NUM_PRIORITIES; priority++)
+    {
+        for (linkPtr = le_dls_Peek(&EntryList[priority]);
+             linkPtr != NULL;
+             linkPtr = le_dls_PeekNext(&EntryList[priority], linkPtr))
+        {
+            entryPtr = CONTAINER_OF(linkPtr, Entry_t, link);
+
+            result = ReadRecord(entryPtr->offset);
+            if (result == LE_OK)
+            {
+                notificationPtr->expiry = entryPtr->expiry;
+                notificationPtr->bootId = BootId;
+                headerPtr->crc = ComputeRecordCrc(RecordBuf);
+
+                result = WriteAll(fd, RecordBuf, entryPtr->recordNumBytes);
+            }
+
+            if (result != LE_OK)
+            {
+                LE_ERROR("Failed to compact %s", QueuePath);
+                close(fd);
+                unlink(TmpPath);
+                return;
+            }
+        }
+    }
+
+    if ((fdatasync(fd) == -1) || (rename(TmpPath, QueuePath) == -1))
+    {
+        LE_ERROR("Failed to replace %s: %m", QueuePath);
+        close(fd);
+        unlink(TmpPath);
+        return;
+    }
+
+    SyncQueueDirectory();
+
+    close(QueueFd);
+    QueueFd = fd;
+
+    for (priority = 0; priority < PUSHQUEUE_NUM_PRIORITIES; priority++)
+    {
+        for (linkPtr = le_dls_Peek(&EntryList[priority]);
+             linkPtr != NULL;
+             linkPtr = le_dls_PeekNext(&EntryList[priority], linkPtr))
+        {
+            entryPtr = CONTAINER_OF(linkPtr, Entry_t, link);
+            entryPtr->offset = offset;
+            offset += entryPtr->recordNumBytes;
+        }
+    }
+
+    LE_DEBUG("Compacted %s from %d to %d bytes", QueuePath, (int)QueueSize, (int)offset);
+
+    QueueSize = offset;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reclaim the space of the obsolete records: the queue file is truncated when the queue is empty,
+ * and compacted when it is mostly made of obsolete records.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReclaimSpace
+(
+    void
+)
+{
+    size_t deadNumBytes = QueueSize - LiveNumBytes;
+
+    if (NumEntries == 0)
+    {
+        if (QueueSize != 0)
+        {
+            if (ftruncate(QueueFd, 0) == -1)
+            {
+                LE_ERROR("Failed to truncate %s: %m", QueuePath);
+                return;
+            }
+            QueueSize = 0;
+        }
+    }
+    else if ((deadNumBytes > COMPACT_MIN_DEAD_NUMBYTES) && (deadNumBytes > LiveNumBytes))
+    {
+        CompactQueue();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Interface functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the push queue, reloading the notifications queued before a restart.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the queue file can't be opened
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pushQueue_Init
+(
+    const char* pathPtr,            ///< [IN] Path of the queue file
+    size_t maxNumBytes              ///< [IN] Maximum number of bytes of queued notifications
+)
+{
+    int priority;
+
+    LE_ASSERT(QueueFd == -1);
+
+    if ((le_utf8_Copy(QueuePath, pathPtr, sizeof(QueuePath), NULL) != LE_OK) ||
+        (le_utf8_Copy(TmpPath, pathPtr, sizeof(TmpPath), NULL) != LE_OK) ||
+        (le_utf8_Append(TmpPath, ".tmp", sizeof(TmpPath), NULL) != LE_OK))
+    {
+        LE_ERROR("Path too long: %s", pathPtr);
+        return LE_FAULT;
+    }
+
+    if (EntryPoolRef == NULL)
+    {
+        EntryPoolRef = le_mem_CreatePool("Push queue entry pool", sizeof(Entry_t));
+        EntryMap = le_hashmap_Create("Push queue entry map",
+                                     ENTRY_MAP_SIZE,
+                                     le_hashmap_HashUInt32,
+                                     le_hashmap_EqualsUInt32);
+    }
+
+    for (priority = 0; priority < PUSHQUEUE_NUM_PRIORITIES; priority++)
+    {
+        EntryList[priority] = LE_DLS_LIST_INIT;
+    }
+    NumEntries = 0;
+    LiveNumBytes = 0;
+    MaxLiveNumBytes = maxNumBytes;
+    NextId = 1;
+    BootId = ReadBootId();
+
+    QueueFd = open(QueuePath, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (QueueFd == -1)
+    {
+        LE_ERROR("Failed to open %s: %m", QueuePath);
+        return LE_FAULT;
+    }
+
+    ReplayQueue();
+    ReclaimSpace();
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the push queue. The queued notifications are kept in the queue file.
+ */
+//--------------------------------------------------------------------------------------------------
+void pushQueue_Close
+(
+    void
+)
+{
+    Entry_t* entryPtr;
+
+    if (QueueFd == -1)
+    {
+        return;
+    }
+
+    while ((entryPtr = GetHighestEntry()) != NULL)
+    {
+        RemoveEntry(entryPtr);
+    }
+
+    close(QueueFd);
+    QueueFd = -1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a notification at the end of the queue. It is written to flash before the function returns.
+ *
+ * When the queue is full, the oldest notifications of a priority lower than or equal to the new
+ * one are dropped to make room for it.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the notification is too large
+ *      - LE_NO_MEMORY if the queue is full of higher priority notifications
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pushQueue_Add
+(
+    const pushQueue_Notification_t* notificationPtr     ///< [IN] Notification to queue
+)
+{
+    RecordHeader_t* headerPtr = (RecordHeader_t*)RecordBuf;
+    NotificationRecord_t* recordPtr = (NotificationRecord_t*)(RecordBuf + sizeof(RecordHeader_t));
+    size_t appNameLength = strlen(notificationPtr->appNamePtr);
+    size_t recordNumBytes;
+    Entry_t* entryPtr;
+    off_t offset;
+
+    if (QueueFd == -1)
+    {
+        LE_ERROR("Push queue not available.");
+        return LE_FAULT;
+    }
+
+    LE_ASSERT(notificationPtr->priority < PUSHQUEUE_NUM_PRIORITIES);
+
+    recordNumBytes = sizeof(RecordHeader_t) + sizeof(NotificationRecord_t) + appNameLength +
+                     notificationPtr->payloadNumBytes;
+
+    if ((appNameLength > MAX_APP_NAME_NUMBYTES) ||
+        (notificationPtr->tokenLength > PUSHQUEUE_MAX_TOKEN_NUMBYTES) ||
+        (notificationPtr->payloadNumBytes > PUSHQUEUE_MAX_PAYLOAD_NUMBYTES) ||
+        (recordNumBytes > MaxLiveNumBytes))
+    {
+        LE_ERROR("Notification too large to be queued.");
+        return LE_OVERFLOW;
+    }
+
+    if ((LiveNumBytes + recordNumBytes) > MaxLiveNumBytes)
+    {
+        DropExpiredEntries();
+    }
+
+    while ((LiveNumBytes + recordNumBytes) > MaxLiveNumBytes)
+    {
+        entryPtr = GetLowestEntry(notificationPtr->priority);
+        if (entryPtr == NULL)
+        {
+            LE_WARN("Push queue full of higher priority notifications.");
+            return LE_NO_MEMORY;
+        }
+
+        LE_WARN("Push queue full, dropping notification %"PRIu32, entryPtr->id);
+        DropEntry(entryPtr);
+    }
+
+    memset(RecordBuf, 0, sizeof(RecordHeader_t) + sizeof(NotificationRecord_t));
+
+    headerPtr->type = RECORD_NOTIFICATION;
+    headerPtr->length = recordNumBytes - sizeof(RecordHeader_t);
+    headerPtr->id = NextId;
+
+    recordPtr->expiry = (notificationPtr->timeToLive == 0) ? 0 :
+                        GetTime() + notificationPtr->timeToLive;
+    recordPtr->bootId = BootId;
+    recordPtr->timeToLive = notificationPtr->timeToLive;
+    recordPtr->assetId = notificationPtr->assetId;
+    recordPtr->contentType = notificationPtr->contentType;
+    recordPtr->priority = notificationPtr->priority;
+    recordPtr->tokenLength = notificationPtr->tokenLength;
+    memcpy(recordPtr->token, notificationPtr->tokenPtr, notificationPtr->tokenLength);
+    recordPtr->appNameLength = appNameLength;
+
+    memcpy(recordPtr + 1, notificationPtr->appNamePtr, appNameLength);
+    memcpy((uint8_t*)(recordPtr + 1) + appNameLength,
+           notificationPtr->payloadPtr,
+           notificationPtr->payloadNumBytes);
+
+    if (AppendRecord(RecordBuf, true, &offset) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    CreateEntry(headerPtr, recordPtr, recordPtr->expiry, offset);
+
+    LE_DEBUG("Queued notification %"PRIu32" of %s/%d (%zu bytes)",
+             headerPtr->id, notificationPtr->appNamePtr, notificationPtr->assetId,
+             notificationPtr->payloadNumBytes);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of queued notifications.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t pushQueue_GetCount
+(
+    void
+)
+{
+    return NumEntries;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a batch of queued notifications to the server, highest priority first and oldest first
+ * within a priority. Expired notifications are dropped.
+ *
+ * @return
+ *      - Number of notifications still queued
+ */
+//--------------------------------------------------------------------------------------------------
+size_t pushQueue_Send
+(
+    size_t maxNumNotifications      ///< [IN] Maximum number of notifications to send
+)
+{
+    RecordHeader_t* headerPtr = (RecordHeader_t*)RecordBuf;
+    NotificationRecord_t* recordPtr = (NotificationRecord_t*)(RecordBuf + sizeof(RecordHeader_t));
+    char appName[MAX_APP_NAME_NUMBYTES + 1];
+    uint8_t* payloadPtr;
+    size_t numSent = 0;
+    uint64_t now = GetTime();
+    pa_avc_LWM2MOperationDataRef_t opRef;
+    Entry_t* entryPtr;
+
+    while ((numSent < maxNumNotifications) && ((entryPtr = GetHighestEntry()) != NULL))
+    {
+        if ((entryPtr->expiry != 0) && (entryPtr->expiry <= now))
+        {
+            LE_INFO("Dropping expired notification %"PRIu32, entryPtr->id);
+            DropEntry(entryPtr);
+            continue;
+        }
+
+        if ((ReadRecord(entryPtr->offset) != LE_OK) || (headerPtr->id != entryPtr->id))
+        {
+            LE_ERROR("Dropping corrupted notification %"PRIu32, entryPtr->id);
+            DropEntry(entryPtr);
+            continue;
+        }
+
+        memcpy(appName, recordPtr + 1, recordPtr->appNameLength);
+        appName[recordPtr->appNameLength] = '\0';
+        payloadPtr = (uint8_t*)(recordPtr + 1) + recordPtr->appNameLength;
+
+        opRef = pa_avc_CreateOpData(appName,
+                                    recordPtr->assetId,
+                                    -1,
+                                    -1,
+                                    PA_AVC_OPTYPE_NOTIFY,
+                                    recordPtr->contentType,
+                                    recordPtr->token,
+                                    recordPtr->tokenLength);
+
+        pa_avc_NotifyChange(opRef,
+                            payloadPtr,
+                            headerPtr->length - sizeof(NotificationRecord_t) -
+                            recordPtr->appNameLength);
+
+        LE_DEBUG("Sent queued notification %"PRIu32, entryPtr->id);
+
+        DropEntry(entryPtr);
+        numSent++;
+    }
+
+    ReclaimSpace();
+
+    return NumEntries;
+}
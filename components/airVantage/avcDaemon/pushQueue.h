@@ -0,0 +1,152 @@
+/**
+ * @file pushQueue.h
+ *
+ * Interface for the push queue: the notifications that can't be sent to the AirVantage server
+ * because there is no session are kept on flash, and sent once a session is available.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef LEGATO_PUSH_QUEUE_INCLUDE_GUARD
+#define LEGATO_PUSH_QUEUE_INCLUDE_GUARD
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+// Definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a queued payload
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSHQUEUE_MAX_PAYLOAD_NUMBYTES (32 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of the token of a queued notification
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSHQUEUE_MAX_TOKEN_NUMBYTES 8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Priority of a queued notification. Higher priority notifications are sent first, and lower
+ * priority ones are dropped first when the queue is full. Notifications of the same priority are
+ * sent in the order they were queued.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PUSHQUEUE_PRIORITY_LOW,         ///< Value change notification.
+    PUSHQUEUE_PRIORITY_HIGH,        ///< Time series, which can't be recorded again.
+    PUSHQUEUE_NUM_PRIORITIES
+}
+pushQueue_Priority_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notification to be queued
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* appNamePtr;             ///< App containing the asset.
+    int assetId;                        ///< Asset id within the app.
+    uint16_t contentType;               ///< Encoding of the payload.
+    const uint8_t* tokenPtr;            ///< Observe token.
+    uint8_t tokenLength;                ///< Number of bytes in tokenPtr.
+    const uint8_t* payloadPtr;          ///< Payload.
+    size_t payloadNumBytes;             ///< Number of bytes in payloadPtr.
+    pushQueue_Priority_t priority;      ///< Priority.
+    uint32_t timeToLive;                ///< Seconds after which the notification is dropped, or
+                                        ///  0 if it never is. It restarts after a reboot.
+}
+pushQueue_Notification_t;
+
+
+//--------------------------------------------------------------------------------------------------
+// Interface functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the push queue, reloading the notifications queued before a restart.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the queue file can't be opened
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pushQueue_Init
+(
+    const char* pathPtr,            ///< [IN] Path of the queue file
+    size_t maxNumBytes              ///< [IN] Maximum number of bytes of queued notifications
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the push queue. The queued notifications are kept in the queue file.
+ */
+//--------------------------------------------------------------------------------------------------
+void pushQueue_Close
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a notification at the end of the queue. It is written to flash before the function returns.
+ *
+ * When the queue is full, the oldest notifications of a priority lower than or equal to the new
+ * one are dropped to make room for it.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the notification is too large
+ *      - LE_NO_MEMORY if the queue is full of higher priority notifications
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pushQueue_Add
+(
+    const pushQueue_Notification_t* notificationPtr     ///< [IN] Notification to queue
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of queued notifications.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t pushQueue_GetCount
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a batch of queued notifications to the server, highest priority first and oldest first
+ * within a priority. Expired notifications are dropped.
+ *
+ * @return
+ *      - Number of notifications still queued
+ */
+//--------------------------------------------------------------------------------------------------
+size_t pushQueue_Send
+(
+    size_t maxNumNotifications      ///< [IN] Maximum number of notifications to send
+);
+
+
+#endif // LEGATO_PUSH_QUEUE_INCLUDE_GUARD
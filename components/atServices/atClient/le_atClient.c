@@ -105,6 +105,13 @@
 //--------------------------------------------------------------------------------------------------
 #define UNSOLICITED_POOL_SIZE 10
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited matcher node pool size
+ */
+//--------------------------------------------------------------------------------------------------
+#define UNSOLICITED_NODE_POOL_SIZE 64
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Rx Buffer length
@@ -241,7 +248,7 @@ RxParser_t;
  *
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct Unsolicited
 {
     le_atClient_UnsolicitedResponseHandlerFunc_t handlerPtr;    ///< Unsolicited handler
     void*         contextPtr;                                   ///< User context
@@ -254,9 +261,30 @@ typedef struct
     DeviceContextPtr_t interfacePtr;                            ///< device context
     le_dls_Link_t link;                                         ///< link in Unsolicited List
     le_msg_SessionRef_t sessionRef;                             ///< client session reference
+    uint32_t      order;                                        ///< position in Unsolicited List
+    struct Unsolicited* nextSamePtr;                            ///< next subscription with the
+                                                                ///< same pattern
+    le_dls_Link_t inProgressLink;                               ///< link in In Progress List
 }
 Unsolicited_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited matcher node structure.
+ *
+ * The subscribed patterns are compiled in a trie, so that a received line is matched against all
+ * of them in a single pass over its first characters.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct UnsolNode
+{
+    char                character;      ///< character leading to this node
+    struct UnsolNode*   childPtr;       ///< first node for the next character
+    struct UnsolNode*   siblingPtr;     ///< next node for the same character position
+    Unsolicited_t*      firstPtr;       ///< first subscription whose pattern ends here
+}
+UnsolNode_t;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -274,6 +302,10 @@ typedef struct DeviceContext
     le_timer_Ref_t  timerRef;           ///< command timer
     le_dls_List_t   atCommandList;      ///< List of command waiting for execution
     le_dls_List_t   unsolicitedList;    ///< unsolicited command list
+    le_dls_List_t   inProgressList;     ///< unsolicited responses being received
+    UnsolNode_t*    unsolRootPtr;       ///< matcher built from unsolicitedList
+    bool            isUnsolStale;       ///< matcher has to be rebuilt
+    uint32_t        unsolCount;         ///< subscriptions in the matcher
     le_sem_Ref_t    waitingSemaphore;   ///< semaphore used for synchronization
     le_atClient_DeviceRef_t ref;        ///< reference of the device context
     le_msg_SessionRef_t sessionRef;     ///< client session reference
@@ -338,6 +370,13 @@ static le_mem_PoolRef_t  RspStringPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t  UnsolicitedPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for unsolicited matcher nodes
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t  UnsolNodePool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Map for AT commands
@@ -372,73 +411,321 @@ static void UpdateTransitionManager(ClientStatePtr_t  parserStatePtr,
 static void SendLine(RxParserPtr_t charParserPtr);
 static void SendData(RxParserPtr_t charParserPtr);
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function releases the unsolicited matcher nodes.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseUnsolNodes
+(
+    UnsolNode_t* nodePtr
+)
+{
+    while (nodePtr != NULL)
+    {
+        UnsolNode_t* siblingPtr = nodePtr->siblingPtr;
+
+        ReleaseUnsolNodes(nodePtr->childPtr);
+        le_mem_Release(nodePtr);
+
+        nodePtr = siblingPtr;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function allocates an unsolicited matcher node.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static UnsolNode_t* CreateUnsolNode
+(
+    char character
+)
+{
+    UnsolNode_t* nodePtr = le_mem_ForceAlloc(UnsolNodePool);
+
+    memset(nodePtr, 0, sizeof(UnsolNode_t));
+    nodePtr->character = character;
+
+    return nodePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function returns the child of a matcher node for the given character, or NULL.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static UnsolNode_t* GetUnsolChild
+(
+    UnsolNode_t* nodePtr,
+    char character
+)
+{
+    UnsolNode_t* childPtr = nodePtr->childPtr;
+
+    while ((childPtr != NULL) && (childPtr->character != character))
+    {
+        childPtr = childPtr->siblingPtr;
+    }
+
+    return childPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function rebuilds the unsolicited matcher of a device from its subscription list.
+ *
+ * It is called by the device thread before matching a line, when subscriptions were added or
+ * removed since the last build.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildUnsolMatcher
+(
+    DeviceContext_t* interfacePtr
+)
+{
+    uint32_t order = 0;
+
+    ReleaseUnsolNodes(interfacePtr->unsolRootPtr);
+    interfacePtr->unsolRootPtr = CreateUnsolNode('\0');
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&interfacePtr->unsolicitedList);
+
+    while (linkPtr != NULL)
+    {
+        Unsolicited_t* unsolPtr = CONTAINER_OF(linkPtr, Unsolicited_t, link);
+        UnsolNode_t* nodePtr = interfacePtr->unsolRootPtr;
+        const char* charPtr;
+
+        for (charPtr = unsolPtr->unsolRsp; *charPtr != '\0'; charPtr++)
+        {
+            UnsolNode_t* childPtr = GetUnsolChild(nodePtr, *charPtr);
+
+            if (childPtr == NULL)
+            {
+                childPtr = CreateUnsolNode(*charPtr);
+                childPtr->siblingPtr = nodePtr->childPtr;
+                nodePtr->childPtr = childPtr;
+            }
+
+            nodePtr = childPtr;
+        }
+
+        // Keep the subscriptions with the same pattern in list order.
+        Unsolicited_t** lastPtrPtr = &nodePtr->firstPtr;
+
+        while (*lastPtrPtr != NULL)
+        {
+            lastPtrPtr = &(*lastPtrPtr)->nextSamePtr;
+        }
+
+        *lastPtrPtr = unsolPtr;
+        unsolPtr->nextSamePtr = NULL;
+        unsolPtr->order = order++;
+
+        linkPtr = le_dls_PeekNext(&interfacePtr->unsolicitedList, linkPtr);
+    }
+
+    interfacePtr->unsolCount = order;
+    interfacePtr->isUnsolStale = false;
+
+    LE_DEBUG("Unsolicited matcher built with %d patterns", order);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function adds a received line to a matching, or in progress, unsolicited response and
+ * calls its handler when all its lines are received.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessUnsolicited
+(
+    DeviceContext_t* interfacePtr,
+    Unsolicited_t* unsolPtr,
+    char* unsolRspPtr,
+    size_t stringSize
+)
+{
+    LE_DEBUG("unsol found");
+    uint32_t len =
+        (stringSize < LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer)) ?
+        stringSize :
+        LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer);
+
+    strncpy(unsolPtr->unsolBuffer+strlen(unsolPtr->unsolBuffer), unsolRspPtr, len);
+
+    if (!unsolPtr->inProgress)
+    {
+        unsolPtr->inProgress = true;
+        le_dls_Queue(&interfacePtr->inProgressList, &unsolPtr->inProgressLink);
+    }
+
+    if ( (unsolPtr->lineCount - unsolPtr->lineCounter) == 1 )
+    {
+        unsolPtr->handlerPtr(unsolPtr->unsolBuffer, unsolPtr->contextPtr );
+        memset(unsolPtr->unsolBuffer,0,LE_ATDEFS_UNSOLICITED_MAX_BYTES);
+        unsolPtr->lineCounter = 0;
+        unsolPtr->inProgress = false;
+        le_dls_Remove(&interfacePtr->inProgressList, &unsolPtr->inProgressLink);
+    }
+    else
+    {
+        if (LE_ATDEFS_UNSOLICITED_MAX_LEN - strlen(unsolPtr->unsolBuffer) >= 2)
+        {
+            snprintf( unsolPtr->unsolBuffer+strlen(unsolPtr->unsolBuffer),
+           LE_ATDEFS_UNSOLICITED_MAX_BYTES,
+            "\r\n" );
+        }
+
+        unsolPtr->lineCounter++;
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is used to check if the received data matches with a subscribed unsolicited
  * response.
  *
+ * The line is walked down the matcher trie once, whatever the number of subscriptions. The
+ * matching subscriptions and the ones already in progress are then processed in subscription
+ * order.
+ *
  */
 //--------------------------------------------------------------------------------------------------
 static void CheckUnsolicited
 (
+    DeviceContext_t* interfacePtr,
     char* unsolRspPtr,
-    size_t stringSize,
-    le_dls_List_t *unsolListPtr
+    size_t stringSize
 )
 {
     LE_DEBUG("Start checking unsolicited");
 
-    le_dls_Link_t* linkPtr = le_dls_Peek(unsolListPtr);
+    if (interfacePtr->isUnsolStale)
+    {
+        BuildUnsolMatcher(interfacePtr);
+    }
 
-    /* Browse all the queue while the string is not found */
-    while (linkPtr != NULL)
+    if ((interfacePtr->unsolRootPtr == NULL) || (interfacePtr->unsolCount == 0))
     {
-        Unsolicited_t *unsolPtr = CONTAINER_OF(linkPtr,
-                                               Unsolicited_t,
-                                                link);
+        return;
+    }
 
-        if ((strncmp(unsolPtr->unsolRsp,unsolRspPtr,strlen(unsolPtr->unsolRsp)) == 0) ||
-            (unsolPtr->inProgress))
-        {
-            LE_DEBUG("unsol found");
-            uint32_t len =
-                (stringSize < LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer)) ?
-                stringSize :
-                LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer);
+    Unsolicited_t* matchPtr[interfacePtr->unsolCount];
+    uint32_t matchCount = 0;
+    uint32_t i, j;
 
-            strncpy(unsolPtr->unsolBuffer+strlen(unsolPtr->unsolBuffer), unsolRspPtr, len);
+    // Subscriptions receiving a multi-line response take every line.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&interfacePtr->inProgressList);
 
-            unsolPtr->inProgress = true;
-        }
+    while (linkPtr != NULL)
+    {
+        matchPtr[matchCount++] = CONTAINER_OF(linkPtr, Unsolicited_t, inProgressLink);
+        linkPtr = le_dls_PeekNext(&interfacePtr->inProgressList, linkPtr);
+    }
+
+    // Collect the subscriptions whose pattern is a prefix of the line.
+    UnsolNode_t* nodePtr = interfacePtr->unsolRootPtr;
+    size_t pos = 0;
 
-        if (unsolPtr->inProgress)
+    while (nodePtr != NULL)
+    {
+        Unsolicited_t* unsolPtr;
+
+        for (unsolPtr = nodePtr->firstPtr; unsolPtr != NULL; unsolPtr = unsolPtr->nextSamePtr)
         {
-            if ( (unsolPtr->lineCount - unsolPtr->lineCounter) == 1 )
+            if (!unsolPtr->inProgress)
             {
-                unsolPtr->handlerPtr(unsolPtr->unsolBuffer, unsolPtr->contextPtr );
-                memset(unsolPtr->unsolBuffer,0,LE_ATDEFS_UNSOLICITED_MAX_BYTES);
-                unsolPtr->lineCounter = 0;
-                unsolPtr->inProgress = false;
+                matchPtr[matchCount++] = unsolPtr;
             }
-            else
-            {
-                if (LE_ATDEFS_UNSOLICITED_MAX_LEN - strlen(unsolPtr->unsolBuffer) >= 2)
-                {
-                    snprintf( unsolPtr->unsolBuffer+strlen(unsolPtr->unsolBuffer),
-                   LE_ATDEFS_UNSOLICITED_MAX_BYTES,
-                    "\r\n" );
-                }
+        }
 
-                unsolPtr->lineCounter++;
-            }
+        if (pos >= stringSize)
+        {
+            break;
         }
 
-        linkPtr = le_dls_PeekNext(unsolListPtr, linkPtr);
+        nodePtr = GetUnsolChild(nodePtr, unsolRspPtr[pos++]);
+    }
+
+    // Sort in subscription order; there are only a few matches, so an insertion sort is fine.
+    for (i = 1; i < matchCount; i++)
+    {
+        Unsolicited_t* unsolPtr = matchPtr[i];
+
+        for (j = i; (j > 0) && (matchPtr[j-1]->order > unsolPtr->order); j--)
+        {
+            matchPtr[j] = matchPtr[j-1];
+        }
+
+        matchPtr[j] = unsolPtr;
+    }
+
+    for (i = 0; i < matchCount; i++)
+    {
+        ProcessUnsolicited(interfacePtr, matchPtr[i], unsolRspPtr, stringSize);
     }
 
     LE_DEBUG("Stop checking unsolicited");
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function returns the index of the first CR, LF or PROMPT character of the Rx buffer found
+ * between idx and endIdx, or endIdx if there is none.
+ *
+ * The buffer is scanned a 64-bit word at a time, each byte of the word being compared to the
+ * three characters at once.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t FindEventChar
+(
+    const uint8_t* bufferPtr,
+    int32_t        idx,
+    int32_t        endIdx
+)
+{
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+
+// A byte of x is zero if, and only if, the corresponding high bit of the result is set.
+#define HAS_ZERO_BYTE(x) (((x) - ones) & ~(x) & highs)
+
+    while (idx + (int32_t)sizeof(uint64_t) <= endIdx)
+    {
+        uint64_t word;
+
+        memcpy(&word, bufferPtr + idx, sizeof(word));
+
+        if ( HAS_ZERO_BYTE(word ^ (ones * '\r')) ||
+             HAS_ZERO_BYTE(word ^ (ones * '\n')) ||
+             HAS_ZERO_BYTE(word ^ (ones * '>')) )
+        {
+            break;
+        }
+
+        idx += sizeof(uint64_t);
+    }
+
+#undef HAS_ZERO_BYTE
+
+    while ( (idx < endIdx) &&
+            (bufferPtr[idx] != '\r') &&
+            (bufferPtr[idx] != '\n') &&
+            (bufferPtr[idx] != '>') )
+    {
+        idx++;
+    }
+
+    return idx;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to get the next event to send to the Rx parser
@@ -505,6 +792,11 @@ static bool GetNextEvent
         }
         else
         {
+            // The parser does the same for a run of characters as for a single one, so skip the
+            // run up to the next CRLF or PROMPT.
+            charParserPtr->rxData.idx = FindEventChar(charParserPtr->rxData.buffer,
+                                                      charParserPtr->rxData.idx,
+                                                      charParserPtr->rxData.endBuffer);
             *evPtr = PARSER_CHAR;
             return true;
         }
@@ -550,16 +842,15 @@ static void ResetRxBuffer
 {
     if (rxParserPtr->curState == ProcessingState)
     {
-        size_t idx,sizeToCopy;
+        size_t sizeToCopy;
         sizeToCopy = rxParserPtr->rxData.endBuffer-rxParserPtr->rxData.idxLastCrLf+2;
 
         LE_DEBUG("%d sizeToCopy %zd from %d",
                             rxParserPtr->rxData.idx,sizeToCopy,rxParserPtr->rxData.idxLastCrLf-2);
 
-        for (idx = 0; idx < sizeToCopy; idx++) {
-            rxParserPtr->rxData.buffer[idx] =
-                                rxParserPtr->rxData.buffer[idx+rxParserPtr->rxData.idxLastCrLf-2];
-        }
+        memmove(rxParserPtr->rxData.buffer,
+                rxParserPtr->rxData.buffer+rxParserPtr->rxData.idxLastCrLf-2,
+                sizeToCopy);
 
         rxParserPtr->rxData.idxLastCrLf = 2;
         rxParserPtr->rxData.endBuffer = sizeToCopy;
@@ -664,6 +955,9 @@ static void DestroyDeviceThread
         le_mem_Release(unsolPtr);
     }
 
+    ReleaseUnsolNodes(interfacePtr->unsolRootPtr);
+    interfacePtr->unsolRootPtr = NULL;
+
     while ((linkPtr=le_dls_Pop(&interfacePtr->atCommandList)) != NULL)
     {
         AtCmd_t* atCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
@@ -1025,9 +1319,9 @@ static void WaitingState
             int32_t newCRLF = parserPtr->idx-2;
             size_t lineSize = newCRLF - parserPtr->idxLastCrLf;
 
-            CheckUnsolicited((char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]),
-                              lineSize,
-                              &interfacePtr->unsolicitedList);
+            CheckUnsolicited(interfacePtr,
+                             (char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]),
+                             lineSize);
             break;
         }
         default:
@@ -1268,6 +1562,17 @@ static void UnsolicitedPoolDestructor
     {
         le_dls_Remove(listPtr, linkPtr);
     }
+
+    listPtr = &unsolicitedPtr->interfacePtr->inProgressList;
+    linkPtr = &unsolicitedPtr->inProgressLink;
+
+    if ( le_dls_IsInList(listPtr, linkPtr) )
+    {
+        le_dls_Remove(listPtr, linkPtr);
+    }
+
+    // The matcher still refers to this subscription; rebuild it before the next match.
+    unsolicitedPtr->interfacePtr->isUnsolStale = true;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2027,10 +2332,14 @@ le_atClient_UnsolicitedResponseHandlerRef_t le_atClient_AddUnsolicitedResponseHa
     unsolicitedPtr->ref = le_ref_CreateRef(UnsolRefMap, unsolicitedPtr);
     unsolicitedPtr->interfacePtr = interfacePtr;
     unsolicitedPtr->link = LE_DLS_LINK_INIT;
+    unsolicitedPtr->inProgressLink = LE_DLS_LINK_INIT;
     unsolicitedPtr->sessionRef = le_atClient_GetClientSessionRef();
 
     le_dls_Queue(&interfacePtr->unsolicitedList, &unsolicitedPtr->link);
 
+    // The matcher is rebuilt by the device thread before the next match.
+    interfacePtr->isUnsolStale = true;
+
     return unsolicitedPtr->ref;
 }
 
@@ -2233,6 +2542,10 @@ COMPONENT_INIT
     le_mem_SetDestructor(UnsolicitedPool,UnsolicitedPoolDestructor);
     UnsolRefMap = le_ref_CreateMap("UnsolRefMap", UNSOLICITED_POOL_SIZE);
 
+    // Unsolicited matcher node pool allocation
+    UnsolNodePool = le_mem_CreatePool("AtUnsolNodePool",sizeof(UnsolNode_t));
+    le_mem_ExpandPool(UnsolNodePool,UNSOLICITED_NODE_POOL_SIZE);
+
     // Add a handler to the close session service
     le_msg_AddServiceCloseHandler(
         le_atClient_GetServiceRef(), CloseSessionEventHandler, NULL);
@@ -895,7 +895,12 @@ static void RemoveStreamEventHandler
         }
 
         LE_DEBUG("dtmfDetectionHandlerCount %d", dtmfDetectionHandlerCount);
-        if (dtmfDetectionHandlerCount == 1)
+        if ((dtmfDetectionHandlerCount == 1) &&
+            (streamPtr->audioInterface == LE_AUDIO_IF_DSP_FRONTEND_FILE_CAPTURE))
+        {
+            le_media_StopDtmfDetector(streamPtr);
+        }
+        else if (dtmfDetectionHandlerCount == 1)
         {
             pa_audio_StopDtmfDecoder(streamPtr);
 
@@ -1979,8 +1984,17 @@ le_audio_DtmfDetectorHandlerRef_t le_audio_AddDtmfDetectorHandler
         return NULL;
     }
 
+    // The DTMFs of a recorder stream are detected by software on the captured samples
+    if (streamPtr->audioInterface == LE_AUDIO_IF_DSP_FRONTEND_FILE_CAPTURE)
+    {
+        if (le_media_StartDtmfDetector(streamPtr) != LE_OK)
+        {
+            LE_ERROR("Cannot start DTMF detection!");
+            return NULL;
+        }
+    }
     // Register a handler function for Dtmf streams events
-    if (streamPtr->dtmfEventHandler == NULL)
+    else if (streamPtr->dtmfEventHandler == NULL)
     {
         streamPtr->dtmfEventHandler = pa_audio_AddDtmfStreamEventHandler(DtmfStreamEventHandler,
                                                                      streamPtr);
@@ -3191,7 +3205,8 @@ le_result_t le_audio_GetSamplePcmSamplingResolution
  * This function must be called to play a DTMF on a specific audio stream.
  *
  * @return LE_FORMAT_ERROR  The DTMF characters are invalid.
- * @return LE_BUSY          A DTMF playback is already in progress on the playback stream.
+ * @return LE_BUSY          A DTMF playback is already in progress on the playback stream, or
+ *                          the DTMFs can't be mixed with the samples played on the stream.
  * @return LE_FAULT         The function failed to play the DTMFs.
  * @return LE_OK            The funtion succeeded.
  *
@@ -3216,7 +3231,9 @@ le_result_t le_audio_PlayDtmf
         return LE_BAD_PARAMETER;
     }
 
-    if ( le_media_IsStreamBusy(streamPtr) )
+    // DTMFs can be mixed over the samples played on a player stream
+    if ( (streamPtr->audioInterface != LE_AUDIO_IF_DSP_FRONTEND_FILE_PLAY) &&
+         le_media_IsStreamBusy(streamPtr) )
     {
         return LE_BUSY;
     }
@@ -41,6 +41,30 @@ le_audio_SampleAmrConfig_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct pcm_Handle* pcm_Handle_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Software mixer opaque handle declaration
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_mixer* le_mixer_Ref_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mixer input opaque handle declaration
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_mixer_Input* le_mixer_InputRef_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Software DTMF detector opaque handle declaration
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_media_DtmfDetector* le_media_DtmfDetectorRef_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reference type used by Add/Remove functions for EVENT 'le_audio_StreamEvent'
@@ -87,6 +111,9 @@ typedef struct {
     le_audio_If_t               interface;        ///< audio interface
     bool                        pause;            ///< pause in capture
     le_audio_MediaEvent_t       mediaEvent;       ///< media event to be sent
+    le_mixer_Ref_t              mixerRef;         ///< software mixer feeding the playback
+    le_mixer_InputRef_t         dtmfInputRef;     ///< DTMFs mixed over the playback, until their
+                                                  ///  end is reported
 }
 le_audio_PcmContext_t;
 
@@ -200,6 +227,8 @@ typedef struct le_audio_Stream {
     le_audio_PcmContext_t* pcmContextPtr;              ///< PCM playback/capture context
     le_audio_MediaThreadContext_t* mediaThreadContextPtr;///< Read Media thread
     le_audio_DtmfStreamEventHandlerRef_t dtmfEventHandler; ///< Dtmf stream event handler
+    le_media_DtmfDetectorRef_t dtmfDetectorRef;        ///< Software DTMF detector of a capture
+                                                       ///  stream
     le_thread_Ref_t     mediaThreadRef;                 ///< Media thread reference
     bool                playFile;                      ///< Stream plays a file
     int8_t              deviceIdentifier;              ///< Device identifier
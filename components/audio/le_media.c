@@ -12,6 +12,7 @@
 #include "interfaces.h"
 #include "le_audio_local.h"
 #include "le_media_local.h"
+#include "le_mixer_local.h"
 #include "pa_audio.h"
 #include "pa_amr.h"
 #include "pa_pcm.h"
@@ -39,6 +40,31 @@
 #define PI 3.14159265358979323846264338327
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fixed-point formats of the DTMF oscillators: the 2*cos(w) coefficient is a Q29 value, and the
+ * oscillator state keeps OSCILLATOR_STATE_SHIFT fractional bits below the 16-bit sample value.
+ */
+//--------------------------------------------------------------------------------------------------
+#define OSCILLATOR_COEF_SHIFT   29
+#define OSCILLATOR_STATE_SHIFT  14
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Values used for DTMF detection. The captured samples are analyzed in blocks of
+ * DTMF_BLOCK_SIZE_8K samples at 8kHz (12.75ms), scaled with the sample rate. The power measured at
+ * each DTMF frequency is normalized so that a sine wave at that frequency gives 1.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DTMF_FREQ_NB            8
+#define DTMF_BLOCK_SIZE_8K      102
+#define DTMF_TONE_THRESHOLD     0.15f               ///< Minimum normalized power of each tone
+#define DTMF_SUM_THRESHOLD      0.6f                ///< Minimum normalized power of both tones
+#define DTMF_TWIST_RATIO        6.3f                ///< Maximum power ratio of both tones (8dB)
+#define DTMF_PEAK_RATIO         6.3f                ///< Minimum power ratio between a tone and
+                                                    ///  the other frequencies of its group (8dB)
+#define DTMF_MIN_POWER          (200.0f * 200.0f)   ///< Minimum mean power of the samples
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Symbols used to populate wave header file.
@@ -89,9 +115,47 @@ typedef struct
     bool           playPause;  ///< Play the pause
     char           dtmf[LE_AUDIO_DTMF_MAX_BYTES];    ///< The DTMFs to play.
     uint32_t       currentDtmf;///< Index of the play dtmf
+    le_mixer_InputRef_t mixerInputRef; ///< Mixer input when mixed over a playback
 }
 DtmfParams_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF tone oscillator. The sine wave is produced by the recursion
+ * y[n] = 2*cos(w)*y[n-1] - y[n-2], which only needs one multiplication per sample.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int64_t coef;   ///< 2*cos(w), in Q29
+    int32_t y1;     ///< Previous output
+    int32_t y2;     ///< Output before the previous one
+}
+Oscillator_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Software DTMF detector structure. The power of the captured signal at the 8 DTMF frequencies is
+ * measured on each block of samples with the Goertzel algorithm. The filters of the 8 frequencies
+ * are updated together on each sample, so that this loop can be vectorized by the compiler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+struct le_media_DtmfDetector
+{
+    bool     enabled;                  ///< Detection is running
+    uint32_t sampleRate;               ///< Sample rate the filters are configured for
+    uint32_t blockSize;                ///< Number of samples of a block
+    uint32_t sampleCount;              ///< Number of samples analyzed in the current block
+    float    coef[DTMF_FREQ_NB];       ///< Goertzel coefficients 2*cos(w)
+    float    s1[DTMF_FREQ_NB];         ///< Goertzel filters previous output
+    float    s2[DTMF_FREQ_NB];         ///< Goertzel filters output before the previous one
+    float    energy;                   ///< Energy of the current block
+    char     candidate;                ///< DTMF found in the previous block
+    char     lastDigit;                ///< Last reported DTMF, cleared when the DTMF is released
+};
+
 //--------------------------------------------------------------------------------------------------
 /**
  * WAV resource structure.
@@ -124,6 +188,26 @@ ControlOperation_t;
 //                                       Static declarations
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF frequencies: the 4 low (row) frequencies followed by the 4 high (column) frequencies.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint32_t DtmfFrequencies[DTMF_FREQ_NB] =
+{
+    697, 770, 852, 941, 1209, 1336, 1477, 1633
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF characters, indexed by low frequency then high frequency.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char DtmfDigits[DTMF_FREQ_NB/2][DTMF_FREQ_NB/2 + 1] =
+{
+    "123A", "456B", "789C", "*0#D"
+};
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The memory pool for the DTMF parameters
@@ -152,6 +236,13 @@ static le_mem_PoolRef_t MediaThreadContextPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t PcmThreadContextPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for the software DTMF detectors
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DtmfDetectorPool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Wake Lock for audio streams
@@ -401,6 +492,49 @@ static inline int16_t SaturateAdd16
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Initialize an oscillator to produce a sine wave. The two previous outputs are set to the sine
+ *  wave values before the first sample, so that the first sample is 0.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitOscillator
+(
+    Oscillator_t* oscPtr,       ///< [OUT] Oscillator
+    uint32_t      freq,         ///< [IN] Frequency in Hertz
+    uint32_t      sampleRate,   ///< [IN] Sample frequency in Hertz
+    int32_t       amplitude     ///< [IN] Amplitude of the sine wave
+)
+{
+    double w = 2 * PI * freq / sampleRate;
+    double scaledAmplitude = (double)amplitude * (1 << OSCILLATOR_STATE_SHIFT);
+
+    oscPtr->coef = (int64_t)lround(2 * cos(w) * (1 << OSCILLATOR_COEF_SHIFT));
+    oscPtr->y1 = (int32_t)lround(-scaledAmplitude * sin(w));
+    oscPtr->y2 = (int32_t)lround(-scaledAmplitude * sin(2 * w));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Return the next sample of an oscillator. The state is rounded to the nearest sample value, so
+ *  that the rounding errors of the initial state don't turn a zero sample into -1.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline int32_t NextOscillatorSample
+(
+    Oscillator_t* oscPtr        ///< [INOUT] Oscillator
+)
+{
+    int32_t y = (int32_t)((oscPtr->coef * oscPtr->y1) >> OSCILLATOR_COEF_SHIFT) - oscPtr->y2;
+
+    oscPtr->y2 = oscPtr->y1;
+    oscPtr->y1 = y;
+
+    return (y + (1 << (OSCILLATOR_STATE_SHIFT - 1))) >> OSCILLATOR_STATE_SHIFT;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Play Tone function.
@@ -414,7 +548,6 @@ static le_result_t PlayTone
     uint32_t*                      bufferLenPtr  ///< [OUT] Length of the buffer
 )
 {
-    double   d1, d2;
     uint32_t i;
 
     DtmfParams_t*  dtmfParamsPtr = (DtmfParams_t*) mediaCtxPtr->codecParams;
@@ -423,6 +556,8 @@ static le_result_t PlayTone
     uint32_t freq2;
     int32_t  amp1;
     int32_t  amp2;
+    Oscillator_t osc1;
+    Oscillator_t osc2;
     uint16_t* dataPtr = (uint16_t*) bufferOutPtr;
 
     if (dtmfParamsPtr->playPause)
@@ -464,16 +599,14 @@ static le_result_t PlayTone
             return LE_FAULT;
         }
 
-        d1 = 1.0f * freq1 / dtmfParamsPtr->sampleRate;
-        d2 = 1.0f * freq2 / dtmfParamsPtr->sampleRate;
+        // Only the oscillators initialization uses floating point, the samples are then
+        // computed in fixed point
+        InitOscillator(&osc1, freq1, dtmfParamsPtr->sampleRate, SAMPLE_SCALE * amp1 / 100);
+        InitOscillator(&osc2, freq2, dtmfParamsPtr->sampleRate, SAMPLE_SCALE * amp2 / 100);
 
         for (i=0; i<samplesCount; i++)
         {
-            int16_t s1, s2;
-
-            s1 = (int16_t)(SAMPLE_SCALE * amp1 / 100.0f * sin(2 * PI * d1 * i));
-            s2 = (int16_t)(SAMPLE_SCALE * amp2 / 100.0f * sin(2 * PI * d2 * i));
-            dataPtr[i] = SaturateAdd16(s1, s2);
+            dataPtr[i] = SaturateAdd16(NextOscillatorSample(&osc1), NextOscillatorSample(&osc2));
         }
     }
 
@@ -494,6 +627,53 @@ static le_result_t PlayTone
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Play Tone function for DTMFs mixed over a playback. The pipe is closed once all the DTMFs are
+ *  played, so that the mixer gets the end of the DTMF samples.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PlayMixedTone
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr,  ///< [IN] Media thread context
+    uint8_t*                       bufferOutPtr, ///< [OUT] dtmf samples buffer output
+    uint32_t*                      bufferLenPtr  ///< [OUT] Length of the buffer
+)
+{
+    le_result_t res = PlayTone(mediaCtxPtr, bufferOutPtr, bufferLenPtr);
+
+    if (res != LE_OK)
+    {
+        close(mediaCtxPtr->fd_pipe_input);
+        mediaCtxPtr->fd_pipe_input = -1;
+    }
+
+    return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the mixer input of the DTMFs mixed over the playback of a stream.
+ *
+ * @return The mixer input, or NULL if the stream isn't playing mixed DTMFs.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mixer_InputRef_t GetMixedDtmfInput
+(
+    le_audio_Stream_t* streamPtr  ///< [IN] Stream object
+)
+{
+    le_audio_MediaThreadContext_t* mediaCtxPtr = streamPtr->mediaThreadContextPtr;
+
+    if (mediaCtxPtr && (mediaCtxPtr->readFunc == PlayMixedTone))
+    {
+        return ((DtmfParams_t*) mediaCtxPtr->codecParams)->mixerInputRef;
+    }
+
+    return NULL;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Populate wave header file
@@ -1258,35 +1438,7 @@ static le_result_t PlayCaptControl
             {
                 pcmContextPtr->pause = true;
 
-                char data[4096];
-                int mask;
-
-                if ((mask = fcntl(pcmContextPtr->fd, F_GETFL, 0)) == -1)
-                {
-                    LE_ERROR("fcntl error, errno.%d (%s)", errno, strerror(errno));
-                    res = LE_FAULT;
-                    break;
-                }
-                if (fcntl(pcmContextPtr->fd, F_SETFL, mask | O_NONBLOCK) == -1)
-                {
-                    LE_ERROR("fcntl error, errno.%d (%s)", errno, strerror(errno));
-                    res = LE_FAULT;
-                    break;
-                }
-
-                ssize_t len = 1;
-
-                while (len > 0)
-                {
-                    len = ReadFd(pcmContextPtr->fd, data, sizeof(data));
-                }
-
-                if (fcntl(pcmContextPtr->fd, F_SETFL, mask) == -1)
-                {
-                    LE_ERROR("fcntl error, errno.%d (%s)", errno, strerror(errno));
-                    res = LE_FAULT;
-                    break;
-                }
+                le_mixer_Flush(pcmContextPtr->mixerRef);
 
                 pcmContextPtr->pause = false;
 
@@ -1368,6 +1520,46 @@ static void PlayTreatEvent
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Treat the end of the DTMFs mixed over a playback, sent by playback thread: release the mixer
+ * input and the media thread of the DTMFs, and report the end to the client.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void MixedDtmfTreatEvent
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    le_audio_Stream_t* streamPtr = param1Ptr;
+    le_mixer_InputRef_t inputRef = param2Ptr;
+
+    // The playback may have been stopped since the end was detected
+    if (GetMixedDtmfInput(streamPtr) != inputRef)
+    {
+        LE_DEBUG("Mixed DTMFs already released");
+        return;
+    }
+
+    le_mixer_RemoveInput(inputRef);
+    le_thread_Cancel(streamPtr->mediaThreadRef);
+    le_thread_Join(streamPtr->mediaThreadRef, NULL);
+    streamPtr->mediaThreadRef = NULL;
+
+    LE_DEBUG("Mixed DTMFs ended");
+
+    le_audio_StreamEvent_t streamEvent;
+    streamEvent.streamPtr = streamPtr;
+    streamEvent.streamEvent = LE_AUDIO_BITMASK_MEDIA_EVENT;
+    streamEvent.event.mediaEvent = LE_AUDIO_MEDIA_ENDED;
+
+    le_event_Report(streamPtr->streamEventId,
+                        &streamEvent,
+                        sizeof(le_audio_StreamEvent_t));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get Playback frames
@@ -1383,72 +1575,196 @@ static le_result_t GetPlaybackFrames
 {
     le_audio_Stream_t* streamPtr = contextPtr;
     le_audio_PcmContext_t* pcmContextPtr = streamPtr->pcmContextPtr;
-    int32_t len=1;
-    fd_set rfds;
-    struct timeval tv;
-    int ret;
     long usec = pa_pcm_GetPeriodSize(pcmContextPtr->pcmHandle) * (1000000/
                                   (pcmContextPtr->pcmConfig.byteRate));
-    uint32_t size = *bufsizePtr, amount = 0;
 
-    while (size && len)
+    if (pcmContextPtr->pause)
+    {
+        memset(bufferPtr, 0, *bufsizePtr);
+        return LE_OK;
+    }
+
+    // The mixer returns less samples than requested when no more samples are received within a
+    // period
+    le_result_t res = le_mixer_Read(pcmContextPtr->mixerRef, bufferPtr, bufsizePtr, usec);
+
+    // Once all the mixed DTMFs are read, their end is reported once by the main thread
+    le_mixer_InputRef_t dtmfInputRef = __atomic_load_n(&pcmContextPtr->dtmfInputRef,
+                                                       __ATOMIC_ACQUIRE);
+
+    if (dtmfInputRef && le_mixer_IsInputEnded(dtmfInputRef) &&
+        __atomic_compare_exchange_n(&pcmContextPtr->dtmfInputRef, &dtmfInputRef, NULL, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        le_event_QueueFunctionToThread(pcmContextPtr->mainThreadRef,
+                                       MixedDtmfTreatEvent,
+                                       streamPtr,
+                                       dtmfInputRef);
+    }
+
+    return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure the DTMF detector filters for a sample rate, and restart the analysis of a block.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ConfigureDtmfDetector
+(
+    le_media_DtmfDetectorRef_t detectorPtr,   ///< [IN] DTMF detector
+    uint32_t                   sampleRate     ///< [IN] Sample frequency in Hertz
+)
+{
+    int k;
+
+    detectorPtr->sampleRate = sampleRate;
+    detectorPtr->blockSize = (sampleRate * DTMF_BLOCK_SIZE_8K) / 8000;
+
+    for (k = 0; k < DTMF_FREQ_NB; k++)
     {
-        // Select on fd to check when there is no more samples to read
-        do
+        detectorPtr->coef[k] = 2 * cosf(2 * PI * DtmfFrequencies[k] / sampleRate);
+        detectorPtr->s1[k] = 0;
+        detectorPtr->s2[k] = 0;
+    }
+
+    detectorPtr->sampleCount = 0;
+    detectorPtr->energy = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the DTMF found in the block of samples that has just been analyzed.
+ *
+ * @return The DTMF character, or '\0' if the block doesn't contain a valid DTMF.
+ */
+//--------------------------------------------------------------------------------------------------
+static char GetBlockDtmf
+(
+    le_media_DtmfDetectorRef_t detectorPtr    ///< [IN] DTMF detector
+)
+{
+    float power[DTMF_FREQ_NB];
+    float norm;
+    int   row = 0;
+    int   col = DTMF_FREQ_NB/2;
+    int   k;
+
+    if (detectorPtr->energy < (DTMF_MIN_POWER * detectorPtr->blockSize))
+    {
+        return '\0';
+    }
+
+    // Normalize the powers by the block energy, so that the thresholds don't depend on the level
+    norm = 2.0f / (detectorPtr->blockSize * detectorPtr->energy);
+
+    for (k = 0; k < DTMF_FREQ_NB; k++)
+    {
+        power[k] = norm * (detectorPtr->s1[k] * detectorPtr->s1[k] +
+                           detectorPtr->s2[k] * detectorPtr->s2[k] -
+                           detectorPtr->coef[k] * detectorPtr->s1[k] * detectorPtr->s2[k]);
+
+        if ((k < DTMF_FREQ_NB/2) && (power[k] > power[row]))
+        {
+            row = k;
+        }
+        else if ((k >= DTMF_FREQ_NB/2) && (power[k] > power[col]))
         {
-            FD_ZERO(&rfds);
-            FD_SET(pcmContextPtr->fd, &rfds);
-            tv.tv_sec = 0;
-            tv.tv_usec =  usec;
-            ret = select(pcmContextPtr->fd+1, &rfds, NULL, NULL, &tv);
+            col = k;
         }
-        while ((ret == -1) && (errno == EINTR));
+    }
 
-        if ((ret == 1) && (FD_ISSET(pcmContextPtr->fd, &rfds)))
+    if ((power[row] < DTMF_TONE_THRESHOLD) ||
+        (power[col] < DTMF_TONE_THRESHOLD) ||
+        ((power[row] + power[col]) < DTMF_SUM_THRESHOLD) ||
+        (power[row] > (power[col] * DTMF_TWIST_RATIO)) ||
+        (power[col] > (power[row] * DTMF_TWIST_RATIO)))
+    {
+        return '\0';
+    }
+
+    // The other frequencies of each group must be well below the detected tone
+    for (k = 0; k < DTMF_FREQ_NB; k++)
+    {
+        if ((k != row) && (k != col) &&
+            ((power[k] * DTMF_PEAK_RATIO) > ((k < DTMF_FREQ_NB/2) ? power[row] : power[col])))
         {
-            // reading file descriptor
-            if (pcmContextPtr->pause)
-            {
-                amount = *bufsizePtr;
-                memset(bufferPtr, 0, amount);
-                // To exit of the loop
-                len = 0;
-            }
-            else
-            {
-                len = read(pcmContextPtr->fd, bufferPtr + amount, size);
+            return '\0';
+        }
+    }
 
-                if (len > 0)
-                {
-                    size -= len;
-                    amount += len;
-                }
-                else if (len < 0)
-                {
-                    if ((errno == EINTR) || (errno == EAGAIN))
-                    {
-                        // read again
-                        len = 1;
-                    }
-                    else
-                    {
-                        LE_ERROR("read error, errno %d, %s", errno, strerror(errno));
-                        return LE_FAULT;
-                    }
-                }
-            }
+    return DtmfDigits[row][col - DTMF_FREQ_NB/2];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look for DTMFs in captured samples, and report them as stream events. Only the first channel of
+ * the samples is analyzed. A DTMF is reported once, when it is found in two consecutive blocks.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DetectDtmf
+(
+    le_audio_Stream_t* streamPtr,       ///< [IN] Stream object
+    const int16_t*     samplesPtr,      ///< [IN] Captured samples
+    uint32_t           framesCount,     ///< [IN] Number of frames
+    uint32_t           channelsCount    ///< [IN] Number of channels of a frame
+)
+{
+    le_media_DtmfDetectorRef_t detectorPtr = streamPtr->dtmfDetectorRef;
+    uint32_t i;
+    int      k;
+
+    for (i = 0; i < framesCount; i++)
+    {
+        float x = samplesPtr[i * channelsCount];
+
+        for (k = 0; k < DTMF_FREQ_NB; k++)
+        {
+            float s0 = x + detectorPtr->coef[k] * detectorPtr->s1[k] - detectorPtr->s2[k];
+
+            detectorPtr->s2[k] = detectorPtr->s1[k];
+            detectorPtr->s1[k] = s0;
         }
-        else
+        detectorPtr->energy += x * x;
+
+        if (++detectorPtr->sampleCount < detectorPtr->blockSize)
         {
-            // No data read
-            LE_DEBUG("No data read");
-            break;
+            continue;
         }
-    }
 
-    *bufsizePtr = amount;
+        char dtmf = GetBlockDtmf(detectorPtr);
 
-    return LE_OK;
+        if (dtmf != detectorPtr->candidate)
+        {
+            detectorPtr->candidate = dtmf;
+        }
+        else if (dtmf != detectorPtr->lastDigit)
+        {
+            detectorPtr->lastDigit = dtmf;
+
+            if (dtmf != '\0')
+            {
+                le_audio_StreamEvent_t streamEvent;
+
+                LE_DEBUG("DTMF %c detected", dtmf);
+
+                streamEvent.streamPtr = streamPtr;
+                streamEvent.streamEvent = LE_AUDIO_BITMASK_DTMF_DETECTION;
+                streamEvent.event.dtmf = dtmf;
+
+                le_event_Report(streamPtr->streamEventId,
+                                &streamEvent,
+                                sizeof(le_audio_StreamEvent_t));
+            }
+        }
+
+        memset(detectorPtr->s1, 0, sizeof(detectorPtr->s1));
+        memset(detectorPtr->s2, 0, sizeof(detectorPtr->s2));
+        detectorPtr->sampleCount = 0;
+        detectorPtr->energy = 0;
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1466,9 +1782,27 @@ static le_result_t SetCaptureFrames
 {
     le_audio_Stream_t*     streamPtr = contextPtr;
     le_audio_PcmContext_t* pcmContextPtr = streamPtr->pcmContextPtr;
+    le_media_DtmfDetectorRef_t detectorPtr = streamPtr->dtmfDetectorRef;
 
     if ( !pcmContextPtr->pause )
     {
+        // The DTMFs are looked for in place, only 16-bit samples are supported
+        if ((detectorPtr != NULL) && detectorPtr->enabled &&
+            (pcmContextPtr->pcmConfig.bitsPerSample == 16))
+        {
+            uint32_t frameSize = 2 * pcmContextPtr->pcmConfig.channelsCount;
+
+            if (detectorPtr->sampleRate != pcmContextPtr->pcmConfig.sampleRate)
+            {
+                ConfigureDtmfDetector(detectorPtr, pcmContextPtr->pcmConfig.sampleRate);
+            }
+
+            DetectDtmf(streamPtr,
+                       (const int16_t*) bufferPtr,
+                       *bufsizePtr / frameSize,
+                       pcmContextPtr->pcmConfig.channelsCount);
+        }
+
         if (WriteFd(pcmContextPtr->fd, bufferPtr, *bufsizePtr) < 0)
         {
             LE_ERROR("Cannot write on pipe");
@@ -1538,10 +1872,13 @@ static void PlayCaptResult
  * This function must be called to play a DTMF on a specific audio stream.
  *
  * @return LE_FORMAT_ERROR  The DTMF characters are invalid.
- * @return LE_BUSY          A DTMF playback is already in progress on the playback stream.
+ * @return LE_BUSY          A DTMF playback is already in progress on the playback stream, or
+ *                          the DTMFs can't be mixed with the samples played on the stream.
  * @return LE_FAULT         The function failed to play the DTMFs.
  * @return LE_OK            The funtion succeeded.
  *
+ * @note If samples are already played on the stream, the DTMFs are mixed over them, and the
+ *       LE_AUDIO_MEDIA_ENDED event is reported at the end of the DTMFs.
  * @note The process exits, if an invalid audio stream reference is given.
  */
 //--------------------------------------------------------------------------------------------------
@@ -1561,17 +1898,15 @@ le_result_t le_media_PlayDtmf
         return LE_FAULT;
     }
 
+    // DTMFs mixed over a playback are released when their end is reported
     if (streamPtr->mediaThreadContextPtr)
     {
         LE_ERROR("Media thread is already started");
         return LE_BUSY;
     }
 
-    if (streamPtr->pcmContextPtr)
-    {
-        LE_ERROR("Playback thread is already started");
-        return LE_BUSY;
-    }
+    // When samples are already played on the stream, the DTMFs are mixed over them
+    bool mixed = (streamPtr->pcmContextPtr != NULL);
 
     le_audio_MediaThreadContext_t* mediaCtxPtr = le_mem_ForceAlloc(MediaThreadContextPool);
     memset(mediaCtxPtr, 0, sizeof(le_audio_MediaThreadContext_t));
@@ -1581,21 +1916,31 @@ le_result_t le_media_PlayDtmf
 
     memset(dtmfParamsPtr, 0, sizeof(DtmfParams_t));
 
-    streamPtr->samplePcmConfig.sampleRate = 16000;
-    streamPtr->samplePcmConfig.bitsPerSample = 16;
-    streamPtr->samplePcmConfig.channelsCount = 1;
+    le_audio_SamplePcmConfig_t dtmfPcmConfig;
+
+    memset(&dtmfPcmConfig, 0, sizeof(dtmfPcmConfig));
+    dtmfPcmConfig.sampleRate = 16000;
+    dtmfPcmConfig.bitsPerSample = 16;
+    dtmfPcmConfig.channelsCount = 1;
+
+    if (!mixed)
+    {
+        streamPtr->samplePcmConfig.sampleRate = dtmfPcmConfig.sampleRate;
+        streamPtr->samplePcmConfig.bitsPerSample = dtmfPcmConfig.bitsPerSample;
+        streamPtr->samplePcmConfig.channelsCount = dtmfPcmConfig.channelsCount;
+        streamPtr->playFile = true;
+    }
     streamPtr->mediaThreadContextPtr = mediaCtxPtr;
-    streamPtr->playFile = true;
 
     dtmfParamsPtr->duration = duration;
     dtmfParamsPtr->pause = pause;
-    dtmfParamsPtr->sampleRate = 16000;
+    dtmfParamsPtr->sampleRate = dtmfPcmConfig.sampleRate;
 
     strncpy(dtmfParamsPtr->dtmf, dtmfPtr, LE_AUDIO_DTMF_MAX_LEN);
     dtmfParamsPtr->dtmf[LE_AUDIO_DTMF_MAX_LEN] = '\0';
 
     mediaCtxPtr->initFunc = InitPlayDtmf;
-    mediaCtxPtr->readFunc = PlayTone;
+    mediaCtxPtr->readFunc = mixed ? PlayMixedTone : PlayTone;
     mediaCtxPtr->writeFunc = MediaWriteFd;
     mediaCtxPtr->closeFunc = ReleaseCodecParams;
     mediaCtxPtr->codecParams = (le_audio_Codec_t) dtmfParamsPtr;
@@ -1609,20 +1954,57 @@ le_result_t le_media_PlayDtmf
         return LE_FAULT;
     }
 
+    if (mixed)
+    {
+        dtmfParamsPtr->mixerInputRef = le_mixer_AddInput(streamPtr->pcmContextPtr->mixerRef,
+                                                         pipefd[0],
+                                                         &dtmfPcmConfig,
+                                                         LE_MIXER_GAIN_UNITY);
+
+        if (dtmfParamsPtr->mixerInputRef == NULL)
+        {
+            LE_ERROR("DTMFs can't be mixed with the played samples");
+            close(pipefd[0]);
+            close(pipefd[1]);
+            le_mem_Release(dtmfParamsPtr);
+            le_mem_Release(mediaCtxPtr);
+            streamPtr->mediaThreadContextPtr = NULL;
+            return LE_BUSY;
+        }
+    }
+
     mediaCtxPtr->fd_arg = streamPtr->fd;
     mediaCtxPtr->fd_pipe_input = pipefd[1];
     mediaCtxPtr->fd_pipe_output = pipefd[0];
-    streamPtr->fd = pipefd[0];
+
+    if (!mixed)
+    {
+        streamPtr->fd = pipefd[0];
+    }
 
     if ( (res=InitMediaThread( streamPtr,
                             LE_AUDIO_FILE_MAX,
                             -1,
                             pipefd[1] )) == LE_OK)
     {
-        res=le_media_PlaySamples(streamPtr, &streamPtr->samplePcmConfig);
+        if (mixed)
+        {
+            // From now on the playback thread watches the end of the DTMFs
+            __atomic_store_n(&streamPtr->pcmContextPtr->dtmfInputRef,
+                             dtmfParamsPtr->mixerInputRef,
+                             __ATOMIC_RELEASE);
+        }
+        else
+        {
+            res=le_media_PlaySamples(streamPtr, &streamPtr->samplePcmConfig);
+        }
     }
     else
     {
+        if (dtmfParamsPtr->mixerInputRef)
+        {
+            le_mixer_RemoveInput(dtmfParamsPtr->mixerInputRef);
+        }
         le_mem_Release(dtmfParamsPtr);
         le_mem_Release(mediaCtxPtr);
         streamPtr->mediaThreadContextPtr = NULL;
@@ -1840,6 +2222,17 @@ le_result_t le_media_PlaySamples
     // Request a wakeup source for media streams
     le_pm_StayAwake(MediaWakeLock);
 
+    // The samples are read through a mixer, so that other sources can be mixed over them
+    pcmContextPtr->mixerRef = le_mixer_Create(&(pcmContextPtr->pcmConfig));
+
+    if (le_mixer_AddInput(pcmContextPtr->mixerRef, pcmContextPtr->fd, &(pcmContextPtr->pcmConfig),
+                          LE_MIXER_GAIN_UNITY) == NULL)
+    {
+        LE_ERROR("Cannot read the samples");
+        le_media_Stop(streamPtr);
+        return LE_FAULT;
+    }
+
     if ((pa_pcm_InitPlayback(&pcmHandle, deviceString, &(pcmContextPtr->pcmConfig)) != LE_OK)
                             || (pcmHandle == NULL))
     {
@@ -2042,10 +2435,21 @@ le_result_t le_media_Stop
             {
                 LE_DEBUG("Close pa_pcm");
                 pa_pcm_Close(streamPtr->pcmContextPtr->pcmHandle);
+                if (streamPtr->pcmContextPtr->mixerRef)
+                {
+                    le_mixer_Delete(streamPtr->pcmContextPtr->mixerRef);
+                }
                 le_mem_Release(streamPtr->pcmContextPtr);
                 streamPtr->pcmContextPtr = NULL;
             }
 
+            // A stopped DTMF detector is released once the PCM thread doesn't use it anymore
+            if (streamPtr->dtmfDetectorRef && !streamPtr->dtmfDetectorRef->enabled)
+            {
+                le_mem_Release(streamPtr->dtmfDetectorRef);
+                streamPtr->dtmfDetectorRef = NULL;
+            }
+
             if (streamPtr->mediaThreadRef)
             {
                 LE_DEBUG("Stop media thread");
@@ -2178,6 +2582,81 @@ bool le_media_IsStreamBusy
     return false;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function starts the software DTMF detection on a capture stream. The captured samples are
+ * analyzed in the PCM thread and each detected DTMF is reported as a
+ * LE_AUDIO_BITMASK_DTMF_DETECTION stream event.
+ *
+ * @return LE_BAD_PARAMETER The interface is not a capture interface
+ * @return LE_OK            The function succeeded
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_media_StartDtmfDetector
+(
+    le_audio_Stream_t*          streamPtr         ///< [IN] Stream object
+)
+{
+    if (streamPtr->audioInterface != LE_AUDIO_IF_DSP_FRONTEND_FILE_CAPTURE)
+    {
+        LE_ERROR("Invalid interface");
+        return LE_BAD_PARAMETER;
+    }
+
+    if ((streamPtr->dtmfDetectorRef != NULL) && streamPtr->dtmfDetectorRef->enabled)
+    {
+        return LE_OK;
+    }
+
+    if (streamPtr->dtmfDetectorRef == NULL)
+    {
+        le_media_DtmfDetectorRef_t detectorPtr = le_mem_ForceAlloc(DtmfDetectorPool);
+
+        memset(detectorPtr, 0, sizeof(struct le_media_DtmfDetector));
+        streamPtr->dtmfDetectorRef = detectorPtr;
+    }
+    else
+    {
+        // Force the filters to be configured again by the PCM thread
+        streamPtr->dtmfDetectorRef->sampleRate = 0;
+        streamPtr->dtmfDetectorRef->candidate = '\0';
+        streamPtr->dtmfDetectorRef->lastDigit = '\0';
+    }
+
+    streamPtr->dtmfDetectorRef->enabled = true;
+
+    LE_DEBUG("DTMF detection started on interface %d", streamPtr->audioInterface);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function stops the software DTMF detection on a capture stream.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_media_StopDtmfDetector
+(
+    le_audio_Stream_t*          streamPtr         ///< [IN] Stream object
+)
+{
+    if (streamPtr->dtmfDetectorRef == NULL)
+    {
+        return;
+    }
+
+    streamPtr->dtmfDetectorRef->enabled = false;
+
+    // While a capture is running, the detector is released when the capture is stopped
+    if (streamPtr->pcmContextPtr == NULL)
+    {
+        le_mem_Release(streamPtr->dtmfDetectorRef);
+        streamPtr->dtmfDetectorRef = NULL;
+    }
+
+    LE_DEBUG("DTMF detection stopped on interface %d", streamPtr->audioInterface);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -2204,6 +2683,12 @@ void le_media_Init
     PcmThreadContextPool = le_mem_CreatePool("PcmThreadContextPool",
                                                                sizeof(le_audio_PcmContext_t));
 
+    // Allocate the software DTMF detectors pool.
+    DtmfDetectorPool = le_mem_CreatePool("DtmfDetectorPool", sizeof(struct le_media_DtmfDetector));
+
     // Create a Wakeup source for Media
     MediaWakeLock = le_pm_NewWakeupSource( LE_PM_REF_COUNT, "MediaStream" );
+
+    // Initialize the software mixer
+    le_mixer_Init();
 }
@@ -149,5 +149,30 @@ bool le_media_IsStreamBusy
     le_audio_Stream_t*          streamPtr         ///< [IN] Stream object
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function starts the software DTMF detection on a capture stream. The captured samples are
+ * analyzed in the PCM thread and each detected DTMF is reported as a
+ * LE_AUDIO_BITMASK_DTMF_DETECTION stream event.
+ *
+ * @return LE_BAD_PARAMETER The interface is not a capture interface
+ * @return LE_OK            The function succeeded
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_media_StartDtmfDetector
+(
+    le_audio_Stream_t*          streamPtr         ///< [IN] Stream object
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function stops the software DTMF detection on a capture stream.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_media_StopDtmfDetector
+(
+    le_audio_Stream_t*          streamPtr         ///< [IN] Stream object
+);
+
 
 #endif // LEGATO_LEMEDIALOCAL_INCLUDE_GUARD
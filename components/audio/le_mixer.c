@@ -0,0 +1,1019 @@
+/** @file le_mixer.c
+ *
+ * This file contains the source code of the software mixer used by the playback streams.
+ *
+ * Each input of a mixer is read from a file descriptor into a ring buffer, with one large
+ * non-blocking read whenever the buffer runs low. The inputs are converted to the output sample
+ * rate with a linear interpolation, scaled by their gain, and accumulated on 32 bits before being
+ * narrowed back to 16-bit samples with saturation. The accumulation and narrowing loops use NEON
+ * when it is available and are otherwise written so that the compiler can vectorize them.
+ *
+ * A single input in the output configuration at unity gain is copied unchanged, so that a stream
+ * played alone doesn't pay for the mixing.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "le_audio_local.h"
+#include "le_mixer_local.h"
+
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the ring buffer of an input, in bytes. Must be a power of 2.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RING_SIZE               16384
+#define RING_MASK               (RING_SIZE - 1)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of channels of mixed samples.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_CHANNELS            2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of output frames mixed at once.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHUNK_FRAMES            512
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of input frames converted at once.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INPUT_CHUNK_FRAMES      2048
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fractional bits of the resampler position.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PHASE_SHIFT             16
+#define PHASE_MASK              ((1 << PHASE_SHIFT) - 1)
+
+//--------------------------------------------------------------------------------------------------
+// Data structures.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mixer input structure.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_mixer_Input
+{
+    le_mixer_Ref_t              mixerRef;       ///< Mixer of the input
+    int                         fd;             ///< File descriptor to read samples from
+    int                         fdFlags;        ///< File descriptor flags to restore
+    le_audio_SamplePcmConfig_t  config;         ///< Configuration of the input samples
+    uint32_t                    frameSize;      ///< Size of an input frame in bytes
+    uint32_t                    gain;           ///< Input gain
+    bool                        ended;          ///< End of file reached on the file descriptor
+    uint32_t                    step;           ///< Resampler step in input frames, 0 if the
+                                                ///<  input is at the output sample rate
+    uint32_t                    phase;          ///< Resampler position after the previous frame
+    int16_t                     prevFrame[MAX_CHANNELS]; ///< Resampler previous input frame
+    uint32_t                    readCount;      ///< Bytes consumed from the ring buffer
+    uint32_t                    writeCount;     ///< Bytes written into the ring buffer
+    uint8_t                     ring[RING_SIZE];///< Ring buffer of input samples
+}
+Input_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mixer structure.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_mixer
+{
+    le_audio_SamplePcmConfig_t  config;                     ///< Configuration of mixed samples
+    uint32_t                    frameSize;                  ///< Size of an output frame in bytes
+    le_mutex_Ref_t              mutex;                      ///< Protects the inputs
+    Input_t*                    inputs[LE_MIXER_MAX_INPUTS];///< Inputs of the mixer
+    uint32_t                    inputCount;                 ///< Number of inputs
+    int32_t  accumulator[CHUNK_FRAMES * MAX_CHANNELS];      ///< Sum of the scaled inputs
+    int16_t  samples[CHUNK_FRAMES * MAX_CHANNELS];          ///< Input converted to the output
+    int16_t  inSamples[INPUT_CHUNK_FRAMES * MAX_CHANNELS];  ///< Input read from the ring buffer
+}
+Mixer_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static declarations.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for the mixers
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t MixerPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for the mixer inputs
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t InputPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the size of a frame in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t FrameSize
+(
+    const le_audio_SamplePcmConfig_t* configPtr
+)
+{
+    return (configPtr->channelsCount * configPtr->bitsPerSample) / 8;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Narrow an accumulated sample to 16 bits with saturation.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline int16_t Saturate16
+(
+    int32_t value
+)
+{
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    else if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+
+    return (int16_t)value;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether an input can be copied to the output unchanged.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsPassthrough
+(
+    Mixer_t* mixerPtr,
+    Input_t* inputPtr
+)
+{
+    return ((inputPtr->gain == LE_MIXER_GAIN_UNITY) &&
+            (inputPtr->config.sampleRate == mixerPtr->config.sampleRate) &&
+            (inputPtr->config.channelsCount == mixerPtr->config.channelsCount) &&
+            (inputPtr->config.bitsPerSample == mixerPtr->config.bitsPerSample));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether an input can be mixed into the output.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsMixable
+(
+    Mixer_t*                          mixerPtr,
+    const le_audio_SamplePcmConfig_t* configPtr
+)
+{
+    return ((mixerPtr->config.bitsPerSample == 16) &&
+            (mixerPtr->config.channelsCount <= MAX_CHANNELS) &&
+            (configPtr->bitsPerSample == 16) &&
+            (configPtr->sampleRate != 0) &&
+            ((configPtr->channelsCount == mixerPtr->config.channelsCount) ||
+             (configPtr->channelsCount == 1)));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes available in the ring buffer of an input.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t RingLevel
+(
+    Input_t* inputPtr
+)
+{
+    return inputPtr->writeCount - inputPtr->readCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy bytes from the ring buffer of an input, without consuming them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PeekRing
+(
+    Input_t* inputPtr,
+    void*    bufferPtr,
+    uint32_t length
+)
+{
+    uint32_t index = inputPtr->readCount & RING_MASK;
+    uint32_t firstLength = RING_SIZE - index;
+
+    if (firstLength > length)
+    {
+        firstLength = length;
+    }
+
+    memcpy(bufferPtr, &inputPtr->ring[index], firstLength);
+    memcpy((uint8_t*)bufferPtr + firstLength, inputPtr->ring, length - firstLength);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill the ring buffer of an input from its file descriptor, without blocking.
+ *
+ * @return LE_OK            The function succeeded.
+ * @return LE_FAULT         The file descriptor could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FillRing
+(
+    Input_t* inputPtr
+)
+{
+    while (!inputPtr->ended && (RingLevel(inputPtr) < RING_SIZE))
+    {
+        uint32_t index = inputPtr->writeCount & RING_MASK;
+        uint32_t length = RING_SIZE - RingLevel(inputPtr);
+        ssize_t  len;
+
+        if (length > RING_SIZE - index)
+        {
+            length = RING_SIZE - index;
+        }
+
+        len = read(inputPtr->fd, &inputPtr->ring[index], length);
+
+        if (len > 0)
+        {
+            inputPtr->writeCount += len;
+
+            if (len < length)
+            {
+                // Nothing more to read for now
+                break;
+            }
+        }
+        else if (len == 0)
+        {
+            inputPtr->ended = true;
+        }
+        else if (errno == EAGAIN)
+        {
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            LE_ERROR("read error on fd %d, errno %d, %s", inputPtr->fd, errno, strerror(errno));
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for samples on the inputs which are not ended.
+ *
+ * @return LE_OK            Samples are available.
+ * @return LE_TIMEOUT       No sample was received before the timeout.
+ * @return LE_FAULT         The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WaitInputs
+(
+    Mixer_t* mixerPtr,
+    long     timeoutUsec
+)
+{
+    fd_set         rfds;
+    struct timeval tv;
+    int            maxFd = -1;
+    int            ret;
+    uint32_t       i;
+
+    do
+    {
+        FD_ZERO(&rfds);
+
+        for (i = 0; i < mixerPtr->inputCount; i++)
+        {
+            if (!mixerPtr->inputs[i]->ended)
+            {
+                FD_SET(mixerPtr->inputs[i]->fd, &rfds);
+
+                if (mixerPtr->inputs[i]->fd > maxFd)
+                {
+                    maxFd = mixerPtr->inputs[i]->fd;
+                }
+            }
+        }
+
+        if (maxFd < 0)
+        {
+            return LE_TIMEOUT;
+        }
+
+        tv.tv_sec = timeoutUsec / 1000000;
+        tv.tv_usec = timeoutUsec % 1000000;
+        ret = select(maxFd + 1, &rfds, NULL, NULL, &tv);
+    }
+    while ((ret == -1) && (errno == EINTR));
+
+    if (ret == -1)
+    {
+        LE_ERROR("select error, errno %d, %s", errno, strerror(errno));
+        return LE_FAULT;
+    }
+
+    return (ret == 0) ? LE_TIMEOUT : LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of output frames an input can provide from its ring buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetInputFrames
+(
+    Input_t* inputPtr,
+    uint32_t maxFrames
+)
+{
+    uint64_t available = RingLevel(inputPtr) / inputPtr->frameSize;
+    uint64_t frames;
+    uint64_t endFrames;
+
+    if (available > INPUT_CHUNK_FRAMES)
+    {
+        available = INPUT_CHUNK_FRAMES;
+    }
+
+    if (inputPtr->step == 0)
+    {
+        frames = available;
+    }
+    else
+    {
+        if ((available << PHASE_SHIFT) <= inputPtr->phase)
+        {
+            return 0;
+        }
+
+        // The last output frame interpolates up to the last available input frame, and the
+        // position after it must not go beyond the frame following it.
+        frames = ((available << PHASE_SHIFT) - inputPtr->phase - 1) / inputPtr->step + 1;
+        endFrames = (((available + 1) << PHASE_SHIFT) - inputPtr->phase - 1) / inputPtr->step;
+
+        if (endFrames < frames)
+        {
+            frames = endFrames;
+        }
+    }
+
+    return (frames < maxFrames) ? frames : maxFrames;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert input frames to the output sample rate and number of channels into the mixer samples
+ * buffer, and consume them from the ring buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ConvertInput
+(
+    Mixer_t* mixerPtr,
+    Input_t* inputPtr,
+    uint32_t frames
+)
+{
+    uint32_t inChannels = inputPtr->config.channelsCount;
+    uint32_t outChannels = mixerPtr->config.channelsCount;
+    int16_t* inPtr = mixerPtr->inSamples;
+    int16_t* outPtr = mixerPtr->samples;
+    uint32_t usedFrames;
+    uint32_t i, c;
+
+    if (inputPtr->step == 0)
+    {
+        usedFrames = frames;
+
+        if (inChannels == outChannels)
+        {
+            PeekRing(inputPtr, outPtr, frames * inputPtr->frameSize);
+        }
+        else
+        {
+            PeekRing(inputPtr, inPtr, frames * inputPtr->frameSize);
+
+            for (i = 0; i < frames; i++)
+            {
+                for (c = 0; c < outChannels; c++)
+                {
+                    outPtr[i * outChannels + c] = inPtr[i];
+                }
+            }
+        }
+    }
+    else
+    {
+        uint64_t lastPos = inputPtr->phase + (uint64_t)(frames - 1) * inputPtr->step;
+        uint64_t endPos = inputPtr->phase + (uint64_t)frames * inputPtr->step;
+        uint32_t peekFrames = (lastPos >> PHASE_SHIFT) + 1;
+
+        usedFrames = endPos >> PHASE_SHIFT;
+        if (usedFrames > peekFrames)
+        {
+            peekFrames = usedFrames;
+        }
+
+        PeekRing(inputPtr, inPtr, peekFrames * inputPtr->frameSize);
+
+        // Position 0 is the previous input frame, position n is the input frame n-1 of the buffer
+        for (i = 0; i < frames; i++)
+        {
+            uint64_t pos = inputPtr->phase + (uint64_t)i * inputPtr->step;
+            uint32_t index = pos >> PHASE_SHIFT;
+            int32_t  frac = (pos & PHASE_MASK) >> 1;
+
+            for (c = 0; c < inChannels; c++)
+            {
+                int32_t a = (index == 0) ? inputPtr->prevFrame[c] :
+                                           inPtr[(index - 1) * inChannels + c];
+                int32_t b = inPtr[index * inChannels + c];
+                int16_t sample = a + (((b - a) * frac) >> (PHASE_SHIFT - 1));
+
+                if (inChannels == outChannels)
+                {
+                    outPtr[i * outChannels + c] = sample;
+                }
+                else
+                {
+                    uint32_t o;
+
+                    for (o = 0; o < outChannels; o++)
+                    {
+                        outPtr[i * outChannels + o] = sample;
+                    }
+                }
+            }
+        }
+
+        if (usedFrames)
+        {
+            for (c = 0; c < inChannels; c++)
+            {
+                inputPtr->prevFrame[c] = inPtr[(usedFrames - 1) * inChannels + c];
+            }
+        }
+        inputPtr->phase = endPos - ((uint64_t)usedFrames << PHASE_SHIFT);
+    }
+
+    inputPtr->readCount += usedFrames * inputPtr->frameSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add scaled samples to the accumulator.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Accumulate
+(
+    int32_t*       accPtr,
+    const int16_t* samplesPtr,
+    uint32_t       count,
+    int16_t        gain
+)
+{
+    uint32_t i = 0;
+
+#ifdef __ARM_NEON
+    int16x4_t gainVector = vdup_n_s16(gain);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_s32(accPtr + i, vmlal_s16(vld1q_s32(accPtr + i),
+                                        vld1_s16(samplesPtr + i),
+                                        gainVector));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        accPtr[i] += samplesPtr[i] * gain;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scale down the accumulator to 16-bit samples, with saturation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Narrow
+(
+    int16_t*       outPtr,
+    const int32_t* accPtr,
+    uint32_t       count
+)
+{
+    uint32_t i = 0;
+
+#ifdef __ARM_NEON
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1_s16(outPtr + i, vqshrn_n_s32(vld1q_s32(accPtr + i), LE_MIXER_GAIN_SHIFT));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        outPtr[i] = Saturate16(accPtr[i] >> LE_MIXER_GAIN_SHIFT);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mix up to a chunk of frames from the ring buffers of the inputs. An input without enough samples
+ * is mixed as silence for the missing frames.
+ *
+ * @return The number of frames produced.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t MixChunk
+(
+    Mixer_t* mixerPtr,
+    int16_t* outPtr,
+    uint32_t maxFrames
+)
+{
+    uint32_t inputFrames[LE_MIXER_MAX_INPUTS];
+    uint32_t frames = 0;
+    uint32_t channels = mixerPtr->config.channelsCount;
+    uint32_t i;
+
+    if (maxFrames > CHUNK_FRAMES)
+    {
+        maxFrames = CHUNK_FRAMES;
+    }
+
+    for (i = 0; i < mixerPtr->inputCount; i++)
+    {
+        inputFrames[i] = GetInputFrames(mixerPtr->inputs[i], maxFrames);
+
+        if (inputFrames[i] > frames)
+        {
+            frames = inputFrames[i];
+        }
+    }
+
+    if (frames == 0)
+    {
+        return 0;
+    }
+
+    memset(mixerPtr->accumulator, 0, frames * channels * sizeof(int32_t));
+
+    for (i = 0; i < mixerPtr->inputCount; i++)
+    {
+        if (inputFrames[i])
+        {
+            ConvertInput(mixerPtr, mixerPtr->inputs[i], inputFrames[i]);
+            Accumulate(mixerPtr->accumulator,
+                       mixerPtr->samples,
+                       inputFrames[i] * channels,
+                       mixerPtr->inputs[i]->gain);
+        }
+    }
+
+    Narrow(outPtr, mixerPtr->accumulator, frames * channels);
+
+    return frames;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy the samples of a single input unchanged.
+ *
+ * @return The number of bytes copied.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CopyInput
+(
+    Input_t* inputPtr,
+    uint8_t* outPtr,
+    uint32_t maxLength
+)
+{
+    uint32_t length = RingLevel(inputPtr);
+
+    if (length > maxLength)
+    {
+        length = maxLength;
+    }
+
+    // Keep incomplete frames until the end of the input, in case the input gets mixed
+    if (!inputPtr->ended)
+    {
+        length -= length % inputPtr->frameSize;
+    }
+
+    PeekRing(inputPtr, outPtr, length);
+    inputPtr->readCount += length;
+
+    return length;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the samples buffered by an input and the pending samples of its file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushInput
+(
+    Input_t* inputPtr
+)
+{
+    do
+    {
+        inputPtr->readCount = inputPtr->writeCount;
+    }
+    while ((FillRing(inputPtr) == LE_OK) && RingLevel(inputPtr));
+
+    inputPtr->readCount = inputPtr->writeCount;
+    inputPtr->phase = 0;
+    memset(inputPtr->prevFrame, 0, sizeof(inputPtr->prevFrame));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public declarations.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a mixer producing samples in the given PCM configuration.
+ *
+ * @return The mixer reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mixer_Ref_t le_mixer_Create
+(
+    const le_audio_SamplePcmConfig_t* outConfigPtr  ///< [IN] Configuration of the mixed samples
+)
+{
+    Mixer_t* mixerPtr = le_mem_ForceAlloc(MixerPool);
+
+    memset(mixerPtr, 0, sizeof(Mixer_t));
+    memcpy(&mixerPtr->config, outConfigPtr, sizeof(le_audio_SamplePcmConfig_t));
+    mixerPtr->frameSize = FrameSize(outConfigPtr);
+    mixerPtr->mutex = le_mutex_CreateNonRecursive("MixerMutex");
+
+    return mixerPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a mixer and all its inputs. The file descriptors of the inputs are not closed.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_Delete
+(
+    le_mixer_Ref_t mixerRef                         ///< [IN] Mixer reference
+)
+{
+    while (mixerRef->inputCount)
+    {
+        le_mixer_RemoveInput(mixerRef->inputs[0]);
+    }
+
+    le_mutex_Delete(mixerRef->mutex);
+    le_mem_Release(mixerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an input to a mixer. The samples are read from the file descriptor, which is switched to
+ * non-blocking mode until the input is removed.
+ *
+ * An input in the output configuration is passed through unchanged while it is the only input of
+ * the mixer. Otherwise the input is mixed, which requires 16-bit samples on both sides and either
+ * the output number of channels or a mono input. Inputs at another sample rate are resampled.
+ *
+ * @return The input reference, or NULL if the input can't be mixed with the current inputs or the
+ *         mixer is full.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mixer_InputRef_t le_mixer_AddInput
+(
+    le_mixer_Ref_t                    mixerRef,     ///< [IN] Mixer reference
+    int                               fd,           ///< [IN] File descriptor to read samples from
+    const le_audio_SamplePcmConfig_t* inConfigPtr,  ///< [IN] Configuration of the input samples
+    uint32_t                          gain          ///< [IN] Input gain, up to LE_MIXER_GAIN_MAX
+)
+{
+    Input_t* inputPtr = NULL;
+    uint32_t i;
+    int      flags;
+
+    if ((gain > LE_MIXER_GAIN_MAX) || (FrameSize(inConfigPtr) == 0))
+    {
+        LE_ERROR("Bad input configuration");
+        return NULL;
+    }
+
+    if ((flags = fcntl(fd, F_GETFL, 0)) == -1)
+    {
+        LE_ERROR("fcntl error, errno.%d (%s)", errno, strerror(errno));
+        return NULL;
+    }
+
+    le_mutex_Lock(mixerRef->mutex);
+
+    if (mixerRef->inputCount == LE_MIXER_MAX_INPUTS)
+    {
+        LE_ERROR("Too many mixer inputs");
+        goto end;
+    }
+
+    if (mixerRef->inputCount || (gain != LE_MIXER_GAIN_UNITY) ||
+        (inConfigPtr->sampleRate != mixerRef->config.sampleRate) ||
+        (inConfigPtr->channelsCount != mixerRef->config.channelsCount) ||
+        (inConfigPtr->bitsPerSample != mixerRef->config.bitsPerSample))
+    {
+        if (!IsMixable(mixerRef, inConfigPtr))
+        {
+            LE_ERROR("Input can't be mixed: rate %d, channels %d, bitsPerSample %d",
+                     inConfigPtr->sampleRate, inConfigPtr->channelsCount,
+                     inConfigPtr->bitsPerSample);
+            goto end;
+        }
+
+        for (i = 0; i < mixerRef->inputCount; i++)
+        {
+            if (!IsMixable(mixerRef, &mixerRef->inputs[i]->config))
+            {
+                LE_ERROR("Input %d can't be mixed", i);
+                goto end;
+            }
+        }
+    }
+
+    if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+    {
+        LE_ERROR("fcntl error, errno.%d (%s)", errno, strerror(errno));
+        goto end;
+    }
+
+    inputPtr = le_mem_ForceAlloc(InputPool);
+    memset(inputPtr, 0, offsetof(Input_t, ring));
+
+    inputPtr->mixerRef = mixerRef;
+    inputPtr->fd = fd;
+    inputPtr->fdFlags = flags;
+    memcpy(&inputPtr->config, inConfigPtr, sizeof(le_audio_SamplePcmConfig_t));
+    inputPtr->frameSize = FrameSize(inConfigPtr);
+    inputPtr->gain = gain;
+
+    if (inConfigPtr->sampleRate != mixerRef->config.sampleRate)
+    {
+        inputPtr->step = (((uint64_t)inConfigPtr->sampleRate << PHASE_SHIFT) +
+                          mixerRef->config.sampleRate / 2) / mixerRef->config.sampleRate;
+    }
+
+    mixerRef->inputs[mixerRef->inputCount++] = inputPtr;
+
+    LE_DEBUG("Input %p added: fd %d, rate %d, channels %d, gain %d", inputPtr, fd,
+             inConfigPtr->sampleRate, inConfigPtr->channelsCount, gain);
+
+end:
+    le_mutex_Unlock(mixerRef->mutex);
+
+    return inputPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove an input from its mixer. The file descriptor is not closed.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_RemoveInput
+(
+    le_mixer_InputRef_t inputRef                    ///< [IN] Input reference
+)
+{
+    Mixer_t* mixerPtr = inputRef->mixerRef;
+    uint32_t i;
+
+    le_mutex_Lock(mixerPtr->mutex);
+
+    for (i = 0; i < mixerPtr->inputCount; i++)
+    {
+        if (mixerPtr->inputs[i] == inputRef)
+        {
+            mixerPtr->inputs[i] = mixerPtr->inputs[--mixerPtr->inputCount];
+            break;
+        }
+    }
+
+    le_mutex_Unlock(mixerPtr->mutex);
+
+    if (fcntl(inputRef->fd, F_SETFL, inputRef->fdFlags) == -1)
+    {
+        LE_WARN("fcntl error, errno.%d (%s)", errno, strerror(errno));
+    }
+
+    le_mem_Release(inputRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the gain of a mixer input.
+ *
+ * @return LE_OK            The function succeeded.
+ * @return LE_OUT_OF_RANGE  The gain is above LE_MIXER_GAIN_MAX.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_mixer_SetGain
+(
+    le_mixer_InputRef_t inputRef,                   ///< [IN] Input reference
+    uint32_t            gain                        ///< [IN] Input gain
+)
+{
+    if (gain > LE_MIXER_GAIN_MAX)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    le_mutex_Lock(inputRef->mixerRef->mutex);
+    inputRef->gain = gain;
+    le_mutex_Unlock(inputRef->mixerRef->mutex);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether all the samples of an input have been read, i.e. the end of file was reached on
+ * its file descriptor and its buffer is empty.
+ *
+ * @return true if the input has ended.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_mixer_IsInputEnded
+(
+    le_mixer_InputRef_t inputRef                    ///< [IN] Input reference
+)
+{
+    bool ended;
+
+    le_mutex_Lock(inputRef->mixerRef->mutex);
+    ended = inputRef->ended && (RingLevel(inputRef) < inputRef->frameSize);
+    le_mutex_Unlock(inputRef->mixerRef->mutex);
+
+    return ended;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the samples buffered by all the inputs of a mixer.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_Flush
+(
+    le_mixer_Ref_t mixerRef                         ///< [IN] Mixer reference
+)
+{
+    uint32_t i;
+
+    le_mutex_Lock(mixerRef->mutex);
+
+    for (i = 0; i < mixerRef->inputCount; i++)
+    {
+        FlushInput(mixerRef->inputs[i]);
+    }
+
+    le_mutex_Unlock(mixerRef->mutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read mixed samples. The inputs are read with large non-blocking reads into their ring buffers,
+ * the function only waits for samples, up to the given timeout, when none of the inputs has any.
+ *
+ * @return LE_OK            The function succeeded. The buffer length is set to the number of bytes
+ *                          produced, which is lower than requested only if the inputs ran dry.
+ * @return LE_FAULT         An input could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_mixer_Read
+(
+    le_mixer_Ref_t mixerRef,                        ///< [IN] Mixer reference
+    uint8_t*       bufferPtr,                       ///< [OUT] Buffer to fill with samples
+    uint32_t*      bufLenPtr,                       ///< [INOUT] Buffer length in bytes
+    long           timeoutUsec                      ///< [IN] Time to wait for samples when all the
+                                                    ///<      inputs are empty
+)
+{
+    le_result_t res = LE_OK;
+    uint32_t    amount = 0;
+    uint32_t    i;
+
+    le_mutex_Lock(mixerRef->mutex);
+
+    while (amount < *bufLenPtr)
+    {
+        uint32_t size = *bufLenPtr - amount;
+        uint32_t len;
+        bool     isEnded = true;
+
+        // Top up the inputs which can't provide the requested samples
+        for (i = 0; i < mixerRef->inputCount; i++)
+        {
+            Input_t* inputPtr = mixerRef->inputs[i];
+
+            if (RingLevel(inputPtr) < RING_SIZE / 2)
+            {
+                if (FillRing(inputPtr) != LE_OK)
+                {
+                    res = LE_FAULT;
+                    goto end;
+                }
+            }
+
+            isEnded = isEnded && inputPtr->ended;
+        }
+
+        if ((mixerRef->inputCount == 1) && IsPassthrough(mixerRef, mixerRef->inputs[0]))
+        {
+            len = CopyInput(mixerRef->inputs[0], bufferPtr + amount, size);
+        }
+        else
+        {
+            len = MixChunk(mixerRef, (int16_t*)(bufferPtr + amount), size / mixerRef->frameSize)
+                  * mixerRef->frameSize;
+        }
+
+        if (len)
+        {
+            amount += len;
+        }
+        else if (isEnded || (size < mixerRef->frameSize))
+        {
+            break;
+        }
+        else
+        {
+            res = WaitInputs(mixerRef, timeoutUsec);
+
+            if (res == LE_TIMEOUT)
+            {
+                LE_DEBUG("No data read");
+                res = LE_OK;
+                break;
+            }
+            else if (res != LE_OK)
+            {
+                goto end;
+            }
+        }
+    }
+
+end:
+    le_mutex_Unlock(mixerRef->mutex);
+
+    *bufLenPtr = amount;
+
+    return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the mixer module.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_Init
+(
+    void
+)
+{
+    MixerPool = le_mem_CreatePool("MixerPool", sizeof(Mixer_t));
+    InputPool = le_mem_CreatePool("MixerInputPool", sizeof(Input_t));
+}
@@ -0,0 +1,148 @@
+/** @file le_mixer_local.h
+ *
+ * Software mixer and sample rate converter stage used to feed a playback PCM from several sources.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_LEMIXERLOCAL_INCLUDE_GUARD
+#define LEGATO_LEMIXERLOCAL_INCLUDE_GUARD
+
+#include "le_audio_local.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of inputs of a mixer.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_MIXER_MAX_INPUTS     4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Input gains are fixed-point values, LE_MIXER_GAIN_UNITY leaves the input level unchanged.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_MIXER_GAIN_SHIFT     12
+#define LE_MIXER_GAIN_UNITY     (1 << LE_MIXER_GAIN_SHIFT)
+#define LE_MIXER_GAIN_MAX       (2 * LE_MIXER_GAIN_UNITY)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a mixer producing samples in the given PCM configuration.
+ *
+ * @return The mixer reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mixer_Ref_t le_mixer_Create
+(
+    const le_audio_SamplePcmConfig_t* outConfigPtr  ///< [IN] Configuration of the mixed samples
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a mixer and all its inputs. The file descriptors of the inputs are not closed.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_Delete
+(
+    le_mixer_Ref_t mixerRef                         ///< [IN] Mixer reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an input to a mixer. The samples are read from the file descriptor, which is switched to
+ * non-blocking mode until the input is removed.
+ *
+ * An input in the output configuration is passed through unchanged while it is the only input of
+ * the mixer. Otherwise the input is mixed, which requires 16-bit samples on both sides and either
+ * the output number of channels or a mono input. Inputs at another sample rate are resampled.
+ *
+ * @return The input reference, or NULL if the input can't be mixed with the current inputs or the
+ *         mixer is full.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mixer_InputRef_t le_mixer_AddInput
+(
+    le_mixer_Ref_t                    mixerRef,     ///< [IN] Mixer reference
+    int                               fd,           ///< [IN] File descriptor to read samples from
+    const le_audio_SamplePcmConfig_t* inConfigPtr,  ///< [IN] Configuration of the input samples
+    uint32_t                          gain          ///< [IN] Input gain, up to LE_MIXER_GAIN_MAX
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove an input from its mixer. The file descriptor is not closed.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_RemoveInput
+(
+    le_mixer_InputRef_t inputRef                    ///< [IN] Input reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the gain of a mixer input.
+ *
+ * @return LE_OK            The function succeeded.
+ * @return LE_OUT_OF_RANGE  The gain is above LE_MIXER_GAIN_MAX.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_mixer_SetGain
+(
+    le_mixer_InputRef_t inputRef,                   ///< [IN] Input reference
+    uint32_t            gain                        ///< [IN] Input gain
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether all the samples of an input have been read, i.e. the end of file was reached on
+ * its file descriptor and its buffer is empty.
+ *
+ * @return true if the input has ended.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_mixer_IsInputEnded
+(
+    le_mixer_InputRef_t inputRef                    ///< [IN] Input reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the samples buffered by all the inputs of a mixer.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_Flush
+(
+    le_mixer_Ref_t mixerRef                         ///< [IN] Mixer reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read mixed samples. The inputs are read with large non-blocking reads into their ring buffers,
+ * the function only waits for samples, up to the given timeout, when none of the inputs has any.
+ *
+ * @return LE_OK            The function succeeded. The buffer length is set to the number of bytes
+ *                          produced, which is lower than requested only if the inputs ran dry.
+ * @return LE_FAULT         An input could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_mixer_Read
+(
+    le_mixer_Ref_t mixerRef,                        ///< [IN] Mixer reference
+    uint8_t*       bufferPtr,                       ///< [OUT] Buffer to fill with samples
+    uint32_t*      bufLenPtr,                       ///< [INOUT] Buffer length in bytes
+    long           timeoutUsec                      ///< [IN] Time to wait for samples when all the
+                                                    ///<      inputs are empty
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the mixer module.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_Init
+(
+    void
+);
+
+#endif // LEGATO_LEMIXERLOCAL_INCLUDE_GUARD
@@ -0,0 +1,287 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Network configuration of the Data Connection Service
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ * Routes are configured through rtnetlink rather than by running the route tool from a shell, and
+ * the DHCP client is executed directly.  This saves the fork of a shell (and of the tool) each
+ * time the data connection is established or switched to another technology.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <sys/wait.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include "legato.h"
+#include "dcsNet.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP client and the environment it is run with
+ */
+//--------------------------------------------------------------------------------------------------
+#define DHCP_CLIENT_PATH    "/sbin/udhcpc"
+#define DHCP_CLIENT_ENV     "PATH=/usr/bin:/bin:/usr/local/sbin:/usr/sbin:/sbin"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffers used to send a rtnetlink request and to receive its acknowledgement
+ */
+//--------------------------------------------------------------------------------------------------
+#define REQUEST_BYTES       128
+#define ACK_BYTES           4096
+
+//--------------------------------------------------------------------------------------------------
+// Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequence number of the last rtnetlink request
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t SequenceNumber = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an attribute to a rtnetlink request
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddAttribute
+(
+    struct nlmsghdr* hdrPtr,    ///< [IN] Request
+    size_t bufferSize,          ///< [IN] Size of the request buffer
+    uint16_t type,              ///< [IN] Attribute type
+    const void* dataPtr,        ///< [IN] Attribute data
+    size_t dataSize             ///< [IN] Attribute data size
+)
+{
+    size_t offset = NLMSG_ALIGN(hdrPtr->nlmsg_len);
+
+    LE_ASSERT(offset + RTA_SPACE(dataSize) <= bufferSize);
+
+    struct rtattr* attrPtr = (struct rtattr*)((uint8_t*)hdrPtr + offset);
+
+    attrPtr->rta_type = type;
+    attrPtr->rta_len = RTA_LENGTH(dataSize);
+    memcpy(RTA_DATA(attrPtr), dataPtr, dataSize);
+
+    hdrPtr->nlmsg_len = offset + RTA_SPACE(dataSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request to the kernel and wait for its acknowledgement
+ *
+ * @return
+ *      - LE_OK     The request succeeded
+ *      - LE_FAULT  The request failed, or could not be sent
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendRequest
+(
+    struct nlmsghdr* hdrPtr     ///< [IN] Request
+)
+{
+    hdrPtr->nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+    hdrPtr->nlmsg_seq = ++SequenceNumber;
+
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (-1 == fd)
+    {
+        LE_ERROR("Unable to open rtnetlink socket: %m");
+        return LE_FAULT;
+    }
+
+    struct sockaddr_nl kernelAddr = { .nl_family = AF_NETLINK };
+    ssize_t len;
+
+    do
+    {
+        len = sendto(fd, hdrPtr, hdrPtr->nlmsg_len, 0,
+                     (struct sockaddr*)&kernelAddr, sizeof(kernelAddr));
+    }
+    while ((-1 == len) && (EINTR == errno));
+
+    if (len != (ssize_t)hdrPtr->nlmsg_len)
+    {
+        LE_ERROR("Unable to send rtnetlink request: %m");
+        close(fd);
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_OK;
+    bool acked = false;
+
+    while (!acked)
+    {
+        uint8_t ackBuffer[ACK_BYTES] __attribute__((aligned(NLMSG_ALIGNTO)));
+
+        len = recv(fd, ackBuffer, sizeof(ackBuffer), 0);
+        if (-1 == len)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            LE_ERROR("Unable to receive rtnetlink acknowledgement: %m");
+            result = LE_FAULT;
+            break;
+        }
+
+        struct nlmsghdr* ackPtr;
+        int remaining = len;
+
+        for (ackPtr = (struct nlmsghdr*)ackBuffer;
+             NLMSG_OK(ackPtr, remaining);
+             ackPtr = NLMSG_NEXT(ackPtr, remaining))
+        {
+            if ((NLMSG_ERROR != ackPtr->nlmsg_type) || (hdrPtr->nlmsg_seq != ackPtr->nlmsg_seq))
+            {
+                continue;
+            }
+
+            int error = -((struct nlmsgerr*)NLMSG_DATA(ackPtr))->error;
+
+            if (0 != error)
+            {
+                LE_ERROR("rtnetlink request failed: %s", strerror(error));
+                result = LE_FAULT;
+            }
+
+            acked = true;
+        }
+    }
+
+    close(fd);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replace the default route of an address family by a route through a gateway on an interface.
+ *
+ * The new route is sent as a single rtnetlink request replacing the current default route, if any,
+ * so the current route is kept when the new one is refused by the kernel (e.g. unreachable
+ * gateway).
+ *
+ * @return
+ *      - LE_OK     Function succeed
+ *      - LE_FAULT  Function failed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t dcsNet_SetDefaultGateway
+(
+    const char* interfacePtr,   ///< [IN] Interface name
+    const char* gatewayPtr,     ///< [IN] Gateway address
+    bool isIpv6                 ///< [IN] IPv6 or not
+)
+{
+    int family = isIpv6 ? AF_INET6 : AF_INET;
+    struct in6_addr gatewayAddr;
+
+    if (1 != inet_pton(family, gatewayPtr, &gatewayAddr))
+    {
+        LE_WARN("Invalid gateway address '%s'", gatewayPtr);
+        return LE_FAULT;
+    }
+
+    uint32_t interfaceIndex = if_nametoindex(interfacePtr);
+    if (0 == interfaceIndex)
+    {
+        LE_WARN("Unknown interface '%s'", interfacePtr);
+        return LE_FAULT;
+    }
+
+    uint8_t request[REQUEST_BYTES] __attribute__((aligned(NLMSG_ALIGNTO))) = { 0 };
+    struct nlmsghdr* hdrPtr = (struct nlmsghdr*)request;
+    struct rtmsg* rtPtr = NLMSG_DATA(hdrPtr);
+
+    // Replace the current default route, or create it if there is none.  The current route is not
+    // deleted first: the kernel handles the replacement atomically and leaves it untouched if the
+    // new route is refused.
+    hdrPtr->nlmsg_len = NLMSG_LENGTH(sizeof(*rtPtr));
+    hdrPtr->nlmsg_type = RTM_NEWROUTE;
+    hdrPtr->nlmsg_flags = NLM_F_CREATE | NLM_F_REPLACE;
+
+    rtPtr->rtm_family = family;
+    rtPtr->rtm_table = RT_TABLE_MAIN;
+    rtPtr->rtm_protocol = RTPROT_BOOT;
+    rtPtr->rtm_scope = RT_SCOPE_UNIVERSE;
+    rtPtr->rtm_type = RTN_UNICAST;
+
+    AddAttribute(hdrPtr, sizeof(request), RTA_GATEWAY, &gatewayAddr,
+                 isIpv6 ? sizeof(struct in6_addr) : sizeof(struct in_addr));
+    AddAttribute(hdrPtr, sizeof(request), RTA_OIF, &interfaceIndex, sizeof(interfaceIndex));
+
+    LE_DEBUG("Set default gateway %s on %s", gatewayPtr, interfacePtr);
+
+    return SendRequest(hdrPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Request an IP address for an interface by running the DHCP client.
+ *
+ * @return
+ *      - LE_OK     Function succeed
+ *      - LE_FAULT  Function failed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t dcsNet_AskForIpAddress
+(
+    const char* interfacePtr    ///< [IN] Interface name
+)
+{
+    pid_t pid = fork();
+
+    if (-1 == pid)
+    {
+        LE_ERROR("Unable to fork the DHCP client: %m");
+        return LE_FAULT;
+    }
+
+    if (0 == pid)
+    {
+        // Clear the signal mask so the DHCP client does not inherit our signal mask.
+        sigset_t sigSet;
+        sigfillset(&sigSet);
+        pthread_sigmask(SIG_UNBLOCK, &sigSet, NULL);
+
+        char* const envp[] = { DHCP_CLIENT_ENV, NULL };
+
+        execle(DHCP_CLIENT_PATH, DHCP_CLIENT_PATH, "-R", "-b", "-i", interfacePtr,
+               (char*)NULL, envp);
+
+        LE_ERROR("Unable to execute '%s': %m", DHCP_CLIENT_PATH);
+        _exit(EXIT_FAILURE);
+    }
+
+    int status;
+    pid_t waitResult;
+
+    do
+    {
+        waitResult = waitpid(pid, &status, 0);
+    }
+    while ((-1 == waitResult) && (EINTR == errno));
+
+    if ((-1 == waitResult) || !WIFEXITED(status) || (0 != WEXITSTATUS(status)))
+    {
+        LE_ERROR("DHCP client failed on %s, status 0x%x", interfacePtr,
+                 (-1 == waitResult) ? 0 : status);
+        return LE_FAULT;
+    }
+
+    LE_INFO("DHCP client successful!");
+    return LE_OK;
+}
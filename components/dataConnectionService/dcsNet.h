@@ -0,0 +1,45 @@
+/** @file dcsNet.h
+ *
+ * Network configuration functions of the Data Connection Service: default route and DHCP client.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_DCS_NET_INCLUDE_GUARD
+#define LEGATO_DCS_NET_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replace the default route of an address family by a route through a gateway on an interface.
+ *
+ * The new route is sent as a single rtnetlink request replacing the current default route, if any,
+ * so the current route is kept when the new one is refused by the kernel (e.g. unreachable
+ * gateway).
+ *
+ * @return
+ *      - LE_OK     Function succeed
+ *      - LE_FAULT  Function failed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t dcsNet_SetDefaultGateway
+(
+    const char* interfacePtr,   ///< [IN] Interface name
+    const char* gatewayPtr,     ///< [IN] Gateway address
+    bool isIpv6                 ///< [IN] IPv6 or not
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Request an IP address for an interface by running the DHCP client.
+ *
+ * @return
+ *      - LE_OK     Function succeed
+ *      - LE_FAULT  Function failed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t dcsNet_AskForIpAddress
+(
+    const char* interfacePtr    ///< [IN] Interface name
+);
+
+#endif // LEGATO_DCS_NET_INCLUDE_GUARD
@@ -36,6 +36,7 @@
 #include "interfaces.h"
 #include "le_cfg_interface.h"
 #include "mdmCfgEntries.h"
+#include "dcsNet.h"
 
 #include "le_print.h"
 
@@ -69,6 +70,14 @@
 //--------------------------------------------------------------------------------------------------
 #define ROUTE_FILE "/proc/net/route"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The DNS configuration file, and the maximum length of a nameserver line written into it
+ */
+//--------------------------------------------------------------------------------------------------
+#define RESOLV_CONF_FILE                "/etc/resolv.conf"
+#define RESOLV_CONF_NAMESERVER_MAX_LEN  (sizeof("nameserver \n") - 1 + LE_MDC_IPV6_ADDR_MAX_LEN)
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Definitions for sending request/release commands to data thread
@@ -535,45 +544,6 @@ static le_data_Technology_t GetNextTech
     }
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * IP Handling to be done once the wifi link is established
- *
- * @return
- *      - LE_OK     Function successful
- *      - LE_FAULT  Function failed
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t AskForIpAddress
-(
-    void
-)
-{
-    int16_t systemResult;
-    char tmpString[512];
-
-    // DHCP Client
-    snprintf(tmpString,
-             sizeof(tmpString),
-             "PATH=/usr/bin:/bin:/usr/local/sbin:/usr/sbin:/sbin;"
-             "/sbin/udhcpc -R -b -i %s",
-             WIFI_INTF
-            );
-
-    systemResult = system(tmpString);
-    // Return value of -1 means that the fork() has failed (see man system)
-    if (0 == WEXITSTATUS(systemResult))
-    {
-        LE_INFO("DHCP client successful!");
-        return LE_OK;
-    }
-    else
-    {
-        LE_ERROR("DHCP client failed: command %s, result %d", tmpString, systemResult);
-        return LE_FAULT;
-    }
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Event callback for Wifi Client changes
@@ -596,7 +566,7 @@ static void WifiClientEventHandler
             // and update connection status
             if ((LE_DATA_WIFI == CurrentTech) && (RequestCount > 0))
             {
-                if (LE_OK == AskForIpAddress())
+                if (LE_OK == dcsNet_AskForIpAddress(WIFI_INTF))
                 {
                     IsConnected = true;
                 }
@@ -863,55 +833,6 @@ static le_result_t LoadSelectedTechProfile
     return result;
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Check if a default gateway is set
- *
- * @return
- *      True or False
- */
-//--------------------------------------------------------------------------------------------------
-static bool IsDefaultGatewayPresent
-(
-    void
-)
-{
-    bool result = false;
-    le_result_t openResult;
-    FILE *routeFile;
-    char line[100] , *ifacePtr , *destPtr, *gwPtr, *saveptr;
-
-    routeFile = le_flock_OpenStream(ROUTE_FILE , LE_FLOCK_READ, &openResult);
-
-    if (NULL == routeFile)
-    {
-        LE_WARN("le_flock_OpenStream failed with error %d", openResult);
-        return result;
-    }
-
-    while (fgets(line, sizeof(line), routeFile))
-    {
-        ifacePtr = strtok_r(line, " \t", &saveptr);
-        destPtr  = strtok_r(NULL, " \t", &saveptr);
-        gwPtr    = strtok_r(NULL, " \t", &saveptr);
-
-        if ((NULL != ifacePtr) && (NULL != destPtr))
-        {
-            if (0 == strcmp(destPtr, "00000000"))
-            {
-                if (gwPtr)
-                {
-                    result = true;
-                    break;
-                }
-            }
-        }
-    }
-
-    le_flock_CloseStream(routeFile);
-    return result;
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Save the default route
@@ -1002,9 +923,6 @@ static le_result_t SetDefaultGateway
     bool isIpv6                 ///< [IN] IPv6 or not
 )
 {
-    const char *optionPtr = "";
-    char systemCmd[200] = {0};
-
     if ((0 == strcmp(gatewayPtr,"")) || (0 == strcmp(interfacePtr,"")))
     {
         LE_WARN("Default gateway or interface is empty");
@@ -1015,34 +933,7 @@ static le_result_t SetDefaultGateway
         LE_DEBUG("Try set the gateway %s on %s", gatewayPtr, interfacePtr);
     }
 
-    if (IsDefaultGatewayPresent())
-    {
-        // Remove the last default GW
-        LE_DEBUG("Execute '/sbin/route del default'");
-        if (-1 == system("/sbin/route del default"))
-        {
-            LE_WARN("system '%s' failed", systemCmd);
-            return LE_FAULT;
-        }
-    }
-
-    if (isIpv6)
-    {
-        optionPtr = "-A inet6";
-    }
-
-    // TODO: use of ioctl instead, should be done when rework the DCS
-    snprintf(systemCmd, sizeof(systemCmd),
-             "/sbin/route %s add default gw %s %s", optionPtr, gatewayPtr, interfacePtr);
-
-    LE_DEBUG("Execute '%s", systemCmd);
-    if (-1 == system(systemCmd))
-    {
-        LE_WARN("system '%s' failed", systemCmd);
-        return LE_FAULT;
-    }
-
-    return LE_OK;
+    return dcsNet_SetDefaultGateway(interfacePtr, gatewayPtr, isIpv6);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1168,10 +1059,10 @@ static char * ReadResolvConf
     char * fileContent = NULL;
     size_t fileSz;
 
-    fd = open("/etc/resolv.conf", O_RDONLY);
+    fd = open(RESOLV_CONF_FILE, O_RDONLY);
     if (fd < 0)
     {
-        LE_WARN("fopen on /etc/resolv.conf failed");
+        LE_WARN("open on %s failed", RESOLV_CONF_FILE);
         return NULL;
     }
 
@@ -1218,6 +1109,70 @@ static char * ReadResolvConf
     return fileContent;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a new DNS configuration into resolv.conf.
+ *
+ * resolv.conf is rewritten in place rather than replaced, since sandboxed applications bind-mount
+ * it into their sandbox and would keep reading the previous file if its inode changed.  The
+ * content is written at once and the file truncated afterwards, so that it is never seen empty.
+ * When the file shrinks, the new content is padded with empty lines up to the previous size, so
+ * that a reader never sees the end of the previous content after the new one.
+ *
+ * @return
+ *      LE_FAULT        Function failed
+ *      LE_OK           Function succeed
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteResolvConf
+(
+    char*  contentPtr,  ///< [IN] New content, padded in place
+    size_t contentLen,  ///< [IN] Length of the new content
+    size_t bufferSize   ///< [IN] Size of the content buffer
+)
+{
+    int fd = open(RESOLV_CONF_FILE, O_WRONLY | O_CREAT | O_CLOEXEC,
+                  S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0)
+    {
+        LE_WARN("open on %s failed: %m", RESOLV_CONF_FILE);
+        return LE_FAULT;
+    }
+
+    // Set mode=644 regardless of the umask
+    if (0 != fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH))
+    {
+        LE_WARN("fchmod on %s failed: %m", RESOLV_CONF_FILE);
+    }
+
+    le_result_t result = LE_OK;
+    size_t writeLen = contentLen;
+    struct stat fileStat;
+
+    if ((0 == fstat(fd, &fileStat)) && ((size_t)fileStat.st_size > contentLen))
+    {
+        writeLen = ((size_t)fileStat.st_size < bufferSize) ? (size_t)fileStat.st_size : bufferSize;
+        memset(contentPtr + contentLen, '\n', writeLen - contentLen);
+    }
+
+    if (   ((ssize_t)writeLen != pwrite(fd, contentPtr, writeLen, 0))
+        || (0 != ftruncate(fd, contentLen))
+        || (0 != fsync(fd))
+       )
+    {
+        LE_WARN("Writing %s failed: %m", RESOLV_CONF_FILE);
+        result = LE_FAULT;
+    }
+
+    if (0 != close(fd))
+    {
+        LE_WARN("close failed");
+        result = LE_FAULT;
+    }
+
+    return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write the DNS configuration into /etc/resolv.conf
@@ -1294,79 +1249,39 @@ static le_result_t AddNameserversToResolvConf
         return LE_OK;
     }
 
-    FILE*  resolvConfPtr;
-    mode_t oldMask;
-
-    // allow fopen to create file with mode=644
-    oldMask = umask(022);
-
-    resolvConfPtr = fopen("/etc/resolv.conf", "w");
-    if (NULL == resolvConfPtr)
-    {
-        // restore old mask
-        umask(oldMask);
-
-        LE_WARN("fopen on /etc/resolv.conf failed");
-        return LE_FAULT;
-    }
+    char content[sizeof(ResolvConfBuffer) + 2 * RESOLV_CONF_NAMESERVER_MAX_LEN];
+    size_t contentLen = 0;
 
     // Set DNS 1 if needed
-    if (addDns1 && (fprintf(resolvConfPtr, "nameserver %s\n", dns1Ptr) < 0))
+    if (addDns1)
     {
-        // restore old mask
-        umask(oldMask);
-
-        LE_WARN("fprintf failed");
-        if (0 != fclose(resolvConfPtr))
-        {
-            LE_WARN("fclose failed");
-        }
-        return LE_FAULT;
+        contentLen += snprintf(content + contentLen, sizeof(content) - contentLen,
+                               "nameserver %s\n", dns1Ptr);
     }
 
     // Set DNS 2 if needed
-    if (addDns2 && (fprintf(resolvConfPtr, "nameserver %s\n", dns2Ptr) < 0))
+    if (addDns2)
     {
-        // restore old mask
-        umask(oldMask);
+        contentLen += snprintf(content + contentLen, sizeof(content) - contentLen,
+                               "nameserver %s\n", dns2Ptr);
+    }
 
-        LE_WARN("fprintf failed");
-        if (0 != fclose(resolvConfPtr))
-        {
-            LE_WARN("fclose failed");
-        }
+    if (contentLen >= sizeof(content))
+    {
+        LE_WARN("DNS address too long");
         return LE_FAULT;
     }
 
     // Append rest of the file
     if (NULL != resolvConfSourcePtr)
     {
-        size_t writeLen = strlen(resolvConfSourcePtr);
-
-        if (writeLen != fwrite(resolvConfSourcePtr, sizeof(char), writeLen, resolvConfPtr))
-        {
-            // restore old mask
-            umask(oldMask);
-
-            LE_CRIT("Writing resolv.conf failed");
-            if (0 != fclose(resolvConfPtr))
-            {
-                LE_WARN("fclose failed");
-            }
-            return LE_FAULT;
-        }
-    }
+        size_t sourceLen = strlen(resolvConfSourcePtr);
 
-    // restore old mask
-    umask(oldMask);
-
-    if (0 != fclose(resolvConfPtr))
-    {
-        LE_WARN("fclose failed");
-        return LE_FAULT;
+        memcpy(content + contentLen, resolvConfSourcePtr, sourceLen);
+        contentLen += sourceLen;
     }
 
-    return LE_OK;
+    return WriteResolvConf(content, contentLen, sizeof(content));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1388,8 +1303,8 @@ static le_result_t RemoveNameserversFromResolvConf
     char* currentLinePtr = resolvConfSourcePtr;
     int currentLinePos = 0;
 
-    FILE*  resolvConfPtr;
-    mode_t oldMask;
+    char content[sizeof(ResolvConfBuffer) + 1];
+    size_t contentLen = 0;
 
     if (NULL == resolvConfSourcePtr)
     {
@@ -1397,19 +1312,6 @@ static le_result_t RemoveNameserversFromResolvConf
         return LE_OK;
     }
 
-    // allow fopen to create file with mode=644
-    oldMask = umask(022);
-
-    resolvConfPtr = fopen("/etc/resolv.conf", "w");
-    if (NULL == resolvConfPtr)
-    {
-        // restore old mask
-        umask(oldMask);
-
-        LE_WARN("fopen on /etc/resolv.conf failed");
-        return LE_FAULT;
-    }
-
     // For each line in source file
     while (true)
     {
@@ -1436,7 +1338,8 @@ static le_result_t RemoveNameserversFromResolvConf
                 // a new-line; always terminate with a new-line, since this is what is
                 // usually expected on linux.
                 currentLinePtr[currentLinePos] = '\n';
-                fwrite(currentLinePtr, sizeof(char), (currentLinePos+1), resolvConfPtr);
+                memcpy(content + contentLen, currentLinePtr, currentLinePos + 1);
+                contentLen += currentLinePos + 1;
             }
 
             if ('\0' == sourceLineEnd)
@@ -1456,16 +1359,7 @@ static le_result_t RemoveNameserversFromResolvConf
         }
     }
 
-    // restore old mask
-    umask(oldMask);
-
-    if (0 != fclose(resolvConfPtr))
-    {
-        LE_WARN("fclose failed");
-        return LE_FAULT;
-    }
-
-    return LE_OK;
+    return WriteResolvConf(content, contentLen, sizeof(content));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -135,10 +135,52 @@ typedef struct le_gnss_PositionSample
     bool             satMeasValid;           ///< if true, satMeas is set
     le_gnss_SvMeas_t satMeas[LE_GNSS_SV_INFO_MAX_LEN];
                                              ///< Satellite Vehicle measurement information.
-    le_dls_Link_t   link;                    ///< Object node link
 }
 le_gnss_PositionSample_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position sample's values as reported to the clients by le_gnss_GetSample() and the
+ * PositionSample event handlers, with the invalid fields set to their invalid value.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_gnss_FixState_t state;             ///< Position fix state
+    int32_t            latitude;          ///< WGS84 Latitude
+    int32_t            longitude;         ///< WGS84 Longitude
+    int32_t            hAccuracy;         ///< Horizontal position's accuracy
+    int32_t            altitude;          ///< Altitude above Mean Sea Level
+    int32_t            vAccuracy;         ///< Vertical position's accuracy
+    int32_t            altitudeOnWgs84;   ///< Altitude with respect to the WGS-84 ellipsoid
+    uint32_t           hSpeed;            ///< Horizontal speed
+    uint32_t           hSpeedAccuracy;    ///< Horizontal speed's accuracy
+    int32_t            vSpeed;            ///< Vertical speed
+    int32_t            vSpeedAccuracy;    ///< Vertical speed's accuracy
+    uint32_t           direction;         ///< Direction
+    uint32_t           directionAccuracy; ///< Direction's accuracy
+    int32_t            magneticDeviation; ///< Magnetic deviation
+    uint16_t           year;              ///< UTC Year
+    uint16_t           month;             ///< UTC Month
+    uint16_t           day;               ///< UTC Day
+    uint16_t           hours;             ///< UTC Hours
+    uint16_t           minutes;           ///< UTC Minutes
+    uint16_t           seconds;           ///< UTC Seconds
+    uint16_t           milliseconds;      ///< UTC Milliseconds
+    uint64_t           epochTime;         ///< Epoch time in milliseconds
+    uint32_t           timeAccuracy;      ///< Time accuracy in milliseconds
+    uint32_t           gpsWeek;           ///< GPS week number
+    uint32_t           gpsTimeOfWeek;     ///< Time in milliseconds into the GPS week
+    uint16_t           hdop;              ///< Horizontal Dilution of Precision
+    uint16_t           vdop;              ///< Vertical Dilution of Precision
+    uint16_t           pdop;              ///< Position Dilution of Precision
+    uint8_t            satsInViewCount;   ///< Satellites in View count
+    uint8_t            satsTrackingCount; ///< Tracking satellites in View count
+    uint8_t            satsUsedCount;     ///< Satellites in View used for Navigation
+}
+le_gnss_SampleValues_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Position Sample's Handler structure.
@@ -149,10 +191,54 @@ typedef struct le_gnss_PositionHandler
 {
     le_gnss_PositionHandlerFunc_t handlerFuncPtr;      ///< The handler function address.
     void*                         handlerContextPtr;   ///< The handler function context.
+    le_msg_SessionRef_t           sessionRef;          ///< The client session of the handler.
     le_dls_Link_t                 link;                ///< Object node link
 }
 le_gnss_PositionHandler_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position Sample's values Handler structure (push mode).
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_gnss_PositionSampleHandler
+{
+    le_gnss_PositionSampleHandlerFunc_t handlerFuncPtr;    ///< The handler function address.
+    void*                               handlerContextPtr; ///< The handler function context.
+    le_dls_Link_t                       link;              ///< Object node link
+}
+le_gnss_PositionSampleHandler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client holding position sample references.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t sessionRef;     ///< The client session, NULL for the daemon itself.
+    le_dls_List_t       sampleRefList;  ///< The position sample references held by the client.
+}
+le_gnss_SampleOwner_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position sample reference given to a client. The position sample itself is shared by all its
+ * references, each of them holding one of the sample's reference counts.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_gnss_PositionSample_t*   positionSamplePtr;  ///< The position sample.
+    le_gnss_SampleRef_t         safeRef;            ///< The safe reference given to the client.
+    le_gnss_SampleOwner_t*      ownerPtr;           ///< The client holding the reference.
+    le_dls_Link_t               link;               ///< Link in the owner's sampleRefList.
+}
+le_gnss_SampleRefNode_t;
+
 //--------------------------------------------------------------------------------------------------
 // Static declarations.
 //--------------------------------------------------------------------------------------------------
@@ -205,6 +291,30 @@ static int32_t NumOfPositionHandlers = 0;
 //--------------------------------------------------------------------------------------------------
 static le_dls_List_t PositionHandlerList = LE_DLS_LIST_INIT;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for position sample's values handlers.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   PositionSampleHandlerPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of position sample's values handler functions.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t NumOfPositionSampleHandlers = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create and initialize the position sample's values handlers list.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t PositionSampleHandlerList = LE_DLS_LIST_INIT;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory Pool for position samples.
@@ -223,15 +333,24 @@ static le_mem_PoolRef_t   PositionSamplePoolRef;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create and initialize the position samples list.
+ * Memory Pools for position sample references and for the clients holding them.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   SampleRefPoolRef;
+static le_mem_PoolRef_t   SampleOwnerPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clients holding position sample references, by client session.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_dls_List_t PositionSampleList = LE_DLS_LIST_INIT;
+static le_hashmap_Ref_t SampleOwnerMap;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Safe Reference Map for Positioning Sample objects.
+ * Safe Reference Map for Positioning Sample references (le_gnss_SampleRefNode_t objects).
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -284,42 +403,103 @@ static void PositionHandlerDestructor
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Position Sample destructor.
+ * Create a position sample reference for a client.
  *
+ * The reference takes over one of the reference counts of the position sample.
+ *
+ * @return The position sample's safe reference.
  */
 //--------------------------------------------------------------------------------------------------
-static void PositionSampleDestructor
+static le_gnss_SampleRef_t CreateSampleRef
 (
-    void* obj
+    le_gnss_PositionSample_t*   positionSamplePtr,  ///< [IN] The position sample.
+    le_msg_SessionRef_t         sessionRef          ///< [IN] The client session.
 )
 {
-    le_gnss_PositionSample_t *positionSampleNodePtr;
-    le_dls_Link_t   *linkPtr;
+    le_gnss_SampleOwner_t*   ownerPtr = le_hashmap_Get(SampleOwnerMap, sessionRef);
+    le_gnss_SampleRefNode_t* sampleRefPtr = le_mem_ForceAlloc(SampleRefPoolRef);
 
-    LE_FATAL_IF((obj == NULL), "Position Sample Object does not exist!");
+    if (ownerPtr == NULL)
+    {
+        ownerPtr = le_mem_ForceAlloc(SampleOwnerPoolRef);
+        ownerPtr->sessionRef = sessionRef;
+        ownerPtr->sampleRefList = LE_DLS_LIST_INIT;
+        le_hashmap_Put(SampleOwnerMap, sessionRef, ownerPtr);
+    }
 
-    linkPtr = le_dls_Peek(&PositionSampleList);
-    if (linkPtr != NULL)
+    sampleRefPtr->positionSamplePtr = positionSamplePtr;
+    sampleRefPtr->ownerPtr = ownerPtr;
+    sampleRefPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&ownerPtr->sampleRefList, &sampleRefPtr->link);
+
+    sampleRefPtr->safeRef = le_ref_CreateRef(PositionSampleMap, sampleRefPtr);
+
+    return sampleRefPtr->safeRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a position sample reference, and the position sample if it was the last one.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseSampleRef
+(
+    le_gnss_SampleRefNode_t* sampleRefPtr   ///< [IN] The position sample reference.
+)
+{
+    le_dls_Remove(&sampleRefPtr->ownerPtr->sampleRefList, &sampleRefPtr->link);
+    le_ref_DeleteRef(PositionSampleMap, sampleRefPtr->safeRef);
+    le_mem_Release(sampleRefPtr->positionSamplePtr);
+    le_mem_Release(sampleRefPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the position sample of a position sample reference.
+ *
+ * @return The position sample, or NULL if the reference is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnss_PositionSample_t* GetPositionSample
+(
+    le_gnss_SampleRef_t positionSampleRef   ///< [IN] The position sample's reference.
+)
+{
+    le_gnss_SampleRefNode_t* sampleRefPtr = le_ref_Lookup(PositionSampleMap, positionSampleRef);
+
+    return (sampleRefPtr == NULL) ? NULL : sampleRefPtr->positionSamplePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function called when a client session closes: releases all the position sample
+ * references still held by the client.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSessionEventHandler
+(
+    le_msg_SessionRef_t sessionRef,     ///< [IN] The closed client session.
+    void*               contextPtr      ///< [IN] Unused.
+)
+{
+    le_gnss_SampleOwner_t* ownerPtr = le_hashmap_Remove(SampleOwnerMap, sessionRef);
+    le_dls_Link_t*         linkPtr;
+
+    if (ownerPtr == NULL)
     {
-        do
-        {
-            // Get the node from the list
-            positionSampleNodePtr = (le_gnss_PositionSample_t*)
-                                    CONTAINER_OF(linkPtr, le_gnss_PositionSample_t, link);
-            // Check the node.
-            if ( positionSampleNodePtr == (le_gnss_PositionSample_t*)obj)
-            {
-                // Remove the node.
-                le_dls_Remove(&PositionSampleList, linkPtr);
-                linkPtr=NULL;
-            }
-            else
-            {
-                // Move to the next node.
-                linkPtr = le_dls_PeekNext(&PositionSampleList, linkPtr);
-            }
-        } while (linkPtr != NULL);
+        return;
     }
+
+    LE_DEBUG("Release the position samples of session %p", sessionRef);
+
+    while ((linkPtr = le_dls_Peek(&ownerPtr->sampleRefList)) != NULL)
+    {
+        ReleaseSampleRef(CONTAINER_OF(linkPtr, le_gnss_SampleRefNode_t, link));
+    }
+
+    le_mem_Release(ownerPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -585,12 +765,155 @@ static void GetPosSampleData
         posSampleDataPtr->satMeas[i].satLatency = paPosDataPtr->satMeas[i].satLatency;
     }
 
-    // Node Link
-    posSampleDataPtr->link = LE_DLS_LINK_INIT;
-
     return;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the values of a position sample as reported to the clients, with the invalid fields set to
+ * the invalid value used by the individual getters.
+ *
+ * @return
+ *      LE_OK if all the values are valid.
+ *      LE_OUT_OF_RANGE if one of the values is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetSampleValues
+(
+    const le_gnss_PositionSample_t* posSampleDataPtr,  // [IN] The position sample.
+    le_gnss_SampleValues_t* valuesPtr                  // [OUT] The position sample's values.
+)
+{
+    bool allValid = true;
+
+#define SAMPLE_VALUE(validFlag, field, value, invalidValue) \
+    if (posSampleDataPtr->validFlag)                        \
+    {                                                       \
+        valuesPtr->field = (value);                         \
+    }                                                       \
+    else                                                    \
+    {                                                       \
+        valuesPtr->field = (invalidValue);                  \
+        allValid = false;                                   \
+    }
+
+    valuesPtr->state = posSampleDataPtr->fixState;
+
+    SAMPLE_VALUE(latitudeValid, latitude, posSampleDataPtr->latitude, INT32_MAX);
+    SAMPLE_VALUE(longitudeValid, longitude, posSampleDataPtr->longitude, INT32_MAX);
+    SAMPLE_VALUE(hAccuracyValid, hAccuracy, posSampleDataPtr->hAccuracy, INT32_MAX);
+    SAMPLE_VALUE(altitudeValid, altitude, posSampleDataPtr->altitude, INT32_MAX);
+    SAMPLE_VALUE(vAccuracyValid, vAccuracy, posSampleDataPtr->vAccuracy, INT32_MAX);
+    SAMPLE_VALUE(altitudeOnWgs84Valid, altitudeOnWgs84, posSampleDataPtr->altitudeOnWgs84,
+                 INT32_MAX);
+    SAMPLE_VALUE(hSpeedValid, hSpeed, posSampleDataPtr->hSpeed, UINT32_MAX);
+    SAMPLE_VALUE(hSpeedAccuracyValid, hSpeedAccuracy, posSampleDataPtr->hSpeedAccuracy,
+                 UINT32_MAX);
+    SAMPLE_VALUE(vSpeedValid, vSpeed, posSampleDataPtr->vSpeed, INT32_MAX);
+    SAMPLE_VALUE(vSpeedAccuracyValid, vSpeedAccuracy, posSampleDataPtr->vSpeedAccuracy,
+                 INT32_MAX);
+    SAMPLE_VALUE(directionValid, direction, posSampleDataPtr->direction, UINT32_MAX);
+    SAMPLE_VALUE(directionAccuracyValid, directionAccuracy, posSampleDataPtr->directionAccuracy,
+                 UINT32_MAX);
+    SAMPLE_VALUE(magneticDeviationValid, magneticDeviation, posSampleDataPtr->magneticDeviation,
+                 INT32_MAX);
+    SAMPLE_VALUE(dateValid, year, posSampleDataPtr->year, 0);
+    SAMPLE_VALUE(dateValid, month, posSampleDataPtr->month, 0);
+    SAMPLE_VALUE(dateValid, day, posSampleDataPtr->day, 0);
+    SAMPLE_VALUE(timeValid, hours, posSampleDataPtr->hours, 0);
+    SAMPLE_VALUE(timeValid, minutes, posSampleDataPtr->minutes, 0);
+    SAMPLE_VALUE(timeValid, seconds, posSampleDataPtr->seconds, 0);
+    SAMPLE_VALUE(timeValid, milliseconds, posSampleDataPtr->milliseconds, 0);
+    SAMPLE_VALUE(timeAccuracyValid, timeAccuracy, posSampleDataPtr->timeAccuracy, UINT16_MAX);
+    SAMPLE_VALUE(gpsTimeValid, gpsWeek, posSampleDataPtr->gpsWeek, 0);
+    SAMPLE_VALUE(gpsTimeValid, gpsTimeOfWeek, posSampleDataPtr->gpsTimeOfWeek, 0);
+    SAMPLE_VALUE(hdopValid, hdop, posSampleDataPtr->hdop, UINT16_MAX);
+    SAMPLE_VALUE(vdopValid, vdop, posSampleDataPtr->vdop, UINT16_MAX);
+    SAMPLE_VALUE(pdopValid, pdop, posSampleDataPtr->pdop, UINT16_MAX);
+    SAMPLE_VALUE(satsInViewCountValid, satsInViewCount, posSampleDataPtr->satsInViewCount,
+                 UINT8_MAX);
+    SAMPLE_VALUE(satsTrackingCountValid, satsTrackingCount, posSampleDataPtr->satsTrackingCount,
+                 UINT8_MAX);
+    SAMPLE_VALUE(satsUsedCountValid, satsUsedCount, posSampleDataPtr->satsUsedCount, UINT8_MAX);
+
+#undef SAMPLE_VALUE
+
+    // The epoch time has no validity flag, 0 means it is not set.
+    valuesPtr->epochTime = posSampleDataPtr->epochTime;
+    if (0 == posSampleDataPtr->epochTime)
+    {
+        allValid = false;
+    }
+
+    return (allValid ? LE_OK : LE_OUT_OF_RANGE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the last position sample's values to the position sample's values handlers.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportPositionSampleValues
+(
+    void
+)
+{
+    le_gnss_SampleValues_t values;
+    le_dls_Link_t* linkPtr = le_dls_Peek(&PositionSampleHandlerList);
+
+    if (NULL == linkPtr)
+    {
+        return;
+    }
+
+    // The values are computed once and pushed to each handler, no position sample is created.
+    GetSampleValues(&LastPositionSample, &values);
+
+    do
+    {
+        le_gnss_PositionSampleHandler_t* handlerNodePtr =
+            CONTAINER_OF(linkPtr, le_gnss_PositionSampleHandler_t, link);
+
+        // Move to the next node first, in case the handler removes itself.
+        linkPtr = le_dls_PeekNext(&PositionSampleHandlerList, linkPtr);
+
+        handlerNodePtr->handlerFuncPtr(values.state,
+                                       values.latitude,
+                                       values.longitude,
+                                       values.hAccuracy,
+                                       values.altitude,
+                                       values.vAccuracy,
+                                       values.altitudeOnWgs84,
+                                       values.hSpeed,
+                                       values.hSpeedAccuracy,
+                                       values.vSpeed,
+                                       values.vSpeedAccuracy,
+                                       values.direction,
+                                       values.directionAccuracy,
+                                       values.magneticDeviation,
+                                       values.year,
+                                       values.month,
+                                       values.day,
+                                       values.hours,
+                                       values.minutes,
+                                       values.seconds,
+                                       values.milliseconds,
+                                       values.epochTime,
+                                       values.timeAccuracy,
+                                       values.gpsWeek,
+                                       values.gpsTimeOfWeek,
+                                       values.hdop,
+                                       values.vdop,
+                                       values.pdop,
+                                       values.satsInViewCount,
+                                       values.satsTrackingCount,
+                                       values.satsUsedCount,
+                                       handlerNodePtr->handlerContextPtr);
+    } while (linkPtr != NULL);
+}
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -644,6 +967,9 @@ static void PaPositionHandler
     // Get the position sample data from the PA position data report
     GetPosSampleData(&LastPositionSample, positionPtr);
 
+    // Push the position sample's values to the handlers registered for them
+    ReportPositionSampleValues();
+
     if(!NumOfPositionHandlers)
     {
         LE_DEBUG("No positioning handlers, exit Handler Function");
@@ -661,9 +987,6 @@ static void PaPositionHandler
         // Copy the position sample to the position sample node
         memcpy(positionSampleNodePtr, &LastPositionSample, sizeof(le_gnss_PositionSample_t));
 
-        // Add the node to the queue of the list by passing in the node's link.
-        le_dls_Queue(&PositionSampleList, &(positionSampleNodePtr->link));
-
         // Add reference for each subscribed handler
         for(i=0 ; i<NumOfPositionHandlers-1 ; i++)
         {
@@ -682,8 +1005,8 @@ static void PaPositionHandler
                      positionHandlerNodePtr->handlerFuncPtr);
 
             // Create a safe reference and call the client's handler
-            void* safePositionSampleRef = le_ref_CreateRef(PositionSampleMap,
-                                                           positionSampleNodePtr);
+            void* safePositionSampleRef = CreateSampleRef(positionSampleNodePtr,
+                                                          positionHandlerNodePtr->sessionRef);
             if(safePositionSampleRef != NULL)
             {
                 positionHandlerNodePtr->handlerFuncPtr(safePositionSampleRef
@@ -697,6 +1020,48 @@ static void PaPositionHandler
     le_mem_Release(positionPtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subscribe to the PA position data handler, if not done yet.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SubscribePaPositionHandler
+(
+    void
+)
+{
+    if (PaHandlerRef == NULL)
+    {
+        if ((PaHandlerRef=pa_gnss_AddPositionDataHandler(PaPositionHandler)) == NULL)
+        {
+            LE_ERROR("Failed to add PA position Data handler!");
+        }
+        else
+        {
+            LE_DEBUG("PaHandlerRef %p subscribed", PaHandlerRef);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsubscribe from the PA position data handler once no handler of either kind is left.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnsubscribePaPositionHandler
+(
+    void
+)
+{
+    if ((NumOfPositionHandlers == 0) && (NumOfPositionSampleHandlers == 0))
+    {
+        pa_gnss_RemovePositionDataHandler(PaHandlerRef);
+        PaHandlerRef = NULL;
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to initialize the GNSS
@@ -756,17 +1121,32 @@ le_result_t gnss_Init
                                                 , sizeof(le_gnss_PositionHandler_t));
     le_mem_SetDestructor(PositionHandlerPoolRef, PositionHandlerDestructor);
 
+    // Create a pool for Position Sample's values Handler objects
+    PositionSampleHandlerPoolRef = le_mem_CreatePool("PositionSampleHandlerPoolRef"
+                                                , sizeof(le_gnss_PositionSampleHandler_t));
+
     // Create a pool for Position Sample objects
     PositionSamplePoolRef = le_mem_CreatePool("PositionSamplePoolRef"
                                             , sizeof(le_gnss_PositionSample_t));
     le_mem_ExpandPool(PositionSamplePoolRef,GNSS_POSITION_SAMPLE_MAX);
-    le_mem_SetDestructor(PositionSamplePoolRef, PositionSampleDestructor);
+
+    // Create the pools for position sample references, and the clients holding them
+    SampleRefPoolRef = le_mem_CreatePool("SampleRefPoolRef", sizeof(le_gnss_SampleRefNode_t));
+    SampleOwnerPoolRef = le_mem_CreatePool("SampleOwnerPoolRef", sizeof(le_gnss_SampleOwner_t));
+    SampleOwnerMap = le_hashmap_Create("SampleOwnerMap",
+                                       GNSS_POSITION_ACTIVATION_MAX,
+                                       le_hashmap_HashVoidPointer,
+                                       le_hashmap_EqualsVoidPointer);
+
+    // The position samples still held by a client are released when it disconnects.
+    le_msg_AddServiceCloseHandler(le_gnss_GetServiceRef(), CloseSessionEventHandler, NULL);
 
     // Create the reference HashMap for positioning sample
     PositionSampleMap = le_ref_CreateMap("PositionSampleMap", GNSS_POSITION_SAMPLE_MAX);
 
     // Initialize Handler context
     NumOfPositionHandlers = 0;
+    NumOfPositionSampleHandlers = 0;
     PaHandlerRef = NULL;
 
     // Initialize last Position sample
@@ -840,21 +1220,12 @@ le_gnss_PositionHandlerRef_t le_gnss_AddPositionHandler
     positionHandlerPtr = (le_gnss_PositionHandler_t*)le_mem_ForceAlloc(PositionHandlerPoolRef);
     positionHandlerPtr->handlerFuncPtr = handlerPtr;
     positionHandlerPtr->handlerContextPtr = contextPtr;
+    positionHandlerPtr->sessionRef = le_gnss_GetClientSessionRef();
 
     LE_DEBUG("handler %p", handlerPtr);
 
     // Subscribe to PA position Data handler
-    if (PaHandlerRef == NULL)
-    {
-        if ((PaHandlerRef=pa_gnss_AddPositionDataHandler(PaPositionHandler)) == NULL)
-        {
-            LE_ERROR("Failed to add PA position Data handler!");
-        }
-        else
-        {
-            LE_DEBUG("PaHandlerRef %p subscribed", PaHandlerRef);
-        }
-    }
+    SubscribePaPositionHandler();
 
     // Update the position handler list with that new handler
     le_dls_Queue(&PositionHandlerList, &(positionHandlerPtr->link));
@@ -906,11 +1277,81 @@ void le_gnss_RemovePositionHandler
         } while (linkPtr != NULL);
     }
 
-    if(NumOfPositionHandlers == 0)
+    UnsubscribePaPositionHandler();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to register an handler for position notifications by value.
+ *
+ *  - A handler reference, which is only needed for later removal of the handler.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_gnss_PositionSampleHandlerRef_t le_gnss_AddPositionSampleHandler
+(
+    le_gnss_PositionSampleHandlerFunc_t handlerPtr,    ///< [IN] The handler function.
+    void*                               contextPtr     ///< [IN] The context pointer
+)
+{
+    le_gnss_PositionSampleHandler_t*  handlerNodePtr=NULL;
+
+    LE_FATAL_IF((handlerPtr == NULL), "handlerPtr pointer is NULL !");
+
+    // Create the position sample's values handler node.
+    handlerNodePtr =
+        (le_gnss_PositionSampleHandler_t*)le_mem_ForceAlloc(PositionSampleHandlerPoolRef);
+    handlerNodePtr->handlerFuncPtr = handlerPtr;
+    handlerNodePtr->handlerContextPtr = contextPtr;
+    handlerNodePtr->link = LE_DLS_LINK_INIT;
+
+    LE_DEBUG("handler %p", handlerPtr);
+
+    SubscribePaPositionHandler();
+
+    // Update the position sample's values handler list with that new handler
+    le_dls_Queue(&PositionSampleHandlerList, &(handlerNodePtr->link));
+    NumOfPositionSampleHandlers++;
+
+    LE_DEBUG("Position sample handler %p added", handlerNodePtr->handlerFuncPtr);
+
+    return (le_gnss_PositionSampleHandlerRef_t)handlerNodePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to remove a handler for position notifications by value.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gnss_RemovePositionSampleHandler
+(
+    le_gnss_PositionSampleHandlerRef_t handlerRef ///< [IN] The handler reference.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&PositionSampleHandlerList);
+
+    while (linkPtr != NULL)
     {
-        pa_gnss_RemovePositionDataHandler(PaHandlerRef);
-        PaHandlerRef = NULL;
+        le_gnss_PositionSampleHandler_t* handlerNodePtr =
+            CONTAINER_OF(linkPtr, le_gnss_PositionSampleHandler_t, link);
+
+        if ((le_gnss_PositionSampleHandlerRef_t)handlerNodePtr == handlerRef)
+        {
+            // Remove the node.
+            le_dls_Remove(&PositionSampleHandlerList, linkPtr);
+            le_mem_Release(handlerNodePtr);
+            NumOfPositionSampleHandlers--;
+            break;
+        }
+
+        // Move to the next node.
+        linkPtr = le_dls_PeekNext(&PositionSampleHandlerList, linkPtr);
     }
+
+    UnsubscribePaPositionHandler();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -938,7 +1379,7 @@ le_result_t le_gnss_GetPositionState
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr =
-                                                le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                                GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -1003,7 +1444,7 @@ le_result_t le_gnss_GetLocation
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1087,7 +1528,7 @@ le_result_t le_gnss_GetAltitude
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t * positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1160,7 +1601,7 @@ le_result_t le_gnss_GetTime
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -1251,7 +1692,7 @@ le_result_t le_gnss_GetGpsTime
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -1323,7 +1764,7 @@ le_result_t le_gnss_GetEpochTime
 {
     le_result_t result;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
     {
@@ -1377,7 +1818,7 @@ le_result_t le_gnss_GetTimeAccuracy
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -1449,7 +1890,7 @@ le_result_t le_gnss_GetDate
 
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr =
-                                                le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                                GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -1537,7 +1978,7 @@ le_result_t le_gnss_GetHorizontalSpeed
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -1610,7 +2051,7 @@ le_result_t le_gnss_GetVerticalSpeed
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -1684,7 +2125,7 @@ le_result_t le_gnss_GetDirection
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -1803,7 +2244,7 @@ le_result_t le_gnss_GetSatellitesInfo
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
     int i;
 
     // Check position sample's reference
@@ -1965,7 +2406,7 @@ le_result_t le_gnss_GetSatellitesStatus
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -2056,7 +2497,7 @@ le_result_t le_gnss_GetDop
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -2137,7 +2578,7 @@ le_result_t le_gnss_GetAltitudeOnWgs84
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t * positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     if (positionSamplePtr == NULL)
     {
@@ -2189,7 +2630,7 @@ le_result_t le_gnss_GetMagneticDeviation
 {
     le_result_t result = LE_OK;
     le_gnss_PositionSample_t* positionSamplePtr
-                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+                                            = GetPositionSample(positionSampleRef);
 
     // Check position sample's reference
     if ( positionSamplePtr == NULL)
@@ -2206,7 +2647,7 @@ le_result_t le_gnss_GetMagneticDeviation
         }
         else
         {
-            *magneticDeviationPtr = UINT32_MAX;
+            *magneticDeviationPtr = INT32_MAX;
             result = LE_OUT_OF_RANGE;
         }
     }
@@ -2214,6 +2655,115 @@ le_result_t le_gnss_GetMagneticDeviation
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get all the information of a position sample at once. This gives the same values as the
+ * individual getters (le_gnss_GetPositionState(), le_gnss_GetLocation(), le_gnss_GetAltitude(),
+ * etc.) with a single call.
+ *
+ * @return
+ *  - LE_FAULT         Function failed to find the positionSample.
+ *  - LE_OUT_OF_RANGE  One of the retrieved parameters is invalid.
+ *  - LE_OK            Function succeeded.
+ *
+ * @note Any of the OUT parameters can be set to NULL if not needed.
+ *
+ * @note If the caller is passing an invalid Position sample reference into this function,
+ *       it is a fatal error, the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_GetSample
+(
+    le_gnss_SampleRef_t positionSampleRef,  ///< [IN] Position sample's reference.
+    le_gnss_FixState_t* statePtr,           ///< [OUT] Position fix state.
+    int32_t* latitudePtr,                   ///< [OUT] WGS84 Latitude [resolution 1e-6].
+    int32_t* longitudePtr,                  ///< [OUT] WGS84 Longitude [resolution 1e-6].
+    int32_t* hAccuracyPtr,                  ///< [OUT] Horizontal accuracy [resolution 1e-2].
+    int32_t* altitudePtr,                   ///< [OUT] Altitude [resolution 1e-3].
+    int32_t* vAccuracyPtr,                  ///< [OUT] Vertical accuracy [resolution 1e-1].
+    int32_t* altitudeOnWgs84Ptr,            ///< [OUT] Altitude on WGS-84 [resolution 1e-3].
+    uint32_t* hSpeedPtr,                    ///< [OUT] Horizontal speed [resolution 1e-2].
+    uint32_t* hSpeedAccuracyPtr,            ///< [OUT] Horizontal speed accuracy [res. 1e-1].
+    int32_t* vSpeedPtr,                     ///< [OUT] Vertical speed [resolution 1e-2].
+    int32_t* vSpeedAccuracyPtr,             ///< [OUT] Vertical speed accuracy [res. 1e-1].
+    uint32_t* directionPtr,                 ///< [OUT] Direction [resolution 1e-1].
+    uint32_t* directionAccuracyPtr,         ///< [OUT] Direction accuracy [resolution 1e-1].
+    int32_t* magneticDeviationPtr,          ///< [OUT] Magnetic deviation [resolution 1e-1].
+    uint16_t* yearPtr,                      ///< [OUT] UTC Year A.D.
+    uint16_t* monthPtr,                     ///< [OUT] UTC Month into the year.
+    uint16_t* dayPtr,                       ///< [OUT] UTC Days into the month.
+    uint16_t* hoursPtr,                     ///< [OUT] UTC Hours into the day.
+    uint16_t* minutesPtr,                   ///< [OUT] UTC Minutes into the hour.
+    uint16_t* secondsPtr,                   ///< [OUT] UTC Seconds into the minute.
+    uint16_t* millisecondsPtr,              ///< [OUT] UTC Milliseconds into the second.
+    uint64_t* epochTimePtr,                 ///< [OUT] Epoch time in milliseconds.
+    uint32_t* timeAccuracyPtr,              ///< [OUT] Time accuracy in milliseconds.
+    uint32_t* gpsWeekPtr,                   ///< [OUT] GPS week number.
+    uint32_t* gpsTimeOfWeekPtr,             ///< [OUT] Milliseconds into the GPS week.
+    uint16_t* hdopPtr,                      ///< [OUT] Horizontal DOP [resolution 1e-3].
+    uint16_t* vdopPtr,                      ///< [OUT] Vertical DOP [resolution 1e-3].
+    uint16_t* pdopPtr,                      ///< [OUT] Position DOP [resolution 1e-3].
+    uint8_t* satsInViewCountPtr,            ///< [OUT] Satellites in View count.
+    uint8_t* satsTrackingCountPtr,          ///< [OUT] Tracking satellites in View count.
+    uint8_t* satsUsedCountPtr               ///< [OUT] Satellites used for Navigation count.
+)
+{
+    le_gnss_SampleValues_t values;
+    le_gnss_PositionSample_t* positionSamplePtr
+                                            = GetPositionSample(positionSampleRef);
+
+    // Check position sample's reference
+    if ( positionSamplePtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!",positionSampleRef);
+        return LE_FAULT;
+    }
+
+    le_result_t result = GetSampleValues(positionSamplePtr, &values);
+
+#define COPY_VALUE(field)               \
+    if (field##Ptr)                     \
+    {                                   \
+        *field##Ptr = values.field;     \
+    }
+
+    COPY_VALUE(state);
+    COPY_VALUE(latitude);
+    COPY_VALUE(longitude);
+    COPY_VALUE(hAccuracy);
+    COPY_VALUE(altitude);
+    COPY_VALUE(vAccuracy);
+    COPY_VALUE(altitudeOnWgs84);
+    COPY_VALUE(hSpeed);
+    COPY_VALUE(hSpeedAccuracy);
+    COPY_VALUE(vSpeed);
+    COPY_VALUE(vSpeedAccuracy);
+    COPY_VALUE(direction);
+    COPY_VALUE(directionAccuracy);
+    COPY_VALUE(magneticDeviation);
+    COPY_VALUE(year);
+    COPY_VALUE(month);
+    COPY_VALUE(day);
+    COPY_VALUE(hours);
+    COPY_VALUE(minutes);
+    COPY_VALUE(seconds);
+    COPY_VALUE(milliseconds);
+    COPY_VALUE(epochTime);
+    COPY_VALUE(timeAccuracy);
+    COPY_VALUE(gpsWeek);
+    COPY_VALUE(gpsTimeOfWeek);
+    COPY_VALUE(hdop);
+    COPY_VALUE(vdop);
+    COPY_VALUE(pdop);
+    COPY_VALUE(satsInViewCount);
+    COPY_VALUE(satsTrackingCount);
+    COPY_VALUE(satsUsedCount);
+
+#undef COPY_VALUE
+
+    return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function gets the last updated position sample object reference.
@@ -2238,13 +2788,10 @@ le_gnss_SampleRef_t le_gnss_GetLastSampleRef
     // Copy the position sample to the position sample node
     memcpy(positionSampleNodePtr, &LastPositionSample, sizeof(le_gnss_PositionSample_t));
 
-    // Add the node to the queue of the list by passing in the node's link.
-    le_dls_Queue(&PositionSampleList, &(positionSampleNodePtr->link));
-
     LE_DEBUG("Get sample %p", positionSampleNodePtr);
 
-    // Create a safe reference and call the client's handler
-    return le_ref_CreateRef(PositionSampleMap, positionSampleNodePtr);
+    // Create a safe reference for the client
+    return CreateSampleRef(positionSampleNodePtr, le_gnss_GetClientSessionRef());
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2260,16 +2807,14 @@ void le_gnss_ReleaseSampleRef
     le_gnss_SampleRef_t    positionSampleRef    ///< [IN] The position sample's reference.
 )
 {
-    le_gnss_PositionSample_t* positionSamplePtr = le_ref_Lookup(PositionSampleMap,
-                                                                positionSampleRef);
+    le_gnss_SampleRefNode_t* sampleRefPtr = le_ref_Lookup(PositionSampleMap, positionSampleRef);
 
-    if ( positionSamplePtr == NULL)
+    if ( sampleRefPtr == NULL)
     {
         LE_KILL_CLIENT("Invalid reference (%p) provided!",positionSampleRef);
         return;
     }
-    le_ref_DeleteRef(PositionSampleMap,positionSampleRef);
-    le_mem_Release(positionSamplePtr);
+    ReleaseSampleRef(sampleRefPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -12,6 +12,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "le_gnss_local.h"
+#include "le_pos_local.h"
 #include "posCfgEntries.h"
 
 #include <math.h>
@@ -98,7 +99,6 @@ typedef struct le_pos_Sample
     uint16_t        minutes;            ///< UTC Minutes into the hour [range 0..59].
     uint16_t        seconds;            ///< UTC Seconds into the minute [range 0..59].
     uint16_t        milliseconds;       ///< UTC Milliseconds into the second [range 0..999].
-    le_dls_Link_t   link;               ///< Object node link
 }
 le_pos_Sample_t;
 
@@ -123,10 +123,104 @@ typedef struct le_pos_SampleHandler
                                                       ///  handler's notification.
     int32_t                      lastAlt;             ///< The altitude associated with the last
                                                       ///  handler's notification.
+    le_msg_SessionRef_t          sessionRef;          ///< The client session of the handler.
     le_dls_Link_t                link;                ///< Object node link
 }
 le_pos_SampleHandler_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client holding position sample references.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t sessionRef;     ///< The client session.
+    le_dls_List_t       sampleRefList;  ///< The position sample references held by the client.
+}
+le_pos_SampleOwner_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position sample reference given to a client. The position sample itself is shared by all its
+ * references, each of them holding one of the sample's reference counts.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_pos_Sample_t*        posSamplePtr;   ///< The position sample.
+    le_pos_SampleRef_t      safeRef;        ///< The safe reference given to the client.
+    le_pos_SampleOwner_t*   ownerPtr;       ///< The client holding the reference.
+    le_dls_Link_t           link;           ///< Link in the owner's sampleRefList.
+}
+le_pos_SampleRefNode_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Batch filter structure. All the sample batch handlers registered with the same parameters share
+ * the same filter, so the samples are selected and batched only once for all of them.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t        minInterval;    ///< Minimum time between two samples kept, in milliseconds.
+    uint32_t        minDistance;    ///< Minimum distance between two samples kept, in meters.
+    uint32_t        maxBatchSize;   ///< Number of samples delivered at once.
+    uint32_t        maxLatency;     ///< Maximum time a sample is held, in milliseconds.
+    bool            lastValid;      ///< If true, a sample has already been kept.
+    int32_t         lastLat;        ///< The latitude of the last sample kept.
+    int32_t         lastLong;       ///< The longitude of the last sample kept.
+    le_clk_Time_t   lastTime;       ///< The time at which the last sample was kept.
+    size_t          numSamples;     ///< Number of samples pending in the arrays below.
+    int32_t         latitude[LE_POS_MAX_BATCH_SIZE];    ///< Pending samples' latitudes.
+    int32_t         longitude[LE_POS_MAX_BATCH_SIZE];   ///< Pending samples' longitudes.
+    int32_t         hAccuracy[LE_POS_MAX_BATCH_SIZE];   ///< Pending samples' accuracies.
+    int32_t         altitude[LE_POS_MAX_BATCH_SIZE];    ///< Pending samples' altitudes.
+    uint32_t        hSpeed[LE_POS_MAX_BATCH_SIZE];      ///< Pending samples' horizontal speeds.
+    uint32_t        direction[LE_POS_MAX_BATCH_SIZE];   ///< Pending samples' directions.
+    uint64_t        epochTime[LE_POS_MAX_BATCH_SIZE];   ///< Pending samples' UTC times.
+    le_timer_Ref_t  latencyTimer;   ///< Timer started when the first pending sample is kept.
+    le_dls_List_t   handlerList;    ///< The sample batch handlers sharing this filter.
+    le_dls_Link_t   link;           ///< Object node link
+}
+BatchFilter_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample batch handler structure.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_pos_SampleBatchHandlerFunc_t handlerFuncPtr;     ///< The handler function address.
+    void*                           handlerContextPtr;  ///< The handler function context.
+    BatchFilter_t*                  filterPtr;          ///< The filter shared by this handler.
+    le_dls_Link_t                   link;               ///< Object node link
+}
+BatchHandler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position sample as stored in the batches, with the resolutions of the le_pos API.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int32_t  latitude;          ///< Latitude.
+    int32_t  longitude;         ///< Longitude.
+    int32_t  hAccuracy;         ///< Horizontal accuracy.
+    int32_t  altitude;          ///< Altitude.
+    uint32_t hSpeed;            ///< Horizontal speed.
+    uint32_t direction;         ///< Direction.
+    uint64_t epochTime;         ///< UTC time.
+}
+BatchSample_t;
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -173,14 +267,6 @@ static le_ref_MapRef_t ActivationRequestRefMap;
 //                                       Static declarations
 //--------------------------------------------------------------------------------------------------
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Create and initialize the position samples list.
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_dls_List_t PosSampleList = LE_DLS_LIST_INIT;
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Create and initialize the position sample's handlers list.
@@ -205,6 +291,38 @@ static le_mem_PoolRef_t   PosSamplePoolRef;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t   PosSampleHandlerPoolRef;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create and initialize the batch filters list.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t BatchFilterList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for batch filters.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   BatchFilterPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for sample batch handlers.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   BatchHandlerPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of sample batch handlers.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t NumOfBatchHandlers;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Safe Reference Map for Positioning Sample objects.
@@ -213,6 +331,23 @@ static le_mem_PoolRef_t   PosSampleHandlerPoolRef;
 //--------------------------------------------------------------------------------------------------
 static le_ref_MapRef_t PosSampleMap;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pools for position sample references and for the clients holding them.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   SampleRefPoolRef;
+static le_mem_PoolRef_t   SampleOwnerPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clients holding position sample references, by client session.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t SampleOwnerMap;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory Pool for Positioning Client Handler.
@@ -261,41 +396,103 @@ static bool IsGNSSAvailable
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Pos Sample destructor.
+ * Create a position sample reference for a client.
  *
+ * The reference takes over one of the reference counts of the position sample.
+ *
+ * @return The position sample's safe reference.
  */
 //--------------------------------------------------------------------------------------------------
-static void PosSampleDestructor
+static le_pos_SampleRef_t CreateSampleRef
 (
-    void* obj
+    le_pos_Sample_t*    posSamplePtr,   ///< [IN] The position sample.
+    le_msg_SessionRef_t sessionRef      ///< [IN] The client session.
 )
 {
-    le_pos_Sample_t *posSampleNodePtr;
-    le_dls_Link_t   *linkPtr;
+    le_pos_SampleOwner_t*   ownerPtr = le_hashmap_Get(SampleOwnerMap, sessionRef);
+    le_pos_SampleRefNode_t* sampleRefPtr = le_mem_ForceAlloc(SampleRefPoolRef);
 
-    LE_FATAL_IF((obj == NULL), "Position Sample Object does not exist!");
+    if (ownerPtr == NULL)
+    {
+        ownerPtr = le_mem_ForceAlloc(SampleOwnerPoolRef);
+        ownerPtr->sessionRef = sessionRef;
+        ownerPtr->sampleRefList = LE_DLS_LIST_INIT;
+        le_hashmap_Put(SampleOwnerMap, sessionRef, ownerPtr);
+    }
 
-    linkPtr = le_dls_Peek(&PosSampleList);
-    if (linkPtr != NULL)
+    sampleRefPtr->posSamplePtr = posSamplePtr;
+    sampleRefPtr->ownerPtr = ownerPtr;
+    sampleRefPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&ownerPtr->sampleRefList, &sampleRefPtr->link);
+
+    sampleRefPtr->safeRef = le_ref_CreateRef(PosSampleMap, sampleRefPtr);
+
+    return sampleRefPtr->safeRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a position sample reference, and the position sample if it was the last one.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseSampleRef
+(
+    le_pos_SampleRefNode_t* sampleRefPtr    ///< [IN] The position sample reference.
+)
+{
+    le_dls_Remove(&sampleRefPtr->ownerPtr->sampleRefList, &sampleRefPtr->link);
+    le_ref_DeleteRef(PosSampleMap, sampleRefPtr->safeRef);
+    le_mem_Release(sampleRefPtr->posSamplePtr);
+    le_mem_Release(sampleRefPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the position sample of a position sample reference.
+ *
+ * @return The position sample, or NULL if the reference is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_pos_Sample_t* GetPosSample
+(
+    le_pos_SampleRef_t positionSampleRef    ///< [IN] The position sample's reference.
+)
+{
+    le_pos_SampleRefNode_t* sampleRefPtr = le_ref_Lookup(PosSampleMap, positionSampleRef);
+
+    return (sampleRefPtr == NULL) ? NULL : sampleRefPtr->posSamplePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function called when a client of the le_pos service closes its session: releases all
+ * the position sample references still held by the client.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSampleSessionHandler
+(
+    le_msg_SessionRef_t sessionRef,     ///< [IN] The closed client session.
+    void*               contextPtr      ///< [IN] Unused.
+)
+{
+    le_pos_SampleOwner_t* ownerPtr = le_hashmap_Remove(SampleOwnerMap, sessionRef);
+    le_dls_Link_t*        linkPtr;
+
+    if (ownerPtr == NULL)
     {
-        do
-        {
-            // Get the node from the list
-            posSampleNodePtr = (le_pos_Sample_t*)CONTAINER_OF(linkPtr, le_pos_Sample_t, link);
-            // Check the node.
-            if ( posSampleNodePtr == (le_pos_Sample_t*)obj)
-            {
-                // Remove the node.
-                le_dls_Remove(&PosSampleList, linkPtr);
-                linkPtr=NULL;
-            }
-            else
-            {
-                // Move to the next node.
-                linkPtr = le_dls_PeekNext(&PosSampleList, linkPtr);
-            }
-        } while (linkPtr != NULL);
+        return;
+    }
+
+    LE_DEBUG("Release the position samples of session %p", sessionRef);
+
+    while ((linkPtr = le_dls_Peek(&ownerPtr->sampleRefList)) != NULL)
+    {
+        ReleaseSampleRef(CONTAINER_OF(linkPtr, le_pos_SampleRefNode_t, link));
     }
+
+    le_mem_Release(ownerPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -376,12 +573,12 @@ static uint32_t CalculateAcquisitionRate
  *
  */
 //--------------------------------------------------------------------------------------------------
-static uint32_t ComputeDistance
+uint32_t pos_ComputeDistance
 (
-    uint32_t latitude1,
-    uint32_t longitude1,
-    uint32_t latitude2,
-    uint32_t longitude2
+    int32_t latitude1,
+    int32_t longitude1,
+    int32_t latitude2,
+    int32_t longitude2
 )
 {
     // Haversine formula:
@@ -519,10 +716,10 @@ static le_result_t ComputeMove
     LE_DEBUG("Last Position lat.%d, long.%d",
                  posSampleHandlerNodePtr->lastLat, posSampleHandlerNodePtr->lastLong);
 
-    uint32_t horizontalMove = ComputeDistance(posSampleHandlerNodePtr->lastLat,
-                                              posSampleHandlerNodePtr->lastLong,
-                                              posParamPtr->latitude,
-                                              posParamPtr->longitude);
+    uint32_t horizontalMove = pos_ComputeDistance(posSampleHandlerNodePtr->lastLat,
+                                                  posSampleHandlerNodePtr->lastLong,
+                                                  posParamPtr->latitude,
+                                                  posParamPtr->longitude);
 
     uint32_t verticalMove = abs(posParamPtr->altitude - posSampleHandlerNodePtr->lastAlt);
 
@@ -556,6 +753,163 @@ static le_result_t ComputeMove
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deliver the pending samples of a batch filter to all its handlers.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushBatch
+(
+    BatchFilter_t* filterPtr
+)
+{
+    le_dls_Link_t* linkPtr;
+    size_t         numSamples = filterPtr->numSamples;
+
+    if (le_timer_IsRunning(filterPtr->latencyTimer))
+    {
+        le_timer_Stop(filterPtr->latencyTimer);
+    }
+
+    if (numSamples == 0)
+    {
+        return;
+    }
+
+    LE_DEBUG("Report %zu samples to the handlers of filter %p", numSamples, filterPtr);
+
+    filterPtr->numSamples = 0;
+
+    linkPtr = le_dls_Peek(&filterPtr->handlerList);
+    while (linkPtr != NULL)
+    {
+        BatchHandler_t* handlerPtr = CONTAINER_OF(linkPtr, BatchHandler_t, link);
+
+        linkPtr = le_dls_PeekNext(&filterPtr->handlerList, linkPtr);
+
+        handlerPtr->handlerFuncPtr(filterPtr->latitude, numSamples,
+                                   filterPtr->longitude, numSamples,
+                                   filterPtr->hAccuracy, numSamples,
+                                   filterPtr->altitude, numSamples,
+                                   filterPtr->hSpeed, numSamples,
+                                   filterPtr->direction, numSamples,
+                                   filterPtr->epochTime, numSamples,
+                                   handlerPtr->handlerContextPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called when the oldest pending sample of a batch filter has waited long enough.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void BatchLatencyTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    FlushBatch((BatchFilter_t*)le_timer_GetContextPtr(timerRef));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a position sample must be kept by a batch filter.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSampleKept
+(
+    const BatchFilter_t* filterPtr,
+    const BatchSample_t* samplePtr,
+    le_clk_Time_t        now
+)
+{
+    if (!filterPtr->lastValid)
+    {
+        return true;
+    }
+
+    if (filterPtr->minInterval != 0)
+    {
+        le_clk_Time_t elapsed = le_clk_Sub(now, filterPtr->lastTime);
+
+        if (((uint64_t)elapsed.sec * 1000 + elapsed.usec / 1000) < filterPtr->minInterval)
+        {
+            return false;
+        }
+    }
+
+    if (filterPtr->minDistance != 0)
+    {
+        uint32_t move = pos_ComputeDistance(filterPtr->lastLat,
+                                            filterPtr->lastLong,
+                                            samplePtr->latitude,
+                                            samplePtr->longitude);
+        uint32_t accuracy = (INT32_MAX == samplePtr->hAccuracy) ? 0 : samplePtr->hAccuracy;
+
+        if (!IsBeyondMagnitude(filterPtr->minDistance, move, accuracy))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a position sample through all the batch filters. Each filter is evaluated once, whatever
+ * the number of handlers sharing it.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessBatchFilters
+(
+    const BatchSample_t* samplePtr
+)
+{
+    le_clk_Time_t  now = le_clk_GetRelativeTime();
+    le_dls_Link_t* linkPtr = le_dls_Peek(&BatchFilterList);
+
+    while (linkPtr != NULL)
+    {
+        BatchFilter_t* filterPtr = CONTAINER_OF(linkPtr, BatchFilter_t, link);
+        size_t         i = filterPtr->numSamples;
+
+        linkPtr = le_dls_PeekNext(&BatchFilterList, linkPtr);
+
+        if (!IsSampleKept(filterPtr, samplePtr, now))
+        {
+            continue;
+        }
+
+        filterPtr->lastValid = true;
+        filterPtr->lastLat = samplePtr->latitude;
+        filterPtr->lastLong = samplePtr->longitude;
+        filterPtr->lastTime = now;
+
+        filterPtr->latitude[i] = samplePtr->latitude;
+        filterPtr->longitude[i] = samplePtr->longitude;
+        filterPtr->hAccuracy[i] = samplePtr->hAccuracy;
+        filterPtr->altitude[i] = samplePtr->altitude;
+        filterPtr->hSpeed[i] = samplePtr->hSpeed;
+        filterPtr->direction[i] = samplePtr->direction;
+        filterPtr->epochTime[i] = samplePtr->epochTime;
+        filterPtr->numSamples++;
+
+        if (filterPtr->numSamples >= filterPtr->maxBatchSize)
+        {
+            FlushBatch(filterPtr);
+        }
+        else if ((filterPtr->numSamples == 1) && (filterPtr->maxLatency != 0))
+        {
+            le_timer_Start(filterPtr->latencyTimer);
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The main position Sample Handler.
@@ -569,6 +923,7 @@ static void PosSampleHandlerfunc
 )
 {
     le_result_t result;
+    le_gnss_FixState_t state;
     // Location parameters
     bool        locationValid = false;
     int32_t     latitude;
@@ -587,14 +942,17 @@ static void PosSampleHandlerfunc
     uint32_t direction;
     uint32_t directionAccuracy;
     // Date parameters
+    bool     dateValid;
     uint16_t year;
     uint16_t month;
     uint16_t day;
     // Time parameters
+    bool     timeValid;
     uint16_t hours;
     uint16_t minutes;
     uint16_t seconds;
     uint16_t milliseconds;
+    uint64_t epochTime;
     // Positioning sample parameters
     le_pos_SampleHandler_t* posSampleHandlerNodePtr;
     le_dls_Link_t*          linkPtr;
@@ -606,7 +964,7 @@ static void PosSampleHandlerfunc
         return;
     }
 
-    if (!NumOfHandlers)
+    if ((!NumOfHandlers) && (!NumOfBatchHandlers))
     {
         LE_DEBUG("No positioning Sample handler, exit Handler Function");
         // Release provided Position sample reference
@@ -616,13 +974,52 @@ static void PosSampleHandlerfunc
 
     LE_DEBUG("Handler Function called with sample %p", positionSampleRef);
 
-    // Get Location
-    result = le_gnss_GetLocation( positionSampleRef
-                                , &latitude
-                                , &longitude
-                                , &hAccuracy);
-    if ((result == LE_OK)
-    ||((result == LE_OUT_OF_RANGE)&&(latitude != INT32_MAX)&&(longitude != INT32_MAX)))
+    // Get all the sample's parameters at once
+    result = le_gnss_GetSample(positionSampleRef,
+                               &state,
+                               &latitude,
+                               &longitude,
+                               &hAccuracy,
+                               &altitude,
+                               &vAccuracy,
+                               NULL,
+                               &hSpeed,
+                               &hSpeedAccuracy,
+                               &vSpeed,
+                               &vSpeedAccuracy,
+                               &direction,
+                               &directionAccuracy,
+                               NULL,
+                               &year,
+                               &month,
+                               &day,
+                               &hours,
+                               &minutes,
+                               &seconds,
+                               &milliseconds,
+                               &epochTime,
+                               NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+    if (LE_FAULT == result)
+    {
+        LE_ERROR("Failed to get the sample %p", positionSampleRef);
+        le_gnss_ReleaseSampleRef(positionSampleRef);
+        return;
+    }
+
+    // An invalid date is reported as 0, which is not a valid year.
+    dateValid = (year != 0);
+
+    // An invalid time is reported as 00:00:00.000, which is also a valid time. Only in that case,
+    // ask for the time alone to find out whether it is valid.
+    timeValid = (LE_OK == result) || (hours != 0) || (minutes != 0) || (seconds != 0)
+                || (milliseconds != 0)
+                || (LE_OK == le_gnss_GetTime(positionSampleRef,
+                                             &hours,
+                                             &minutes,
+                                             &seconds,
+                                             &milliseconds));
+
+    if ((latitude != INT32_MAX) && (longitude != INT32_MAX))
     {
         locationValid = true;
         LE_DEBUG("Position lat.%d, long.%d, hAccuracy.%d"
@@ -635,12 +1032,7 @@ static void PosSampleHandlerfunc
                 , latitude, longitude, hAccuracy);
     }
 
-    // Get altitude
-    result = le_gnss_GetAltitude( positionSampleRef
-                                , &altitude
-                                , &vAccuracy);
-    if ((result == LE_OK)
-    ||((result == LE_OUT_OF_RANGE)&&(altitude != INT32_MAX)))
+    if (altitude != INT32_MAX)
     {
         altitudeValid = true;
         LE_DEBUG("Altitude.%d, vAccuracy.%d"
@@ -653,6 +1045,22 @@ static void PosSampleHandlerfunc
                 , altitude, vAccuracy);
     }
 
+    // Batched samples, only for known locations
+    if (locationValid)
+    {
+        BatchSample_t batchSample;
+
+        batchSample.latitude = latitude;
+        batchSample.longitude = longitude;
+        batchSample.hAccuracy = (INT32_MAX == hAccuracy) ? INT32_MAX : hAccuracy/100;
+        batchSample.altitude = altitudeValid ? altitude/1000 : INT32_MAX;
+        batchSample.hSpeed = (UINT32_MAX == hSpeed) ? UINT32_MAX : hSpeed/100;
+        batchSample.direction = (UINT32_MAX == direction) ? UINT32_MAX : direction/10;
+        batchSample.epochTime = epochTime;
+
+        ProcessBatchFilters(&batchSample);
+    }
+
     // Positioning sample
     linkPtr = le_dls_Peek(&PosSampleHandlerList);
     if (linkPtr != NULL)
@@ -695,7 +1103,12 @@ static void PosSampleHandlerfunc
                  ( (posSampleHandlerNodePtr->verticalMagnitude == 0)
                     && (posSampleHandlerNodePtr->horizontalMagnitude == 0) )    )
             {
-                if (posSampleNodePtr == NULL)
+                if (posSampleNodePtr != NULL)
+                {
+                    // Each handler's reference holds one reference count of the sample.
+                    le_mem_AddRef(posSampleNodePtr);
+                }
+                else
                 {
                     // Create the position sample node.
                     posSampleNodePtr = (le_pos_Sample_t*)le_mem_ForceAlloc(PosSamplePoolRef);
@@ -714,20 +1127,12 @@ static void PosSampleHandlerfunc
                     posSampleNodePtr->vAccuracyValid = CHECK_VALIDITY(vAccuracy,INT32_MAX);
                     posSampleNodePtr->vAccuracy = vAccuracy;
 
-                    // Get horizontal speed
-                    le_gnss_GetHorizontalSpeed( positionSampleRef
-                                                , &hSpeed
-                                                , &hSpeedAccuracy);
                     posSampleNodePtr->hSpeedValid = CHECK_VALIDITY(hSpeed,UINT32_MAX);
                     posSampleNodePtr->hSpeed = hSpeed;
                     posSampleNodePtr->hSpeedAccuracyValid =
                                                         CHECK_VALIDITY(hSpeedAccuracy,UINT32_MAX);
                     posSampleNodePtr->hSpeedAccuracy = hSpeedAccuracy;
 
-                    // Get vertical speed
-                    le_gnss_GetVerticalSpeed( positionSampleRef
-                                            , &vSpeed
-                                            , &vSpeedAccuracy);
                     posSampleNodePtr->vSpeedValid = CHECK_VALIDITY(vSpeed,INT32_MAX);
                     posSampleNodePtr->vSpeed = vSpeed;
                     posSampleNodePtr->vSpeedAccuracyValid =
@@ -740,54 +1145,24 @@ static void PosSampleHandlerfunc
                     posSampleNodePtr->headingAccuracyValid = false;
                     posSampleNodePtr->headingAccuracy = UINT32_MAX;
 
-                    // Get direction
-                    le_gnss_GetDirection( positionSampleRef
-                                        , &direction
-                                        , &directionAccuracy);
-
                     posSampleNodePtr->directionValid = CHECK_VALIDITY(direction,UINT32_MAX);
                     posSampleNodePtr->direction = direction;
                     posSampleNodePtr->directionAccuracyValid =
                                                     CHECK_VALIDITY(directionAccuracy,UINT32_MAX);
                     posSampleNodePtr->directionAccuracy = directionAccuracy;
 
-                    // Get UTC time
-                    if (LE_OK == le_gnss_GetDate(positionSampleRef
-                                            , &year
-                                            , &month
-                                            , &day))
-                    {
-                        posSampleNodePtr->dateValid = true;
-                    }
-                    else
-                    {
-                        posSampleNodePtr->dateValid = false;
-                    }
+                    posSampleNodePtr->dateValid = dateValid;
                     posSampleNodePtr->year = year;
                     posSampleNodePtr->month = month;
                     posSampleNodePtr->day = day;
 
-                    if (LE_OK == le_gnss_GetTime(positionSampleRef
-                                        , &hours
-                                        , &minutes
-                                        , &seconds
-                                        , &milliseconds))
-                    {
-                        posSampleNodePtr->timeValid = true;
-                    }
-                    else
-                    {
-                        posSampleNodePtr->timeValid = false;
-                    }
+                    posSampleNodePtr->timeValid = timeValid;
                     posSampleNodePtr->hours = hours;
                     posSampleNodePtr->minutes = minutes;
                     posSampleNodePtr->seconds = seconds;
                     posSampleNodePtr->milliseconds = milliseconds;
 
-                    posSampleNodePtr->link = LE_DLS_LINK_INIT;
-
-                    // Add the node to the queue of the list by passing in the node's link.
-                    le_dls_Queue(&PosSampleList, &(posSampleNodePtr->link));
+                    posSampleNodePtr->fixState = (le_pos_FixState_t)state;
                 }
 
                 // Save the information reported to the handler function
@@ -799,16 +1174,11 @@ static void PosSampleHandlerfunc
                          posSampleNodePtr,
                          posSampleHandlerNodePtr->handlerFuncPtr);
 
-                uint8_t i;
-                for(i=0 ; i<NumOfHandlers-1 ; i++)
-                {
-                    le_mem_AddRef((void *)posSampleNodePtr);
-                }
-
                 // Call the client's handler
                 posSampleHandlerNodePtr->handlerFuncPtr(
-                                                le_ref_CreateRef(PosSampleMap, posSampleNodePtr),
-                                                posSampleHandlerNodePtr->handlerContextPtr);
+                                        CreateSampleRef(posSampleNodePtr,
+                                                        posSampleHandlerNodePtr->sessionRef),
+                                        posSampleHandlerNodePtr->handlerContextPtr);
             }
 
             // Move to the next node.
@@ -926,7 +1296,17 @@ COMPONENT_INIT
     // Create a pool for Position Sample objects
     PosSamplePoolRef = le_mem_CreatePool("PosSamplePoolRef", sizeof(le_pos_Sample_t));
     le_mem_ExpandPool(PosSamplePoolRef,POSITIONING_SAMPLE_MAX);
-    le_mem_SetDestructor(PosSamplePoolRef, PosSampleDestructor);
+
+    // Create the pools for position sample references, and the clients holding them
+    SampleRefPoolRef = le_mem_CreatePool("SampleRefPoolRef", sizeof(le_pos_SampleRefNode_t));
+    SampleOwnerPoolRef = le_mem_CreatePool("SampleOwnerPoolRef", sizeof(le_pos_SampleOwner_t));
+    SampleOwnerMap = le_hashmap_Create("SampleOwnerMap",
+                                       POSITIONING_ACTIVATION_MAX,
+                                       le_hashmap_HashVoidPointer,
+                                       le_hashmap_EqualsVoidPointer);
+
+    // The position samples still held by a client are released when it disconnects.
+    le_msg_AddServiceCloseHandler(le_pos_GetServiceRef(), CloseSampleSessionHandler, NULL);
 
     // Initialize the event client close function handler.
     le_msg_ServiceRef_t msgService = le_posCtrl_GetServiceRef();
@@ -941,7 +1321,12 @@ COMPONENT_INIT
     // Create the reference HashMap for positioning sample
     PosSampleMap = le_ref_CreateMap("PosSampleMap", POSITIONING_SAMPLE_MAX);
 
+    // Create the pools for the sample batch handlers and the filters they share
+    BatchFilterPoolRef = le_mem_CreatePool("BatchFilterPoolRef", sizeof(BatchFilter_t));
+    BatchHandlerPoolRef = le_mem_CreatePool("BatchHandlerPoolRef", sizeof(BatchHandler_t));
+
     NumOfHandlers = 0;
+    NumOfBatchHandlers = 0;
     GnssHandlerRef = NULL;
 
     // Create safe reference map for request references. The size of the map should be based on
@@ -956,6 +1341,7 @@ COMPONENT_INIT
     if (IsGNSSAvailable() == true)
     {
         gnss_Init();
+        posFence_Init();
         LoadPositioningFromConfigDb();
     }
     else
@@ -1085,6 +1471,7 @@ le_pos_MovementHandlerRef_t le_pos_AddMovementHandler
     posSampleHandlerNodePtr = (le_pos_SampleHandler_t*)le_mem_ForceAlloc(PosSampleHandlerPoolRef);
     posSampleHandlerNodePtr->handlerFuncPtr = handlerPtr;
     posSampleHandlerNodePtr->handlerContextPtr = contextPtr;
+    posSampleHandlerNodePtr->sessionRef = le_pos_GetClientSessionRef();
     posSampleHandlerNodePtr->acquisitionRate = CalculateAcquisitionRate(SUPPOSED_AVERAGE_SPEED,
                                                                         horizontalMagnitude,
                                                                         verticalMagnitude);
@@ -1108,7 +1495,7 @@ le_pos_MovementHandlerRef_t le_pos_AddMovementHandler
     posSampleHandlerNodePtr->verticalMagnitude = verticalMagnitude;
 
     // Start acquisition
-    if (NumOfHandlers == 0)
+    if (GnssHandlerRef == NULL)
     {
         if ((GnssHandlerRef=le_gnss_AddPositionHandler(PosSampleHandlerfunc, NULL)) == NULL)
         {
@@ -1164,13 +1551,164 @@ void le_pos_RemoveMovementHandler
         } while (linkPtr != NULL);
     }
 
-    if (NumOfHandlers == 0)
+    if ((NumOfHandlers == 0) && (NumOfBatchHandlers == 0))
     {
         le_gnss_RemovePositionHandler(GnssHandlerRef);
         GnssHandlerRef = NULL;
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to register an handler for batches of position samples.
+ *
+ * @return
+ *      - A handler reference, which is only needed for later removal of the handler.
+ *      - NULL if the GNSS position handler can't be added.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_SampleBatchHandlerRef_t le_pos_AddSampleBatchHandler
+(
+    uint32_t                        minInterval,    ///< [IN] Minimum time between two samples,
+                                                    ///       in milliseconds.
+    uint32_t                        minDistance,    ///< [IN] Minimum distance between two samples,
+                                                    ///       in meters.
+    uint32_t                        maxBatchSize,   ///< [IN] Number of samples delivered at once.
+    uint32_t                        maxLatency,     ///< [IN] Maximum time a sample is held, in
+                                                    ///       milliseconds.
+    le_pos_SampleBatchHandlerFunc_t handlerPtr,     ///< [IN] The handler function.
+    void*                           contextPtr      ///< [IN] The context pointer
+)
+{
+    BatchFilter_t*  filterPtr = NULL;
+    BatchHandler_t* batchHandlerPtr;
+    le_dls_Link_t*  linkPtr;
+
+    LE_FATAL_IF((handlerPtr == NULL), "handlerPtr pointer is NULL !");
+
+    if (maxBatchSize == 0)
+    {
+        maxBatchSize = 1;
+    }
+    else if (maxBatchSize > LE_POS_MAX_BATCH_SIZE)
+    {
+        maxBatchSize = LE_POS_MAX_BATCH_SIZE;
+    }
+
+    // Start acquisition
+    if (GnssHandlerRef == NULL)
+    {
+        if ((GnssHandlerRef=le_gnss_AddPositionHandler(PosSampleHandlerfunc, NULL)) == NULL)
+        {
+            LE_ERROR("Failed to add PA GNSS's handler!");
+            return NULL;
+        }
+    }
+
+    // Share the filter of the handlers registered with the same parameters, if any.
+    linkPtr = le_dls_Peek(&BatchFilterList);
+    while (linkPtr != NULL)
+    {
+        BatchFilter_t* nodePtr = CONTAINER_OF(linkPtr, BatchFilter_t, link);
+
+        if ( (nodePtr->minInterval == minInterval) && (nodePtr->minDistance == minDistance) &&
+             (nodePtr->maxBatchSize == maxBatchSize) && (nodePtr->maxLatency == maxLatency) )
+        {
+            filterPtr = nodePtr;
+            break;
+        }
+        linkPtr = le_dls_PeekNext(&BatchFilterList, linkPtr);
+    }
+
+    if (filterPtr == NULL)
+    {
+        filterPtr = (BatchFilter_t*)le_mem_ForceAlloc(BatchFilterPoolRef);
+        memset(filterPtr, 0, sizeof(BatchFilter_t));
+        filterPtr->minInterval = minInterval;
+        filterPtr->minDistance = minDistance;
+        filterPtr->maxBatchSize = maxBatchSize;
+        filterPtr->maxLatency = maxLatency;
+        filterPtr->handlerList = LE_DLS_LIST_INIT;
+        filterPtr->link = LE_DLS_LINK_INIT;
+
+        filterPtr->latencyTimer = le_timer_Create("PosBatchLatency");
+        le_timer_SetHandler(filterPtr->latencyTimer, BatchLatencyTimerHandler);
+        le_timer_SetContextPtr(filterPtr->latencyTimer, filterPtr);
+        if (maxLatency != 0)
+        {
+            le_timer_SetMsInterval(filterPtr->latencyTimer, maxLatency);
+        }
+
+        le_dls_Queue(&BatchFilterList, &(filterPtr->link));
+
+        LE_DEBUG("New batch filter %p (%u ms, %u m, %u samples, %u ms)",
+                 filterPtr, minInterval, minDistance, maxBatchSize, maxLatency);
+    }
+
+    batchHandlerPtr = (BatchHandler_t*)le_mem_ForceAlloc(BatchHandlerPoolRef);
+    batchHandlerPtr->handlerFuncPtr = handlerPtr;
+    batchHandlerPtr->handlerContextPtr = contextPtr;
+    batchHandlerPtr->filterPtr = filterPtr;
+    batchHandlerPtr->link = LE_DLS_LINK_INIT;
+
+    le_dls_Queue(&filterPtr->handlerList, &(batchHandlerPtr->link));
+    NumOfBatchHandlers++;
+
+    return (le_pos_SampleBatchHandlerRef_t)batchHandlerPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to remove a handler for batches of position samples.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pos_RemoveSampleBatchHandler
+(
+    le_pos_SampleBatchHandlerRef_t  handlerRef ///< [IN] The handler reference.
+)
+{
+    le_dls_Link_t* filterLinkPtr = le_dls_Peek(&BatchFilterList);
+
+    while (filterLinkPtr != NULL)
+    {
+        BatchFilter_t* filterPtr = CONTAINER_OF(filterLinkPtr, BatchFilter_t, link);
+        le_dls_Link_t* linkPtr = le_dls_Peek(&filterPtr->handlerList);
+
+        while (linkPtr != NULL)
+        {
+            BatchHandler_t* batchHandlerPtr = CONTAINER_OF(linkPtr, BatchHandler_t, link);
+
+            if ((le_pos_SampleBatchHandlerRef_t)batchHandlerPtr == handlerRef)
+            {
+                le_dls_Remove(&filterPtr->handlerList, linkPtr);
+                le_mem_Release(batchHandlerPtr);
+                NumOfBatchHandlers--;
+
+                // The pending samples are dropped with the last handler of the filter.
+                if (le_dls_IsEmpty(&filterPtr->handlerList))
+                {
+                    le_timer_Delete(filterPtr->latencyTimer);
+                    le_dls_Remove(&BatchFilterList, filterLinkPtr);
+                    le_mem_Release(filterPtr);
+                }
+
+                if ((NumOfHandlers == 0) && (NumOfBatchHandlers == 0))
+                {
+                    le_gnss_RemovePositionHandler(GnssHandlerRef);
+                    GnssHandlerRef = NULL;
+                }
+                return;
+            }
+            linkPtr = le_dls_PeekNext(&filterPtr->handlerList, linkPtr);
+        }
+        filterLinkPtr = le_dls_PeekNext(&BatchFilterList, filterLinkPtr);
+    }
+
+    LE_ERROR("Invalid sample batch handler reference (%p)", handlerRef);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the position sample's 2D location (latitude, longitude,
@@ -1202,7 +1740,7 @@ le_result_t le_pos_sample_Get2DLocation
 )
 {
     le_result_t result = LE_OK;
-    le_pos_Sample_t* positionSamplePtr = le_ref_Lookup(PosSampleMap,positionSampleRef);
+    le_pos_Sample_t* positionSamplePtr = GetPosSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1264,7 +1802,7 @@ le_result_t le_pos_sample_GetTime
 )
 {
     le_result_t result = LE_OK;
-    le_pos_Sample_t* positionSamplePtr = le_ref_Lookup(PosSampleMap,positionSampleRef);
+    le_pos_Sample_t* positionSamplePtr = GetPosSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1336,7 +1874,7 @@ le_result_t le_pos_sample_GetDate
 )
 {
     le_result_t result = LE_OK;
-    le_pos_Sample_t* positionSamplePtr = le_ref_Lookup(PosSampleMap,positionSampleRef);
+    le_pos_Sample_t* positionSamplePtr = GetPosSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1407,7 +1945,7 @@ le_result_t le_pos_sample_GetAltitude
 )
 {
     le_result_t result = LE_OK;
-    le_pos_Sample_t* positionSamplePtr = le_ref_Lookup(PosSampleMap,positionSampleRef);
+    le_pos_Sample_t* positionSamplePtr = GetPosSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1466,7 +2004,7 @@ le_result_t le_pos_sample_GetHorizontalSpeed
 )
 {
     le_result_t result = LE_OK;
-    le_pos_Sample_t* positionSamplePtr = le_ref_Lookup(PosSampleMap,positionSampleRef);
+    le_pos_Sample_t* positionSamplePtr = GetPosSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1519,7 +2057,7 @@ le_result_t le_pos_sample_GetVerticalSpeed
 )
 {
     le_result_t result = LE_OK;
-    le_pos_Sample_t* positionSamplePtr = le_ref_Lookup(PosSampleMap,positionSampleRef);
+    le_pos_Sample_t* positionSamplePtr = GetPosSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1577,7 +2115,7 @@ le_result_t le_pos_sample_GetHeading
 )
 {
     le_result_t result = LE_OK;
-    le_pos_Sample_t* positionSamplePtr = le_ref_Lookup(PosSampleMap,positionSampleRef);
+    le_pos_Sample_t* positionSamplePtr = GetPosSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1635,7 +2173,7 @@ le_result_t le_pos_sample_GetDirection
 )
 {
     le_result_t result = LE_OK;
-    le_pos_Sample_t* positionSamplePtr = le_ref_Lookup(PosSampleMap,positionSampleRef);
+    le_pos_Sample_t* positionSamplePtr = GetPosSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1684,7 +2222,7 @@ le_result_t le_pos_sample_GetFixState
     le_pos_FixState_t*  statePtr              ///< [OUT] Position fix state.
 )
 {
-    le_pos_Sample_t* positionSamplePtr = le_ref_Lookup(PosSampleMap,positionSampleRef);
+    le_pos_Sample_t* positionSamplePtr = GetPosSample(positionSampleRef);
 
     if ( positionSamplePtr == NULL)
     {
@@ -1701,6 +2239,92 @@ le_result_t le_pos_sample_GetFixState
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to get all the parameters of a position sample in a single call.
+ * The values are the same as the ones returned by the individual le_pos_sample_GetXxx() functions.
+ *
+ * @return LE_FAULT         Function failed to find the positionSample.
+ * @return LE_OUT_OF_RANGE  One of the retrieved parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the caller is passing an invalid Position reference into this function,
+ *       it is a fatal error, the function will not return.
+ *
+ * @note Any of the output pointers can be set to NULL if not needed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_pos_sample_GetAll
+(
+    le_pos_SampleRef_t  positionSampleRef,    ///< [IN] The position sample's reference.
+    le_pos_FixState_t*  statePtr,             ///< [OUT] Position fix state.
+    int32_t*            latitudePtr,          ///< [OUT] WGS84 Latitude in degrees
+                                              ///<       [resolution 1e-6].
+    int32_t*            longitudePtr,         ///< [OUT] WGS84 Longitude in degrees
+                                              ///<       [resolution 1e-6].
+    int32_t*            hAccuracyPtr,         ///< [OUT] Horizontal position's accuracy in meters.
+    int32_t*            altitudePtr,          ///< [OUT] Altitude in meters.
+    int32_t*            altitudeAccuracyPtr,  ///< [OUT] Vertical position's accuracy in meters.
+    uint32_t*           hSpeedPtr,            ///< [OUT] The Horizontal Speed in m/sec.
+    uint32_t*           hSpeedAccuracyPtr,    ///< [OUT] The Horizontal Speed's accuracy in m/sec.
+    int32_t*            vSpeedPtr,            ///< [OUT] The Vertical Speed in m/sec.
+    int32_t*            vSpeedAccuracyPtr,    ///< [OUT] The Vertical Speed's accuracy in m/sec.
+    uint32_t*           headingPtr,           ///< [OUT] The heading in degrees.
+    uint32_t*           headingAccuracyPtr,   ///< [OUT] The heading's accuracy estimate.
+    uint32_t*           directionPtr,         ///< [OUT] Direction indication in degrees.
+    uint32_t*           directionAccuracyPtr, ///< [OUT] The direction's accuracy estimate.
+    uint16_t*           yearPtr,              ///< [OUT] UTC Year A.D. [e.g. 2014].
+    uint16_t*           monthPtr,             ///< [OUT] UTC Month into the year [range 1...12].
+    uint16_t*           dayPtr,               ///< [OUT] UTC Days into the month [range 1...31].
+    uint16_t*           hoursPtr,             ///< [OUT] UTC Hours into the day [range 0..23].
+    uint16_t*           minutesPtr,           ///< [OUT] UTC Minutes into the hour [range 0..59].
+    uint16_t*           secondsPtr,           ///< [OUT] UTC Seconds into the minute [range 0..59].
+    uint16_t*           millisecondsPtr       ///< [OUT] UTC Milliseconds into the second
+                                              ///<       [range 0..999].
+)
+{
+    le_result_t result = LE_OK;
+    le_pos_Sample_t* positionSamplePtr = GetPosSample(positionSampleRef);
+
+    if ( positionSamplePtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!",positionSampleRef);
+        return LE_FAULT;
+    }
+
+    if (statePtr)
+    {
+        *statePtr = positionSamplePtr->fixState;
+    }
+
+    // The reference is known to be valid, so the individual getters can only return LE_OK or
+    // LE_OUT_OF_RANGE. Reuse them so that the units and invalid values are the same.
+    le_result_t results[] =
+    {
+        le_pos_sample_Get2DLocation(positionSampleRef, latitudePtr, longitudePtr, hAccuracyPtr),
+        le_pos_sample_GetAltitude(positionSampleRef, altitudePtr, altitudeAccuracyPtr),
+        le_pos_sample_GetHorizontalSpeed(positionSampleRef, hSpeedPtr, hSpeedAccuracyPtr),
+        le_pos_sample_GetVerticalSpeed(positionSampleRef, vSpeedPtr, vSpeedAccuracyPtr),
+        le_pos_sample_GetHeading(positionSampleRef, headingPtr, headingAccuracyPtr),
+        le_pos_sample_GetDirection(positionSampleRef, directionPtr, directionAccuracyPtr),
+        le_pos_sample_GetDate(positionSampleRef, yearPtr, monthPtr, dayPtr),
+        le_pos_sample_GetTime(positionSampleRef, hoursPtr, minutesPtr, secondsPtr,
+                              millisecondsPtr)
+    };
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(results); i++)
+    {
+        if (results[i] != LE_OK)
+        {
+            result = LE_OUT_OF_RANGE;
+        }
+    }
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to release the position sample.
@@ -1714,15 +2338,14 @@ void le_pos_sample_Release
     le_pos_SampleRef_t    positionSampleRef    ///< [IN] The position sample's reference.
 )
 {
-    le_pos_Sample_t* positionSamplePtr = le_ref_Lookup(PosSampleMap,positionSampleRef);
+    le_pos_SampleRefNode_t* sampleRefPtr = le_ref_Lookup(PosSampleMap, positionSampleRef);
 
-    if ( positionSamplePtr == NULL)
+    if ( sampleRefPtr == NULL)
     {
         LE_KILL_CLIENT("Invalid reference (%p) provided!",positionSampleRef);
         return;
     }
-    le_ref_DeleteRef(PosSampleMap,positionSampleRef);
-    le_mem_Release(positionSamplePtr);
+    ReleaseSampleRef(sampleRefPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
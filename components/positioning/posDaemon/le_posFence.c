@@ -0,0 +1,886 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file le_posFence.c
+ *
+ * This file contains the source code of the geofences of the Positioning API.
+ *
+ * The fences are kept in a grid of cells of FENCE_CELL_SIZE x FENCE_CELL_SIZE micro-degrees,
+ * indexed by a hashmap: a fence is linked to each of the cells its bounding box overlaps. Each
+ * new position is only checked against:
+ *  - the fences of the cell the position is in,
+ *  - the fences the position was inside of, as they may have to report an exit,
+ *  - the few fences that are too large to be put in the grid.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+
+#include "legato.h"
+#include "interfaces.h"
+#include "le_pos_local.h"
+
+#include <math.h>
+
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+/// Size of the grid cells, in micro-degrees (0.01 degree is about 1.1 km of latitude).
+#define FENCE_CELL_SIZE             10000
+
+/// Fences overlapping more cells than this are not put in the grid, but checked at every position.
+#define FENCE_MAX_CELLS             64
+
+/// Length of one degree of latitude, in meters.
+#define METERS_PER_DEGREE           111320
+
+/// Typically, we don't expect more than this number of fences per device.
+#define FENCE_DEFAULT_MAX           1024
+
+#define PI                          3.14159265
+
+
+//--------------------------------------------------------------------------------------------------
+// Data structures.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Vertices of a polygon fence.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t  numVertices;                                ///< Number of vertices.
+    int32_t latitude[LE_POS_MAX_FENCE_VERTICES];        ///< Latitudes of the vertices.
+    int32_t longitude[LE_POS_MAX_FENCE_VERTICES];       ///< Longitudes of the vertices.
+}
+Polygon_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fence structure.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_pos_FenceRef_t   ref;            ///< The fence's safe reference.
+    le_msg_SessionRef_t sessionRef;     ///< The client session that owns the fence.
+    Polygon_t*          polygonPtr;     ///< The vertices for a polygon, NULL for a circle.
+    int32_t             latitude;       ///< Latitude of the center of a circle.
+    int32_t             longitude;      ///< Longitude of the center of a circle.
+    uint32_t            radius;         ///< Radius of a circle, in meters.
+    int32_t             minLat;         ///< Bounding box of the fence.
+    int32_t             maxLat;         ///< Bounding box of the fence.
+    int32_t             minLong;        ///< Bounding box of the fence.
+    int32_t             maxLong;        ///< Bounding box of the fence.
+    uint32_t            dwellTime;      ///< Dwell time in milliseconds, 0 if not needed.
+    bool                isInside;       ///< If true, the last position was inside the fence.
+    bool                dwellReported;  ///< If true, FENCE_DWELL has been reported.
+    le_clk_Time_t       enterTime;      ///< Time of the FENCE_ENTER event.
+    uint32_t            positionCount;  ///< Number of the last position the fence was checked at.
+    bool                isLarge;        ///< If true, the fence is in LargeFenceList, not the grid.
+    le_dls_List_t       cellEntryList;  ///< The grid cells the fence is linked to.
+    le_dls_Link_t       insideLink;     ///< Link in InsideFenceList.
+    le_dls_Link_t       largeLink;      ///< Link in LargeFenceList.
+    le_dls_Link_t       link;           ///< Link in FenceList.
+}
+Fence_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Grid cell structure.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t        key;            ///< Cell coordinates, used as the key in the grid.
+    le_dls_List_t   entryList;      ///< The fences overlapping the cell.
+}
+Cell_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Link between a fence and a grid cell.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    Fence_t*        fencePtr;       ///< The fence.
+    Cell_t*         cellPtr;        ///< The cell.
+    le_dls_Link_t   cellLink;       ///< Link in the cell's entryList.
+    le_dls_Link_t   fenceLink;      ///< Link in the fence's cellEntryList.
+}
+CellEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fence handler structure.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_pos_FenceHandlerFunc_t   handlerFuncPtr;     ///< The handler function address.
+    void*                       handlerContextPtr;  ///< The handler function context.
+    le_msg_SessionRef_t         sessionRef;         ///< The client session of the handler.
+    le_dls_Link_t               link;               ///< Object node link
+}
+FenceHandler_t;
+
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pools for fences, polygons, grid cells, cell entries and fence handlers.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t FencePoolRef;
+static le_mem_PoolRef_t PolygonPoolRef;
+static le_mem_PoolRef_t CellPoolRef;
+static le_mem_PoolRef_t CellEntryPoolRef;
+static le_mem_PoolRef_t FenceHandlerPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe Reference Map for fences.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t FenceMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The grid: maps the cell coordinates to the Cell_t objects.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t Grid;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * All the fences, the fences too large for the grid, and the fences the position is inside of.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t FenceList = LE_DLS_LIST_INIT;
+static le_dls_List_t LargeFenceList = LE_DLS_LIST_INIT;
+static le_dls_List_t InsideFenceList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The fence handlers.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t FenceHandlerList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of the positions processed, used to check each fence only once per position.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t PositionCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * GNSS position handler's reference, set while there are fences.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnss_PositionHandlerRef_t GnssHandlerRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the coordinate of the cell a latitude or a longitude is in.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t GetCellCoordinate
+(
+    int32_t value
+)
+{
+    // Round towards minus infinity, so that the cells all have the same size around 0.
+    return (value >= 0) ? (value / FENCE_CELL_SIZE) : (((value + 1) / FENCE_CELL_SIZE) - 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the grid key of a cell.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetCellKey
+(
+    int32_t latCell,
+    int32_t longCell
+)
+{
+    return ((uint64_t)(uint32_t)latCell << 32) | (uint32_t)longCell;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a position is inside a fence.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInsideFence
+(
+    const Fence_t* fencePtr,
+    int32_t        latitude,
+    int32_t        longitude
+)
+{
+    if ( (latitude < fencePtr->minLat) || (latitude > fencePtr->maxLat) ||
+         (longitude < fencePtr->minLong) || (longitude > fencePtr->maxLong) )
+    {
+        return false;
+    }
+
+    if (fencePtr->polygonPtr == NULL)
+    {
+        return (pos_ComputeDistance(fencePtr->latitude, fencePtr->longitude,
+                                    latitude, longitude) <= fencePtr->radius);
+    }
+
+    // Ray casting: count the edges crossed by a ray going East from the position. The polygons
+    // are small enough for the coordinates to be used as plane coordinates.
+    const Polygon_t* polygonPtr = fencePtr->polygonPtr;
+    bool             isInside = false;
+    size_t           i, j;
+
+    for (i = 0, j = polygonPtr->numVertices - 1; i < polygonPtr->numVertices; j = i++)
+    {
+        int64_t latI = polygonPtr->latitude[i];
+        int64_t latJ = polygonPtr->latitude[j];
+        int64_t longI = polygonPtr->longitude[i];
+        int64_t longJ = polygonPtr->longitude[j];
+
+        if ((latI > latitude) != (latJ > latitude))
+        {
+            // Longitude of the edge at the position's latitude, compared without dividing.
+            int64_t lhs = (longitude - longI) * (latJ - latI);
+            int64_t rhs = (longJ - longI) * (latitude - latI);
+
+            if ((latJ > latI) ? (lhs < rhs) : (lhs > rhs))
+            {
+                isInside = !isInside;
+            }
+        }
+    }
+
+    return isInside;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report an event of a fence to the handlers of the client that owns it.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportFenceEvent
+(
+    Fence_t*            fencePtr,
+    le_pos_FenceEvent_t event
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&FenceHandlerList);
+
+    LE_DEBUG("Fence %p event %d", fencePtr->ref, event);
+
+    while (linkPtr != NULL)
+    {
+        FenceHandler_t* handlerPtr = CONTAINER_OF(linkPtr, FenceHandler_t, link);
+
+        linkPtr = le_dls_PeekNext(&FenceHandlerList, linkPtr);
+
+        if (handlerPtr->sessionRef == fencePtr->sessionRef)
+        {
+            handlerPtr->handlerFuncPtr(fencePtr->ref, event, handlerPtr->handlerContextPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a fence against the current position, unless it has already been checked, and report
+ * its events.
+ *
+ * @return 1 if the fence was checked, 0 if it had already been checked.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CheckFence
+(
+    Fence_t*      fencePtr,
+    int32_t       latitude,
+    int32_t       longitude,
+    le_clk_Time_t now
+)
+{
+    if (fencePtr->positionCount == PositionCount)
+    {
+        return 0;
+    }
+    fencePtr->positionCount = PositionCount;
+
+    bool isInside = IsInsideFence(fencePtr, latitude, longitude);
+
+    if (isInside && !fencePtr->isInside)
+    {
+        fencePtr->isInside = true;
+        fencePtr->dwellReported = false;
+        fencePtr->enterTime = now;
+        le_dls_Queue(&InsideFenceList, &fencePtr->insideLink);
+        ReportFenceEvent(fencePtr, LE_POS_FENCE_ENTER);
+    }
+    else if (!isInside && fencePtr->isInside)
+    {
+        fencePtr->isInside = false;
+        le_dls_Remove(&InsideFenceList, &fencePtr->insideLink);
+        ReportFenceEvent(fencePtr, LE_POS_FENCE_EXIT);
+        return 1;
+    }
+
+    if (isInside && (fencePtr->dwellTime != 0) && !fencePtr->dwellReported)
+    {
+        le_clk_Time_t dwell = le_clk_Sub(now, fencePtr->enterTime);
+
+        if (((uint64_t)dwell.sec * 1000 + dwell.usec / 1000) >= fencePtr->dwellTime)
+        {
+            fencePtr->dwellReported = true;
+            ReportFenceEvent(fencePtr, LE_POS_FENCE_DWELL);
+        }
+    }
+
+    return 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Link a fence to the grid cells its bounding box overlaps, or to LargeFenceList.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void IndexFence
+(
+    Fence_t* fencePtr
+)
+{
+    int32_t minLatCell = GetCellCoordinate(fencePtr->minLat);
+    int32_t maxLatCell = GetCellCoordinate(fencePtr->maxLat);
+    int32_t minLongCell = GetCellCoordinate(fencePtr->minLong);
+    int32_t maxLongCell = GetCellCoordinate(fencePtr->maxLong);
+    int32_t latCell, longCell;
+
+    if (((int64_t)(maxLatCell - minLatCell + 1) * (maxLongCell - minLongCell + 1)) >
+        FENCE_MAX_CELLS)
+    {
+        fencePtr->isLarge = true;
+        le_dls_Queue(&LargeFenceList, &fencePtr->largeLink);
+        return;
+    }
+
+    for (latCell = minLatCell; latCell <= maxLatCell; latCell++)
+    {
+        for (longCell = minLongCell; longCell <= maxLongCell; longCell++)
+        {
+            uint64_t key = GetCellKey(latCell, longCell);
+            Cell_t*  cellPtr = le_hashmap_Get(Grid, &key);
+
+            if (cellPtr == NULL)
+            {
+                cellPtr = le_mem_ForceAlloc(CellPoolRef);
+                cellPtr->key = key;
+                cellPtr->entryList = LE_DLS_LIST_INIT;
+                le_hashmap_Put(Grid, &cellPtr->key, cellPtr);
+            }
+
+            CellEntry_t* entryPtr = le_mem_ForceAlloc(CellEntryPoolRef);
+            entryPtr->fencePtr = fencePtr;
+            entryPtr->cellPtr = cellPtr;
+            entryPtr->cellLink = LE_DLS_LINK_INIT;
+            entryPtr->fenceLink = LE_DLS_LINK_INIT;
+            le_dls_Queue(&cellPtr->entryList, &entryPtr->cellLink);
+            le_dls_Queue(&fencePtr->cellEntryList, &entryPtr->fenceLink);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unlink a fence from the grid cells, or from LargeFenceList.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnindexFence
+(
+    Fence_t* fencePtr
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    if (fencePtr->isLarge)
+    {
+        le_dls_Remove(&LargeFenceList, &fencePtr->largeLink);
+        return;
+    }
+
+    while ((linkPtr = le_dls_Pop(&fencePtr->cellEntryList)) != NULL)
+    {
+        CellEntry_t* entryPtr = CONTAINER_OF(linkPtr, CellEntry_t, fenceLink);
+        Cell_t*      cellPtr = entryPtr->cellPtr;
+
+        le_dls_Remove(&cellPtr->entryList, &entryPtr->cellLink);
+        le_mem_Release(entryPtr);
+
+        if (le_dls_IsEmpty(&cellPtr->entryList))
+        {
+            le_hashmap_Remove(Grid, &cellPtr->key);
+            le_mem_Release(cellPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler for the GNSS position samples, started while there are fences.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void GnssPositionHandler
+(
+    le_gnss_SampleRef_t positionSampleRef,
+    void*               contextPtr
+)
+{
+    int32_t latitude;
+    int32_t longitude;
+    int32_t hAccuracy;
+
+    le_gnss_GetLocation(positionSampleRef, &latitude, &longitude, &hAccuracy);
+
+    if ((latitude != INT32_MAX) && (longitude != INT32_MAX))
+    {
+        posFence_ProcessPosition(latitude, longitude);
+    }
+
+    le_gnss_ReleaseSampleRef(positionSampleRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a fence to the engine.
+ *
+ * @return The fence's reference, or NULL on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_pos_FenceRef_t AddFence
+(
+    Fence_t* fencePtr
+)
+{
+    if (GnssHandlerRef == NULL)
+    {
+        if ((GnssHandlerRef = le_gnss_AddPositionHandler(GnssPositionHandler, NULL)) == NULL)
+        {
+            LE_ERROR("Failed to add GNSS's handler!");
+            if (fencePtr->polygonPtr != NULL)
+            {
+                le_mem_Release(fencePtr->polygonPtr);
+            }
+            le_mem_Release(fencePtr);
+            return NULL;
+        }
+    }
+
+    fencePtr->sessionRef = le_pos_GetClientSessionRef();
+    fencePtr->isInside = false;
+    fencePtr->dwellReported = false;
+    fencePtr->positionCount = PositionCount;
+    fencePtr->isLarge = false;
+    fencePtr->cellEntryList = LE_DLS_LIST_INIT;
+    fencePtr->insideLink = LE_DLS_LINK_INIT;
+    fencePtr->largeLink = LE_DLS_LINK_INIT;
+    fencePtr->link = LE_DLS_LINK_INIT;
+
+    IndexFence(fencePtr);
+    le_dls_Queue(&FenceList, &fencePtr->link);
+
+    fencePtr->ref = le_ref_CreateRef(FenceMap, fencePtr);
+
+    LE_DEBUG("Fence %p created, [%d..%d] x [%d..%d]%s", fencePtr->ref,
+             fencePtr->minLat, fencePtr->maxLat, fencePtr->minLong, fencePtr->maxLong,
+             fencePtr->isLarge ? " (large)" : "");
+
+    return fencePtr->ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a fence from the engine and free it.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteFence
+(
+    Fence_t* fencePtr
+)
+{
+    UnindexFence(fencePtr);
+
+    if (fencePtr->isInside)
+    {
+        le_dls_Remove(&InsideFenceList, &fencePtr->insideLink);
+    }
+    le_dls_Remove(&FenceList, &fencePtr->link);
+    le_ref_DeleteRef(FenceMap, fencePtr->ref);
+
+    if (fencePtr->polygonPtr != NULL)
+    {
+        le_mem_Release(fencePtr->polygonPtr);
+    }
+    le_mem_Release(fencePtr);
+
+    if (le_dls_IsEmpty(&FenceList) && (GnssHandlerRef != NULL))
+    {
+        le_gnss_RemovePositionHandler(GnssHandlerRef);
+        GnssHandlerRef = NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function called when a client session closes: deletes the fences and the handlers of
+ * the client.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSessionEventHandler
+(
+    le_msg_SessionRef_t sessionRef,
+    void*               contextPtr
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&FenceList);
+
+    while (linkPtr != NULL)
+    {
+        Fence_t* fencePtr = CONTAINER_OF(linkPtr, Fence_t, link);
+
+        linkPtr = le_dls_PeekNext(&FenceList, linkPtr);
+
+        if (fencePtr->sessionRef == sessionRef)
+        {
+            DeleteFence(fencePtr);
+        }
+    }
+
+    linkPtr = le_dls_Peek(&FenceHandlerList);
+
+    while (linkPtr != NULL)
+    {
+        FenceHandler_t* handlerPtr = CONTAINER_OF(linkPtr, FenceHandler_t, link);
+
+        linkPtr = le_dls_PeekNext(&FenceHandlerList, linkPtr);
+
+        if (handlerPtr->sessionRef == sessionRef)
+        {
+            le_dls_Remove(&FenceHandlerList, &handlerPtr->link);
+            le_mem_Release(handlerPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+//                                       Internal functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to initialize the geofence engine.
+ */
+//--------------------------------------------------------------------------------------------------
+void posFence_Init
+(
+    void
+)
+{
+    FencePoolRef = le_mem_CreatePool("FencePoolRef", sizeof(Fence_t));
+    PolygonPoolRef = le_mem_CreatePool("FencePolygonPoolRef", sizeof(Polygon_t));
+    CellPoolRef = le_mem_CreatePool("FenceCellPoolRef", sizeof(Cell_t));
+    CellEntryPoolRef = le_mem_CreatePool("FenceCellEntryPoolRef", sizeof(CellEntry_t));
+    FenceHandlerPoolRef = le_mem_CreatePool("FenceHandlerPoolRef", sizeof(FenceHandler_t));
+
+    FenceMap = le_ref_CreateMap("FenceMap", FENCE_DEFAULT_MAX);
+
+    Grid = le_hashmap_Create("FenceGrid",
+                             FENCE_DEFAULT_MAX,
+                             le_hashmap_HashUInt64,
+                             le_hashmap_EqualsUInt64);
+
+    // The fences and handlers of a client are deleted when it disconnects.
+    le_msg_AddServiceCloseHandler(le_pos_GetServiceRef(), CloseSessionEventHandler, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Evaluate the geofences against a new position and report their events.
+ *
+ * @return The number of fences checked against the position.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t posFence_ProcessPosition
+(
+    int32_t latitude,       ///< [IN] WGS84 Latitude in degrees [resolution 1e-6].
+    int32_t longitude       ///< [IN] WGS84 Longitude in degrees [resolution 1e-6].
+)
+{
+    le_clk_Time_t  now = le_clk_GetRelativeTime();
+    uint64_t       key = GetCellKey(GetCellCoordinate(latitude), GetCellCoordinate(longitude));
+    Cell_t*        cellPtr = le_hashmap_Get(Grid, &key);
+    le_dls_Link_t* linkPtr;
+    uint32_t       checkCount = 0;
+
+    PositionCount++;
+
+    // The fences the position was inside of, they may have to report an exit.
+    linkPtr = le_dls_Peek(&InsideFenceList);
+    while (linkPtr != NULL)
+    {
+        Fence_t* fencePtr = CONTAINER_OF(linkPtr, Fence_t, insideLink);
+
+        linkPtr = le_dls_PeekNext(&InsideFenceList, linkPtr);
+        checkCount += CheckFence(fencePtr, latitude, longitude, now);
+    }
+
+    // The fences around the position.
+    if (cellPtr != NULL)
+    {
+        linkPtr = le_dls_Peek(&cellPtr->entryList);
+        while (linkPtr != NULL)
+        {
+            CellEntry_t* entryPtr = CONTAINER_OF(linkPtr, CellEntry_t, cellLink);
+
+            linkPtr = le_dls_PeekNext(&cellPtr->entryList, linkPtr);
+            checkCount += CheckFence(entryPtr->fencePtr, latitude, longitude, now);
+        }
+    }
+
+    // The fences too large for the grid.
+    linkPtr = le_dls_Peek(&LargeFenceList);
+    while (linkPtr != NULL)
+    {
+        Fence_t* fencePtr = CONTAINER_OF(linkPtr, Fence_t, largeLink);
+
+        linkPtr = le_dls_PeekNext(&LargeFenceList, linkPtr);
+        checkCount += CheckFence(fencePtr, latitude, longitude, now);
+    }
+
+    return checkCount;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+//                                       API functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to register an handler for geofence events.
+ *
+ * @return A handler reference, which is only needed for later removal of the handler.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_FenceHandlerRef_t le_pos_AddFenceHandler
+(
+    le_pos_FenceHandlerFunc_t handlerPtr,   ///< [IN] The handler function.
+    void*                     contextPtr    ///< [IN] The context pointer
+)
+{
+    FenceHandler_t* fenceHandlerPtr;
+
+    LE_FATAL_IF((handlerPtr == NULL), "handlerPtr pointer is NULL !");
+
+    fenceHandlerPtr = le_mem_ForceAlloc(FenceHandlerPoolRef);
+    fenceHandlerPtr->handlerFuncPtr = handlerPtr;
+    fenceHandlerPtr->handlerContextPtr = contextPtr;
+    fenceHandlerPtr->sessionRef = le_pos_GetClientSessionRef();
+    fenceHandlerPtr->link = LE_DLS_LINK_INIT;
+
+    le_dls_Queue(&FenceHandlerList, &fenceHandlerPtr->link);
+
+    return (le_pos_FenceHandlerRef_t)fenceHandlerPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to remove a handler for geofence events.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pos_RemoveFenceHandler
+(
+    le_pos_FenceHandlerRef_t handlerRef     ///< [IN] The handler reference.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&FenceHandlerList);
+
+    while (linkPtr != NULL)
+    {
+        FenceHandler_t* fenceHandlerPtr = CONTAINER_OF(linkPtr, FenceHandler_t, link);
+
+        if ((le_pos_FenceHandlerRef_t)fenceHandlerPtr == handlerRef)
+        {
+            le_dls_Remove(&FenceHandlerList, linkPtr);
+            le_mem_Release(fenceHandlerPtr);
+            return;
+        }
+        linkPtr = le_dls_PeekNext(&FenceHandlerList, linkPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a circular geofence.
+ *
+ * @return A reference to the fence, or NULL if the center is not a valid position.
+ *
+ * @note A dwell time of 0 means that no FENCE_DWELL event is reported for this fence.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_FenceRef_t le_pos_fence_CreateCircle
+(
+    int32_t  latitude,      ///< [IN] Latitude of the center [resolution 1e-6].
+    int32_t  longitude,     ///< [IN] Longitude of the center [resolution 1e-6].
+    uint32_t radius,        ///< [IN] Radius in meters.
+    uint32_t dwellTime      ///< [IN] Dwell time in milliseconds.
+)
+{
+    if ( (latitude < -90000000) || (latitude > 90000000) ||
+         (longitude < -180000000) || (longitude > 180000000) )
+    {
+        LE_ERROR("Invalid fence center (%d, %d)", latitude, longitude);
+        return NULL;
+    }
+
+    Fence_t* fencePtr = le_mem_ForceAlloc(FencePoolRef);
+    double   latDelta = ((double)radius * 1000000.0 / METERS_PER_DEGREE) + 1;
+    double   cosLat = cos((double)latitude / 1000000.0 * PI / 180);
+    double   longDelta = (cosLat > 0.01) ? (latDelta / cosLat) : 180000000.0;
+
+    fencePtr->polygonPtr = NULL;
+    fencePtr->latitude = latitude;
+    fencePtr->longitude = longitude;
+    fencePtr->radius = radius;
+    fencePtr->dwellTime = dwellTime;
+
+    // Bounding box, clamped to the valid coordinates.
+    fencePtr->minLat = (int32_t)fmax(latitude - latDelta, -90000000.0);
+    fencePtr->maxLat = (int32_t)fmin(latitude + latDelta, 90000000.0);
+    fencePtr->minLong = (int32_t)fmax(longitude - longDelta, -180000000.0);
+    fencePtr->maxLong = (int32_t)fmin(longitude + longDelta, 180000000.0);
+
+    return AddFence(fencePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a polygonal geofence.
+ *
+ * @return A reference to the fence, or NULL if the polygon has less than 3 vertices or if the
+ *         latitude and longitude arrays don't have the same size.
+ *
+ * @note A dwell time of 0 means that no FENCE_DWELL event is reported for this fence.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_FenceRef_t le_pos_fence_CreatePolygon
+(
+    const int32_t* latitudePtr,     ///< [IN] Latitudes of the vertices [resolution 1e-6].
+    size_t         latitudeSize,    ///< [IN] Number of latitudes.
+    const int32_t* longitudePtr,    ///< [IN] Longitudes of the vertices [resolution 1e-6].
+    size_t         longitudeSize,   ///< [IN] Number of longitudes.
+    uint32_t       dwellTime        ///< [IN] Dwell time in milliseconds.
+)
+{
+    size_t i;
+
+    if ( (latitudeSize != longitudeSize) || (latitudeSize < 3) ||
+         (latitudeSize > LE_POS_MAX_FENCE_VERTICES) )
+    {
+        LE_ERROR("Invalid fence polygon (%zu latitudes, %zu longitudes)",
+                 latitudeSize, longitudeSize);
+        return NULL;
+    }
+
+    Fence_t*   fencePtr = le_mem_ForceAlloc(FencePoolRef);
+    Polygon_t* polygonPtr = le_mem_ForceAlloc(PolygonPoolRef);
+
+    polygonPtr->numVertices = latitudeSize;
+    fencePtr->polygonPtr = polygonPtr;
+    fencePtr->radius = 0;
+    fencePtr->dwellTime = dwellTime;
+    fencePtr->minLat = INT32_MAX;
+    fencePtr->maxLat = INT32_MIN;
+    fencePtr->minLong = INT32_MAX;
+    fencePtr->maxLong = INT32_MIN;
+
+    for (i = 0; i < latitudeSize; i++)
+    {
+        polygonPtr->latitude[i] = latitudePtr[i];
+        polygonPtr->longitude[i] = longitudePtr[i];
+
+        fencePtr->minLat = (latitudePtr[i] < fencePtr->minLat) ? latitudePtr[i] : fencePtr->minLat;
+        fencePtr->maxLat = (latitudePtr[i] > fencePtr->maxLat) ? latitudePtr[i] : fencePtr->maxLat;
+        fencePtr->minLong = (longitudePtr[i] < fencePtr->minLong) ?
+                            longitudePtr[i] : fencePtr->minLong;
+        fencePtr->maxLong = (longitudePtr[i] > fencePtr->maxLong) ?
+                            longitudePtr[i] : fencePtr->maxLong;
+    }
+
+    fencePtr->latitude = fencePtr->minLat;
+    fencePtr->longitude = fencePtr->minLong;
+
+    return AddFence(fencePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a geofence.
+ *
+ * @note If the caller is passing an invalid Fence reference into this function,
+ *       it is a fatal error, the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pos_fence_Delete
+(
+    le_pos_FenceRef_t fenceRef      ///< [IN] The fence's reference.
+)
+{
+    Fence_t* fencePtr = le_ref_Lookup(FenceMap, fenceRef);
+
+    if ((fencePtr == NULL) || (fencePtr->sessionRef != le_pos_GetClientSessionRef()))
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", fenceRef);
+        return;
+    }
+
+    DeleteFence(fencePtr);
+}
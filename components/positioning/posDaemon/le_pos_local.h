@@ -0,0 +1,52 @@
+/**
+ * @file le_pos_local.h
+ *
+ * Local Positioning Definitions
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_POS_LOCAL_INCLUDE_GUARD
+#define LEGATO_POS_LOCAL_INCLUDE_GUARD
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calculate the distance in meters between two fix points (use Haversine formula).
+ *
+ * @return The distance in meters.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pos_ComputeDistance
+(
+    int32_t latitude1,      ///< [IN] Latitude of the first point [resolution 1e-6].
+    int32_t longitude1,     ///< [IN] Longitude of the first point [resolution 1e-6].
+    int32_t latitude2,      ///< [IN] Latitude of the second point [resolution 1e-6].
+    int32_t longitude2      ///< [IN] Longitude of the second point [resolution 1e-6].
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to initialize the geofence engine.
+ */
+//--------------------------------------------------------------------------------------------------
+void posFence_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Evaluate the geofences against a new position and report their events.
+ *
+ * @return The number of fences checked against the position.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t posFence_ProcessPosition
+(
+    int32_t latitude,       ///< [IN] WGS84 Latitude in degrees [resolution 1e-6].
+    int32_t longitude       ///< [IN] WGS84 Longitude in degrees [resolution 1e-6].
+);
+
+#endif // LEGATO_POS_LOCAL_INCLUDE_GUARD
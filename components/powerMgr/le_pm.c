@@ -21,11 +21,25 @@
 ///@{
 //--------------------------------------------------------------------------------------------------
 /**
- * Power Management sysfs interface files
+ * Power Management sysfs interface files. They are looked for below the directory given by the
+ * SYSFS_ROOT_ENV environment variable if it is set, e.g. to run on a fake sysfs tree.
  */
 //--------------------------------------------------------------------------------------------------
 #define WAKE_LOCK_FILE      "/sys/power/wake_lock"
 #define WAKE_UNLOCK_FILE    "/sys/power/wake_unlock"
+#define SYSFS_ROOT_ENV      "LE_PM_SYSFS_ROOT"
+///@}
+
+///@{
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time the kernel wake lock is still held after the last wakeup source is released, so that
+ * bursts of short StayAwake/Relax sequences don't toggle the kernel wake lock and trigger suspend
+ * attempts. It can be changed with the HOLD_OFF_ENV environment variable, 0 disables the hold-off.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_HOLD_OFF_MS 100
+#define HOLD_OFF_ENV        "LE_PM_HOLD_OFF_MS"
 ///@}
 
 //--------------------------------------------------------------------------------------------------
@@ -35,6 +49,13 @@
 //--------------------------------------------------------------------------------------------------
 #define LEGATO_TAG_PREFIX   "legato"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the kernel wake lock held on behalf of all the Legato wakeup sources
+ */
+//--------------------------------------------------------------------------------------------------
+#define LEGATO_WAKE_LOCK    LEGATO_TAG_PREFIX
+
 ///@{
 //--------------------------------------------------------------------------------------------------
 /**
@@ -74,6 +95,9 @@ typedef struct {
     pid_t         pid;      // client pid of wakeup source owner
     void          *wsref;   // back-pointer to safe reference
     bool          isRef;     // true if reference counted, false if not
+    uint32_t      acquireCount; // number of times the wakeup source was acquired
+    uint64_t      holdTime;     // total hold time in ms, not including the current hold
+    le_clk_Time_t takenTime;    // time the wakeup source was last taken
 }
 WakeupSource_t;
 #define PM_WAKEUP_SOURCE_COOKIE 0xa1f6337b
@@ -103,8 +127,10 @@ static struct {
     le_hashmap_Ref_t    locks;   // table of wakeup source records
     le_mem_PoolRef_t    cpool;   // memory pool for client records
     le_hashmap_Ref_t    clients; // table of client records
+    uint32_t            held;    // number of wakeup sources taken
+    le_timer_Ref_t      holdOff; // timer delaying the release of the kernel wake lock
 }
-PowerManager = {-1, -1, NULL, NULL, NULL, NULL, NULL};
+PowerManager = {-1, -1, NULL, NULL, NULL, NULL, NULL, 0, NULL};
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -145,6 +171,95 @@ static inline Client_t *to_Client_t(void *c)
 #define to_Client_t(c) ((Client_t*)c)
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the time elapsed since a given time, in milliseconds
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedMs(le_clk_Time_t since)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), since);
+
+    return (uint64_t)elapsed.sec * 1000 + elapsed.usec / 1000;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the kernel wake lock
+ *
+ * @note The process exits on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseWakeLock(void)
+{
+    // write to /sys/power/wake_unlock
+    if (0 > write(PowerManager.wu, LEGATO_WAKE_LOCK, strlen(LEGATO_WAKE_LOCK)))
+        LE_FATAL("Error releasing wake lock '%s', errno = %d.", LEGATO_WAKE_LOCK, errno);
+
+    LE_DEBUG("Wake lock '%s' released.", LEGATO_WAKE_LOCK);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hold-off timer expiry: no wakeup source was taken again, release the kernel wake lock
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void OnHoldOffExpiry(le_timer_Ref_t timerRef)
+{
+    ReleaseWakeLock();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Account for a wakeup source being taken. The kernel wake lock is acquired with the first one.
+ *
+ * @note The process exits on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static void TakeWakeLock(WakeupSource_t *ws)
+{
+    ws->takenTime = le_clk_GetRelativeTime();
+
+    if (PowerManager.held++)
+        return;
+
+    // The kernel wake lock is still held if its release is pending
+    if (PowerManager.holdOff && le_timer_IsRunning(PowerManager.holdOff)) {
+        le_timer_Stop(PowerManager.holdOff);
+        return;
+    }
+
+    // Write to /sys/power/wake_lock
+    if (0 > write(PowerManager.wl, LEGATO_WAKE_LOCK, strlen(LEGATO_WAKE_LOCK)))
+        LE_FATAL("Error acquiring wake lock '%s' for wakeup source '%s', errno = %d.",
+            LEGATO_WAKE_LOCK, ws->name, errno);
+
+    LE_DEBUG("Wake lock '%s' acquired for wakeup source '%s'.", LEGATO_WAKE_LOCK, ws->name);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Account for a wakeup source being released. The kernel wake lock is released with the last one,
+ * once the hold-off time has elapsed.
+ *
+ * @note The process exits on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static void GiveWakeLock(WakeupSource_t *ws)
+{
+    ws->holdTime += GetElapsedMs(ws->takenTime);
+
+    if (--PowerManager.held)
+        return;
+
+    if (PowerManager.holdOff)
+        le_timer_Start(PowerManager.holdOff);
+    else
+        ReleaseWakeLock();
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Client connect callback
@@ -211,8 +326,9 @@ static void OnClientDisconnect
         }
 
         // Delete wakeup source record, free memory
-        LE_INFO("Deleting wakeup source '%s' on behalf of pid %d.",
-                ws->name, ws->pid);
+        LE_INFO("Deleting wakeup source '%s' on behalf of pid %d "
+                "(acquired %u times, held %"PRIu64" ms).",
+                ws->name, ws->pid, ws->acquireCount, ws->holdTime);
         le_hashmap_Remove(PowerManager.locks, ws->name);
         le_ref_DeleteRef(PowerManager.refs, ws->wsref);
         le_mem_Release(ws);
@@ -238,16 +354,39 @@ static void OnClientDisconnect
 //--------------------------------------------------------------------------------------------------
 COMPONENT_INIT
 {
+    char wakeLockPath[PATH_MAX];
+    char wakeUnlockPath[PATH_MAX];
+    const char *sysfsRoot = getenv(SYSFS_ROOT_ENV);
+    const char *holdOffStr = getenv(HOLD_OFF_ENV);
+    int holdOffMs;
+
+    if (NULL == sysfsRoot)
+        sysfsRoot = "";
+
+    if ((NULL == holdOffStr) || (LE_OK != le_utf8_ParseInt(&holdOffMs, holdOffStr)) ||
+        (holdOffMs < 0))
+        holdOffMs = DEFAULT_HOLD_OFF_MS;
+
     // Atomic initialization: initialize all items or fail
     // Open wake lock file
-    PowerManager.wl = open(WAKE_LOCK_FILE, O_RDWR);
+    snprintf(wakeLockPath, sizeof(wakeLockPath), "%s%s", sysfsRoot, WAKE_LOCK_FILE);
+    PowerManager.wl = open(wakeLockPath, O_RDWR);
     if (-1 == PowerManager.wl)
-        LE_FATAL("Failed to open %s, errno = %d.", WAKE_LOCK_FILE, errno);
+        LE_FATAL("Failed to open %s, errno = %d.", wakeLockPath, errno);
 
     // Open wake unlock file
-    PowerManager.wu = open(WAKE_UNLOCK_FILE, O_RDWR);
+    snprintf(wakeUnlockPath, sizeof(wakeUnlockPath), "%s%s", sysfsRoot, WAKE_UNLOCK_FILE);
+    PowerManager.wu = open(wakeUnlockPath, O_RDWR);
     if (-1 == PowerManager.wu)
-        LE_FATAL("Failed to open %s, errno = %d.", WAKE_UNLOCK_FILE, errno);
+        LE_FATAL("Failed to open %s, errno = %d.", wakeUnlockPath, errno);
+
+    // Create the timer delaying the release of the kernel wake lock
+    if (holdOffMs > 0) {
+        PowerManager.holdOff = le_timer_Create("PM Wake Lock Hold-Off");
+        le_timer_SetMsInterval(PowerManager.holdOff, holdOffMs);
+        le_timer_SetHandler(PowerManager.holdOff, OnHoldOffExpiry);
+    }
+    LE_INFO("Wake lock release hold-off is %d ms.", holdOffMs);
 
     // Create table of safe references
     PowerManager.refs = le_ref_CreateMap("PM References", 31);
@@ -329,6 +468,8 @@ le_pm_WakeupSourceRef_t le_pm_NewWakeupSource(uint32_t opts, const char *tag)
     ws->cookie = PM_WAKEUP_SOURCE_COOKIE;
     strcpy(ws->name, name);
     ws->taken = 0;
+    ws->acquireCount = 0;
+    ws->holdTime = 0;
     ws->pid = cl->pid;
     ws->isRef = (opts & LE_PM_REF_COUNT ? true : false);
 
@@ -365,6 +506,8 @@ void le_pm_StayAwake(le_pm_WakeupSourceRef_t w)
     if (!entry)
         LE_FATAL("Wakeup source '%s' not created.\n", ws->name);
 
+    entry->acquireCount++;
+
     if (entry->taken++) {
         if (!entry->isRef) {
             LE_WARN("Wakeup source '%s' already acquired.", entry->name);
@@ -375,10 +518,8 @@ void le_pm_StayAwake(le_pm_WakeupSourceRef_t w)
         return;
     }
 
-    // Write to /sys/power/wake_lock
-    if (0 > write(PowerManager.wl, entry->name, strlen(entry->name)))
-        LE_FATAL("Error acquiring wakeup soruce '%s', errno = %d.",
-            entry->name, errno);
+    // All the wakeup sources share a single kernel wake lock
+    TakeWakeLock(entry);
 
     return;
 }
@@ -423,10 +564,43 @@ void le_pm_Relax(le_pm_WakeupSourceRef_t w)
         entry->taken = 0;
     }
 
-    // write to /sys/power/wake_unlock
-    if (0 > write(PowerManager.wu, entry->name, strlen(entry->name)))
-        LE_FATAL("Error releasing wakeup soruce '%s', errno = %d.",
-            entry->name, errno);
+    GiveWakeLock(entry);
+
+    return;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of a wakeup source
+ *
+ * @note The process exits on failure
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pm_GetWakeupSourceStats
+(
+    le_pm_WakeupSourceRef_t w,
+    uint32_t *acquireCountPtr,
+    uint64_t *holdTimePtr
+)
+{
+    WakeupSource_t *ws;
+
+    *acquireCountPtr = 0;
+    *holdTimePtr = 0;
+
+    // Validate the reference, check if it exists
+    ws = ToWakeupSource(w);
+    // If the wakeup source is NULL then the client will have
+    // been killed and we can just return
+    if (NULL == ws)
+        return;
+
+    *acquireCountPtr = ws->acquireCount;
+    *holdTimePtr = ws->holdTime;
+
+    // Include the current hold
+    if (ws->taken)
+        *holdTimePtr += GetElapsedMs(ws->takenTime);
 
     return;
 }
@@ -163,6 +163,40 @@ Entry_t;
 static le_mem_PoolRef_t EntryPool = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Usage record of a client's area of secure storage.  Caches the amount of space used by the client
+ * and the client's limit so that writes don't have to walk the client's whole area or read the
+ * config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char clientPath[SECSTOREADMIN_MAX_PATH_BYTES];  ///< Path to the client's area.  Key in the map.
+    size_t usedSpace;                               ///< Space, in bytes, used by the client.
+    bool isUsedSpaceValid;                          ///< false if usedSpace must be recomputed.
+    size_t limit;                                   ///< Client's limit, in bytes.
+    bool isLimitValid;                              ///< false if limit must be read again.
+}
+ClientUsage_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of client usage records.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ClientUsagePool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map of client usage records, keyed by the path to the client's area in secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t ClientUsageMap = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if the specified system index is in the list.
@@ -657,11 +691,92 @@ static void GetClientPath
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the usage record of a client's area of secure storage, creating it if needed.  A new record
+ * has neither its used space nor its limit loaded yet.
+ *
+ * @return
+ *      Pointer to the client's usage record.
+ */
+//--------------------------------------------------------------------------------------------------
+static ClientUsage_t* GetClientUsage
+(
+    const char* clientPathPtr               ///< [IN] Path to the client's area in secure storage.
+)
+{
+    ClientUsage_t* usagePtr = le_hashmap_Get(ClientUsageMap, clientPathPtr);
+
+    if (usagePtr == NULL)
+    {
+        usagePtr = le_mem_ForceAlloc(ClientUsagePool);
+
+        LE_ASSERT(le_utf8_Copy(usagePtr->clientPath, clientPathPtr, sizeof(usagePtr->clientPath),
+                               NULL) == LE_OK);
+        usagePtr->usedSpace = 0;
+        usagePtr->isUsedSpaceValid = false;
+        usagePtr->limit = 0;
+        usagePtr->isLimitValid = false;
+
+        le_hashmap_Put(ClientUsageMap, usagePtr->clientPath, usagePtr);
+    }
+
+    return usagePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks the used space of all clients as unknown, so that it gets recomputed on the next write.
+ * Used when secure storage was modified without going through a client's own area.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InvalidateUsedSpace
+(
+    void
+)
+{
+    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(ClientUsageMap);
+
+    while (le_hashmap_NextNode(iter) == LE_OK)
+    {
+        ClientUsage_t* usagePtr = (ClientUsage_t*)le_hashmap_GetValue(iter);
+
+        usagePtr->isUsedSpaceValid = false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when the apps configuration changes.  The limits of the clients may have changed so they
+ * are read again on the next write.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppConfigChangeHandler
+(
+    void
+)
+{
+    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(ClientUsageMap);
+
+    while (le_hashmap_NextNode(iter) == LE_OK)
+    {
+        ClientUsage_t* usagePtr = (ClientUsage_t*)le_hashmap_GetValue(iter);
+
+        usagePtr->isLimitValid = false;
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if there is enough space in the client's area of secure storage for the client to write
  * the item.
  *
+ * The client's limit and used space are taken from its usage record, and only loaded if the record
+ * doesn't have them yet.
+ *
  * @return
  *      LE_OK if the item would fit in the client's area of secure storage.
  *      LE_NO_MEMORY if there is not enough memory to store the item.
@@ -672,29 +787,44 @@ static void GetClientPath
 static le_result_t CheckClientLimit
 (
     const char* clientNamePtr,              ///< [IN] Name of the client.
-    const char* clientPathPtr,              ///< [IN] Path to the client's area in secure storage.
+    ClientUsage_t* usagePtr,                ///< [IN] Usage record of the client.
     const char* itemNamePtr,                ///< [IN] Name of the item.
-    size_t itemSize                         ///< [IN] Size, in bytes, of the item.
+    size_t itemSize,                        ///< [IN] Size, in bytes, of the item.
+    size_t* origItemSizePtr                 ///< [OUT] Size, in bytes, of the item currently stored.
 )
 {
+    le_result_t result;
+
     // Get the secure storage limit for the client.
-    appCfg_Iter_t iter = appCfg_FindApp(clientNamePtr);
-    size_t secStoreLimit = appCfg_GetSecStoreLimit(iter);
-    appCfg_DeleteIter(iter);
+    if (!usagePtr->isLimitValid)
+    {
+        appCfg_Iter_t iter = appCfg_FindApp(clientNamePtr);
+        usagePtr->limit = appCfg_GetSecStoreLimit(iter);
+        appCfg_DeleteIter(iter);
 
-    // Get the current amount of space used by the client.
-    size_t usedSpace = 0;
-    le_result_t result = pa_secStore_GetSize(clientPathPtr, &usedSpace);
+        usagePtr->isLimitValid = true;
+    }
 
-    if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+    // Get the current amount of space used by the client.
+    if (!usagePtr->isUsedSpaceValid)
     {
-        return result;
+        size_t usedSpace = 0;
+        result = pa_secStore_GetSize(usagePtr->clientPath, &usedSpace);
+
+        if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+        {
+            return result;
+        }
+
+        usagePtr->usedSpace = usedSpace;
+        usagePtr->isUsedSpaceValid = true;
     }
 
     // Get the size of the item in the secure storage if it already exists.
     char itemPath[SECSTOREADMIN_MAX_PATH_BYTES] = "";
 
-    LE_FATAL_IF(le_path_Concat("/", itemPath, sizeof(itemPath), clientPathPtr, itemNamePtr, NULL) != LE_OK,
+    LE_FATAL_IF(le_path_Concat("/", itemPath, sizeof(itemPath), usagePtr->clientPath, itemNamePtr,
+                               NULL) != LE_OK,
                 "Client %s's path for item %s is too long.", clientNamePtr, itemNamePtr);
 
     size_t origItemSize = 0;
@@ -705,8 +835,10 @@ static le_result_t CheckClientLimit
         return result;
     }
 
+    *origItemSizePtr = origItemSize;
+
     // Calculate if replacing the item would fit within the limit.
-    if (((ssize_t)(secStoreLimit - usedSpace + origItemSize - itemSize)) >= 0)
+    if (((ssize_t)(usagePtr->limit - usagePtr->usedSpace + origItemSize - itemSize)) >= 0)
     {
         return LE_OK;
     }
@@ -805,6 +937,8 @@ static le_result_t Write
 
     char path[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
     le_result_t result;
+    ClientUsage_t* usagePtr = NULL;
+    size_t origItemSize = 0;
 
     if(isGlobal)
     {
@@ -828,7 +962,9 @@ static le_result_t Write
         GetClientPath(clientName, isApp, path, sizeof(path));
 
         // Check the available limit for the client.
-        result = CheckClientLimit(clientName, path, name, bufNumElements);
+        usagePtr = GetClientUsage(path);
+
+        result = CheckClientLimit(clientName, usagePtr, name, bufNumElements, &origItemSize);
 
         if (result != LE_OK)
         {
@@ -843,6 +979,19 @@ static le_result_t Write
     // Write the item to the secure storage.
     result = pa_secStore_Write(path, bufPtr, bufNumElements);
 
+    if (usagePtr != NULL)
+    {
+        if (result == LE_OK)
+        {
+            usagePtr->usedSpace = usagePtr->usedSpace - origItemSize + bufNumElements;
+        }
+        else
+        {
+            // The item may have been partially written.
+            usagePtr->isUsedSpaceValid = false;
+        }
+    }
+
     if (result == LE_BAD_PARAMETER)
     {
         return LE_FAULT;
@@ -1066,6 +1215,8 @@ le_result_t Delete
     }
 
     char path[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
+    ClientUsage_t* usagePtr = NULL;
+    size_t itemSize = 0;
 
     if(isGlobal)
     {
@@ -1088,13 +1239,40 @@ le_result_t Delete
         // Get the path to the client's secure storage area.
         GetClientPath(clientName, isApp, path, sizeof(path));
 
+        usagePtr = GetClientUsage(path);
+
         // Append item name to client path.
         LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
                     "Client %s's path for item %s is too long.", clientName, name);
+
+        // Get the size of the item so that it can be removed from the client's used space.
+        if (usagePtr->isUsedSpaceValid)
+        {
+            le_result_t result = pa_secStore_GetSize(path, &itemSize);
+
+            if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+            {
+                usagePtr->isUsedSpaceValid = false;
+            }
+        }
     }
 
     // Delete the item from the secure storage.
-    return pa_secStore_Delete(path);
+    le_result_t result = pa_secStore_Delete(path);
+
+    if ( (usagePtr != NULL) && (usagePtr->isUsedSpaceValid) )
+    {
+        if ( (result == LE_OK) && (itemSize <= usagePtr->usedSpace) )
+        {
+            usagePtr->usedSpace -= itemSize;
+        }
+        else if (result != LE_NOT_FOUND)
+        {
+            usagePtr->isUsedSpaceValid = false;
+        }
+    }
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1529,6 +1707,9 @@ le_result_t secStoreAdmin_Write
         return LE_FAULT;
     }
 
+    // The item may be in a client's area.
+    InvalidateUsedSpace();
+
     // Write the item to the secure storage.
     return pa_secStore_Write(path, bufPtr, bufNumElements);
 }
@@ -1633,6 +1814,9 @@ le_result_t secStoreAdmin_Delete
         return LE_FAULT;
     }
 
+    // The path may be in, or contain, a client's area.
+    InvalidateUsedSpace();
+
     // Delete the item from the secure storage.
     return pa_secStore_Delete(path);
 }
@@ -1725,6 +1909,15 @@ COMPONENT_INIT
 
     SystemIndexPool = le_mem_CreatePool("SystemIndexPool", sizeof(SystemsIndex_t));
 
+    ClientUsagePool = le_mem_CreatePool("ClientUsagePool", sizeof(ClientUsage_t));
+    ClientUsageMap = le_hashmap_Create("ClientUsageMap",
+                                       31,
+                                       le_hashmap_HashString,
+                                       le_hashmap_EqualsString);
+
+    // Client limits are cached, so they must be read again when the apps configuration changes.
+    appCfg_SetChangeHandler(AppConfigChangeHandler);
+
     // Register a handler that will clean up client specific data when clients disconnect.
     le_msg_AddServiceCloseHandler(secStoreAdmin_GetServiceRef(),
                                   CleanupClientIterators,
@@ -0,0 +1,1357 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  SMS Inbox Server
+ *
+ * Message store. The messages of all the message boxes are kept in a single append-only log made
+ * of CRC-protected records:
+ *  - a message record holds a message and the message boxes it was added to,
+ *  - a state record holds the new read/unread and message box masks of a message, a message in no
+ *    message box being deleted,
+ *  - a counter record holds the next message identifier, so that identifiers are never reused.
+ *
+ * An index of the live messages is rebuilt in memory by replaying the log at start-up; the log is
+ * only read afterwards to fetch the strings and the data of a message. Replay stops at the first
+ * invalid record, which is how a record torn by a power loss is detected, and the log is truncated
+ * there.
+ *
+ * When obsolete records make up more than half of the log, it is compacted: the live messages are
+ * written with their current state to a new log, which atomically replaces the old one.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "msgStore.h"
+
+#include <sys/mman.h>
+
+//--------------------------------------------------------------------------------------------------
+// Symbols and enums.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number at the start of each record ("SMSR").
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_MAGIC 0x534d5352
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record types.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_MSG      1
+#define RECORD_STATE    2
+#define RECORD_COUNTER  3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of a string which is not available.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STRING_ABSENT   0xFF
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of data which is not available.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DATA_ABSENT     0xFFFF
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RECORD_BYTES (sizeof(RecordHeader_t) + sizeof(MsgPayload_t) + \
+                          (MSGSTORE_NUM_STRINGS * (STRING_ABSENT - 1)) + MSGSTORE_MAX_DATA_BYTES)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The log is compacted when it holds more than this number of obsolete bytes, and more obsolete
+ * bytes than live ones.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPACT_MIN_DEAD_BYTES  (16 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer used to write the compacted log.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPACT_BUFFER_BYTES    (32 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of messages, used to size the index.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_MAP_SIZE 256
+
+//--------------------------------------------------------------------------------------------------
+// Data structures.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record header.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;         ///< RECORD_MAGIC.
+    uint32_t crc;           ///< CRC32 of the rest of the header and of the payload.
+    uint16_t type;          ///< Record type.
+    uint16_t length;        ///< Number of bytes of payload following the header.
+    uint32_t msgId;         ///< Message identifier, next message identifier for a counter record.
+    uint32_t mboxMask;      ///< Message boxes the message belongs to.
+    uint32_t unreadMask;    ///< Message boxes where the message is unread.
+}
+RecordHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fixed part of a message record payload. It is followed by the strings, without terminating
+ * null character, then by the data.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int32_t  format;                        ///< Message format.
+    uint32_t msgLen;                        ///< Message length.
+    uint8_t  strLen[MSGSTORE_NUM_STRINGS];  ///< String lengths, STRING_ABSENT if not available.
+    uint8_t  reserved;
+    uint16_t dataLen;                       ///< Data length, DATA_ABSENT if not available.
+    uint16_t reserved2;
+}
+MsgPayload_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index entry of a message.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t      msgId;        ///< Message identifier.
+    int32_t       format;       ///< Message format.
+    uint32_t      msgLen;       ///< Message length.
+    uint32_t      mboxMask;     ///< Message boxes the message belongs to.
+    uint32_t      unreadMask;   ///< Message boxes where the message is unread.
+    off_t         offset;       ///< Offset of the message record in the log.
+    uint16_t      recordLen;    ///< Size of the message record.
+    le_dls_Link_t link;         ///< Link in MsgList.
+    le_dls_Link_t mboxLink[];   ///< Links in the message box lists, one per message box.
+}
+MsgEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message box.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_List_t list;     ///< Messages of the message box, oldest first.
+    uint32_t      count;    ///< Number of messages in the list.
+    uint32_t      size;     ///< Maximum number of messages.
+}
+Mbox_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static declarations.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of index entries, and number of message boxes it was sized for.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t EntryPool;
+static size_t PoolNumMbox;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index entries by message identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t MsgMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * All the index entries, in the order of the log.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t MsgList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message boxes.
+ */
+//--------------------------------------------------------------------------------------------------
+static Mbox_t Mboxes[MSGSTORE_MAX_MBOX];
+static size_t NumMbox;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log file.
+ */
+//--------------------------------------------------------------------------------------------------
+static int LogFd = -1;
+static char LogPath[PATH_MAX];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the log being written by a compaction.
+ */
+//--------------------------------------------------------------------------------------------------
+static char TmpPath[PATH_MAX];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the log, and number of its bytes holding live message records.
+ */
+//--------------------------------------------------------------------------------------------------
+static off_t LogSize;
+static off_t LiveBytes;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Next message identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NextMsgId = 1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the index entry owning a message box link.
+ */
+//--------------------------------------------------------------------------------------------------
+static MsgEntry_t* EntryFromMboxLink
+(
+    le_dls_Link_t* linkPtr,     ///< [IN] Message box link.
+    size_t         mbox         ///< [IN] Message box index.
+)
+{
+    return (MsgEntry_t*)((uint8_t*)(linkPtr - mbox) - offsetof(MsgEntry_t, mboxLink));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the index entry of a message.
+ *
+ * @return The entry, or NULL if the message doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+static MsgEntry_t* GetEntry
+(
+    uint32_t msgId      ///< [IN] Message identifier.
+)
+{
+    return le_hashmap_Get(MsgMap, &msgId);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the CRC of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ComputeRecordCrc
+(
+    const uint8_t* recordPtr    ///< [IN] The record, header then payload.
+)
+{
+    const RecordHeader_t* hdrPtr = (const RecordHeader_t*)recordPtr;
+    size_t crcOffset = offsetof(RecordHeader_t, type);
+
+    return le_crc_Crc32((uint8_t*)recordPtr + crcOffset,
+                        sizeof(RecordHeader_t) + hdrPtr->length - crcOffset,
+                        LE_CRC_START_CRC32);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a message record payload is consistent.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsMsgPayloadValid
+(
+    const uint8_t* payloadPtr,  ///< [IN] The payload.
+    size_t         length       ///< [IN] Length of the payload.
+)
+{
+    const MsgPayload_t* msgPtr = (const MsgPayload_t*)payloadPtr;
+    size_t expected = sizeof(MsgPayload_t);
+    int i;
+
+    if (length < sizeof(MsgPayload_t))
+    {
+        return false;
+    }
+
+    for (i = 0; i < MSGSTORE_NUM_STRINGS; i++)
+    {
+        if (msgPtr->strLen[i] != STRING_ABSENT)
+        {
+            expected += msgPtr->strLen[i];
+        }
+    }
+
+    if (msgPtr->dataLen != DATA_ABSENT)
+    {
+        expected += msgPtr->dataLen;
+    }
+
+    return (expected == length);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a record to the log.
+ *
+ * @return
+ *  - LE_OK    Function succeeded.
+ *  - LE_FAULT The record couldn't be written.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AppendRecord
+(
+    uint8_t* recordPtr,     ///< [IN] The record, its magic and CRC are filled in.
+    bool     sync,          ///< [IN] Whether to sync the record to the storage.
+    off_t*   offsetPtr      ///< [OUT] Offset of the record in the log, may be NULL.
+)
+{
+    RecordHeader_t* hdrPtr = (RecordHeader_t*)recordPtr;
+    size_t recordLen = sizeof(RecordHeader_t) + hdrPtr->length;
+    ssize_t written;
+
+    hdrPtr->magic = RECORD_MAGIC;
+    hdrPtr->crc = ComputeRecordCrc(recordPtr);
+
+    do
+    {
+        written = write(LogFd, recordPtr, recordLen);
+    }
+    while ((written == -1) && (errno == EINTR));
+
+    if (written != (ssize_t)recordLen)
+    {
+        LE_ERROR("Failed to write record in %s: %m", LogPath);
+
+        // Don't leave a partial record behind, later records would be lost at replay.
+        if (ftruncate(LogFd, LogSize) == -1)
+        {
+            LE_ERROR("Failed to truncate %s: %m", LogPath);
+        }
+        return LE_FAULT;
+    }
+
+    if (sync && (fdatasync(LogFd) == -1))
+    {
+        LE_WARN("Failed to sync %s: %m", LogPath);
+    }
+
+    if (offsetPtr)
+    {
+        *offsetPtr = LogSize;
+    }
+    LogSize += recordLen;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the index entry of a message record.
+ */
+//--------------------------------------------------------------------------------------------------
+static MsgEntry_t* CreateEntry
+(
+    const RecordHeader_t* hdrPtr,   ///< [IN] Message record header.
+    const MsgPayload_t*   msgPtr,   ///< [IN] Message record payload.
+    off_t                 offset    ///< [IN] Offset of the record in the log.
+)
+{
+    MsgEntry_t* entryPtr = le_mem_ForceAlloc(EntryPool);
+    size_t m;
+
+    entryPtr->msgId = hdrPtr->msgId;
+    entryPtr->format = msgPtr->format;
+    entryPtr->msgLen = msgPtr->msgLen;
+    entryPtr->mboxMask = hdrPtr->mboxMask & ((NumMbox < 32) ? ((1U << NumMbox) - 1) : ~0U);
+    entryPtr->unreadMask = hdrPtr->unreadMask & entryPtr->mboxMask;
+    entryPtr->offset = offset;
+    entryPtr->recordLen = sizeof(RecordHeader_t) + hdrPtr->length;
+    entryPtr->link = LE_DLS_LINK_INIT;
+
+    le_dls_Queue(&MsgList, &entryPtr->link);
+    le_hashmap_Put(MsgMap, &entryPtr->msgId, entryPtr);
+
+    for (m = 0; m < NumMbox; m++)
+    {
+        entryPtr->mboxLink[m] = LE_DLS_LINK_INIT;
+        if (entryPtr->mboxMask & (1U << m))
+        {
+            le_dls_Queue(&Mboxes[m].list, &entryPtr->mboxLink[m]);
+            Mboxes[m].count++;
+        }
+    }
+
+    LiveBytes += entryPtr->recordLen;
+
+    if (hdrPtr->msgId >= NextMsgId)
+    {
+        NextMsgId = hdrPtr->msgId + 1;
+    }
+
+    return entryPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply a new state to an index entry. The entry is freed if the message is in no message box.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyState
+(
+    MsgEntry_t* entryPtr,   ///< [IN] The index entry.
+    uint32_t    mboxMask,   ///< [IN] New message box mask.
+    uint32_t    unreadMask  ///< [IN] New unread mask.
+)
+{
+    // A message is never added to a message box after its creation.
+    uint32_t removedMask = entryPtr->mboxMask & ~mboxMask;
+    size_t m;
+
+    for (m = 0; m < NumMbox; m++)
+    {
+        if (removedMask & (1U << m))
+        {
+            le_dls_Remove(&Mboxes[m].list, &entryPtr->mboxLink[m]);
+            Mboxes[m].count--;
+        }
+    }
+
+    entryPtr->mboxMask &= mboxMask;
+    entryPtr->unreadMask = unreadMask & entryPtr->mboxMask;
+
+    if (0 == entryPtr->mboxMask)
+    {
+        le_dls_Remove(&MsgList, &entryPtr->link);
+        le_hashmap_Remove(MsgMap, &entryPtr->msgId);
+        LiveBytes -= entryPtr->recordLen;
+        le_mem_Release(entryPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replay the log to rebuild the index. The log is truncated at the first invalid record.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReplayLog
+(
+    void
+)
+{
+    struct stat st;
+    off_t offset = 0;
+
+    if ((fstat(LogFd, &st) == -1) || (0 == st.st_size))
+    {
+        LogSize = 0;
+        return;
+    }
+
+    uint8_t* logPtr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, LogFd, 0);
+    if (MAP_FAILED == logPtr)
+    {
+        LE_ERROR("Failed to map %s: %m", LogPath);
+        LogSize = st.st_size;
+        return;
+    }
+
+    while ((offset + (off_t)sizeof(RecordHeader_t)) <= st.st_size)
+    {
+        RecordHeader_t hdr;
+        const uint8_t* payloadPtr = logPtr + offset + sizeof(RecordHeader_t);
+
+        memcpy(&hdr, logPtr + offset, sizeof(hdr));
+
+        if (   (hdr.magic != RECORD_MAGIC)
+            || ((offset + (off_t)sizeof(hdr) + hdr.length) > st.st_size)
+            || (hdr.crc != ComputeRecordCrc(logPtr + offset)) )
+        {
+            break;
+        }
+
+        MsgEntry_t* entryPtr = GetEntry(hdr.msgId);
+
+        if (RECORD_MSG == hdr.type)
+        {
+            if (!IsMsgPayloadValid(payloadPtr, hdr.length))
+            {
+                break;
+            }
+            if (NULL == entryPtr)
+            {
+                MsgPayload_t msg;
+
+                memcpy(&msg, payloadPtr, sizeof(msg));
+                entryPtr = CreateEntry(&hdr, &msg, offset);
+
+                if (0 == entryPtr->mboxMask)
+                {
+                    ApplyState(entryPtr, 0, 0);
+                }
+            }
+        }
+        else if (RECORD_STATE == hdr.type)
+        {
+            if (entryPtr)
+            {
+                ApplyState(entryPtr, hdr.mboxMask, hdr.unreadMask);
+            }
+        }
+        else if (RECORD_COUNTER == hdr.type)
+        {
+            if (hdr.msgId > NextMsgId)
+            {
+                NextMsgId = hdr.msgId;
+            }
+        }
+        else
+        {
+            break;
+        }
+
+        offset += sizeof(hdr) + hdr.length;
+    }
+
+    munmap(logPtr, st.st_size);
+
+    if (offset != st.st_size)
+    {
+        LE_WARN("Discarding %d bytes of invalid records at the end of %s",
+                (int)(st.st_size - offset), LogPath);
+
+        if (ftruncate(LogFd, offset) == -1)
+        {
+            LE_ERROR("Failed to truncate %s: %m", LogPath);
+        }
+    }
+
+    LogSize = offset;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sync the directory of the log, so that a rename is durable.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SyncLogDirectory
+(
+    void
+)
+{
+    char dirPath[PATH_MAX];
+    char* slashPtr;
+
+    le_utf8_Copy(dirPath, LogPath, sizeof(dirPath), NULL);
+    slashPtr = strrchr(dirPath, '/');
+    if (NULL == slashPtr)
+    {
+        le_utf8_Copy(dirPath, ".", sizeof(dirPath), NULL);
+    }
+    else
+    {
+        slashPtr[(slashPtr == dirPath) ? 1 : 0] = '\0';
+    }
+
+    int dirFd = open(dirPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd != -1)
+    {
+        fsync(dirFd);
+        close(dirFd);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a buffer to a file.
+ *
+ * @return true on success.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WriteAll
+(
+    int            fd,          ///< [IN] File descriptor.
+    const uint8_t* bufPtr,      ///< [IN] Data to write.
+    size_t         len          ///< [IN] Number of bytes to write.
+)
+{
+    while (len > 0)
+    {
+        ssize_t written = write(fd, bufPtr, len);
+
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+
+        bufPtr += written;
+        len -= written;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact the log if enough of it is made of obsolete records.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompactIfNeeded
+(
+    void
+)
+{
+    off_t deadBytes = LogSize - LiveBytes;
+
+    if ((deadBytes > COMPACT_MIN_DEAD_BYTES) && (deadBytes > LiveBytes))
+    {
+        msgStore_Compact();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a state record for a message and apply the new state to the index. The index is left
+ * unchanged if the record can't be written.
+ *
+ * @return
+ *  - LE_OK    Function succeeded.
+ *  - LE_FAULT The record couldn't be written.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t UpdateState
+(
+    MsgEntry_t* entryPtr,   ///< [IN] The index entry.
+    uint32_t    mboxMask,   ///< [IN] New message box mask.
+    uint32_t    unreadMask  ///< [IN] New unread mask.
+)
+{
+    mboxMask &= entryPtr->mboxMask;
+    unreadMask &= mboxMask;
+
+    if ((mboxMask == entryPtr->mboxMask) && (unreadMask == entryPtr->unreadMask))
+    {
+        return LE_OK;
+    }
+
+    RecordHeader_t hdr =
+    {
+        .type = RECORD_STATE,
+        .length = 0,
+        .msgId = entryPtr->msgId,
+        .mboxMask = mboxMask,
+        .unreadMask = unreadMask
+    };
+
+    // State changes are not synced: after a power loss, the message may show up unread again.
+    if (AppendRecord((uint8_t*)&hdr, false, NULL) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+    ApplyState(entryPtr, mboxMask, unreadMask);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the message store, replaying its log to rebuild the index. A record torn by a crash at the
+ * end of the log is discarded.
+ *
+ * @return
+ *  - LE_OK            The store is open.
+ *  - LE_BAD_PARAMETER Too many message boxes.
+ *  - LE_FAULT         The log can't be opened.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_Init
+(
+    const char*     pathPtr,        ///< [IN] Path of the log file.
+    size_t          numMbox,        ///< [IN] Number of message boxes.
+    const uint32_t* mboxSizePtr     ///< [IN] Maximum number of messages of each message box.
+)
+{
+    size_t m;
+
+    if (numMbox > MSGSTORE_MAX_MBOX)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    if (NULL == EntryPool)
+    {
+        PoolNumMbox = numMbox;
+        EntryPool = le_mem_CreatePool("MsgStoreEntry",
+                                      sizeof(MsgEntry_t) + (numMbox * sizeof(le_dls_Link_t)));
+        MsgMap = le_hashmap_Create("MsgStoreMap", MSG_MAP_SIZE,
+                                   le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+    }
+    else if (numMbox > PoolNumMbox)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    if (   (le_utf8_Copy(LogPath, pathPtr, sizeof(LogPath), NULL) != LE_OK)
+        || (le_utf8_Copy(TmpPath, pathPtr, sizeof(TmpPath), NULL) != LE_OK)
+        || (le_utf8_Append(TmpPath, ".tmp", sizeof(TmpPath), NULL) != LE_OK) )
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    NumMbox = numMbox;
+    for (m = 0; m < numMbox; m++)
+    {
+        Mboxes[m].list = LE_DLS_LIST_INIT;
+        Mboxes[m].count = 0;
+        Mboxes[m].size = mboxSizePtr[m];
+    }
+    NextMsgId = 1;
+    LiveBytes = 0;
+
+    // Remove the output of a compaction interrupted by a crash.
+    unlink(TmpPath);
+
+    LogFd = open(LogPath, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (-1 == LogFd)
+    {
+        LE_ERROR("Failed to open %s: %m", LogPath);
+        return LE_FAULT;
+    }
+
+    ReplayLog();
+
+    // Message box sizes may have been reduced since the messages were added.
+    for (m = 0; m < numMbox; m++)
+    {
+        while (Mboxes[m].count > Mboxes[m].size)
+        {
+            MsgEntry_t* entryPtr = EntryFromMboxLink(le_dls_Peek(&Mboxes[m].list), m);
+
+            if (UpdateState(entryPtr, entryPtr->mboxMask & ~(1U << m),
+                            entryPtr->unreadMask) != LE_OK)
+            {
+                break;
+            }
+        }
+    }
+
+    CompactIfNeeded();
+
+    LE_INFO("%zu messages in %s, next message id %u",
+            le_hashmap_Size(MsgMap), LogPath, NextMsgId);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the message store and free its index.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgStore_Close
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(&MsgList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, MsgEntry_t, link));
+    }
+
+    if (MsgMap)
+    {
+        le_hashmap_RemoveAll(MsgMap);
+    }
+
+    if (LogFd != -1)
+    {
+        close(LogFd);
+        LogFd = -1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message to the store. The record is synced to the storage before the function returns.
+ *
+ * When a message box is full, its oldest message is removed from it once the new message is
+ * stored. If the removal can't be written, the message box stays over its size until the next
+ * message is added.
+ *
+ * @return The message identifier, or 0 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t msgStore_AddMsg
+(
+    uint32_t                msgId,      ///< [IN] Message identifier, 0 to allocate a new one. If
+                                        ///<      the message already exists, nothing is done.
+    const msgStore_Msg_t*   msgPtr,     ///< [IN] The message.
+    uint32_t                mboxMask,   ///< [IN] Message boxes the message is added to.
+    uint32_t                unreadMask  ///< [IN] Message boxes where the message is unread.
+)
+{
+    uint8_t record[MAX_RECORD_BYTES];
+    RecordHeader_t* hdrPtr = (RecordHeader_t*)record;
+    MsgPayload_t* payloadPtr = (MsgPayload_t*)(record + sizeof(RecordHeader_t));
+    uint8_t* dataPtr = record + sizeof(RecordHeader_t) + sizeof(MsgPayload_t);
+    off_t offset;
+    size_t m;
+    int i;
+
+    if (-1 == LogFd)
+    {
+        return 0;
+    }
+
+    if (msgId != 0)
+    {
+        if (GetEntry(msgId))
+        {
+            return msgId;
+        }
+    }
+    else
+    {
+        msgId = NextMsgId;
+    }
+
+    memset(record, 0, sizeof(RecordHeader_t) + sizeof(MsgPayload_t));
+    payloadPtr->format = msgPtr->format;
+    payloadPtr->msgLen = msgPtr->msgLen;
+
+    for (i = 0; i < MSGSTORE_NUM_STRINGS; i++)
+    {
+        if (NULL == msgPtr->strPtr[i])
+        {
+            payloadPtr->strLen[i] = STRING_ABSENT;
+            continue;
+        }
+
+        size_t len = strlen(msgPtr->strPtr[i]);
+        if (len >= STRING_ABSENT)
+        {
+            LE_ERROR("String %d too long (%zu bytes)", i, len);
+            return 0;
+        }
+        memcpy(dataPtr, msgPtr->strPtr[i], len);
+        dataPtr += len;
+        payloadPtr->strLen[i] = len;
+    }
+
+    if (NULL == msgPtr->dataPtr)
+    {
+        payloadPtr->dataLen = DATA_ABSENT;
+    }
+    else
+    {
+        if (msgPtr->dataLen > MSGSTORE_MAX_DATA_BYTES)
+        {
+            LE_ERROR("Data too long (%zu bytes)", msgPtr->dataLen);
+            return 0;
+        }
+        memcpy(dataPtr, msgPtr->dataPtr, msgPtr->dataLen);
+        dataPtr += msgPtr->dataLen;
+        payloadPtr->dataLen = msgPtr->dataLen;
+    }
+
+    mboxMask &= (NumMbox < 32) ? ((1U << NumMbox) - 1) : ~0U;
+
+    hdrPtr->type = RECORD_MSG;
+    hdrPtr->length = dataPtr - (uint8_t*)payloadPtr;
+    hdrPtr->msgId = msgId;
+    hdrPtr->mboxMask = mboxMask;
+    hdrPtr->unreadMask = unreadMask & mboxMask;
+
+    if (AppendRecord(record, true, &offset) != LE_OK)
+    {
+        return 0;
+    }
+
+    CreateEntry(hdrPtr, payloadPtr, offset);
+
+    // Make room in the full message boxes, the new message is always kept.
+    for (m = 0; m < NumMbox; m++)
+    {
+        if (mboxMask & (1U << m))
+        {
+            while ((Mboxes[m].count > 1) && (Mboxes[m].count > Mboxes[m].size))
+            {
+                MsgEntry_t* oldestPtr = EntryFromMboxLink(le_dls_Peek(&Mboxes[m].list), m);
+
+                LE_DEBUG("Mailbox %zu full, remove message %u", m, oldestPtr->msgId);
+                if (UpdateState(oldestPtr, oldestPtr->mboxMask & ~(1U << m),
+                                oldestPtr->unreadMask) != LE_OK)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    CompactIfNeeded();
+
+    return msgId;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message belongs to a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgStore_IsInMbox
+(
+    uint32_t msgId,     ///< [IN] Message identifier.
+    size_t   mbox       ///< [IN] Message box index.
+)
+{
+    MsgEntry_t* entryPtr = GetEntry(msgId);
+
+    return (entryPtr && (mbox < NumMbox) && (entryPtr->mboxMask & (1U << mbox)));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the format and the length of a message.
+ *
+ * @return
+ *  - LE_OK        Function succeeded.
+ *  - LE_NOT_FOUND The message doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_GetInfo
+(
+    uint32_t  msgId,        ///< [IN] Message identifier.
+    int32_t*  formatPtr,    ///< [OUT] Message format.
+    uint32_t* msgLenPtr     ///< [OUT] Message length.
+)
+{
+    MsgEntry_t* entryPtr = GetEntry(msgId);
+
+    if (NULL == entryPtr)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    *formatPtr = entryPtr->format;
+    *msgLenPtr = entryPtr->msgLen;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the payload of a message record from the log.
+ *
+ * @return
+ *  - LE_OK    Function succeeded.
+ *  - LE_FAULT The message doesn't exist or the record can't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadMsgPayload
+(
+    uint32_t msgId,         ///< [IN] Message identifier.
+    uint8_t* payloadPtr     ///< [OUT] Payload, at least MAX_RECORD_BYTES long.
+)
+{
+    MsgEntry_t* entryPtr = GetEntry(msgId);
+
+    if (NULL == entryPtr)
+    {
+        return LE_FAULT;
+    }
+
+    size_t len = entryPtr->recordLen - sizeof(RecordHeader_t);
+
+    if (pread(LogFd, payloadPtr, len, entryPtr->offset + sizeof(RecordHeader_t)) != (ssize_t)len)
+    {
+        LE_ERROR("Failed to read message %u from %s: %m", msgId, LogPath);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get one of the strings of a message.
+ *
+ * @return
+ *  - LE_OK       Function succeeded.
+ *  - LE_OVERFLOW The string doesn't fit in the buffer.
+ *  - LE_FAULT    The message or the string doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_GetString
+(
+    uint32_t          msgId,    ///< [IN] Message identifier.
+    msgStore_String_t string,   ///< [IN] The string to get.
+    char*             bufPtr,   ///< [OUT] The string.
+    size_t            bufSize   ///< [IN] Size of bufPtr.
+)
+{
+    uint8_t payload[MAX_RECORD_BYTES];
+    const MsgPayload_t* msgPtr = (const MsgPayload_t*)payload;
+    const uint8_t* strPtr = payload + sizeof(MsgPayload_t);
+    int i;
+
+    if ((string >= MSGSTORE_NUM_STRINGS) || (ReadMsgPayload(msgId, payload) != LE_OK))
+    {
+        return LE_FAULT;
+    }
+
+    for (i = 0; i < string; i++)
+    {
+        if (msgPtr->strLen[i] != STRING_ABSENT)
+        {
+            strPtr += msgPtr->strLen[i];
+        }
+    }
+
+    if (STRING_ABSENT == msgPtr->strLen[string])
+    {
+        return LE_FAULT;
+    }
+
+    if (msgPtr->strLen[string] >= bufSize)
+    {
+        return LE_OVERFLOW;
+    }
+
+    memcpy(bufPtr, strPtr, msgPtr->strLen[string]);
+    bufPtr[msgPtr->strLen[string]] = '\0';
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the data of a message.
+ *
+ * @return
+ *  - LE_OK       Function succeeded.
+ *  - LE_OVERFLOW The data doesn't fit in the buffer.
+ *  - LE_FAULT    The message or its data doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_GetData
+(
+    uint32_t msgId,         ///< [IN] Message identifier.
+    uint8_t* bufPtr,        ///< [OUT] The data.
+    size_t*  bufSizePtr     ///< [INOUT] Size of bufPtr, then number of bytes of data.
+)
+{
+    uint8_t payload[MAX_RECORD_BYTES];
+    const MsgPayload_t* msgPtr = (const MsgPayload_t*)payload;
+    const uint8_t* dataPtr = payload + sizeof(MsgPayload_t);
+    int i;
+
+    if (ReadMsgPayload(msgId, payload) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    if (DATA_ABSENT == msgPtr->dataLen)
+    {
+        return LE_FAULT;
+    }
+
+    if (msgPtr->dataLen > *bufSizePtr)
+    {
+        return LE_OVERFLOW;
+    }
+
+    for (i = 0; i < MSGSTORE_NUM_STRINGS; i++)
+    {
+        if (msgPtr->strLen[i] != STRING_ABSENT)
+        {
+            dataPtr += msgPtr->strLen[i];
+        }
+    }
+
+    memcpy(bufPtr, dataPtr, msgPtr->dataLen);
+    *bufSizePtr = msgPtr->dataLen;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message is unread in a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgStore_IsUnread
+(
+    uint32_t msgId,     ///< [IN] Message identifier.
+    size_t   mbox       ///< [IN] Message box index.
+)
+{
+    MsgEntry_t* entryPtr = GetEntry(msgId);
+
+    return (entryPtr && (mbox < NumMbox) && (entryPtr->unreadMask & (1U << mbox)));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mark a message as read or unread in a message box.
+ *
+ * @return
+ *  - LE_OK        Function succeeded.
+ *  - LE_NOT_FOUND The message isn't in the message box.
+ *  - LE_FAULT     The new status couldn't be written, it is unchanged.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_SetUnread
+(
+    uint32_t msgId,     ///< [IN] Message identifier.
+    size_t   mbox,      ///< [IN] Message box index.
+    bool     isUnread   ///< [IN] New status.
+)
+{
+    MsgEntry_t* entryPtr = GetEntry(msgId);
+
+    if ((NULL == entryPtr) || (mbox >= NumMbox) || !(entryPtr->mboxMask & (1U << mbox)))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    uint32_t unreadMask = isUnread ? (entryPtr->unreadMask | (1U << mbox))
+                                   : (entryPtr->unreadMask & ~(1U << mbox));
+
+    if (UpdateState(entryPtr, entryPtr->mboxMask, unreadMask) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+    CompactIfNeeded();
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a message from a message box. The message is deleted once it is in no message box.
+ *
+ * @return
+ *  - LE_OK        Function succeeded.
+ *  - LE_NOT_FOUND The message isn't in the message box.
+ *  - LE_FAULT     The removal couldn't be written, the message is kept.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_Delete
+(
+    uint32_t msgId,     ///< [IN] Message identifier.
+    size_t   mbox       ///< [IN] Message box index.
+)
+{
+    MsgEntry_t* entryPtr = GetEntry(msgId);
+
+    if ((NULL == entryPtr) || (mbox >= NumMbox) || !(entryPtr->mboxMask & (1U << mbox)))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if (UpdateState(entryPtr, entryPtr->mboxMask & ~(1U << mbox), entryPtr->unreadMask) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+    CompactIfNeeded();
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the first message of a message box.
+ *
+ * @return The message identifier, or 0 if the message box is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t msgStore_GetFirst
+(
+    size_t             mbox,        ///< [IN] Message box index.
+    msgStore_Cursor_t* cursorPtr    ///< [OUT] Browsing cursor.
+)
+{
+    cursorPtr->lastMsgId = 0;
+    cursorPtr->maxMsgId = 0;
+
+    if ((mbox >= NumMbox) || le_dls_IsEmpty(&Mboxes[mbox].list))
+    {
+        return 0;
+    }
+
+    cursorPtr->lastMsgId = EntryFromMboxLink(le_dls_Peek(&Mboxes[mbox].list), mbox)->msgId;
+    cursorPtr->maxMsgId = EntryFromMboxLink(le_dls_PeekTail(&Mboxes[mbox].list), mbox)->msgId;
+
+    return cursorPtr->lastMsgId;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next message of a message box. Messages received after msgStore_GetFirst() was called
+ * are not returned.
+ *
+ * @return The message identifier, or 0 if there are no more messages.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t msgStore_GetNext
+(
+    size_t             mbox,        ///< [IN] Message box index.
+    msgStore_Cursor_t* cursorPtr    ///< [INOUT] Browsing cursor.
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    if ((mbox >= NumMbox) || (0 == cursorPtr->lastMsgId))
+    {
+        return 0;
+    }
+
+    if (msgStore_IsInMbox(cursorPtr->lastMsgId, mbox))
+    {
+        linkPtr = le_dls_PeekNext(&Mboxes[mbox].list,
+                                  &GetEntry(cursorPtr->lastMsgId)->mboxLink[mbox]);
+    }
+    else
+    {
+        // The last message was removed from the message box, find the one following it.
+        linkPtr = le_dls_Peek(&Mboxes[mbox].list);
+        while (linkPtr && (EntryFromMboxLink(linkPtr, mbox)->msgId <= cursorPtr->lastMsgId))
+        {
+            linkPtr = le_dls_PeekNext(&Mboxes[mbox].list, linkPtr);
+        }
+    }
+
+    if (   (NULL == linkPtr)
+        || (EntryFromMboxLink(linkPtr, mbox)->msgId > cursorPtr->maxMsgId) )
+    {
+        return 0;
+    }
+
+    cursorPtr->lastMsgId = EntryFromMboxLink(linkPtr, mbox)->msgId;
+
+    return cursorPtr->lastMsgId;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rewrite the log with only the live messages. This is done automatically when enough of the log
+ * is made of obsolete records.
+ *
+ * @return
+ *  - LE_OK    Function succeeded.
+ *  - LE_FAULT The log couldn't be rewritten, the current one is kept.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_Compact
+(
+    void
+)
+{
+    static uint8_t buf[COMPACT_BUFFER_BYTES];
+    size_t bufLen;
+    le_dls_Link_t* linkPtr;
+    bool ok = true;
+
+    if (-1 == LogFd)
+    {
+        return LE_FAULT;
+    }
+
+    int fd = open(TmpPath, O_RDWR | O_APPEND | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (-1 == fd)
+    {
+        LE_ERROR("Failed to create %s: %m", TmpPath);
+        return LE_FAULT;
+    }
+
+    // The counter record keeps the message identifiers increasing even if the log is emptied.
+    RecordHeader_t* hdrPtr = (RecordHeader_t*)buf;
+    memset(hdrPtr, 0, sizeof(*hdrPtr));
+    hdrPtr->magic = RECORD_MAGIC;
+    hdrPtr->type = RECORD_COUNTER;
+    hdrPtr->msgId = NextMsgId;
+    hdrPtr->crc = ComputeRecordCrc(buf);
+    bufLen = sizeof(RecordHeader_t);
+
+    for (linkPtr = le_dls_Peek(&MsgList);
+         ok && linkPtr;
+         linkPtr = le_dls_PeekNext(&MsgList, linkPtr))
+    {
+        MsgEntry_t* entryPtr = CONTAINER_OF(linkPtr, MsgEntry_t, link);
+
+        if ((bufLen + entryPtr->recordLen) > COMPACT_BUFFER_BYTES)
+        {
+            ok = WriteAll(fd, buf, bufLen);
+            bufLen = 0;
+        }
+
+        hdrPtr = (RecordHeader_t*)(buf + bufLen);
+        if (pread(LogFd, hdrPtr, entryPtr->recordLen, entryPtr->offset) != entryPtr->recordLen)
+        {
+            ok = false;
+            break;
+        }
+
+        // Fold the current state of the message into its record.
+        hdrPtr->mboxMask = entryPtr->mboxMask;
+        hdrPtr->unreadMask = entryPtr->unreadMask;
+        hdrPtr->crc = ComputeRecordCrc((uint8_t*)hdrPtr);
+        bufLen += entryPtr->recordLen;
+    }
+
+    if (ok)
+    {
+        ok = WriteAll(fd, buf, bufLen) && (fdatasync(fd) == 0);
+    }
+
+    if ((!ok) || (rename(TmpPath, LogPath) == -1))
+    {
+        LE_ERROR("Failed to compact %s: %m", LogPath);
+        close(fd);
+        unlink(TmpPath);
+        return LE_FAULT;
+    }
+
+    SyncLogDirectory();
+
+    close(LogFd);
+    LogFd = fd;
+
+    // The records were written in the order of the list.
+    LogSize = sizeof(RecordHeader_t);
+    for (linkPtr = le_dls_Peek(&MsgList); linkPtr; linkPtr = le_dls_PeekNext(&MsgList, linkPtr))
+    {
+        MsgEntry_t* entryPtr = CONTAINER_OF(linkPtr, MsgEntry_t, link);
+
+        entryPtr->offset = LogSize;
+        LogSize += entryPtr->recordLen;
+    }
+
+    LE_DEBUG("Compacted %s, %d bytes", LogPath, (int)LogSize);
+
+    return LE_OK;
+}
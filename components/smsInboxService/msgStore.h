@@ -0,0 +1,274 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  SMS Inbox Server
+ *
+ * Declaration of the message store: the messages of all the message boxes, kept in a single
+ * append-only record log with an in-memory index.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef MSGSTORE_H_INCLUDE_GUARD
+#define MSGSTORE_H_INCLUDE_GUARD
+
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of message boxes (the message boxes are identified by a bit in a 32-bit mask).
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSGSTORE_MAX_MBOX   32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a message's data (text, binary or PDU).
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSGSTORE_MAX_DATA_BYTES 256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Strings stored with a message.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    MSGSTORE_IMSI,          ///< IMSI of the receiver SIM.
+    MSGSTORE_SENDER_TEL,    ///< Sender telephone number.
+    MSGSTORE_TIMESTAMP,     ///< Message time stamp.
+    MSGSTORE_NUM_STRINGS
+}
+msgStore_String_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message to be added to the store.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int32_t         format;                         ///< Message format (le_sms_Format_t).
+    uint32_t        msgLen;                         ///< Message length.
+    const char*     strPtr[MSGSTORE_NUM_STRINGS];   ///< Strings, NULL when not available.
+    const uint8_t*  dataPtr;                        ///< Message data, NULL when not available.
+    size_t          dataLen;                        ///< Number of bytes in dataPtr.
+}
+msgStore_Msg_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message box browsing cursor.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t lastMsgId;     ///< Last message identifier returned.
+    uint32_t maxMsgId;      ///< Last message identifier in the message box when browsing started.
+}
+msgStore_Cursor_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the message store, replaying its log to rebuild the index. A record torn by a crash at the
+ * end of the log is discarded.
+ *
+ * @return
+ *  - LE_OK            The store is open.
+ *  - LE_BAD_PARAMETER Too many message boxes.
+ *  - LE_FAULT         The log can't be opened.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_Init
+(
+    const char*     pathPtr,        ///< [IN] Path of the log file.
+    size_t          numMbox,        ///< [IN] Number of message boxes.
+    const uint32_t* mboxSizePtr     ///< [IN] Maximum number of messages of each message box.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the message store and free its index.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgStore_Close
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message to the store. The record is synced to the storage before the function returns.
+ *
+ * When a message box is full, its oldest message is removed from it.
+ *
+ * @return The message identifier, or 0 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t msgStore_AddMsg
+(
+    uint32_t                msgId,      ///< [IN] Message identifier, 0 to allocate a new one. If
+                                        ///<      the message already exists, nothing is done.
+    const msgStore_Msg_t*   msgPtr,     ///< [IN] The message.
+    uint32_t                mboxMask,   ///< [IN] Message boxes the message is added to.
+    uint32_t                unreadMask  ///< [IN] Message boxes where the message is unread.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message belongs to a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgStore_IsInMbox
+(
+    uint32_t msgId,     ///< [IN] Message identifier.
+    size_t   mbox       ///< [IN] Message box index.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the format and the length of a message.
+ *
+ * @return
+ *  - LE_OK        Function succeeded.
+ *  - LE_NOT_FOUND The message doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_GetInfo
+(
+    uint32_t  msgId,        ///< [IN] Message identifier.
+    int32_t*  formatPtr,    ///< [OUT] Message format.
+    uint32_t* msgLenPtr     ///< [OUT] Message length.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get one of the strings of a message.
+ *
+ * @return
+ *  - LE_OK       Function succeeded.
+ *  - LE_OVERFLOW The string doesn't fit in the buffer.
+ *  - LE_FAULT    The message or the string doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_GetString
+(
+    uint32_t          msgId,    ///< [IN] Message identifier.
+    msgStore_String_t string,   ///< [IN] The string to get.
+    char*             bufPtr,   ///< [OUT] The string.
+    size_t            bufSize   ///< [IN] Size of bufPtr.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the data of a message.
+ *
+ * @return
+ *  - LE_OK       Function succeeded.
+ *  - LE_OVERFLOW The data doesn't fit in the buffer.
+ *  - LE_FAULT    The message or its data doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_GetData
+(
+    uint32_t msgId,         ///< [IN] Message identifier.
+    uint8_t* bufPtr,        ///< [OUT] The data.
+    size_t*  bufSizePtr     ///< [INOUT] Size of bufPtr, then number of bytes of data.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message is unread in a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgStore_IsUnread
+(
+    uint32_t msgId,     ///< [IN] Message identifier.
+    size_t   mbox       ///< [IN] Message box index.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mark a message as read or unread in a message box.
+ *
+ * @return
+ *  - LE_OK        Function succeeded.
+ *  - LE_NOT_FOUND The message isn't in the message box.
+ *  - LE_FAULT     The new status couldn't be written, it is unchanged.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_SetUnread
+(
+    uint32_t msgId,     ///< [IN] Message identifier.
+    size_t   mbox,      ///< [IN] Message box index.
+    bool     isUnread   ///< [IN] New status.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a message from a message box. The message is deleted once it is in no message box.
+ *
+ * @return
+ *  - LE_OK        Function succeeded.
+ *  - LE_NOT_FOUND The message isn't in the message box.
+ *  - LE_FAULT     The removal couldn't be written, the message is kept.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_Delete
+(
+    uint32_t msgId,     ///< [IN] Message identifier.
+    size_t   mbox       ///< [IN] Message box index.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the first message of a message box.
+ *
+ * @return The message identifier, or 0 if the message box is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t msgStore_GetFirst
+(
+    size_t             mbox,        ///< [IN] Message box index.
+    msgStore_Cursor_t* cursorPtr    ///< [OUT] Browsing cursor.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next message of a message box. Messages received after msgStore_GetFirst() was called
+ * are not returned.
+ *
+ * @return The message identifier, or 0 if there are no more messages.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t msgStore_GetNext
+(
+    size_t             mbox,        ///< [IN] Message box index.
+    msgStore_Cursor_t* cursorPtr    ///< [INOUT] Browsing cursor.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rewrite the log with only the live messages. This is done automatically when enough of the log
+ * is made of obsolete records.
+ *
+ * @return
+ *  - LE_OK    Function succeeded.
+ *  - LE_FAULT The log couldn't be rewritten, the current one is kept.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgStore_Compact
+(
+    void
+);
+
+
+#endif // MSGSTORE_H_INCLUDE_GUARD
@@ -2,18 +2,16 @@
 /**
  *  SMS Inbox Server
  *
- * When the service is activated, or when a SMS is received, the SMS is copied from the SIM to a
- * specific folder (SMSINBOX_PATH/MSG_PATH).
+ * When the service is activated, or when a SMS is received, the SMS is copied from the SIM to the
+ * message store (see msgStore.c): a single append-only log in SMSINBOX_PATH holding the data of
+ * each SMS (imsi, SMS format, message length, text/binary/pdu, sender telephone number,
+ * timestamp) and, for each application's message box, whether the message belongs to it and
+ * whether it was read. The message boxes are indexed in memory, so browsing them doesn't touch the
+ * file system.
  *
- * Each SMS is copied into a dedicated file (named with a unique message identifier). The data
- * are stored using the Jannsson representation: Each data (imsi, SMS format, message length,
- * text/pdu, sender telephone number, timestamp, read/unread) are recorded with a key to retrieve
- * each value.
- *
- * Each application using the SMS Inbox Server possesses a configuration file in
- * SMSINBOX_PATH/CONF_PATH directory (also encoding using Jansson format): this file is used to
- * store the message identifier contained in the application mailbox. It is updated each time is new
- * SMS is received.
+ * Former versions stored each SMS in a dedicated Jansson file, and the message identifiers of each
+ * application's message box in a Jansson configuration file. These files are migrated to the
+ * message store at start-up.
  *
  *  Copyright (C) Sierra Wireless Inc.
  */
@@ -23,6 +21,7 @@
 #include "interfaces.h"
 #include "mdmCfgEntries.h"
 #include "le_smsInbox.h"
+#include "msgStore.h"
 
 #include "le_print.h"
 #include "le_hex.h"
@@ -43,6 +42,13 @@
 #define MSG_PATH "msg/"
 #define CONF_PATH "cfg/"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message store log file name.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_FILE "inbox.log"
+
 //--------------------------------------------------------------------------------------------------
 /**
  * File extension definition.
@@ -113,49 +119,6 @@
 //--------------------------------------------------------------------------------------------------
 typedef uint32_t MessageId_t;
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Browsing structure.
- *
- */
-//--------------------------------------------------------------------------------------------------
-typedef struct
-{
-    json_t* jsonObjPtr;
-    json_t* jsonArrayPtr;
-    uint32_t currentMessageIndex;
-    uint32_t maxIndex;
-}
-BrowseCtx_t;
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Entry description structure.
- *
- */
-//--------------------------------------------------------------------------------------------------
-typedef struct
-{
-    enum
-    {
-        DESC_INT,
-        DESC_STRING,
-        DESC_BOOL
-    }                               type;       ///< Union type (string or integer
-    union
-    {
-        struct
-        {
-            char*   strPtr;                     ///< String
-            size_t  lenStr;                     ///< Length of the string
-        }                  str;                 ///< Value for string
-        uint32_t           val;                 ///< Value for integer
-        bool               boolVal;             ///< Boolean value
-    }                               uVal;       ///< Union type
-}
-EntryDesc_t;
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * message box object structure.
@@ -180,7 +143,7 @@ MboxCtx_t;
 typedef struct
 {
     MboxCtx_t *    mboxCtxPtr; ///< message box object
-    BrowseCtx_t    browseCtx;     ///< browsing context (for GetFirst/GetNext)
+    msgStore_Cursor_t browseCtx;  ///< browsing context (for GetFirst/GetNext)
 }
 MboxSession_t;
 
@@ -286,136 +249,6 @@ static uint32_t MaxInboxSize;
 //--------------------------------------------------------------------------------------------------
 static char SimImsi[LE_SIM_IMSI_BYTES];
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Next message Identifier
- *
- */
-//--------------------------------------------------------------------------------------------------
-static MessageId_t NextMessageId = 1;
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Add a boolean value of a key in a Jason object
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t AddBooleanKeyInJsonObject
-(
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    bool value          ///<[IN] Value to be added
-)
-{
-    json_t *jsonBoolPtr;
-    int ret = -1;
-
-    if ( value == true )
-    {
-        jsonBoolPtr = json_true();
-    }
-    else
-    {
-        jsonBoolPtr = json_false();
-    }
-
-    if (jsonBoolPtr)
-    {
-        ret = json_object_set_new(jsonObjPtr, key, jsonBoolPtr);
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
-
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
-}
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Add an integer value of a key in a Jason object
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t AddIntegerKeyInJsonObject
-(
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    int  value          ///<[IN] Value to be added
-)
-{
-    json_t *jsonIntPtr = json_integer(value);
-    int ret = -1;
-
-    if (jsonIntPtr)
-    {
-        if (json_is_array(jsonObjPtr))
-        {
-            ret = json_array_append_new(jsonObjPtr, jsonIntPtr);
-        }
-        else
-        {
-            ret = json_object_set_new(jsonObjPtr, key, jsonIntPtr);
-        }
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
-
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Add a string value of a key in a Jason object
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t AddStringKeyInJsonObject
-(
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    char* string        ///<[IN] String to be added
-)
-{
-    json_t * jsonStrPtr = json_string(string);
-    int ret = -1;
-
-    if (jsonStrPtr)
-    {
-        ret = json_object_set_new(jsonObjPtr, key, jsonStrPtr);
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
-
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the SMSInbox directory path length
@@ -480,867 +313,457 @@ static void GetSMSInboxConfigPath
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Modify Json object
+ * Get the index of a message box in the message store
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ModifyJsonObj
+static size_t GetMboxIndex
 (
-    json_t* jsonObjPtr,         ///<[IN] Json object (root object)
-    json_t* jsonValPtr,         ///<[IN] Json value to be modified
-    char*   key,                ///<[IN] Key to modify
-    EntryDesc_t * modifPtr      ///<[IN] Requested modification
+    MboxCtx_t* mboxCtxPtr   ///<[IN] message box
 )
 {
-    int res = 0;
-
-    if (jsonValPtr == NULL)
-    {
-        return LE_FAULT;
-    }
-
-    switch (modifPtr->type)
-    {
-        case DESC_STRING:
-            // check the type
-            if (json_is_string(jsonValPtr) == false)
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if ( res == 0 )
-            {
-                res = json_string_set(jsonValPtr, modifPtr->uVal.str.strPtr);
-            }
-        break;
-        case DESC_INT:
-            // check the type
-            if (json_is_integer(jsonValPtr) == false )
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if ( res == 0 )
-            {
-                res = json_integer_set(jsonValPtr, modifPtr->uVal.val);
-            }
-        break;
-        case DESC_BOOL:
-            // check the type
-            if ( (json_is_true(jsonValPtr) != true) && (json_is_false(jsonValPtr) != true) )
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if (( res == 0 ) &&
-                (AddBooleanKeyInJsonObject(jsonObjPtr, key, modifPtr->uVal.boolVal) != LE_OK))
-            {
-                res = -1;
-            }
-        break;
-        default:
-            res = -1;
-        break;
-    }
-
-    if (res < 0)
-    {
-        LE_ERROR(("Update error %d"), modifPtr->type);
-        return LE_FAULT;
-    }
-    else
-    {
-        return LE_OK;
-    }
-
+    return mboxCtxPtr - Apps;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Modify message file
+ * Get the mask of all the message boxes
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ModifyMsgEntry
+static uint32_t GetAllMboxMask
 (
-    MessageId_t messageId,      ///<[IN] Message identifier to be modified
-    char* keyPtr[],              ///<[IN] Key to modify
-    uint8_t nbKey,              ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * modifPtr      ///<[IN] Requested modification
+    void
 )
 {
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    json_error_t error;
-    le_result_t res;
-    int indexKey = -1;
-
-    GetSMSInboxMessagePath(messageId, path, pathLen);
-
-    json_t* jsonRootPtr = json_load_file(path, 0, &error);
-
-    if ( jsonRootPtr == NULL )
-    {
-        LE_ERROR("json decoder error %s", error.text);
-        return LE_FAULT;
-    }
-
-    json_t* jsonValPtr = jsonRootPtr;
-    json_t* jsonSubObjPtr = jsonRootPtr;
-
-    while ( ( json_is_object(jsonValPtr) == true ) && ( nbKey > indexKey ) )
-    {
-        indexKey++;
-        jsonSubObjPtr = jsonValPtr;
-        jsonValPtr = json_object_get(jsonSubObjPtr, keyPtr[indexKey]);
-    }
-
-    if ( !jsonValPtr )
-    {
-        LE_ERROR("Unable to get the object %s", keyPtr[indexKey]);
-        res = LE_FAULT;
-    }
-    else
-    {
-        res = ModifyJsonObj(jsonSubObjPtr, jsonValPtr, keyPtr[indexKey], modifPtr);
-    }
-
+    uint32_t mask = 0;
+    int i;
 
-    if ( res == LE_OK )
+    for (i=0; i < le_smsInbox_NbMbx; i++)
     {
-        if ( json_dump_file(jsonRootPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
+        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
         {
-            LE_ERROR("json error");
-            res = LE_FAULT;
+            mask |= (1U << i);
         }
     }
-    else
+
+    return mask;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message belongs to a message box
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckMessageIdInMbox
+(
+    MboxCtx_t* mboxCtxPtr,      ///<[IN] message box
+    MessageId_t messageId       ///<[IN] Message identifier
+)
+{
+    if (msgStore_IsInMbox(messageId, GetMboxIndex(mboxCtxPtr)))
     {
-        LE_ERROR("Something was wrong in ModifyJsonObj");
+        return LE_OK;
     }
 
-    json_decref(jsonRootPtr);
-
-    return res;
+    LE_ERROR("Bad msg id or mbox name");
+    return LE_FAULT;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read Json object
+ * Add a new SMS to the message store, unread in all the message boxes
  *
+ * @return The message identifier, 0 on failure
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ReadJsonObj
+static MessageId_t AddMsgEntry
 (
-    json_t* jsonValPtr,         ///<[IN] Json value to be read
-    char* keyPtr[],             ///<[IN] Key to read
-    uint8_t nbKey,              ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * decodePtr     ///<[OUT] Decoding result
+    le_sms_MsgRef_t msgRef  ///<[IN] SMS to be stored
 )
 {
-    le_result_t res = LE_OK;
+    msgStore_Msg_t msg;
+    char tel[LE_MDMDEFS_PHONE_NUM_MAX_BYTES];
+    char timeStamp[LE_SMS_TIMESTAMP_MAX_BYTES];
+    uint8_t data[MSGSTORE_MAX_DATA_BYTES];
+    size_t len;
+    le_result_t result;
 
-    if ( jsonValPtr == NULL )
-    {
-        LE_ERROR("No information");
-        return LE_FAULT;
-    }
+    memset(&msg, 0, sizeof(msg));
 
-    switch json_typeof(jsonValPtr)
+    msg.format = le_sms_GetFormat(msgRef);
+    msg.strPtr[MSGSTORE_IMSI] = SimImsi;
+
+    switch ( msg.format )
     {
-        case JSON_STRING:
+        case LE_SMS_FORMAT_TEXT:
+        case LE_SMS_FORMAT_BINARY:
         {
-            if ( decodePtr->type != DESC_STRING )
+            memset(tel,0,LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
+
+            // Add phone number
+            result = le_sms_GetSenderTel(msgRef, tel, LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
+
+            if (result != LE_OK)
             {
-                res = LE_FAULT;
-                LE_ERROR("Bad format");
+                LE_ERROR("Unable to get the tel number %d", result);
             }
-
-            if (res == LE_OK)
+            else
             {
-                const char* strPtr = json_string_value((const json_t *)jsonValPtr);
-
-                if ( strlen(strPtr) >= decodePtr->uVal.str.lenStr )
-                {
-                    LE_ERROR("String too long");
-                    res = LE_OVERFLOW;
-                }
-                else
-                {
-                    strcpy(decodePtr->uVal.str.strPtr, strPtr);
-                    decodePtr->uVal.str.lenStr = strlen(strPtr);
-                }
+                LE_DEBUG("tel num: %s", tel);
+                msg.strPtr[MSGSTORE_SENDER_TEL] = tel;
             }
-        }
-        break;
-        case JSON_INTEGER:
-        {
-            if ( decodePtr->type != DESC_INT )
+
+            // Add timestamp
+            result = le_sms_GetTimeStamp (msgRef, timeStamp, LE_SMS_TIMESTAMP_MAX_BYTES);
+
+            if (result != LE_OK)
             {
-                LE_ERROR("Bad format");
-                res = LE_FAULT;
+                LE_ERROR("Unable to get the timestamp %d", result);
             }
             else
             {
-                decodePtr->uVal.val = json_integer_value((const json_t *)jsonValPtr);
+                LE_DEBUG("timestamp: %s", timeStamp);
+                msg.strPtr[MSGSTORE_TIMESTAMP] = timeStamp;
             }
-        }
-        break;
-        case JSON_TRUE:
-        case JSON_FALSE:
-        {
-            if ( decodePtr->type != DESC_BOOL )
+
+            msg.msgLen = le_sms_GetUserdataLen(msgRef);
+
+            // Add a character for last '\0'
+            len = msg.msgLen + 1;
+            if (len > sizeof(data))
             {
-                LE_ERROR("Bad format");
-                res = LE_FAULT;
+                len = sizeof(data);
+            }
+
+            if (msg.format == LE_SMS_FORMAT_TEXT)
+            {
+                // Get text
+                result = le_sms_GetText(msgRef, (char*) data, len);
             }
             else
             {
-                decodePtr->uVal.boolVal = json_is_true((const json_t *)jsonValPtr);
+                // Get binary
+                result = le_sms_GetBinary(msgRef, data, &len);
             }
-        }
-        break;
-        case JSON_OBJECT:
-        {
-            // if key-value is an object, read the next key
-            if (nbKey >= 1)
+
+            if (result != LE_OK)
             {
-                json_t* jsonSubValPtr = json_object_get(jsonValPtr, keyPtr[0]);
-
-                if ( jsonSubValPtr )
-                {
-                    res = ReadJsonObj(jsonSubValPtr, &keyPtr[1], nbKey-1,  decodePtr );
-                }
-                else
-                {
-                    res = LE_FAULT;
-                }
+                LE_ERROR("Unable to get payload %d", result);
+                msg.msgLen = 0;
             }
             else
             {
-                res = LE_FAULT;
+                msg.dataPtr = data;
+                msg.dataLen = len;
             }
         }
         break;
-        case JSON_ARRAY:
-        case JSON_REAL:
-        case JSON_NULL:
-        default:
-            res = LE_FAULT;
-        break;
-    }
-
-    return res;
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Read Application's config file
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t GetMsgListFromMbox
-(
-    char* pathPtr,              ///<[IN] Application's config file path
-    json_t **jsonRootObjPtr,    ///<[OUT] json root object
-    json_t **jsonArrayPtr       ///<[OUT] messages in box list
-)
-{
-    json_error_t error;
-    *jsonRootObjPtr = json_load_file(pathPtr, 0, &error);
-
-    if ( !(*jsonRootObjPtr) )
-    {
-        // File doesn't exist, create objects
-        *jsonRootObjPtr = json_object();
-
-        if ( !(*jsonRootObjPtr) )
-        {
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
-    }
-
-    *jsonArrayPtr = json_object_get(*jsonRootObjPtr, JSON_MSGINBOX);
-
-    if ( !(*jsonArrayPtr) )
-    {
-        // Array doesn't exist, create it
-        *jsonArrayPtr = json_array();
-
-        if (!(*jsonArrayPtr))
-        {
-            json_decref(*jsonRootObjPtr);
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
-
-        if ( json_object_set(*jsonRootObjPtr, JSON_MSGINBOX, *jsonArrayPtr) < 0 )
-        {
-            json_decref(*jsonRootObjPtr);
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
-    }
-
-    return LE_OK;
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Remove a message from the application's cfg file
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t DeleteMsgInAppCfg
-(
-    char *appNamePtr,               ///<[IN] application name
-    MessageId_t deleteMessageId     ///<[IN] message to delete
-)
-{
-    uint32_t pathLen = GetSMSInboxConfigPathLen(appNamePtr);
-    char path[pathLen];
-    memset(path,0,pathLen);
-    GetSMSInboxConfigPath(appNamePtr, path, pathLen);
-    json_t *jsonObjPtr;
-    json_t *jsonArrayPtr;
 
-    if (GetMsgListFromMbox(path, &jsonObjPtr, &jsonArrayPtr) != LE_OK)
-    {
-        return LE_FAULT;
-    }
-
-    int i;
-    MessageId_t messageId;
-
-    for (i=0; i < json_array_size(jsonArrayPtr); i++)
-    {
-        json_t * jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
-
-        if (jsonIntegerPtr)
+        case LE_SMS_FORMAT_PDU:
         {
-            messageId = json_integer_value(jsonIntegerPtr);
+            msg.msgLen = le_sms_GetPDULen(msgRef);
 
-            if (messageId == deleteMessageId)
+            // Add a character for last '\0'
+            len = msg.msgLen + 1;
+            if (len > sizeof(data))
             {
-                LE_DEBUG("Remove %d", (int) messageId);
-                json_array_remove(jsonArrayPtr, i);
+                len = sizeof(data);
             }
-        }
-        else
-        {
-            LE_ERROR("Json error");
-        }
-    }
 
-    le_result_t res = LE_OK;
-    if ( json_dump_file(jsonObjPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
-    {
-        res = LE_FAULT;
-    }
-
-    json_decref(jsonObjPtr);
-
-    return res;
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Check if a message belongs to a message box
- *
- */
-//--------------------------------------------------------------------------------------------------
-
-le_result_t CheckMessageIdInMbox
-(
-    char* mboxName,
-    MessageId_t messageId
-)
-{
-    json_t *jsonRootObjPtr;
-    json_t *jsonArrayPtr;
-    uint32_t pathLen = GetSMSInboxConfigPathLen(mboxName);
-    char path[pathLen];
-    GetSMSInboxConfigPath(mboxName, path, pathLen);
-
-    if ( GetMsgListFromMbox(path, &jsonRootObjPtr, &jsonArrayPtr) != LE_OK )
-    {
-        LE_ERROR("Error in GetMsgListFromMbox");
-        return LE_FAULT;
-    }
-
-    int i = 0;
-
-    while (i < json_array_size(jsonArrayPtr))
-    {
-        json_t * jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
-        MessageId_t msgId = 0;
-
-        if (jsonIntegerPtr)
-        {
-            msgId = json_integer_value(jsonIntegerPtr);
-        }
-        else
-        {
-            LE_ERROR("json error");
-            json_decref(jsonRootObjPtr);
-            return LE_FAULT;
-        }
+            // Add pdu
+            result = le_sms_GetPDU(msgRef, data, &len);
 
-        if (msgId == messageId)
-        {
-            json_decref(jsonRootObjPtr);
-            return LE_OK;
+            if (result != LE_OK)
+            {
+                LE_ERROR("Unable to get pdu %d", result);
+                msg.msgLen = 0;
+            }
+            else
+            {
+                msg.dataPtr = data;
+                msg.dataLen = len;
+            }
         }
-
-        i++;
-    }
-
-    LE_ERROR("Bad msg id or mbox name");
-    json_decref(jsonRootObjPtr);
-    return LE_FAULT;
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Decode message file
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t DecodeMsgEntry
-(
-    char* mboxName,                      ///<[IN] mbox name
-    MessageId_t messageId,               ///<[IN] Message identifier to decode
-    char* keyPtr[],                      ///<[IN] Key to retrieve
-    uint8_t nbKey,                       ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * decodePtr              ///<[IN/OUT] Decoding result
-)
-{
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    json_error_t error;
-    le_result_t res = LE_OK;
-
-    GetSMSInboxMessagePath(messageId, path, pathLen);
-
-    json_t* jsonRootPtr = json_load_file(path, JSON_REJECT_DUPLICATES, &error);
-
-    if ( jsonRootPtr == NULL )
-    {
-        LE_ERROR("json decoder error %s", error.text);
-        DeleteMsgInAppCfg(mboxName, messageId);
-        return LE_FAULT;
+        break;
+        case LE_SMS_FORMAT_UNKNOWN:
+        default:
+            LE_ERROR("Bad format %d", msg.format);
     }
 
-    res = ReadJsonObj(jsonRootPtr, keyPtr, nbKey, decodePtr);
+    // Unread by default for all applications
+    MessageId_t messageId = msgStore_AddMsg(0, &msg, GetAllMboxMask(), GetAllMboxMask());
 
-    json_decref(jsonRootPtr);
+    LE_DEBUG("New entry: %08x", (int) messageId);
 
-    return res;
+    return messageId;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Check if an application requested the deletion of a message
- *
- */
-//--------------------------------------------------------------------------------------------------
-static bool IsDeleted
-(
-    MessageId_t messageId,  ///<[IN] Message identifier
-    char* appNamePtr        ///<[IN] Application name
-)
-{
-    EntryDesc_t decode;
-    decode.type = DESC_BOOL;
-    char* key[2] = {JSON_ISDELETED, appNamePtr};
-
-    if (DecodeMsgEntry(appNamePtr, messageId, key, 2, &decode) == LE_OK)
-    {
-        return decode.uVal.boolVal;
-    }
-    else
-    {
-        // if error, delete the message
-        return true;
-    }
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Perform the deleteion
+ * Convert the file name string in hexa
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void PerformDeletion
+static MessageId_t GetMessageId
 (
-    MessageId_t messageId   ///<[IN] Message identifier
+    char* fileName  ///<[IN] file name to be converted
 )
 {
-    int i;
-    bool deleted = true;
-
-    for (i=0; i < MAX_APPS; i++)
-    {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
-        {
-            deleted &= IsDeleted(messageId, Apps[i].namePtr);
-        }
-    }
-
-    // All applications mark this message to be delteted => erase physically the message
-    if (deleted)
-    {
-        uint16_t pathLen = GetSMSInboxMessagePathLen();
-        char path[pathLen];
-        memset(path,0,pathLen);
-
-        GetSMSInboxMessagePath(messageId, path, pathLen);
-
-        unlink(path);
-    }
+    char *savePtr;
+    char *str = strtok_r(fileName,".", &savePtr);
+    return le_hex_HexaToInteger(str);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a message in the application's cfg file
+ * Check if a message identifier is in the message list of an application's cfg file
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddMsgInAppCfg
+static bool IsInJsonMsgList
 (
-    MboxCtx_t* appsPtr,         ///<[IN] application config
-    MessageId_t messageId     ///<[IN] message to add
+    json_t* jsonArrayPtr,       ///<[IN] messages in box list, may be NULL
+    MessageId_t messageId       ///<[IN] Message identifier
 )
 {
-    uint32_t pathLen = GetSMSInboxConfigPathLen(appsPtr->namePtr);
-    char path[pathLen];
-    GetSMSInboxConfigPath(appsPtr->namePtr, path, pathLen);
-    json_t* jsonMsgIdPtr = NULL;
-    json_t* jsonPtr;
-    json_t* jsonArrayPtr;
-
-    if ( GetMsgListFromMbox (path, &jsonPtr, &jsonArrayPtr) != LE_OK )
-    {
-        return LE_FAULT;
-    }
+    size_t i;
 
-    if ( json_array_size(jsonArrayPtr) == appsPtr->inboxSize )
+    for (i = 0; i < json_array_size(jsonArrayPtr); i++)
     {
-        // delete older entry
-        jsonMsgIdPtr = json_array_get(jsonArrayPtr, 0);
-        MessageId_t messageId = 0;
-
-        if (jsonMsgIdPtr)
-        {
-            messageId = json_integer_value(jsonMsgIdPtr);
-        }
-
-        if (messageId != 0)
-        {
-            json_array_remove(jsonArrayPtr, 0);
-
-            EntryDesc_t modif;
-            modif.type = DESC_BOOL;
-            modif.uVal.boolVal = true;
-            char* key[2]={JSON_ISDELETED, appsPtr->namePtr};
-
-            if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
-            {
-                LE_ERROR("Can't modify entry %08x", (int) messageId);
-            }
-
-            PerformDeletion(messageId);
-        }
-        else
+        if (json_integer_value(json_array_get(jsonArrayPtr, i)) == messageId)
         {
-            json_decref(jsonPtr);
-            LE_ERROR("json error");
-            return LE_FAULT;
+            return true;
         }
     }
 
-    if (AddIntegerKeyInJsonObject(jsonArrayPtr, NULL, messageId) != LE_OK)
-    {
-        json_decref(jsonPtr);
-        LE_ERROR("json error");
-        return LE_FAULT;
-    }
-
-    if ( json_dump_file(jsonPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
-    {
-        json_decref(jsonPtr);
-        LE_ERROR("json error");
-        return LE_FAULT;
-    }
-
-    json_decref(jsonPtr);
-
-    // Use for the first initialization
-    if (jsonArrayPtr->refcount > 0)
-    {
-        json_decref(jsonArrayPtr);
-    }
-
-    return LE_OK;
+    return false;
 }
 
-
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Encode Json file
+ * Copy a message file of the former JSON inbox into the message store
  *
+ * @return
+ *      - LE_OK on success, or if the file is not readable
+ *      - LE_FAULT if the message can't be stored
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t EncodeMsgEntry
+static le_result_t MigrateJsonMsg
 (
-    uint32_t fd,            ///<[IN] file descriptor
-    le_sms_MsgRef_t msgRef  ///<[IN] SMS to be encoding
+    MessageId_t messageId,      ///<[IN] Message identifier
+    json_t* jsonArrayPtr[]      ///<[IN] message lists of the applications
 )
 {
-    json_t *jsonRootPtr = json_object();
-
-    if (!jsonRootPtr)
-    {
-        LE_ERROR("Json error");
-        return LE_FAULT;
-    }
-
-    // Add imsi in json file
-    AddStringKeyInJsonObject(jsonRootPtr, JSON_IMSI, SimImsi);
-
-    // Add sms format in json file
-    le_sms_Format_t format = le_sms_GetFormat(msgRef);
-    AddIntegerKeyInJsonObject(jsonRootPtr, JSON_FORMAT, (int) format);
-
-    // Unread by default for all applications
-    json_t *jsonUnreadPtr = json_object();
-    int i;
-    for (i=0; i < MAX_APPS; i++)
-    {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
-        {
-            AddBooleanKeyInJsonObject(jsonUnreadPtr, Apps[i].namePtr, true);
-        }
-    }
-
-    json_object_set_new(jsonRootPtr, JSON_ISUNREAD, jsonUnreadPtr);
-
-    // Undeleted by default for all applications
-    json_t *jsonDeletePtr = json_object();
-    for (i=0; i < MAX_APPS; i++)
-    {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
-        {
-            AddBooleanKeyInJsonObject(jsonDeletePtr, Apps[i].namePtr, false);
-        }
-    }
-
-    json_object_set_new(jsonRootPtr, JSON_ISDELETED, jsonDeletePtr);
-
-    switch ( format )
-    {
-        case LE_SMS_FORMAT_TEXT:
-        case LE_SMS_FORMAT_BINARY:
-        {
-            char tel[LE_MDMDEFS_PHONE_NUM_MAX_BYTES];
-            memset(tel,0,LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
-
-            // Add phone number
-            le_result_t result = le_sms_GetSenderTel(msgRef, tel, LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
-
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get the tel number %d", result);
-            }
-            else
-            {
-                LE_DEBUG("tel num: %s", tel);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_SENDERTEL, tel);
-            }
+    uint16_t pathLen = GetSMSInboxMessagePathLen();
+    char path[pathLen];
+    json_error_t error;
+    msgStore_Msg_t msg;
+    uint8_t data[MSGSTORE_MAX_DATA_BYTES];
+    uint32_t mboxMask = 0;
+    uint32_t unreadMask = 0;
+    const char* jsonKey;
+    int i;
 
-            // Add timestamp
-            char timeStamp[LE_SMS_TIMESTAMP_MAX_BYTES];
-            result = le_sms_GetTimeStamp (msgRef, timeStamp, LE_SMS_TIMESTAMP_MAX_BYTES);
+    GetSMSInboxMessagePath(messageId, path, pathLen);
 
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get the timestamp %d", result);
-            }
-            else
-            {
-                LE_DEBUG("timestamp: %s", timeStamp);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_TIMESTAMP, timeStamp);
-            }
+    json_t* jsonRootPtr = json_load_file(path, JSON_REJECT_DUPLICATES, &error);
 
-            size_t len = le_sms_GetUserdataLen(msgRef);
-            AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, len);
+    if ( jsonRootPtr == NULL )
+    {
+        LE_WARN("Dropping unreadable message %s: %s", path, error.text);
+        return LE_OK;
+    }
 
-            // Add a character for last '\0'
-            len++;
+    memset(&msg, 0, sizeof(msg));
+    msg.format = json_integer_value(json_object_get(jsonRootPtr, JSON_FORMAT));
+    msg.msgLen = json_integer_value(json_object_get(jsonRootPtr, JSON_MSGLEN));
+    msg.strPtr[MSGSTORE_IMSI] = json_string_value(json_object_get(jsonRootPtr, JSON_IMSI));
+    msg.strPtr[MSGSTORE_SENDER_TEL] = json_string_value(json_object_get(jsonRootPtr,
+                                                                        JSON_SENDERTEL));
+    msg.strPtr[MSGSTORE_TIMESTAMP] = json_string_value(json_object_get(jsonRootPtr,
+                                                                       JSON_TIMESTAMP));
 
-            uint8_t bin[len];
-            memset(bin,0,len);
-            int32_t strLen = 2*len + 1;
-            char string[strLen];
-            memset(string,0,strLen);
-            const char* jsonKey;
+    switch (msg.format)
+    {
+        case LE_SMS_FORMAT_TEXT:
+            jsonKey = JSON_TEXT;
+            break;
+        case LE_SMS_FORMAT_BINARY:
+            jsonKey = JSON_BIN;
+            break;
+        default:
+            jsonKey = JSON_PDU;
+            break;
+    }
 
-            if (format == LE_SMS_FORMAT_TEXT)
-            {
-                // Get text
-                result = le_sms_GetText(msgRef, (char*) bin, len);
-                jsonKey = JSON_TEXT;
-            }
-            else
-            {
-                // Get binary
-                result = le_sms_GetBinary(msgRef, bin, &len);
-                jsonKey = JSON_BIN;
-            }
+    const char* stringPtr = json_string_value(json_object_get(jsonRootPtr, jsonKey));
 
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get payload %d", result);
-                AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, 0);
-            }
-            else
-            {
-                // Convert payload in string: json supports only utf-8 characters.
-                // Some extended-ASCII characters can be sent by SMS (such as character with accent)
-                // and can't be convert directly in utf-8. A convertion in string solves this issue.
-                strLen = le_hex_BinaryToString(bin, len, string, strLen);
-                AddStringKeyInJsonObject(jsonRootPtr, jsonKey, string);
+    if (stringPtr)
+    {
+        int32_t len = le_hex_StringToBinary(stringPtr, strlen(stringPtr), data, sizeof(data));
 
-            }
+        if (len >= 0)
+        {
+            msg.dataPtr = data;
+            msg.dataLen = len;
         }
-        break;
+    }
 
-        case LE_SMS_FORMAT_PDU:
+    for (i=0; i < le_smsInbox_NbMbx; i++)
+    {
+        if ( Apps[i].namePtr
+             && IsInJsonMsgList(jsonArrayPtr[i], messageId)
+             && !json_is_true(json_object_get(json_object_get(jsonRootPtr, JSON_ISDELETED),
+                                              Apps[i].namePtr)) )
         {
-            size_t len = le_sms_GetPDULen(msgRef);
-            AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, len);
-            // Add a character for last '\0'
-            len++;
-            uint8_t pdu[len];
-            memset(pdu,0,len);
-            int32_t strLen = 2*len + 1;
-            char string[strLen];
-            memset(string,0,strLen);
-
-            // Add pdu
-            le_result_t result = le_sms_GetPDU(msgRef, pdu, &len);
+            mboxMask |= (1U << i);
 
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get pdu %d", result);
-                AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, 0);
-            }
-            else
+            if (json_is_true(json_object_get(json_object_get(jsonRootPtr, JSON_ISUNREAD),
+                                             Apps[i].namePtr)))
             {
-                // Convert pdu in string
-                strLen = le_hex_BinaryToString(pdu, len, string, strLen);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_PDU, string);
+                unreadMask |= (1U << i);
             }
         }
-        break;
-        case LE_SMS_FORMAT_UNKNOWN:
-        default:
-            LE_ERROR("Bad format %d", format);
     }
 
-    // Write json file in the file system
-    char* jsondumpStr = json_dumps( (const json_t *) jsonRootPtr,
-                                    JSON_INDENT(1) | JSON_PRESERVE_ORDER);
-    char* restJsondumpStr = jsondumpStr;
-    ssize_t writeSize = strlen(jsondumpStr);
-    ssize_t writtenSize;
+    le_result_t res = LE_OK;
 
-    do
+    if ( mboxMask && (msgStore_AddMsg(messageId, &msg, mboxMask, unreadMask) == 0) )
     {
-        writtenSize = write( fd, restJsondumpStr, writeSize );
-        if (writtenSize > 0)
-        {
-            writeSize -= writtenSize;
-            restJsondumpStr += writtenSize;
-        }
+        LE_ERROR("Unable to migrate message %08x", (int) messageId);
+        res = LE_FAULT;
     }
-    while ((writeSize > 0) && ((writtenSize >= 0) || (EINTR == errno)));
 
-    free(jsondumpStr);
     json_decref(jsonRootPtr);
 
-    return LE_OK;
+    return res;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a new message entry
+ * Remove a directory of the former JSON inbox and the files it contains
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t CreateMsgEntry
+static void RemoveJsonDirectory
 (
-    MessageId_t *msgPtr,    ///<[OUT] create messageId
-    int32_t *fdPtr         ///<[OUT] Created file descriptor
+    const char* dirPtr      ///<[IN] directory path
 )
 {
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
-
-    GetSMSInboxMessagePath(NextMessageId, path, pathLen);
-
-    *fdPtr = open( path, O_CREAT | O_RDWR | O_SYNC, S_IRUSR | S_IWUSR );
+    struct dirent **namelist;
+    int nbEntries = scandir(dirPtr, &namelist, NULL, alphasort);
 
-    if (*fdPtr < 0)
+    if (nbEntries < 0)
     {
-        LE_ERROR("No such file: %s", path);
-        return LE_FAULT;
+        return;
     }
 
-    LE_DEBUG("New entry: %s", path);
-
-    int i;
-
-    // For all the applications
-    for (i = 0; i < MAX_APPS; i++)
+    while (nbEntries--)
     {
-        if ( Apps[i].namePtr && strlen(Apps[i].namePtr) )
+        if (namelist[nbEntries]->d_name[0] != '.')
         {
-            AddMsgInAppCfg(&Apps[i], NextMessageId);
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), "%s%s", dirPtr, namelist[nbEntries]->d_name);
+            unlink(path);
         }
+        free(namelist[nbEntries]);
     }
 
-    *msgPtr = NextMessageId;
-
-    NextMessageId++;
+    free(namelist);
 
-    return LE_OK;
+    if (0 > rmdir(dirPtr))
+    {
+        LE_ERROR("Unable to remove directory %s: %m", dirPtr);
+    }
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Convert the file name string in hexa
+ * Migrate the messages stored by former versions (one JSON file per message, one JSON message
+ * list per application) to the message store. Each message file is removed once the message is
+ * stored, so an interrupted migration is resumed at next start.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static MessageId_t GetMessageId
+static void MigrateJsonInbox
 (
-    char* fileName  ///<[IN] file name to be converted
+    void
 )
 {
-    char *savePtr;
-    char *str = strtok_r(fileName,".", &savePtr);
-    return le_hex_HexaToInteger(str);
+    struct dirent **namelist;
+    json_t* jsonRootPtr[MAX_APPS];
+    json_t* jsonArrayPtr[MAX_APPS];
+    json_error_t error;
+    char path[PATH_MAX];
+    bool done = true;
+    int nbEntries;
+    int i;
+
+    nbEntries = scandir(SMSINBOX_PATH MSG_PATH, &namelist, NULL, alphasort);
+
+    if (nbEntries < 0)
+    {
+        // Nothing to migrate
+        return;
+    }
+
+    LE_INFO("Migrating JSON inbox");
+
+    memset(jsonRootPtr, 0, sizeof(jsonRootPtr));
+    memset(jsonArrayPtr, 0, sizeof(jsonArrayPtr));
+
+    for (i=0; i < le_smsInbox_NbMbx; i++)
+    {
+        if (Apps[i].namePtr)
+        {
+            GetSMSInboxConfigPath(Apps[i].namePtr, path, sizeof(path));
+            jsonRootPtr[i] = json_load_file(path, 0, &error);
+            jsonArrayPtr[i] = json_object_get(jsonRootPtr[i], JSON_MSGINBOX);
+        }
+    }
+
+    // Files are sorted by message identifier, which keeps the order of the message boxes.
+    for (i = 0; i < nbEntries; i++)
+    {
+        char* namePtr = namelist[i]->d_name;
+
+        if (done && (namePtr[0] != '.'))
+        {
+            MessageId_t messageId = GetMessageId(namePtr);
+
+            if (MigrateJsonMsg(messageId, jsonArrayPtr) == LE_OK)
+            {
+                GetSMSInboxMessagePath(messageId, path, sizeof(path));
+                unlink(path);
+            }
+            else
+            {
+                done = false;
+            }
+        }
+
+        free(namelist[i]);
+    }
+
+    free(namelist);
+
+    for (i=0; i < le_smsInbox_NbMbx; i++)
+    {
+        if (jsonRootPtr[i])
+        {
+            json_decref(jsonRootPtr[i]);
+        }
+    }
+
+    if (done)
+    {
+        RemoveJsonDirectory(SMSINBOX_PATH MSG_PATH);
+        RemoveJsonDirectory(SMSINBOX_PATH CONF_PATH);
+        LE_INFO("JSON inbox migrated");
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1354,55 +777,30 @@ static void InitSmsInBoxDirectory
     void
 )
 {
-    struct dirent **namelist;
-    uint32_t nbSmsEntries;
+    uint32_t mboxSize[MAX_APPS];
+    int i;
 
     LE_DEBUG("InitSmsInBoxDirectory");
 
-    // create directories
-    if (0 > mkdir( SMSINBOX_PATH, S_IREAD|S_IWRITE ))
+    // create directory
+    if ((0 > mkdir( SMSINBOX_PATH, S_IRWXU )) && (errno != EEXIST))
     {
         LE_ERROR("Unable to create directory %s: %m", SMSINBOX_PATH);
         return;
     }
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path,0,pathLen);
-    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, CONF_PATH);
-    if (0 > mkdir( path, S_IREAD|S_IWRITE ))
-    {
-        LE_ERROR("Unable to create directory %s: %m", path );
-        return;
-    }
-    memset(path,0,pathLen);
-    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, MSG_PATH);
-    if (0 > mkdir( path, S_IREAD|S_IWRITE ))
-    {
-        LE_ERROR("Unable to create directory %s: %m", path );
-        return;
-    }
-
 
-    nbSmsEntries = scandir(path, &namelist, NULL, alphasort);
-
-    if ( nbSmsEntries > 2 )
+    for (i=0; i < le_smsInbox_NbMbx; i++)
     {
-        uint8_t len = strlen(namelist[nbSmsEntries-1]->d_name);
-        char name[len+1];
-        memset(name, 0, len+1);
-        strncpy(name, namelist[nbSmsEntries-1]->d_name, len);
-        NextMessageId = GetMessageId(name);
-        NextMessageId++;
-
-        LE_DEBUG("NextMessageId %d", (int) NextMessageId);
+        mboxSize[i] = Apps[i].inboxSize;
     }
 
-    while (nbSmsEntries--)
+    if (msgStore_Init(SMSINBOX_PATH LOG_FILE, le_smsInbox_NbMbx, mboxSize) != LE_OK)
     {
-        free(namelist[nbSmsEntries]);
+        LE_ERROR("Unable to open the message store");
+        return;
     }
 
-    free(namelist);
+    MigrateJsonInbox();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1416,9 +814,6 @@ static void MoveSmsFromSimToFolder
     void
 )
 {
-    int32_t fd;
-    le_result_t result = LE_OK;
-
     le_sms_MsgListRef_t msgListRef = le_sms_CreateRxMsgList();
 
     if (!msgListRef)
@@ -1431,20 +826,7 @@ static void MoveSmsFromSimToFolder
 
     while(smsRef)
     {
-        MessageId_t msgId;
-
-        result = CreateMsgEntry(&msgId, &fd);
-
-        if (result == LE_OK)
-        {
-            if ( EncodeMsgEntry(fd, smsRef) != LE_OK )
-            {
-                LE_ERROR("Encoding issue");
-            }
-
-            close(fd);
-        }
-        else
+        if (AddMsgEntry(smsRef) == 0)
         {
             LE_ERROR("Error during new entry creation");
         }
@@ -1472,27 +854,15 @@ static void NewSmsMsgHandler
     void*           contextPtr
 )
 {
-    int32_t fd;
-    le_result_t result;
-    MessageId_t msgId;
-
-    result = CreateMsgEntry(&msgId, &fd);
-
-    if (result == LE_OK)
-    {
-        result = EncodeMsgEntry(fd, msgRef);
-        close(fd);
-
-    }
+    MessageId_t msgId = AddMsgEntry(msgRef);
 
-    if (result == LE_OK)
+    if (msgId != 0)
     {
         le_sms_DeleteFromStorage(msgRef);
         le_sms_Delete(msgRef);
         le_event_Report(RxMsgEventId, &msgId, sizeof(MessageId_t));
     }
 }
-
 //--------------------------------------------------------------------------------------------------
 /**
  * SIM state handler
@@ -1680,7 +1050,7 @@ SmsInbox_SessionRef_t SmsInbox_Open
             MboxSession_t* mboxSessionPtr = (MboxSession_t*) le_mem_ForceAlloc(MboxSessionPool);
 
             mboxSessionPtr->mboxCtxPtr = &Apps[i];
-            memset(&mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
+            memset(&mboxSessionPtr->browseCtx, 0, sizeof(mboxSessionPtr->browseCtx));
 
             return le_ref_CreateRef(MboxRefMap, mboxSessionPtr);
         }
@@ -1819,29 +1189,17 @@ void SmsInbox_DeleteMsg
         return;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = true;
-    char* key[2]={JSON_ISDELETED, mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
-    {
-        LE_ERROR("ModifyMsgEntry error");
-    }
-
-    if (DeleteMsgInAppCfg(mboxSessionPtr->mboxCtxPtr->namePtr, messageId) != LE_OK)
+    // The message is erased physically once all applications deleted it
+    if (msgStore_Delete(msgId, GetMboxIndex(mboxSessionPtr->mboxCtxPtr)) != LE_OK)
     {
-        LE_ERROR("DeleteMsgInAppCfg error");
+        LE_ERROR("Unable to delete message %u", msgId);
     }
-
-    PerformDeletion(messageId);
 }
 
 
@@ -1884,13 +1242,12 @@ le_result_t SmsInbox_GetImsi
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
     le_result_t res;
 
     memset(imsiPtr,0,imsiNumElements);
@@ -1900,14 +1257,7 @@ le_result_t SmsInbox_GetImsi
         return LE_OVERFLOW;
     }
 
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = imsiPtr;
-    decode.uVal.str.lenStr = imsiNumElements;
-    char* key[1] = {JSON_IMSI};
-
-    if ((res = DecodeMsgEntry(mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1, &decode))
-                                                                                        == LE_OK)
+    if ((res = msgStore_GetString(msgId, MSGSTORE_IMSI, imsiPtr, imsiNumElements)) == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
     }
@@ -1946,21 +1296,19 @@ le_sms_Format_t SmsInbox_GetFormat
         return 0;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return 0;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_INT;
-    char* key[1] = {JSON_FORMAT};
+    int32_t format;
+    uint32_t msgLen;
 
-    if (DecodeMsgEntry(mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1, &decode) == LE_OK)
+    if (msgStore_GetInfo(msgId, &format, &msgLen) == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
-        return decode.uVal.val;
+        return format;
     }
     else
     {
@@ -2005,23 +1353,16 @@ le_result_t SmsInbox_GetSenderTel
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
     le_result_t res;
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = telPtr;
-    decode.uVal.str.lenStr = telNumElements;
     memset(telPtr,0,telNumElements);
-    char* key[1] = {JSON_SENDERTEL};
 
-    if ((res = DecodeMsgEntry(mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1, &decode))
-                                                                                           == LE_OK)
+    if ((res = msgStore_GetString(msgId, MSGSTORE_SENDER_TEL, telPtr, telNumElements)) == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
     }
@@ -2070,23 +1411,19 @@ le_result_t SmsInbox_GetTimeStamp
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = timestampPtr;
-    decode.uVal.str.lenStr = timestampNumElements;
     memset(timestampPtr,0,timestampNumElements);
-    char* key[1] = {JSON_TIMESTAMP};
     le_result_t res;
 
-    if ( (res = DecodeMsgEntry(mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1, &decode))
-                                                                                          == LE_OK )
+    if ( (res = msgStore_GetString(msgId,
+                                   MSGSTORE_TIMESTAMP,
+                                   timestampPtr,
+                                   timestampNumElements)) == LE_OK )
     {
         SmsInbox_MarkRead(sessionRef, msgId);
     }
@@ -2121,28 +1458,20 @@ size_t SmsInbox_GetMsgLen
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-
-    EntryDesc_t decode;
-    decode.type = DESC_INT;
-    char* key[1] = {JSON_MSGLEN};
-    le_result_t res;
+    int32_t format;
+    uint32_t msgLen;
 
-    if ( (res = DecodeMsgEntry(mboxSessionPtr->mboxCtxPtr->namePtr,
-                                messageId,
-                                key,
-                                1,
-                                &decode)) == LE_OK )
+    if ( msgStore_GetInfo(msgId, &format, &msgLen) == LE_OK )
     {
         SmsInbox_MarkRead(sessionRef, msgId);
 
-        return decode.uVal.val;
+        return msgLen;
     }
     else
     {
@@ -2150,6 +1479,35 @@ size_t SmsInbox_GetMsgLen
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the data of a message of a given format
+ *
+ * @return
+ *  - LE_FAULT     The message is not in the requested format, or has no data.
+ *  - LE_OVERFLOW  Message length exceed the maximum length.
+ *  - LE_OK        Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetMsgData
+(
+    MessageId_t messageId,      ///<[IN] Message identifier
+    le_sms_Format_t format,     ///<[IN] Requested format
+    uint8_t* dataPtr,           ///<[OUT] Message data
+    size_t* dataNumElementsPtr  ///<[INOUT] Size of dataPtr, then data length
+)
+{
+    int32_t msgFormat;
+    uint32_t msgLen;
+
+    if ( (msgStore_GetInfo(messageId, &msgFormat, &msgLen) != LE_OK) || (msgFormat != format) )
+    {
+        return LE_FAULT;
+    }
+
+    return msgStore_GetData(messageId, dataPtr, dataNumElementsPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the text Message.
@@ -2189,37 +1547,19 @@ le_result_t SmsInbox_GetText
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
     le_result_t res;
-    size_t len = 2*textNumElements+1;
-    char tmpTextPtr[len];
-    memset(tmpTextPtr,0,len);
     memset(textPtr,0,textNumElements);
 
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpTextPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_TEXT};
-
-    res = DecodeMsgEntry(mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1, &decode);
+    res = GetMsgData(msgId, LE_SMS_FORMAT_TEXT, (uint8_t*) textPtr, &textNumElements);
 
     if ( res == LE_OK )
     {
-        if ( le_hex_StringToBinary(tmpTextPtr,
-                                   decode.uVal.str.lenStr,
-                                   (uint8_t*) textPtr,
-                                   textNumElements ) < 0 )
-        {
-            return LE_FAULT;
-        }
-
         SmsInbox_MarkRead(sessionRef, msgId);
     }
 
@@ -2265,41 +1605,19 @@ le_result_t SmsInbox_GetBinary
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
     le_result_t res;
-    EntryDesc_t decode;
-    size_t len = 2*(*binNumElementsPtr)+1;
-    char tmpBinPtr[len];
-    memset(tmpBinPtr,0,len);
     memset(binPtr,0,*binNumElementsPtr);
 
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpBinPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_BIN};
-
-    res = DecodeMsgEntry(mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1, &decode);
+    res = GetMsgData(msgId, LE_SMS_FORMAT_BINARY, binPtr, binNumElementsPtr);
 
     if ( res == LE_OK )
     {
-        int32_t binNumElements = le_hex_StringToBinary(tmpBinPtr,
-                                                    decode.uVal.str.lenStr,
-                                                    binPtr,
-                                                    *binNumElementsPtr);
-
-        if ( binNumElements < 0 )
-        {
-            return LE_FAULT;
-        }
-
-        *binNumElementsPtr = binNumElements;
-
         SmsInbox_MarkRead(sessionRef, msgId);
     }
 
@@ -2348,41 +1666,19 @@ le_result_t SmsInbox_GetPdu
         return 0;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return 0;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
     le_result_t res;
-    EntryDesc_t decode;
-    size_t len = 2*(*pduNumElementsPtr)+1;
-    char tmpPduPtr[len];
-    memset(tmpPduPtr,0,len);
     memset(pduPtr,0,*pduNumElementsPtr);
 
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpPduPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_PDU};
-
-    res = DecodeMsgEntry(mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1, &decode);
+    res = GetMsgData(msgId, LE_SMS_FORMAT_PDU, pduPtr, pduNumElementsPtr);
 
     if ( res == LE_OK )
     {
-        int32_t pduNumElements = le_hex_StringToBinary(tmpPduPtr,
-                                                    decode.uVal.str.lenStr,
-                                                    pduPtr,
-                                                    *pduNumElementsPtr);
-
-        if ( pduNumElements < 0 )
-        {
-            return LE_FAULT;
-        }
-
-        *pduNumElementsPtr = pduNumElements;
-
         SmsInbox_MarkRead(sessionRef, msgId);
     }
 
@@ -2415,72 +1711,15 @@ uint32_t SmsInbox_GetFirst
         return 0;
     }
 
-    uint32_t pathLen = GetSMSInboxConfigPathLen( mboxSessionPtr->mboxCtxPtr->namePtr );
-    char path[pathLen];
-    memset(path,0,pathLen);
-    GetSMSInboxConfigPath(mboxSessionPtr->mboxCtxPtr->namePtr, path, pathLen);
-    le_result_t res = LE_OK;
-    MessageId_t messageId=0;
-
-    if ( GetMsgListFromMbox(path,
-                        &mboxSessionPtr->browseCtx.jsonObjPtr,
-                        &mboxSessionPtr->browseCtx.jsonArrayPtr) != LE_OK )
-    {
-        LE_ERROR("error in GetMsgListFromMbox");
-        return 0;
-    }
-
-    mboxSessionPtr->browseCtx.maxIndex = json_array_size(mboxSessionPtr->browseCtx.jsonArrayPtr);
-
-    LE_DEBUG("maxIndex %d", mboxSessionPtr->browseCtx.maxIndex);
-
-    if ( mboxSessionPtr->browseCtx.maxIndex > 0 )
-    {
-        json_t * jsonIntegerPtr = json_array_get(mboxSessionPtr->browseCtx.jsonArrayPtr, 0);
-
-        if (jsonIntegerPtr)
-        {
-            messageId = json_integer_value(jsonIntegerPtr);
-        }
-        else
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
+    MessageId_t messageId = msgStore_GetFirst(GetMboxIndex(mboxSessionPtr->mboxCtxPtr),
+                                              &mboxSessionPtr->browseCtx);
 
-        if (messageId)
-        {
-            mboxSessionPtr->browseCtx.currentMessageIndex = 1;
-        }
-        else
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
-    }
-    else
+    if (messageId == 0)
     {
-        res = LE_FAULT;
         LE_DEBUG("Empty mbox");
     }
 
-    if (res == LE_FAULT)
-    {
-        if (mboxSessionPtr->browseCtx.jsonObjPtr)
-        {
-            json_decref(mboxSessionPtr->browseCtx.jsonObjPtr);
-        }
-
-        memset(&mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
-
-        return 0;
-    }
-    else
-    {
-        return messageId;
-    }
-
-    return 0;
+    return messageId;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2502,54 +1741,22 @@ uint32_t SmsInbox_GetNext
     // Get the message box session context
     MboxSession_t* mboxSessionPtr = (MboxSession_t*) le_ref_Lookup(MboxRefMap, sessionRef);
 
-    while(mboxSessionPtr->browseCtx.maxIndex != mboxSessionPtr->browseCtx.currentMessageIndex)
+    if (mboxSessionPtr == NULL)
     {
-        LE_DEBUG("currentIndex %d, maxIndex %d", mboxSessionPtr->browseCtx.currentMessageIndex,
-                                                 mboxSessionPtr->browseCtx.maxIndex);
-
-        json_t * jsonIntegerPtr = json_array_get(mboxSessionPtr->browseCtx.jsonArrayPtr,
-                                                 mboxSessionPtr->browseCtx.currentMessageIndex);
+        LE_ERROR("Bad mbox reference");
+        return 0;
+    }
 
-        if (jsonIntegerPtr)
-        {
-            MessageId_t messageId = json_integer_value(jsonIntegerPtr);
+    // Messages deleted since the GetFirst call are skipped
+    MessageId_t messageId = msgStore_GetNext(GetMboxIndex(mboxSessionPtr->mboxCtxPtr),
+                                             &mboxSessionPtr->browseCtx);
 
-            if (messageId > 0)
-            {
-                mboxSessionPtr->browseCtx.currentMessageIndex++;
-
-                // Check if the message exist (it may be deleted since the GetFirst call)
-                uint16_t pathLen = GetSMSInboxMessagePathLen();
-                char path[pathLen];
-                memset(path, 0, pathLen);
-                GetSMSInboxMessagePath(messageId, path, pathLen);
-                int32_t fd = open(path, O_RDWR);
-
-                if (fd > 0)
-                {
-                    // message is still existing
-                    close(fd);
-                    return messageId;
-                }
-                // else continue the parsing
-            }
-            else
-            {
-                LE_ERROR("json error");
-            }
-        }
-        else
-        {
-            LE_ERROR("json error");
-        }
+    if (messageId == 0)
+    {
+        LE_DEBUG("No more messages");
     }
 
-    // Parsing end => free the memory
-    LE_DEBUG("No more messages");
-    json_decref(mboxSessionPtr->browseCtx.jsonObjPtr);
-    memset(&mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
-
-    return 0;
+    return messageId;
 }
 //--------------------------------------------------------------------------------------------------
 /**
@@ -2581,26 +1788,13 @@ bool SmsInbox_IsUnread
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_BOOL;
-    char* key[] = {JSON_ISUNREAD, mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (DecodeMsgEntry(mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 2, &decode) == LE_OK)
-    {
-        return decode.uVal.boolVal;
-    }
-    else
-    {
-        LE_ERROR("Error in DecodeMsgEntry");
-        return false;
-    }
+    return msgStore_IsUnread(msgId, GetMboxIndex(mboxSessionPtr->mboxCtxPtr));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2631,21 +1825,16 @@ void SmsInbox_MarkRead
         return;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = false;
-    char* key[2]={JSON_ISUNREAD, mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
+    // Nothing is written if the message is already read
+    if (msgStore_SetUnread(msgId, GetMboxIndex(mboxSessionPtr->mboxCtxPtr), false) != LE_OK)
     {
-        LE_ERROR("Error in ModifyMsgEntry");
+        LE_ERROR("Unable to mark message %u as read", msgId);
     }
 }
 
@@ -2676,20 +1865,14 @@ void SmsInbox_MarkUnread
         return;
     }
 
-    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = true;
-    char* key[2]={JSON_ISUNREAD, mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
+    if (msgStore_SetUnread(msgId, GetMboxIndex(mboxSessionPtr->mboxCtxPtr), true) != LE_OK)
     {
-        LE_ERROR("Error in ModifyMsgEntry");
+        LE_ERROR("Unable to mark message %u as unread", msgId);
     }
 }
@@ -55,6 +55,14 @@ static const char* SubSysName[CGRP_NUM_SUBSYSTEMS] = {"cpu,cpuacct", "memory", "
 #define CPU_SHARES_FILENAME         "cpu.shares"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cpu accounting usage file.  Holds the total CPU time consumed by the cgroup in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CPU_USAGE_FILENAME          "cpuacct.usage"
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory limit file.
@@ -848,6 +856,48 @@ le_result_t cgrp_cpu_SetShare
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the total CPU time consumed by all the tasks in a cgroup, as accounted by the cpuacct
+ * controller.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_cpu_GetUsage
+(
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    uint64_t* usagePtr              ///< [OUT] CPU time in nanoseconds.
+)
+{
+    char buffer[32];
+
+    if (GetValue(CGRP_SUBSYS_CPU,
+                 cgroupNamePtr,
+                 CPU_USAGE_FILENAME,
+                 buffer,
+                 sizeof(buffer)) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    char* endPtr;
+    errno = 0;
+    unsigned long long usage = strtoull(buffer, &endPtr, 10);
+
+    if ((errno != 0) || (endPtr == buffer))
+    {
+        LE_ERROR("Invalid CPU usage '%s' in cgroup '%s'.", buffer, cgroupNamePtr);
+        return LE_FAULT;
+    }
+
+    *usagePtr = usage;
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the memory limit for a cgroup.
@@ -1016,6 +1066,7 @@ ssize_t cgrp_GetMemUsed
                  buffer,
                  sizeof(buffer)) == LE_OK)
     {
+        errno = 0;
         result = strtol(buffer, NULL, 10);
         if ((errno == ERANGE) || (errno == EINVAL))
         {
@@ -1048,6 +1099,7 @@ ssize_t cgrp_GetMaxMemUsed
                  buffer,
                  sizeof(buffer)) == LE_OK)
     {
+        errno = 0;
         result = strtol(buffer, NULL, 10);
         if ((errno == ERANGE) || (errno == EINVAL))
         {
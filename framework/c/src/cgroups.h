@@ -340,6 +340,23 @@ le_result_t cgrp_cpu_SetShare
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the total CPU time consumed by all the tasks in a cgroup, as accounted by the cpuacct
+ * controller.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_cpu_GetUsage
+(
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    uint64_t* usagePtr              ///< [OUT] CPU time in nanoseconds.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the memory limit for a cgroup.
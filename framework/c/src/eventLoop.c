@@ -99,6 +99,7 @@
 #include "fdMonitor.h"
 #include "limit.h"
 #include "fileDescriptor.h"
+#include "stats.h"
 
 #include <pthread.h>
 #include <sys/eventfd.h>
@@ -501,6 +502,9 @@ static void WriteEventFd
 
     ssize_t writeSize;
 
+    // Every report queued to an Event Queue comes through here.
+    stats_Increment(STATS_EVENTS_QUEUED);
+
     for (;;)
     {
         writeSize = write(perThreadRecPtr->eventQueueFd, &writeBuff, sizeof(writeBuff));
@@ -589,6 +593,8 @@ static void ProcessOneEventReport
         return;
     }
 
+    stats_Increment(STATS_EVENTS_PROCESSED);
+
     // Convert the link pointer into a pointer to the Report base class.
     reportObjPtr = CONTAINER_OF(linkPtr, Report_t, link);
 
@@ -950,6 +956,8 @@ void event_DestructThread
     {
         Report_t* reportPtr = CONTAINER_OF(singleLinkPtr, Report_t, link);
 
+        stats_Increment(STATS_EVENTS_PROCESSED);
+
         // If it is carrying a pointer to a reference-counted object from a memory pool,
         // release that thing first.
         if (reportPtr->type == LE_EVENT_REPORT_COUNTED_REF)
@@ -46,6 +46,7 @@
 #include "thread.h"
 #include "fdMonitor.h"
 #include "limit.h"
+#include "stats.h"
 
 #include <pthread.h>
 
@@ -449,6 +450,7 @@ static void DispatchToHandler
     event_SetCurrentContextPtr(fdMonitorPtr->contextPtr);
 
     // Call the handler function.
+    stats_Increment(STATS_FD_DISPATCHES);
     fdMonitorPtr->handlerFunc(fdMonitorPtr->fd, pollEvents);
 
     // Clear the thread-specific pointer to the FD Monitor.
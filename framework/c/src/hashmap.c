@@ -1226,8 +1226,8 @@ bool le_hashmap_EqualsUInt64
     const void* secondIntPtr    ///< [in] Pointer to the second long integer for comparing.
 )
 {
-    int a = *((uint64_t*) firstIntPtr);
-    int b = *((uint64_t*) secondIntPtr);
+    uint64_t a = *((uint64_t*) firstIntPtr);
+    uint64_t b = *((uint64_t*) secondIntPtr);
     return a == b;
 }
 
@@ -8,6 +8,7 @@
 #include "legato.h"
 
 #include "args.h"
+#include "stats.h"
 #include "mem.h"
 #include "hashmap.h"
 #include "safeRef.h"
@@ -51,6 +52,7 @@ __attribute__((constructor)) void _legato_InitFramework
     // hasn't been called yet.  Keep it that way.  Also, be careful when using logging inside
     // the memory pool module, because there is the risk of creating infinite recursion.
 
+    stats_Init();      // Must come first so that every memory pool gets a statistics record.
     mem_Init();
     log_Init();        // Uses memory pools.
     sig_Init();        // Uses memory pools.
@@ -9,6 +9,8 @@
 #include "legato.h"
 #include "killProc.h"
 #include "limit.h"
+#include "fileDescriptor.h"
+#include <dirent.h>
 
 
 //--------------------------------------------------------------------------------------------------
@@ -48,6 +50,14 @@ le_hashmap_Ref_t ProcTimerHash;
 #define PROC_TIMER_HASH_SIZE        31
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of characters of a process name that the kernel keeps in /proc/<pid>/comm.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_COMM_LEN                15
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initializes the kill API.
@@ -195,9 +205,110 @@ void kill_Hard
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a file from a process's /proc directory.  The content is always NULL-terminated.
+ *
+ * @return
+ *      The number of bytes read if successful.
+ *      -1 if the file could not be read, e.g. because the process has exited.
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t ReadProcFile
+(
+    pid_t pid,                  ///< [IN] Process to read the file of.
+    const char* fileNamePtr,    ///< [IN] Name of the file in /proc/<pid>.
+    char* bufPtr,               ///< [OUT] Buffer to store the content in.
+    size_t bufSize              ///< [IN] Size of the buffer.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    LE_ASSERT(snprintf(path, sizeof(path), "/proc/%d/%s", pid, fileNamePtr) < sizeof(path));
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    ssize_t numBytes;
+
+    do
+    {
+        numBytes = read(fd, bufPtr, bufSize - 1);
+    }
+    while ( (numBytes == -1) && (errno == EINTR) );
+
+    fd_Close(fd);
+
+    if (numBytes < 0)
+    {
+        return -1;
+    }
+
+    bufPtr[numBytes] = '\0';
+
+    return numBytes;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a process has the specified name.  Like killall, the name is matched against the
+ * process name kept by the kernel, which is truncated to MAX_COMM_LEN characters, and longer names
+ * are checked against the name of the process's executable.
+ *
+ * @return
+ *      true if the process has the specified name.
+ *      false otherwise, or if the process does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsProcNamed
+(
+    pid_t pid,                  ///< [IN] Process to check.
+    const char* procNamePtr     ///< [IN] Name of the process.
+)
+{
+    char comm[MAX_COMM_LEN + 2];
+
+    if (ReadProcFile(pid, "comm", comm, sizeof(comm)) <= 0)
+    {
+        return false;
+    }
+
+    // Remove the trailing newline.
+    comm[strcspn(comm, "\n")] = '\0';
+
+    if (strlen(procNamePtr) < MAX_COMM_LEN)
+    {
+        return (strcmp(comm, procNamePtr) == 0);
+    }
+
+    if (strncmp(comm, procNamePtr, MAX_COMM_LEN) != 0)
+    {
+        return false;
+    }
+
+    // The first argument of the command line is the executable's path.  Kernel threads have an
+    // empty command line.
+    char cmdLine[LIMIT_MAX_PATH_BYTES];
+
+    if (ReadProcFile(pid, "cmdline", cmdLine, sizeof(cmdLine)) <= 0)
+    {
+        return false;
+    }
+
+    return (strcmp(le_path_GetBasenamePtr(cmdLine, "/"), procNamePtr) == 0);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Kills processes by name.  Kills all occurrences of a process with the specified name.
+ *
+ * The processes are looked up in /proc and sent a SIGTERM, as killall would, but without having to
+ * fork a shell and run an external tool.  The calling process is never killed.
  */
 //--------------------------------------------------------------------------------------------------
 void kill_ByName
@@ -205,18 +316,33 @@ void kill_ByName
     const char* procNamePtr     ///< [IN] Name of the processes to kill.
 )
 {
-    char killCmd[LIMIT_MAX_PATH_BYTES];
-    int s = snprintf(killCmd, sizeof(killCmd), "killall -q %s", procNamePtr);
+    DIR* procDirPtr = opendir("/proc");
+    LE_FATAL_IF(procDirPtr == NULL, "Could not open /proc.  %m.");
+
+    pid_t ownPid = getpid();
+    struct dirent* entryPtr;
 
-    if (s >= sizeof(killCmd))
+    while ((entryPtr = readdir(procDirPtr)) != NULL)
     {
-        LE_FATAL("Could not create 'killall' cmd, buffer is too small.  Buffer is %zd bytes but \
-needs to be %d bytes.", sizeof(killCmd), s);
-    }
+        // Only the process directories have numerical names.
+        char* endPtr;
+        long pid = strtol(entryPtr->d_name, &endPtr, 10);
+
+        if ( (endPtr == entryPtr->d_name) || (*endPtr != '\0') || (pid == ownPid) )
+        {
+            continue;
+        }
 
-    int r = system(killCmd);
+        if (IsProcNamed(pid, procNamePtr))
+        {
+            LE_DEBUG("Sending SIGTERM to process '%s' (PID: %ld).", procNamePtr, pid);
+
+            LE_FATAL_IF((kill(pid, SIGTERM) == -1) && (errno != ESRCH),
+                        "Failed to send SIGTERM to process (PID: %ld).  %m.", pid);
+        }
+    }
 
-    LE_FATAL_IF(!WIFEXITED(r), "Could not send killall cmd.");
+    closedir(procDirPtr);
 }
 
 
@@ -75,6 +75,9 @@ void kill_Hard
 //--------------------------------------------------------------------------------------------------
 /**
  * Kills processes by name.  Kills all occurrences of a process with the specified name.
+ *
+ * The processes are looked up in /proc and sent a SIGTERM, as killall would, but without having to
+ * fork a shell and run an external tool.  The calling process is never killed.
  */
 //--------------------------------------------------------------------------------------------------
 void kill_ByName
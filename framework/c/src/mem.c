@@ -199,6 +199,34 @@ static inline void Unlock
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a pool's counters into its record in the statistics page.
+ *
+ * @note
+ *      Assumes that the mutex is locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void PublishStats
+(
+    MemPool_t* pool
+)
+{
+    stats_PoolRecord_t* recPtr = pool->statsRecPtr;
+
+    if (recPtr != NULL)
+    {
+        stats_BeginUpdate(&recPtr->seq);
+        recPtr->numAllocations = pool->numAllocations;
+        recPtr->numOverflows = pool->numOverflows;
+        recPtr->totalBlocks = pool->totalBlocks;
+        recPtr->numBlocksInUse = pool->numBlocksInUse;
+        recPtr->maxNumBlocksUsed = pool->maxNumBlocksUsed;
+        stats_EndUpdate(&recPtr->seq);
+    }
+}
+
+
 #ifdef USE_GUARD_BAND
 
     //----------------------------------------------------------------------------------------------
@@ -330,6 +358,7 @@ static void InitPool
     pool->blockSize = blockSize;
     pool->destructor = NULL;
     pool->superPoolPtr = NULL;
+    pool->statsRecPtr = NULL;
     pool->numAllocations = 0;
     pool->numOverflows = 0;
     pool->totalBlocks = 0;
@@ -647,6 +676,9 @@ le_mem_PoolRef_t _le_mem_CreatePool
     PoolListChangeCount++;
     le_dls_Queue(&PoolList, &(newPool->poolLink));
 
+    newPool->statsRecPtr = stats_AddPool(newPool->name);
+    PublishStats(newPool);
+
     Unlock();
 
     return newPool;
@@ -699,6 +731,8 @@ le_mem_PoolRef_t le_mem_ExpandPool
             {
                 pool->superPoolPtr->maxNumBlocksUsed = pool->superPoolPtr->numBlocksInUse;
             }
+
+            PublishStats(pool->superPoolPtr);
         }
         else
         {
@@ -706,6 +740,8 @@ le_mem_PoolRef_t le_mem_ExpandPool
             AddBlocks(pool, numObjects);
         }
 
+        PublishStats(pool);
+
         Unlock();
     #endif
 
@@ -763,6 +799,8 @@ void* le_mem_TryAlloc
             pool->maxNumBlocksUsed = pool->numBlocksInUse;
         }
 
+        PublishStats(pool);
+
         blockPtr->refCount = 1;
 
         // Return the user object in the block.
@@ -834,6 +872,7 @@ void* le_mem_ForceAlloc
 
             Lock();
             pool->numOverflows++;
+            PublishStats(pool);
 
             // log a warning.
             LE_DEBUG("Memory pool '%s' overflowed. Expanded to %zu blocks.",
@@ -949,6 +988,7 @@ void le_mem_Release
             #endif
 
             poolPtr->numBlocksInUse--;
+            PublishStats(poolPtr);
 
             break;
         }
@@ -1071,6 +1111,7 @@ void le_mem_ResetStats
     Lock();
     pool->numAllocations = 0;
     pool->numOverflows = 0;
+    PublishStats(pool);
     Unlock();
 }
 
@@ -1297,6 +1338,9 @@ le_mem_PoolRef_t _le_mem_CreateSubPool
     PoolListChangeCount++;
     le_dls_Queue(&PoolList, &(subPool->poolLink));
 
+    subPool->statsRecPtr = stats_AddPool(subPool->name);
+    PublishStats(subPool);
+
     Unlock();
 
     // Expand the pool to its initial size.
@@ -1350,6 +1394,10 @@ void le_mem_DeleteSubPool
     PoolListChangeCount++;
     le_dls_Remove(&PoolList, &(subPool->poolLink));
 
+    stats_RemovePool(subPool->statsRecPtr);
+    subPool->statsRecPtr = NULL;
+    PublishStats(superPool);
+
     Unlock();
 
     // Release the sub-pool.
@@ -13,6 +13,7 @@
 #define MEM_INCLUDE_GUARD
 
 #include "limit.h"
+#include "stats.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -45,6 +46,7 @@ typedef struct le_mem_Pool
                                         ///  for this pool.
     #endif
 
+    stats_PoolRecord_t* statsRecPtr;    ///< This pool's record in the statistics page, or NULL.
     le_mem_Destructor_t destructor;     ///< The destructor for objects in this pool.
     char name[LIMIT_MAX_MEM_POOL_NAME_BYTES]; ///< Name of the pool.
 }
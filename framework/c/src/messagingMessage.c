@@ -138,7 +138,8 @@ le_mem_PoolRef_t msgMessage_CreatePool
 le_result_t msgMessage_Send
 (
     int         socketFd,   ///< [IN] Connected socket's file descriptor.
-    Message_t*  msgPtr      ///< The Message to be sent.
+    Message_t*  msgPtr,     ///< The Message to be sent.
+    size_t*     sizePtr     ///< [OUT] Number of bytes sent on the socket, if successful.
 )
 //--------------------------------------------------------------------------------------------------
 {
@@ -160,9 +161,12 @@ le_result_t msgMessage_Send
 
     // The first bytes come from our transaction ID and the rest (if any)
     // from our Message object's payload section, which comes right after the transaction ID.
+    // The socket is a sequenced-packet socket, so the message is either sent whole or not at all.
+    *sizePtr = sizeof(msgPtr->txnId) + le_msg_GetMaxPayloadSize(msgPtr);
+
     return unixSocket_SendMsg(  socketFd,
                                 &msgPtr->txnId,
-                                sizeof(msgPtr->txnId) + le_msg_GetMaxPayloadSize(msgPtr),
+                                *sizePtr,
                                 msgPtr->fd,
                                 false   ); // Don't send process credentials.
 }
@@ -182,16 +186,17 @@ le_result_t msgMessage_Send
 le_result_t msgMessage_Receive
 (
     int                 socketFd,   ///< [IN] The socket's file descriptor.
-    le_msg_MessageRef_t msgRef      ///< [IN] Message object to store the received message in.
+    le_msg_MessageRef_t msgRef,     ///< [IN] Message object to store the received message in.
+    size_t*             sizePtr     ///< [OUT] Number of bytes received, if successful.
 )
 //--------------------------------------------------------------------------------------------------
 {
     // Receive the first bytes into our transaction ID and the rest (if any)
     // into our Message object's payload section.
-    size_t byteCount = sizeof(msgRef->txnId) + le_msg_GetMaxPayloadSize(msgRef);
+    *sizePtr = sizeof(msgRef->txnId) + le_msg_GetMaxPayloadSize(msgRef);
     le_result_t result = unixSocket_ReceiveMsg( socketFd,
                                                 &msgRef->txnId,
-                                                &byteCount,
+                                                sizePtr,
                                                 &msgRef->fd,
                                                 NULL    );  // Don't receive credentials.
     if (msgSession_GetInterfaceType(msgRef->sessionRef) == LE_MSG_INTERFACE_SERVER)
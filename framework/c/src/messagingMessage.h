@@ -86,7 +86,8 @@ le_mem_PoolRef_t msgMessage_CreatePool
 le_result_t msgMessage_Send
 (
     int         socketFd,   ///< [IN] Connected socket's file descriptor.
-    Message_t*  msgPtr      ///< The Message to be sent.
+    Message_t*  msgPtr,     ///< The Message to be sent.
+    size_t*     sizePtr     ///< [OUT] Number of bytes sent on the socket, if successful.
 );
 
 
@@ -104,7 +105,8 @@ le_result_t msgMessage_Send
 le_result_t msgMessage_Receive
 (
     int                 socketFd,   ///< [IN] The socket's file descriptor.
-    le_msg_MessageRef_t msgRef      ///< [IN] Message object to store the received message in.
+    le_msg_MessageRef_t msgRef,     ///< [IN] Message object to store the received message in.
+    size_t*             sizePtr     ///< [OUT] Number of bytes received, if successful.
 );
 
 
@@ -17,6 +17,7 @@
 #include "messagingProtocol.h"
 #include "messagingMessage.h"
 #include "fileDescriptor.h"
+#include "stats.h"
 
 
 // =======================================
@@ -450,6 +451,9 @@ static msgSession_Session_t* CreateSession
 
     sessionPtr->interfaceRef = interfaceRef;
 
+    bool isServer = (interfaceRef->interfaceType == LE_MSG_INTERFACE_SERVER);
+    sessionPtr->statsRecPtr = stats_AddSession(le_msg_GetInterfaceName(interfaceRef), isServer);
+
     SessionObjListChangeCount++;
     msgInterface_AddSession(interfaceRef, sessionPtr);
 
@@ -523,6 +527,8 @@ static void DeleteSession
     SessionObjListChangeCount++;
     msgInterface_RemoveSession(sessionPtr->interfaceRef, sessionPtr);
 
+    stats_RemoveSession(sessionPtr->statsRecPtr);
+
     // Release the Session object itself.
     le_mem_Release(sessionPtr);
 }
@@ -917,10 +923,13 @@ static void ReceiveMessages
         le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionPtr);
 
         // Receive from the socket into the Message object.
-        le_result_t result = msgMessage_Receive(sessionPtr->socketFd, msgRef);
+        size_t msgSize;
+        le_result_t result = msgMessage_Receive(sessionPtr->socketFd, msgRef, &msgSize);
 
         if (result == LE_OK)
         {
+            stats_CountSessionMessage(sessionPtr->statsRecPtr, false, msgSize);
+
             // Received something.  Push it onto the Receive Queue for later processing.
             PushReceiveQueue(sessionPtr, msgRef);
         }
@@ -1004,11 +1013,14 @@ static void SendFromTransmitQueue
             break;
         }
 
-        le_result_t result = msgMessage_Send(sessionPtr->socketFd, msgRef);
+        size_t msgSize;
+        le_result_t result = msgMessage_Send(sessionPtr->socketFd, msgRef, &msgSize);
 
         switch (result)
         {
             case LE_OK:
+                stats_CountSessionMessage(sessionPtr->statsRecPtr, true, msgSize);
+
                 switch (sessionPtr->interfaceRef->interfaceType)
                 {
                     // If this is the client side of the session,
@@ -1671,7 +1683,11 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
     fd_SetBlocking(sessionRef->socketFd);
 
     // Send the Request Message.
-    msgMessage_Send(sessionRef->socketFd, msgRef);
+    size_t msgSize;
+    if (msgMessage_Send(sessionRef->socketFd, msgRef, &msgSize) == LE_OK)
+    {
+        stats_CountSessionMessage(sessionRef->statsRecPtr, true, msgSize);
+    }
 
     // While we have not yet received the response we are waiting for, keep
     // receiving messages.  Any that we receive that don't match the transaction ID
@@ -1681,7 +1697,7 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
     {
         rxMsgRef = le_msg_CreateMsg(sessionRef);
 
-        le_result_t result = msgMessage_Receive(sessionRef->socketFd, rxMsgRef);
+        le_result_t result = msgMessage_Receive(sessionRef->socketFd, rxMsgRef, &msgSize);
 
         if (result != LE_OK)
         {
@@ -1692,6 +1708,8 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
             break;
         }
 
+        stats_CountSessionMessage(sessionRef->statsRecPtr, false, msgSize);
+
         if (msgMessage_GetTxnId(rxMsgRef) == msgMessage_GetTxnId(msgRef))
         {
             // Got the synchronous response we were waiting for.
@@ -11,6 +11,7 @@
 #define LE_MESSAGING_SESSION_H_INCLUDE_GUARD
 
 #include "messagingInterface.h"
+#include "stats.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -61,6 +62,7 @@ typedef struct le_msg_Session
     void*                           openContextPtr; ///< Open handler's context pointer.
     le_msg_SessionEventHandler_t    closeHandler;   ///< Close handler function.
     void*                           closeContextPtr;///< Close handler's context pointer.
+    stats_SessionRecord_t*          statsRecPtr;    ///< Record in the statistics page, or NULL.
 }
 msgSession_Session_t;
 
@@ -0,0 +1,409 @@
+//--------------------------------------------------------------------------------------------------
+/** @file stats.c
+ *
+ * Implementation of the live statistics page. See stats.h for a description of the page.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "stats.h"
+#include "fileDescriptor.h"
+#include <sys/mman.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flag for memfd_create(), in case the C library headers are too old to define it.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The statistics page of this process, or NULL if it couldn't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static stats_Page_t* PagePtr = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File descriptor of the shared memory segment holding the page.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PageFd = -1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an anonymous shared memory segment big enough for a statistics page.
+ *
+ * @return
+ *      The segment's file descriptor, or -1 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CreateSegment
+(
+    void
+)
+{
+    int fd = -1;
+
+#ifdef SYS_memfd_create
+    fd = syscall(SYS_memfd_create, STATS_SEGMENT_NAME, MFD_CLOEXEC);
+#endif
+
+    if (fd == -1)
+    {
+        // No memfd support. Use a file on the tmpfs and unlink it right away, so that it disappears
+        // with the process just like a memfd would.
+        char path[LIMIT_MAX_PATH_BYTES];
+
+        snprintf(path, sizeof(path), "/tmp/" STATS_SEGMENT_NAME ".%d", getpid());
+
+        fd = open(path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+
+        if (fd == -1)
+        {
+            return -1;
+        }
+
+        unlink(path);
+    }
+
+    if (ftruncate(fd, sizeof(stats_Page_t)) == -1)
+    {
+        fd_Close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs in the child after a fork(). Gives the child its own copy of the page, mapped at the same
+ * address so that the record pointers held by the other modules stay valid, instead of letting it
+ * update its parent's page.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ForkChildHandler
+(
+    void
+)
+{
+    if (PagePtr == NULL)
+    {
+        return;
+    }
+
+    int oldFd = PageFd;
+    int newFd = CreateSegment();
+
+    if (   (newFd == -1)
+        || (pwrite(newFd, PagePtr, sizeof(stats_Page_t), 0) != sizeof(stats_Page_t))
+        || (mmap(PagePtr, sizeof(stats_Page_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                 newFd, 0) == MAP_FAILED) )
+    {
+        // Can't publish anything for the child, but it must not write into its parent's page.
+        if (newFd != -1)
+        {
+            close(newFd);
+        }
+        mmap(PagePtr, sizeof(stats_Page_t), PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+        PageFd = -1;
+    }
+    else
+    {
+        PageFd = newFd;
+        PagePtr->pid = getpid();
+    }
+
+    close(oldFd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the statistics module and creates this process's statistics page.
+ *
+ * Must be called before any other module of the framework is initialized. If the page can't be
+ * created, statistics are silently not published.
+ */
+//--------------------------------------------------------------------------------------------------
+void stats_Init
+(
+    void
+)
+{
+    // NOTE: This runs before the memory pools and logging are initialized, so don't use them.
+
+    int fd = CreateSegment();
+
+    if (fd == -1)
+    {
+        return;
+    }
+
+    stats_Page_t* pagePtr = mmap(NULL, sizeof(stats_Page_t), PROT_READ | PROT_WRITE, MAP_SHARED,
+                                 fd, 0);
+
+    if (pagePtr == MAP_FAILED)
+    {
+        fd_Close(fd);
+        return;
+    }
+
+    // The segment is zero-filled, so all records start out free and all counters at zero.
+    pagePtr->version = STATS_VERSION;
+    pagePtr->pageSize = sizeof(stats_Page_t);
+    pagePtr->pid = getpid();
+    pagePtr->maxPools = STATS_MAX_POOLS;
+    pagePtr->maxSessions = STATS_MAX_SESSIONS;
+
+    // Writing the magic number last makes the page valid for readers.
+    __atomic_store_n(&pagePtr->magic, STATS_MAGIC, __ATOMIC_RELEASE);
+
+    PageFd = fd;
+    PagePtr = pagePtr;
+
+    pthread_atfork(NULL, NULL, ForkChildHandler);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Increments one of the process-wide counters.
+ */
+//--------------------------------------------------------------------------------------------------
+void stats_Increment
+(
+    stats_Counter_t counter     ///< [IN] The counter to increment.
+)
+{
+    if (PagePtr != NULL)
+    {
+        __atomic_fetch_add(&PagePtr->counters[counter], 1, __ATOMIC_RELAXED);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Claims a free record in an array of records. Both record types start with the seq and state
+ * fields, so this works on either of them. The record is left in the STATS_RECORD_CLAIMED state
+ * for the caller to finish setting it up.
+ *
+ * @return
+ *      Pointer to the claimed record, or NULL if they are all used.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ClaimRecord
+(
+    void* recordsPtr,       ///< [IN] Array of records.
+    size_t recordSize,      ///< [IN] Size of a record.
+    size_t numRecords,      ///< [IN] Number of records in the array.
+    const char* name,       ///< [IN] Name to give to the record.
+    size_t nameOffset,      ///< [IN] Offset of the name field in a record.
+    size_t nameSize         ///< [IN] Size of the name field.
+)
+{
+    size_t i;
+
+    for (i = 0; i < numRecords; i++)
+    {
+        uint8_t* recPtr = (uint8_t*)recordsPtr + (i * recordSize);
+        uint32_t* statePtr = (uint32_t*)(recPtr + sizeof(uint32_t));
+        uint32_t expected = STATS_RECORD_FREE;
+
+        if (__atomic_compare_exchange_n(statePtr, &expected, STATS_RECORD_CLAIMED, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            // The record is ours now, and readers ignore it until the caller marks it as used.
+            uint32_t* seqPtr = (uint32_t*)recPtr;
+
+            stats_BeginUpdate(seqPtr);
+            memset(recPtr + nameOffset, 0, recordSize - nameOffset);
+            le_utf8_Copy((char*)(recPtr + nameOffset), name, nameSize, NULL);
+            stats_EndUpdate(seqPtr);
+
+            return recPtr;
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives back a record claimed by ClaimRecord().
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseRecord
+(
+    uint32_t* seqPtr,       ///< [IN] The record's sequence lock.
+    uint32_t* statePtr      ///< [IN] The record's state.
+)
+{
+    stats_BeginUpdate(seqPtr);
+    __atomic_store_n(statePtr, STATS_RECORD_FREE, __ATOMIC_RELAXED);
+    stats_EndUpdate(seqPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Claims a record for a memory pool.
+ *
+ * @return
+ *      Pointer to the record, or NULL if statistics are not available or the page is full.
+ */
+//--------------------------------------------------------------------------------------------------
+stats_PoolRecord_t* stats_AddPool
+(
+    const char* name    ///< [IN] Name of the pool.
+)
+{
+    if (PagePtr == NULL)
+    {
+        return NULL;
+    }
+
+    stats_PoolRecord_t* recPtr = ClaimRecord(PagePtr->pools,
+                                             sizeof(stats_PoolRecord_t),
+                                             STATS_MAX_POOLS,
+                                             name,
+                                             offsetof(stats_PoolRecord_t, name),
+                                             sizeof(recPtr->name));
+
+    if (recPtr == NULL)
+    {
+        __atomic_fetch_add(&PagePtr->droppedPools, 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        stats_BeginUpdate(&recPtr->seq);
+        recPtr->state = STATS_RECORD_USED;
+        stats_EndUpdate(&recPtr->seq);
+    }
+
+    return recPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives back a record claimed by stats_AddPool().
+ */
+//--------------------------------------------------------------------------------------------------
+void stats_RemovePool
+(
+    stats_PoolRecord_t* recPtr  ///< [IN] The record, may be NULL.
+)
+{
+    if (recPtr != NULL)
+    {
+        ReleaseRecord(&recPtr->seq, &recPtr->state);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Claims a record for an IPC session.
+ *
+ * @return
+ *      Pointer to the record, or NULL if statistics are not available or the page is full.
+ */
+//--------------------------------------------------------------------------------------------------
+stats_SessionRecord_t* stats_AddSession
+(
+    const char* interfaceName,  ///< [IN] Name of the session's interface.
+    bool isServer               ///< [IN] true if this is the server side of the session.
+)
+{
+    if (PagePtr == NULL)
+    {
+        return NULL;
+    }
+
+    stats_SessionRecord_t* recPtr = ClaimRecord(PagePtr->sessions,
+                                                sizeof(stats_SessionRecord_t),
+                                                STATS_MAX_SESSIONS,
+                                                interfaceName,
+                                                offsetof(stats_SessionRecord_t, name),
+                                                sizeof(recPtr->name));
+
+    if (recPtr == NULL)
+    {
+        __atomic_fetch_add(&PagePtr->droppedSessions, 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        stats_BeginUpdate(&recPtr->seq);
+        recPtr->isServer = isServer;
+        recPtr->state = STATS_RECORD_USED;
+        stats_EndUpdate(&recPtr->seq);
+    }
+
+    return recPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives back a record claimed by stats_AddSession().
+ */
+//--------------------------------------------------------------------------------------------------
+void stats_RemoveSession
+(
+    stats_SessionRecord_t* recPtr   ///< [IN] The record, may be NULL.
+)
+{
+    if (recPtr != NULL)
+    {
+        ReleaseRecord(&recPtr->seq, &recPtr->state);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts a message sent or received on an IPC session.
+ */
+//--------------------------------------------------------------------------------------------------
+void stats_CountSessionMessage
+(
+    stats_SessionRecord_t* recPtr,  ///< [IN] The session's record, may be NULL.
+    bool isTx,                      ///< [IN] true if the message was sent, false if received.
+    size_t numBytes                 ///< [IN] Number of bytes transferred on the socket.
+)
+{
+    if (recPtr == NULL)
+    {
+        return;
+    }
+
+    stats_BeginUpdate(&recPtr->seq);
+
+    if (isTx)
+    {
+        recPtr->txMessages++;
+        recPtr->txBytes += numBytes;
+    }
+    else
+    {
+        recPtr->rxMessages++;
+        recPtr->rxBytes += numBytes;
+    }
+
+    stats_EndUpdate(&recPtr->seq);
+}
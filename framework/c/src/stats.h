@@ -0,0 +1,308 @@
+//--------------------------------------------------------------------------------------------------
+/** @file stats.h
+ *
+ * Live statistics page.
+ *
+ * Every process that uses the framework publishes a compact statistics page in a shared memory
+ * segment: a handful of process-wide counters (event queue activity, timers, FD Monitor
+ * dispatches), one record per memory pool and one record per IPC session. The page is updated in
+ * place by the modules that own the counters, so reading it costs nothing to the process being
+ * observed.
+ *
+ * The segment is a memfd (or an unlinked file in /tmp on kernels that don't have memfd) named
+ * @ref STATS_SEGMENT_NAME. A collector running as root finds it by scanning /proc/<PID>/fd for
+ * a link containing that name, maps it read-only and reads the records using the sequence lock
+ * protocol described on @ref stats_Page_t.
+ *
+ * This file is shared by the framework, which writes the page, and the tools that read it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_STATS_H_INCLUDE_GUARD
+#define LEGATO_STATS_H_INCLUDE_GUARD
+
+#include "limit.h"
+#include <sched.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name given to the shared memory segment holding the statistics page.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STATS_SEGMENT_NAME      "legato-stats"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number found at the start of a valid statistics page ("LSTA").
+ */
+//--------------------------------------------------------------------------------------------------
+#define STATS_MAGIC             0x4c535441
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Version of the page layout. Must be incremented whenever any of the structures below change.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STATS_VERSION           1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of memory pool and IPC session records in a page. Objects created once all
+ * records are taken are not published; they are counted in the page's "dropped" counters instead.
+ *
+ * @note Only the records that have actually been used are backed by memory.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STATS_MAX_POOLS         256
+#define STATS_MAX_SESSIONS      64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process-wide counters. All of them only ever increase (modulo 2^32); gauges are computed by
+ * the reader as the difference between two of them.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    STATS_EVENTS_QUEUED,        ///< Event reports and queued functions added to event queues.
+    STATS_EVENTS_PROCESSED,     ///< Event reports and queued functions taken off event queues.
+    STATS_TIMERS_CREATED,       ///< Timers created.
+    STATS_TIMERS_DELETED,       ///< Timers deleted.
+    STATS_TIMER_EXPIRIES,       ///< Timer expiries handled.
+    STATS_FD_DISPATCHES,        ///< FD Monitor handler calls.
+    STATS_NUM_COUNTERS
+}
+stats_Counter_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Values of the state field of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STATS_RECORD_FREE       0   ///< Record is not used.
+#define STATS_RECORD_USED       1   ///< Record describes a live object.
+#define STATS_RECORD_CLAIMED    2   ///< Record is being set up for a new object.
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of one memory pool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t seq;                               ///< Sequence lock, odd while being updated.
+    uint32_t state;                             ///< One of the STATS_RECORD_xxx values.
+    char name[LIMIT_MAX_MEM_POOL_NAME_BYTES];   ///< Component-scoped name of the pool.
+    uint64_t numAllocations;                    ///< Total number of allocations.
+    uint32_t numOverflows;                      ///< Number of times the pool had to be expanded.
+    uint32_t totalBlocks;                       ///< Number of blocks, free and allocated.
+    uint32_t numBlocksInUse;                    ///< Number of currently allocated blocks.
+    uint32_t maxNumBlocksUsed;                  ///< High-water mark of numBlocksInUse.
+}
+stats_PoolRecord_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of one IPC session.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t seq;                                   ///< Sequence lock, odd while being updated.
+    uint32_t state;                                 ///< One of the STATS_RECORD_xxx values.
+    char name[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];  ///< Name of the session's interface.
+    uint32_t isServer;                              ///< 1 = server side, 0 = client side.
+    uint32_t reserved;
+    uint64_t txMessages;                            ///< Messages sent.
+    uint64_t rxMessages;                            ///< Messages received.
+    uint64_t txBytes;                               ///< Bytes sent on the session's socket.
+    uint64_t rxBytes;                               ///< Bytes received on the session's socket.
+}
+stats_SessionRecord_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The statistics page.
+ *
+ * The header fields (magic, version, sizes, pid) are written once before the page becomes
+ * visible. Counters are updated with atomic increments and can be read at any time.
+ *
+ * Records are protected by a per-record sequence lock. A writer takes the lock by moving seq from
+ * an even to an odd value with a compare-and-swap, so writers of a record running in different
+ * threads are serialized. To read a record consistently:
+ *  -# read seq (acquire); if it is odd, try again;
+ *  -# copy the record;
+ *  -# read seq again after an acquire fence; if it changed, try again.
+ *
+ * Only records whose state is STATS_RECORD_USED hold valid data.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                         ///< STATS_MAGIC.
+    uint32_t version;                       ///< STATS_VERSION.
+    uint32_t pageSize;                      ///< sizeof(stats_Page_t).
+    int32_t pid;                            ///< Process that owns the page.
+    uint32_t maxPools;                      ///< Number of elements in pools[].
+    uint32_t maxSessions;                   ///< Number of elements in sessions[].
+    uint32_t droppedPools;                  ///< Pools that couldn't get a record.
+    uint32_t droppedSessions;               ///< Sessions that couldn't get a record.
+    uint32_t counters[STATS_NUM_COUNTERS];  ///< Process-wide counters, see stats_Counter_t.
+    stats_PoolRecord_t pools[STATS_MAX_POOLS];
+    stats_SessionRecord_t sessions[STATS_MAX_SESSIONS];
+}
+stats_Page_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks the start of an update of a record. Must be followed by stats_EndUpdate().
+ *
+ * Waits for an update of the record by another thread to end, which only takes a few stores.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void stats_BeginUpdate
+(
+    uint32_t* seqPtr    ///< [IN] The record's sequence lock.
+)
+{
+    uint32_t seq = __atomic_load_n(seqPtr, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        if ((seq & 1) != 0)
+        {
+            // Let the other writer finish, even if it was preempted on a single core.
+            sched_yield();
+            seq = __atomic_load_n(seqPtr, __ATOMIC_RELAXED);
+        }
+        else if (__atomic_compare_exchange_n(seqPtr, &seq, seq + 1, true,
+                                             __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            break;
+        }
+    }
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks the end of an update of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void stats_EndUpdate
+(
+    uint32_t* seqPtr    ///< [IN] The record's sequence lock.
+)
+{
+    __atomic_fetch_add(seqPtr, 1, __ATOMIC_RELEASE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the statistics module and creates this process's statistics page.
+ *
+ * Must be called before any other module of the framework is initialized. If the page can't be
+ * created, statistics are silently not published.
+ */
+//--------------------------------------------------------------------------------------------------
+void stats_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Increments one of the process-wide counters.
+ */
+//--------------------------------------------------------------------------------------------------
+void stats_Increment
+(
+    stats_Counter_t counter     ///< [IN] The counter to increment.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Claims a record for a memory pool.
+ *
+ * @return
+ *      Pointer to the record, or NULL if statistics are not available or the page is full.
+ *
+ * @note The record is updated under the sequence lock until stats_RemovePool() is called.
+ */
+//--------------------------------------------------------------------------------------------------
+stats_PoolRecord_t* stats_AddPool
+(
+    const char* name    ///< [IN] Name of the pool.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives back a record claimed by stats_AddPool().
+ */
+//--------------------------------------------------------------------------------------------------
+void stats_RemovePool
+(
+    stats_PoolRecord_t* recPtr  ///< [IN] The record, may be NULL.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Claims a record for an IPC session.
+ *
+ * @return
+ *      Pointer to the record, or NULL if statistics are not available or the page is full.
+ *
+ * @note The record may be updated from several threads, stats_BeginUpdate() serializes them.
+ */
+//--------------------------------------------------------------------------------------------------
+stats_SessionRecord_t* stats_AddSession
+(
+    const char* interfaceName,  ///< [IN] Name of the session's interface.
+    bool isServer               ///< [IN] true if this is the server side of the session.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives back a record claimed by stats_AddSession().
+ */
+//--------------------------------------------------------------------------------------------------
+void stats_RemoveSession
+(
+    stats_SessionRecord_t* recPtr   ///< [IN] The record, may be NULL.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts a message sent or received on an IPC session.
+ */
+//--------------------------------------------------------------------------------------------------
+void stats_CountSessionMessage
+(
+    stats_SessionRecord_t* recPtr,  ///< [IN] The session's record, may be NULL.
+    bool isTx,                      ///< [IN] true if the message was sent, false if received.
+    size_t numBytes                 ///< [IN] Number of bytes transferred on the socket.
+);
+
+
+#endif // LEGATO_STATS_H_INCLUDE_GUARD
@@ -331,6 +331,7 @@ typedef struct app_Ref
     le_timer_Ref_t  killTimer;          // Timeout timer for killing processes.
     le_sls_List_t   additionalLinks;    // List of additional links that are temporarily added to
                                         // the app.
+    char            lastLinkDir[LIMIT_MAX_PATH_BYTES];  // Last directory created for a link.
 }
 App_t;
 
@@ -364,6 +365,35 @@ FileLinkNode_t;
 static le_mem_PoolRef_t FileLinkNodePool;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record of the set up of a sandboxed app's area.  The links (bind mounts) into a sandbox are left
+ * in place when the app stops, so they do not have to be created again on the next start as long
+ * as the sandbox has not been unmounted and the app has not been reinstalled or reconfigured.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char appName[LIMIT_MAX_APP_NAME_BYTES];     ///< Name of the app.  Key in the map.
+    char installPath[LIMIT_MAX_PATH_BYTES];     ///< Resolved install dir the links were made from.
+    bool isReady;                               ///< true if all the links are in place.
+    le_cfg_ChangeHandlerRef_t cfgChangeRef;     ///< Handler that clears isReady on config changes.
+}
+AppAreaRecord_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool and map of app area records, keyed by app name.  Records are kept for the life
+ * of the Supervisor.
+ */
+//--------------------------------------------------------------------------------------------------
+#define APP_AREA_RECORD_MAP_SIZE        31
+
+static le_mem_PoolRef_t AppAreaRecordPool;
+static le_hashmap_Ref_t AppAreaRecordMap;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prototype for process stopped handler.
@@ -1252,6 +1282,7 @@ static le_result_t GetAbsDestPath
 //--------------------------------------------------------------------------------------------------
 static le_result_t CreateIntermediateDirs
 (
+    app_Ref_t appRef,                   ///< [IN] Application reference.
     const char* pathPtr,                ///< [IN] Path.
     const char* smackLabelPtr           ///< [IN] SMACK label to use for the created dirs.
 )
@@ -1264,6 +1295,13 @@ static le_result_t CreateIntermediateDirs
         return LE_FAULT;
     }
 
+    // Links are mostly created a directory at a time so skip the path walk if the directory was
+    // the last one created.
+    if (strcmp(dirPath, appRef->lastLinkDir) == 0)
+    {
+        return LE_OK;
+    }
+
     if (dir_MakePathSmack(dirPath,
                           S_IRUSR | S_IXUSR | S_IROTH | S_IXOTH,
                           smackLabelPtr) == LE_FAULT)
@@ -1271,6 +1309,9 @@ static le_result_t CreateIntermediateDirs
         return LE_FAULT;
     }
 
+    LE_ASSERT(le_utf8_Copy(appRef->lastLinkDir, dirPath, sizeof(appRef->lastLinkDir), NULL)
+              == LE_OK);
+
     return LE_OK;
 }
 
@@ -1279,7 +1320,8 @@ static le_result_t CreateIntermediateDirs
 /**
  * Check if the link already exists.
  *
- * If there is a link to a different file then attempt to delete it.
+ * If there is a link to a different file then attempt to delete it, or to unmount it if the app is
+ * sandboxed.
  *
  * @return
  *      true if link already exists.
@@ -1320,6 +1362,12 @@ static bool DoesLinkExist
                 LE_WARN("Could not delete %s.  %m,", destPath);
             }
         }
+        // A bind mount of a source that was deleted and replaced cannot be mounted over, so
+        // detach it before the new source is mounted.
+        else if ( (umount2(destPath, MNT_DETACH) == -1) && (errno != EINVAL) )
+        {
+            LE_WARN("Could not unmount %s.  %m", destPath);
+        }
     }
 
     return false;
@@ -1370,7 +1418,7 @@ static le_result_t CreateDirLink
     }
 
     // Create the necessary intermediate directories along the destination path.
-    if (CreateIntermediateDirs(destPath, appDirLabelPtr) != LE_OK)
+    if (CreateIntermediateDirs(appRef, destPath, appDirLabelPtr) != LE_OK)
     {
         return LE_FAULT;
     }
@@ -1459,7 +1507,7 @@ static le_result_t CreateFileLink
     }
 
     // Create the necessary intermediate directories along the destination path.
-    if (CreateIntermediateDirs(destPath, appDirLabelPtr) != LE_OK)
+    if (CreateIntermediateDirs(appRef, destPath, appDirLabelPtr) != LE_OK)
     {
         return LE_FAULT;
     }
@@ -2123,6 +2171,190 @@ static le_result_t CreateRequiredLinks
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that the links to the app's required files under the current node in the configuration
+ * iterator still point to their sources.  A source that was replaced by a new file has a different
+ * inode than the file bind mounted in the sandbox.
+ *
+ * @return
+ *      true if all the links are current.
+ *      false if a link is stale or could not be checked.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AreRequiredFileLinksCurrent
+(
+    app_Ref_t appRef,                   ///< [IN] Application reference.
+    le_cfg_IteratorRef_t cfgIter        ///< [IN] Config iterator.
+)
+{
+    bool isCurrent = true;
+
+    if (le_cfg_GoToFirstChild(cfgIter) == LE_OK)
+    {
+        do
+        {
+            char srcPath[LIMIT_MAX_PATH_BYTES] = "";
+            char destPtr[LIMIT_MAX_PATH_BYTES];
+            char destPath[LIMIT_MAX_PATH_BYTES] = "";
+            struct stat srcStat;
+            struct stat destStat;
+
+            if ( (GetSrcPath(appRef, cfgIter, srcPath, sizeof(srcPath)) != LE_OK) ||
+                 (GetDestPath(appRef, cfgIter, destPtr, sizeof(destPtr)) != LE_OK) ||
+                 (GetAbsDestPath(destPtr, srcPath, appRef->workingDir,
+                                 destPath, sizeof(destPath)) != LE_OK) ||
+                 (stat(srcPath, &srcStat) == -1) ||
+                 (stat(destPath, &destStat) == -1) ||
+                 (srcStat.st_ino != destStat.st_ino) )
+            {
+                LE_DEBUG("Link to '%s' in app '%s' is stale.", srcPath, appRef->name);
+                isCurrent = false;
+            }
+        }
+        while (isCurrent && (le_cfg_GoToNextSibling(cfgIter) == LE_OK));
+
+        le_cfg_GoToParent(cfgIter);
+    }
+
+    return isCurrent;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that the links to the app's required files and devices still point to their sources.
+ * Only a stat of each source and link is done so this is much cheaper than making the links again.
+ *
+ * @return
+ *      true if all the links are current.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AreRequiredLinksCurrent
+(
+    app_Ref_t appRef                    ///< [IN] Application reference.
+)
+{
+    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(appRef->cfgPathRoot);
+
+    le_cfg_GoToNode(appCfg, CFG_NODE_REQUIRES);
+    le_cfg_GoToNode(appCfg, CFG_NODE_FILES);
+
+    bool isCurrent = AreRequiredFileLinksCurrent(appRef, appCfg);
+
+    if (isCurrent)
+    {
+        le_cfg_GoToParent(appCfg);
+        le_cfg_GoToNode(appCfg, CFG_NODE_DEVICES);
+
+        isCurrent = AreRequiredFileLinksCurrent(appRef, appCfg);
+    }
+
+    le_cfg_CancelTxn(appCfg);
+    return isCurrent;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called by the config tree when an app's config has changed.  The app's links may have changed
+ * so its area must be set up again on the next start.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppAreaConfigChangeHandler
+(
+    void* contextPtr                    ///< [IN] The app area record.
+)
+{
+    AppAreaRecord_t* recordPtr = contextPtr;
+
+    recordPtr->isReady = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the app area record for an app, creating it if it does not exist yet.
+ *
+ * @return
+ *      The app area record.
+ */
+//--------------------------------------------------------------------------------------------------
+static AppAreaRecord_t* GetAppAreaRecord
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+)
+{
+    AppAreaRecord_t* recordPtr = le_hashmap_Get(AppAreaRecordMap, appRef->name);
+
+    if (recordPtr == NULL)
+    {
+        recordPtr = le_mem_ForceAlloc(AppAreaRecordPool);
+
+        LE_ASSERT(le_utf8_Copy(recordPtr->appName, appRef->name,
+                               sizeof(recordPtr->appName), NULL) == LE_OK);
+        recordPtr->installPath[0] = '\0';
+        recordPtr->isReady = false;
+
+        // Register before the app's config is read to set up the area so that no change is missed.
+        recordPtr->cfgChangeRef = le_cfg_AddChangeHandler(appRef->cfgPathRoot,
+                                                          AppAreaConfigChangeHandler,
+                                                          recordPtr);
+
+        le_hashmap_Put(AppAreaRecordMap, recordPtr->appName, recordPtr);
+    }
+
+    return recordPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets up the links in the application execution area.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CreateAppAreaLinks
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    const char* appDirLabelPtr          ///< [IN] SMACK label to use for created directories.
+)
+{
+    if (appRef->sandboxed)
+    {
+        // Create default links.
+        if (CreateDefaultLinks(appRef, appDirLabelPtr) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    // Create links to the app's lib and bin directories.
+    if (CreateLibBinLinks(appRef, appDirLabelPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    // Create links to bundled files.
+    if (CreateBundledLinks(appRef, appDirLabelPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    // Create links to required files.
+    if (CreateRequiredLinks(appRef, appDirLabelPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets up the application execution area in the file system.  For a sandboxed app this will be the
@@ -2150,42 +2382,61 @@ static le_result_t SetupAppArea
         return LE_FAULT;
     }
 
-    if (appRef->sandboxed)
+    if (!appRef->sandboxed)
     {
-        if (!fs_IsMountPoint(appRef->workingDir))
-        {
-            // Bind mount the root of the sandbox unto itself so that we just lazy umount this when we
-            // need to clean up.
-            if (mount(appRef->workingDir, appRef->workingDir, NULL, MS_BIND, NULL) != 0)
-            {
-                LE_ERROR("Couldn't bind mount '%s' unto itself. %m", appRef->workingDir);
-                return LE_FAULT;
-            }
-        }
+        return CreateAppAreaLinks(appRef, appDirLabel);
+    }
 
-        // Create default links.
-        if (CreateDefaultLinks(appRef, appDirLabel) != LE_OK)
+    // The links are made from the app's installed files so they must be made again if the app
+    // was reinstalled.  If the install dir cannot be resolved the set up is not recorded.
+    char installPath[PATH_MAX];
+
+    if (realpath(appRef->installDirPath, installPath) == NULL)
+    {
+        installPath[0] = '\0';
+    }
+
+    AppAreaRecord_t* recordPtr = GetAppAreaRecord(appRef);
+
+    if (!fs_IsMountPoint(appRef->workingDir))
+    {
+        // Bind mount the root of the sandbox unto itself so that we just lazy umount this when we
+        // need to clean up.
+        if (mount(appRef->workingDir, appRef->workingDir, NULL, MS_BIND, NULL) != 0)
         {
+            LE_ERROR("Couldn't bind mount '%s' unto itself. %m", appRef->workingDir);
             return LE_FAULT;
         }
     }
-
-    // Create links to the app's lib and bin directories.
-    if (CreateLibBinLinks(appRef, appDirLabel) != LE_OK)
+    else if ( recordPtr->isReady && (installPath[0] != '\0') &&
+              (strcmp(recordPtr->installPath, installPath) == 0) &&
+              AreRequiredLinksCurrent(appRef) )
     {
-        return LE_FAULT;
+        // The sandbox is still set up from the previous start.  A required file that was replaced
+        // since then fails the check above and is bind mounted again by the full set up.
+        LE_INFO("Sandbox for app '%s' is already set up.", appRef->name);
+        return LE_OK;
     }
 
-    // Create links to bundled files.
-    if (CreateBundledLinks(appRef, appDirLabel) != LE_OK)
+    recordPtr->isReady = false;
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    if (CreateAppAreaLinks(appRef, appDirLabel) != LE_OK)
     {
         return LE_FAULT;
     }
 
-    // Create links to required files.
-    if (CreateRequiredLinks(appRef, appDirLabel) != LE_OK)
+    le_clk_Time_t duration = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    LE_INFO("Set up sandbox for app '%s' in %ld ms.",
+            appRef->name, (long)(duration.sec * 1000 + duration.usec / 1000));
+
+    if ( (installPath[0] != '\0') &&
+         (le_utf8_Copy(recordPtr->installPath, installPath,
+                       sizeof(recordPtr->installPath), NULL) == LE_OK) )
     {
-        return LE_FAULT;
+        recordPtr->isReady = true;
     }
 
     return LE_OK;
@@ -2315,6 +2566,9 @@ static void RemoveLinks
 
     LE_INFO("Removing link %s from %s.", pathPtr, appRef->name);
 
+    // The removed link may be a directory that was recorded as created.
+    appRef->lastLinkDir[0] = '\0';
+
     if (appRef->sandboxed)
     {
         fs_TryLazyUmount(fullPath);
@@ -2347,6 +2601,11 @@ void app_Init
 {
     AppPool = le_mem_CreatePool("Apps", sizeof(App_t));
     FileLinkNodePool = le_mem_CreatePool("Links", sizeof(FileLinkNode_t));
+    AppAreaRecordPool = le_mem_CreatePool("AppAreaRecords", sizeof(AppAreaRecord_t));
+    AppAreaRecordMap = le_hashmap_Create("AppAreaRecords",
+                                         APP_AREA_RECORD_MAP_SIZE,
+                                         le_hashmap_HashString,
+                                         le_hashmap_EqualsString);
     ProcContainerPool = le_mem_CreatePool("ProcContainers", sizeof(ProcContainer_t));
 
     proc_Init();
@@ -2461,6 +2720,7 @@ app_Ref_t app_Create
     appPtr->procs = LE_DLS_LIST_INIT;
     appPtr->auxProcs = LE_DLS_LIST_INIT;
     appPtr->additionalLinks = LE_SLS_LIST_INIT;
+    appPtr->lastLinkDir[0] = '\0';
     appPtr->state = APP_STATE_STOPPED;
     appPtr->killTimer = NULL;
 
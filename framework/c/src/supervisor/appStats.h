@@ -0,0 +1,58 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/appStats.h
+ *
+ * API for sampling the resources used by the running applications.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+#ifndef LEGATO_SRC_APP_STATS_INCLUDE_GUARD
+#define LEGATO_SRC_APP_STATS_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the application statistics sub-system.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts sampling an application.  The samples kept from a previous run of the application are
+ * discarded.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_StartApp
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stops sampling an application.  The samples taken are kept until the application is started
+ * again or deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_StopApp
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stops sampling an application and discards its samples.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_DeleteApp
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+);
+
+
+#endif  // LEGATO_SRC_APP_STATS_INCLUDE_GUARD
@@ -58,6 +58,7 @@
 #include "legato.h"
 #include "apps.h"
 #include "app.h"
+#include "appStats.h"
 #include "interfaces.h"
 #include "limit.h"
 #include "wait.h"
@@ -319,6 +320,8 @@ static void DeleteApp
     // Reset the additional link overrides here too because it is persistent in the file system.
     app_RemoveAllLinks(appContainerPtr->appRef);
 
+    appStats_DeleteApp(app_GetName(appContainerPtr->appRef));
+
     app_Delete(appContainerPtr->appRef);
 
     le_mem_Release(appContainerPtr);
@@ -339,6 +342,8 @@ static void DeactivateAppContainer
 
     LE_INFO("Application '%s' has stopped.", app_GetName(appContainerRef->appRef));
 
+    appStats_StopApp(app_GetName(appContainerRef->appRef));
+
     appContainerRef->stopHandler = NULL;
 
     le_dls_Queue(&InactiveAppsList, &(appContainerRef->link));
@@ -636,6 +641,8 @@ static le_result_t StartApp
     le_dls_Queue(&ActiveAppsList, &(appContainerPtr->link));
     appContainerPtr->isActive = true;
 
+    appStats_StartApp(app_GetName(appContainerPtr->appRef));
+
     // Start the app.
     return app_Start(appContainerPtr->appRef);
 }
@@ -1123,6 +1130,7 @@ void apps_Init
 )
 {
     app_Init();
+    appStats_Init();
 
     // Create memory pools.
     AppContainerPool = le_mem_CreatePool("appContainers", sizeof(AppContainer_t));
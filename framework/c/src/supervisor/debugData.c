@@ -0,0 +1,966 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/debugData.c
+ *
+ * Module that captures the data that may help diagnose a process fault: a dump of the system log
+ * and the most recent core file of the process.
+ *
+ * The capture is done by the Supervisor itself rather than by a shell script, so that handling a
+ * fault does not require forking a shell and a series of external tools.  The only external tool
+ * used is logread, whose output is streamed through a pipe into the log file.  Core files are
+ * moved into the log directory, or copied chunk by chunk if they are on another file system.  Both
+ * the system log and core files are truncated to a maximum size.
+ *
+ * Captures are performed one at a time from the event loop, so that a fault does not stall the
+ * Supervisor while its data is being saved.  However when the system is about to reboot the
+ * capture is performed synchronously because the Supervisor will not be around to complete it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "debugData.h"
+#include "limit.h"
+#include "sysPaths.h"
+#include "fileDescriptor.h"
+#include "wait.h"
+#include <dirent.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directories the debug data is saved in.  The data is normally saved in the tmp file system
+ * (normally a RAM disk).  However, if the system is about to be rebooted, the data is saved in
+ * flash along with the data previously saved in the tmp file system.
+ *
+ * The paths and sizes below can be overridden to unit test this module in a temporary directory.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef RAM_LOG_DIR
+#define RAM_LOG_DIR                     "/tmp/legato_logs"
+#endif
+#ifndef FLASH_LOG_DIR
+#define FLASH_LOG_DIR                   "/mnt/flash/legato_logs"
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory containing the working directories of the apps, where the core files of their
+ * processes are created.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef APPS_CORE_DIR
+#define APPS_CORE_DIR                   APPS_WRITEABLE_DIR
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Program used to dump the system log on its standard output.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef LOGREAD_PATH
+#define LOGREAD_PATH                    "/sbin/logread"
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of previous system log dumps and core files kept in the tmp file system.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef MAX_KEPT_FILES
+#define MAX_KEPT_FILES                  3
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum sizes of a system log dump and of a core file.  Larger ones are truncated.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef MAX_LOG_BYTES
+#define MAX_LOG_BYTES                   (512 * 1024)
+#endif
+#ifndef MAX_CORE_BYTES
+#define MAX_CORE_BYTES                  (16 * 1024 * 1024)
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes copied at a time.  Copies are done one chunk per event loop iteration.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHUNK_BYTES                     (16 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of captures waiting to be performed.  Faults beyond this are not captured, so
+ * that a crash loop can't pile up work in the Supervisor.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef MAX_PENDING_CAPTURES
+#define MAX_PENDING_CAPTURES            4
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Permissions of the created directories.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DIR_PERMISSIONS                 (S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy of a file descriptor's content into a file, up to a maximum size.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int inFd;                               ///< Fd to copy from, -1 if not open.
+    int outFd;                              ///< Fd to copy to, -1 if not open.
+    size_t numBytes;                        ///< Number of bytes copied so far.
+    size_t maxBytes;                        ///< Maximum number of bytes to copy.
+    char outPath[LIMIT_MAX_PATH_BYTES];     ///< Path of the file copied to.
+}
+Stream_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Capture of the debug data of a faulty process.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;                             ///< Link in the list of captures.
+    char appName[LIMIT_MAX_APP_NAME_BYTES];         ///< Name of the app.
+    char procName[LIMIT_MAX_PROCESS_NAME_BYTES];    ///< Name of the process.
+    time_t faultTime;                               ///< Time of the fault.
+    bool isAsync;                                   ///< Is the capture done from the event loop?
+    const char* logDirPtr;                          ///< Directory to save the data in.
+    pid_t logReaderPid;                             ///< Pid of logread, -1 if not running.
+    le_fdMonitor_Ref_t monitorRef;                  ///< Monitor of logread's output pipe.
+    char corePath[LIMIT_MAX_PATH_BYTES];            ///< Core file being copied.
+    Stream_t stream;                                ///< Copy in progress.
+}
+Capture_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of captures.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CapturePool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of asynchronous captures.  The first one is in progress, the others are waiting.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t CaptureList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer used for the copies.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t CopyBuffer[CHUNK_BYTES];
+
+
+static void StartCapture(Capture_t* capturePtr);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens the file a stream copies to.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenStreamOutput
+(
+    Stream_t* streamPtr,            ///< [IN] Stream.
+    size_t maxBytes                 ///< [IN] Maximum number of bytes to copy.
+)
+{
+    do
+    {
+        streamPtr->outFd = open(streamPtr->outPath,
+                                O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                                S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    }
+    while ( (streamPtr->outFd == -1) && (errno == EINTR) );
+
+    if (streamPtr->outFd == -1)
+    {
+        LE_ERROR("Could not create file '%s'.  %m.", streamPtr->outPath);
+        return LE_FAULT;
+    }
+
+    streamPtr->numBytes = 0;
+    streamPtr->maxBytes = maxBytes;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes the file descriptors of a stream.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseStream
+(
+    Stream_t* streamPtr             ///< [IN] Stream.
+)
+{
+    if (streamPtr->inFd != -1)
+    {
+        fd_Close(streamPtr->inFd);
+        streamPtr->inFd = -1;
+    }
+
+    if (streamPtr->outFd != -1)
+    {
+        fd_Close(streamPtr->outFd);
+        streamPtr->outFd = -1;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a chunk of a stream.
+ *
+ * @return
+ *      LE_OK if there is more to copy.
+ *      LE_WOULD_BLOCK if there is nothing to read for now on a non-blocking stream.
+ *      LE_TERMINATED if the copy is over, because the whole input was copied, the maximum size
+ *                    was reached or there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CopyChunk
+(
+    Stream_t* streamPtr             ///< [IN] Stream.
+)
+{
+    ssize_t numBytesRead;
+
+    do
+    {
+        numBytesRead = read(streamPtr->inFd, CopyBuffer, sizeof(CopyBuffer));
+    }
+    while ( (numBytesRead == -1) && (errno == EINTR) );
+
+    if (numBytesRead == -1)
+    {
+        if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) )
+        {
+            return LE_WOULD_BLOCK;
+        }
+
+        LE_ERROR("Could not read data for '%s'.  %m.", streamPtr->outPath);
+        return LE_TERMINATED;
+    }
+
+    if (numBytesRead == 0)
+    {
+        return LE_TERMINATED;
+    }
+
+    size_t numBytes = numBytesRead;
+
+    if (numBytes > streamPtr->maxBytes - streamPtr->numBytes)
+    {
+        numBytes = streamPtr->maxBytes - streamPtr->numBytes;
+        LE_WARN("'%s' truncated to %zu bytes.", streamPtr->outPath, streamPtr->maxBytes);
+    }
+
+    size_t numBytesWritten = 0;
+
+    while (numBytesWritten < numBytes)
+    {
+        ssize_t r = write(streamPtr->outFd,
+                          CopyBuffer + numBytesWritten,
+                          numBytes - numBytesWritten);
+
+        if (r == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            LE_ERROR("Could not write to '%s'.  %m.", streamPtr->outPath);
+            return LE_TERMINATED;
+        }
+
+        numBytesWritten += r;
+    }
+
+    streamPtr->numBytes += numBytes;
+
+    if (streamPtr->numBytes >= streamPtr->maxBytes)
+    {
+        return LE_TERMINATED;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the oldest or the newest regular file in a directory whose name starts with a prefix.
+ *
+ * @return
+ *      The number of files whose name starts with the prefix.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t FindFile
+(
+    const char* dirPathPtr,         ///< [IN] Directory to search.
+    const char* prefixPtr,          ///< [IN] Prefix of the file names.
+    bool findNewest,                ///< [IN] true to find the newest file, false for the oldest.
+    char* namePtr,                  ///< [OUT] Name of the file found.
+    size_t nameSize                 ///< [IN] Size of the name buffer.
+)
+{
+    DIR* dirPtr = opendir(dirPathPtr);
+
+    if (dirPtr == NULL)
+    {
+        return 0;
+    }
+
+    size_t numFiles = 0;
+    time_t foundTime = 0;
+    struct dirent* entryPtr;
+
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        struct stat fileStat;
+
+        if ( (strncmp(entryPtr->d_name, prefixPtr, strlen(prefixPtr)) != 0) ||
+             (fstatat(dirfd(dirPtr), entryPtr->d_name, &fileStat, AT_SYMLINK_NOFOLLOW) != 0) ||
+             !S_ISREG(fileStat.st_mode) )
+        {
+            continue;
+        }
+
+        if ( (numFiles == 0) ||
+             (findNewest && (fileStat.st_mtime > foundTime)) ||
+             (!findNewest && (fileStat.st_mtime < foundTime)) )
+        {
+            if (le_utf8_Copy(namePtr, entryPtr->d_name, nameSize, NULL) != LE_OK)
+            {
+                continue;
+            }
+
+            foundTime = fileStat.st_mtime;
+        }
+
+        numFiles++;
+    }
+
+    closedir(dirPtr);
+
+    return numFiles;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes the oldest files of a directory whose name starts with a prefix, keeping the most recent
+ * ones.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PruneFiles
+(
+    const char* dirPathPtr,         ///< [IN] Directory.
+    const char* prefixPtr,          ///< [IN] Prefix of the file names.
+    size_t numKept                  ///< [IN] Number of files to keep.
+)
+{
+    char name[LIMIT_MAX_PATH_BYTES];
+
+    while (FindFile(dirPathPtr, prefixPtr, false, name, sizeof(name)) > numKept)
+    {
+        char path[LIMIT_MAX_PATH_BYTES];
+        snprintf(path, sizeof(path), "%s/%s", dirPathPtr, name);
+
+        if (unlink(path) != 0)
+        {
+            LE_ERROR("Could not delete '%s'.  %m.", path);
+            return;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replaces the content of the flash log directory by the content of the tmp file system log
+ * directory.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BackupRamLogs
+(
+    void
+)
+{
+    if (le_dir_RemoveRecursive(FLASH_LOG_DIR) != LE_OK)
+    {
+        LE_ERROR("Could not remove old logs in '%s'.", FLASH_LOG_DIR);
+    }
+
+    if (le_dir_MakePath(FLASH_LOG_DIR, DIR_PERMISSIONS) != LE_OK)
+    {
+        LE_ERROR("Could not create '%s'.", FLASH_LOG_DIR);
+        return;
+    }
+
+    DIR* dirPtr = opendir(RAM_LOG_DIR);
+
+    if (dirPtr == NULL)
+    {
+        return;
+    }
+
+    struct dirent* entryPtr;
+
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        if (entryPtr->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        Stream_t stream = { .inFd = -1, .outFd = -1 };
+        snprintf(stream.outPath, sizeof(stream.outPath), "%s/%s", FLASH_LOG_DIR, entryPtr->d_name);
+
+        stream.inFd = openat(dirfd(dirPtr), entryPtr->d_name, O_RDONLY | O_CLOEXEC);
+
+        if ( (stream.inFd != -1) && (OpenStreamOutput(&stream, MAX_CORE_BYTES) == LE_OK) )
+        {
+            while (CopyChunk(&stream) == LE_OK)
+            {
+            }
+        }
+
+        CloseStream(&stream);
+    }
+
+    closedir(dirPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completes a capture and starts the next one, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishCapture
+(
+    Capture_t* capturePtr           ///< [IN] Capture.
+)
+{
+    LE_INFO("Saved the debug data of process '%s' in app '%s' to '%s'.",
+            capturePtr->procName, capturePtr->appName, capturePtr->logDirPtr);
+
+    if (!capturePtr->isAsync)
+    {
+        le_mem_Release(capturePtr);
+        return;
+    }
+
+    le_dls_Remove(&CaptureList, &capturePtr->link);
+    le_mem_Release(capturePtr);
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&CaptureList);
+
+    if (linkPtr != NULL)
+    {
+        StartCapture(CONTAINER_OF(linkPtr, Capture_t, link));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completes the copy of a core file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishCoreCopy
+(
+    Capture_t* capturePtr           ///< [IN] Capture.
+)
+{
+    CloseStream(&capturePtr->stream);
+
+    LE_ERROR_IF(unlink(capturePtr->corePath) != 0,
+                "Could not delete '%s'.  %m.", capturePtr->corePath);
+
+    FinishCapture(capturePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a chunk of a core file and queues the copy of the next one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CopyCoreChunk
+(
+    void* param1Ptr,                ///< [IN] Capture.
+    void* param2Ptr                 ///< [IN] Not used.
+)
+{
+    Capture_t* capturePtr = param1Ptr;
+
+    if (CopyChunk(&capturePtr->stream) == LE_OK)
+    {
+        le_event_QueueFunction(CopyCoreChunk, capturePtr, NULL);
+    }
+    else
+    {
+        FinishCoreCopy(capturePtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Saves the most recent core file of the process and deletes the older ones.  Core files are
+ * created by the kernel in the process's working directory and named core-<procName>-<time>.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SaveCore
+(
+    Capture_t* capturePtr           ///< [IN] Capture.
+)
+{
+    char homePath[LIMIT_MAX_PATH_BYTES] = "/";
+
+    if (strcmp(capturePtr->appName, "framework") != 0)
+    {
+        snprintf(homePath, sizeof(homePath), "%s/%s", APPS_CORE_DIR, capturePtr->appName);
+    }
+
+    char prefix[LIMIT_MAX_PATH_BYTES];
+    snprintf(prefix, sizeof(prefix), "core-%s-", capturePtr->procName);
+
+    char coreName[LIMIT_MAX_PATH_BYTES];
+
+    if (FindFile(homePath, prefix, true, coreName, sizeof(coreName)) == 0)
+    {
+        FinishCapture(capturePtr);
+        return;
+    }
+
+    // Drop the redundant core files.
+    DIR* dirPtr = opendir(homePath);
+
+    if (dirPtr != NULL)
+    {
+        struct dirent* entryPtr;
+
+        while ((entryPtr = readdir(dirPtr)) != NULL)
+        {
+            if ( (strncmp(entryPtr->d_name, prefix, strlen(prefix)) == 0) &&
+                 (strcmp(entryPtr->d_name, coreName) != 0) )
+            {
+                LE_ERROR_IF(unlinkat(dirfd(dirPtr), entryPtr->d_name, 0) != 0,
+                            "Could not delete core file '%s'.  %m.", entryPtr->d_name);
+            }
+        }
+
+        closedir(dirPtr);
+    }
+
+    Stream_t* streamPtr = &capturePtr->stream;
+
+    snprintf(capturePtr->corePath, sizeof(capturePtr->corePath), "%s/%s", homePath, coreName);
+    snprintf(streamPtr->outPath, sizeof(streamPtr->outPath), "%s/core-%s-%s-%ld",
+             capturePtr->logDirPtr, capturePtr->appName, capturePtr->procName,
+             (long)capturePtr->faultTime);
+
+    if (rename(capturePtr->corePath, streamPtr->outPath) == 0)
+    {
+        // A moved core file is truncated like a copied one would be.
+        struct stat coreStat;
+
+        if ( (stat(streamPtr->outPath, &coreStat) == 0) && (coreStat.st_size > MAX_CORE_BYTES) )
+        {
+            LE_WARN("'%s' truncated to %d bytes.", streamPtr->outPath, MAX_CORE_BYTES);
+            LE_ERROR_IF(truncate(streamPtr->outPath, MAX_CORE_BYTES) != 0,
+                        "Could not truncate '%s'.  %m.", streamPtr->outPath);
+        }
+
+        FinishCapture(capturePtr);
+        return;
+    }
+
+    if (errno != EXDEV)
+    {
+        LE_ERROR("Could not move '%s' to '%s'.  %m.", capturePtr->corePath, streamPtr->outPath);
+        FinishCapture(capturePtr);
+        return;
+    }
+
+    // The core file is on another file system so it must be copied.
+    streamPtr->inFd = open(capturePtr->corePath, O_RDONLY | O_CLOEXEC);
+
+    if (streamPtr->inFd == -1)
+    {
+        LE_ERROR("Could not open '%s'.  %m.", capturePtr->corePath);
+        FinishCapture(capturePtr);
+        return;
+    }
+
+    if (OpenStreamOutput(streamPtr, MAX_CORE_BYTES) != LE_OK)
+    {
+        CloseStream(streamPtr);
+        FinishCapture(capturePtr);
+        return;
+    }
+
+    if (capturePtr->isAsync)
+    {
+        le_event_QueueFunction(CopyCoreChunk, capturePtr, NULL);
+        return;
+    }
+
+    while (CopyChunk(streamPtr) == LE_OK)
+    {
+    }
+
+    FinishCoreCopy(capturePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves on to the core file once the system log is saved and logread is reaped.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckLogSaved
+(
+    Capture_t* capturePtr           ///< [IN] Capture.
+)
+{
+    if ( (capturePtr->stream.inFd == -1) && (capturePtr->logReaderPid == -1) )
+    {
+        SaveCore(capturePtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies logread's output into the system log file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogReaderHandler
+(
+    int fd,                         ///< [IN] Read end of logread's output pipe.
+    short events                    ///< [IN] Events on the pipe.
+)
+{
+    Capture_t* capturePtr = le_fdMonitor_GetContextPtr();
+
+    if (CopyChunk(&capturePtr->stream) == LE_TERMINATED)
+    {
+        le_fdMonitor_Delete(capturePtr->monitorRef);
+        capturePtr->monitorRef = NULL;
+
+        // Closing the pipe makes logread exit if the log was truncated.
+        CloseStream(&capturePtr->stream);
+
+        CheckLogSaved(capturePtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts logread with its output on a pipe.
+ *
+ * @return
+ *      The read end of the pipe if successful.
+ *      -1 if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static int StartLogReader
+(
+    Capture_t* capturePtr           ///< [IN] Capture.
+)
+{
+    int pipeFds[2];
+
+    if (pipe(pipeFds) != 0)
+    {
+        LE_ERROR("Could not create pipe.  %m.");
+        return -1;
+    }
+
+    pid_t pid = fork();
+
+    if (pid < 0)
+    {
+        LE_ERROR("Failed to fork child process.  %m.");
+        fd_Close(pipeFds[0]);
+        fd_Close(pipeFds[1]);
+        return -1;
+    }
+
+    if (pid == 0)
+    {
+        // Clear the signal mask so the child does not inherit our signal mask.
+        sigset_t sigSet;
+        LE_ASSERT(sigfillset(&sigSet) == 0);
+        LE_ASSERT(pthread_sigmask(SIG_UNBLOCK, &sigSet, NULL) == 0);
+
+        if (pipeFds[1] != STDOUT_FILENO)
+        {
+            int r;
+            do
+            {
+                r = dup2(pipeFds[1], STDOUT_FILENO);
+            }
+            while ( (r == -1)  && (errno == EINTR) );
+
+            LE_FATAL_IF(r == -1, "Failed to duplicate fd.  %m.");
+        }
+
+        // Close all non-standard fds.
+        fd_CloseAllNonStd();
+
+        execl(LOGREAD_PATH, "logread", (char*)NULL);
+
+        LE_ERROR("'%s' could not be started: %m", LOGREAD_PATH);
+        _exit(EXIT_FAILURE);
+    }
+
+    fd_Close(pipeFds[1]);
+
+    capturePtr->logReaderPid = pid;
+
+    return pipeFds[0];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Saves a dump of the system log, then the core file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SaveLog
+(
+    Capture_t* capturePtr           ///< [IN] Capture.
+)
+{
+    Stream_t* streamPtr = &capturePtr->stream;
+
+    snprintf(streamPtr->outPath, sizeof(streamPtr->outPath), "%s/syslog-%s-%s-%ld",
+             capturePtr->logDirPtr, capturePtr->appName, capturePtr->procName,
+             (long)capturePtr->faultTime);
+
+    if (OpenStreamOutput(streamPtr, MAX_LOG_BYTES) != LE_OK)
+    {
+        SaveCore(capturePtr);
+        return;
+    }
+
+    streamPtr->inFd = StartLogReader(capturePtr);
+
+    if (streamPtr->inFd == -1)
+    {
+        CloseStream(streamPtr);
+        SaveCore(capturePtr);
+        return;
+    }
+
+    if (capturePtr->isAsync)
+    {
+        fd_SetNonBlocking(streamPtr->inFd);
+
+        capturePtr->monitorRef = le_fdMonitor_Create("DebugDataLog", streamPtr->inFd,
+                                                     LogReaderHandler, POLLIN);
+        le_fdMonitor_SetContextPtr(capturePtr->monitorRef, capturePtr);
+        return;
+    }
+
+    while (CopyChunk(streamPtr) == LE_OK)
+    {
+    }
+
+    CloseStream(streamPtr);
+
+    pid_t pid;
+    do
+    {
+        pid = waitpid(capturePtr->logReaderPid, NULL, 0);
+    }
+    while ( (pid == -1) && (errno == EINTR) );
+
+    capturePtr->logReaderPid = -1;
+
+    SaveCore(capturePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a capture.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartCapture
+(
+    Capture_t* capturePtr           ///< [IN] Capture.
+)
+{
+    if (capturePtr->isAsync)
+    {
+        if (le_dir_MakePath(RAM_LOG_DIR, DIR_PERMISSIONS) != LE_OK)
+        {
+            LE_ERROR("Could not create '%s'.", RAM_LOG_DIR);
+        }
+
+        // Make room for the new files.
+        PruneFiles(RAM_LOG_DIR, "core-", MAX_KEPT_FILES);
+        PruneFiles(RAM_LOG_DIR, "syslog-", MAX_KEPT_FILES);
+    }
+    else
+    {
+        BackupRamLogs();
+    }
+
+    SaveLog(capturePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the debug data capture sub-system.
+ */
+//--------------------------------------------------------------------------------------------------
+void debugData_Init
+(
+    void
+)
+{
+    CapturePool = le_mem_CreatePool("DebugDataCaptures", sizeof(Capture_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Captures any extra data that may help indicate what contributed to the fault of a process: a
+ * dump of the system log and the most recent core file of the process.
+ *
+ * The data is saved in the tmp file system, keeping the data of the last few faults.  The capture
+ * is performed asynchronously from the event loop.
+ *
+ * If the system is about to be rebooted, the data is saved in flash instead, along with the data
+ * previously saved in the tmp file system, and the function only returns once the capture is done.
+ */
+//--------------------------------------------------------------------------------------------------
+void debugData_Capture
+(
+    const char* appNamePtr,         ///< [IN] Name of the app, or "framework".
+    const char* procNamePtr,        ///< [IN] Name of the process that faulted.
+    bool isRebooting                ///< [IN] Is the supervisor going to reboot the system?
+)
+{
+    if (!isRebooting && (le_dls_NumLinks(&CaptureList) >= MAX_PENDING_CAPTURES))
+    {
+        LE_WARN("Too many faults being captured, not saving the debug data of process '%s'.",
+                procNamePtr);
+        return;
+    }
+
+    Capture_t* capturePtr = le_mem_ForceAlloc(CapturePool);
+
+    capturePtr->link = LE_DLS_LINK_INIT;
+    LE_ASSERT(le_utf8_Copy(capturePtr->appName, appNamePtr, sizeof(capturePtr->appName), NULL)
+              == LE_OK);
+    LE_ASSERT(le_utf8_Copy(capturePtr->procName, procNamePtr, sizeof(capturePtr->procName), NULL)
+              == LE_OK);
+    capturePtr->faultTime = time(NULL);
+    capturePtr->isAsync = !isRebooting;
+    capturePtr->logDirPtr = isRebooting ? FLASH_LOG_DIR : RAM_LOG_DIR;
+    capturePtr->logReaderPid = -1;
+    capturePtr->monitorRef = NULL;
+    capturePtr->stream.inFd = -1;
+    capturePtr->stream.outFd = -1;
+
+    if (!capturePtr->isAsync)
+    {
+        StartCapture(capturePtr);
+        return;
+    }
+
+    le_dls_Queue(&CaptureList, &capturePtr->link);
+
+    // Captures are done one at a time.
+    if (le_dls_NumLinks(&CaptureList) == 1)
+    {
+        StartCapture(capturePtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles SIGCHLD for the processes started to dump the system log.  The child is reaped if it is
+ * one of them.
+ *
+ * @return
+ *      LE_OK if the child was reaped.
+ *      LE_NOT_FOUND if the child is not a process started by this module.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t debugData_SigChildHandler
+(
+    pid_t pid                       ///< [IN] Pid of the process that produced the SIGCHLD.
+)
+{
+    // Only the capture in progress may have a logread running.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&CaptureList);
+
+    if (linkPtr == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    Capture_t* capturePtr = CONTAINER_OF(linkPtr, Capture_t, link);
+
+    if (capturePtr->logReaderPid != pid)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    int status = wait_ReapChild(pid);
+
+    // logread is killed by SIGPIPE when the log is truncated.
+    LE_ERROR_IF(WIFEXITED(status) && (WEXITSTATUS(status) != EXIT_SUCCESS),
+                "Could not dump the system log, '%s' exited with code %d.",
+                LOGREAD_PATH, WEXITSTATUS(status));
+
+    capturePtr->logReaderPid = -1;
+
+    CheckLogSaved(capturePtr);
+
+    return LE_OK;
+}
@@ -0,0 +1,59 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/debugData.h
+ *
+ * API for capturing the system log and core files after a process fault.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+#ifndef LEGATO_SRC_DEBUG_DATA_INCLUDE_GUARD
+#define LEGATO_SRC_DEBUG_DATA_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the debug data capture sub-system.
+ */
+//--------------------------------------------------------------------------------------------------
+void debugData_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Captures any extra data that may help indicate what contributed to the fault of a process: a
+ * dump of the system log and the most recent core file of the process.
+ *
+ * The data is saved in the tmp file system, keeping the data of the last few faults.  The capture
+ * is performed asynchronously from the event loop.
+ *
+ * If the system is about to be rebooted, the data is saved in flash instead, along with the data
+ * previously saved in the tmp file system, and the function only returns once the capture is done.
+ */
+//--------------------------------------------------------------------------------------------------
+void debugData_Capture
+(
+    const char* appNamePtr,         ///< [IN] Name of the app, or "framework".
+    const char* procNamePtr,        ///< [IN] Name of the process that faulted.
+    bool isRebooting                ///< [IN] Is the supervisor going to reboot the system?
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles SIGCHLD for the processes started to dump the system log.  The child is reaped if it is
+ * one of them.
+ *
+ * @return
+ *      LE_OK if the child was reaped.
+ *      LE_NOT_FOUND if the child is not a process started by this module.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t debugData_SigChildHandler
+(
+    pid_t pid                       ///< [IN] Pid of the process that produced the SIGCHLD.
+);
+
+
+#endif  // LEGATO_SRC_DEBUG_DATA_INCLUDE_GUARD
@@ -24,6 +24,7 @@
 #include "killProc.h"
 #include "interfaces.h"
 #include "sysStatus.h"
+#include "debugData.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -126,6 +127,28 @@
                                                                 // NULL-terminator.
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Launch descriptor.  Caches the launch settings read from the process's config so that the config
+ * tree does not have to be read every time the process is (re)started.  The descriptor is built
+ * when the process is first started and invalidated whenever its config changes.  The configured
+ * executable path and arguments are only cached when they are not overridden, so that overridden
+ * settings are not validated.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool    isValid;                ///< true if the cached settings match the config tree.
+    bool    hasExecPath;            ///< true if args starts with the configured executable path.
+    bool    hasArgs;                ///< true if args holds the configured arguments.
+    char    priority[LIMIT_MAX_PRIORITY_NAME_BYTES];    ///< Configured priority.
+    le_sls_List_t envVars;          ///< Configured environment variables.
+    le_sls_List_t args;             ///< Configured executable path and/or arguments.
+    le_cfg_ChangeHandlerRef_t cfgChangeRef; ///< Handler that invalidates this descriptor.
+}
+LaunchDesc_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The process object.
@@ -154,6 +177,7 @@ typedef struct proc_Ref
     proc_BlockCallback_t  blockCallback;  ///< Callback function to indicate when the process is
                                           ///  has been blocked after the fork but before the exec.
     void* blockContextPtr;          ///< Context pointer for the blockCallback.
+    LaunchDesc_t launchDesc;        ///< Cached launch settings from the config tree.
 }
 Process_t;
 
@@ -203,6 +227,14 @@ static le_mem_PoolRef_t PriorityPool;
 static le_mem_PoolRef_t ArgsPool;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for environment variables.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t EnvVarPool;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Nice level definitions for the different Legato priority levels.
@@ -222,6 +254,7 @@ typedef struct
 {
     char            name[LIMIT_MAX_ENV_VAR_NAME_BYTES];     // The variable name.
     char            value[LIMIT_MAX_PATH_BYTES];            // The variable value.
+    le_sls_Link_t   link;                                   // Link in a list of variables.
 }
 EnvVar_t;
 
@@ -260,6 +293,7 @@ void proc_Init
     PathPool = le_mem_CreatePool("Paths", LIMIT_MAX_PATH_BYTES);
     PriorityPool = le_mem_CreatePool("Priority", LIMIT_MAX_PRIORITY_NAME_BYTES);
     ArgsPool = le_mem_CreatePool("Args", sizeof(Arg_t));
+    EnvVarPool = le_mem_CreatePool("EnvVars", sizeof(EnvVar_t));
 }
 
 
@@ -345,10 +379,52 @@ proc_Ref_t proc_Create
     procPtr->blockCallback = NULL;
     procPtr->blockContextPtr = NULL;
 
+    procPtr->launchDesc.isValid = false;
+    procPtr->launchDesc.hasExecPath = false;
+    procPtr->launchDesc.hasArgs = false;
+    procPtr->launchDesc.envVars = LE_SLS_LIST_INIT;
+    procPtr->launchDesc.args = LE_SLS_LIST_INIT;
+    procPtr->launchDesc.cfgChangeRef = NULL;
+
     return procPtr;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases the settings cached in the process's launch descriptor and marks it invalid.  The config
+ * change handler is left registered.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearLaunchDesc
+(
+    proc_Ref_t procRef              ///< [IN] The process reference.
+)
+{
+    procRef->launchDesc.isValid = false;
+    procRef->launchDesc.hasExecPath = false;
+    procRef->launchDesc.hasArgs = false;
+
+    le_sls_Link_t* linkPtr = le_sls_Pop(&(procRef->launchDesc.envVars));
+
+    while (linkPtr != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, EnvVar_t, link));
+
+        linkPtr = le_sls_Pop(&(procRef->launchDesc.envVars));
+    }
+
+    linkPtr = le_sls_Pop(&(procRef->launchDesc.args));
+
+    while (linkPtr != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, Arg_t, link));
+
+        linkPtr = le_sls_Pop(&(procRef->launchDesc.args));
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Delete the process object.
@@ -364,6 +440,14 @@ void proc_Delete
     // Delete arguments override list.
     proc_ClearArgs(procRef);
 
+    // Delete the cached launch settings.
+    if (procRef->launchDesc.cfgChangeRef != NULL)
+    {
+        le_cfg_RemoveChangeHandler(procRef->launchDesc.cfgChangeRef);
+    }
+
+    ClearLaunchDesc(procRef);
+
     // Close any open file descriptors.
     if (procRef->stdInFd != -1)
     {
@@ -509,8 +593,7 @@ static void SetSchedulingPriority
     proc_Ref_t procRef      ///< [IN] The process to set the priority for.
 )
 {
-    char priorStr[LIMIT_MAX_PRIORITY_NAME_BYTES] = "medium";
-    char* priorStrPtr = priorStr;
+    const char* priorStrPtr = "medium";
 
     if (procRef->priorityPtr != NULL)
     {
@@ -518,17 +601,8 @@ static void SetSchedulingPriority
     }
     else if (procRef->cfgPathPtr != NULL)
     {
-        // Read the priority setting from the config tree.
-        le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(procRef->cfgPathPtr);
-
-        if (le_cfg_GetString(procCfg, CFG_NODE_PRIORITY, priorStr, sizeof(priorStr), "medium") != LE_OK)
-        {
-            LE_CRIT("Priority string for process %s is too long.  Using default priority.", procRef->namePtr);
-
-            LE_ASSERT(le_utf8_Copy(priorStr, "medium", sizeof(priorStr), NULL) == LE_OK);
-        }
-
-        le_cfg_CancelTxn(procCfg);
+        // Use the priority setting cached from the config tree.
+        priorStrPtr = procRef->launchDesc.priority;
     }
 
     if (SetProcPriority(priorStrPtr, procRef->pid) != LE_OK)
@@ -540,66 +614,263 @@ static void SetSchedulingPriority
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets the environment variable from the list of environment variables in the config tree.
+ * Called by the config tree when the process's config has changed.  Invalidates the process's
+ * launch descriptor so that it is read again from the config tree on the next start.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LaunchDescChangeHandler
+(
+    void* contextPtr                ///< [IN] The process reference.
+)
+{
+    proc_Ref_t procRef = contextPtr;
+
+    LE_DEBUG("Config for process '%s' changed.", procRef->namePtr);
+
+    ClearLaunchDesc(procRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the priority from the config tree into the process's launch descriptor.  The default
+ * priority is used if the configured priority cannot be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadPriority
+(
+    proc_Ref_t procRef,             ///< [IN] The process reference.
+    le_cfg_IteratorRef_t procCfg    ///< [IN] Iterator at the process's config node.
+)
+{
+    char* priorStr = procRef->launchDesc.priority;
+
+    if (le_cfg_GetString(procCfg, CFG_NODE_PRIORITY, priorStr, LIMIT_MAX_PRIORITY_NAME_BYTES,
+                         "medium") != LE_OK)
+    {
+        LE_CRIT("Priority string for process %s is too long.  Using default priority.",
+                procRef->namePtr);
+
+        LE_ASSERT(le_utf8_Copy(priorStr, "medium", LIMIT_MAX_PRIORITY_NAME_BYTES, NULL) == LE_OK);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the executable path and/or the command line arguments from the config tree into the
+ * process's launch descriptor.  The executable path is the first element of the config list, and
+ * of the descriptor's list if it is read.  Only the elements that are read are checked.  The
+ * iterator is moved back to the process's config node afterwards.
  *
  * @return
- *      The number of environment variables read from the config tree if successful.
+ *      LE_OK if successful.
  *      LE_FAULT if there was an error.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetEnvironmentVariables
+static le_result_t ReadArgs
 (
-    proc_Ref_t procRef,     ///< [IN] The process to get the environment variables for.
-    EnvVar_t envVars[],     ///< [IN] The list of environment variables.
-    size_t maxNumEnvVars    ///< [IN] The maximum number of items envVars can hold.
+    proc_Ref_t procRef,             ///< [IN] The process reference.
+    le_cfg_IteratorRef_t procCfg,   ///< [IN] Iterator at the process's config node.
+    bool readExecPath,              ///< [IN] Read the executable path.
+    bool readArgs                   ///< [IN] Read the arguments following the executable path.
 )
 {
-    int numEnvVars = 0;
+    le_cfg_GoToNode(procCfg, CFG_NODE_ARGS);
 
-    if (procRef->cfgPathPtr != NULL)
+    if (le_cfg_GoToFirstChild(procCfg) != LE_OK)
     {
-        le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(procRef->cfgPathPtr);
-        le_cfg_GoToNode(procCfg, CFG_NODE_ENV_VARS);
+        LE_ERROR("No arguments for process '%s'.", procRef->namePtr);
+        return LE_FAULT;
+    }
 
-        if (le_cfg_GoToFirstChild(procCfg) != LE_OK)
-        {
-            LE_WARN("No environment variables for process '%s'.", procRef->namePtr);
+    if (readExecPath)
+    {
+        // Queue the argument first so that it is released with the descriptor on error.
+        Arg_t* argPtr = le_mem_ForceAlloc(ArgsPool);
+        argPtr->link = LE_SLS_LINK_INIT;
 
-            le_cfg_CancelTxn(procCfg);
-            return 0;
+        le_sls_Queue(&(procRef->launchDesc.args), &(argPtr->link));
+
+        if (le_cfg_GetString(procCfg, "", argPtr->argument,
+                             LIMIT_MAX_ARGS_STR_BYTES, "") != LE_OK)
+        {
+            LE_ERROR("Argument too long '%s...' for process '%s'.",
+                     argPtr->argument,
+                     procRef->namePtr);
+            return LE_FAULT;
         }
 
-        int i = 0;
-        for (i = 0; i < maxNumEnvVars; i++)
+        procRef->launchDesc.hasExecPath = true;
+    }
+
+    if (readArgs)
+    {
+        size_t numArgs = readExecPath ? 1 : 0;
+
+        while (le_cfg_GoToNextSibling(procCfg) == LE_OK)
         {
-            if ( (le_cfg_GetNodeName(procCfg, "", envVars[i].name, LIMIT_MAX_ENV_VAR_NAME_BYTES) != LE_OK) ||
-                 (le_cfg_GetString(procCfg, "", envVars[i].value, LIMIT_MAX_PATH_BYTES, "") != LE_OK) )
+            if (numArgs >= LIMIT_MAX_NUM_CMD_LINE_ARGS)
             {
-                LE_ERROR("Error reading environment variables for process '%s'.", procRef->namePtr);
-
-                le_cfg_CancelTxn(procCfg);
+                LE_ERROR("Too many arguments for process '%s'.", procRef->namePtr);
                 return LE_FAULT;
             }
 
-            if (le_cfg_GoToNextSibling(procCfg) != LE_OK)
+            if (le_cfg_IsEmpty(procCfg, ""))
             {
-                break;
+                LE_ERROR("Empty node in argument list for process '%s'.", procRef->namePtr);
+                return LE_FAULT;
             }
-            else if (i >= maxNumEnvVars-1)
-            {
-                LE_ERROR("There were too many environment variables for process '%s'.", procRef->namePtr);
 
-                le_cfg_CancelTxn(procCfg);
+            Arg_t* argPtr = le_mem_ForceAlloc(ArgsPool);
+            argPtr->link = LE_SLS_LINK_INIT;
+
+            le_sls_Queue(&(procRef->launchDesc.args), &(argPtr->link));
+
+            if (le_cfg_GetString(procCfg, "", argPtr->argument,
+                                 LIMIT_MAX_ARGS_STR_BYTES, "") != LE_OK)
+            {
+                LE_ERROR("Argument too long '%s...' for process '%s'.",
+                         argPtr->argument,
+                         procRef->namePtr);
                 return LE_FAULT;
             }
+
+            numArgs++;
         }
 
-        le_cfg_CancelTxn(procCfg);
+        procRef->launchDesc.hasArgs = true;
+    }
+
+    le_cfg_GoToNode(procCfg, "../..");
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the environment variables from the config tree into the process's launch descriptor.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadEnvironmentVariables
+(
+    proc_Ref_t procRef,             ///< [IN] The process reference.
+    le_cfg_IteratorRef_t procCfg    ///< [IN] Iterator at the process's config node.
+)
+{
+    le_cfg_GoToNode(procCfg, CFG_NODE_ENV_VARS);
 
-        numEnvVars = i + 1;
+    if (le_cfg_GoToFirstChild(procCfg) != LE_OK)
+    {
+        LE_WARN("No environment variables for process '%s'.", procRef->namePtr);
+        return LE_OK;
     }
 
-    return numEnvVars;
+    size_t numEnvVars = 0;
+
+    do
+    {
+        if (numEnvVars >= LIMIT_MAX_NUM_ENV_VARS)
+        {
+            LE_ERROR("There were too many environment variables for process '%s'.",
+                     procRef->namePtr);
+            return LE_FAULT;
+        }
+
+        // Queue the variable first so that it is released with the descriptor on error.
+        EnvVar_t* envVarPtr = le_mem_ForceAlloc(EnvVarPool);
+        envVarPtr->link = LE_SLS_LINK_INIT;
+
+        le_sls_Queue(&(procRef->launchDesc.envVars), &(envVarPtr->link));
+
+        if ( (le_cfg_GetNodeName(procCfg, "", envVarPtr->name,
+                                 LIMIT_MAX_ENV_VAR_NAME_BYTES) != LE_OK) ||
+             (le_cfg_GetString(procCfg, "", envVarPtr->value, LIMIT_MAX_PATH_BYTES, "") != LE_OK) )
+        {
+            LE_ERROR("Error reading environment variables for process '%s'.", procRef->namePtr);
+            return LE_FAULT;
+        }
+
+        numEnvVars++;
+    }
+    while (le_cfg_GoToNextSibling(procCfg) == LE_OK);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes sure the process's launch descriptor is up to date, reading the process's config in a
+ * single transaction if it is not.  The descriptor is also read again if it lacks the configured
+ * executable path or arguments while they are no longer overridden.  Processes without a config
+ * have nothing to cache.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadLaunchDesc
+(
+    proc_Ref_t procRef              ///< [IN] The process reference.
+)
+{
+    bool needExecPath = (procRef->execPathPtr == NULL);
+    bool needArgs = !procRef->argsListValid;
+
+    if (procRef->cfgPathPtr == NULL)
+    {
+        return LE_OK;
+    }
+
+    if (procRef->launchDesc.isValid)
+    {
+        if ( (procRef->launchDesc.hasExecPath || !needExecPath) &&
+             (procRef->launchDesc.hasArgs || !needArgs) )
+        {
+            return LE_OK;
+        }
+
+        ClearLaunchDesc(procRef);
+    }
+
+    // Register for changes before reading the config so that a change committed while the
+    // descriptor is built is not missed.
+    if (procRef->launchDesc.cfgChangeRef == NULL)
+    {
+        procRef->launchDesc.cfgChangeRef = le_cfg_AddChangeHandler(procRef->cfgPathPtr,
+                                                                   LaunchDescChangeHandler,
+                                                                   procRef);
+    }
+
+    le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(procRef->cfgPathPtr);
+
+    ReadPriority(procRef, procCfg);
+
+    le_result_t result = ReadArgs(procRef, procCfg, needExecPath, needArgs);
+
+    if (result == LE_OK)
+    {
+        result = ReadEnvironmentVariables(procRef, procCfg);
+    }
+
+    le_cfg_CancelTxn(procCfg);
+
+    if (result != LE_OK)
+    {
+        ClearLaunchDesc(procRef);
+        return LE_FAULT;
+    }
+
+    procRef->launchDesc.isValid = true;
+
+    return LE_OK;
 }
 
 
@@ -612,8 +883,7 @@ static le_result_t GetEnvironmentVariables
 //--------------------------------------------------------------------------------------------------
 static void SetEnvironmentVariables
 (
-    EnvVar_t envVars[],     ///< [IN] The list of environment variables.
-    int numEnvVars          ///< [IN] The number environment variables in the list.
+    le_sls_List_t* envVarsPtr   ///< [IN] The list of environment variables.
 )
 {
 #define OVER_WRITE_ENV_VAR      1
@@ -622,11 +892,16 @@ static void SetEnvironmentVariables
     LE_ASSERT(clearenv() == 0);
 
     // Set the environment variables list.
-    int i;
-    for (i = 0; i < numEnvVars; i++)
+    le_sls_Link_t* linkPtr = le_sls_Peek(envVarsPtr);
+
+    while (linkPtr != NULL)
     {
+        EnvVar_t* envVarPtr = CONTAINER_OF(linkPtr, EnvVar_t, link);
+
         // Set the environment variable, overwriting anything that was previously there.
-        LE_ASSERT(setenv(envVars[i].name, envVars[i].value, OVER_WRITE_ENV_VAR) == 0);
+        LE_ASSERT(setenv(envVarPtr->name, envVarPtr->value, OVER_WRITE_ENV_VAR) == 0);
+
+        linkPtr = le_sls_PeekNext(envVarsPtr, linkPtr);
     }
 }
 
@@ -639,24 +914,13 @@ static void SetEnvironmentVariables
  * the process name to for this process.  Subsequent elements in the list will contain command line
  * arguments for the process.  The list of arguments will be terminated by a NULL pointer.
  *
- * The arguments list will be passed out to the caller in argsPtr.
- *
- * The caller must provide a list of buffers, argsBuffers, that can be used to store the fetched
- * arguments.  Note that this buffer does not necessarily store the arguments in the correct order.
- * The caller should read argsPtr to see the proper arguments list.
- *
- * @return
- *      LE_OK if successful.
- *      LE_FAULT if there was an error.
+ * The arguments list will be passed out to the caller in argsPtr.  The list points into the
+ * process's argument overrides and launch descriptor, which must be up to date.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetArgs
+static void GetArgs
 (
     proc_Ref_t procRef,             ///< [IN] The process to get the args for.
-    char argsBuffers[LIMIT_MAX_NUM_CMD_LINE_ARGS][LIMIT_MAX_ARGS_STR_BYTES], ///< [OUT] A pointer to
-                                                                             /// an array of buffers
-                                                                             /// used to store
-                                                                             /// arguments.
     char* argsPtr[NUM_ARGS_PTRS]    ///< [OUT] An array of pointers that will point to the valid
                                     ///       arguments list.  The list is terminated by NULL.
 )
@@ -666,7 +930,6 @@ static le_result_t GetArgs
 #define INDEX_ARGS      INDEX_PROC + 1
 
     size_t ptrIndex = 0;
-    size_t bufIndex = 0;
 
     // Initialize the executable path.
     argsPtr[INDEX_EXEC] = procRef->execPathPtr;
@@ -690,89 +953,38 @@ static le_result_t GetArgs
         }
     }
 
-    // Set the executable and the args if necessary.
+    // Set the executable and the args from the config if necessary.
     if (procRef->cfgPathPtr != NULL)
     {
-        // Get a config iterator to the arguments list.
-        le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(procRef->cfgPathPtr);
-        le_cfg_GoToNode(procCfg, CFG_NODE_ARGS);
+        // The configured executable path, if cached, comes first.
+        le_sls_Link_t* argLinkPtr = le_sls_Peek(&(procRef->launchDesc.args));
 
-        if (le_cfg_GoToFirstChild(procCfg) != LE_OK)
+        if (procRef->launchDesc.hasExecPath)
         {
-            LE_ERROR("No arguments for process '%s'.", procRef->namePtr);
-            le_cfg_CancelTxn(procCfg);
-            return LE_FAULT;
-        }
-
-        // Record the executable path.
-        if (procRef->execPathPtr == NULL)
-        {
-            if (le_cfg_GetString(procCfg, "", argsBuffers[bufIndex],
-                                 LIMIT_MAX_ARGS_STR_BYTES, "") != LE_OK)
+            if (procRef->execPathPtr == NULL)
             {
-                LE_ERROR("Error reading argument '%s...' for process '%s'.",
-                         argsBuffers[bufIndex],
-                         procRef->namePtr);
-
-                le_cfg_CancelTxn(procCfg);
-                return LE_FAULT;
+                argsPtr[INDEX_EXEC] = CONTAINER_OF(argLinkPtr, Arg_t, link)->argument;
             }
 
-            argsPtr[INDEX_EXEC] = argsBuffers[bufIndex];
-            bufIndex++;
+            argLinkPtr = le_sls_PeekNext(&(procRef->launchDesc.args), argLinkPtr);
         }
 
-        // Record the arguments in the caller's list of buffers.
         if (!procRef->argsListValid)
         {
-            ptrIndex = 0;
-
-            while(1)
+            while (argLinkPtr != NULL)
             {
-                if (le_cfg_GoToNextSibling(procCfg) != LE_OK)
-                {
-                    break;
-                }
-                else if (bufIndex >= LIMIT_MAX_NUM_CMD_LINE_ARGS)
-                {
-                    LE_ERROR("Too many arguments for process '%s'.", procRef->namePtr);
-                    le_cfg_CancelTxn(procCfg);
-                    return LE_FAULT;
-                }
-
-                if (le_cfg_IsEmpty(procCfg, ""))
-                {
-                    LE_ERROR("Empty node in argument list for process '%s'.", procRef->namePtr);
-
-                    le_cfg_CancelTxn(procCfg);
-                    return LE_FAULT;
-                }
-
-                if (le_cfg_GetString(procCfg, "", argsBuffers[bufIndex],
-                                     LIMIT_MAX_ARGS_STR_BYTES, "") != LE_OK)
-                {
-                    LE_ERROR("Argument too long '%s...' for process '%s'.",
-                             argsBuffers[bufIndex],
-                             procRef->namePtr);
-
-                    le_cfg_CancelTxn(procCfg);
-                    return LE_FAULT;
-                }
-
-                // Point to the string.
-                argsPtr[INDEX_ARGS + ptrIndex] = argsBuffers[bufIndex];
+                Arg_t* argPtr = CONTAINER_OF(argLinkPtr, Arg_t, link);
+
+                argsPtr[INDEX_ARGS + ptrIndex] = argPtr->argument;
                 ptrIndex++;
-                bufIndex++;
+
+                argLinkPtr = le_sls_PeekNext(&(procRef->launchDesc.args), argLinkPtr);
             }
         }
-
-        le_cfg_CancelTxn(procCfg);
     }
 
     // Terminate the list.
     argsPtr[INDEX_ARGS + ptrIndex] = NULL;
-
-    return LE_OK;
 }
 
 
@@ -1049,42 +1261,32 @@ le_result_t proc_Start
         return LE_FAULT;
     }
 
-    // Create a pipe for parent/child synchronization.
-    int syncPipeFd[2];
-    LE_FATAL_IF(pipe(syncPipeFd) == -1, "Could not create synchronization pipe.  %m.");
-
-    // Create a pipe that can be used to block the child after the fork and initialization but
-    // before the exec() call.
-    int blockPipeFd[2] = {-1, -1};
-
-    if (procRef->blockCallback != NULL)
-    {
-        LE_FATAL_IF(pipe(blockPipeFd) == -1, "Could not create block pipe.  %m.");
-    }
-
     // @Note The current IPC system does not support forking so any reads to the config DB must be
     //       done in the parent process.
 
-    // Get the environment variables from the config tree for this process.
-    EnvVar_t envVars[LIMIT_MAX_NUM_ENV_VARS];
-    int numEnvVars = GetEnvironmentVariables(procRef, envVars, LIMIT_MAX_NUM_ENV_VARS);
-
-    if (numEnvVars == LE_FAULT)
+    // Get the launch settings for this process.  The config tree is only read if the settings
+    // changed since the process was last started.
+    if (LoadLaunchDesc(procRef) != LE_OK)
     {
-        LE_ERROR("Error getting environment variables.  Process '%s' cannot be started.",
+        LE_ERROR("Could not get launch settings, process '%s' cannot be started.",
                  procRef->namePtr);
         return LE_FAULT;
     }
 
-    // Get the command line arguments from the config tree for this process.
-    char argsBuffers[LIMIT_MAX_NUM_CMD_LINE_ARGS][LIMIT_MAX_ARGS_STR_BYTES];
     char* argsPtr[NUM_ARGS_PTRS];
+    GetArgs(procRef, argsPtr);
 
-    if (GetArgs(procRef, argsBuffers, argsPtr) != LE_OK)
+    // Create a pipe for parent/child synchronization.
+    int syncPipeFd[2];
+    LE_FATAL_IF(pipe(syncPipeFd) == -1, "Could not create synchronization pipe.  %m.");
+
+    // Create a pipe that can be used to block the child after the fork and initialization but
+    // before the exec() call.
+    int blockPipeFd[2] = {-1, -1};
+
+    if (procRef->blockCallback != NULL)
     {
-        LE_ERROR("Could not get command line arguments, process '%s' cannot be started.",
-                 procRef->namePtr);
-        return LE_FAULT;
+        LE_FATAL_IF(pipe(blockPipeFd) == -1, "Could not create block pipe.  %m.");
     }
 
     // Create pipes for the process's standard error and standard out streams.
@@ -1127,7 +1329,7 @@ le_result_t proc_Start
         LE_ASSERT(sigfillset(&sigSet) == 0);
         LE_ASSERT(pthread_sigmask(SIG_UNBLOCK, &sigSet, NULL) == 0);
 
-        SetEnvironmentVariables(envVars, numEnvVars);
+        SetEnvironmentVariables(&(procRef->launchDesc.envVars));
 
         // Setup the process environment.
         if (app_GetIsSandboxed(procRef->appRef))
@@ -1348,6 +1550,11 @@ bool proc_IsRealtime
     {
         priorStrPtr = procRef->priorityPtr;
     }
+    else if (procRef->launchDesc.isValid)
+    {
+        // Use the priority setting cached from the config tree.
+        priorStrPtr = procRef->launchDesc.priority;
+    }
     else if (procRef->cfgPathPtr != NULL)
     {
         // Read the priority setting from the config tree.
@@ -1775,45 +1982,6 @@ void proc_SetRun
 }
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Called to capture any extra data that may help indicate what contributed to the fault that caused
- * the given process to fail.
- *
- * This function calls a shell script that will save a dump of the system log and any core files
- * that have been generated into a known location.
- */
-//--------------------------------------------------------------------------------------------------
-static void CaptureDebugData
-(
-    proc_Ref_t procRef,             ///< [IN] The process reference.
-    bool isRebooting                ///< [IN] Is the supervisor going to reboot the system?
-)
-{
-    char command[LIMIT_MAX_PATH_BYTES];
-    int s = snprintf(command,
-                     sizeof(command),
-                     "/legato/systems/current/bin/saveLogs %s %s %s",
-                     app_GetName(procRef->appRef),
-                     procRef->namePtr,
-                     isRebooting ? "REBOOT" : "");
-
-    if (s >= sizeof(command))
-    {
-        LE_FATAL("Could not create command, buffer is too small.  "
-                 "Buffer is %zd bytes but needs to be %d bytes.",
-                 sizeof(command),
-                 s);
-    }
-
-    int r = system(command);
-
-    if (!WIFEXITED(r) || (WEXITSTATUS(r) != EXIT_SUCCESS))
-    {
-        LE_ERROR("Could not save log and core file.");
-    }
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the watchdog action for this process.
@@ -2001,7 +2169,7 @@ FaultAction_t proc_SigChildHandler
         // Check if we're rebooting.  If we are, this data needs to be saved in a more permanent
         // location.
         bool isRebooting = (faultAction == FAULT_ACTION_REBOOT);
-        CaptureDebugData(procRef, isRebooting);
+        debugData_Capture(app_GetName(procRef->appRef), procRef->namePtr, isRebooting);
     }
 
     return faultAction;
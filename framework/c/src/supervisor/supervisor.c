@@ -214,6 +214,7 @@
 #include "fileSystem.h"
 #include "sysStatus.h"
 #include "fileDescriptor.h"
+#include "debugData.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -406,6 +407,7 @@ static void StartFramework
     wdog_AdvertiseService();
     le_appInfo_AdvertiseService();
     le_appProc_AdvertiseService();
+    le_appStats_AdvertiseService();
 
     // Initialize the apps sub system.
     apps_Init();
@@ -526,6 +528,7 @@ static void PrepareFullShutdown
     le_msg_HideService(wdog_GetServiceRef());
     le_msg_HideService(le_appInfo_GetServiceRef());
     le_msg_HideService(le_appProc_GetServiceRef());
+    le_msg_HideService(le_appStats_GetServiceRef());
 }
 
 
@@ -591,29 +594,6 @@ static void Reboot
 }
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Called to capture any extra data that may help indicate what contributed to the fault that
- * caused the framework to fail.
- *
- * This function calls a shell script that will save a dump of the system log and any core files
- * that have been generated into a known location.
- */
-//--------------------------------------------------------------------------------------------------
-static void CaptureDebugData
-(
-    void
-)
-{
-    int r = system("/legato/systems/current/bin/saveLogs framework unknown REBOOT");
-
-    if (!WIFEXITED(r) || (WEXITSTATUS(r) != EXIT_SUCCESS))
-    {
-        LE_ERROR("Could not save log and core file.");
-    }
-}
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * The signal event handler function for SIGCHLD called from the Legato event loop.
@@ -668,13 +648,13 @@ static void SigChildHandler
 
             if (r == LE_FAULT)
             {
-                CaptureDebugData();
+                debugData_Capture("framework", "unknown", true);
                 Reboot();
             }
-            else if (r == LE_NOT_FOUND)
+            else if ( (r == LE_NOT_FOUND) && (debugData_SigChildHandler(pid) == LE_NOT_FOUND) )
             {
-                // The child is neither an application process nor a framework daemon.
-                // Reap the child now.
+                // The child is neither an application process, a framework daemon nor a process
+                // used to capture debug data.  Reap the child now.
                 LE_INFO("Reaping unconfigured child process %d.", pid);
 
                 wait_ReapChild(pid);
@@ -866,6 +846,7 @@ COMPONENT_INIT
     smack_SetRule("framework", "rw", "syslog");
 
     cgrp_Init();
+    debugData_Init();
 
     // Register a signal event handler for SIGCHLD so we know when processes die.
     le_sig_SetEventHandler(SIGCHLD, SigChildHandler);
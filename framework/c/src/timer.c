@@ -8,6 +8,7 @@
 
 #include "legato.h"
 #include "timer.h"
+#include "stats.h"
 #include "thread.h"
 #include "fileDescriptor.h"
 #include <sys/timerfd.h>
@@ -117,6 +118,8 @@ static Timer_t* CreateTimer
     timerPtr->safeRef = NULL;
     timerPtr->safeRef = le_ref_CreateRef(SafeRefMap, timerPtr);
 
+    stats_Increment(STATS_TIMERS_CREATED);
+
     return timerPtr;
 }
 
@@ -387,6 +390,7 @@ static void ProcessExpiredTimer
 
     // Keep track of the number of times the timer has expired, regardless of whether it repeats.
     expiredTimer->expiryCount++;
+    stats_Increment(STATS_TIMER_EXPIRIES);
 
     // Handle repeating timers by adding it back to the list; do this before calling the expiry
     // handler to reduce jitter.
@@ -647,6 +651,8 @@ void timer_DestructThread
         le_dls_Remove(&threadRecPtr->activeTimerList, &timerPtr->link);
 
         le_mem_Release(timerPtr);
+
+        stats_Increment(STATS_TIMERS_DELETED);
     }
 }
 
@@ -698,6 +704,8 @@ void le_timer_Delete
     }
     le_ref_DeleteRef(SafeRefMap, timerRef);
     le_mem_Release(timerPtr);
+
+    stats_Increment(STATS_TIMERS_DELETED);
 }
 
 
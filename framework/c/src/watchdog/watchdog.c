@@ -31,14 +31,21 @@
  *
  *
  * Algorithm
- * When a process kicks us, if we have no timer for it we will:
- *    create a timer,
- *    add it to our timer list and
- *    set it running with the appropriate time out (for now, that configured for the app).
- * If the timer times out before the next kick then the watchdog will
+ * When a process kicks us, if we have no watchdog for it we will:
+ *    create a watchdog,
+ *    add it to our watchdog container and
+ *    set its expiry time using the appropriate time out (for now, that configured for the app).
+ * Running watchdogs are kept in a deadline heap serviced by a single timer, which is set for the
+ * earliest deadline in the heap. A kick just stores the new expiry time in the watchdog; the heap
+ * is only updated when that deadline comes due, at which point the watchdog is either filed again
+ * under its new expiry time, or has expired. If it has expired the watchdog will
  *    attempt to alert the supervisor that the app has timed out.
  *          The supervisor can then apply the configured fault action.
- *    delist the timer and dispose of it.
+ *    delist the watchdog and dispose of it.
+ *
+ * Kicks are rate limited per client (see KICK_RATE_LIMIT), and counters of kicks, throttled kicks
+ * and missed deadlines are logged when a watchdog expires or its client goes away. A client can
+ * read them back with le_wdog_GetKickStats().
  *
  * Analysis
  *
@@ -49,11 +56,11 @@
  *         the dead process won't be around to kick the watchdog again at which time
  *         we have case 1.
  * case 3: Another race condition - the app times out and we tell the supervisor about it.
- *         We delist the timer and destroy it.
+ *         We delist the watchdog and destroy it.
  *         The supervisor kills the app but between the timeout and the supervisor acting
  *         the app sends a kick.
- *         We treat the kick as a kick from a new app and create a timer.
- *         When the timer times out we have case 1 again.
+ *         We treat the kick as a kick from a new app and create a watchdog.
+ *         When the watchdog times out we have case 1 again.
  *
  *         The analysis assumes that the time between timeouts is significantly shorter
  *         than the time expected before pIDs are re-used.
@@ -128,6 +135,37 @@
 //--------------------------------------------------------------------------------------------------
 #define TIMEOUT_KICK -3
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expiry time of a watchdog that never times out.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define EXPIRY_NEVER UINT64_MAX
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * heapIndex of a watchdog that is not in the deadline heap.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define NOT_IN_HEAP SIZE_MAX
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kick rate limit: at most this many kicks per timeout interval are applied for a client. Kicks
+ * that come sooner than (timeout / KICK_RATE_LIMIT) after the last applied one are only counted.
+ * This bounds the work done for a client that kicks in a tight loop, at the cost of letting its
+ * watchdog expire at most 1/KICK_RATE_LIMIT of the timeout earlier than it otherwise would.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define KICK_RATE_LIMIT 20
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of deadline heap slots added whenever the heap runs out of room.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define DEADLINE_HEAP_CHUNK 16
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Definition of Watchdog object, pool for allocation of watchdogs and container for organizing and
@@ -138,8 +176,14 @@ typedef struct
 {
     pid_t procId;                       ///< The unique value by which to find this watchdog
     uid_t appId;                        ///< The id of the app it belongs to
-    le_clk_Time_t kickTimeoutInterval;  ///< Default timeout for this watchdog
-    le_timer_Ref_t timer;               ///< The timer this watchdog uses
+    uint32_t kickTimeoutMs;             ///< Default timeout for this watchdog (in milliseconds)
+    uint64_t expiryMs;                  ///< When the watchdog expires, or EXPIRY_NEVER
+    uint64_t heapKeyMs;                 ///< Deadline this watchdog is filed under in the heap
+    size_t heapIndex;                   ///< Position in the deadline heap, or NOT_IN_HEAP
+    uint64_t firstKickMs;               ///< When the first kick was received
+    uint64_t lastKickMs;                ///< When the last applied kick was received
+    uint32_t numKicks;                  ///< Number of kicks received
+    uint32_t numThrottledKicks;         ///< Number of kicks ignored because of the rate limit
 }
 WatchdogObj_t;
 
@@ -148,8 +192,255 @@ static le_hashmap_Ref_t WatchdogRefsContainer;  ///< The container we use to kee
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove the watchdog from our container, free the timer it contains and then free the storage
- * we allocated to hold the watchdog structure.
+ * Deadline heap. A binary min-heap of all watchdogs that may expire, ordered by heapKeyMs. The
+ * single ExpiryTimer is armed for the deadline at the top of the heap.
+ *
+ * A kick only stores the watchdog's new expiry time. Because kicks only ever push the expiry time
+ * later, the heap key is allowed to lag behind it: when the key comes due, the watchdog is either
+ * re-filed under its real expiry time or, if that has passed too, expired. This way the heap and
+ * the timer are touched about once per timeout interval per client instead of once per kick.
+ */
+//--------------------------------------------------------------------------------------------------
+static WatchdogObj_t** DeadlineHeap = NULL;
+static size_t DeadlineHeapSize = 0;             ///< Number of watchdogs in the heap
+static size_t DeadlineHeapCapacity = 0;         ///< Number of slots allocated for the heap
+
+static le_timer_Ref_t ExpiryTimer;              ///< The one timer used for all watchdogs
+static uint64_t ArmedExpiryMs = EXPIRY_NEVER;   ///< When ExpiryTimer is set to go off
+
+static uint64_t NumKicks = 0;                   ///< Total kicks received
+static uint64_t NumThrottledKicks = 0;          ///< Total kicks ignored by the rate limit
+static uint32_t NumMissedDeadlines = 0;         ///< Total watchdogs that timed out
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time on the relative clock.
+ *
+ * @return The number of milliseconds since an arbitrary point in the past.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetNowMs
+(
+    void
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    return ((uint64_t)now.sec * 1000) + (now.usec / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Construct le_clk_Time_t object that will give an interval of the provided number
+ *  of milliseconds.
+ *
+ *      @return the constructed le_clk_Time_t
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t MakeTimerInterval
+(
+    uint32_t milliseconds
+)
+{
+    le_clk_Time_t interval;
+
+    interval.sec = milliseconds / 1000;
+    interval.usec = (milliseconds * 1000) - (interval.sec * 1000000);
+
+    return interval;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put a watchdog in a slot of the deadline heap.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetHeapSlot
+(
+    size_t index,               ///< [IN] The slot
+    WatchdogObj_t* dogPtr       ///< [IN] The watchdog to put there
+)
+{
+    DeadlineHeap[index] = dogPtr;
+    dogPtr->heapIndex = index;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move a watchdog up the deadline heap until its parent is due no later than it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SiftUp
+(
+    size_t index    ///< [IN] Slot of the watchdog to move
+)
+{
+    WatchdogObj_t* dogPtr = DeadlineHeap[index];
+
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+
+        if (DeadlineHeap[parent]->heapKeyMs <= dogPtr->heapKeyMs)
+        {
+            break;
+        }
+
+        SetHeapSlot(index, DeadlineHeap[parent]);
+        index = parent;
+    }
+
+    SetHeapSlot(index, dogPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move a watchdog down the deadline heap until its children are due no earlier than it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SiftDown
+(
+    size_t index    ///< [IN] Slot of the watchdog to move
+)
+{
+    WatchdogObj_t* dogPtr = DeadlineHeap[index];
+
+    for (;;)
+    {
+        size_t child = (2 * index) + 1;
+
+        if (child >= DeadlineHeapSize)
+        {
+            break;
+        }
+
+        if (   (child + 1 < DeadlineHeapSize)
+            && (DeadlineHeap[child + 1]->heapKeyMs < DeadlineHeap[child]->heapKeyMs) )
+        {
+            child++;
+        }
+
+        if (dogPtr->heapKeyMs <= DeadlineHeap[child]->heapKeyMs)
+        {
+            break;
+        }
+
+        SetHeapSlot(index, DeadlineHeap[child]);
+        index = child;
+    }
+
+    SetHeapSlot(index, dogPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a watchdog to the deadline heap, filed under its current expiry time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToHeap
+(
+    WatchdogObj_t* dogPtr   ///< [IN] The watchdog, which must not be in the heap
+)
+{
+    if (DeadlineHeapSize == DeadlineHeapCapacity)
+    {
+        DeadlineHeapCapacity += DEADLINE_HEAP_CHUNK;
+        DeadlineHeap = realloc(DeadlineHeap, DeadlineHeapCapacity * sizeof(DeadlineHeap[0]));
+        LE_ASSERT(DeadlineHeap != NULL);
+    }
+
+    dogPtr->heapKeyMs = dogPtr->expiryMs;
+    SetHeapSlot(DeadlineHeapSize, dogPtr);
+    DeadlineHeapSize++;
+    SiftUp(dogPtr->heapIndex);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a watchdog out of the deadline heap. Does nothing if it isn't in the heap.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveFromHeap
+(
+    WatchdogObj_t* dogPtr   ///< [IN] The watchdog
+)
+{
+    size_t index = dogPtr->heapIndex;
+
+    if (index == NOT_IN_HEAP)
+    {
+        return;
+    }
+
+    dogPtr->heapIndex = NOT_IN_HEAP;
+    DeadlineHeapSize--;
+
+    if (index < DeadlineHeapSize)
+    {
+        // Fill the hole with the last watchdog, which may need to go either way from there.
+        WatchdogObj_t* movedDogPtr = DeadlineHeap[DeadlineHeapSize];
+
+        SetHeapSlot(index, movedDogPtr);
+        SiftUp(index);
+        SiftDown(movedDogPtr->heapIndex);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make sure the expiry timer goes off at the deadline at the top of the heap. The timer is only
+ * touched if that deadline has changed since it was last armed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ArmExpiryTimer
+(
+    void
+)
+{
+    uint64_t nextExpiryMs = (DeadlineHeapSize > 0) ? DeadlineHeap[0]->heapKeyMs : EXPIRY_NEVER;
+
+    if (nextExpiryMs == ArmedExpiryMs)
+    {
+        return;
+    }
+
+    le_timer_Stop(ExpiryTimer);
+    ArmedExpiryMs = nextExpiryMs;
+
+    if (nextExpiryMs != EXPIRY_NEVER)
+    {
+        uint64_t nowMs = GetNowMs();
+        uint32_t intervalMs = (nextExpiryMs > nowMs) ? (uint32_t)(nextExpiryMs - nowMs) : 0;
+
+        LE_ASSERT(LE_OK == le_timer_SetInterval(ExpiryTimer, MakeTimerInterval(intervalMs)));
+        le_timer_Start(ExpiryTimer);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log a watchdog's kick counters.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogKickStats
+(
+    const WatchdogObj_t* dogPtr     ///< [IN] The watchdog
+)
+{
+    uint64_t elapsedMs = dogPtr->lastKickMs - dogPtr->firstKickMs;
+
+    LE_INFO("proc %d: %u kicks (%u throttled) over %" PRIu64 " ms, %" PRIu64 " kicks/min",
+            dogPtr->procId,
+            dogPtr->numKicks,
+            dogPtr->numThrottledKicks,
+            elapsedMs,
+            (elapsedMs > 0) ? ((uint64_t)dogPtr->numKicks * 60000 / elapsedMs) : 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the watchdog from our container and the deadline heap and then free the storage we
+ * allocated to hold the watchdog structure.
  */
 //--------------------------------------------------------------------------------------------------
 static void DeleteWatchdog
@@ -162,7 +453,8 @@ static void DeleteWatchdog
     {
         // All good. The dog was in the hash
         LE_DEBUG("Cleaning up watchdog resources for %d", deadDogPtr->procId);
-        le_timer_Delete(deadDogPtr->timer);
+        LogKickStats(deadDogPtr);
+        RemoveFromHeap(deadDogPtr);
         le_mem_Release(deadDogPtr);
     }
     else
@@ -227,7 +519,7 @@ static WatchdogObj_t* LookupClientWatchdogPtrById
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The handler for all time outs. No registered application wants to see us get here.
+ * Handle a watchdog that has timed out. No registered application wants to see us get here.
  * Arrival here means that some process has failed to service its watchdog and therefore,
  * we need to tattle to the supervisor who, if the app still exists, will deal with it
  * in the manner proscribed in the book of config.
@@ -236,54 +528,69 @@ static WatchdogObj_t* LookupClientWatchdogPtrById
 //--------------------------------------------------------------------------------------------------
 static void WatchdogHandleExpiry
 (
-    le_timer_Ref_t timerRef ///< [IN] The reference to the expired timer
+    WatchdogObj_t* expiredDog ///< [IN] The watchdog that has expired
 )
 {
     char appName[LIMIT_MAX_APP_NAME_BYTES];
-    pid_t procId = (intptr_t)le_timer_GetContextPtr(timerRef);
-    WatchdogObj_t* expiredDog = LookupClientWatchdogPtrById(procId);
-    if (expiredDog != NULL)
-    {
-        uid_t appId = expiredDog->appId;
+    pid_t procId = expiredDog->procId;
+    uid_t appId = expiredDog->appId;
 
+    NumMissedDeadlines++;
 
-        if (LE_OK == le_appInfo_GetName(procId, appName, sizeof(appName) ))
-        {
-            LE_CRIT("app %s, proc %d timed out", appName, procId);
-        }
-        else
-        {
-            LE_CRIT("app %d, proc %d timed out", appId, procId);
-        }
-
-        DeleteWatchdog(procId);
-        wdog_WatchdogTimedOut(appId, procId);
+    if (LE_OK == le_appInfo_GetName(procId, appName, sizeof(appName) ))
+    {
+        LE_CRIT("app %s, proc %d timed out", appName, procId);
     }
     else
     {
-        LE_CRIT("Processing watchdog timeout for proc %d but watchdog already freed.", procId);
+        LE_CRIT("app %d, proc %d timed out", appId, procId);
     }
+
+    LE_INFO("%u watchdog deadlines missed so far, %" PRIu64 " kicks received (%" PRIu64
+            " throttled)", NumMissedDeadlines, NumKicks, NumThrottledKicks);
+
+    DeleteWatchdog(procId);
+    wdog_WatchdogTimedOut(appId, procId);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Construct le_clk_Time_t object that will give an interval of the provided number
- *  of milliseconds.
- *
- *      @return the constructed le_clk_Time_t
+ * The handler for the expiry timer. Checks all the watchdogs that have come due since the last
+ * time, re-filing those that have been kicked meanwhile and expiring the others, then re-arms the
+ * timer for the next deadline.
  */
 //--------------------------------------------------------------------------------------------------
-static le_clk_Time_t MakeTimerInterval
+static void ExpiryTimerHandler
 (
-    uint32_t milliseconds
+    le_timer_Ref_t timerRef ///< [IN] The reference to the expired timer
 )
 {
-    le_clk_Time_t interval;
+    uint64_t nowMs = GetNowMs();
 
-    interval.sec = milliseconds / 1000;
-    interval.usec = (milliseconds * 1000) - (interval.sec * 1000000);
+    ArmedExpiryMs = EXPIRY_NEVER;
 
-    return interval;
+    while ((DeadlineHeapSize > 0) && (DeadlineHeap[0]->heapKeyMs <= nowMs))
+    {
+        WatchdogObj_t* dogPtr = DeadlineHeap[0];
+
+        if (dogPtr->expiryMs <= nowMs)
+        {
+            RemoveFromHeap(dogPtr);
+            WatchdogHandleExpiry(dogPtr);
+        }
+        else if (dogPtr->expiryMs == EXPIRY_NEVER)
+        {
+            RemoveFromHeap(dogPtr);
+        }
+        else
+        {
+            // Kicked since it was filed. File it again under its real expiry time.
+            dogPtr->heapKeyMs = dogPtr->expiryMs;
+            SiftDown(0);
+        }
+    }
+
+    ArmExpiryTimer();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -351,10 +658,10 @@ static le_result_t GetProcessNameFromPid
  * is not found, read the configured timeout for the application this process belongs to.
  *
  * @return
- *      A le_clk_Time_t struct representing the configured timeout interval
+ *      The configured timeout interval in milliseconds
  */
 //--------------------------------------------------------------------------------------------------
-static le_clk_Time_t GetConfigKickTimeoutInterval
+static uint32_t GetConfigKickTimeoutMs
 (
     pid_t procId,  ///< The process id of the client
     uid_t appId    ///< The user id of the application
@@ -424,15 +731,16 @@ static le_clk_Time_t GetConfigKickTimeoutInterval
         LE_WARN("Unknown app with pid %d requested watchdog - using default timeout %d ms", procId,
           proc_milliseconds);
     }
-    return MakeTimerInterval(proc_milliseconds);
+    return proc_milliseconds;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Allocate a new watchdog object and "construct" it.
+ * Allocate a new watchdog object and "construct" it. The watchdog isn't running until it is
+ * kicked.
  *
  * @return
- *      A pointer to a new Watchdog object containing an initialized timer
+ *      A pointer to a new Watchdog object
  */
 //--------------------------------------------------------------------------------------------------
 static WatchdogObj_t* CreateNewWatchdog
@@ -441,18 +749,18 @@ static WatchdogObj_t* CreateNewWatchdog
     uid_t appId       ///< the user id of the client
 )
 {
-    char timerName[LIMIT_MAX_TIMER_NAME_BYTES];
-
     LE_DEBUG("Making a new dog");
     WatchdogObj_t* newDogPtr = le_mem_ForceAlloc(WatchdogPool);
     newDogPtr->procId = clientPid;
     newDogPtr->appId = appId;
-    newDogPtr->kickTimeoutInterval = GetConfigKickTimeoutInterval(clientPid, appId);
-    LE_ASSERT(0 <= snprintf(timerName, sizeof(timerName), "wdog_u%d:p%d", clientPid, appId));
-    newDogPtr->timer = le_timer_Create(timerName);
-    _Static_assert (sizeof(pid_t) <= sizeof(intptr_t), "pid_t is truncated by cast to void*");
-    LE_ASSERT(LE_OK == le_timer_SetContextPtr(newDogPtr->timer, (void*)((intptr_t)clientPid)));
-    LE_ASSERT(LE_OK == le_timer_SetHandler(newDogPtr->timer, WatchdogHandleExpiry));
+    newDogPtr->kickTimeoutMs = GetConfigKickTimeoutMs(clientPid, appId);
+    newDogPtr->expiryMs = EXPIRY_NEVER;
+    newDogPtr->heapKeyMs = EXPIRY_NEVER;
+    newDogPtr->heapIndex = NOT_IN_HEAP;
+    newDogPtr->firstKickMs = GetNowMs();
+    newDogPtr->lastKickMs = newDogPtr->firstKickMs;
+    newDogPtr->numKicks = 0;
+    newDogPtr->numThrottledKicks = 0;
     return newDogPtr;
 }
 
@@ -503,31 +811,60 @@ static void ResetClientWatchdog
     int32_t timeout ///< [IN] The timeout to reset the watchdog timer to (in milliseconds).
 )
 {
-    le_clk_Time_t timeoutValue;
     WatchdogObj_t* watchDogPtr = GetClientWatchdogPtr();
     if (watchDogPtr != NULL)
     {
-        le_timer_Stop(watchDogPtr->timer);
+        uint64_t nowMs = GetNowMs();
+
+        NumKicks++;
+        watchDogPtr->numKicks++;
+
         if (timeout == TIMEOUT_KICK)
         {
-            timeoutValue = watchDogPtr->kickTimeoutInterval;
+            // Apply the rate limit. Only kicks that would merely move a deadline set by a previous
+            // kick are throttled; kicks that revert a le_wdog_Timeout() always take effect.
+            if (   (watchDogPtr->expiryMs == watchDogPtr->lastKickMs + watchDogPtr->kickTimeoutMs)
+                && ((nowMs - watchDogPtr->lastKickMs)
+                        < (watchDogPtr->kickTimeoutMs / KICK_RATE_LIMIT)) )
+            {
+                NumThrottledKicks++;
+                watchDogPtr->numThrottledKicks++;
+                return;
+            }
+
+            timeout = watchDogPtr->kickTimeoutMs;
         }
-        else
+
+        watchDogPtr->lastKickMs = nowMs;
+
+        if (timeout == LE_WDOG_TIMEOUT_NEVER)
         {
-            timeoutValue = MakeTimerInterval(timeout);
+            // Leave it in the heap, if it is there; it will be dropped when its key comes due.
+            LE_DEBUG("Timeout set to NEVER!");
+            watchDogPtr->expiryMs = EXPIRY_NEVER;
+            return;
         }
 
-        if (timeout != LE_WDOG_TIMEOUT_NEVER)
+        watchDogPtr->expiryMs = nowMs + (uint32_t)timeout;
+
+        if (watchDogPtr->heapIndex == NOT_IN_HEAP)
+        {
+            AddToHeap(watchDogPtr);
+        }
+        else if (watchDogPtr->expiryMs < watchDogPtr->heapKeyMs)
         {
-            // timer should be stopped here so this should never fail
-            // testing
-            LE_ASSERT(LE_OK == le_timer_SetInterval(watchDogPtr->timer, timeoutValue));
-            le_timer_Start(watchDogPtr->timer);
+            // The deadline has been brought forward (by le_wdog_Timeout()), so it must be re-filed
+            // now. Later deadlines are picked up lazily by ExpiryTimerHandler().
+            watchDogPtr->heapKeyMs = watchDogPtr->expiryMs;
+            SiftUp(watchDogPtr->heapIndex);
         }
         else
         {
-            LE_DEBUG("Timeout set to NEVER!");
+            // The common case: just the store above.
+            return;
         }
+
+        ArmExpiryTimer();
     }
 }
 
@@ -564,6 +901,49 @@ void le_wdog_Kick
     ResetClientWatchdog(TIMEOUT_KICK);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the kick counters of the client's watchdog, and the number of deadlines missed by all the
+ * watchdogs.
+ *
+ * @return
+ *      - LE_OK on success.
+ *      - LE_NOT_FOUND if the client has no watchdog, its kick counters are set to 0.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wdog_GetKickStats
+(
+    uint32_t* kickCountPtr,         ///< [OUT] Number of kicks received.
+    uint32_t* throttledCountPtr,    ///< [OUT] Number of kicks ignored by the rate limit.
+    uint32_t* missedCountPtr        ///< [OUT] Number of deadlines missed by all the watchdogs.
+)
+{
+    uid_t clientUserId;
+    pid_t clientProcId;
+    WatchdogObj_t* watchDogPtr = NULL;
+
+    *kickCountPtr = 0;
+    *throttledCountPtr = 0;
+    *missedCountPtr = NumMissedDeadlines;
+
+    if (LE_OK == le_msg_GetClientUserCreds(le_wdog_GetClientSessionRef(),
+                                           &clientUserId,
+                                           &clientProcId))
+    {
+        watchDogPtr = LookupClientWatchdogPtrById(clientProcId);
+    }
+
+    if (watchDogPtr == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    *kickCountPtr = watchDogPtr->numKicks;
+    *throttledCountPtr = watchDogPtr->numThrottledKicks;
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Signal to the supervisor that we are set up and ready
@@ -589,7 +969,8 @@ static void SystemProcessNotifySupervisor
 //--------------------------------------------------------------------------------------------------
 /**
  * Create the memory pool to allocate watchdog objects from and the container to store them in
- * so we can find the ones we want when we want them. Currently that's a hashmap.
+ * so we can find the ones we want when we want them. Currently that's a hashmap. Also create the
+ * timer that services the deadline heap.
  *
  * @return
  *      LE_OK the timer container was successfully initiated
@@ -610,6 +991,8 @@ static le_result_t InitializeTimerContainer
                          le_hashmap_EqualsUInt32
                        );
     LE_ASSERT(WatchdogRefsContainer != NULL);
+    ExpiryTimer = le_timer_Create("wdog_expiryTimer");
+    LE_ASSERT(LE_OK == le_timer_SetHandler(ExpiryTimer, ExpiryTimerHandler));
     return LE_OK;
 }
 
@@ -11,6 +11,7 @@
 package io.legato;
 
 import java.io.FileDescriptor;
+import java.nio.ByteBuffer;
 
 
 
@@ -81,6 +82,7 @@ class LegatoJni
     public static native void Respond(long messageRef);
     public static native boolean NeedsResponse(long messageRef);
     public static native int GetMaxPayloadSize(long messageRef);
+    public static native ByteBuffer GetPayloadBuffer(long messageRef);
     public static native long GetSession(long messageRef);
 
     public static native FileDescriptor GetMessageFd(long messageRef);
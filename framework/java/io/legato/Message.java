@@ -11,6 +11,8 @@
 package io.legato;
 
 import java.io.FileDescriptor;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 
 
 
@@ -28,6 +30,12 @@ public class Message implements AutoCloseable
      */
     private long messageRef;
 
+    /**
+     *  Direct buffer view of the message payload, fetched from the native side the first time the
+     *  payload is accessed.
+     */
+    private ByteBuffer payload;
+
     //----------------------------------------------------------------------------------------------
     /**
      *  Package private way to construct a Message from a native reference.
@@ -53,6 +61,8 @@ public class Message implements AutoCloseable
             LegatoJni.ReleaseMessage(messageRef);
             messageRef = 0;
         }
+
+        payload = null;
     }
 
     //----------------------------------------------------------------------------------------------
@@ -73,6 +83,7 @@ public class Message implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void send()
     {
+        payload = null;
         LegatoJni.Send(messageRef);
     }
 
@@ -86,6 +97,7 @@ public class Message implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public Message requestResponse()
     {
+        payload = null;
         return new Message(LegatoJni.RequestSyncResponse(messageRef));
     }
 
@@ -96,6 +108,7 @@ public class Message implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void respond()
     {
+        payload = null;
         LegatoJni.Respond(messageRef);
     }
 
@@ -159,6 +172,32 @@ public class Message implements AutoCloseable
         return new MessageBuffer(this);
     }
 
+    //----------------------------------------------------------------------------------------------
+    /**
+     *  Package internal method used to get direct access to the message's payload memory.  The
+     *  buffer is fetched from the native side once per message and is in native byte order, to
+     *  match the packing done by the C side of the API.
+     *
+     *  @return A buffer that spans the whole payload of this message.
+     */
+    //----------------------------------------------------------------------------------------------
+    ByteBuffer getPayload()
+    {
+        if (payload == null)
+        {
+            ByteBuffer newPayload = LegatoJni.GetPayloadBuffer(messageRef);
+
+            if (newPayload == null)
+            {
+                throw new IllegalStateException("JVM does not support direct buffer access");
+            }
+
+            payload = newPayload.order(ByteOrder.nativeOrder());
+        }
+
+        return payload;
+    }
+
     //----------------------------------------------------------------------------------------------
     /**
      *  Get the file descriptor that was attached to this message.
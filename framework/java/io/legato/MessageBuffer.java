@@ -10,6 +10,8 @@
 
 package io.legato;
 
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -18,6 +20,9 @@ package io.legato;
  *
  *  The get and set methods act as a streaming operation.  The buffer maintains an internal pointer
  *  that is updated as values are read and written.
+ *
+ *  Values are read and written directly in the message's payload memory, so the native side is
+ *  only called once per message to get access to that memory.
  */
 //--------------------------------------------------------------------------------------------------
 public class MessageBuffer implements AutoCloseable
@@ -27,6 +32,11 @@ public class MessageBuffer implements AutoCloseable
      */
     private Message hostMessage;
 
+    /**
+     *  Direct view of the host message's payload memory.
+     */
+    private ByteBuffer payload;
+
     /**
      *  The current buffer insertion location.  Reads and writes start from and update this
      *  location.
@@ -76,6 +86,7 @@ public class MessageBuffer implements AutoCloseable
     MessageBuffer(Message message)
     {
         hostMessage = message;
+        payload = message.getPayload();
         location = 0;
     }
 
@@ -88,6 +99,7 @@ public class MessageBuffer implements AutoCloseable
     public void close()
     {
         hostMessage = null;
+        payload = null;
         location = 0;
     }
 
@@ -110,7 +122,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public boolean readBool()
     {
-        boolean result = LegatoJni.GetMessageBool(hostMessage.getRef(), location);
+        boolean result = payload.get(location) != 0;
         location += 1;
 
         return result;
@@ -125,7 +137,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeBool(boolean newValue)
     {
-        LegatoJni.SetMessageBool(hostMessage.getRef(), location, newValue);
+        payload.put(location, (byte)(newValue ? 1 : 0));
         location += 1;
     }
 
@@ -138,7 +150,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public byte readByte()
     {
-        byte result = LegatoJni.GetMessageByte(hostMessage.getRef(), location);
+        byte result = payload.get(location);
         location += 1;
 
         return result;
@@ -153,7 +165,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeByte(byte newValue)
     {
-        LegatoJni.SetMessageByte(hostMessage.getRef(), location, newValue);
+        payload.put(location, newValue);
         location += 1;
     }
 
@@ -166,7 +178,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public short readShort()
     {
-        short result = LegatoJni.GetMessageShort(hostMessage.getRef(), location);
+        short result = payload.getShort(location);
         location += 2;
 
         return result;
@@ -181,7 +193,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeShort(Short newValue)
     {
-        LegatoJni.SetMessageShort(hostMessage.getRef(), location, newValue);
+        payload.putShort(location, newValue);
         location += 2;
     }
 
@@ -194,7 +206,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public int readInt()
     {
-        int result = LegatoJni.GetMessageInt(hostMessage.getRef(), location);
+        int result = payload.getInt(location);
         location += 4;
 
         return result;
@@ -209,7 +221,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeInt(int newValue)
     {
-        LegatoJni.SetMessageInt(hostMessage.getRef(), location, newValue);
+        payload.putInt(location, newValue);
         location += 4;
     }
 
@@ -222,7 +234,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public long readLong()
     {
-        long result = LegatoJni.GetMessageLong(hostMessage.getRef(), location);
+        long result = payload.getLong(location);
         location += 8;
 
         return result;
@@ -237,7 +249,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeLong(long newValue)
     {
-        LegatoJni.SetMessageLong(hostMessage.getRef(), location, newValue);
+        payload.putLong(location, newValue);
         location += 8;
     }
 
@@ -250,7 +262,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public double readDouble()
     {
-        double result = LegatoJni.GetMessageDouble(hostMessage.getRef(), location);
+        double result = payload.getDouble(location);
         location += 8;
 
         return result;
@@ -265,7 +277,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeDouble(double newValue)
     {
-        LegatoJni.SetMessageDouble(hostMessage.getRef(), location, newValue);
+        payload.putDouble(location, newValue);
         location += 8;
     }
 
@@ -278,10 +290,16 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public String readString()
     {
-        LocationValue result = LegatoJni.GetMessageString(hostMessage.getRef(), location);
+        // Strings are packed as their byte size followed by the utf-8 bytes themselves.
+        int strSize = payload.getInt(location);
+        byte[] strBytes = new byte[strSize];
 
-        location += result.bytesUsed;
-        return (String)result.value;
+        ByteBuffer strBuffer = payload.duplicate();
+        strBuffer.position(location + 4);
+        strBuffer.get(strBytes);
+
+        location += 4 + strSize;
+        return new String(strBytes, StandardCharsets.UTF_8);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -293,7 +311,15 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeString(String strValue, int maxSize)
     {
-        location += LegatoJni.SetMessageString(hostMessage.getRef(), location, strValue, maxSize);
+        byte[] strBytes = strValue.getBytes(StandardCharsets.UTF_8);
+
+        payload.putInt(location, strBytes.length);
+
+        ByteBuffer strBuffer = payload.duplicate();
+        strBuffer.position(location + 4);
+        strBuffer.put(strBytes);
+
+        location += 4 + strBytes.length;
     }
 
     //----------------------------------------------------------------------------------------------
@@ -305,7 +331,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public long readLongRef()
     {
-        long result = (long)LegatoJni.GetMessageInt(hostMessage.getRef(), location);
+        long result = (long)payload.getInt(location);
         location += 4;
 
         return result;
@@ -328,7 +354,7 @@ public class MessageBuffer implements AutoCloseable
             throw new IllegalArgumentException("Illegal reference");
         }
 
-        LegatoJni.SetMessageInt(hostMessage.getRef(), location, (int)longRef);
+        payload.putInt(location, (int)longRef);
         location += 4;
     }
 }
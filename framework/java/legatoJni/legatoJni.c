@@ -1313,6 +1313,36 @@ JNIEXPORT jint JNICALL Java_io_legato_LegatoJni_GetMaxPayloadSize
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wraps the message payload memory buffer in a direct java.nio.ByteBuffer so that the Java side can
+ * pack and unpack the payload in place, without crossing JNI for every value.
+ *
+ * The buffer is only valid for as long as the message itself.  It must not be used once the
+ * message has been sent, responded to or released.
+ *
+ * @return A direct ByteBuffer spanning the whole payload, or NULL if the JVM doesn't support
+ *         direct buffer access.
+ */
+//--------------------------------------------------------------------------------------------------
+JNIEXPORT jobject JNICALL Java_io_legato_LegatoJni_GetPayloadBuffer
+(
+    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
+    jclass callClassPtr,  ///< [IN] The java class that called this function.
+    jlong messageRef      ///< [IN] Reference to the message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
+
+    return (*envPtr)->NewDirectByteBuffer(envPtr,
+                                          le_msg_GetPayloadPtr(nRef),
+                                          (jlong)le_msg_GetMaxPayloadSize(nRef));
+}
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a reference to the session to which a given message belongs.
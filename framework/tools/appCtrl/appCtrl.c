@@ -12,6 +12,7 @@
 #include "user.h"
 #include "cgroups.h"
 #include "sysPaths.h"
+#include "distribution.h"
 
 /// @todo Use the appCfg component instead of reading from the config directly.
 
@@ -202,6 +203,7 @@ static void PrintHelp
         "    app status [<appName>]\n"
         "    app version <appName>\n"
         "    app info [<appName>]\n"
+        "    app stats [<appName>]\n"
         "    app runProc <appName> <procName> [options]\n"
         "    app runProc <appName> [<procName>] --exe=<exePath> [options]\n"
         "\n"
@@ -249,6 +251,15 @@ static void PrintHelp
         "       If no name is given, prints the information of all installed applications.\n"
         "       If a name is given, prints the information of the specified application.\n"
         "\n"
+        "    app stats [<appName>]\n"
+        "       If no name is given, prints the resource usage of all installed applications.\n"
+        "       If a name is given, prints the resource usage of the specified application.\n"
+        "       The CPU load, memory, thread and file descriptor counts are sampled periodically\n"
+        "       by the Supervisor while the application runs.  The last value, median (p50),\n"
+        "       90th percentile (p90) and maximum over the kept samples are printed, along with\n"
+        "       the rate at which the memory used grows.  The memory is shown as n/a if the\n"
+        "       kernel does not account it.\n"
+        "\n"
         "    app runProc <appName> <procName> [options]\n"
         "       Runs a configured process inside an app using the process settings from the\n"
         "       configuration database.  If an exePath is provided as an option then the specified\n"
@@ -1254,6 +1265,164 @@ static void PrintAppVersion
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the last value, the median, the 90th percentile and the maximum of a series of values.
+ *
+ * @note The values are sorted in place.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintDistribution
+(
+    const char* labelPtr,       ///< [IN] Name of the values.
+    double* valuesPtr,          ///< [IN] Values, from the oldest to the most recent.
+    size_t numValues,           ///< [IN] Number of values, at least one.
+    int precision,              ///< [IN] Number of decimals to print.
+    const char* unitPtr         ///< [IN] Unit of the values.
+)
+{
+    distribution_Summary_t summary;
+
+    distribution_Summarize(valuesPtr, numValues, &summary);
+
+    printf("    %-8s now %.*f%s, p50 %.*f%s, p90 %.*f%s, max %.*f%s\n", labelPtr,
+           precision, summary.last, unitPtr, precision, summary.p50, unitPtr,
+           precision, summary.p90, unitPtr, precision, summary.max, unitPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the resource usage of an application from the samples taken by the Supervisor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintAppStats
+(
+    const char* appNamePtr      ///< [IN] Application name to get the statistics for.
+)
+{
+    le_appInfo_ConnectService();
+    le_appStats_ConnectService();
+
+    uint64_t timestamps[LE_APPSTATS_MAX_SAMPLES];
+    uint64_t cpuTimes[LE_APPSTATS_MAX_SAMPLES];
+    uint64_t memUsed[LE_APPSTATS_MAX_SAMPLES];
+    uint32_t numThreads[LE_APPSTATS_MAX_SAMPLES];
+    uint32_t numFds[LE_APPSTATS_MAX_SAMPLES];
+    size_t numTimestamps = NUM_ARRAY_MEMBERS(timestamps);
+    size_t numCpuTimes = NUM_ARRAY_MEMBERS(cpuTimes);
+    size_t numMemUsed = NUM_ARRAY_MEMBERS(memUsed);
+    size_t numNumThreads = NUM_ARRAY_MEMBERS(numThreads);
+    size_t numNumFds = NUM_ARRAY_MEMBERS(numFds);
+
+    const char* statePtr = IsAppRunning(appNamePtr) ? "running" : "stopped";
+
+    le_result_t result = le_appStats_GetSamples(appNamePtr,
+                                                timestamps, &numTimestamps,
+                                                cpuTimes, &numCpuTimes,
+                                                memUsed, &numMemUsed,
+                                                numThreads, &numNumThreads,
+                                                numFds, &numNumFds);
+
+    if (result == LE_NOT_FOUND)
+    {
+        printf("[%s] %s\n", statePtr, appNamePtr);
+        printf("    no samples\n");
+        return;
+    }
+
+    INTERNAL_ERR_IF(result != LE_OK,
+                    "Could not get the samples of app '%s'.  %s.",
+                    appNamePtr, LE_RESULT_TXT(result));
+
+    size_t numSamples = numTimestamps;
+    size_t i;
+
+    printf("[%s] %s\n", statePtr, appNamePtr);
+    printf("    %zu samples over %" PRIu64 " s, every %" PRIu32 " s\n",
+           numSamples, (timestamps[numSamples - 1] - timestamps[0]) / 1000,
+           le_appStats_GetSamplePeriod() / 1000);
+
+    double values[LE_APPSTATS_MAX_SAMPLES];
+    size_t numValues = 0;
+
+    // The CPU load over each sampling interval.  Intervals over which the CPU time went down were
+    // interrupted by a restart of the app and are skipped.
+    for (i = 1; i < numSamples; i++)
+    {
+        uint64_t elapsedMs = timestamps[i] - timestamps[i - 1];
+
+        if ( (elapsedMs > 0) && (cpuTimes[i] >= cpuTimes[i - 1]) )
+        {
+            values[numValues++] = (double)(cpuTimes[i] - cpuTimes[i - 1]) / (elapsedMs * 10000.0);
+        }
+    }
+
+    if (numValues > 0)
+    {
+        PrintDistribution("cpu:", values, numValues, 1, "%");
+    }
+
+    if (le_appStats_IsMemUsedSampled())
+    {
+        for (i = 0; i < numSamples; i++)
+        {
+            values[i] = memUsed[i] / 1024.0;
+        }
+        PrintDistribution("memory:", values, numSamples, 0, " KB");
+
+        double minutes = (timestamps[numSamples - 1] - timestamps[0]) / 60000.0;
+
+        if (minutes > 0)
+        {
+            printf("    %-8s %+.1f KB/min\n", "",
+                   ((double)memUsed[numSamples - 1] - (double)memUsed[0]) / 1024.0 / minutes);
+        }
+    }
+    else
+    {
+        printf("    %-8s n/a\n", "memory:");
+    }
+
+    for (i = 0; i < numSamples; i++)
+    {
+        values[i] = numThreads[i];
+    }
+    PrintDistribution("threads:", values, numSamples, 0, "");
+
+    for (i = 0; i < numSamples; i++)
+    {
+        values[i] = numFds[i];
+    }
+    PrintDistribution("fds:", values, numSamples, 0, "");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Implements the "stats" command.
+ *
+ * @note This function does not return.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void PrintStats
+(
+    void
+)
+{
+    if (AppNamePtr == NULL)
+    {
+        ListInstalledApps(PrintAppStats);
+    }
+    else
+    {
+        PrintAppStats(AppNamePtr);
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * A handler that is called when the application process exits.
@@ -1862,6 +2031,14 @@ static void CommandArgHandler
         le_arg_AddPositionalCallback(AppNameArgHandler);
         le_arg_AllowLessPositionalArgsThanCallbacks();
     }
+    else if (strcmp(command, "stats") == 0)
+    {
+        CommandFunc = PrintStats;
+
+        // Accept an optional app name argument.
+        le_arg_AddPositionalCallback(AppNameArgHandler);
+        le_arg_AllowLessPositionalArgsThanCallbacks();
+    }
     else
     {
         fprintf(stderr, "Unknown command '%s'.  Try --help.\n", command);
@@ -0,0 +1,71 @@
+//--------------------------------------------------------------------------------------------------
+/** @file distribution.c
+ *
+ * Summary of the distribution of a series of values, used to print the resource usage of apps.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "distribution.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compares two doubles for qsort().
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareDoubles
+(
+    const void* aPtr,
+    const void* bPtr
+)
+{
+    double a = *(const double*)aPtr;
+    double b = *(const double*)bPtr;
+
+    return (a > b) - (a < b);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the nearest-rank percentile of sorted values: the smallest value that is greater than or
+ * equal to the given percentage of the values.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetPercentile
+(
+    const double* sortedValuesPtr,          ///< [IN] Values, sorted in ascending order.
+    size_t numValues,                       ///< [IN] Number of values, at least one.
+    size_t percent                          ///< [IN] Percentile, from 1 to 100.
+)
+{
+    return sortedValuesPtr[(percent * numValues + 99) / 100 - 1];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Summarizes a series of values.
+ *
+ * @note The values are sorted in place.
+ */
+//--------------------------------------------------------------------------------------------------
+void distribution_Summarize
+(
+    double* valuesPtr,                      ///< [IN] Values, from the oldest to the most recent.
+    size_t numValues,                       ///< [IN] Number of values, at least one.
+    distribution_Summary_t* summaryPtr      ///< [OUT] Summary of the values.
+)
+{
+    LE_ASSERT(numValues > 0);
+
+    summaryPtr->last = valuesPtr[numValues - 1];
+
+    qsort(valuesPtr, numValues, sizeof(double), CompareDoubles);
+
+    summaryPtr->p50 = GetPercentile(valuesPtr, numValues, 50);
+    summaryPtr->p90 = GetPercentile(valuesPtr, numValues, 90);
+    summaryPtr->max = valuesPtr[numValues - 1];
+}
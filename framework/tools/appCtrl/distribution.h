@@ -0,0 +1,42 @@
+//--------------------------------------------------------------------------------------------------
+/** @file distribution.h
+ *
+ * Summary of the distribution of a series of values, used to print the resource usage of apps.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+#ifndef LEGATO_APPCTRL_DISTRIBUTION_INCLUDE_GUARD
+#define LEGATO_APPCTRL_DISTRIBUTION_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Summary of a series of values.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    double last;                ///< Most recent value.
+    double p50;                 ///< Median, by the nearest-rank method.
+    double p90;                 ///< 90th percentile, by the nearest-rank method.
+    double max;                 ///< Maximum value.
+}
+distribution_Summary_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Summarizes a series of values.
+ *
+ * @note The values are sorted in place.
+ */
+//--------------------------------------------------------------------------------------------------
+void distribution_Summarize
+(
+    double* valuesPtr,                      ///< [IN] Values, from the oldest to the most recent.
+    size_t numValues,                       ///< [IN] Number of values, at least one.
+    distribution_Summary_t* summaryPtr      ///< [OUT] Summary of the values.
+);
+
+
+#endif  // LEGATO_APPCTRL_DISTRIBUTION_INCLUDE_GUARD
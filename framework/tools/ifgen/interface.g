@@ -114,6 +114,11 @@ options {
 
 @footer
 {
+    # Interfaces which have already been parsed, keyed by path, search path and interface name.
+    # When generating code for many interfaces in one run (ifgen --batch), this saves re-parsing
+    # commonly imported files for every job.
+    ParsedInterfaces = {}
+
     def ParseCode(apiFile, searchPath=[], ifaceName=None):
         if os.path.isabs(apiFile) or os.path.isfile(apiFile):
             apiPath = apiFile
@@ -128,6 +133,10 @@ options {
                 # path but at least will raise a reasonable exception
                 apiPath = apiFile
 
+        cacheKey = (os.path.abspath(apiPath), tuple(searchPath), ifaceName)
+        if cacheKey in ParsedInterfaces:
+            return ParsedInterfaces[cacheKey]
+
         fileStream = ANTLRFileStream(apiPath, 'utf-8')
         lexer = interfaceLexer(fileStream)
         tokens = CommonTokenStream(lexer)
@@ -143,6 +152,7 @@ options {
 
         if (parser.getNumberOfSyntaxErrors() > 0 or
             parser.compileErrors > 0):
+            ParsedInterfaces[cacheKey] = None
             return None
 
         iface.text= ''.join([ token.text
@@ -152,6 +162,8 @@ options {
                                                                DOC_PRE_COMMENT,
                                                                DOC_POST_COMMENT ]) ])
 
+        ParsedInterfaces[cacheKey] = iface
+
         return iface
 }
 
@@ -2545,6 +2545,11 @@ def main(argv, stdin=sys.stdin, stdout=sys.stdout, stderr=sys.stderr):
 
 
 
+# Interfaces which have already been parsed, keyed by path, search path and interface name.
+# When generating code for many interfaces in one run (ifgen --batch), this saves re-parsing
+# commonly imported files for every job.
+ParsedInterfaces = {}
+
 def ParseCode(apiFile, searchPath=[], ifaceName=None):
     if os.path.isabs(apiFile) or os.path.isfile(apiFile):
         apiPath = apiFile
@@ -2559,6 +2564,10 @@ def ParseCode(apiFile, searchPath=[], ifaceName=None):
             # path but at least will raise a reasonable exception
             apiPath = apiFile
 
+    cacheKey = (os.path.abspath(apiPath), tuple(searchPath), ifaceName)
+    if cacheKey in ParsedInterfaces:
+        return ParsedInterfaces[cacheKey]
+
     fileStream = ANTLRFileStream(apiPath, 'utf-8')
     lexer = interfaceLexer(fileStream)
     tokens = CommonTokenStream(lexer)
@@ -2574,6 +2583,7 @@ def ParseCode(apiFile, searchPath=[], ifaceName=None):
 
     if (parser.getNumberOfSyntaxErrors() > 0 or
         parser.compileErrors > 0):
+        ParsedInterfaces[cacheKey] = None
         return None
 
     iface.text= ''.join([ token.text
@@ -2583,6 +2593,8 @@ def ParseCode(apiFile, searchPath=[], ifaceName=None):
                                                            DOC_PRE_COMMENT,
                                                            DOC_POST_COMMENT ]) ])
 
+    ParsedInterfaces[cacheKey] = iface
+
     return iface
 
 
@@ -21,6 +21,9 @@
 #include "limit.h"
 #include "addr.h"
 #include "fileDescriptor.h"
+#include "stats.h"
+#include <sys/uio.h>
+#include <sys/mman.h>
 
 
 //--------------------------------------------------------------------------------------------------
@@ -57,7 +60,8 @@ typedef enum
     INSPECT_INSP_TYPE_IPC_SERVERS,
     INSPECT_INSP_TYPE_IPC_CLIENTS,
     INSPECT_INSP_TYPE_IPC_SERVERS_SESSIONS,
-    INSPECT_INSP_TYPE_IPC_CLIENTS_SESSIONS
+    INSPECT_INSP_TYPE_IPC_CLIENTS_SESSIONS,
+    INSPECT_INSP_TYPE_STATS
 }
 InspType_t;
 
@@ -416,6 +420,136 @@ static int OpenProcMemFile
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of buffers that can be read from the remote process in a single batch.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_REMOTE_READ_BATCH               8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * One element of a batch of reads from the remote process.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    off_t remoteAddr;   ///< Address of the buffer in the remote process.
+    void* localPtr;     ///< Local buffer to copy the remote bytes into.
+    size_t size;        ///< Number of bytes to read.
+}
+RemoteRead_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true = read the remote process with process_vm_readv(). Cleared the first time the kernel refuses
+ * the call, after which everything is read through the /proc/<PID>/mem file instead.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool UseProcessVmReadv = true;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a batch of buffers from the remote process. All buffers are fetched with a single
+ * process_vm_readv() scatter/gather call, so that they are both cheap to read and as close to
+ * each other in time as possible. Falls back to reading /proc/<PID>/mem one buffer at a time if
+ * process_vm_readv() is not available.
+ *
+ * @return
+ *      LE_OK if all buffers were read.
+ *      LE_FAULT if any of them couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadRemoteBatch
+(
+    const RemoteRead_t* readsPtr,   ///< [IN] Array of reads to perform.
+    size_t readCount                ///< [IN] Number of elements in the array.
+)
+{
+    INTERNAL_ERR_IF(readCount > MAX_REMOTE_READ_BATCH,
+                    "Too many remote reads in one batch (%zu).", readCount);
+
+    if (UseProcessVmReadv)
+    {
+        struct iovec localIov[MAX_REMOTE_READ_BATCH];
+        struct iovec remoteIov[MAX_REMOTE_READ_BATCH];
+        size_t totalSize = 0;
+        size_t i;
+
+        for (i = 0; i < readCount; i++)
+        {
+            localIov[i].iov_base = readsPtr[i].localPtr;
+            localIov[i].iov_len = readsPtr[i].size;
+            remoteIov[i].iov_base = (void*)(size_t)readsPtr[i].remoteAddr;
+            remoteIov[i].iov_len = readsPtr[i].size;
+            totalSize += readsPtr[i].size;
+        }
+
+        ssize_t result;
+
+        do
+        {
+            result = process_vm_readv(PidToInspect, localIov, readCount, remoteIov, readCount, 0);
+        }
+        while ((result == -1) && (errno == EINTR));
+
+        if (result == (ssize_t)totalSize)
+        {
+            return LE_OK;
+        }
+
+        if ((result != -1) || ((errno != ENOSYS) && (errno != EPERM)))
+        {
+            LE_ERROR("Could not read %zu bytes from process %d (got %zd).  %m.",
+                     totalSize, PidToInspect, result);
+            return LE_FAULT;
+        }
+
+        LE_INFO("process_vm_readv() is not usable (%m). Falling back to /proc/%d/mem.",
+                PidToInspect);
+        UseProcessVmReadv = false;
+    }
+
+    size_t i;
+
+    for (i = 0; i < readCount; i++)
+    {
+        if (fd_ReadFromOffset(FdProcMem, readsPtr[i].remoteAddr, readsPtr[i].localPtr,
+                              readsPtr[i].size) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a single buffer from the remote process.
+ *
+ * @return
+ *      LE_OK if the buffer was read.
+ *      LE_FAULT if it couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadRemote
+(
+    off_t remoteAddr,   ///< [IN] Address of the buffer in the remote process.
+    void* bufPtr,       ///< [OUT] Local buffer to store the read bytes in.
+    size_t bufSize      ///< [IN] Size of the buffer.
+)
+{
+    RemoteRead_t read = {remoteAddr, bufPtr, bufSize};
+
+    return ReadRemoteBatch(&read, 1);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize a RemoteListAccess_t data struct.
@@ -461,16 +595,16 @@ static MemPoolIter_Ref_t CreateMemPoolIter
     InitRemoteListAccessObj(&iteratorPtr->memPoolList);
 
     // Get the List for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, listAddrOffset, &(iteratorPtr->memPoolList.List),
-                             sizeof(iteratorPtr->memPoolList.List)) != LE_OK)
+    if (ReadRemote(listAddrOffset, &(iteratorPtr->memPoolList.List),
+                   sizeof(iteratorPtr->memPoolList.List)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("mempool list"));
     }
 
     // Get the ListChgCntRef for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, listChgCntAddrOffset,
-                          &(iteratorPtr->memPoolList.ListChgCntRef),
-                          sizeof(iteratorPtr->memPoolList.ListChgCntRef)) != LE_OK)
+    if (ReadRemote(listChgCntAddrOffset,
+                   &(iteratorPtr->memPoolList.ListChgCntRef),
+                   sizeof(iteratorPtr->memPoolList.ListChgCntRef)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("mempool list change counter ref"));
     }
@@ -504,16 +638,16 @@ static ThreadObjIter_Ref_t CreateThreadObjIter
     InitRemoteListAccessObj(&iteratorPtr->threadObjList);
 
     // Get the List for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, listAddrOffset, &(iteratorPtr->threadObjList.List),
-                             sizeof(iteratorPtr->threadObjList.List)) != LE_OK)
+    if (ReadRemote(listAddrOffset, &(iteratorPtr->threadObjList.List),
+                   sizeof(iteratorPtr->threadObjList.List)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("thread obj list"));
     }
 
     // Get the ListChgCntRef for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, listChgCntAddrOffset,
-                          &(iteratorPtr->threadObjList.ListChgCntRef),
-                          sizeof(iteratorPtr->threadObjList.ListChgCntRef)) != LE_OK)
+    if (ReadRemote(listChgCntAddrOffset,
+                   &(iteratorPtr->threadObjList.ListChgCntRef),
+                   sizeof(iteratorPtr->threadObjList.ListChgCntRef)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("thread obj list change counter ref"));
     }
@@ -576,24 +710,24 @@ static void* CreateThreadMemberObjIter
     InitRemoteListAccessObj(&iteratorPtr->threadMemberObjList);
 
     // Get the list of thread objs for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, threadObjListAddrOffset, &(iteratorPtr->threadObjList.List),
-                             sizeof(iteratorPtr->threadObjList.List)) != LE_OK)
+    if (ReadRemote(threadObjListAddrOffset, &(iteratorPtr->threadObjList.List),
+                   sizeof(iteratorPtr->threadObjList.List)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("thread obj list"));
     }
 
     // Get the thread obj ListChgCntRef for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, threadObjListChgCntAddrOffset,
-                          &(iteratorPtr->threadObjList.ListChgCntRef),
-                          sizeof(iteratorPtr->threadObjList.ListChgCntRef)) != LE_OK)
+    if (ReadRemote(threadObjListChgCntAddrOffset,
+                   &(iteratorPtr->threadObjList.ListChgCntRef),
+                   sizeof(iteratorPtr->threadObjList.ListChgCntRef)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("thread obj list change counter ref"));
     }
 
     // Get the thread member obj ListChgCntRef for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, threadMemberObjListChgCntAddrOffset,
-                          &(iteratorPtr->threadMemberObjList.ListChgCntRef),
-                          sizeof(iteratorPtr->threadMemberObjList.ListChgCntRef)) != LE_OK)
+    if (ReadRemote(threadMemberObjListChgCntAddrOffset,
+                   &(iteratorPtr->threadMemberObjList.ListChgCntRef),
+                   sizeof(iteratorPtr->threadMemberObjList.ListChgCntRef)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("thread member obj list change counter ref"));
     }
@@ -696,13 +830,13 @@ static InterfaceObjIter_Ref_t CreateInterfaceObjIter
     Hashmap_t map;
 
     // Get the mapRef for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, mapAddrOffset, &(mapRef), sizeof(mapRef)) != LE_OK)
+    if (ReadRemote(mapAddrOffset, &(mapRef), sizeof(mapRef)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("interface obj map ref"));
     }
 
     // Get the map for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)mapRef, &(map), sizeof(map)) != LE_OK)
+    if (ReadRemote((ssize_t)mapRef, &(map), sizeof(map)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("interface obj map"));
     }
@@ -711,8 +845,8 @@ static InterfaceObjIter_Ref_t CreateInterfaceObjIter
     iteratorPtr->interfaceObjMap.bucketCount = map.bucketCount;
 
     // Get the mapChgCntRef for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, mapChgCntAddrOffset, &(iteratorPtr->interfaceObjMap.mapChgCntRef),
-                             sizeof(iteratorPtr->interfaceObjMap.mapChgCntRef)) != LE_OK)
+    if (ReadRemote(mapChgCntAddrOffset, &(iteratorPtr->interfaceObjMap.mapChgCntRef),
+                   sizeof(iteratorPtr->interfaceObjMap.mapChgCntRef)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("interface obj map change counter ref"));
     }
@@ -721,9 +855,9 @@ static InterfaceObjIter_Ref_t CreateInterfaceObjIter
     iteratorPtr->currIndex = 0;
 
     // Get the list of interface objects.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)iteratorPtr->interfaceObjMap.bucketsPtr,
-                          &(iteratorPtr->interfaceObjList.List),
-                          sizeof(iteratorPtr->interfaceObjList.List)) != LE_OK)
+    if (ReadRemote((ssize_t)iteratorPtr->interfaceObjMap.bucketsPtr,
+                   &(iteratorPtr->interfaceObjList.List),
+                   sizeof(iteratorPtr->interfaceObjList.List)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("interface obj list of bucket 0 in the interface obj map"));
     }
@@ -800,9 +934,9 @@ static SessionObjIter_Ref_t CreateSessionObjIter
     InitRemoteListAccessObj(&iteratorPtr->sessionList);
 
     // Get the listChgCntRef for the process-under-inspection.
-    if (fd_ReadFromOffset(FdProcMem, listChgCntAddrOffset,
-                          &(iteratorPtr->sessionList.ListChgCntRef),
-                          sizeof(iteratorPtr->sessionList.ListChgCntRef)) != LE_OK)
+    if (ReadRemote(listChgCntAddrOffset,
+                   &(iteratorPtr->sessionList.ListChgCntRef),
+                   sizeof(iteratorPtr->sessionList.ListChgCntRef)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("session obj list change counter ref"));
     }
@@ -825,8 +959,8 @@ static size_t GetMemPoolListChgCnt
 )
 {
     size_t memPoolListChgCnt;
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->memPoolList.ListChgCntRef),
-                          &memPoolListChgCnt, sizeof(memPoolListChgCnt)) != LE_OK)
+    if (ReadRemote((ssize_t)(iterator->memPoolList.ListChgCntRef),
+                   &memPoolListChgCnt, sizeof(memPoolListChgCnt)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("mempool list change counter"));
     }
@@ -849,8 +983,8 @@ static size_t GetThreadObjListChgCnt
 )
 {
     size_t threadObjListChgCnt;
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->threadObjList.ListChgCntRef),
-                          &threadObjListChgCnt, sizeof(threadObjListChgCnt)) != LE_OK)
+    if (ReadRemote((ssize_t)(iterator->threadObjList.ListChgCntRef),
+                   &threadObjListChgCnt, sizeof(threadObjListChgCnt)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("thread obj list change counter"));
     }
@@ -877,16 +1011,19 @@ static size_t GetThreadMemberObjListChgCnt
 )
 {
     size_t threadObjListChgCnt, threadMemberObjListChgCnt;
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->threadObjList.ListChgCntRef),
-                          &threadObjListChgCnt, sizeof(threadObjListChgCnt)) != LE_OK)
+
+    // Fetch both counters in one go so they are sampled at the same time.
+    RemoteRead_t reads[] =
     {
-        INTERNAL_ERR(REMOTE_READ_ERR("thread obj list change counter"));
-    }
+        { (ssize_t)(iterator->threadObjList.ListChgCntRef),
+          &threadObjListChgCnt, sizeof(threadObjListChgCnt) },
+        { (ssize_t)(iterator->threadMemberObjList.ListChgCntRef),
+          &threadMemberObjListChgCnt, sizeof(threadMemberObjListChgCnt) }
+    };
 
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->threadMemberObjList.ListChgCntRef),
-                          &threadMemberObjListChgCnt, sizeof(threadMemberObjListChgCnt)) != LE_OK)
+    if (ReadRemoteBatch(reads, NUM_ARRAY_MEMBERS(reads)) != LE_OK)
     {
-        INTERNAL_ERR(REMOTE_READ_ERR("thread member obj list change counter"));
+        INTERNAL_ERR(REMOTE_READ_ERR("thread obj and thread member obj list change counters"));
     }
 
     return (threadObjListChgCnt + threadMemberObjListChgCnt);
@@ -907,8 +1044,8 @@ static size_t GetInterfaceObjMapChgCnt
 )
 {
     size_t interfaceObjMapChgCnt;
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->interfaceObjMap.mapChgCntRef),
-                          &interfaceObjMapChgCnt, sizeof(interfaceObjMapChgCnt)) != LE_OK)
+    if (ReadRemote((ssize_t)(iterator->interfaceObjMap.mapChgCntRef),
+                   &interfaceObjMapChgCnt, sizeof(interfaceObjMapChgCnt)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("interface obj map change counter"));
     }
@@ -931,14 +1068,22 @@ static size_t GetSessionListChgCnt
     SessionObjIter_Ref_t iterator ///< [IN] The iterator to get the list change counter from.
 )
 {
-    size_t sessionListChgCnt;
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->sessionList.ListChgCntRef),
-                          &sessionListChgCnt, sizeof(sessionListChgCnt)) != LE_OK)
+    size_t interfaceObjMapChgCnt, sessionListChgCnt;
+
+    RemoteRead_t reads[] =
     {
-        INTERNAL_ERR(REMOTE_READ_ERR("session list change counter"));
+        { (ssize_t)(iterator->interfaceObjMap.mapChgCntRef),
+          &interfaceObjMapChgCnt, sizeof(interfaceObjMapChgCnt) },
+        { (ssize_t)(iterator->sessionList.ListChgCntRef),
+          &sessionListChgCnt, sizeof(sessionListChgCnt) }
+    };
+
+    if (ReadRemoteBatch(reads, NUM_ARRAY_MEMBERS(reads)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("interface obj map and session list change counters"));
     }
 
-    return GetInterfaceObjMapChgCnt((InterfaceObjIter_Ref_t)iterator) + sessionListChgCnt;
+    return (interfaceObjMapChgCnt + sessionListChgCnt);
 }
 
 
@@ -1042,8 +1187,8 @@ static MemPool_t* GetNextMemPool
     MemPool_t* poolPtr = CONTAINER_OF(linkPtr, MemPool_t, poolLink);
 
     // Read the pool into our own memory.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)poolPtr, &(memPoolIterRef->currMemPool),
-                          sizeof(memPoolIterRef->currMemPool)) != LE_OK)
+    if (ReadRemote((ssize_t)poolPtr, &(memPoolIterRef->currMemPool),
+                   sizeof(memPoolIterRef->currMemPool)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("mempool object"));
     }
@@ -1077,8 +1222,8 @@ static thread_Obj_t* GetNextThreadObj
     thread_Obj_t* threadObjPtr = CONTAINER_OF(linkPtr, thread_Obj_t, link);
 
     // Read the thread obj into our own memory.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)threadObjPtr, &(threadObjIterRef->currThreadObj),
-                          sizeof(threadObjIterRef->currThreadObj)) != LE_OK)
+    if (ReadRemote((ssize_t)threadObjPtr, &(threadObjIterRef->currThreadObj),
+                   sizeof(threadObjIterRef->currThreadObj)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("thread object"));
     }
@@ -1178,9 +1323,9 @@ static le_dls_Link_t* GetNextThreadMemberObjLinkPtr
         thread_Obj_t* remThreadObjPtr = CONTAINER_OF(remThreadObjNextLinkPtr, thread_Obj_t, link);
 
         // Read the thread obj into our own memory, and update the local reference
-        if (fd_ReadFromOffset(FdProcMem, (ssize_t)remThreadObjPtr,
-                              &(threadMemberObjItrRef->currThreadObj),
-                              sizeof(threadMemberObjItrRef->currThreadObj)) != LE_OK)
+        if (ReadRemote((ssize_t)remThreadObjPtr,
+                       &(threadMemberObjItrRef->currThreadObj),
+                       sizeof(threadMemberObjItrRef->currThreadObj)) != LE_OK)
         {
             INTERNAL_ERR(REMOTE_READ_ERR("thread object"));
         }
@@ -1229,8 +1374,8 @@ static Timer_t* GetNextTimer
     Timer_t* remTimerPtr = CONTAINER_OF(remThreadMemberObjNextLinkPtr, Timer_t, link);
 
     // Read the timer into our own memory.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)remTimerPtr, &(timerIterRef->currTimer),
-                          sizeof(timerIterRef->currTimer)) != LE_OK)
+    if (ReadRemote((ssize_t)remTimerPtr, &(timerIterRef->currTimer),
+                   sizeof(timerIterRef->currTimer)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("timer object"));
     }
@@ -1265,8 +1410,8 @@ static Mutex_t* GetNextMutex
     Mutex_t* remMutexPtr = CONTAINER_OF(remThreadMemberObjNextLinkPtr, Mutex_t, lockedByThreadLink);
 
     // Read the mutex into our own memory.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)remMutexPtr, &(mutexIterRef->currMutex),
-                          sizeof(mutexIterRef->currMutex)) != LE_OK)
+    if (ReadRemote((ssize_t)remMutexPtr, &(mutexIterRef->currMutex),
+                   sizeof(mutexIterRef->currMutex)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("mutex object"));
     }
@@ -1327,8 +1472,8 @@ static Semaphore_t* GetNextSemaphore
     while (remSemaphorePtr == NULL);
 
     // Read the semaphore into our own memory.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)remSemaphorePtr, &(semaIterRef->currSemaphore),
-                          sizeof(semaIterRef->currSemaphore)) != LE_OK)
+    if (ReadRemote((ssize_t)remSemaphorePtr, &(semaIterRef->currSemaphore),
+                   sizeof(semaIterRef->currSemaphore)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("semaphore object"));
     }
@@ -1396,8 +1541,8 @@ static void* GetNextInterfaceObjPtr
     Entry_t* remEntryPtr = CONTAINER_OF(remEntryNextLinkPtr, Entry_t, entryListLink);
 
     // Read the entry object into our own memory.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)remEntryPtr,
-                          &(iterator->currEntry), sizeof(iterator->currEntry)) != LE_OK)
+    if (ReadRemote((ssize_t)remEntryPtr,
+                   &(iterator->currEntry), sizeof(iterator->currEntry)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("entry object"));
     }
@@ -1429,8 +1574,8 @@ static msgInterface_Service_t* GetNextServiceObj
     }
 
     // Read the service object into our own memory.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)serviceObjPtr, &(serviceObjIterRef->currServiceObj),
-                          sizeof(serviceObjIterRef->currServiceObj)) != LE_OK)
+    if (ReadRemote((ssize_t)serviceObjPtr, &(serviceObjIterRef->currServiceObj),
+                   sizeof(serviceObjIterRef->currServiceObj)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("service object"));
     }
@@ -1463,8 +1608,8 @@ static msgInterface_ClientInterface_t* GetNextClientObj
     }
 
     // Read the client interface object into our own memory.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)clientObjPtr, &(clientObjIterRef->currClientObj),
-                          sizeof(clientObjIterRef->currClientObj)) != LE_OK)
+    if (ReadRemote((ssize_t)clientObjPtr, &(clientObjIterRef->currClientObj),
+                   sizeof(clientObjIterRef->currClientObj)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("client interface object"));
     }
@@ -1505,8 +1650,8 @@ static msgSession_Session_t* GetNextSessionObj
         }
 
         // Read the interface object into our own memory.
-        if (fd_ReadFromOffset(FdProcMem, (ssize_t)interfaceObjPtr,
-                              &(currInterfaceObj), sizeof(currInterfaceObj)) != LE_OK)
+        if (ReadRemote((ssize_t)interfaceObjPtr,
+                       &(currInterfaceObj), sizeof(currInterfaceObj)) != LE_OK)
         {
             INTERNAL_ERR(REMOTE_READ_ERR("interface object"));
         }
@@ -1524,9 +1669,9 @@ static msgSession_Session_t* GetNextSessionObj
                                                           msgSession_Session_t, link);
 
     // Read the session object into our own memory.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)remSessionObjPtr,
-                          &(sessionObjIterRef->currSessionObj),
-                          sizeof(sessionObjIterRef->currSessionObj)) != LE_OK)
+    if (ReadRemote((ssize_t)remSessionObjPtr,
+                   &(sessionObjIterRef->currSessionObj),
+                   sizeof(sessionObjIterRef->currSessionObj)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("session object"));
     }
@@ -1554,6 +1699,7 @@ static void PrintHelp
         "SYNOPSIS:\n"
         "    inspect <pools|threads|timers|mutexes|semaphores> [OPTIONS] PID\n"
         "    inspect ipc <servers|clients [sessions]> [OPTIONS] PID\n"
+        "    inspect stats [OPTIONS] [PID]\n"
         "\n"
         "DESCRIPTION:\n"
         "    inspect pools              Prints the memory pools usage for the specified process.\n"
@@ -1562,6 +1708,9 @@ static void PrintHelp
         "    inspect mutexes            Prints the info of mutexes in all threads for the specified process.\n"
         "    inspect semaphores         Prints the info of semaphores in all threads for the specified process.\n"
         "    inspect ipc                Prints the info of ipc in all threads for the specified process.\n"
+        "    inspect stats              Prints the live statistics published by the specified process, or\n"
+        "                               by all processes if no PID is given. Use -v for per pool and per\n"
+        "                               session details.\n"
         "\n"
         "OPTIONS:\n"
         "    -f\n"
@@ -3134,11 +3283,18 @@ static void GetWaitingListThreadNames
         currNodePtr = getThreadRecPtrFunc(currNodeLinkPtr);
         currThreadPtr = getThreadPtrFromLinkFunc(currNodePtr);
 
-        // Read the thread obj into the local memory.
-        if (fd_ReadFromOffset(FdProcMem, (ssize_t)currThreadPtr, &localThreadObjCopy,
-                              sizeof(localThreadObjCopy)) != LE_OK)
+        // Read the thread obj and the thread record into the local memory. The thread record is
+        // needed below to get the next link; GetNextLink must operate on a ref to a locally
+        // existing link.
+        RemoteRead_t reads[] =
         {
-            INTERNAL_ERR(REMOTE_READ_ERR("thread object"));
+            { (ssize_t)currThreadPtr, &localThreadObjCopy, sizeof(localThreadObjCopy) },
+            { (ssize_t)currNodePtr, &localThreadRecCopy, threadRecSize }
+        };
+
+        if (ReadRemoteBatch(reads, NUM_ARRAY_MEMBERS(reads)) != LE_OK)
+        {
+            INTERNAL_ERR(REMOTE_READ_ERR("thread object and thread record with waiting list"));
         }
 
         // TODO: write accessor functions to do boundary checking, or if ticket 2847 is approved,
@@ -3151,14 +3307,7 @@ static void GetWaitingListThreadNames
         waitingThreadNames[i] = strndup(localThreadObjCopy.name, sizeof(localThreadObjCopy.name));
         i++;
 
-        // Get the ptr to the the next node link on the waiting list, by reading the thread record
-        // to the local memory first. GetNextLink must operate on a ref to a locally existing link.
-        if (fd_ReadFromOffset(FdProcMem, (ssize_t)currNodePtr, &localThreadRecCopy, threadRecSize) !=
-            LE_OK)
-        {
-            INTERNAL_ERR(REMOTE_READ_ERR("thread record with waiting list"));
-        }
-
+        // Get the ptr to the the next node link on the waiting list.
         le_dls_Link_t waitingListLink = GetWaitingListLink(inspectType, &localThreadRecCopy);
 
         currNodeLinkPtr = GetNextLink(&waitingList, &waitingListLink);
@@ -3435,8 +3584,8 @@ static int PrintServiceObjInfo
     msgProtocol_Protocol_t protocol;
 
     // Read the protocol object into our own memory.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)serviceObjRef->interface.id.protocolRef, &protocol,
-                          sizeof(protocol)) != LE_OK)
+    if (ReadRemote((ssize_t)serviceObjRef->interface.id.protocolRef, &protocol,
+                   sizeof(protocol)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("protocol object"));
     }
@@ -3519,8 +3668,8 @@ static int PrintClientObjInfo
 
     // Retrieve the protocol object. Read the protocol object into our own memory.
     msgProtocol_Protocol_t protocol;
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)clientObjRef->interface.id.protocolRef, &protocol,
-                          sizeof(protocol)) != LE_OK)
+    if (ReadRemote((ssize_t)clientObjRef->interface.id.protocolRef, &protocol,
+                   sizeof(protocol)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("protocol object"));
     }
@@ -3587,8 +3736,8 @@ static int PrintSessionObjInfo
 
     // Retrieve the interface object. Read the interface object into our own memory.
     msgInterface_Interface_t interface;
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)sessionObjRef->interfaceRef, &interface,
-                          sizeof(interface)) != LE_OK)
+    if (ReadRemote((ssize_t)sessionObjRef->interfaceRef, &interface,
+                   sizeof(interface)) != LE_OK)
     {
         INTERNAL_ERR(REMOTE_READ_ERR("interface object"));
     }
@@ -3657,6 +3806,31 @@ static void RefreshTimerHandler
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the refresh timer which runs the next round of inspection.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartRefreshTimer
+(
+    le_clk_Time_t refreshInterval ///< [IN] Time until the next round.
+)
+{
+    // Set up the refresh timer.
+    refreshTimer = le_timer_Create("RefreshTimer");
+
+    INTERNAL_ERR_IF(le_timer_SetHandler(refreshTimer, RefreshTimerHandler) != LE_OK,
+                    "Could not set timer handler.\n");
+
+    INTERNAL_ERR_IF(le_timer_SetInterval(refreshTimer, refreshInterval) != LE_OK,
+                    "Could not set refresh time.\n");
+
+    // Start the refresh timer.
+    INTERNAL_ERR_IF(le_timer_Start(refreshTimer) != LE_OK,
+                    "Could not start refresh timer.\n");
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Performs actions when an inspection ends depending on how it ends.
@@ -3725,21 +3899,103 @@ static int InspectEndHandling
                 INTERNAL_ERR("Invalid end status.");
         }
 
-        // Set up the refresh timer.
-        refreshTimer = le_timer_Create("RefreshTimer");
+        StartRefreshTimer(refreshInterval);
+    }
+
+    return lineCount;
+}
+
 
-        INTERNAL_ERR_IF(le_timer_SetHandler(refreshTimer, RefreshTimerHandler) != LE_OK,
-                        "Could not set timer handler.\n");
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function prototypes for the CreateXXXIter, GetXXXListChgCnt, GetNextXXX, and PrintXXXInfo
+ * families.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void* (*CreateIterFunc_t)(void);
+typedef size_t (*GetListChgCntFunc_t)(void* iterRef);
+typedef void* (*GetNextNodeFunc_t)(void* iterRef);
+typedef int (*PrintNodeInfoFunc_t)(void* nodeRef);
 
-        INTERNAL_ERR_IF(le_timer_SetInterval(refreshTimer, refreshInterval) != LE_OK,
-                        "Could not set refresh time.\n");
 
-        // Start the refresh timer.
-        INTERNAL_ERR_IF(le_timer_Start(refreshTimer) != LE_OK,
-                        "Could not start refresh timer.\n");
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of times a snapshot is attempted before reporting that the inspection was interrupted by
+ * list changes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SNAPSHOT_ATTEMPTS               3
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Local copy of the nodes of the list being inspected. The buffer is grown as needed and kept
+ * across refreshes.
+ */
+//--------------------------------------------------------------------------------------------------
+static struct
+{
+    uint8_t* bufPtr;    ///< Node copies, back to back.
+    size_t capacity;    ///< Size of the buffer in bytes.
+}
+Snapshot = { NULL, 0 };
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Walks the list of nodes in the remote process in one pass and copies each node into the local
+ * snapshot. The change counters are checked after every node, and the walk stops as soon as a
+ * change is detected since the remaining links can no longer be trusted.
+ *
+ * @return
+ *      INSPECT_SUCCESS if the whole list was copied without any changes to it.
+ *      INSPECT_INTERRUPTED if the list changed during the walk. The nodes copied so far are still
+ *      in the snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+static InspectEndStatus_t TakeSnapshot
+(
+    CreateIterFunc_t createIterFunc,        ///< [IN] Creates the iterator for the list.
+    GetListChgCntFunc_t getListChgCntFunc,  ///< [IN] Gets the list change counter.
+    GetNextNodeFunc_t getNextNodeFunc,      ///< [IN] Gets the next node of the list.
+    size_t nodeSize,                        ///< [IN] Size of a node.
+    size_t* nodeCountPtr                    ///< [OUT] Number of nodes in the snapshot.
+)
+{
+    void* iterRef = createIterFunc();
+
+    size_t initialChangeCount = getListChgCntFunc(iterRef);
+    size_t currentChangeCount = initialChangeCount;
+    size_t nodeCount = 0;
+    void* nodeRef;
+
+    while ((currentChangeCount == initialChangeCount) &&
+           ((nodeRef = getNextNodeFunc(iterRef)) != NULL))
+    {
+        if (((nodeCount + 1) * nodeSize) > Snapshot.capacity)
+        {
+            size_t newCapacity = (Snapshot.capacity == 0) ? (16 * nodeSize) :
+                                                            (2 * Snapshot.capacity);
+            uint8_t* newBufPtr = realloc(Snapshot.bufPtr, newCapacity);
+
+            INTERNAL_ERR_IF(newBufPtr == NULL, "Could not grow the snapshot to %zu bytes.",
+                            newCapacity);
+
+            Snapshot.bufPtr = newBufPtr;
+            Snapshot.capacity = newCapacity;
+        }
+
+        memcpy(Snapshot.bufPtr + (nodeCount * nodeSize), nodeRef, nodeSize);
+        nodeCount++;
+
+        currentChangeCount = getListChgCntFunc(iterRef);
     }
 
-    return lineCount;
+    le_mem_Release(iterRef);
+
+    *nodeCountPtr = nodeCount;
+
+    return (currentChangeCount == initialChangeCount) ? INSPECT_SUCCESS : INSPECT_INTERRUPTED;
 }
 
 
@@ -3753,19 +4009,11 @@ static void InspectFunc
     InspType_t inspectType ///< [IN] What to inspect.
 )
 {
-    // function prototype for the CreateXXXIter family.
-    typedef void* (*CreateIterFunc_t)(void);
-    // function prototype for the GetXXXListChgCnt family.
-    typedef size_t (*GetListChgCntFunc_t)(void* iterRef);
-    // function prototype for the GetNextXXX family.
-    typedef void* (*GetNextNodeFunc_t)(void* iterRef);
-    // Function prototype for the PrintXXXInfo family.
-    typedef int (*PrintNodeInfoFunc_t)(void* nodeRef);
-
     CreateIterFunc_t createIterFunc;
     GetListChgCntFunc_t getListChgCntFunc;
     GetNextNodeFunc_t getNextNodeFunc;
     PrintNodeInfoFunc_t printNodeInfoFunc;
+    size_t nodeSize;
 
     // assigns the appropriate set of functions according to the inspection type.
     switch (inspectType)
@@ -3775,6 +4023,7 @@ static void InspectFunc
             getListChgCntFunc = (GetListChgCntFunc_t) GetMemPoolListChgCnt;
             getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextMemPool;
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintMemPoolInfo;
+            nodeSize          = sizeof(MemPool_t);
             break;
 
         case INSPECT_INSP_TYPE_THREAD_OBJ:
@@ -3782,6 +4031,7 @@ static void InspectFunc
             getListChgCntFunc = (GetListChgCntFunc_t) GetThreadObjListChgCnt;
             getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextThreadObj;
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintThreadObjInfo;
+            nodeSize          = sizeof(thread_Obj_t);
             break;
 
         case INSPECT_INSP_TYPE_TIMER:
@@ -3789,6 +4039,7 @@ static void InspectFunc
             getListChgCntFunc = (GetListChgCntFunc_t) GetThreadMemberObjListChgCnt;
             getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextTimer;
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintTimerInfo;
+            nodeSize          = sizeof(Timer_t);
             break;
 
         case INSPECT_INSP_TYPE_MUTEX:
@@ -3796,6 +4047,7 @@ static void InspectFunc
             getListChgCntFunc = (GetListChgCntFunc_t) GetThreadMemberObjListChgCnt;
             getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextMutex;
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintMutexInfo;
+            nodeSize          = sizeof(Mutex_t);
             break;
 
         case INSPECT_INSP_TYPE_SEMAPHORE:
@@ -3803,6 +4055,7 @@ static void InspectFunc
             getListChgCntFunc = (GetListChgCntFunc_t) GetThreadMemberObjListChgCnt;
             getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextSemaphore;
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintSemaphoreInfo;
+            nodeSize          = sizeof(Semaphore_t);
             break;
 
         case INSPECT_INSP_TYPE_IPC_SERVERS:
@@ -3810,6 +4063,7 @@ static void InspectFunc
             getListChgCntFunc = (GetListChgCntFunc_t) GetInterfaceObjMapChgCnt;
             getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextServiceObj;
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintServiceObjInfo;
+            nodeSize          = sizeof(msgInterface_Service_t);
             break;
 
         case INSPECT_INSP_TYPE_IPC_CLIENTS:
@@ -3817,6 +4071,7 @@ static void InspectFunc
             getListChgCntFunc = (GetListChgCntFunc_t) GetInterfaceObjMapChgCnt;
             getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextClientObj;
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintClientObjInfo;
+            nodeSize          = sizeof(msgInterface_ClientInterface_t);
             break;
 
         case INSPECT_INSP_TYPE_IPC_SERVERS_SESSIONS:
@@ -3825,14 +4080,26 @@ static void InspectFunc
             getListChgCntFunc = (GetListChgCntFunc_t) GetSessionListChgCnt;
             getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextSessionObj;
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintSessionObjInfo;
+            nodeSize          = sizeof(msgSession_Session_t);
             break;
 
         default:
             INTERNAL_ERR("unexpected inspect type %d.", inspectType);
     }
 
-    // Create an iterator.
-    void* iterRef = createIterFunc();
+    // Walk the remote list into a local snapshot before printing anything, so that the time spent
+    // formatting and writing the output doesn't widen the window in which the remote process can
+    // change the list under us. If it changes anyway, try again a few times before giving up.
+    size_t nodeCount = 0;
+    InspectEndStatus_t endStatus = INSPECT_INTERRUPTED;
+    int attempt;
+
+    for (attempt = 0; (attempt < MAX_SNAPSHOT_ATTEMPTS) && (endStatus == INSPECT_INTERRUPTED);
+         attempt++)
+    {
+        endStatus = TakeSnapshot(createIterFunc, getListChgCntFunc, getNextNodeFunc, nodeSize,
+                                 &nodeCount);
+    }
 
     static int lineCount = 0;
 
@@ -3846,44 +4113,402 @@ static void InspectFunc
 
     lineCount += PrintInspectHeader();
 
+    size_t i;
 
-    // Iterate through the list of nodes.
-    size_t initialChangeCount = getListChgCntFunc(iterRef);
-    size_t currentChangeCount;
-    void* nodeRef = NULL;
+    for (i = 0; i < nodeCount; i++)
+    {
+        lineCount += printNodeInfoFunc(Snapshot.bufPtr + (i * nodeSize));
+    }
 
-    do
+    // Note that InspectFunc is called multiple times when the "interval mode" is on, so don't
+    // close the fd "FdProcMem". Let the OS handle the cleanup.
+    lineCount += InspectEndHandling(endStatus);
+
+    return;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of attempts at reading a consistent copy of a statistics record before giving
+ * up on it.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_STATS_READ_ATTEMPTS             100
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps the statistics page published by a process.
+ *
+ * @return
+ *      Pointer to the read-only page, or NULL if the process doesn't publish one (e.g. it doesn't
+ *      use the Legato framework). Must be unmapped with munmap() when done.
+ */
+//--------------------------------------------------------------------------------------------------
+static const stats_Page_t* MapStatsPage
+(
+    pid_t pid ///< [IN] Process whose page is to be mapped.
+)
+{
+    char fdDirPath[LIMIT_MAX_PATH_BYTES];
+    snprintf(fdDirPath, sizeof(fdDirPath), "/proc/%d/fd", pid);
+
+    DIR* dirPtr = opendir(fdDirPath);
+
+    if (dirPtr == NULL)
+    {
+        return NULL;
+    }
+
+    const stats_Page_t* pagePtr = NULL;
+    struct dirent* entryPtr;
+
+    // The segment is a memfd or an unlinked file, either way the link of its fd contains the
+    // segment name.
+    while ((pagePtr == NULL) && ((entryPtr = readdir(dirPtr)) != NULL))
     {
-        nodeRef = getNextNodeFunc(iterRef);
+        char fdPath[LIMIT_MAX_PATH_BYTES];
+        char linkTarget[LIMIT_MAX_PATH_BYTES];
 
-        if (nodeRef != NULL)
+        if (entryPtr->d_name[0] == '.')
         {
-            lineCount += printNodeInfoFunc(nodeRef);
+            continue;
         }
 
-        currentChangeCount = getListChgCntFunc(iterRef);
+        snprintf(fdPath, sizeof(fdPath), "%s/%s", fdDirPath, entryPtr->d_name);
+
+        ssize_t linkSize = readlink(fdPath, linkTarget, sizeof(linkTarget) - 1);
+
+        if (linkSize <= 0)
+        {
+            continue;
+        }
+
+        linkTarget[linkSize] = '\0';
+
+        if (strstr(linkTarget, STATS_SEGMENT_NAME) == NULL)
+        {
+            continue;
+        }
+
+        int fd = open(fdPath, O_RDONLY);
+
+        if (fd == -1)
+        {
+            continue;
+        }
+
+        struct stat fileStat;
+
+        if ((fstat(fd, &fileStat) == 0) && (fileStat.st_size >= sizeof(stats_Page_t)))
+        {
+            void* mapPtr = mmap(NULL, sizeof(stats_Page_t), PROT_READ, MAP_SHARED, fd, 0);
+
+            if (mapPtr != MAP_FAILED)
+            {
+                pagePtr = mapPtr;
+
+                if (   (__atomic_load_n(&pagePtr->magic, __ATOMIC_ACQUIRE) != STATS_MAGIC)
+                    || (pagePtr->version != STATS_VERSION)
+                    || (pagePtr->pageSize != sizeof(stats_Page_t)) )
+                {
+                    munmap(mapPtr, sizeof(stats_Page_t));
+                    pagePtr = NULL;
+                }
+            }
+        }
+
+        fd_Close(fd);
+    }
+
+    closedir(dirPtr);
+
+    return pagePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes a consistent copy of a record of a statistics page. Records all start with a sequence lock
+ * followed by a state, see stats.h.
+ *
+ * @return
+ *      true if the copy holds a record in use.
+ *      false if the record is not in use, or couldn't be read consistently.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadStatsRecord
+(
+    const void* recPtr, ///< [IN] Record in the page.
+    void* copyPtr,      ///< [OUT] Where to copy the record.
+    size_t recSize      ///< [IN] Size of the record.
+)
+{
+    const uint32_t* seqPtr = recPtr;
+    int attempt;
+
+    for (attempt = 0; attempt < MAX_STATS_READ_ATTEMPTS; attempt++)
+    {
+        uint32_t seq = __atomic_load_n(seqPtr, __ATOMIC_ACQUIRE);
+
+        if (seq & 1)
+        {
+            continue;
+        }
+
+        memcpy(copyPtr, recPtr, recSize);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(seqPtr, __ATOMIC_RELAXED) == seq)
+        {
+            return (((const uint32_t*)copyPtr)[1] == STATS_RECORD_USED);
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the statistics published by a process.
+ *
+ * @return
+ *      Number of lines printed in the human-readable format.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PrintProcessStats
+(
+    pid_t pid,                  ///< [IN] Process to print the statistics of.
+    const stats_Page_t* pagePtr ///< [IN] Page published by the process.
+)
+{
+    int lineCount = 0;
+
+    char procName[LIMIT_MAX_PROCESS_NAME_BYTES] = "";
+    char commPath[LIMIT_MAX_PATH_BYTES];
+    snprintf(commPath, sizeof(commPath), "/proc/%d/comm", pid);
+
+    FILE* commFilePtr = fopen(commPath, "r");
+
+    if (commFilePtr != NULL)
+    {
+        if (fgets(procName, sizeof(procName), commFilePtr) != NULL)
+        {
+            procName[strcspn(procName, "\n")] = '\0';
+        }
+        fclose(commFilePtr);
     }
-    // Access the next node only if the current node is not NULL and there has been no changes to
-    // the node list.
-    while ((nodeRef != NULL) && (currentChangeCount == initialChangeCount));
 
-    // If the loop terminated because the next node is NULL and there has been no changes to the
-    // node list, then we can delcare the end of list has been reached.
-    if ((nodeRef == NULL) && (currentChangeCount == initialChangeCount))
+    uint32_t counters[STATS_NUM_COUNTERS];
+    int i;
+
+    for (i = 0; i < STATS_NUM_COUNTERS; i++)
     {
-        lineCount += InspectEndHandling(INSPECT_SUCCESS);
+        counters[i] = __atomic_load_n(&pagePtr->counters[i], __ATOMIC_RELAXED);
+    }
+
+    uint32_t eventQueueDepth = counters[STATS_EVENTS_QUEUED] - counters[STATS_EVENTS_PROCESSED];
+    uint32_t numTimers = counters[STATS_TIMERS_CREATED] - counters[STATS_TIMERS_DELETED];
+
+    // Take a copy of all records in use first, so that the totals and the details agree.
+    static stats_PoolRecord_t pools[STATS_MAX_POOLS];
+    static stats_SessionRecord_t sessions[STATS_MAX_SESSIONS];
+    size_t numPools = 0;
+    size_t numSessions = 0;
+    size_t numBlocksInUse = 0;
+    uint64_t txMessages = 0;
+    uint64_t rxMessages = 0;
+
+    for (i = 0; i < STATS_MAX_POOLS; i++)
+    {
+        if (ReadStatsRecord(&pagePtr->pools[i], &pools[numPools], sizeof(pools[0])))
+        {
+            numBlocksInUse += pools[numPools].numBlocksInUse;
+            numPools++;
+        }
+    }
+
+    for (i = 0; i < STATS_MAX_SESSIONS; i++)
+    {
+        if (ReadStatsRecord(&pagePtr->sessions[i], &sessions[numSessions], sizeof(sessions[0])))
+        {
+            txMessages += sessions[numSessions].txMessages;
+            rxMessages += sessions[numSessions].rxMessages;
+            numSessions++;
+        }
+    }
+
+    size_t j;
+
+    if (IsOutputJson)
+    {
+        if (!IsPrintedNodeFirst)
+        {
+            printf(",");
+        }
+        IsPrintedNodeFirst = false;
+
+        printf("{\"pid\":%d,\"name\":\"%s\",\"eventQueueDepth\":%" PRIu32 ",\"timers\":%" PRIu32
+               ",\"timerExpiries\":%" PRIu32 ",\"fdDispatches\":%" PRIu32
+               ",\"droppedPools\":%" PRIu32 ",\"droppedSessions\":%" PRIu32 ",\"pools\":[",
+               pid, procName, eventQueueDepth, numTimers, counters[STATS_TIMER_EXPIRIES],
+               counters[STATS_FD_DISPATCHES], pagePtr->droppedPools, pagePtr->droppedSessions);
+
+        for (j = 0; j < numPools; j++)
+        {
+            printf("%s{\"name\":\"%s\",\"numAllocations\":%" PRIu64 ",\"numOverflows\":%" PRIu32
+                   ",\"totalBlocks\":%" PRIu32 ",\"numBlocksInUse\":%" PRIu32
+                   ",\"maxNumBlocksUsed\":%" PRIu32 "}",
+                   (j == 0) ? "" : ",", pools[j].name, pools[j].numAllocations,
+                   pools[j].numOverflows, pools[j].totalBlocks, pools[j].numBlocksInUse,
+                   pools[j].maxNumBlocksUsed);
+        }
+
+        printf("],\"sessions\":[");
+
+        for (j = 0; j < numSessions; j++)
+        {
+            printf("%s{\"interface\":\"%s\",\"isServer\":%s,\"txMessages\":%" PRIu64
+                   ",\"rxMessages\":%" PRIu64 ",\"txBytes\":%" PRIu64 ",\"rxBytes\":%" PRIu64 "}",
+                   (j == 0) ? "" : ",", sessions[j].name,
+                   sessions[j].isServer ? "true" : "false", sessions[j].txMessages,
+                   sessions[j].rxMessages, sessions[j].txBytes, sessions[j].rxBytes);
+        }
+
+        printf("]}");
+
+        return 0;
+    }
+
+    printf("%-8d %-16s %8" PRIu32 " %8" PRIu32 " %10" PRIu32 " %10" PRIu32 " %6zu %8zu %8zu"
+           " %10" PRIu64 " %10" PRIu64 "\n",
+           pid, procName, eventQueueDepth, numTimers, counters[STATS_TIMER_EXPIRIES],
+           counters[STATS_FD_DISPATCHES], numPools, numBlocksInUse, numSessions,
+           txMessages, rxMessages);
+    lineCount++;
+
+    if (IsVerbose)
+    {
+        for (j = 0; j < numPools; j++)
+        {
+            printf("    pool    %-32s in use %6" PRIu32 " / %-6" PRIu32 " max %6" PRIu32
+                   " allocs %10" PRIu64 " overflows %6" PRIu32 "\n",
+                   pools[j].name, pools[j].numBlocksInUse, pools[j].totalBlocks,
+                   pools[j].maxNumBlocksUsed, pools[j].numAllocations, pools[j].numOverflows);
+            lineCount++;
+        }
+
+        for (j = 0; j < numSessions; j++)
+        {
+            printf("    session %-32s %-6s tx %8" PRIu64 " msgs %10" PRIu64 " bytes"
+                   "  rx %8" PRIu64 " msgs %10" PRIu64 " bytes\n",
+                   sessions[j].name, sessions[j].isServer ? "server" : "client",
+                   sessions[j].txMessages, sessions[j].txBytes,
+                   sessions[j].rxMessages, sessions[j].rxBytes);
+            lineCount++;
+        }
+
+        if ((pagePtr->droppedPools != 0) || (pagePtr->droppedSessions != 0))
+        {
+            printf("    (%" PRIu32 " pools and %" PRIu32 " sessions not published)\n",
+                   pagePtr->droppedPools, pagePtr->droppedSessions);
+            lineCount++;
+        }
+    }
+
+    return lineCount;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the live statistics published by the process under inspection, or by every process on
+ * the system if no PID was given. Unlike the other inspections, this reads the statistics page that
+ * each process keeps up to date itself instead of walking its data structures.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InspectStats
+(
+    void
+)
+{
+    static int lineCount = 0;
+
+    if (!IsOutputJson)
+    {
+        printf("%c[1G", ESCAPE_CHAR);             // Move cursor to the column 1.
+        printf("%c[%dA", ESCAPE_CHAR, lineCount); // Move cursor up to the top of the table.
+        printf("%c[0J", ESCAPE_CHAR);             // Clear Screen.
+
+        lineCount = 0;
+
+        printf("%-8s %-16s %8s %8s %10s %10s %6s %8s %8s %10s %10s\n",
+               "PID", "NAME", "EVENTQ", "TIMERS", "EXPIRIES", "FD CALLS", "POOLS", "BLOCKS",
+               "SESSIONS", "TX MSGS", "RX MSGS");
+        lineCount++;
     }
-    // Detected changes to the node list.
     else
     {
-        lineCount += InspectEndHandling(INSPECT_INTERRUPTED);
+        IsPrintedNodeFirst = true;
+        printf("{\"Processes\":[");
     }
 
-    // Note that InspectFunc is called multiple times when the "interval mode" is on, so don't
-    // close the fd "FdProcMem". Let the OS handle the cleanup.
-    le_mem_Release(iterRef);
+    if (PidToInspect > 0)
+    {
+        const stats_Page_t* pagePtr = MapStatsPage(PidToInspect);
 
-    return;
+        if (pagePtr == NULL)
+        {
+            fprintf(stderr, "Process %d does not publish statistics.\n", PidToInspect);
+            exit(EXIT_FAILURE);
+        }
+
+        lineCount += PrintProcessStats(PidToInspect, pagePtr);
+        munmap((void*)pagePtr, sizeof(stats_Page_t));
+    }
+    else
+    {
+        DIR* procDirPtr = opendir("/proc");
+        INTERNAL_ERR_IF(procDirPtr == NULL, "Could not open /proc. %m.");
+
+        struct dirent* entryPtr;
+
+        while ((entryPtr = readdir(procDirPtr)) != NULL)
+        {
+            int pid;
+
+            if (   (le_utf8_ParseInt(&pid, entryPtr->d_name) != LE_OK)
+                || (pid <= 0) )
+            {
+                continue;
+            }
+
+            const stats_Page_t* pagePtr = MapStatsPage(pid);
+
+            if (pagePtr != NULL)
+            {
+                lineCount += PrintProcessStats(pid, pagePtr);
+                munmap((void*)pagePtr, sizeof(stats_Page_t));
+            }
+        }
+
+        closedir(procDirPtr);
+    }
+
+    if (IsOutputJson)
+    {
+        printf("]}\n");
+    }
+
+    fflush(stdout);
+
+    if (IsFollowing)
+    {
+        le_clk_Time_t refreshInterval = { RefreshInterval, 0 };
+        StartRefreshTimer(refreshInterval);
+    }
 }
 
 
@@ -3898,7 +4523,14 @@ static void RefreshTimerHandler
 )
 {
     // Perform the inspection.
-    InspectFunc(InspectType);
+    if (InspectType == INSPECT_INSP_TYPE_STATS)
+    {
+        InspectStats();
+    }
+    else
+    {
+        InspectFunc(InspectType);
+    }
 }
 
 
@@ -3928,6 +4560,32 @@ static void PidArgHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function called by command line argument scanner when the pid argument of the stats command is
+ * found. Unlike the other inspections, this one doesn't need access to the process's memory.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void StatsPidArgHandler
+(
+    const char* pidStr
+)
+{
+    int pid;
+    le_result_t result = le_utf8_ParseInt(&pid, pidStr);
+
+    if ((result == LE_OK) && (pid > 0))
+    {
+        PidToInspect = pid;
+    }
+    else
+    {
+        fprintf(stderr, "Invalid PID (%s).\n", pidStr);
+        exit(EXIT_FAILURE);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * IPC sessions argument handler.
@@ -4028,13 +4686,21 @@ static void CommandArgHandler
     {
         le_arg_AddPositionalCallback(IpcInterfaceTypeHandler);
     }
+    else if (strcmp(command, "stats") == 0)
+    {
+        InspectType = INSPECT_INSP_TYPE_STATS;
+
+        // The PID is optional; without it, all processes are inspected.
+        le_arg_AddPositionalCallback(StatsPidArgHandler);
+        le_arg_AllowLessPositionalArgsThanCallbacks();
+    }
     else
     {
         fprintf(stderr, "Invalid command '%s'.\n", command);
         exit(EXIT_FAILURE);
     }
 
-    if (strcmp(command, "ipc") != 0)
+    if ((strcmp(command, "ipc") != 0) && (strcmp(command, "stats") != 0))
     {
         le_arg_AddPositionalCallback(PidArgHandler);
     }
@@ -4171,13 +4837,20 @@ COMPONENT_INIT
 
     le_arg_Scan();
 
-    // Create a memory pool for iterators.
-    InitIteratorPool(InspectType);
+    if (InspectType == INSPECT_INSP_TYPE_STATS)
+    {
+        InspectStats();
+    }
+    else
+    {
+        // Create a memory pool for iterators.
+        InitIteratorPool(InspectType);
 
-    InitDisplay(InspectType);
+        InitDisplay(InspectType);
 
-    // Start the inspection.
-    InspectFunc(InspectType);
+        // Start the inspection.
+        InspectFunc(InspectType);
+    }
 
     if (!IsFollowing)
     {
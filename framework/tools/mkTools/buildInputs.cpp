@@ -0,0 +1,250 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file buildInputs.cpp
+ *
+ * Tracking of the input files (.sdef, .adef, .cdef, .mdef, .api, and any files they #include)
+ * read by the mk tools, so a regeneration of the build script can be skipped when none of their
+ * contents have changed.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "mkTools.h"
+
+
+namespace buildInputs
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Paths to all the input files read so far.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::set<std::string> InputFiles;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the file system path to the file in which the input file hashes are saved.
+ **/
+//--------------------------------------------------------------------------------------------------
+static std::string GetSaveFilePath
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return path::Combine(buildParams.workingDir, "mktool_inputs");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the MD5 hash of a file's contents.
+ *
+ * @return The hash, or "" if the file can't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string HashFile
+(
+    const std::string& path
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::ifstream inputFile(path);
+
+    if (!inputFile.is_open())
+    {
+        return "";
+    }
+
+    std::stringstream contents;
+    contents << inputFile.rdbuf();
+
+    if (inputFile.bad())
+    {
+        return "";
+    }
+
+    return md5(contents.str());
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record that a given file has been read while building the conceptual model.
+ */
+//--------------------------------------------------------------------------------------------------
+void Add
+(
+    const std::string& path ///< Path to the file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Files may be referred to by relative or absolute paths, so always store absolute paths to
+    // avoid listing the same file twice.
+    InputFiles.insert(path::Minimize(path::MakeAbsolute(path)));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the set of all the input files that have been read so far.
+ *
+ * The build script must be regenerated if any of these change, so they should all be listed as
+ * dependencies of the build.ninja file.
+ */
+//--------------------------------------------------------------------------------------------------
+const std::set<std::string>& GetAll
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return InputFiles;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Saves the paths and content hashes of all the input files that have been read (in a file in the
+ * build's working directory) for later use by MatchesSaved().
+ */
+//--------------------------------------------------------------------------------------------------
+void Save
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto filePath = GetSaveFilePath(buildParams);
+
+    // Make sure the containing directory exists.
+    file::MakeDir(buildParams.workingDir);
+
+    // Open the file
+    std::ofstream saveFile(filePath);
+    if (!saveFile.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for writing."), filePath)
+        );
+    }
+
+    // The generated files also depend on the mk tools themselves, so include them too.
+    std::set<std::string> allInputs(InputFiles);
+    auto mkToolPath = path::Combine(envVars::Get("LEGATO_ROOT"), "build/tools/mk");
+    if (file::FileExists(mkToolPath))
+    {
+        allInputs.insert(mkToolPath);
+    }
+
+    // Write each file's hash and path as a line in the file.
+    for (auto& inputPath : allInputs)
+    {
+        saveFile << HashFile(inputPath) << ' ' << inputPath << '\n';
+
+        if (saveFile.fail())
+        {
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Error writing to file '%s'."), filePath)
+            );
+        }
+    }
+
+    // Close the file.
+    saveFile.close();
+    if (saveFile.fail())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Error closing file '%s'."), filePath)
+        );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the contents of the input files listed by the last call to Save() against their saved
+ * content hashes.
+ *
+ * @return true if none of the input files' contents have changed, or
+ *         false if any input file has changed or disappeared (or nothing was saved).
+ */
+//--------------------------------------------------------------------------------------------------
+bool MatchesSaved
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto filePath = GetSaveFilePath(buildParams);
+
+    if (!file::FileExists(filePath))
+    {
+        if (buildParams.beVerbose)
+        {
+            std::cout << LE_I18N("Input file hashes from previous run not found.") << std::endl;
+        }
+        return false;
+    }
+
+    // Open the file
+    std::ifstream saveFile(filePath);
+    if (!saveFile.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for reading."), filePath)
+        );
+    }
+
+    std::string line;
+    size_t fileCount = 0;
+
+    // Each line holds a hash, followed by a space, followed by the path of the file.
+    while (std::getline(saveFile, line))
+    {
+        auto separatorPos = line.find(' ');
+        if (separatorPos == std::string::npos)
+        {
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Malformed line '%s' in file '%s'."), line, filePath)
+            );
+        }
+
+        auto savedHash = line.substr(0, separatorPos);
+        auto inputPath = line.substr(separatorPos + 1);
+
+        if (savedHash.empty() || (HashFile(inputPath) != savedHash))
+        {
+            if (buildParams.beVerbose)
+            {
+                std::cout << mk::format(LE_I18N("Input file '%s' has changed."), inputPath)
+                          << std::endl;
+            }
+            return false;
+        }
+
+        fileCount++;
+    }
+
+    if (saveFile.bad())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Error reading from file '%s'."), filePath)
+        );
+    }
+
+    if (buildParams.beVerbose)
+    {
+        std::cout << mk::format(LE_I18N("None of the %zu input files have changed."), fileCount)
+                  << std::endl;
+    }
+
+    return (fileCount > 0);
+}
+
+
+} // namespace buildInputs
@@ -0,0 +1,74 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file buildInputs.h
+ *
+ * Tracking of the input files (.sdef, .adef, .cdef, .mdef, .api, and any files they #include)
+ * read by the mk tools, so a regeneration of the build script can be skipped when none of their
+ * contents have changed.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_MKTOOLS_BUILD_INPUTS_H_INCLUDE_GUARD
+#define LEGATO_MKTOOLS_BUILD_INPUTS_H_INCLUDE_GUARD
+
+namespace buildInputs
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record that a given file has been read while building the conceptual model.
+ */
+//--------------------------------------------------------------------------------------------------
+void Add
+(
+    const std::string& path ///< Path to the file.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the set of all the input files that have been read so far.
+ *
+ * The build script must be regenerated if any of these change, so they should all be listed as
+ * dependencies of the build.ninja file.
+ */
+//--------------------------------------------------------------------------------------------------
+const std::set<std::string>& GetAll
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Saves the paths and content hashes of all the input files that have been read (in a file in the
+ * build's working directory) for later use by MatchesSaved().
+ */
+//--------------------------------------------------------------------------------------------------
+void Save
+(
+    const mk::BuildParams_t& buildParams
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the contents of the input files listed by the last call to Save() against their saved
+ * content hashes.
+ *
+ * @return true if none of the input files' contents have changed, or
+ *         false if any input file has changed or disappeared (or nothing was saved).
+ */
+//--------------------------------------------------------------------------------------------------
+bool MatchesSaved
+(
+    const mk::BuildParams_t& buildParams
+);
+
+
+} // namespace buildInputs
+
+#endif // LEGATO_MKTOOLS_BUILD_INPUTS_H_INCLUDE_GUARD
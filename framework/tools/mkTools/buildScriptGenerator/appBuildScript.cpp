@@ -619,12 +619,13 @@ static void GenerateNinjaScriptBuildStatement
 //--------------------------------------------------------------------------------------------------
 {
     // Generate a build statement for the build.ninja.
-    script << "build " << filePath << ": RegenNinjaScript | " << appPtr->defFilePtr->path;
+    script << "build " << filePath << ": RegenNinjaScript |";
 
-    // In addition to the .adef file, the build.ninja depends on the .cdef files of all components
+    // The build.ninja depends on the .adef file, the .cdef files of all components
     // and all the .api files they use.
     // Create a set of dependencies.
     std::set<std::string> dependencies;
+    dependencies.insert(appPtr->defFilePtr->path);
     for (auto componentPtr : appPtr->components)
     {
         dependencies.insert(componentPtr->defFilePtr->path);
@@ -655,6 +656,10 @@ static void GenerateNinjaScriptBuildStatement
         }
     }
 
+    // Also depend on every other file read while building the model (e.g., #included files and
+    // .api files pulled in through USETYPES statements in other .api files).
+    dependencies.insert(buildInputs::GetAll().begin(), buildInputs::GetAll().end());
+
     // Write the dependencies to the script.
     for (auto dep : dependencies)
     {
@@ -233,10 +233,12 @@ void GenerateBuildRules
               "            CFLAGS=\"$cFlags\" CXXFLAGS=\"$cxxFlags\" LDFLAGS=\"$ldFlags\""
               "            cd $builddir/$workingdir; $externalCommand\n";
 
-    // Generate a rule for running ifgen.
+    // Generate a rule for running ifgen in batch mode.  ifgen only rewrites generated files whose
+    // contents have changed, so tell ninja to re-check the outputs' timestamps afterwards.
     script << "rule GenInterfaceCode\n"
               "  description = Generating IPC interface code\n"
-              "  command = ifgen --output-dir $outputDir $ifgenFlags $in\n"
+              "  command = ifgen --batch $in $ifgenFlags\n"
+              "  restat = 1\n"
               "\n";
 
     // Generate a rule for creating a hard link.
@@ -300,27 +302,53 @@ void GenerateRunPathLdFlags
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write out to a given script file a space-separated list of paths to all the .api files needed
- * by a given .api file (specified through USETYPES statements in the .api files).
+ * Add to a given set the paths to all the .api files needed by a given .api file (specified
+ * through USETYPES statements in the .api files).
  **/
 //--------------------------------------------------------------------------------------------------
 static void GetIncludedApis
 (
-    std::ofstream& script,  ///< Build script to write to.
+    std::set<std::string>& apiFiles,    ///< Set to add the .api file paths to.
     const model::ApiFile_t* apiFilePtr
 )
 //--------------------------------------------------------------------------------------------------
 {
     for (auto includedApiPtr : apiFilePtr->includes)
     {
-        script << " " << includedApiPtr->path;
+        apiFiles.insert(includedApiPtr->path);
 
         // Recurse.
-        GetIncludedApis(script, includedApiPtr);
+        GetIncludedApis(apiFiles, includedApiPtr);
     }
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a job to an ifgen batch.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void AddIfgenJob
+(
+    IfgenBatch_t& ifgenBatch,   ///< Batch to add the job to.
+    const std::list<std::string>& generatedFiles, ///< Paths (as used in the script) of outputs.
+    const std::string& ifgenFlags,  ///< ifgen command-line flags for this job.
+    const std::string& outputDir,   ///< Directory to put the generated files in.
+    const model::ApiFile_t* apiFilePtr  ///< The .api file to generate code for.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ifgenBatch.jobs.push_back(ifgenFlags + " --output-dir " + outputDir + " " + apiFilePtr->path);
+
+    ifgenBatch.outputFiles.insert(ifgenBatch.outputFiles.end(),
+                                  generatedFiles.begin(),
+                                  generatedFiles.end());
+
+    ifgenBatch.apiFiles.insert(apiFilePtr->path);
+    GetIncludedApis(ifgenBatch.apiFiles, apiFilePtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print to a given script a build statement for building the interface header file for a given
@@ -330,7 +358,7 @@ static void GetIncludedApis
 //--------------------------------------------------------------------------------------------------
 static void GenerateClientUsetypesHFileBuildStatement
 (
-    std::ofstream& script,  ///< Build script to write to.
+    IfgenBatch_t& ifgenBatch,   ///< Batch of ifgen jobs to add to.
     const model::ApiFile_t* apiFilePtr,
     const mk::BuildParams_t& buildParams,
     std::set<std::string>& generatedSet ///< Paths to files that already have build statements.
@@ -343,13 +371,11 @@ static void GenerateClientUsetypesHFileBuildStatement
     {
         generatedSet.insert(headerFile);
 
-        script << "build $builddir/" << headerFile <<
-                  ": GenInterfaceCode " << apiFilePtr->path << " |";
-        GetIncludedApis(script, apiFilePtr);
-        script << "\n"
-                  "  outputDir = $builddir/" << path::GetContainingDir(headerFile) << "\n"
-                  "  ifgenFlags = --gen-interface $ifgenFlags\n"
-                  "\n";
+        AddIfgenJob(ifgenBatch,
+                    { "$builddir/" + headerFile },
+                    "--gen-interface",
+                    path::Combine(buildParams.workingDir, path::GetContainingDir(headerFile)),
+                    apiFilePtr);
     }
 }
 
@@ -363,7 +389,7 @@ static void GenerateClientUsetypesHFileBuildStatement
 //--------------------------------------------------------------------------------------------------
 static void GenerateServerUsetypesHFileBuildStatement
 (
-    std::ofstream& script,  ///< Build script to write to.
+    IfgenBatch_t& ifgenBatch,   ///< Batch of ifgen jobs to add to.
     const model::ApiFile_t* apiFilePtr,
     const mk::BuildParams_t& buildParams,
     std::set<std::string>& generatedSet ///< Paths to files that already have build statements.
@@ -376,13 +402,11 @@ static void GenerateServerUsetypesHFileBuildStatement
     {
         generatedSet.insert(headerFile);
 
-        script << "build $builddir/" << headerFile <<
-                  ": GenInterfaceCode " << apiFilePtr->path << " |";
-        GetIncludedApis(script, apiFilePtr);
-        script << "\n"
-                  "  outputDir = $builddir/" << path::GetContainingDir(headerFile) << "\n"
-                  "  ifgenFlags = --gen-server-interface $ifgenFlags\n"
-                  "\n";
+        AddIfgenJob(ifgenBatch,
+                    { "$builddir/" + headerFile },
+                    "--gen-server-interface",
+                    path::Combine(buildParams.workingDir, path::GetContainingDir(headerFile)),
+                    apiFilePtr);
     }
 }
 
@@ -395,7 +419,7 @@ static void GenerateServerUsetypesHFileBuildStatement
 //--------------------------------------------------------------------------------------------------
 static void GenerateBuildStatement
 (
-    std::ofstream& script,  ///< Build script to write to.
+    IfgenBatch_t& ifgenBatch,   ///< Batch of ifgen jobs to add to.
     const model::ApiTypesOnlyInterface_t* ifPtr,
     const mk::BuildParams_t& buildParams,
     std::set<std::string>& generatedSet ///< Paths to files that already have build statements.
@@ -409,15 +433,12 @@ static void GenerateBuildStatement
     {
         generatedSet.insert(cFiles.interfaceFile);
 
-        script << "build $builddir/" << cFiles.interfaceFile << ":"
-                  " GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
-        GetIncludedApis(script, ifPtr->apiFilePtr);
-        script << "\n"
-                  "  ifgenFlags = --gen-interface"
-                  " --name-prefix " << ifPtr->internalName <<
-                  " $ifgenFlags\n"
-                  "  outputDir = $builddir/" << path::GetContainingDir(cFiles.interfaceFile) << "\n"
-                  "\n";
+        AddIfgenJob(ifgenBatch,
+                    { "$builddir/" + cFiles.interfaceFile },
+                    "--gen-interface --name-prefix " + ifPtr->internalName,
+                    path::Combine(buildParams.workingDir,
+                                  path::GetContainingDir(cFiles.interfaceFile)),
+                    ifPtr->apiFilePtr);
     }
 }
 
@@ -431,6 +452,7 @@ static void GenerateBuildStatement
 static void GenerateBuildStatement
 (
     std::ofstream& script,  ///< Build script to write to.
+    IfgenBatch_t& ifgenBatch,   ///< Batch of ifgen jobs to add to.
     const model::ApiClientInterface_t* ifPtr,
     const mk::BuildParams_t& buildParams,
     std::set<std::string>& generatedSet ///< Paths to files that already have build statements.
@@ -482,35 +504,35 @@ static void GenerateBuildStatement
     }
 
     // .c file and .h files
-    std::string generatedFiles;
+    std::list<std::string> generatedFiles;
     std::string ifgenFlags;
     if (generatedSet.find(cFiles.sourceFile) == generatedSet.end())
     {
         generatedSet.insert(cFiles.sourceFile);
-        generatedFiles += " $builddir/" + cFiles.sourceFile;
-        ifgenFlags += " --gen-client";
+        generatedFiles.push_back("$builddir/" + cFiles.sourceFile);
+        ifgenFlags += "--gen-client ";
     }
     if (generatedSet.find(cFiles.interfaceFile) == generatedSet.end())
     {
         generatedSet.insert(cFiles.interfaceFile);
-        generatedFiles += " $builddir/" + cFiles.interfaceFile;
-        ifgenFlags += " --gen-interface";
+        generatedFiles.push_back("$builddir/" + cFiles.interfaceFile);
+        ifgenFlags += "--gen-interface ";
     }
     if (generatedSet.find(cFiles.internalHFile) == generatedSet.end())
     {
         generatedSet.insert(cFiles.internalHFile);
-        generatedFiles += " $builddir/" + cFiles.internalHFile;
-        ifgenFlags += " --gen-local";
+        generatedFiles.push_back("$builddir/" + cFiles.internalHFile);
+        ifgenFlags += "--gen-local ";
     }
     if (!generatedFiles.empty())
     {
-        ifgenFlags += " --name-prefix " + ifPtr->internalName;
-        script << "build" << generatedFiles <<
-                  ": GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
-        GetIncludedApis(script, ifPtr->apiFilePtr);
-        script << "\n"
-                  "  ifgenFlags =" << ifgenFlags << " $ifgenFlags\n"
-                  "  outputDir = $builddir/" << path::GetContainingDir(cFiles.sourceFile) << "\n\n";
+        ifgenFlags += "--name-prefix " + ifPtr->internalName;
+        AddIfgenJob(ifgenBatch,
+                    generatedFiles,
+                    ifgenFlags,
+                    path::Combine(buildParams.workingDir,
+                                  path::GetContainingDir(cFiles.sourceFile)),
+                    ifPtr->apiFilePtr);
     }
 }
 
@@ -522,7 +544,7 @@ static void GenerateBuildStatement
 //--------------------------------------------------------------------------------------------------
 static void GenerateJavaBuildStatement
 (
-    std::ofstream& script,  ///< Build script to write to.
+    IfgenBatch_t& ifgenBatch,   ///< Batch of ifgen jobs to add to.
     const model::InterfaceJavaFiles_t& javaFiles,
     const model::Component_t* componentPtr,
     const model::ApiFile_t* apiFilePtr,
@@ -535,18 +557,12 @@ static void GenerateJavaBuildStatement
 {
     std::string apiFlag = isClient ? "--gen-client" : "--gen-server";
 
-    script << "build " << path::Combine(workDir, javaFiles.interfaceSourceFile) << " $\n"
-              "      " << path::Combine(workDir, javaFiles.implementationSourceFile) << " : $\n"
-              "      GenInterfaceCode " << apiFilePtr->path << " | ";
-
-    GetIncludedApis(script, apiFilePtr);
-
-    script << "\n"
-              "  ifgenFlags = --lang Java --gen-interface " << apiFlag << " --name-prefix "
-           << internalName << " $ifgenFlags\n"
-              "  outputDir = " << path::Combine(workDir,
-                                                path::Combine(componentPtr->workingDir, "src"))
-           << "\n\n";
+    AddIfgenJob(ifgenBatch,
+                { path::Combine(workDir, javaFiles.interfaceSourceFile),
+                  path::Combine(workDir, javaFiles.implementationSourceFile) },
+                "--lang Java --gen-interface " + apiFlag + " --name-prefix " + internalName,
+                path::Combine(workDir, path::Combine(componentPtr->workingDir, "src")),
+                apiFilePtr);
 }
 
 
@@ -557,7 +573,7 @@ static void GenerateJavaBuildStatement
 //--------------------------------------------------------------------------------------------------
 static void GenerateJavaBuildStatement
 (
-    std::ofstream& script,  ///< Build script to write to.
+    IfgenBatch_t& ifgenBatch,   ///< Batch of ifgen jobs to add to.
     const model::ApiClientInterface_t* ifPtr,
     const mk::BuildParams_t& buildParams,
     std::set<std::string>& generatedSet ///< Paths to files that already have build statements.
@@ -567,7 +583,7 @@ static void GenerateJavaBuildStatement
     model::InterfaceJavaFiles_t javaFiles;
     ifPtr->GetInterfaceFiles(javaFiles);
 
-    GenerateJavaBuildStatement(script,
+    GenerateJavaBuildStatement(ifgenBatch,
                                javaFiles,
                                ifPtr->componentPtr,
                                ifPtr->apiFilePtr,
@@ -587,6 +603,7 @@ static void GenerateJavaBuildStatement
 static void GenerateBuildStatement
 (
     std::ofstream& script,  ///< Build script to write to.
+    IfgenBatch_t& ifgenBatch,   ///< Batch of ifgen jobs to add to.
     const model::ApiServerInterface_t* ifPtr,
     const mk::BuildParams_t& buildParams,
     std::set<std::string>& generatedSet ///< Paths to files that already have build statements.
@@ -638,40 +655,39 @@ static void GenerateBuildStatement
     }
 
     // .c file and .h files
-    std::string generatedFiles;
+    std::list<std::string> generatedFiles;
     std::string ifgenFlags;
     if (generatedSet.find(cFiles.sourceFile) == generatedSet.end())
     {
         generatedSet.insert(cFiles.sourceFile);
-        generatedFiles += " $builddir/" + cFiles.sourceFile;
-        ifgenFlags += " --gen-server";
+        generatedFiles.push_back("$builddir/" + cFiles.sourceFile);
+        ifgenFlags += "--gen-server ";
     }
     if (generatedSet.find(cFiles.interfaceFile) == generatedSet.end())
     {
         generatedSet.insert(cFiles.interfaceFile);
-        generatedFiles += " $builddir/" + cFiles.interfaceFile;
-        ifgenFlags += " --gen-server-interface";
+        generatedFiles.push_back("$builddir/" + cFiles.interfaceFile);
+        ifgenFlags += "--gen-server-interface ";
     }
     if (generatedSet.find(cFiles.internalHFile) == generatedSet.end())
     {
         generatedSet.insert(cFiles.internalHFile);
-        generatedFiles += " $builddir/" + cFiles.internalHFile;
-        ifgenFlags += " --gen-local";
+        generatedFiles.push_back("$builddir/" + cFiles.internalHFile);
+        ifgenFlags += "--gen-local ";
     }
     if (!generatedFiles.empty())
     {
         if (ifPtr->async)
         {
-            ifgenFlags += " --async-server";
+            ifgenFlags += "--async-server ";
         }
-        ifgenFlags += " --name-prefix " + ifPtr->internalName;
-        script << "build" << generatedFiles << ":"
-                  " GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
-        GetIncludedApis(script, ifPtr->apiFilePtr);
-        script << "\n"
-                  "  ifgenFlags =" << ifgenFlags << " $ifgenFlags\n"
-                  "  outputDir = $builddir/" << path::GetContainingDir(cFiles.sourceFile) << "\n"
-                  "\n";
+        ifgenFlags += "--name-prefix " + ifPtr->internalName;
+        AddIfgenJob(ifgenBatch,
+                    generatedFiles,
+                    ifgenFlags,
+                    path::Combine(buildParams.workingDir,
+                                  path::GetContainingDir(cFiles.sourceFile)),
+                    ifPtr->apiFilePtr);
     }
 }
 
@@ -683,7 +699,7 @@ static void GenerateBuildStatement
 //--------------------------------------------------------------------------------------------------
 static void GenerateJavaBuildStatement
 (
-    std::ofstream& script,  ///< Build script to write to.
+    IfgenBatch_t& ifgenBatch,   ///< Batch of ifgen jobs to add to.
     const model::ApiServerInterface_t* ifPtr,
     const mk::BuildParams_t& buildParams,
     std::set<std::string>& generatedSet ///< Paths to files that already have build statements.
@@ -693,7 +709,7 @@ static void GenerateJavaBuildStatement
     model::InterfaceJavaFiles_t javaFiles;
     ifPtr->GetInterfaceFiles(javaFiles);
 
-    GenerateJavaBuildStatement(script,
+    GenerateJavaBuildStatement(ifgenBatch,
                                javaFiles,
                                ifPtr->componentPtr,
                                ifPtr->apiFilePtr,
@@ -713,6 +729,7 @@ static void GenerateJavaBuildStatement
 void GenerateIpcBuildStatements
 (
     std::ofstream& script,
+    IfgenBatch_t& ifgenBatch,   ///< Batch to add the ifgen jobs to.
     const model::Component_t* componentPtr,
     const mk::BuildParams_t& buildParams,
     std::set<std::string>& generatedSet ///< Paths to files that already have build statements.
@@ -723,28 +740,34 @@ void GenerateIpcBuildStatements
 
     for (auto typesOnlyApi : componentPtr->typesOnlyApis)
     {
-        GenerateBuildStatement(script, typesOnlyApi, buildParams, generatedSet);
+        GenerateBuildStatement(ifgenBatch, typesOnlyApi, buildParams, generatedSet);
     }
 
     for (auto apiFilePtr : componentPtr->clientUsetypesApis)
     {
-        GenerateClientUsetypesHFileBuildStatement(script, apiFilePtr, buildParams, generatedSet);
+        GenerateClientUsetypesHFileBuildStatement(ifgenBatch,
+                                                  apiFilePtr,
+                                                  buildParams,
+                                                  generatedSet);
     }
 
     for (auto apiFilePtr : componentPtr->serverUsetypesApis)
     {
-        GenerateServerUsetypesHFileBuildStatement(script, apiFilePtr, buildParams, generatedSet);
+        GenerateServerUsetypesHFileBuildStatement(ifgenBatch,
+                                                  apiFilePtr,
+                                                  buildParams,
+                                                  generatedSet);
     }
 
     for (auto clientApi : componentPtr->clientApis)
     {
         if (isJava)
         {
-            GenerateJavaBuildStatement(script, clientApi, buildParams, generatedSet);
+            GenerateJavaBuildStatement(ifgenBatch, clientApi, buildParams, generatedSet);
         }
         else
         {
-            GenerateBuildStatement(script, clientApi, buildParams, generatedSet);
+            GenerateBuildStatement(script, ifgenBatch, clientApi, buildParams, generatedSet);
         }
     }
 
@@ -752,16 +775,63 @@ void GenerateIpcBuildStatements
     {
         if (isJava)
         {
-            GenerateJavaBuildStatement(script, serverApi, buildParams, generatedSet);
+            GenerateJavaBuildStatement(ifgenBatch, serverApi, buildParams, generatedSet);
         }
         else
         {
-            GenerateBuildStatement(script, serverApi, buildParams, generatedSet);
+            GenerateBuildStatement(script, ifgenBatch, serverApi, buildParams, generatedSet);
         }
     }
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the list of jobs in a given ifgen batch to the batch file in the working directory, and
+ * write to a given build script a single build statement that runs them all with one ifgen
+ * process.
+ *
+ * The batch file is only rewritten if its contents change, so ninja won't re-run ifgen unless
+ * the set of jobs or one of the .api files has changed.
+ **/
+//--------------------------------------------------------------------------------------------------
+void GenerateIfgenBatchBuildStatement
+(
+    std::ofstream& script,
+    const IfgenBatch_t& ifgenBatch,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (ifgenBatch.jobs.empty())
+    {
+        return;
+    }
+
+    std::stringstream batchContents;
+    for (auto& job : ifgenBatch.jobs)
+    {
+        batchContents << job << "\n";
+    }
+
+    auto batchFilePath = path::Combine(buildParams.workingDir, "ifgen_batch");
+    file::WriteIfChanged(batchFilePath, batchContents.str());
+
+    script << "build";
+    for (auto& outputFile : ifgenBatch.outputFiles)
+    {
+        script << " $\n      " << outputFile;
+    }
+    script << " : $\n"
+              "      GenInterfaceCode $builddir/ifgen_batch |";
+    for (auto& apiFile : ifgenBatch.apiFiles)
+    {
+        script << " $\n      " << apiFile;
+    }
+    script << "\n\n";
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write to a given build script the build statements for all the IPC client and server
@@ -781,11 +851,14 @@ void GenerateIpcBuildStatements
     // already generated.
 
     std::set<std::string> generatedSet;
+    IfgenBatch_t ifgenBatch;
 
     for (auto& mapEntry : model::Component_t::GetComponentMap())
     {
-        GenerateIpcBuildStatements(script, mapEntry.second, buildParams, generatedSet);
+        GenerateIpcBuildStatements(script, ifgenBatch, mapEntry.second, buildParams, generatedSet);
     }
+
+    GenerateIfgenBatchBuildStatement(script, ifgenBatch, buildParams);
 }
 
 
@@ -17,6 +17,20 @@ namespace ninja
 {
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set of ifgen jobs needed by a build script.  All the jobs are run by a single ifgen process
+ * (in batch mode), so each .api file only has to be parsed once per build.
+ **/
+//--------------------------------------------------------------------------------------------------
+struct IfgenBatch_t
+{
+    std::list<std::string> jobs;        ///< ifgen command-line arguments, one entry per job.
+    std::list<std::string> outputFiles; ///< Paths (as used in the script) of all generated files.
+    std::set<std::string> apiFiles;     ///< Paths of all .api files read by the jobs.
+};
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -101,12 +115,28 @@ void GenerateRunPathLdFlags
 void GenerateIpcBuildStatements
 (
     std::ofstream& script,
+    IfgenBatch_t& ifgenBatch,   ///< Batch to add the ifgen jobs to.
     const model::Component_t* componentPtr,
     const mk::BuildParams_t& buildParams,
     std::set<std::string>& generatedSet ///< Paths to files that already have build statements.
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the list of jobs in a given ifgen batch to the batch file in the working directory, and
+ * write to a given build script a single build statement that runs them all with one ifgen
+ * process.
+ **/
+//--------------------------------------------------------------------------------------------------
+void GenerateIfgenBatchBuildStatement
+(
+    std::ofstream& script,
+    const IfgenBatch_t& ifgenBatch,
+    const mk::BuildParams_t& buildParams
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write to a given build script the build statements for all the IPC client and server
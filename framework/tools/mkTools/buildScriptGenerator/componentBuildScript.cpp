@@ -682,16 +682,17 @@ static void GenerateIpcBuildStatements
     // already generated.
 
     std::set<std::string> generatedSet;
+    IfgenBatch_t ifgenBatch;
 
     // Use a lambda to recursively descend through the tree of sub-components.
 
     std::function<void(const model::Component_t* componentPtr)> generate;
-    generate = [&script, &generatedSet, &buildParams, &generate]
+    generate = [&script, &ifgenBatch, &generatedSet, &buildParams, &generate]
         (
             const model::Component_t* componentPtr
         )
         {
-            GenerateIpcBuildStatements(script, componentPtr, buildParams, generatedSet);
+            GenerateIpcBuildStatements(script, ifgenBatch, componentPtr, buildParams, generatedSet);
 
             for (auto subComponentPtr : componentPtr->subComponents)
             {
@@ -700,6 +701,9 @@ static void GenerateIpcBuildStatements
         };
 
     generate(componentPtr);
+
+    // Run all the ifgen jobs for the component and its sub-components in one go.
+    GenerateIfgenBatchBuildStatement(script, ifgenBatch, buildParams);
 }
 
 
@@ -815,6 +819,10 @@ static void GenerateNinjaScriptBuildStatement
     // Call the lambda function.
     lambda(componentPtr);
 
+    // Also depend on every other file read while building the model (e.g., #included files and
+    // .api files pulled in through USETYPES statements in other .api files).
+    dependencies.insert(buildInputs::GetAll().begin(), buildInputs::GetAll().end());
+
     // Write the dependencies to the script.
     for (auto dep : dependencies)
     {
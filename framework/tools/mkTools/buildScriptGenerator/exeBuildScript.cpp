@@ -223,11 +223,18 @@ static void GenerateIpcBuildStatements
     // already generated.
 
     std::set<std::string> generatedSet;
+    IfgenBatch_t ifgenBatch;
 
     for (auto instancePtr : exePtr->componentInstances)
     {
-        GenerateIpcBuildStatements(script, instancePtr->componentPtr, buildParams, generatedSet);
+        GenerateIpcBuildStatements(script,
+                                   ifgenBatch,
+                                   instancePtr->componentPtr,
+                                   buildParams,
+                                   generatedSet);
     }
+
+    GenerateIfgenBatchBuildStatement(script, ifgenBatch, buildParams);
 }
 
 
@@ -404,6 +411,10 @@ static void GenerateNinjaScriptBuildStatement
     // It also depends on changes to the mk tools.
     dependencies.insert(path::Combine(envVars::Get("LEGATO_ROOT"), "build/tools/mk"));
 
+    // Also depend on every other file read while building the model (e.g., #included files and
+    // .api files pulled in through USETYPES statements in other .api files).
+    dependencies.insert(buildInputs::GetAll().begin(), buildInputs::GetAll().end());
+
     // Write the dependencies to the script.
     for (auto dep : dependencies)
     {
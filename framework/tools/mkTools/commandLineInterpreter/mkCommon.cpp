@@ -10,6 +10,7 @@
 #include "mkCommon.h"
 #include <string.h>
 #include <unistd.h>
+#include <utime.h>
 
 namespace cli
 {
@@ -69,6 +70,54 @@ void RunNinja
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the build script is still current when ninja has asked for it to be regenerated
+ * (using --dont-run-ninja).  Ninja does that whenever an input file's timestamp is newer than the
+ * build.ninja file's, but if none of the input files' contents have changed since the build
+ * script was generated, parsing and modelling everything again would produce the same outputs.
+ *
+ * If the build script is current, its timestamp is updated so ninja will see it as up to date.
+ *
+ * @return true if the build script doesn't need to be regenerated.
+ *
+ * @throw mk::Exception_t if the build script's timestamp can't be updated.
+ */
+//--------------------------------------------------------------------------------------------------
+bool BuildScriptIsCurrent
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto ninjaFilePath = path::Combine(buildParams.workingDir, "build.ninja");
+
+    if (!file::FileExists(ninjaFilePath) || !buildInputs::MatchesSaved(buildParams))
+    {
+        return false;
+    }
+
+    if (buildParams.beVerbose)
+    {
+        std::cout << LE_I18N("Input files are unchanged; build script is up to date.")
+                  << std::endl;
+    }
+
+    if (utime(ninjaFilePath.c_str(), NULL) != 0)
+    {
+        int errCode = errno;
+
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to update timestamp of '%s' (%s)."),
+                       ninjaFilePath,
+                       strerror(errCode))
+        );
+    }
+
+    return true;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate code for a given component.
@@ -29,6 +29,26 @@ void RunNinja
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the build script is still current when ninja has asked for it to be regenerated
+ * (using --dont-run-ninja).  Ninja does that whenever an input file's timestamp is newer than the
+ * build.ninja file's, but if none of the input files' contents have changed since the build
+ * script was generated, parsing and modelling everything again would produce the same outputs.
+ *
+ * If the build script is current, its timestamp is updated so ninja will see it as up to date.
+ *
+ * @return true if the build script doesn't need to be regenerated.
+ *
+ * @throw mk::Exception_t if the build script's timestamp can't be updated.
+ */
+//--------------------------------------------------------------------------------------------------
+bool BuildScriptIsCurrent
+(
+    const mk::BuildParams_t& buildParams
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate code for a given component.
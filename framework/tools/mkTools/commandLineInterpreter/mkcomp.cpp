@@ -242,6 +242,13 @@ void MakeComponent
     // Set the target-specific environment variables (e.g., LEGATO_TARGET).
     envVars::SetTargetSpecific(BuildParams.target);
 
+    // If ninja has asked us to regenerate its script, but none of the input files' contents have
+    // actually changed since it was last generated, there's nothing to do.
+    if (DontRunNinja && BuildScriptIsCurrent(BuildParams))
+    {
+        return;
+    }
+
     // If we have not been asked to ignore any already existing build.ninja, and the command-line
     // arguments and environment variables we were given are the same as last time, just run ninja.
     if (!DontRunNinja)
@@ -295,6 +302,10 @@ void MakeComponent
     // Generate the ninja build script.
     ninja::Generate(componentPtr, BuildParams, argc, argv);
 
+    // Remember the contents of all the input files, so the build script doesn't have to be
+    // regenerated if they are touched without being changed.
+    buildInputs::Save(BuildParams);
+
     // If we haven't been asked not to, run ninja.
     if (!DontRunNinja)
     {
@@ -236,6 +236,13 @@ void MakeSystem
     // Compute the staging directory path.
     auto stagingDir = path::Combine(BuildParams.workingDir, "staging");
 
+    // If ninja has asked us to regenerate its script, but none of the input files' contents have
+    // actually changed since it was last generated, there's nothing to do.
+    if (DontRunNinja && BuildScriptIsCurrent(BuildParams))
+    {
+        return;
+    }
+
     // If we have been asked not to run Ninja, then delete the staging area because it probably
     // will contain some of the wrong files now that .Xdef file have changed.
     if (DontRunNinja)
@@ -294,6 +301,10 @@ void MakeSystem
     // Generate the build script for the system.
     ninja::Generate(systemPtr, BuildParams, OutputDir, argc, argv);
 
+    // Remember the contents of all the input files, so the build script doesn't have to be
+    // regenerated if they are touched without being changed.
+    buildInputs::Save(BuildParams);
+
     // Now delete the appPtr
     delete systemPtr;
 
@@ -434,4 +434,54 @@ void DeleteFile
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a string to a file, unless the file already contains exactly that string.  Leaving an
+ * unchanged file alone preserves its timestamp, so anything that depends on it won't be rebuilt.
+ *
+ * @throw mk::Exception_t if something goes wrong.
+ **/
+//--------------------------------------------------------------------------------------------------
+void WriteIfChanged
+(
+    const std::string& path,
+    const std::string& contents
+)
+//--------------------------------------------------------------------------------------------------
+{
+    {
+        std::ifstream existingFile(path);
+
+        if (existingFile.is_open())
+        {
+            std::stringstream existingContents;
+            existingContents << existingFile.rdbuf();
+
+            if (existingContents.str() == contents)
+            {
+                return;
+            }
+        }
+    }
+
+    MakeDir(path::GetContainingDir(path));
+
+    std::ofstream outputFile(path, std::ofstream::trunc);
+    if (!outputFile.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for writing."), path)
+        );
+    }
+
+    outputFile << contents;
+
+    outputFile.close();
+    if (outputFile.fail())
+    {
+        throw mk::Exception_t(mk::format(LE_I18N("Failed to write file '%s'."), path));
+    }
+}
+
+
 } // namespace file
@@ -173,6 +173,21 @@ void DeleteFile
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a string to a file, unless the file already contains exactly that string.  Leaving an
+ * unchanged file alone preserves its timestamp, so anything that depends on it won't be rebuilt.
+ *
+ * @throw mk::Exception_t if something goes wrong.
+ **/
+//--------------------------------------------------------------------------------------------------
+void WriteIfChanged
+(
+    const std::string& path,
+    const std::string& contents
+);
+
+
 } // namespace file
 
 #endif // LEGATO_MKTOOLS_FILE_H_INCLUDE_GUARD
@@ -38,6 +38,7 @@
 #include "file.h"
 #include "format.h"
 #include "md5.h"
+#include "buildInputs.h"
 #include "parseTree/parseTree.h"
 #include "parser/parser.h"
 #include "conceptualModel/conceptualModel.h"
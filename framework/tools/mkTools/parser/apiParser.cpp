@@ -99,6 +99,9 @@ void GetDependencies
         );
     }
 
+    // Remember that this file is an input to the build.
+    buildInputs::Add(filePath);
+
     // Keep looking for USETYPES statements, skipping comments.
     for (int c = inputStream.get(); c != EOF; c = inputStream.get())
     {
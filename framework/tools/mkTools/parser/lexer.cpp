@@ -47,6 +47,9 @@ Lexer_t::LexerContext_t::LexerContext_t
         );
     }
 
+    // Remember that this file is an input to the build.
+    buildInputs::Add(filePtr->path);
+
     // Read in the first characters.
     Buffer(2);
 